@@ -0,0 +1,677 @@
+#include "FullInclude.h"
+#include "CipherAES.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+	#define CIPHER_AES_X86
+	#include <wmmintrin.h>
+
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define CIPHER_AES_TARGET
+	#else
+		#include <cpuid.h>
+		#include <x86intrin.h>
+		// Allows AES-NI instructions in these functions only, the rest of the module must run on any processor
+		#define CIPHER_AES_TARGET __attribute__((target("aes,sse2")))
+	#endif
+#endif
+
+volatile CipherAES::Implementation CipherAES::implementation = CipherAES::IMPLEMENTATION_AUTO;
+
+/**
+ * @brief	Lookup tables used by the table implementation.
+ *
+ * Each entry of CipherTables::encrypt combines SubBytes and MixColumns for one byte of a column,
+ * the four tables are rotations of each other so that ShiftRows is applied by the choice of table.
+ * CipherTables::decrypt does the same for InverseSubBytes and InverseMixColumns.
+ */
+struct CipherTables
+{
+	/** @brief Encryption tables. */
+	unsigned int encrypt[4][256];
+
+	/** @brief Decryption tables. */
+	unsigned int decrypt[4][256];
+
+	/**
+	 * @brief	Performs galois field multiplication (@a a * @a b).
+	 *
+	 * @param	a	A number to be multiplied with @a b.
+	 * @param	b	A number to be multiplied with @a a.
+	 *
+	 * @return	@a a multiplied with @a b (galois field).
+	 */
+	static unsigned int Multiply(unsigned char a, unsigned char b)
+	{
+		unsigned char p = 0;
+		for(size_t n = 0;n<8;n++)
+		{
+			if((b & 1) == 1)
+			{
+				p ^= a;
+			}
+
+			bool hiBitSet = (a & 0x80) != 0;
+			a <<= 1;
+			if(hiBitSet == true)
+			{
+				a ^= 0x1b;
+			}
+
+			b >>= 1;
+		}
+		return p;
+	}
+
+	/**
+	 * @brief	Rotates a word right.
+	 *
+	 * @param	word	Word to rotate.
+	 * @param	bits	Number of bits to rotate by, must be more than 0 and less than 32.
+	 *
+	 * @return	rotated word.
+	 */
+	static unsigned int RotateRight(unsigned int word, size_t bits)
+	{
+		return (word >> bits) | (word << (32 - bits));
+	}
+
+	/**
+	 * @brief	Constructor, generates the tables from NetUtility::EncryptionBox and NetUtility::InverseEncryptionBox.
+	 */
+	CipherTables()
+	{
+		for(size_t n = 0;n<256;n++)
+		{
+			unsigned char s = NetUtility::EncryptionBox[n];
+			unsigned int encryptWord = (Multiply(s,0x02) << 24) | (Multiply(s,0x01) << 16) | (Multiply(s,0x01) << 8) | Multiply(s,0x03);
+
+			unsigned char inverse = NetUtility::InverseEncryptionBox[n];
+			unsigned int decryptWord = (Multiply(inverse,0x0e) << 24) | (Multiply(inverse,0x09) << 16) | (Multiply(inverse,0x0d) << 8) | Multiply(inverse,0x0b);
+
+			encrypt[0][n] = encryptWord;
+			decrypt[0][n] = decryptWord;
+			for(size_t t = 1;t<4;t++)
+			{
+				encrypt[t][n] = RotateRight(encryptWord,t * 8);
+				decrypt[t][n] = RotateRight(decryptWord,t * 8);
+			}
+		}
+	}
+};
+
+/** @brief Tables used by the table implementation, generated before main is entered. */
+static const CipherTables tables;
+
+/**
+ * @brief	Reads a big endian word.
+ *
+ * @param	data	Data to read from, must be at least 4 bytes in size.
+ *
+ * @return	the word.
+ */
+static inline unsigned int LoadWord(const unsigned char * data)
+{
+	return (static_cast<unsigned int>(data[0]) << 24) | (static_cast<unsigned int>(data[1]) << 16) |
+		   (static_cast<unsigned int>(data[2]) << 8) | static_cast<unsigned int>(data[3]);
+}
+
+/**
+ * @brief	Writes a big endian word.
+ *
+ * @param [out]	data	Destination, must be at least 4 bytes in size.
+ * @param	word	Word to write.
+ */
+static inline void StoreWord(unsigned char * data, unsigned int word)
+{
+	data[0] = static_cast<unsigned char>(word >> 24);
+	data[1] = static_cast<unsigned char>(word >> 16);
+	data[2] = static_cast<unsigned char>(word >> 8);
+	data[3] = static_cast<unsigned char>(word);
+}
+
+/**
+ * @brief	Combines the final round's substitution bytes into a word.
+ *
+ * @param	box	Substitution table.
+ * @param	a	Word whose most significant byte is substituted into the most significant byte.
+ * @param	b	Word whose second byte is substituted into the second byte.
+ * @param	c	Word whose third byte is substituted into the third byte.
+ * @param	d	Word whose least significant byte is substituted into the least significant byte.
+ *
+ * @return	the combined word.
+ */
+static inline unsigned int SubstituteWord(const unsigned char * box, unsigned int a, unsigned int b, unsigned int c, unsigned int d)
+{
+	return (static_cast<unsigned int>(box[a >> 24]) << 24) | (static_cast<unsigned int>(box[(b >> 16) & 0xff]) << 16) |
+		   (static_cast<unsigned int>(box[(c >> 8) & 0xff]) << 8) | static_cast<unsigned int>(box[d & 0xff]);
+}
+
+/**
+ * @brief	Encrypts blocks using the table implementation.
+ *
+ * @param [in,out]	data	Blocks to encrypt in place.
+ * @param	numBlocks	Number of blocks.
+ * @param	numRounds	Number of rounds.
+ * @param	roundKey	Round keys.
+ */
+static void EncryptBlocksTable(unsigned char * data, size_t numBlocks, unsigned char numRounds, const unsigned char * roundKey)
+{
+	unsigned int keys[CipherAES::MAXIMUM_ROUND_KEY_SIZE / 4];
+	for(size_t n = 0;n<(numRounds + 1u) * 4u;n++)
+	{
+		keys[n] = LoadWord(roundKey + n * 4);
+	}
+
+	const unsigned int (* te)[256] = tables.encrypt;
+	const unsigned char * box = NetUtility::EncryptionBox;
+
+	for(size_t b = 0;b<numBlocks;b++, data += CipherAES::BLOCK_SIZE)
+	{
+		const unsigned int * rk = keys;
+		unsigned int s0 = LoadWord(data) ^ rk[0];
+		unsigned int s1 = LoadWord(data + 4) ^ rk[1];
+		unsigned int s2 = LoadWord(data + 8) ^ rk[2];
+		unsigned int s3 = LoadWord(data + 12) ^ rk[3];
+
+		for(size_t r = 1;r<numRounds;r++)
+		{
+			rk += 4;
+			unsigned int t0 = te[0][s0 >> 24] ^ te[1][(s1 >> 16) & 0xff] ^ te[2][(s2 >> 8) & 0xff] ^ te[3][s3 & 0xff] ^ rk[0];
+			unsigned int t1 = te[0][s1 >> 24] ^ te[1][(s2 >> 16) & 0xff] ^ te[2][(s3 >> 8) & 0xff] ^ te[3][s0 & 0xff] ^ rk[1];
+			unsigned int t2 = te[0][s2 >> 24] ^ te[1][(s3 >> 16) & 0xff] ^ te[2][(s0 >> 8) & 0xff] ^ te[3][s1 & 0xff] ^ rk[2];
+			unsigned int t3 = te[0][s3 >> 24] ^ te[1][(s0 >> 16) & 0xff] ^ te[2][(s1 >> 8) & 0xff] ^ te[3][s2 & 0xff] ^ rk[3];
+			s0 = t0;
+			s1 = t1;
+			s2 = t2;
+			s3 = t3;
+		}
+
+		// Final round has no MixColumns
+		rk += 4;
+		StoreWord(data,SubstituteWord(box,s0,s1,s2,s3) ^ rk[0]);
+		StoreWord(data + 4,SubstituteWord(box,s1,s2,s3,s0) ^ rk[1]);
+		StoreWord(data + 8,SubstituteWord(box,s2,s3,s0,s1) ^ rk[2]);
+		StoreWord(data + 12,SubstituteWord(box,s3,s0,s1,s2) ^ rk[3]);
+	}
+}
+
+/**
+ * @brief	Decrypts blocks using the table implementation.
+ *
+ * @param [in,out]	data	Blocks to decrypt in place.
+ * @param	numBlocks	Number of blocks.
+ * @param	numRounds	Number of rounds.
+ * @param	decryptionRoundKey	Round keys generated by CipherAES::ExpandDecryptionKey().
+ */
+static void DecryptBlocksTable(unsigned char * data, size_t numBlocks, unsigned char numRounds, const unsigned char * decryptionRoundKey)
+{
+	unsigned int keys[CipherAES::MAXIMUM_ROUND_KEY_SIZE / 4];
+	for(size_t n = 0;n<(numRounds + 1u) * 4u;n++)
+	{
+		keys[n] = LoadWord(decryptionRoundKey + n * 4);
+	}
+
+	const unsigned int (* td)[256] = tables.decrypt;
+	const unsigned char * box = NetUtility::InverseEncryptionBox;
+
+	for(size_t b = 0;b<numBlocks;b++, data += CipherAES::BLOCK_SIZE)
+	{
+		const unsigned int * rk = keys;
+		unsigned int s0 = LoadWord(data) ^ rk[0];
+		unsigned int s1 = LoadWord(data + 4) ^ rk[1];
+		unsigned int s2 = LoadWord(data + 8) ^ rk[2];
+		unsigned int s3 = LoadWord(data + 12) ^ rk[3];
+
+		for(size_t r = 1;r<numRounds;r++)
+		{
+			rk += 4;
+			unsigned int t0 = td[0][s0 >> 24] ^ td[1][(s3 >> 16) & 0xff] ^ td[2][(s2 >> 8) & 0xff] ^ td[3][s1 & 0xff] ^ rk[0];
+			unsigned int t1 = td[0][s1 >> 24] ^ td[1][(s0 >> 16) & 0xff] ^ td[2][(s3 >> 8) & 0xff] ^ td[3][s2 & 0xff] ^ rk[1];
+			unsigned int t2 = td[0][s2 >> 24] ^ td[1][(s1 >> 16) & 0xff] ^ td[2][(s0 >> 8) & 0xff] ^ td[3][s3 & 0xff] ^ rk[2];
+			unsigned int t3 = td[0][s3 >> 24] ^ td[1][(s2 >> 16) & 0xff] ^ td[2][(s1 >> 8) & 0xff] ^ td[3][s0 & 0xff] ^ rk[3];
+			s0 = t0;
+			s1 = t1;
+			s2 = t2;
+			s3 = t3;
+		}
+
+		// Final round has no InverseMixColumns
+		rk += 4;
+		StoreWord(data,SubstituteWord(box,s0,s3,s2,s1) ^ rk[0]);
+		StoreWord(data + 4,SubstituteWord(box,s1,s0,s3,s2) ^ rk[1]);
+		StoreWord(data + 8,SubstituteWord(box,s2,s1,s0,s3) ^ rk[2]);
+		StoreWord(data + 12,SubstituteWord(box,s3,s2,s1,s0) ^ rk[3]);
+	}
+}
+
+#ifdef CIPHER_AES_X86
+/**
+ * @brief	Encrypts blocks using AES-NI instructions.
+ *
+ * Four blocks are ciphered at a time so that the latency of each instruction is hidden.
+ *
+ * @param [in,out]	data	Blocks to encrypt in place.
+ * @param	numBlocks	Number of blocks.
+ * @param	numRounds	Number of rounds.
+ * @param	roundKey	Round keys.
+ */
+CIPHER_AES_TARGET static void EncryptBlocksHardware(unsigned char * data, size_t numBlocks, unsigned char numRounds, const unsigned char * roundKey)
+{
+	__m128i keys[CipherAES::MAXIMUM_ROUNDS + 1];
+	for(size_t r = 0;r<=numRounds;r++)
+	{
+		keys[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(roundKey + r * CipherAES::BLOCK_SIZE));
+	}
+
+	__m128i * blocks = reinterpret_cast<__m128i*>(data);
+	size_t b = 0;
+	for(;b + 4<=numBlocks;b+=4)
+	{
+		__m128i s0 = _mm_xor_si128(_mm_loadu_si128(blocks + b),keys[0]);
+		__m128i s1 = _mm_xor_si128(_mm_loadu_si128(blocks + b + 1),keys[0]);
+		__m128i s2 = _mm_xor_si128(_mm_loadu_si128(blocks + b + 2),keys[0]);
+		__m128i s3 = _mm_xor_si128(_mm_loadu_si128(blocks + b + 3),keys[0]);
+
+		for(size_t r = 1;r<numRounds;r++)
+		{
+			s0 = _mm_aesenc_si128(s0,keys[r]);
+			s1 = _mm_aesenc_si128(s1,keys[r]);
+			s2 = _mm_aesenc_si128(s2,keys[r]);
+			s3 = _mm_aesenc_si128(s3,keys[r]);
+		}
+
+		_mm_storeu_si128(blocks + b,_mm_aesenclast_si128(s0,keys[numRounds]));
+		_mm_storeu_si128(blocks + b + 1,_mm_aesenclast_si128(s1,keys[numRounds]));
+		_mm_storeu_si128(blocks + b + 2,_mm_aesenclast_si128(s2,keys[numRounds]));
+		_mm_storeu_si128(blocks + b + 3,_mm_aesenclast_si128(s3,keys[numRounds]));
+	}
+
+	for(;b<numBlocks;b++)
+	{
+		__m128i s = _mm_xor_si128(_mm_loadu_si128(blocks + b),keys[0]);
+		for(size_t r = 1;r<numRounds;r++)
+		{
+			s = _mm_aesenc_si128(s,keys[r]);
+		}
+		_mm_storeu_si128(blocks + b,_mm_aesenclast_si128(s,keys[numRounds]));
+	}
+}
+
+/**
+ * @brief	Decrypts blocks using AES-NI instructions.
+ *
+ * Four blocks are ciphered at a time so that the latency of each instruction is hidden.
+ *
+ * @param [in,out]	data	Blocks to decrypt in place.
+ * @param	numBlocks	Number of blocks.
+ * @param	numRounds	Number of rounds.
+ * @param	decryptionRoundKey	Round keys generated by CipherAES::ExpandDecryptionKey().
+ */
+CIPHER_AES_TARGET static void DecryptBlocksHardware(unsigned char * data, size_t numBlocks, unsigned char numRounds, const unsigned char * decryptionRoundKey)
+{
+	__m128i keys[CipherAES::MAXIMUM_ROUNDS + 1];
+	for(size_t r = 0;r<=numRounds;r++)
+	{
+		keys[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(decryptionRoundKey + r * CipherAES::BLOCK_SIZE));
+	}
+
+	__m128i * blocks = reinterpret_cast<__m128i*>(data);
+	size_t b = 0;
+	for(;b + 4<=numBlocks;b+=4)
+	{
+		__m128i s0 = _mm_xor_si128(_mm_loadu_si128(blocks + b),keys[0]);
+		__m128i s1 = _mm_xor_si128(_mm_loadu_si128(blocks + b + 1),keys[0]);
+		__m128i s2 = _mm_xor_si128(_mm_loadu_si128(blocks + b + 2),keys[0]);
+		__m128i s3 = _mm_xor_si128(_mm_loadu_si128(blocks + b + 3),keys[0]);
+
+		for(size_t r = 1;r<numRounds;r++)
+		{
+			s0 = _mm_aesdec_si128(s0,keys[r]);
+			s1 = _mm_aesdec_si128(s1,keys[r]);
+			s2 = _mm_aesdec_si128(s2,keys[r]);
+			s3 = _mm_aesdec_si128(s3,keys[r]);
+		}
+
+		_mm_storeu_si128(blocks + b,_mm_aesdeclast_si128(s0,keys[numRounds]));
+		_mm_storeu_si128(blocks + b + 1,_mm_aesdeclast_si128(s1,keys[numRounds]));
+		_mm_storeu_si128(blocks + b + 2,_mm_aesdeclast_si128(s2,keys[numRounds]));
+		_mm_storeu_si128(blocks + b + 3,_mm_aesdeclast_si128(s3,keys[numRounds]));
+	}
+
+	for(;b<numBlocks;b++)
+	{
+		__m128i s = _mm_xor_si128(_mm_loadu_si128(blocks + b),keys[0]);
+		for(size_t r = 1;r<numRounds;r++)
+		{
+			s = _mm_aesdec_si128(s,keys[r]);
+		}
+		_mm_storeu_si128(blocks + b,_mm_aesdeclast_si128(s,keys[numRounds]));
+	}
+}
+#endif
+
+/**
+ * @brief	Determines whether the processor supports AES-NI instructions.
+ *
+ * @return	true if IMPLEMENTATION_HARDWARE can be used, false if not.
+ */
+bool CipherAES::IsHardwareSupported()
+{
+#ifdef CIPHER_AES_X86
+	#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info,1);
+		return (info[2] & (1 << 25)) != 0;
+	#else
+		unsigned int eax, ebx, ecx, edx;
+		if(__get_cpuid(1,&eax,&ebx,&ecx,&edx) == 0)
+		{
+			return false;
+		}
+		return (ecx & bit_AES) != 0;
+	#endif
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief	Changes the implementation used by all encryption and decryption operations.
+ *
+ * This is intended for testing and benchmarking, by default the fastest implementation is used.
+ *
+ * @param	newImplementation	Implementation to use, IMPLEMENTATION_AUTO selects the fastest implementation.
+ *
+ * @throws ErrorReport If @a newImplementation is IMPLEMENTATION_HARDWARE and the processor does not support it.
+ */
+void CipherAES::SetImplementation(Implementation newImplementation)
+{
+	_ErrorException((newImplementation == IMPLEMENTATION_HARDWARE && IsHardwareSupported() == false),"changing the AES implementation, the processor does not support AES-NI instructions",0,__LINE__,__FILE__);
+
+	if(newImplementation == IMPLEMENTATION_AUTO)
+	{
+		if(IsHardwareSupported() == true)
+		{
+			newImplementation = IMPLEMENTATION_HARDWARE;
+		}
+		else
+		{
+			newImplementation = IMPLEMENTATION_TABLE;
+		}
+	}
+
+	implementation = newImplementation;
+}
+
+/**
+ * @brief	Retrieves the implementation used by encryption and decryption operations.
+ *
+ * @return	IMPLEMENTATION_TABLE or IMPLEMENTATION_HARDWARE.
+ */
+CipherAES::Implementation CipherAES::GetImplementation()
+{
+	// Threads which get here at the same time select the same implementation
+	if(implementation == IMPLEMENTATION_AUTO)
+	{
+		SetImplementation(IMPLEMENTATION_AUTO);
+	}
+	return implementation;
+}
+
+/**
+ * @brief	Generates the round keys used by the equivalent inverse cipher.
+ *
+ * The round keys are put in reverse order and InverseMixColumns is applied to all but
+ * the first and last, so that decryption has the same structure as encryption. The same
+ * round keys are used by all implementations.
+ *
+ * @param	numRounds	Number of rounds.
+ * @param	roundKey	Encryption round keys, (@a numRounds + 1) * BLOCK_SIZE bytes in size.
+ * @param [out]	decryptionRoundKey	Destination for decryption round keys, must be (@a numRounds + 1) * BLOCK_SIZE bytes in size.
+ */
+void CipherAES::ExpandDecryptionKey(unsigned char numRounds, const unsigned char * roundKey, unsigned char * decryptionRoundKey)
+{
+	for(size_t r = 0;r<=numRounds;r++)
+	{
+		const unsigned char * source = roundKey + (numRounds - r) * BLOCK_SIZE;
+		unsigned char * destination = decryptionRoundKey + r * BLOCK_SIZE;
+
+		for(size_t c = 0;c<BLOCK_SIZE;c+=4)
+		{
+			unsigned int word = LoadWord(source + c);
+
+			if(r != 0 && r != numRounds)
+			{
+				// Decryption tables apply InverseSubBytes then InverseMixColumns, so substitute first to leave only InverseMixColumns
+				const unsigned char * box = NetUtility::EncryptionBox;
+				word = tables.decrypt[0][box[word >> 24]] ^ tables.decrypt[1][box[(word >> 16) & 0xff]] ^
+					   tables.decrypt[2][box[(word >> 8) & 0xff]] ^ tables.decrypt[3][box[word & 0xff]];
+			}
+
+			StoreWord(destination + c,word);
+		}
+	}
+}
+
+/**
+ * @brief	Encrypts blocks of data in place.
+ *
+ * @param [in,out]	data	Data to encrypt, must be @a numBlocks * BLOCK_SIZE bytes in size.
+ * @param	numBlocks	Number of blocks to encrypt.
+ * @param	numRounds	Number of rounds, see EncryptKey::GetNumRounds().
+ * @param	roundKey	Round keys, see EncryptKey::GetRoundKeys().
+ */
+void CipherAES::EncryptBlocks(unsigned char * data, size_t numBlocks, unsigned char numRounds, const unsigned char * roundKey)
+{
+#ifdef CIPHER_AES_X86
+	if(GetImplementation() == IMPLEMENTATION_HARDWARE)
+	{
+		EncryptBlocksHardware(data,numBlocks,numRounds,roundKey);
+		return;
+	}
+#endif
+	EncryptBlocksTable(data,numBlocks,numRounds,roundKey);
+}
+
+/**
+ * @brief	Decrypts blocks of data in place.
+ *
+ * @param [in,out]	data	Data to decrypt, must be @a numBlocks * BLOCK_SIZE bytes in size.
+ * @param	numBlocks	Number of blocks to decrypt.
+ * @param	numRounds	Number of rounds, see EncryptKey::GetNumRounds().
+ * @param	decryptionRoundKey	Round keys generated by ExpandDecryptionKey().
+ */
+void CipherAES::DecryptBlocks(unsigned char * data, size_t numBlocks, unsigned char numRounds, const unsigned char * decryptionRoundKey)
+{
+#ifdef CIPHER_AES_X86
+	if(GetImplementation() == IMPLEMENTATION_HARDWARE)
+	{
+		DecryptBlocksHardware(data,numBlocks,numRounds,decryptionRoundKey);
+		return;
+	}
+#endif
+	DecryptBlocksTable(data,numBlocks,numRounds,decryptionRoundKey);
+}
+
+/**
+ * @brief	Reads the processor's cycle counter.
+ *
+ * @return	number of cycles, 0 if there is no cycle counter.
+ */
+static unsigned long long int ReadCycleCounter()
+{
+#ifdef CIPHER_AES_X86
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief	Measures the speed of the current implementation.
+ *
+ * @param	key	Key to use.
+ * @param	encrypt	If true encryption is measured, if false decryption is measured.
+ *
+ * @return	number of cycles per byte.
+ */
+static double CipherAESBenchmark(const EncryptKey & key, bool encrypt)
+{
+	const size_t bufferSize = 64 * 1024;
+	const size_t iterations = 256;
+
+	unsigned char * buffer = new unsigned char[bufferSize];
+	memset(buffer,0x5a,bufferSize);
+
+	unsigned long long int startCycles = ReadCycleCounter();
+	for(size_t n = 0;n<iterations;n++)
+	{
+		if(encrypt == true)
+		{
+			CipherAES::EncryptBlocks(buffer,bufferSize / CipherAES::BLOCK_SIZE,key.GetNumRounds(),key.GetRoundKeys());
+		}
+		else
+		{
+			CipherAES::DecryptBlocks(buffer,bufferSize / CipherAES::BLOCK_SIZE,key.GetNumRounds(),key.GetDecryptionRoundKeys());
+		}
+	}
+	unsigned long long int cycles = ReadCycleCounter() - startCycles;
+
+	delete[] buffer;
+	return static_cast<double>(cycles) / static_cast<double>(bufferSize * iterations);
+}
+
+/**
+ * @brief	Creates a key from a hex string.
+ *
+ * @param	hex	Key in hex, 32, 48 or 64 characters long.
+ *
+ * @return	the key.
+ */
+static EncryptKey CipherAESCreateKey(const char * hex)
+{
+	Packet keyData;
+	keyData.AddHex(hex);
+	keyData.SetCursor(0);
+
+	__int64 key1 = keyData.Get<__int64>();
+	__int64 key2 = keyData.Get<__int64>();
+	if(keyData.GetUsedSize() == 16)
+	{
+		return EncryptKey(key1,key2);
+	}
+
+	__int64 key3 = keyData.Get<__int64>();
+	if(keyData.GetUsedSize() == 24)
+	{
+		return EncryptKey(key1,key2,key3);
+	}
+
+	__int64 key4 = keyData.Get<__int64>();
+	return EncryptKey(key1,key2,key3,key4);
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool CipherAES::TestClass()
+{
+	cout << "Testing CipherAES class...\n";
+	bool problem = false;
+
+	// Test vectors from appendix C of the Advanced Encryption Standard specification
+	const char * keys[] = {"000102030405060708090a0b0c0d0e0f",
+						   "000102030405060708090a0b0c0d0e0f1011121314151617",
+						   "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"};
+	const char * ciphers[] = {"69c4e0d86a7b0430d8cdb78070b4c55a",
+							  "dda97ca4864cdfe06eaf70a0ec0d7191",
+							  "8ea2b7ca516745bfeafc49904b496089"};
+	const size_t bitStrengths[] = {128, 192, 256};
+
+	Implementation implementations[] = {IMPLEMENTATION_TABLE, IMPLEMENTATION_HARDWARE};
+	const char * implementationNames[] = {"table", "hardware"};
+	size_t numImplementations = 2;
+	if(IsHardwareSupported() == false)
+	{
+		cout << "AES-NI is not supported by this processor, only the table implementation is tested\n";
+		numImplementations = 1;
+	}
+
+	const size_t randomSize = 1024 + 3 * BLOCK_SIZE;
+	unsigned char original[randomSize];
+	for(size_t n = 0;n<randomSize;n++)
+	{
+		original[n] = static_cast<unsigned char>(rand());
+	}
+
+	for(size_t k = 0;k<3;k++)
+	{
+		EncryptKey key = CipherAESCreateKey(keys[k]);
+		const unsigned char * decryptionRoundKey = key.GetDecryptionRoundKeys();
+
+		Packet desiredCipher;
+		desiredCipher.AddHex(ciphers[k]);
+
+		unsigned char firstResult[randomSize];
+
+		for(size_t i = 0;i<numImplementations;i++)
+		{
+			SetImplementation(implementations[i]);
+
+			Packet block;
+			block.AddHex("00112233445566778899aabbccddeeff");
+			EncryptBlocks(reinterpret_cast<unsigned char*>(block.GetDataPtr()),1,key.GetNumRounds(),key.GetRoundKeys());
+			bool encryptGood = (block == desiredCipher);
+
+			DecryptBlocks(reinterpret_cast<unsigned char*>(block.GetDataPtr()),1,key.GetNumRounds(),decryptionRoundKey);
+			Packet desiredPlain;
+			desiredPlain.AddHex("00112233445566778899aabbccddeeff");
+			bool decryptGood = (block == desiredPlain);
+
+			// Odd number of blocks, so that blocks which are not ciphered four at a time are tested
+			unsigned char result[randomSize];
+			memcpy(result,original,randomSize);
+			EncryptBlocks(result,randomSize / BLOCK_SIZE,key.GetNumRounds(),key.GetRoundKeys());
+			if(i == 0)
+			{
+				memcpy(firstResult,result,randomSize);
+			}
+			bool identical = (memcmp(result,firstResult,randomSize) == 0);
+
+			DecryptBlocks(result,randomSize / BLOCK_SIZE,key.GetNumRounds(),decryptionRoundKey);
+			bool roundTrip = (memcmp(result,original,randomSize) == 0);
+
+			if(encryptGood == false || decryptGood == false || identical == false || roundTrip == false)
+			{
+				cout << "Cipher " << bitStrengths[k] << " (" << implementationNames[i] << ") is bad\n";
+				problem = true;
+			}
+			else
+			{
+				cout << "Cipher " << bitStrengths[k] << " (" << implementationNames[i] << ") is good\n";
+			}
+		}
+	}
+
+	cout << "Benchmarking..\n";
+	for(size_t k = 0;k<3;k++)
+	{
+		EncryptKey key = CipherAESCreateKey(keys[k]);
+		for(size_t i = 0;i<numImplementations;i++)
+		{
+			SetImplementation(implementations[i]);
+			double encryptCycles = CipherAESBenchmark(key,true);
+			double decryptCycles = CipherAESBenchmark(key,false);
+			cout << " " << bitStrengths[k] << " bit, " << implementationNames[i] << ": " << encryptCycles << " cycles per byte encrypting, " << decryptCycles << " cycles per byte decrypting\n";
+		}
+	}
+	SetImplementation(IMPLEMENTATION_AUTO);
+
+	cout << "\n\n";
+	return !problem;
+}
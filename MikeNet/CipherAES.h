@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @brief	Advanced Encryption Standard block cipher, used by EncryptKey and Packet to encrypt and decrypt data.
+ *
+ * Blocks are ciphered using AES-NI instructions where the processor supports them, and using
+ * a table based software implementation otherwise. The implementation is selected at runtime,
+ * and both produce identical output from the same round keys (see EncryptKey::GetRoundKeys()).\n\n
+ *
+ * Decryption uses the equivalent inverse cipher, which needs the round keys to be transformed
+ * using ExpandDecryptionKey() first. EncryptKey does this once when it is constructed, see
+ * EncryptKey::GetDecryptionRoundKeys().\n\n
+ *
+ * All methods are thread safe.
+ *
+ * @author	Michael Pryor
+ */
+class CipherAES
+{
+public:
+	/**
+	 * @brief Methods of ciphering blocks.
+	 */
+	enum Implementation
+	{
+		/** Select the fastest implementation that the processor supports. */
+		IMPLEMENTATION_AUTO,
+
+		/** Software implementation which combines SubBytes, ShiftRows and MixColumns into table lookups. */
+		IMPLEMENTATION_TABLE,
+
+		/** AES-NI instructions, only available on x86 processors which support them. */
+		IMPLEMENTATION_HARDWARE
+	};
+
+	/** @brief Size of a block in bytes, data is ciphered in blocks of this size. */
+	static const size_t BLOCK_SIZE = 16;
+
+	/** @brief Maximum number of rounds, used by 256 bit keys. */
+	static const size_t MAXIMUM_ROUNDS = 14;
+
+	/** @brief Maximum size of round keys in bytes, used by 256 bit keys. */
+	static const size_t MAXIMUM_ROUND_KEY_SIZE = (MAXIMUM_ROUNDS + 1) * BLOCK_SIZE;
+
+private:
+	/** @brief Implementation in use, IMPLEMENTATION_AUTO until it is first needed. */
+	static volatile Implementation implementation;
+
+public:
+	static bool IsHardwareSupported();
+	static void SetImplementation(Implementation implementation);
+	static Implementation GetImplementation();
+
+	static void ExpandDecryptionKey(unsigned char numRounds, const unsigned char * roundKey, unsigned char * decryptionRoundKey);
+
+	static void EncryptBlocks(unsigned char * data, size_t numBlocks, unsigned char numRounds, const unsigned char * roundKey);
+	static void DecryptBlocks(unsigned char * data, size_t numBlocks, unsigned char numRounds, const unsigned char * decryptionRoundKey);
+
+	static bool TestClass();
+};
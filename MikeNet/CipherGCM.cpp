@@ -0,0 +1,786 @@
+#include "FullInclude.h"
+#include "CipherGCM.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+	#define CIPHER_GCM_X86
+	#include <wmmintrin.h>
+	#include <tmmintrin.h>
+
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define CIPHER_GCM_TARGET
+	#else
+		#include <cpuid.h>
+		// Allows carry-less multiplication instructions in these functions only, the rest of the module must run on any processor
+		#define CIPHER_GCM_TARGET __attribute__((target("pclmul,ssse3")))
+	#endif
+#endif
+
+#ifdef _WIN32
+	#pragma comment(lib, "Advapi32.lib")
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+/**
+ * @brief	Reduction constants used by CipherGCM::MultiplyTable(), one for each 4 bits shifted out of the state.
+ */
+static const unsigned long long int CipherGCMReduction[16] =
+{
+	0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+	0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+/**
+ * @brief	Reads a big endian 64 bit integer.
+ *
+ * @param	data	Data to read from.
+ *
+ * @return	integer.
+ */
+static inline unsigned long long int LoadLongWord(const unsigned char * data)
+{
+	unsigned long long int word = 0;
+	for(size_t n = 0;n<8;n++)
+	{
+		word = (word << 8) | data[n];
+	}
+	return word;
+}
+
+/**
+ * @brief	Writes a big endian 64 bit integer.
+ *
+ * @param [out]	data	Data to write to.
+ * @param	word	Integer to write.
+ */
+static inline void StoreLongWord(unsigned char * data, unsigned long long int word)
+{
+	for(size_t n = 0;n<8;n++)
+	{
+		data[7-n] = static_cast<unsigned char>(word);
+		word >>= 8;
+	}
+}
+
+/**
+ * @brief	Multiplies @a a by @a b in GF(2^128) using carry-less multiplication instructions, without reducing the product.
+ *
+ * Products can be added together with XOR before they are reduced, so that several blocks need only one reduction.
+ *
+ * @param	a	Value to multiply, byte reflected.
+ * @param	b	Value to multiply, byte reflected.
+ * @param [in,out]	low	Low 128 bits of the product are added to this.
+ * @param [in,out]	high	High 128 bits of the product are added to this.
+ */
+#ifdef CIPHER_GCM_X86
+CIPHER_GCM_TARGET static inline void MultiplyHardware(__m128i a, __m128i b, __m128i & low, __m128i & high)
+{
+	__m128i middle = _mm_xor_si128(_mm_clmulepi64_si128(a,b,0x10),_mm_clmulepi64_si128(a,b,0x01));
+	low = _mm_xor_si128(low,_mm_xor_si128(_mm_clmulepi64_si128(a,b,0x00),_mm_slli_si128(middle,8)));
+	high = _mm_xor_si128(high,_mm_xor_si128(_mm_clmulepi64_si128(a,b,0x11),_mm_srli_si128(middle,8)));
+}
+
+/**
+ * @brief	Reduces a product generated by MultiplyHardware() modulo x^128 + x^7 + x^2 + x + 1.
+ *
+ * @param	low		Low 128 bits of the product.
+ * @param	high	High 128 bits of the product.
+ *
+ * @return	reduced product, byte reflected.
+ */
+CIPHER_GCM_TARGET static inline __m128i ReduceHardware(__m128i low, __m128i high)
+{
+	// GHASH bits are reflected, so shift the product left by one
+	__m128i lowCarry = _mm_srli_epi32(low,31);
+	__m128i highCarry = _mm_srli_epi32(high,31);
+	low = _mm_slli_epi32(low,1);
+	high = _mm_slli_epi32(high,1);
+	high = _mm_or_si128(high,_mm_srli_si128(lowCarry,12));
+	high = _mm_or_si128(high,_mm_slli_si128(highCarry,4));
+	low = _mm_or_si128(low,_mm_slli_si128(lowCarry,4));
+
+	__m128i reduce = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(low,31),_mm_slli_epi32(low,30)),_mm_slli_epi32(low,25));
+	__m128i reduceHigh = _mm_srli_si128(reduce,4);
+	low = _mm_xor_si128(low,_mm_slli_si128(reduce,12));
+
+	__m128i fold = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(low,1),_mm_srli_epi32(low,2)),_mm_srli_epi32(low,7));
+	fold = _mm_xor_si128(fold,reduceHigh);
+	low = _mm_xor_si128(low,fold);
+
+	return _mm_xor_si128(high,low);
+}
+
+/**
+ * @brief	Adds data to a GHASH state using carry-less multiplication instructions.
+ *
+ * Four blocks are multiplied by the fourth to first powers of the authentication key
+ * and reduced together, which removes most of the dependency between blocks.
+ *
+ * @param [in,out]	state	Hash state.
+ * @param	hashKeyPowers	First to fourth powers of the authentication key, one after another.
+ * @param	data		Data to add, the last block is padded with zeros.
+ * @param	size		Size of @a data in bytes.
+ */
+CIPHER_GCM_TARGET static void HashHardware(unsigned char * state, const unsigned char * hashKeyPowers, const unsigned char * data, size_t size)
+{
+	const __m128i reverse = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+	__m128i key[4];
+	for(size_t n = 0;n<4;n++)
+	{
+		key[n] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hashKeyPowers + n * CipherAES::BLOCK_SIZE)),reverse);
+	}
+	__m128i hash = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)),reverse);
+
+	while(size >= 4 * CipherAES::BLOCK_SIZE)
+	{
+		__m128i low = _mm_setzero_si128();
+		__m128i high = _mm_setzero_si128();
+		for(size_t n = 0;n<4;n++)
+		{
+			__m128i block = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + n * CipherAES::BLOCK_SIZE)),reverse);
+			if(n == 0)
+			{
+				block = _mm_xor_si128(block,hash);
+			}
+			MultiplyHardware(block,key[3-n],low,high);
+		}
+		hash = ReduceHardware(low,high);
+
+		data += 4 * CipherAES::BLOCK_SIZE;
+		size -= 4 * CipherAES::BLOCK_SIZE;
+	}
+
+	while(size > 0)
+	{
+		__m128i block;
+		if(size >= CipherAES::BLOCK_SIZE)
+		{
+			block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+			data += CipherAES::BLOCK_SIZE;
+			size -= CipherAES::BLOCK_SIZE;
+		}
+		else
+		{
+			unsigned char padded[CipherAES::BLOCK_SIZE] = {0};
+			memcpy(padded,data,size);
+			block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded));
+			size = 0;
+		}
+
+		__m128i low = _mm_setzero_si128();
+		__m128i high = _mm_setzero_si128();
+		MultiplyHardware(_mm_xor_si128(hash,_mm_shuffle_epi8(block,reverse)),key[0],low,high);
+		hash = ReduceHardware(low,high);
+	}
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state),_mm_shuffle_epi8(hash,reverse));
+}
+#endif
+
+/** @brief True if GHASH may use carry-less multiplication instructions, determined once on startup. */
+static const bool hardwareHashSupported = CipherGCM::IsCarrylessMultiplySupported();
+
+/**
+ * @brief Constructor.
+ *
+ * @param key Key to use. The round keys are copied, so @a key does not need to remain valid for the lifetime of this object.
+ */
+CipherGCM::CipherGCM(const EncryptKey & key)
+{
+	numRounds = key.GetNumRounds();
+	memcpy(roundKey,key.GetRoundKeys(),(numRounds + 1) * CipherAES::BLOCK_SIZE);
+
+	unsigned char * hashKey = hashKeyPowers;
+	memset(hashKey,0,CipherAES::BLOCK_SIZE);
+	CipherAES::EncryptBlocks(hashKey,1,numRounds,roundKey);
+
+	// Multiples of the authentication key by every 4 bit value, bits are reflected so 8 is 1
+	unsigned long long int high = LoadLongWord(hashKey);
+	unsigned long long int low = LoadLongWord(hashKey + 8);
+
+	hashTableHigh[0] = 0;
+	hashTableLow[0] = 0;
+	hashTableHigh[8] = high;
+	hashTableLow[8] = low;
+
+	for(size_t n = 4;n>0;n>>=1)
+	{
+		unsigned long long int carry = (low & 1) * 0xe1000000;
+		low = (high << 63) | (low >> 1);
+		high = (high >> 1) ^ (carry << 32);
+		hashTableHigh[n] = high;
+		hashTableLow[n] = low;
+	}
+
+	for(size_t n = 2;n<=8;n*=2)
+	{
+		for(size_t i = 1;i<n;i++)
+		{
+			hashTableHigh[n+i] = hashTableHigh[n] ^ hashTableHigh[i];
+			hashTableLow[n+i] = hashTableLow[n] ^ hashTableLow[i];
+		}
+	}
+
+	// Powers of the authentication key used by the hardware implementation
+	for(size_t n = 1;n<4;n++)
+	{
+		unsigned char * power = hashKeyPowers + n * CipherAES::BLOCK_SIZE;
+		memcpy(power,power - CipherAES::BLOCK_SIZE,CipherAES::BLOCK_SIZE);
+		MultiplyTable(power);
+	}
+}
+
+/**
+ * @brief	Multiplies @a state by the authentication key in GF(2^128), 4 bits at a time using lookup tables.
+ *
+ * @param [in,out]	state	Block to multiply.
+ */
+void CipherGCM::MultiplyTable(unsigned char * state) const
+{
+	unsigned char lowNibble = state[15] & 0x0f;
+	unsigned long long int high = hashTableHigh[lowNibble];
+	unsigned long long int low = hashTableLow[lowNibble];
+
+	for(int n = 15;n>=0;n--)
+	{
+		lowNibble = state[n] & 0x0f;
+		unsigned char highNibble = state[n] >> 4;
+		unsigned char remainder;
+
+		if(n != 15)
+		{
+			remainder = static_cast<unsigned char>(low & 0x0f);
+			low = (high << 60) | (low >> 4);
+			high = (high >> 4) ^ (CipherGCMReduction[remainder] << 48);
+			high ^= hashTableHigh[lowNibble];
+			low ^= hashTableLow[lowNibble];
+		}
+
+		remainder = static_cast<unsigned char>(low & 0x0f);
+		low = (high << 60) | (low >> 4);
+		high = (high >> 4) ^ (CipherGCMReduction[remainder] << 48);
+		high ^= hashTableHigh[highNibble];
+		low ^= hashTableLow[highNibble];
+	}
+
+	StoreLongWord(state,high);
+	StoreLongWord(state + 8,low);
+}
+
+/**
+ * @brief	Adds data to a GHASH state.
+ *
+ * @param [in,out]	state	Hash state, CipherAES::BLOCK_SIZE bytes.
+ * @param	data	Data to add, the last block is padded with zeros.
+ * @param	size	Size of @a data in bytes.
+ */
+void CipherGCM::Hash(unsigned char * state, const unsigned char * data, size_t size) const
+{
+#ifdef CIPHER_GCM_X86
+	if(hardwareHashSupported == true && CipherAES::GetImplementation() == CipherAES::IMPLEMENTATION_HARDWARE)
+	{
+		HashHardware(state,hashKeyPowers,data,size);
+		return;
+	}
+#endif
+
+	while(size > 0)
+	{
+		size_t blockSize = CipherAES::BLOCK_SIZE;
+		if(size < blockSize)
+		{
+			blockSize = size;
+		}
+
+		for(size_t n = 0;n<blockSize;n++)
+		{
+			state[n] ^= data[n];
+		}
+		MultiplyTable(state);
+
+		data += blockSize;
+		size -= blockSize;
+	}
+}
+
+/**
+ * @brief	Encrypts or decrypts data in counter mode, starting from counter 2.
+ *
+ * Counter blocks are encrypted in batches so that CipherAES can pipeline them.
+ *
+ * @param [in,out]	data	Data to cipher.
+ * @param	size	Size of @a data in bytes.
+ * @param	nonce	NONCE_SIZE byte nonce.
+ */
+void CipherGCM::ApplyKeystream(unsigned char * data, size_t size, const unsigned char * nonce) const
+{
+	unsigned char counters[KEYSTREAM_BLOCKS * CipherAES::BLOCK_SIZE];
+	unsigned char keystream[KEYSTREAM_BLOCKS * CipherAES::BLOCK_SIZE];
+	unsigned int counter = 2;
+
+	// Only the last 4 bytes of each counter block change
+	for(size_t n = 0;n<KEYSTREAM_BLOCKS;n++)
+	{
+		memcpy(counters + n * CipherAES::BLOCK_SIZE,nonce,NONCE_SIZE);
+	}
+
+	while(size > 0)
+	{
+		size_t amount = sizeof(keystream);
+		if(size < amount)
+		{
+			amount = size;
+		}
+		size_t numBlocks = (amount + CipherAES::BLOCK_SIZE - 1) / CipherAES::BLOCK_SIZE;
+
+		for(size_t n = 0;n<numBlocks;n++)
+		{
+			unsigned char * block = counters + n * CipherAES::BLOCK_SIZE;
+			block[12] = static_cast<unsigned char>(counter >> 24);
+			block[13] = static_cast<unsigned char>(counter >> 16);
+			block[14] = static_cast<unsigned char>(counter >> 8);
+			block[15] = static_cast<unsigned char>(counter);
+			counter++;
+		}
+		memcpy(keystream,counters,numBlocks * CipherAES::BLOCK_SIZE);
+		CipherAES::EncryptBlocks(keystream,numBlocks,numRounds,roundKey);
+
+		// XOR a word at a time, memcpy avoids unaligned access
+		size_t n = 0;
+		for(;n + sizeof(unsigned long long int) <= amount;n += sizeof(unsigned long long int))
+		{
+			unsigned long long int word;
+			unsigned long long int key;
+			memcpy(&word,data + n,sizeof(word));
+			memcpy(&key,keystream + n,sizeof(key));
+			word ^= key;
+			memcpy(data + n,&word,sizeof(word));
+		}
+		for(;n<amount;n++)
+		{
+			data[n] ^= keystream[n];
+		}
+
+		data += amount;
+		size -= amount;
+	}
+}
+
+/**
+ * @brief	Generates the authentication tag of encrypted data.
+ *
+ * @param	data	Encrypted data.
+ * @param	size	Size of @a data in bytes.
+ * @param	additionalData	Data which is authenticated but not encrypted, may be NULL if @a additionalDataSize is 0.
+ * @param	additionalDataSize	Size of @a additionalData in bytes.
+ * @param	nonce	NONCE_SIZE byte nonce.
+ * @param [out]	tag	TAG_SIZE bytes are written here.
+ */
+void CipherGCM::GenerateTag(const unsigned char * data, size_t size, const unsigned char * additionalData, size_t additionalDataSize, const unsigned char * nonce, unsigned char * tag) const
+{
+	unsigned char state[CipherAES::BLOCK_SIZE] = {0};
+	Hash(state,additionalData,additionalDataSize);
+	Hash(state,data,size);
+
+	unsigned char lengths[CipherAES::BLOCK_SIZE];
+	StoreLongWord(lengths,static_cast<unsigned long long int>(additionalDataSize) * 8);
+	StoreLongWord(lengths + 8,static_cast<unsigned long long int>(size) * 8);
+	Hash(state,lengths,sizeof(lengths));
+
+	// Tag is the hash encrypted with counter 1
+	memcpy(tag,nonce,NONCE_SIZE);
+	tag[12] = 0;
+	tag[13] = 0;
+	tag[14] = 0;
+	tag[15] = 1;
+	CipherAES::EncryptBlocks(tag,1,numRounds,roundKey);
+
+	for(size_t n = 0;n<TAG_SIZE;n++)
+	{
+		tag[n] ^= state[n];
+	}
+}
+
+/**
+ * @brief	Encrypts data in place and generates its authentication tag.
+ *
+ * @param [in,out]	data	Data to encrypt, may be NULL if @a size is 0.
+ * @param	size	Size of @a data in bytes.
+ * @param	additionalData	Data which is authenticated but not encrypted, may be NULL if @a additionalDataSize is 0.
+ * @param	additionalDataSize	Size of @a additionalData in bytes.
+ * @param	nonce	NONCE_SIZE byte nonce, which must never be used with this key again.
+ * @param [out]	tag	TAG_SIZE bytes are written here, which must be passed to Open().
+ */
+void CipherGCM::Seal(unsigned char * data, size_t size, const unsigned char * additionalData, size_t additionalDataSize, const unsigned char * nonce, unsigned char * tag) const
+{
+	_ErrorException((static_cast<unsigned long long int>(size) > 0xFFFFFFFEULL * CipherAES::BLOCK_SIZE),"sealing data, size exceeds the maximum supported by one nonce",0,__LINE__,__FILE__);
+
+	ApplyKeystream(data,size,nonce);
+	GenerateTag(data,size,additionalData,additionalDataSize,nonce,tag);
+}
+
+/**
+ * @brief	Verifies the authentication tag of data and decrypts it in place.
+ *
+ * @param [in,out]	data	Data to decrypt, may be NULL if @a size is 0.
+ * @param	size	Size of @a data in bytes.
+ * @param	additionalData	Data which is authenticated but not encrypted, may be NULL if @a additionalDataSize is 0.
+ * @param	additionalDataSize	Size of @a additionalData in bytes.
+ * @param	nonce	NONCE_SIZE byte nonce that was passed to Seal().
+ * @param	tag	TAG_SIZE byte tag generated by Seal().
+ *
+ * @return	true if the data is authentic and has been decrypted.
+ * @return	false if the data, additional data, nonce or tag was modified, in which case @a data is not changed.
+ */
+bool CipherGCM::Open(unsigned char * data, size_t size, const unsigned char * additionalData, size_t additionalDataSize, const unsigned char * nonce, const unsigned char * tag) const
+{
+	if(static_cast<unsigned long long int>(size) > 0xFFFFFFFEULL * CipherAES::BLOCK_SIZE)
+	{
+		return false;
+	}
+
+	unsigned char expectedTag[TAG_SIZE];
+	GenerateTag(data,size,additionalData,additionalDataSize,nonce,expectedTag);
+
+	// Compare every byte so that timing does not reveal how much of the tag was correct
+	unsigned char difference = 0;
+	for(size_t n = 0;n<TAG_SIZE;n++)
+	{
+		difference |= expectedTag[n] ^ tag[n];
+	}
+
+	if(difference != 0)
+	{
+		return false;
+	}
+
+	ApplyKeystream(data,size,nonce);
+	return true;
+}
+
+/**
+ * @brief	Determines whether the processor supports carry-less multiplication instructions.
+ *
+ * @return	true if PCLMULQDQ and SSSE3 instructions are supported, false if not.
+ */
+bool CipherGCM::IsCarrylessMultiplySupported()
+{
+#ifdef CIPHER_GCM_X86
+	#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info,1);
+		return (info[2] & (1 << 1)) != 0 && (info[2] & (1 << 9)) != 0;
+	#else
+		unsigned int eax, ebx, ecx, edx;
+		if(__get_cpuid(1,&eax,&ebx,&ecx,&edx) == 0)
+		{
+			return false;
+		}
+		return (ecx & bit_PCLMUL) != 0 && (ecx & bit_SSSE3) != 0;
+	#endif
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief	Fills a buffer with cryptographically secure random bytes from the operating system.
+ *
+ * @param [out]	destination	Buffer to fill.
+ * @param	size	Number of bytes to write to @a destination.
+ *
+ * @throws ErrorReport If the operating system fails to generate random data.
+ */
+void CipherGCM::GenerateRandom(unsigned char * destination, size_t size)
+{
+#ifdef _WIN32
+	HCRYPTPROV provider;
+	_ErrorException((CryptAcquireContext(&provider,NULL,NULL,PROV_RSA_FULL,CRYPT_VERIFYCONTEXT) == FALSE),"generating random data, failed to acquire a cryptographic context",GetLastError(),__LINE__,__FILE__);
+
+	BOOL result = CryptGenRandom(provider,static_cast<DWORD>(size),destination);
+	DWORD error = GetLastError();
+	CryptReleaseContext(provider,0);
+
+	_ErrorException((result == FALSE),"generating random data",error,__LINE__,__FILE__);
+#else
+	int file = open("/dev/urandom",O_RDONLY);
+	_ErrorException((file < 0),"generating random data, failed to open /dev/urandom",errno,__LINE__,__FILE__);
+
+	size_t done = 0;
+	while(done < size)
+	{
+		ssize_t result = read(file,destination + done,size - done);
+		if(result <= 0)
+		{
+			close(file);
+			_ErrorException(true,"generating random data, failed to read /dev/urandom",errno,__LINE__,__FILE__);
+		}
+		done += static_cast<size_t>(result);
+	}
+
+	close(file);
+#endif
+}
+
+/**
+ * @brief	Creates a key from a hexadecimal string.
+ *
+ * @param	hex	128, 192 or 256 bit key in hexadecimal.
+ *
+ * @return	key.
+ */
+static EncryptKey CipherGCMCreateKey(const char * hex)
+{
+	Packet keyData;
+	keyData.AddHex(hex);
+	keyData.SetCursor(0);
+
+	__int64 key1 = keyData.Get<__int64>();
+	__int64 key2 = keyData.Get<__int64>();
+	if(keyData.GetUsedSize() == 16)
+	{
+		return EncryptKey(key1,key2);
+	}
+
+	__int64 key3 = keyData.Get<__int64>();
+	if(keyData.GetUsedSize() == 24)
+	{
+		return EncryptKey(key1,key2,key3);
+	}
+
+	__int64 key4 = keyData.Get<__int64>();
+	return EncryptKey(key1,key2,key3,key4);
+}
+
+/**
+ * @brief	Measures the throughput of sealing and opening UDP sized packets, compared
+ * with copying, encrypting and decrypting them using Packet::Encrypt() and Packet::Decrypt().
+ *
+ * @param	key	Key to use.
+ * @param	packetSize	Size of each packet in bytes.
+ */
+static void CipherGCMBenchmark(const EncryptKey & key, size_t packetSize)
+{
+	const size_t iterations = 20000;
+
+	Packet original;
+	original.SetMemorySize(packetSize);
+	original.SetUsedSize(packetSize);
+	memset(original.GetDataPtr(),0x5a,packetSize);
+
+	// Send operations copy the packet, then the receiver decrypts
+	DWORD startTime = GetTickCount();
+	for(size_t n = 0;n<iterations;n++)
+	{
+		Packet copy(original);
+		copy.Encrypt(key);
+		copy.Decrypt(key);
+	}
+	DWORD currentTime = GetTickCount() - startTime;
+
+	CipherGCM cipher(key);
+	unsigned char * buffer = new unsigned char[packetSize];
+	unsigned char nonce[CipherGCM::NONCE_SIZE] = {0};
+	unsigned char tag[CipherGCM::TAG_SIZE];
+
+	// Send operations seal their own copy of the packet, then the receiver opens it in place
+	startTime = GetTickCount();
+	for(size_t n = 0;n<iterations;n++)
+	{
+		memcpy(buffer,original.GetDataPtr(),packetSize);
+		nonce[11] = static_cast<unsigned char>(n);
+		cipher.Seal(buffer,packetSize,nonce,sizeof(nonce),nonce,tag);
+		cipher.Open(buffer,packetSize,nonce,sizeof(nonce),nonce,tag);
+	}
+	DWORD sealTime = GetTickCount() - startTime;
+
+	delete[] buffer;
+
+	double megabytes = static_cast<double>(packetSize) * iterations / (1024.0 * 1024.0);
+	cout << " " << packetSize << " byte packets: " << megabytes * 1000.0 / (currentTime + 1) << " MB/s with Packet::Encrypt/Decrypt, "
+		 << megabytes * 1000.0 / (sealTime + 1) << " MB/s with Seal/Open\n";
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool CipherGCM::TestClass()
+{
+	cout << "Testing CipherGCM class...\n";
+	bool problem = false;
+
+	// Test cases 2, 3, 4 and 16 from the Galois/Counter Mode specification
+	const size_t numVectors = 4;
+	const char * keys[] = {"00000000000000000000000000000000",
+						   "feffe9928665731c6d6a8f9467308308",
+						   "feffe9928665731c6d6a8f9467308308",
+						   "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308"};
+	const char * nonces[] = {"000000000000000000000000",
+							 "cafebabefacedbaddecaf888",
+							 "cafebabefacedbaddecaf888",
+							 "cafebabefacedbaddecaf888"};
+	const char * plains[] = {"00000000000000000000000000000000",
+							 "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255",
+							 "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+							 "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"};
+	const char * additional[] = {"",
+								 "",
+								 "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+								 "feedfacedeadbeeffeedfacedeadbeefabaddad2"};
+	const char * ciphers[] = {"0388dace60b6a392f328c2b971b2fe78",
+							  "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+							  "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+							  "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662"};
+	const char * tags[] = {"ab6e47d42cec13bdf53a67b21257bddf",
+						   "4d5c2af327cd64a62cf35abd2ba6fab4",
+						   "5bc94fbc3221a5db94fae95ae7121a47",
+						   "76fc6ece0f4e1768cddf8853bb2d551b"};
+
+	CipherAES::Implementation implementations[] = {CipherAES::IMPLEMENTATION_TABLE, CipherAES::IMPLEMENTATION_HARDWARE};
+	const char * implementationNames[] = {"table", "hardware"};
+	size_t numImplementations = 2;
+	if(CipherAES::IsHardwareSupported() == false || IsCarrylessMultiplySupported() == false)
+	{
+		cout << "AES-NI or carry-less multiplication is not supported by this processor, only the table implementation is tested\n";
+		numImplementations = 1;
+	}
+
+	for(size_t i = 0;i<numImplementations;i++)
+	{
+		CipherAES::SetImplementation(implementations[i]);
+
+		for(size_t v = 0;v<numVectors;v++)
+		{
+			CipherGCM cipher(CipherGCMCreateKey(keys[v]));
+
+			Packet nonce;
+			nonce.AddHex(nonces[v]);
+			Packet data;
+			data.AddHex(plains[v]);
+			Packet additionalData;
+			additionalData.AddHex(additional[v]);
+			Packet desiredCipher;
+			desiredCipher.AddHex(ciphers[v]);
+			Packet desiredTag;
+			desiredTag.AddHex(tags[v]);
+
+			unsigned char * dataPtr = reinterpret_cast<unsigned char*>(data.GetDataPtr());
+			const unsigned char * additionalPtr = reinterpret_cast<const unsigned char*>(additionalData.GetDataPtr());
+			const unsigned char * noncePtr = reinterpret_cast<const unsigned char*>(nonce.GetDataPtr());
+
+			Packet tag;
+			tag.SetMemorySize(TAG_SIZE);
+			tag.SetUsedSize(TAG_SIZE);
+			unsigned char * tagPtr = reinterpret_cast<unsigned char*>(tag.GetDataPtr());
+
+			cipher.Seal(dataPtr,data.GetUsedSize(),additionalPtr,additionalData.GetUsedSize(),noncePtr,tagPtr);
+			bool sealGood = (data == desiredCipher && tag == desiredTag);
+
+			// Modified tags must be rejected without changing the data
+			tagPtr[0] ^= 1;
+			bool rejectGood = (cipher.Open(dataPtr,data.GetUsedSize(),additionalPtr,additionalData.GetUsedSize(),noncePtr,tagPtr) == false && data == desiredCipher);
+			tagPtr[0] ^= 1;
+
+			Packet desiredPlain;
+			desiredPlain.AddHex(plains[v]);
+			bool openGood = (cipher.Open(dataPtr,data.GetUsedSize(),additionalPtr,additionalData.GetUsedSize(),noncePtr,tagPtr) == true && data == desiredPlain);
+
+			if(sealGood == false || rejectGood == false || openGood == false)
+			{
+				cout << "Test case " << v << " (" << implementationNames[i] << ") is bad\n";
+				problem = true;
+			}
+			else
+			{
+				cout << "Test case " << v << " (" << implementationNames[i] << ") is good\n";
+			}
+		}
+	}
+
+	// Both implementations must produce the same result for sizes which are not a multiple of the block size
+	{
+		const size_t randomSize = KEYSTREAM_BLOCKS * CipherAES::BLOCK_SIZE * 3 + 7;
+		unsigned char original[randomSize];
+		for(size_t n = 0;n<randomSize;n++)
+		{
+			original[n] = static_cast<unsigned char>(rand());
+		}
+
+		CipherGCM cipher(CipherGCMCreateKey("000102030405060708090a0b0c0d0e0f"));
+		unsigned char nonce[NONCE_SIZE] = {1,2,3,4,5,6,7,8,9,10,11,12};
+
+		unsigned char firstResult[randomSize];
+		unsigned char firstTag[TAG_SIZE];
+
+		for(size_t i = 0;i<numImplementations;i++)
+		{
+			CipherAES::SetImplementation(implementations[i]);
+
+			unsigned char result[randomSize];
+			unsigned char tag[TAG_SIZE];
+			memcpy(result,original,randomSize);
+			cipher.Seal(result,randomSize,original,5,nonce,tag);
+
+			if(i == 0)
+			{
+				memcpy(firstResult,result,randomSize);
+				memcpy(firstTag,tag,TAG_SIZE);
+			}
+
+			bool identical = (memcmp(result,firstResult,randomSize) == 0 && memcmp(tag,firstTag,TAG_SIZE) == 0);
+			bool roundTrip = (cipher.Open(result,randomSize,original,5,nonce,tag) == true && memcmp(result,original,randomSize) == 0);
+
+			if(identical == false || roundTrip == false)
+			{
+				cout << "Seal and Open (" << implementationNames[i] << ") are bad\n";
+				problem = true;
+			}
+			else
+			{
+				cout << "Seal and Open (" << implementationNames[i] << ") are good\n";
+			}
+		}
+	}
+	CipherAES::SetImplementation(CipherAES::IMPLEMENTATION_AUTO);
+
+	{
+		unsigned char random[32] = {0};
+		GenerateRandom(random,sizeof(random));
+
+		bool allZero = true;
+		for(size_t n = 0;n<sizeof(random);n++)
+		{
+			if(random[n] != 0)
+			{
+				allZero = false;
+			}
+		}
+
+		if(allZero == true)
+		{
+			cout << "GenerateRandom is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "GenerateRandom is good\n";
+		}
+	}
+
+	cout << "Benchmarking..\n";
+	{
+		EncryptKey key = CipherGCMCreateKey("000102030405060708090a0b0c0d0e0f");
+		CipherGCMBenchmark(key,64);
+		CipherGCMBenchmark(key,512);
+		CipherGCMBenchmark(key,1400);
+	}
+
+	cout << "\n\n";
+	return !problem;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * @brief	Galois/Counter Mode authenticated encryption, built on CipherAES.
+ *
+ * Data is encrypted using AES in counter mode and authenticated with GHASH, so that
+ * modified, truncated or forged data is detected by Open() instead of being passed
+ * on as garbage. Additional data, such as a header which must remain readable, can be
+ * authenticated without being encrypted.\n\n
+ *
+ * Unlike Packet::Encrypt(), data does not need to be padded to a multiple of CipherAES::BLOCK_SIZE
+ * and is sealed in place, so the size of data only grows by the TAG_SIZE byte tag.\n\n
+ *
+ * A nonce must never be used twice with the same key, doing so reveals the authentication key.\n\n
+ *
+ * GHASH uses carry-less multiplication instructions where the processor supports them and
+ * CipherAES is using AES-NI, and a table based software implementation otherwise.\n\n
+ *
+ * Objects are immutable after construction, so all methods are thread safe.
+ *
+ * @author	Michael Pryor
+ */
+class CipherGCM
+{
+public:
+	/** @brief Size of the authentication tag in bytes. */
+	static const size_t TAG_SIZE = 16;
+
+	/** @brief Size of the nonce in bytes. */
+	static const size_t NONCE_SIZE = 12;
+
+private:
+	/** @brief Number of counter blocks that are encrypted with one call to CipherAES::EncryptBlocks(). */
+	static const size_t KEYSTREAM_BLOCKS = 16;
+
+	/** @brief Number of rounds used by the key. */
+	unsigned char numRounds;
+
+	/** @brief Copy of the key's round keys, see EncryptKey::GetRoundKeys(). */
+	unsigned char roundKey[CipherAES::MAXIMUM_ROUND_KEY_SIZE];
+
+	/**
+	 * @brief First to fourth powers of the authentication key, one after another.
+	 *
+	 * The authentication key is a block of zeros encrypted using the key.
+	 */
+	unsigned char hashKeyPowers[4 * CipherAES::BLOCK_SIZE];
+
+	/** @brief High 64 bits of multiples of the authentication key, used by the table implementation of GHASH. */
+	unsigned long long int hashTableHigh[16];
+
+	/** @brief Low 64 bits of multiples of the authentication key, used by the table implementation of GHASH. */
+	unsigned long long int hashTableLow[16];
+
+	void MultiplyTable(unsigned char * state) const;
+	void Hash(unsigned char * state, const unsigned char * data, size_t size) const;
+	void ApplyKeystream(unsigned char * data, size_t size, const unsigned char * nonce) const;
+	void GenerateTag(const unsigned char * data, size_t size, const unsigned char * additionalData, size_t additionalDataSize, const unsigned char * nonce, unsigned char * tag) const;
+
+public:
+	CipherGCM(const EncryptKey & key);
+
+	void Seal(unsigned char * data, size_t size, const unsigned char * additionalData, size_t additionalDataSize, const unsigned char * nonce, unsigned char * tag) const;
+	bool Open(unsigned char * data, size_t size, const unsigned char * additionalData, size_t additionalDataSize, const unsigned char * nonce, const unsigned char * tag) const;
+
+	static bool IsCarrylessMultiplySupported();
+	static void GenerateRandom(unsigned char * destination, size_t size);
+
+	static bool TestClass();
+};
@@ -52,7 +52,7 @@ public:
 	bool operator==(const CompletionKey & compare) const;
 	bool operator!=(const CompletionKey & compare) const;
 
-	CompletionKey(KeyType type, NetSocket * socket = NULL, NetInstance * instance = NULL, size_t clientID = NULL);
+	CompletionKey(KeyType type, NetSocket * socket = NULL, NetInstance * instance = NULL, size_t clientID = 0);
 
 	NetSocket * GetSocket();
 	NetInstance * GetInstance();
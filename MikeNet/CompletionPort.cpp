@@ -1,5 +1,6 @@
 #include "FullInclude.h"
 
+#ifdef _WIN32
 /**
  * @brief	Constructor.
  *
@@ -19,16 +20,7 @@ CompletionPort::CompletionPort(size_t numThreads, LPTHREAD_START_ROUTINE functio
 	completionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE,NULL,NULL,static_cast<DWORD>(numThreads));
 	_ErrorException((completionPort==NULL),"creating the completion port",WSAGetLastError(),__LINE__,__FILE__);
 
-	// Setup threads that manage completion port
-	for(size_t t = 0;t<numThreads;t++)
-	{
-		ThreadSingle * newThread = new (nothrow) ThreadSingle(function,this,t);
-		Utility::DynamicAllocCheck(newThread,__LINE__,__FILE__);
-
-		newThread->Resume();
-
-		this->Add(newThread);
-	}
+	StartThreads(numThreads,function);
 }
 
 /**
@@ -60,6 +52,203 @@ void CompletionPort::PostCompletionStatus(const CompletionKey & key, DWORD numbe
 	_ErrorException((result == 0),"posting a completion status",WSAGetLastError(),__LINE__,__FILE__);
 }
 
+/**
+ * @brief	Dequeues a completion status.
+ *
+ * @param [out]	key			Destination that a pointer to the key of the completion status will be stored.
+ * @param [out]	bytes		Destination that number of bytes transferred of completion status will be stored.
+ * @param [out]	overlapped	Destination that a pointer to the overlapped structure of the completion status will be stored.
+ *
+ * @return	true if a status was successfully dequeued, false if not. 
+ */
+bool CompletionPort::GetCompletionStatus(CompletionKey *& key, DWORD & bytes, LPOVERLAPPED & overlapped)
+{
+	ULONG_PTR completionKey; // Stores a pointer to CompletionKey object
+	BOOL success = GetQueuedCompletionStatus(completionPort,&bytes,&completionKey,&overlapped,INFINITE);
+
+	key = (CompletionKey*)completionKey;
+
+	return (success != FALSE);
+}
+
+/**
+ * @brief Associates an object with the completion port, so that status indicators
+ * can be received by the completion port about that object.
+ *
+ * @param object Object to associate with completion port.
+ * @param key Key associated with object, to uniquely identify it.
+ */
+void CompletionPort::Associate(HANDLE object, const CompletionKey & key)
+{
+	HANDLE hResult = CreateIoCompletionPort(object,completionPort,(ULONG_PTR)&key,NULL);
+	_ErrorException((hResult==NULL),"associating a socket with the completion port",WSAGetLastError(),__LINE__,__FILE__);
+}
+#else
+/** @brief True if the calling thread is the worker currently in CompletionPort::WaitForEvents. */
+static __thread bool completionPortIsWaitingThread = false;
+
+/**
+ * @brief Initializes the queue of completion status' shared by all Linux completion engines.
+ */
+void CompletionPort::InitializeStatusQueue()
+{
+	waiting = false;
+	waitingThreads = 0;
+	pthread_mutex_init(&statusLock,NULL);
+	pthread_cond_init(&statusAvailable,NULL);
+}
+
+/**
+ * @brief Cleans up the queue of completion status'.
+ */
+void CompletionPort::DestroyStatusQueue()
+{
+	pthread_cond_destroy(&statusAvailable);
+	pthread_mutex_destroy(&statusLock);
+}
+
+/**
+ * @brief	Posts a completion status.
+ *
+ * @param	key							Key to use.
+ * @param	numberOfBytesTransferred	Number of bytes transferred.
+ * @param   [in]	overlapped			Overlapped structure.
+ */
+void CompletionPort::PostCompletionStatus(const CompletionKey & key, DWORD numberOfBytesTransferred, OVERLAPPED * overlapped)
+{
+	QueueCompletionStatus(&key,numberOfBytesTransferred,overlapped,0);
+}
+
+/**
+ * @brief Queues a completion status to be dequeued by a worker thread.
+ *
+ * If there are more status' queued than worker threads waiting for a status and a thread
+ * is waiting in WaitForEvents(), that thread is woken so that the status is not delayed.
+ *
+ * @param	key							Key to use.
+ * @param	numberOfBytesTransferred	Number of bytes transferred.
+ * @param   [in]	overlapped			Overlapped structure.
+ * @param	error						Winsock error code, 0 if the operation was successful.
+ */
+void CompletionPort::QueueCompletionStatus(const CompletionKey * key, DWORD numberOfBytesTransferred, OVERLAPPED * overlapped, DWORD error)
+{
+	Status status;
+	status.key = const_cast<CompletionKey*>(key);
+	status.bytes = numberOfBytesTransferred;
+	status.overlapped = overlapped;
+	status.error = error;
+
+	pthread_mutex_lock(&statusLock);
+		statusQueue.push_back(status);
+
+		bool wakeWaiter = (statusQueue.size() > waitingThreads && waiting == true && completionPortIsWaitingThread == false);
+		if(waitingThreads > 0)
+		{
+			pthread_cond_signal(&statusAvailable);
+		}
+	pthread_mutex_unlock(&statusLock);
+
+	if(wakeWaiter == true)
+	{
+		Wake();
+	}
+}
+
+/**
+ * @brief	Dequeues a completion status.
+ *
+ * If no status is available and no other worker thread is in WaitForEvents(), the calling
+ * thread waits for events itself. When it has dealt with them, another waiting thread is
+ * woken to take its place so that events continue to be dealt with while this thread
+ * deals with the completion status.
+ *
+ * @param [out]	key			Destination that a pointer to the key of the completion status will be stored.
+ * @param [out]	bytes		Destination that number of bytes transferred of completion status will be stored.
+ * @param [out]	overlapped	Destination that a pointer to the overlapped structure of the completion status will be stored.
+ *
+ * @return	true if a status was successfully dequeued, false if not. If false WSAGetLastError()
+ * returns the reason that the operation failed.
+ */
+bool CompletionPort::GetCompletionStatus(CompletionKey *& key, DWORD & bytes, LPOVERLAPPED & overlapped)
+{
+	pthread_mutex_lock(&statusLock);
+	while(statusQueue.empty() == true)
+	{
+		if(waiting == false)
+		{
+			waiting = true;
+			completionPortIsWaitingThread = true;
+			pthread_mutex_unlock(&statusLock);
+
+			WaitForEvents();
+
+			pthread_mutex_lock(&statusLock);
+			completionPortIsWaitingThread = false;
+			waiting = false;
+
+			// Hand over waiting to another thread.
+			if(waitingThreads > 0)
+			{
+				pthread_cond_signal(&statusAvailable);
+			}
+		}
+		else
+		{
+			waitingThreads++;
+			pthread_cond_wait(&statusAvailable,&statusLock);
+			waitingThreads--;
+		}
+	}
+
+	Status status = statusQueue.front();
+	statusQueue.pop_front();
+
+	// Make sure that someone is either waiting for events or dealing with the remaining status'.
+	// If no other thread is waiting for a status, the thread waiting for events must deal with them.
+	bool wakeWaiter = false;
+	if((statusQueue.empty() == false || waiting == false) && waitingThreads > 0)
+	{
+		pthread_cond_signal(&statusAvailable);
+	}
+	else if(statusQueue.empty() == false && waiting == true && completionPortIsWaitingThread == false)
+	{
+		wakeWaiter = true;
+	}
+	pthread_mutex_unlock(&statusLock);
+
+	if(wakeWaiter == true)
+	{
+		Wake();
+	}
+
+	key = status.key;
+	bytes = status.bytes;
+	overlapped = status.overlapped;
+	WSASetLastError(status.error);
+
+	return (status.error == 0);
+}
+#endif
+
+/**
+ * @brief Starts the worker threads that manage the completion port.
+ *
+ * @param numThreads Number of worker threads.
+ * @param function Function to be called by worker threads, see CompletionPort::CompletionPort.
+ */
+void CompletionPort::StartThreads(size_t numThreads, LPTHREAD_START_ROUTINE function)
+{
+	for(size_t t = 0;t<numThreads;t++)
+	{
+		ThreadSingle * newThread = new (nothrow) ThreadSingle(function,this,t);
+		Utility::DynamicAllocCheck(newThread,__LINE__,__FILE__);
+
+		newThread->Resume();
+
+		this->Add(newThread);
+	}
+}
+
 /**
  * @brief	Posts a completion status to all threads.
  *
@@ -98,39 +287,6 @@ void CompletionPort::TerminateFriendly( bool block )
 	this->WaitForThreadsToExit();
 }
 
-/**
- * @brief	Dequeues a completion status.
- *
- * @param [out]	key			Destination that a pointer to the key of the completion status will be stored.
- * @param [out]	bytes		Destination that number of bytes transferred of completion status will be stored.
- * @param [out]	overlapped	Destination that a pointer to the overlapped structure of the completion status will be stored.
- *
- * @return	true if a status was successfully dequeued, false if not. 
- */
-bool CompletionPort::GetCompletionStatus(CompletionKey *& key, DWORD & bytes, LPOVERLAPPED & overlapped)
-{
-	ULONG_PTR completionKey; // Stores a pointer to CompletionKey object
-	BOOL success = GetQueuedCompletionStatus(completionPort,&bytes,&completionKey,&overlapped,INFINITE);
-
-	key = (CompletionKey*)completionKey;
-
-	return (success != FALSE);
-}
-
-/**
- * @brief Associates an object with the completion port, so that status indicators
- * can be received by the completion port about that object.
- *
- * @param object Object to associate with completion port.
- * @param key Key associated with object, to uniquely identify it.
- */
-void CompletionPort::Associate(HANDLE object, const CompletionKey & key)
-{
-	HANDLE hResult = CreateIoCompletionPort(object,completionPort,(ULONG_PTR)&key,NULL);
-	_ErrorException((hResult==NULL),"associating a socket with the completion port",WSAGetLastError(),__LINE__,__FILE__);
-}
-
-
 /**
  * @brief Test function used by threads.
  *
@@ -1,19 +1,85 @@
 #pragma once
-#include "threadsinglegroup.h"
+#include "ThreadSingleGroup.h"
 #include "CompletionKey.h"
+#ifndef _WIN32
+	#include <pthread.h>
+	#include <deque>
+#endif
 
 DWORD WINAPI NetManageCompletionPort(LPVOID lpParameter);
 
 /**
  * @brief Manages a completion port and the threads associated with it.
+ *
+ * On Windows this wraps an I/O completion port. On Linux completion status' are
+ * generated by an engine which emulates overlapped socket operations, so that worker
+ * threads see the same CompletionKey, byte count and overlapped pointer that they would
+ * on Windows. The engine is edge triggered epoll (see CompletionPortEpoll.cpp) unless
+ * MIKENET_IO_URING is defined, in which case io_uring is used (see CompletionPortUring.cpp).
  */
 class CompletionPort :
 	protected ThreadSingleGroup
 {
+#ifdef _WIN32
 	/**
 	 * @brief Completion port.
 	 */
 	HANDLE completionPort;
+#else
+public:
+	/**
+	 * @brief A completed operation waiting to be dequeued by GetCompletionStatus().
+	 */
+	struct Status
+	{
+		/** @brief Key of object that the operation belongs to. */
+		CompletionKey * key;
+
+		/** @brief Number of bytes transferred. */
+		DWORD bytes;
+
+		/** @brief Overlapped object of the operation, may be NULL for posted status'. */
+		OVERLAPPED * overlapped;
+
+		/** @brief Winsock error code, 0 if the operation was successful. */
+		DWORD error;
+	};
+private:
+#ifdef MIKENET_IO_URING
+	/** @brief io_uring instance that operations are submitted to, see CompletionPortUring.cpp. */
+	struct UringRing * ring;
+#else
+	/** @brief epoll descriptor that associated sockets are registered with. */
+	int epollDescriptor;
+
+	/** @brief eventfd registered with CompletionPort::epollDescriptor, used to wake the waiting thread. */
+	int wakeDescriptor;
+#endif
+
+	/** @brief Protects CompletionPort::statusQueue, CompletionPort::waiting and CompletionPort::waitingThreads. */
+	pthread_mutex_t statusLock;
+
+	/** @brief Signaled when a status is queued or when a thread is needed in WaitForEvents(). */
+	pthread_cond_t statusAvailable;
+
+	/** @brief Completed operations that have not yet been dequeued. */
+	std::deque<Status> statusQueue;
+
+	/** @brief True while a worker thread is in WaitForEvents(). */
+	bool waiting;
+
+	/** @brief Number of worker threads waiting on CompletionPort::statusAvailable. */
+	size_t waitingThreads;
+
+	void InitializeStatusQueue();
+	void DestroyStatusQueue();
+	void WaitForEvents();
+	void Wake();
+public:
+	void QueueCompletionStatus(const CompletionKey * key, DWORD numberOfBytesTransferred, OVERLAPPED * overlapped, DWORD error);
+#endif
+private:
+	void StartThreads(size_t numThreads, LPTHREAD_START_ROUTINE function);
 public:
 	CompletionPort(size_t numThreads, LPTHREAD_START_ROUTINE function);
 	virtual ~CompletionPort(void);
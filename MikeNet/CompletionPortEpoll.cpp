@@ -0,0 +1,890 @@
+#include "FullInclude.h"
+#if !defined(_WIN32) && !defined(MIKENET_IO_URING)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <vector>
+
+/*
+ * Linux completion engine.
+ *
+ * Overlapped socket operations are emulated on top of edge triggered epoll:
+ * - An operation is first attempted immediately. If it completes, a completion
+ *   status is queued (as an I/O completion port would do) and the call succeeds.
+ * - If the socket is not ready the operation is stored as pending and
+ *   WSA_IO_PENDING is returned. When epoll reports readiness the polling worker
+ *   thread retries pending operations in order, queueing a status for each one that
+ *   completes.
+ * - Closing a socket aborts its pending operations with WSA_OPERATION_ABORTED.
+ *   Destroying the completion port does the same for every socket still associated
+ *   with it, as WSACleanup does on Windows, but only their events are signaled.
+ * - Batched receive operations (WSARecvFromBatch) use recvmmsg, so that every
+ *   datagram waiting on the socket, up to the size of the batch, is received with
+ *   one system call.
+ *
+ * The socket's lock is held from the first attempt until the operation is stored
+ * as pending, so an edge that arrives in between cannot be lost.
+ *
+ * Worker threads use a leader/follower model: one thread at a time waits in
+ * epoll_wait, the rest wait for completion status' to be queued.
+ */
+
+/** @brief Maximum number of buffers that may be passed to a single operation. */
+static const size_t EPOLL_MAX_BUFFERS = 8;
+
+/** @brief Maximum number of readiness events dealt with per call to epoll_wait. */
+static const int EPOLL_MAX_EVENTS = 64;
+
+/** @brief Size of the control buffer of each message received by recvmmsg, large enough for UDP_GRO. */
+static const size_t EPOLL_CONTROL_SIZE = CMSG_SPACE(sizeof(int));
+
+/**
+ * @brief An overlapped operation that has not yet completed.
+ */
+struct EpollOperation
+{
+	/** @brief Overlapped object supplied by the initiator. */
+	WSAOVERLAPPED * overlapped;
+
+	/** @brief Copy of the initiator's buffer array, data is not copied. */
+	WSABUF buffers[EPOLL_MAX_BUFFERS];
+
+	/** @brief Number of elements of EpollOperation::buffers in use. */
+	DWORD bufferCount;
+
+	/** @brief Number of bytes transferred so far, only used by stream sends. */
+	size_t transferred;
+
+	/** @brief Receive only, filled with flags describing received data. */
+	DWORD * flags;
+
+	/** @brief Receive only, filled with address that data was received from, may be NULL. */
+	SOCKADDR * address;
+
+	/** @brief Receive only, length of EpollOperation::address. */
+	int * addressLength;
+
+	/** @brief Batched receive only, messages to receive into, NULL if the operation is not batched. */
+	WSABATCHMSG * batch;
+
+	/** @brief Batched receive only, number of elements in EpollOperation::batch. */
+	DWORD batchCount;
+
+	/** @brief Batched receive only, filled with number of messages received. */
+	DWORD * batchReceived;
+
+	/** @brief Send only, address to send to. */
+	sockaddr_storage destination;
+
+	/** @brief Send only, length of EpollOperation::destination, 0 if the socket's connected address should be used. */
+	socklen_t destinationLength;
+};
+
+/**
+ * @brief Socket that is associated with a completion port.
+ */
+struct EpollSocket
+{
+	/** @brief Socket descriptor. */
+	SOCKET descriptor;
+
+	/** @brief Key passed to CompletionPort::Associate. */
+	CompletionKey * key;
+
+	/** @brief Completion port that status' are queued to, NULL once the completion port has been destroyed. */
+	CompletionPort * port;
+
+	/** @brief Event signaled when the connection is closed by the peer, see WSAEventSelect. */
+	HANDLE closeEvent;
+
+	/** @brief Protects all other members. */
+	pthread_mutex_t lock;
+
+	/** @brief Receive operations waiting for the socket to become readable, in order of initiation. */
+	std::deque<EpollOperation> pendingRecv;
+
+	/** @brief Send operations waiting for the socket to become writable, in order of initiation. */
+	std::deque<EpollOperation> pendingSend;
+};
+
+/** @brief Associated sockets indexed by descriptor. */
+static std::vector<EpollSocket*> epollSockets;
+
+/** @brief Protects epollSockets, held for writing only while sockets are associated or closed. */
+static pthread_rwlock_t epollSocketsLock = PTHREAD_RWLOCK_INITIALIZER;
+
+/**
+ * @brief Finds an associated socket and locks it.
+ *
+ * @param descriptor Socket descriptor.
+ *
+ * @return locked socket, which must be unlocked by the caller.
+ * @return NULL if the socket is not associated with a completion port.
+ */
+static EpollSocket * EpollLockSocket(SOCKET descriptor)
+{
+	EpollSocket * returnMe = NULL;
+
+	pthread_rwlock_rdlock(&epollSocketsLock);
+	if(descriptor >= 0 && static_cast<size_t>(descriptor) < epollSockets.size())
+	{
+		returnMe = epollSockets[descriptor];
+		if(returnMe != NULL)
+		{
+			pthread_mutex_lock(&returnMe->lock);
+		}
+	}
+	pthread_rwlock_unlock(&epollSocketsLock);
+
+	return returnMe;
+}
+
+/**
+ * @brief Finishes an operation, signaling its event and queuing a completion status.
+ *
+ * The overlapped object must not be used after this, because the worker thread
+ * that dequeues the status may clean it up.
+ *
+ * @param socket Socket that operation belongs to.
+ * @param operation Operation that has finished.
+ * @param bytes Number of bytes transferred.
+ * @param error Winsock error code, 0 if successful.
+ */
+static void EpollComplete(EpollSocket * socket, EpollOperation & operation, DWORD bytes, DWORD error)
+{
+	WSAOVERLAPPED * overlapped = operation.overlapped;
+	overlapped->Internal = error;
+	overlapped->InternalHigh = bytes;
+
+	SetEvent(overlapped->hEvent);
+
+	// As with an I/O completion port, operations that complete after the
+	// port has been closed only signal their event.
+	if(socket->port != NULL)
+	{
+		socket->port->QueueCompletionStatus(socket->key,bytes,overlapped,error);
+	}
+}
+
+/**
+ * @brief Attempts a batched receive operation without blocking.
+ *
+ * @param socket Socket to receive on.
+ * @param [in,out] operation Operation to attempt.
+ * @param [out] bytes Total number of bytes received in all messages.
+ * @param [out] error Winsock error code, 0 if successful.
+ *
+ * @return true if the operation finished, successfully or not.
+ * @return false if no data is available yet.
+ */
+static bool EpollAttemptRecvBatch(EpollSocket * socket, EpollOperation & operation, DWORD & bytes, DWORD & error)
+{
+	mmsghdr messages[WSA_MAX_RECV_BATCH];
+	sockaddr_storage from[WSA_MAX_RECV_BATCH];
+	char control[WSA_MAX_RECV_BATCH][EPOLL_CONTROL_SIZE];
+
+	memset(messages,0,sizeof(mmsghdr) * operation.batchCount);
+	for(DWORD n = 0;n<operation.batchCount;n++)
+	{
+		messages[n].msg_hdr.msg_iov = reinterpret_cast<iovec*>(&operation.batch[n].buffer);
+		messages[n].msg_hdr.msg_iovlen = 1;
+		messages[n].msg_hdr.msg_name = &from[n];
+		messages[n].msg_hdr.msg_namelen = sizeof(from[n]);
+		messages[n].msg_hdr.msg_control = control[n];
+		messages[n].msg_hdr.msg_controllen = EPOLL_CONTROL_SIZE;
+	}
+
+	int result;
+	do
+	{
+		result = recvmmsg(socket->descriptor,messages,operation.batchCount,0,NULL);
+	}
+	while(result == -1 && errno == EINTR);
+
+	if(result == -1)
+	{
+		if(errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			return false;
+		}
+
+		bytes = 0;
+		error = WSATranslateErrno(errno);
+		return true;
+	}
+
+	bytes = 0;
+	error = 0;
+	for(int n = 0;n<result;n++)
+	{
+		WSABATCHMSG & message = operation.batch[n];
+		message.bytes = messages[n].msg_len;
+		message.error = (messages[n].msg_hdr.msg_flags & MSG_TRUNC) ? WSAEMSGSIZE : 0;
+		message.segmentSize = 0;
+
+		for(cmsghdr * header = CMSG_FIRSTHDR(&messages[n].msg_hdr);header != NULL;header = CMSG_NXTHDR(&messages[n].msg_hdr,header))
+		{
+			if(header->cmsg_level == SOL_UDP && header->cmsg_type == UDP_GRO)
+			{
+				int segmentSize;
+				memcpy(&segmentSize,CMSG_DATA(header),sizeof(segmentSize));
+				message.segmentSize = static_cast<DWORD>(segmentSize);
+			}
+		}
+
+		if(message.from != NULL)
+		{
+			size_t length = messages[n].msg_hdr.msg_namelen;
+			if(length > static_cast<size_t>(message.fromLength))
+			{
+				length = message.fromLength;
+			}
+			memcpy(message.from,&from[n],length);
+			message.fromLength = static_cast<int>(length);
+		}
+
+		bytes += message.bytes;
+	}
+	*operation.batchReceived = static_cast<DWORD>(result);
+
+	return true;
+}
+
+/**
+ * @brief Attempts a receive operation without blocking.
+ *
+ * @param socket Socket to receive on.
+ * @param [in,out] operation Operation to attempt.
+ * @param [out] bytes Number of bytes received.
+ * @param [out] error Winsock error code, 0 if successful.
+ *
+ * @return true if the operation finished, successfully or not.
+ * @return false if no data is available yet.
+ */
+static bool EpollAttemptRecv(EpollSocket * socket, EpollOperation & operation, DWORD & bytes, DWORD & error)
+{
+	if(operation.batch != NULL)
+	{
+		return EpollAttemptRecvBatch(socket,operation,bytes,error);
+	}
+
+	msghdr message;
+	memset(&message,0,sizeof(message));
+	message.msg_iov = reinterpret_cast<iovec*>(operation.buffers);
+	message.msg_iovlen = operation.bufferCount;
+
+	sockaddr_storage from;
+	if(operation.address != NULL)
+	{
+		message.msg_name = &from;
+		message.msg_namelen = sizeof(from);
+	}
+
+	ssize_t result;
+	do
+	{
+		result = recvmsg(socket->descriptor,&message,0);
+	}
+	while(result == -1 && errno == EINTR);
+
+	if(result == -1)
+	{
+		if(errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			return false;
+		}
+
+		bytes = 0;
+		error = WSATranslateErrno(errno);
+		return true;
+	}
+
+	bytes = static_cast<DWORD>(result);
+	error = 0;
+
+	if(operation.address != NULL && operation.addressLength != NULL)
+	{
+		size_t length = message.msg_namelen;
+		if(length > static_cast<size_t>(*operation.addressLength))
+		{
+			length = *operation.addressLength;
+		}
+		memcpy(operation.address,&from,length);
+		*operation.addressLength = static_cast<int>(length);
+	}
+
+	if(operation.flags != NULL)
+	{
+		*operation.flags = 0;
+	}
+
+	// Winsock reports truncated datagrams as an error.
+	if(message.msg_flags & MSG_TRUNC)
+	{
+		error = WSAEMSGSIZE;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Attempts a send operation without blocking.
+ *
+ * Stream sockets may accept part of the data, in which case the operation
+ * remains pending until the rest has been sent.
+ *
+ * @param socket Socket to send on.
+ * @param [in,out] operation Operation to attempt.
+ * @param [out] bytes Number of bytes sent.
+ * @param [out] error Winsock error code, 0 if successful.
+ *
+ * @return true if the operation finished, successfully or not.
+ * @return false if the socket cannot accept more data yet.
+ */
+static bool EpollAttemptSend(EpollSocket * socket, EpollOperation & operation, DWORD & bytes, DWORD & error)
+{
+	// Skip data that has already been sent.
+	iovec vectors[EPOLL_MAX_BUFFERS];
+	size_t vectorCount = 0;
+	size_t total = 0;
+	size_t skip = operation.transferred;
+	for(size_t n = 0;n<operation.bufferCount;n++)
+	{
+		size_t length = operation.buffers[n].len;
+		total += length;
+
+		if(skip >= length)
+		{
+			skip -= length;
+			continue;
+		}
+
+		vectors[vectorCount].iov_base = operation.buffers[n].buf + skip;
+		vectors[vectorCount].iov_len = length - skip;
+		vectorCount++;
+		skip = 0;
+	}
+
+	msghdr message;
+	memset(&message,0,sizeof(message));
+	message.msg_iov = vectors;
+	message.msg_iovlen = vectorCount;
+	if(operation.destinationLength > 0)
+	{
+		message.msg_name = &operation.destination;
+		message.msg_namelen = operation.destinationLength;
+	}
+
+	ssize_t result;
+	do
+	{
+		result = sendmsg(socket->descriptor,&message,MSG_NOSIGNAL);
+	}
+	while(result == -1 && errno == EINTR);
+
+	if(result == -1)
+	{
+		if(errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			return false;
+		}
+
+		bytes = static_cast<DWORD>(operation.transferred);
+		error = WSATranslateErrno(errno);
+		return true;
+	}
+
+	operation.transferred += result;
+	if(operation.transferred < total)
+	{
+		return false;
+	}
+
+	bytes = static_cast<DWORD>(operation.transferred);
+	error = 0;
+	return true;
+}
+
+/**
+ * @brief Retries pending operations after epoll reports readiness.
+ *
+ * @param descriptor Socket descriptor.
+ * @param events epoll event flags.
+ */
+static void EpollDealWithReadiness(SOCKET descriptor, uint32_t events)
+{
+	EpollSocket * socket = EpollLockSocket(descriptor);
+	if(socket == NULL)
+	{
+		return;
+	}
+
+	DWORD bytes = 0;
+	DWORD error = 0;
+
+	if(events & (EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP))
+	{
+		while(socket->pendingRecv.empty() == false && EpollAttemptRecv(socket,socket->pendingRecv.front(),bytes,error) == true)
+		{
+			EpollComplete(socket,socket->pendingRecv.front(),bytes,error);
+			socket->pendingRecv.pop_front();
+		}
+	}
+
+	if(events & (EPOLLOUT | EPOLLERR | EPOLLHUP))
+	{
+		while(socket->pendingSend.empty() == false && EpollAttemptSend(socket,socket->pendingSend.front(),bytes,error) == true)
+		{
+			EpollComplete(socket,socket->pendingSend.front(),bytes,error);
+			socket->pendingSend.pop_front();
+		}
+	}
+
+	if((events & (EPOLLRDHUP | EPOLLHUP)) && socket->closeEvent != NULL)
+	{
+		SetEvent(socket->closeEvent);
+	}
+
+	pthread_mutex_unlock(&socket->lock);
+}
+
+/**
+ * @brief Initializes an operation from the parameters of a winsock call.
+ *
+ * @param [out] operation Operation to initialize.
+ * @param buffers Buffer array.
+ * @param bufferCount Number of elements in @a buffers.
+ * @param overlapped Overlapped object.
+ *
+ * @return true if successful, false if too many buffers were specified.
+ */
+static bool EpollInitializeOperation(EpollOperation & operation, LPWSABUF buffers, DWORD bufferCount, LPWSAOVERLAPPED overlapped)
+{
+	if(bufferCount > EPOLL_MAX_BUFFERS || overlapped == NULL)
+	{
+		return false;
+	}
+
+	operation.overlapped = overlapped;
+	memcpy(operation.buffers,buffers,sizeof(WSABUF) * bufferCount);
+	operation.bufferCount = bufferCount;
+	operation.transferred = 0;
+	operation.flags = NULL;
+	operation.address = NULL;
+	operation.addressLength = NULL;
+	operation.batch = NULL;
+	operation.batchCount = 0;
+	operation.batchReceived = NULL;
+	operation.destinationLength = 0;
+	return true;
+}
+
+/**
+ * @brief Starts an overlapped operation.
+ *
+ * @param descriptor Socket descriptor.
+ * @param operation Operation to start.
+ * @param recv True if the operation is a receive, false if it is a send.
+ * @param [out] bytesTransferred Number of bytes transferred if the operation completed immediately, may be NULL.
+ *
+ * @return 0 if the operation completed immediately, SOCKET_ERROR if not.
+ * WSAGetLastError() returns WSA_IO_PENDING if the operation will complete later.
+ */
+static int EpollStartOperation(SOCKET descriptor, EpollOperation & operation, bool recv, DWORD * bytesTransferred)
+{
+	EpollSocket * socket = EpollLockSocket(descriptor);
+	if(socket == NULL)
+	{
+		WSASetLastError(WSAENOTSOCK);
+		return SOCKET_ERROR;
+	}
+
+	ResetEvent(operation.overlapped->hEvent);
+
+	std::deque<EpollOperation> & pending = recv ? socket->pendingRecv : socket->pendingSend;
+
+	// Operations must complete in the order that they were initiated,
+	// so only attempt immediately if nothing else is waiting.
+	if(pending.empty() == true)
+	{
+		DWORD bytes = 0;
+		DWORD error = 0;
+		bool finished = recv ? EpollAttemptRecv(socket,operation,bytes,error) : EpollAttemptSend(socket,operation,bytes,error);
+
+		if(finished == true)
+		{
+			// Operations that fail immediately do not generate a completion status.
+			if(error != 0)
+			{
+				pthread_mutex_unlock(&socket->lock);
+				WSASetLastError(error);
+				return SOCKET_ERROR;
+			}
+
+			if(bytesTransferred != NULL)
+			{
+				*bytesTransferred = bytes;
+			}
+
+			EpollComplete(socket,operation,bytes,error);
+			pthread_mutex_unlock(&socket->lock);
+			return 0;
+		}
+	}
+
+	pending.push_back(operation);
+	pthread_mutex_unlock(&socket->lock);
+
+	WSASetLastError(WSA_IO_PENDING);
+	return SOCKET_ERROR;
+}
+
+/**
+ * @brief Starts an overlapped receive operation on a connected socket.
+ *
+ * See the winsock documentation of WSARecv for more information.
+ */
+int WSARecv(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesReceived, DWORD * flags, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine)
+{
+	return WSARecvFrom(socket,buffers,bufferCount,bytesReceived,flags,NULL,NULL,overlapped,completionRoutine);
+}
+
+/**
+ * @brief Starts an overlapped receive operation.
+ *
+ * See the winsock documentation of WSARecvFrom for more information.
+ */
+int WSARecvFrom(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesReceived, DWORD * flags, SOCKADDR * from, int * fromLength, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine)
+{
+	EpollOperation operation;
+	if(completionRoutine != NULL || EpollInitializeOperation(operation,buffers,bufferCount,overlapped) == false)
+	{
+		WSASetLastError(WSAEINVAL);
+		return SOCKET_ERROR;
+	}
+
+	operation.flags = flags;
+	operation.address = from;
+	operation.addressLength = fromLength;
+
+	return EpollStartOperation(socket,operation,true,bytesReceived);
+}
+
+/**
+ * @brief Starts an overlapped receive operation that receives up to @a messageCount datagrams
+ * with one call to recvmmsg.
+ *
+ * The operation completes as soon as at least one datagram is available. The completion status
+ * reports the total number of bytes received in all messages.
+ *
+ * @param socket Datagram socket.
+ * @param [in,out] messages Messages to receive into, must remain valid until the operation completes.
+ * @param messageCount Number of elements in @a messages, at most WSA_MAX_RECV_BATCH.
+ * @param [out] messagesReceived Filled with number of messages received when the operation completes.
+ * @param overlapped Overlapped object of operation.
+ *
+ * @return 0 if the operation completed immediately, SOCKET_ERROR if not.
+ * WSAGetLastError() returns WSA_IO_PENDING if the operation will complete later.
+ */
+int WSARecvFromBatch(SOCKET socket, WSABATCHMSG * messages, DWORD messageCount, DWORD * messagesReceived, LPWSAOVERLAPPED overlapped)
+{
+	EpollOperation operation;
+	if(messages == NULL || messageCount == 0 || messageCount > WSA_MAX_RECV_BATCH || messagesReceived == NULL ||
+	   EpollInitializeOperation(operation,NULL,0,overlapped) == false)
+	{
+		WSASetLastError(WSAEINVAL);
+		return SOCKET_ERROR;
+	}
+
+	operation.batch = messages;
+	operation.batchCount = messageCount;
+	operation.batchReceived = messagesReceived;
+
+	return EpollStartOperation(socket,operation,true,NULL);
+}
+
+/**
+ * @brief Starts an overlapped send operation on a connected socket.
+ *
+ * See the winsock documentation of WSASend for more information.
+ */
+int WSASend(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesSent, DWORD flags, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine)
+{
+	return WSASendTo(socket,buffers,bufferCount,bytesSent,flags,NULL,0,overlapped,completionRoutine);
+}
+
+/**
+ * @brief Starts an overlapped send operation.
+ *
+ * See the winsock documentation of WSASendTo for more information.
+ * Flags are not supported, @a flags must be 0.
+ */
+int WSASendTo(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesSent, DWORD flags, const SOCKADDR * to, int toLength, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine)
+{
+	EpollOperation operation;
+	if(completionRoutine != NULL || flags != 0 || EpollInitializeOperation(operation,buffers,bufferCount,overlapped) == false ||
+	   toLength < 0 || static_cast<size_t>(toLength) > sizeof(operation.destination))
+	{
+		WSASetLastError(WSAEINVAL);
+		return SOCKET_ERROR;
+	}
+
+	if(to != NULL)
+	{
+		memcpy(&operation.destination,to,toLength);
+		operation.destinationLength = toLength;
+	}
+
+	return EpollStartOperation(socket,operation,false,bytesSent);
+}
+
+/**
+ * @brief Requests that an event be signaled when the connection is closed by the peer.
+ *
+ * Only FD_CLOSE is supported, and the socket must already be associated with a completion port.
+ *
+ * @param socket Socket to monitor.
+ * @param event Event to signal.
+ * @param networkEvents Must be FD_CLOSE.
+ *
+ * @return 0 if successful, SOCKET_ERROR if not.
+ */
+int WSAEventSelect(SOCKET socket, HANDLE event, long networkEvents)
+{
+	if(networkEvents != FD_CLOSE)
+	{
+		WSASetLastError(WSAEINVAL);
+		return SOCKET_ERROR;
+	}
+
+	EpollSocket * epollSocket = EpollLockSocket(socket);
+	if(epollSocket == NULL)
+	{
+		WSASetLastError(WSAENOTSOCK);
+		return SOCKET_ERROR;
+	}
+
+	epollSocket->closeEvent = event;
+	pthread_mutex_unlock(&epollSocket->lock);
+	return 0;
+}
+
+/**
+ * @brief Aborts all pending operations of a socket with WSA_OPERATION_ABORTED.
+ *
+ * The socket's lock must be held.
+ *
+ * @param socket Socket whose operations should be aborted.
+ */
+static void EpollAbortPending(EpollSocket * socket)
+{
+	while(socket->pendingRecv.empty() == false)
+	{
+		EpollComplete(socket,socket->pendingRecv.front(),0,WSA_OPERATION_ABORTED);
+		socket->pendingRecv.pop_front();
+	}
+
+	while(socket->pendingSend.empty() == false)
+	{
+		EpollComplete(socket,socket->pendingSend.front(),static_cast<DWORD>(socket->pendingSend.front().transferred),WSA_OPERATION_ABORTED);
+		socket->pendingSend.pop_front();
+	}
+}
+
+/**
+ * @brief Closes a socket, aborting all of its pending operations.
+ *
+ * A completion status with error WSA_OPERATION_ABORTED is queued for
+ * every operation that had not completed.
+ *
+ * @param socket Socket to close.
+ *
+ * @return 0 if successful, SOCKET_ERROR if not.
+ */
+int closesocket(SOCKET socket)
+{
+	EpollSocket * epollSocket = NULL;
+
+	// Once removed no other thread can find the socket, so when we
+	// have acquired its lock we are the only user.
+	pthread_rwlock_wrlock(&epollSocketsLock);
+	if(socket >= 0 && static_cast<size_t>(socket) < epollSockets.size())
+	{
+		epollSocket = epollSockets[socket];
+		epollSockets[socket] = NULL;
+	}
+	pthread_rwlock_unlock(&epollSocketsLock);
+
+	if(epollSocket != NULL)
+	{
+		pthread_mutex_lock(&epollSocket->lock);
+		EpollAbortPending(epollSocket);
+
+		// Closing the descriptor removes it from the epoll set.
+		pthread_mutex_unlock(&epollSocket->lock);
+		pthread_mutex_destroy(&epollSocket->lock);
+		delete epollSocket;
+	}
+
+	if(close(socket) == -1)
+	{
+		WSASetLastError(WSATranslateErrno(errno));
+		return SOCKET_ERROR;
+	}
+	return 0;
+}
+
+/**
+ * @brief	Constructor.
+ *
+ * @param numThreads Number of worker threads that will manage completion port. Threads must
+ * exit without dealing with further completion status' when CompletionKey::SHUTDOWN notification is
+ * received.
+ * @param function Function to be called by worker threads. Function is passed a pointer to
+ * the ThreadSingle object that is managing it. ThreadSingle::GetParameter() will return a
+ * a pointer to the CompletionPort object that it is associated with. ThreadSingle::GetManualThreadID()
+ * will return a unique thread ID that should be used by the thread when calling any method requiring a thread ID.
+ */
+CompletionPort::CompletionPort(size_t numThreads, LPTHREAD_START_ROUTINE function)
+{
+	_ErrorException((numThreads == 0),"starting the completion port, number of threads is 0",0,__LINE__,__FILE__);
+
+	InitializeStatusQueue();
+
+	epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+	_ErrorException((epollDescriptor == -1),"creating the completion port",WSATranslateErrno(errno),__LINE__,__FILE__);
+
+	wakeDescriptor = eventfd(0,EFD_NONBLOCK | EFD_CLOEXEC);
+	_ErrorException((wakeDescriptor == -1),"creating the completion port wake event",WSATranslateErrno(errno),__LINE__,__FILE__);
+
+	epoll_event event;
+	event.events = EPOLLIN | EPOLLET;
+	event.data.fd = wakeDescriptor;
+	int result = epoll_ctl(epollDescriptor,EPOLL_CTL_ADD,wakeDescriptor,&event);
+	_ErrorException((result == -1),"registering the completion port wake event",WSATranslateErrno(errno),__LINE__,__FILE__);
+
+	StartThreads(numThreads,function);
+}
+
+/**
+ * @brief	Destructor.
+ */
+CompletionPort::~CompletionPort(void)
+{
+	const char * cCommand = "an internal function (~CompletionPort)";
+	try
+	{
+		this->TerminateFriendly(true);
+
+		// Sockets may outlive the completion port. Without it their pending operations
+		// can never complete, so they are aborted, only signaling their events.
+		pthread_rwlock_wrlock(&epollSocketsLock);
+		for(size_t n = 0;n<epollSockets.size();n++)
+		{
+			EpollSocket * socket = epollSockets[n];
+			if(socket != NULL && socket->port == this)
+			{
+				pthread_mutex_lock(&socket->lock);
+				socket->port = NULL;
+				EpollAbortPending(socket);
+				pthread_mutex_unlock(&socket->lock);
+			}
+		}
+		pthread_rwlock_unlock(&epollSocketsLock);
+
+		close(wakeDescriptor);
+		close(epollDescriptor);
+		DestroyStatusQueue();
+	}
+	MSG_CATCH
+}
+
+/**
+ * @brief Waits for readiness notifications and retries pending operations.
+ *
+ * Must only be called by one thread at a time, see CompletionPort::waiting.
+ */
+void CompletionPort::WaitForEvents()
+{
+	epoll_event events[EPOLL_MAX_EVENTS];
+
+	int amount;
+	do
+	{
+		amount = epoll_wait(epollDescriptor,events,EPOLL_MAX_EVENTS,-1);
+	}
+	while(amount == -1 && errno == EINTR);
+
+	for(int n = 0;n<amount;n++)
+	{
+		if(events[n].data.fd == wakeDescriptor)
+		{
+			uint64_t value;
+			while(read(wakeDescriptor,&value,sizeof(value)) > 0);
+		}
+		else
+		{
+			EpollDealWithReadiness(events[n].data.fd,events[n].events);
+		}
+	}
+}
+
+/**
+ * @brief Wakes the thread that is waiting in WaitForEvents().
+ */
+void CompletionPort::Wake()
+{
+	uint64_t value = 1;
+	ssize_t result = write(wakeDescriptor,&value,sizeof(value));
+	(void)result;
+}
+
+/**
+ * @brief Associates an object with the completion port, so that status indicators
+ * can be received by the completion port about that object.
+ *
+ * @param object Socket descriptor to associate with completion port.
+ * @param key Key associated with object, to uniquely identify it.
+ */
+void CompletionPort::Associate(HANDLE object, const CompletionKey & key)
+{
+	SOCKET descriptor = static_cast<SOCKET>(reinterpret_cast<INT_PTR>(object));
+	_ErrorException((descriptor < 0),"associating a socket with the completion port, invalid socket",0,__LINE__,__FILE__);
+
+	int flags = fcntl(descriptor,F_GETFL,0);
+	_ErrorException((flags == -1 || fcntl(descriptor,F_SETFL,flags | O_NONBLOCK) == -1),"associating a socket with the completion port, could not make socket non blocking",WSATranslateErrno(errno),__LINE__,__FILE__);
+
+	EpollSocket * socket = new (nothrow) EpollSocket();
+	Utility::DynamicAllocCheck(socket,__LINE__,__FILE__);
+	socket->descriptor = descriptor;
+	socket->key = const_cast<CompletionKey*>(&key);
+	socket->port = this;
+	socket->closeEvent = NULL;
+	pthread_mutex_init(&socket->lock,NULL);
+
+	EpollSocket * previous = NULL;
+	pthread_rwlock_wrlock(&epollSocketsLock);
+		if(static_cast<size_t>(descriptor) >= epollSockets.size())
+		{
+			epollSockets.resize(descriptor + 1,NULL);
+		}
+		previous = epollSockets[descriptor];
+		epollSockets[descriptor] = socket;
+	pthread_rwlock_unlock(&epollSocketsLock);
+
+	// Descriptor was closed without using closesocket and has been reused.
+	if(previous != NULL)
+	{
+		pthread_mutex_lock(&previous->lock);
+		pthread_mutex_unlock(&previous->lock);
+		pthread_mutex_destroy(&previous->lock);
+		delete previous;
+	}
+
+	epoll_event event;
+	event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+	event.data.fd = descriptor;
+	int result = epoll_ctl(epollDescriptor,EPOLL_CTL_ADD,descriptor,&event);
+	_ErrorException((result == -1),"associating a socket with the completion port",WSATranslateErrno(errno),__LINE__,__FILE__);
+}
+
+#endif
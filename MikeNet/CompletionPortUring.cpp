@@ -0,0 +1,1575 @@
+#include "FullInclude.h"
+#if !defined(_WIN32) && defined(MIKENET_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <vector>
+
+/*
+ * Linux io_uring completion engine, used instead of the epoll engine when
+ * MIKENET_IO_URING is defined. Requires Linux 6.0 or later.
+ *
+ * Receiving:
+ * - Each socket has a provided buffer ring, created when its first receive operation
+ *   is started and sized to fit that operation's buffer.
+ * - A single multishot receive (recvmsg for datagram sockets, recv for stream sockets)
+ *   is kept armed on each socket. The kernel places each datagram or chunk of stream
+ *   data into a provided buffer and posts a completion queue entry without the receive
+ *   needing to be started again.
+ * - Data that arrives while no WSARecv/WSARecvFrom operation is pending is kept in its
+ *   provided buffer. The next operation is then satisfied in user space without
+ *   a system call, and the buffer is returned to the ring.
+ * - If the ring runs out of buffers the kernel ends the multishot receive. It is
+ *   armed again when the next operation finds no data waiting.
+ * - Batched receive operations (WSARecvFromBatch) take every datagram that is waiting,
+ *   up to the size of the batch, so under load many datagrams are handed over at once.
+ *   Completion queue entries that are already waiting are included, rather than
+ *   completing the operation with the first of them.
+ * - Received data is copied from the provided buffer into the operation's buffers, which
+ *   is what the winsock interface expects. The provided buffer goes back to the ring
+ *   straight away rather than being held while the data is dealt with, so that the ring
+ *   does not run dry and end the multishot receive while worker threads are busy. This
+ *   costs one copy of each datagram (at most the size of the receive buffer), which
+ *   epoll's recvmsg into the operation's buffers does not.
+ *
+ * Sending:
+ * - Sends are first attempted with a non blocking sendmsg. If the socket cannot
+ *   accept the data the send is submitted to the ring, which waits for the socket
+ *   internally. Only one send per stream socket is in the ring at a time so that
+ *   data is sent in order.
+ *
+ * Closing a socket cancels all of its requests. The socket's state is cleaned up
+ * when the kernel has posted the final completion for each of them. Destroying the
+ * completion port does the same for every socket still associated with it, as
+ * WSACleanup does on Windows, but only the events of their operations are signaled.
+ *
+ * Worker threads share the completion status queue in CompletionPort.cpp; the thread
+ * in WaitForEvents() waits in io_uring_enter and converts completion queue entries into
+ * completion status'.
+ */
+
+/** @brief Number of submission queue entries. */
+static const unsigned URING_ENTRIES = 1024;
+
+/** @brief Number of provided buffers per socket, must be a power of 2. */
+static const unsigned URING_BUFFERS_PER_SOCKET = 64;
+
+/** @brief Maximum number of buffers that may be passed to a single operation. */
+static const size_t URING_MAX_BUFFERS = 8;
+
+/** @brief Buffer ID indicating that received data is not stored in a provided buffer. */
+static const unsigned short URING_NO_BUFFER = 0xFFFF;
+
+/** @brief Size of the control data received with each datagram, large enough for UDP_GRO. */
+static const size_t URING_CONTROL_SIZE = CMSG_SPACE(sizeof(int));
+
+/**
+ * @brief Submission and completion queues of an io_uring instance, shared with the kernel.
+ */
+struct UringRing
+{
+	/** @brief io_uring descriptor. */
+	int descriptor;
+
+	/** @brief Submission queue, see io_uring documentation. */
+	unsigned * sqHead;
+	unsigned * sqTail;
+	unsigned sqMask;
+	unsigned * sqArray;
+	io_uring_sqe * sqes;
+
+	/** @brief Completion queue, see io_uring documentation. */
+	unsigned * cqHead;
+	unsigned * cqTail;
+	unsigned cqMask;
+	io_uring_cqe * cqes;
+
+	/** @brief Mapped memory, unmapped when the ring is cleaned up. */
+	void * sqMap;
+	size_t sqMapSize;
+	void * cqMap;
+	size_t cqMapSize;
+	size_t sqesSize;
+
+	/** @brief Protects the submission queue and UringRing::freeBufferGroups. */
+	pthread_mutex_t submitLock;
+
+	/** @brief Buffer group IDs that are not in use. */
+	std::vector<unsigned short> freeBufferGroups;
+
+	/** @brief Number of sockets using the ring that have not been cleaned up, protected by UringRing::submitLock. */
+	size_t sockets;
+};
+
+struct UringSocket;
+
+/** @brief Purpose of a request submitted to the ring. */
+enum UringRequestType
+{
+	/** Multishot receive, there is one per socket. */
+	URING_RECV,
+
+	/** Send operation. */
+	URING_SEND
+};
+
+/**
+ * @brief Request submitted to the ring, identified by the completion queue entry's user data.
+ *
+ * Requests with user data of 0 (wake and cancel requests) need no further action on completion.
+ */
+struct UringRequest
+{
+	/** @brief Purpose of request. */
+	UringRequestType type;
+
+	/** @brief Socket that request belongs to. */
+	UringSocket * socket;
+};
+
+/**
+ * @brief Send operation.
+ */
+struct UringSend : public UringRequest
+{
+	/** @brief Overlapped object supplied by the initiator. */
+	WSAOVERLAPPED * overlapped;
+
+	/** @brief Data remaining to be sent. */
+	iovec vectors[URING_MAX_BUFFERS];
+
+	/** @brief Message passed to sendmsg. */
+	msghdr message;
+
+	/** @brief Address to send to, unused if UringSend::message has no name. */
+	sockaddr_storage destination;
+
+	/** @brief Total number of bytes to send. */
+	size_t total;
+
+	/** @brief Number of bytes sent so far. */
+	size_t transferred;
+};
+
+/**
+ * @brief Receive operation waiting for data.
+ */
+struct UringRecvOperation
+{
+	/** @brief Overlapped object supplied by the initiator. */
+	WSAOVERLAPPED * overlapped;
+
+	/** @brief Copy of the initiator's buffer array. */
+	WSABUF buffers[URING_MAX_BUFFERS];
+
+	/** @brief Number of elements of UringRecvOperation::buffers in use. */
+	DWORD bufferCount;
+
+	/** @brief Filled with flags describing received data, may be NULL. */
+	DWORD * flags;
+
+	/** @brief Filled with address that data was received from, may be NULL. */
+	SOCKADDR * address;
+
+	/** @brief Length of UringRecvOperation::address. */
+	int * addressLength;
+
+	/** @brief Batched receive only, messages to receive into, NULL if the operation is not batched. */
+	WSABATCHMSG * batch;
+
+	/** @brief Batched receive only, number of elements in UringRecvOperation::batch. */
+	DWORD batchCount;
+
+	/** @brief Batched receive only, filled with number of messages received. */
+	DWORD * batchReceived;
+};
+
+/**
+ * @brief Data or an error received by the multishot receive that has not yet been consumed.
+ */
+struct UringReceived
+{
+	/** @brief Provided buffer that data is stored in, or URING_NO_BUFFER. */
+	unsigned short bufferID;
+
+	/** @brief Received data. */
+	const char * data;
+
+	/** @brief Number of bytes in UringReceived::data. */
+	size_t length;
+
+	/** @brief Number of bytes already consumed, only used by stream sockets. */
+	size_t offset;
+
+	/** @brief True if the datagram was larger than the buffer. */
+	bool truncated;
+
+	/** @brief Size of each datagram if UDP receive coalescing merged several datagrams, 0 if not. */
+	DWORD segmentSize;
+
+	/** @brief Winsock error code, 0 if data was received. */
+	DWORD error;
+
+	/** @brief Address that data was received from. */
+	sockaddr_storage from;
+
+	/** @brief Length of UringReceived::from. */
+	socklen_t fromLength;
+};
+
+/**
+ * @brief Socket that is associated with a completion port.
+ */
+struct UringSocket
+{
+	/** @brief Socket descriptor. */
+	SOCKET descriptor;
+
+	/** @brief True if the socket is a stream (TCP) socket. */
+	bool stream;
+
+	/** @brief Key passed to CompletionPort::Associate. */
+	CompletionKey * key;
+
+	/** @brief Completion port that status' are queued to, NULL once the completion port is being destroyed. */
+	CompletionPort * port;
+
+	/** @brief Ring that requests are submitted to. */
+	UringRing * ring;
+
+	/** @brief Event signaled when the connection is closed by the peer, see WSAEventSelect. */
+	HANDLE closeEvent;
+
+	/** @brief Protects all other members. */
+	pthread_mutex_t lock;
+
+	/** @brief True after closesocket, no further requests are submitted. */
+	bool closed;
+
+	/** @brief Number of requests in the ring that refer to this socket. */
+	size_t inFlight;
+
+	/** @brief The multishot receive request. */
+	UringRequest recvRequest;
+
+	/** @brief True while the multishot receive is armed. */
+	bool recvArmed;
+
+	/** @brief Message template used by multishot recvmsg. */
+	msghdr recvTemplate;
+
+	/** @brief Provided buffer ring, NULL until the first receive operation. */
+	io_uring_buf_ring * bufferRing;
+
+	/** @brief Memory that provided buffers are allocated from. */
+	char * bufferMemory;
+
+	/** @brief Size of each provided buffer. */
+	size_t bufferSize;
+
+	/** @brief Buffer group ID of UringSocket::bufferRing. */
+	unsigned short bufferGroup;
+
+	/** @brief Tail of UringSocket::bufferRing, advanced as buffers are returned. */
+	unsigned short bufferTail;
+
+	/** @brief Received data waiting for a receive operation. */
+	std::deque<UringReceived> received;
+
+	/** @brief Receive operations waiting for data, in order of initiation. */
+	std::deque<UringRecvOperation> pendingRecv;
+
+	/** @brief Stream sockets only, true while a send is in the ring. */
+	bool sendInFlight;
+
+	/** @brief Stream sockets only, sends waiting for the send in the ring to complete. */
+	std::deque<UringSend*> queuedSend;
+};
+
+/** @brief Associated sockets indexed by descriptor. */
+static std::vector<UringSocket*> uringSockets;
+
+/** @brief Protects uringSockets, held for writing only while sockets are associated or closed. */
+static pthread_rwlock_t uringSocketsLock = PTHREAD_RWLOCK_INITIALIZER;
+
+/**
+ * @brief Gets a free submission queue entry, submitting queued entries if the queue is full.
+ *
+ * UringRing::submitLock must be held.
+ *
+ * @param ring Ring to use.
+ *
+ * @return cleared submission queue entry.
+ */
+static io_uring_sqe * UringGetSqe(UringRing * ring)
+{
+	unsigned tail = *ring->sqTail;
+	while(tail - __atomic_load_n(ring->sqHead,__ATOMIC_ACQUIRE) >= URING_ENTRIES)
+	{
+		syscall(__NR_io_uring_enter,ring->descriptor,tail - __atomic_load_n(ring->sqHead,__ATOMIC_ACQUIRE),0,0,NULL,0);
+	}
+
+	io_uring_sqe * sqe = &ring->sqes[tail & ring->sqMask];
+	memset(sqe,0,sizeof(io_uring_sqe));
+	return sqe;
+}
+
+/**
+ * @brief Submits the entry most recently returned by UringGetSqe().
+ *
+ * UringRing::submitLock must be held.
+ *
+ * @param ring Ring to use.
+ */
+static void UringSubmit(UringRing * ring)
+{
+	unsigned tail = *ring->sqTail;
+	ring->sqArray[tail & ring->sqMask] = tail & ring->sqMask;
+	__atomic_store_n(ring->sqTail,tail + 1,__ATOMIC_RELEASE);
+
+	int result;
+	do
+	{
+		result = static_cast<int>(syscall(__NR_io_uring_enter,ring->descriptor,1,0,0,NULL,0));
+	}
+	while(result == -1 && (errno == EINTR || errno == EAGAIN || errno == EBUSY));
+}
+
+/**
+ * @brief Finds an associated socket and locks it.
+ *
+ * @param descriptor Socket descriptor.
+ *
+ * @return locked socket, which must be unlocked by the caller.
+ * @return NULL if the socket is not associated with a completion port.
+ */
+static UringSocket * UringLockSocket(SOCKET descriptor)
+{
+	UringSocket * returnMe = NULL;
+
+	pthread_rwlock_rdlock(&uringSocketsLock);
+	if(descriptor >= 0 && static_cast<size_t>(descriptor) < uringSockets.size())
+	{
+		returnMe = uringSockets[descriptor];
+		if(returnMe != NULL)
+		{
+			pthread_mutex_lock(&returnMe->lock);
+		}
+	}
+	pthread_rwlock_unlock(&uringSocketsLock);
+
+	return returnMe;
+}
+
+/**
+ * @brief Cleans up a socket once it is closed and has no requests in the ring.
+ *
+ * @param socket Socket to clean up, must not be locked.
+ */
+static void UringDestroySocket(UringSocket * socket)
+{
+	if(socket->bufferRing != NULL)
+	{
+		io_uring_buf_reg reg;
+		memset(&reg,0,sizeof(reg));
+		reg.bgid = socket->bufferGroup;
+		syscall(__NR_io_uring_register,socket->ring->descriptor,IORING_UNREGISTER_PBUF_RING,&reg,1);
+
+		pthread_mutex_lock(&socket->ring->submitLock);
+		socket->ring->freeBufferGroups.push_back(socket->bufferGroup);
+		pthread_mutex_unlock(&socket->ring->submitLock);
+
+		munmap(socket->bufferRing,URING_BUFFERS_PER_SOCKET * sizeof(io_uring_buf));
+		delete[] socket->bufferMemory;
+	}
+
+	pthread_mutex_lock(&socket->ring->submitLock);
+	socket->ring->sockets--;
+	pthread_mutex_unlock(&socket->ring->submitLock);
+
+	pthread_mutex_destroy(&socket->lock);
+	delete socket;
+}
+
+/**
+ * @brief Returns a provided buffer to the socket's buffer ring.
+ *
+ * @param socket Socket that buffer belongs to.
+ * @param bufferID ID of buffer.
+ */
+static void UringRecycleBuffer(UringSocket * socket, unsigned short bufferID)
+{
+	if(bufferID == URING_NO_BUFFER)
+	{
+		return;
+	}
+
+	// io_uring_buf_ring::bufs is declared in a way that C++ offsets from
+	// the start of the ring, so index the ring as an array directly.
+	io_uring_buf * buffer = reinterpret_cast<io_uring_buf*>(socket->bufferRing) + (socket->bufferTail & (URING_BUFFERS_PER_SOCKET - 1));
+	buffer->addr = reinterpret_cast<uintptr_t>(socket->bufferMemory + bufferID * socket->bufferSize);
+	buffer->len = static_cast<unsigned int>(socket->bufferSize);
+	buffer->bid = bufferID;
+
+	socket->bufferTail++;
+	__atomic_store_n(&socket->bufferRing->tail,socket->bufferTail,__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Creates the socket's provided buffer ring.
+ *
+ * @param socket Socket to create ring for.
+ * @param capacity Maximum amount of data to receive into each buffer.
+ *
+ * @return true if successful.
+ */
+static bool UringSetupBuffers(UringSocket * socket, size_t capacity)
+{
+	UringRing * ring = socket->ring;
+
+	pthread_mutex_lock(&ring->submitLock);
+	bool groupAvailable = (ring->freeBufferGroups.empty() == false);
+	if(groupAvailable == true)
+	{
+		socket->bufferGroup = ring->freeBufferGroups.back();
+		ring->freeBufferGroups.pop_back();
+	}
+	pthread_mutex_unlock(&ring->submitLock);
+
+	if(groupAvailable == false)
+	{
+		return false;
+	}
+
+	// Datagrams are received with recvmsg, which stores a header and the
+	// source address before the data.
+	socket->bufferSize = capacity;
+	if(socket->stream == false)
+	{
+		socket->bufferSize += sizeof(io_uring_recvmsg_out) + socket->recvTemplate.msg_namelen + socket->recvTemplate.msg_controllen;
+	}
+
+	void * ringMemory = mmap(NULL,URING_BUFFERS_PER_SOCKET * sizeof(io_uring_buf),PROT_READ | PROT_WRITE,MAP_ANONYMOUS | MAP_PRIVATE,-1,0);
+	socket->bufferMemory = new (nothrow) char[socket->bufferSize * URING_BUFFERS_PER_SOCKET];
+	if(ringMemory == MAP_FAILED || socket->bufferMemory == NULL)
+	{
+		if(ringMemory != MAP_FAILED)
+		{
+			munmap(ringMemory,URING_BUFFERS_PER_SOCKET * sizeof(io_uring_buf));
+		}
+		delete[] socket->bufferMemory;
+		socket->bufferMemory = NULL;
+		return false;
+	}
+
+	io_uring_buf_reg reg;
+	memset(&reg,0,sizeof(reg));
+	reg.ring_addr = reinterpret_cast<uintptr_t>(ringMemory);
+	reg.ring_entries = URING_BUFFERS_PER_SOCKET;
+	reg.bgid = socket->bufferGroup;
+	if(syscall(__NR_io_uring_register,ring->descriptor,IORING_REGISTER_PBUF_RING,&reg,1) != 0)
+	{
+		munmap(ringMemory,URING_BUFFERS_PER_SOCKET * sizeof(io_uring_buf));
+		delete[] socket->bufferMemory;
+		socket->bufferMemory = NULL;
+		return false;
+	}
+
+	socket->bufferRing = static_cast<io_uring_buf_ring*>(ringMemory);
+	socket->bufferTail = 0;
+	for(unsigned short n = 0;n<URING_BUFFERS_PER_SOCKET;n++)
+	{
+		UringRecycleBuffer(socket,n);
+	}
+	return true;
+}
+
+/**
+ * @brief Arms the socket's multishot receive if it is not already armed.
+ *
+ * @param socket Locked socket.
+ */
+static void UringArmRecv(UringSocket * socket)
+{
+	if(socket->recvArmed == true || socket->closed == true)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&socket->ring->submitLock);
+		io_uring_sqe * sqe = UringGetSqe(socket->ring);
+		sqe->fd = socket->descriptor;
+		sqe->flags = IOSQE_BUFFER_SELECT;
+		sqe->ioprio = IORING_RECV_MULTISHOT;
+		sqe->buf_group = socket->bufferGroup;
+		sqe->user_data = reinterpret_cast<uintptr_t>(&socket->recvRequest);
+
+		if(socket->stream == true)
+		{
+			sqe->opcode = IORING_OP_RECV;
+		}
+		else
+		{
+			sqe->opcode = IORING_OP_RECVMSG;
+			sqe->addr = reinterpret_cast<uintptr_t>(&socket->recvTemplate);
+		}
+
+		socket->recvArmed = true;
+		socket->inFlight++;
+		UringSubmit(socket->ring);
+	pthread_mutex_unlock(&socket->ring->submitLock);
+}
+
+/**
+ * @brief Submits a send to the ring.
+ *
+ * @param socket Locked socket.
+ * @param send Send to submit.
+ */
+static void UringSubmitSend(UringSocket * socket, UringSend * send)
+{
+	pthread_mutex_lock(&socket->ring->submitLock);
+		io_uring_sqe * sqe = UringGetSqe(socket->ring);
+		sqe->opcode = IORING_OP_SENDMSG;
+		sqe->fd = socket->descriptor;
+		sqe->addr = reinterpret_cast<uintptr_t>(&send->message);
+		sqe->msg_flags = MSG_NOSIGNAL | (socket->stream ? MSG_WAITALL : 0);
+		sqe->user_data = reinterpret_cast<uintptr_t>(static_cast<UringRequest*>(send));
+
+		socket->inFlight++;
+		if(socket->stream == true)
+		{
+			socket->sendInFlight = true;
+		}
+		UringSubmit(socket->ring);
+	pthread_mutex_unlock(&socket->ring->submitLock);
+}
+
+/**
+ * @brief Finishes an operation, signaling its event and queuing a completion status.
+ *
+ * The overlapped object must not be used after this, because the worker thread
+ * that dequeues the status may clean it up.
+ *
+ * @param socket Socket that operation belongs to.
+ * @param overlapped Overlapped object of operation.
+ * @param bytes Number of bytes transferred.
+ * @param error Winsock error code, 0 if successful.
+ */
+static void UringComplete(UringSocket * socket, WSAOVERLAPPED * overlapped, DWORD bytes, DWORD error)
+{
+	overlapped->Internal = error;
+	overlapped->InternalHigh = bytes;
+
+	SetEvent(overlapped->hEvent);
+
+	// As with an I/O completion port, operations that complete after the
+	// port has been closed only signal their event.
+	if(socket->port != NULL)
+	{
+		socket->port->QueueCompletionStatus(socket->key,bytes,overlapped,error);
+	}
+}
+
+/**
+ * @brief Satisfies a batched receive operation using as many received datagrams as it can hold.
+ *
+ * UringSocket::received must not be empty. An error is only reported if it is the oldest
+ * received item, otherwise the batch stops before it and it is reported to the next operation.
+ *
+ * @param socket Locked datagram socket.
+ * @param operation Operation to satisfy.
+ * @param [out] bytes Total number of bytes copied into the operation's messages.
+ * @param [out] error Winsock error code, 0 if successful.
+ */
+static void UringConsumeBatch(UringSocket * socket, UringRecvOperation & operation, DWORD & bytes, DWORD & error)
+{
+	bytes = 0;
+	error = 0;
+
+	DWORD amount = 0;
+	while(amount < operation.batchCount && socket->received.empty() == false)
+	{
+		UringReceived & received = socket->received.front();
+		if(received.error != 0)
+		{
+			if(amount == 0)
+			{
+				error = received.error;
+				UringRecycleBuffer(socket,received.bufferID);
+				socket->received.pop_front();
+			}
+			break;
+		}
+
+		WSABATCHMSG & message = operation.batch[amount];
+		size_t length = received.length;
+		message.error = received.truncated ? WSAEMSGSIZE : 0;
+		if(length > message.buffer.len)
+		{
+			length = message.buffer.len;
+			message.error = WSAEMSGSIZE;
+		}
+		memcpy(message.buffer.buf,received.data,length);
+		message.bytes = static_cast<DWORD>(length);
+		message.segmentSize = received.segmentSize;
+
+		if(message.from != NULL)
+		{
+			size_t fromLength = received.fromLength;
+			if(fromLength > static_cast<size_t>(message.fromLength))
+			{
+				fromLength = message.fromLength;
+			}
+			memcpy(message.from,&received.from,fromLength);
+			message.fromLength = static_cast<int>(fromLength);
+		}
+
+		bytes += message.bytes;
+		amount++;
+
+		UringRecycleBuffer(socket,received.bufferID);
+		socket->received.pop_front();
+	}
+	*operation.batchReceived = amount;
+}
+
+/**
+ * @brief Satisfies a receive operation using the oldest received data.
+ *
+ * The data is copied into the operation's buffers and the provided buffer is returned to the ring,
+ * see the description of receiving at the top of this file.\n\n
+ *
+ * UringSocket::received must not be empty.
+ *
+ * @param socket Locked socket.
+ * @param operation Operation to satisfy.
+ * @param [out] bytes Number of bytes copied into the operation's buffers.
+ * @param [out] error Winsock error code, 0 if successful.
+ */
+static void UringConsume(UringSocket * socket, UringRecvOperation & operation, DWORD & bytes, DWORD & error)
+{
+	if(operation.batch != NULL)
+	{
+		UringConsumeBatch(socket,operation,bytes,error);
+		return;
+	}
+
+	UringReceived & received = socket->received.front();
+
+	bytes = 0;
+	error = received.error;
+
+	if(error == 0)
+	{
+		// Copy into the operation's buffers in order.
+		size_t remaining = received.length - received.offset;
+		for(DWORD n = 0;n<operation.bufferCount && remaining > 0;n++)
+		{
+			size_t amount = operation.buffers[n].len;
+			if(amount > remaining)
+			{
+				amount = remaining;
+			}
+
+			memcpy(operation.buffers[n].buf,received.data + received.offset + bytes,amount);
+			bytes += static_cast<DWORD>(amount);
+			remaining -= amount;
+		}
+		received.offset += bytes;
+
+		if(operation.address != NULL && operation.addressLength != NULL)
+		{
+			size_t length = received.fromLength;
+			if(length > static_cast<size_t>(*operation.addressLength))
+			{
+				length = *operation.addressLength;
+			}
+			memcpy(operation.address,&received.from,length);
+			*operation.addressLength = static_cast<int>(length);
+		}
+
+		if(operation.flags != NULL)
+		{
+			*operation.flags = 0;
+		}
+
+		// Winsock reports truncated datagrams as an error.
+		if(socket->stream == false && (received.truncated == true || remaining > 0))
+		{
+			error = WSAEMSGSIZE;
+		}
+	}
+
+	// Datagrams are consumed in one operation, stream data may take several.
+	if(socket->stream == false || received.offset >= received.length)
+	{
+		UringRecycleBuffer(socket,received.bufferID);
+		socket->received.pop_front();
+	}
+}
+
+/**
+ * @brief Satisfies pending receive operations using received data.
+ *
+ * A batched operation is left pending while further entries of the socket's receive are
+ * already in the completion queue, so that it takes all of them at once rather than only the first.
+ *
+ * @param socket Locked socket.
+ * @param moreReady True if the next completion queue entry belongs to the socket's receive.
+ */
+static void UringSatisfyPending(UringSocket * socket, bool moreReady)
+{
+	while(socket->pendingRecv.empty() == false && socket->received.empty() == false)
+	{
+		UringRecvOperation & operation = socket->pendingRecv.front();
+		if(moreReady == true && operation.batch != NULL && socket->received.size() < operation.batchCount)
+		{
+			break;
+		}
+
+		DWORD bytes = 0;
+		DWORD error = 0;
+		UringConsume(socket,operation,bytes,error);
+		UringComplete(socket,operation.overlapped,bytes,error);
+		socket->pendingRecv.pop_front();
+	}
+}
+
+/**
+ * @brief Deals with a completion queue entry of a socket's multishot receive.
+ *
+ * @param socket Locked socket.
+ * @param cqe Completion queue entry.
+ * @param moreReady True if the next completion queue entry belongs to the socket's receive.
+ */
+static void UringDealWithRecv(UringSocket * socket, const io_uring_cqe & cqe, bool moreReady)
+{
+	bool hasBuffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+	unsigned short bufferID = hasBuffer ? static_cast<unsigned short>(cqe.flags >> IORING_CQE_BUFFER_SHIFT) : URING_NO_BUFFER;
+
+	if((cqe.flags & IORING_CQE_F_MORE) == 0)
+	{
+		socket->recvArmed = false;
+		socket->inFlight--;
+	}
+
+	UringReceived received;
+	received.bufferID = bufferID;
+	received.data = NULL;
+	received.length = 0;
+	received.offset = 0;
+	received.truncated = false;
+	received.segmentSize = 0;
+	received.error = 0;
+	received.fromLength = 0;
+
+	if(cqe.res < 0)
+	{
+		UringRecycleBuffer(socket,bufferID);
+
+		// Buffer ring was empty, the receive is armed again once data has been consumed,
+		// which may already have happened. Cancelation only occurs when the socket is closing.
+		if(cqe.res == -ENOBUFS || cqe.res == -ECANCELED)
+		{
+			UringSatisfyPending(socket,moreReady);
+			if(socket->pendingRecv.empty() == false)
+			{
+				UringArmRecv(socket);
+			}
+			return;
+		}
+		received.bufferID = URING_NO_BUFFER;
+		received.error = WSATranslateErrno(-cqe.res);
+	}
+	else if(hasBuffer == true)
+	{
+		const char * buffer = socket->bufferMemory + bufferID * socket->bufferSize;
+		if(socket->stream == true)
+		{
+			received.data = buffer;
+			received.length = cqe.res;
+		}
+		else
+		{
+			const io_uring_recvmsg_out * header = reinterpret_cast<const io_uring_recvmsg_out*>(buffer);
+			const char * name = buffer + sizeof(io_uring_recvmsg_out);
+			const char * control = name + socket->recvTemplate.msg_namelen;
+			const char * payload = control + socket->recvTemplate.msg_controllen;
+
+			// Control data is not necessarily aligned within the provided buffer, so copy headers out.
+			size_t controlLength = header->controllen < socket->recvTemplate.msg_controllen ? header->controllen : socket->recvTemplate.msg_controllen;
+			size_t controlOffset = 0;
+			while(controlOffset + sizeof(cmsghdr) <= controlLength)
+			{
+				cmsghdr controlHeader;
+				memcpy(&controlHeader,control + controlOffset,sizeof(controlHeader));
+				if(controlHeader.cmsg_len < sizeof(cmsghdr) || controlOffset + controlHeader.cmsg_len > controlLength)
+				{
+					break;
+				}
+
+				if(controlHeader.cmsg_level == SOL_UDP && controlHeader.cmsg_type == UDP_GRO)
+				{
+					int segmentSize;
+					memcpy(&segmentSize,control + controlOffset + CMSG_LEN(0),sizeof(segmentSize));
+					received.segmentSize = static_cast<DWORD>(segmentSize);
+				}
+				controlOffset += CMSG_ALIGN(controlHeader.cmsg_len);
+			}
+
+			received.data = payload;
+			received.length = cqe.res - (payload - buffer);
+			received.truncated = (header->flags & MSG_TRUNC) != 0;
+			received.fromLength = header->namelen < sizeof(sockaddr_storage) ? header->namelen : sizeof(sockaddr_storage);
+			memcpy(&received.from,name,received.fromLength);
+		}
+	}
+	// Stream has been closed by the peer, the zero byte
+	// completion lets the initiator know.
+	else if(socket->closeEvent != NULL)
+	{
+		SetEvent(socket->closeEvent);
+	}
+
+	if(received.error == WSAECONNRESET && socket->closeEvent != NULL)
+	{
+		SetEvent(socket->closeEvent);
+	}
+
+	socket->received.push_back(received);
+	UringSatisfyPending(socket,moreReady);
+
+	// Multishot receive ended while operations are still waiting for data.
+	if(socket->pendingRecv.empty() == false)
+	{
+		UringArmRecv(socket);
+	}
+}
+
+/**
+ * @brief Deals with the completion queue entry of a send.
+ *
+ * @param socket Locked socket.
+ * @param send Send that completed.
+ * @param result Result of sendmsg.
+ */
+static void UringDealWithSend(UringSocket * socket, UringSend * send, int result)
+{
+	socket->inFlight--;
+	socket->sendInFlight = false;
+
+	DWORD error = 0;
+	if(result < 0)
+	{
+		error = WSATranslateErrno(-result);
+	}
+	else
+	{
+		send->transferred += result;
+
+		// Stream sockets may accept part of the data, send the rest.
+		if(send->transferred < send->total && socket->closed == false)
+		{
+			size_t skip = result;
+			while(send->message.msg_iovlen > 0 && skip >= send->message.msg_iov[0].iov_len)
+			{
+				skip -= send->message.msg_iov[0].iov_len;
+				send->message.msg_iov++;
+				send->message.msg_iovlen--;
+			}
+			send->message.msg_iov[0].iov_base = static_cast<char*>(send->message.msg_iov[0].iov_base) + skip;
+			send->message.msg_iov[0].iov_len -= skip;
+
+			UringSubmitSend(socket,send);
+			return;
+		}
+	}
+
+	UringComplete(socket,send->overlapped,static_cast<DWORD>(send->transferred),error);
+	delete send;
+
+	if(socket->queuedSend.empty() == false && socket->closed == false)
+	{
+		UringSend * next = socket->queuedSend.front();
+		socket->queuedSend.pop_front();
+		UringSubmitSend(socket,next);
+	}
+}
+
+/**
+ * @brief Starts a receive operation, satisfying it immediately if data is already waiting.
+ *
+ * @param socket Socket descriptor.
+ * @param operation Operation to start.
+ * @param capacity Maximum amount of data that one datagram or chunk of stream data received into the operation can contain.
+ * @param [out] bytesReceived Number of bytes received if the operation completed immediately, may be NULL.
+ *
+ * @return 0 if the operation completed immediately, SOCKET_ERROR if not.
+ * WSAGetLastError() returns WSA_IO_PENDING if the operation will complete later.
+ */
+static int UringStartRecv(SOCKET socket, UringRecvOperation & operation, size_t capacity, DWORD * bytesReceived)
+{
+	UringSocket * uringSocket = UringLockSocket(socket);
+	if(uringSocket == NULL)
+	{
+		WSASetLastError(WSAENOTSOCK);
+		return SOCKET_ERROR;
+	}
+
+	if(operation.batch != NULL && uringSocket->stream == true)
+	{
+		pthread_mutex_unlock(&uringSocket->lock);
+		WSASetLastError(WSAEINVAL);
+		return SOCKET_ERROR;
+	}
+
+	ResetEvent(operation.overlapped->hEvent);
+
+	// Data has already been received, no need to involve the kernel.
+	if(uringSocket->pendingRecv.empty() == true && uringSocket->received.empty() == false)
+	{
+		DWORD bytes = 0;
+		DWORD error = 0;
+		UringConsume(uringSocket,operation,bytes,error);
+
+		// Operations that fail immediately do not generate a completion status.
+		if(error != 0)
+		{
+			pthread_mutex_unlock(&uringSocket->lock);
+			WSASetLastError(error);
+			return SOCKET_ERROR;
+		}
+
+		if(bytesReceived != NULL)
+		{
+			*bytesReceived = bytes;
+		}
+		UringComplete(uringSocket,operation.overlapped,bytes,error);
+		pthread_mutex_unlock(&uringSocket->lock);
+		return 0;
+	}
+
+	if(uringSocket->bufferRing == NULL && UringSetupBuffers(uringSocket,capacity) == false)
+	{
+		pthread_mutex_unlock(&uringSocket->lock);
+		WSASetLastError(WSAENOBUFS);
+		return SOCKET_ERROR;
+	}
+
+	uringSocket->pendingRecv.push_back(operation);
+	UringArmRecv(uringSocket);
+	pthread_mutex_unlock(&uringSocket->lock);
+
+	WSASetLastError(WSA_IO_PENDING);
+	return SOCKET_ERROR;
+}
+
+/**
+ * @brief Starts an overlapped receive operation.
+ *
+ * See the winsock documentation of WSARecvFrom for more information.
+ */
+int WSARecvFrom(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesReceived, DWORD * flags, SOCKADDR * from, int * fromLength, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine)
+{
+	if(completionRoutine != NULL || overlapped == NULL || bufferCount == 0 || bufferCount > URING_MAX_BUFFERS)
+	{
+		WSASetLastError(WSAEINVAL);
+		return SOCKET_ERROR;
+	}
+
+	UringRecvOperation operation;
+	operation.overlapped = overlapped;
+	memcpy(operation.buffers,buffers,sizeof(WSABUF) * bufferCount);
+	operation.bufferCount = bufferCount;
+	operation.flags = flags;
+	operation.address = from;
+	operation.addressLength = fromLength;
+	operation.batch = NULL;
+	operation.batchCount = 0;
+	operation.batchReceived = NULL;
+
+	size_t capacity = 0;
+	for(DWORD n = 0;n<bufferCount;n++)
+	{
+		capacity += buffers[n].len;
+	}
+
+	return UringStartRecv(socket,operation,capacity,bytesReceived);
+}
+
+/**
+ * @brief Starts an overlapped receive operation that receives up to @a messageCount datagrams at once.
+ *
+ * The operation completes as soon as at least one datagram is available. The completion status
+ * reports the total number of bytes received in all messages.
+ *
+ * @param socket Datagram socket.
+ * @param [in,out] messages Messages to receive into, must remain valid until the operation completes.
+ * @param messageCount Number of elements in @a messages, at most WSA_MAX_RECV_BATCH.
+ * @param [out] messagesReceived Filled with number of messages received when the operation completes.
+ * @param overlapped Overlapped object of operation.
+ *
+ * @return 0 if the operation completed immediately, SOCKET_ERROR if not.
+ * WSAGetLastError() returns WSA_IO_PENDING if the operation will complete later.
+ */
+int WSARecvFromBatch(SOCKET socket, WSABATCHMSG * messages, DWORD messageCount, DWORD * messagesReceived, LPWSAOVERLAPPED overlapped)
+{
+	if(overlapped == NULL || messages == NULL || messageCount == 0 || messageCount > WSA_MAX_RECV_BATCH || messagesReceived == NULL)
+	{
+		WSASetLastError(WSAEINVAL);
+		return SOCKET_ERROR;
+	}
+
+	UringRecvOperation operation;
+	operation.overlapped = overlapped;
+	operation.bufferCount = 0;
+	operation.flags = NULL;
+	operation.address = NULL;
+	operation.addressLength = NULL;
+	operation.batch = messages;
+	operation.batchCount = messageCount;
+	operation.batchReceived = messagesReceived;
+
+	return UringStartRecv(socket,operation,messages[0].buffer.len,NULL);
+}
+
+/**
+ * @brief Starts an overlapped receive operation on a connected socket.
+ *
+ * See the winsock documentation of WSARecv for more information.
+ */
+int WSARecv(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesReceived, DWORD * flags, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine)
+{
+	return WSARecvFrom(socket,buffers,bufferCount,bytesReceived,flags,NULL,NULL,overlapped,completionRoutine);
+}
+
+/**
+ * @brief Starts an overlapped send operation.
+ *
+ * See the winsock documentation of WSASendTo for more information.
+ * Flags are not supported, @a flags must be 0.
+ */
+int WSASendTo(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesSent, DWORD flags, const SOCKADDR * to, int toLength, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine)
+{
+	if(completionRoutine != NULL || flags != 0 || overlapped == NULL || bufferCount > URING_MAX_BUFFERS ||
+	   toLength < 0 || static_cast<size_t>(toLength) > sizeof(sockaddr_storage))
+	{
+		WSASetLastError(WSAEINVAL);
+		return SOCKET_ERROR;
+	}
+
+	UringSend * send = new (nothrow) UringSend();
+	if(send == NULL)
+	{
+		WSASetLastError(WSAENOBUFS);
+		return SOCKET_ERROR;
+	}
+
+	send->type = URING_SEND;
+	send->overlapped = overlapped;
+	send->total = 0;
+	send->transferred = 0;
+	for(DWORD n = 0;n<bufferCount;n++)
+	{
+		send->vectors[n].iov_base = buffers[n].buf;
+		send->vectors[n].iov_len = buffers[n].len;
+		send->total += buffers[n].len;
+	}
+
+	memset(&send->message,0,sizeof(send->message));
+	send->message.msg_iov = send->vectors;
+	send->message.msg_iovlen = bufferCount;
+	if(to != NULL)
+	{
+		memcpy(&send->destination,to,toLength);
+		send->message.msg_name = &send->destination;
+		send->message.msg_namelen = toLength;
+	}
+
+	UringSocket * uringSocket = UringLockSocket(socket);
+	if(uringSocket == NULL)
+	{
+		delete send;
+		WSASetLastError(WSAENOTSOCK);
+		return SOCKET_ERROR;
+	}
+	send->socket = uringSocket;
+
+	ResetEvent(overlapped->hEvent);
+
+	// Try to send immediately, this usually succeeds and is
+	// cheaper than going through the ring.
+	bool inOrder = (uringSocket->sendInFlight == false && uringSocket->queuedSend.empty() == true);
+	if(inOrder == true)
+	{
+		ssize_t result;
+		do
+		{
+			result = sendmsg(uringSocket->descriptor,&send->message,MSG_NOSIGNAL | MSG_DONTWAIT);
+		}
+		while(result == -1 && errno == EINTR);
+
+		if(result == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
+		{
+			DWORD error = WSATranslateErrno(errno);
+			pthread_mutex_unlock(&uringSocket->lock);
+			delete send;
+			WSASetLastError(error);
+			return SOCKET_ERROR;
+		}
+
+		if(result >= 0 && static_cast<size_t>(result) == send->total)
+		{
+			if(bytesSent != NULL)
+			{
+				*bytesSent = static_cast<DWORD>(result);
+			}
+			UringComplete(uringSocket,overlapped,static_cast<DWORD>(result),0);
+			pthread_mutex_unlock(&uringSocket->lock);
+			delete send;
+			return 0;
+		}
+
+		// Part of a stream send was accepted, the ring sends the rest.
+		if(result > 0)
+		{
+			uringSocket->inFlight++;
+			UringDealWithSend(uringSocket,send,static_cast<int>(result));
+			pthread_mutex_unlock(&uringSocket->lock);
+			WSASetLastError(WSA_IO_PENDING);
+			return SOCKET_ERROR;
+		}
+	}
+
+	if(uringSocket->stream == true && inOrder == false)
+	{
+		uringSocket->queuedSend.push_back(send);
+	}
+	else
+	{
+		UringSubmitSend(uringSocket,send);
+	}
+	pthread_mutex_unlock(&uringSocket->lock);
+
+	WSASetLastError(WSA_IO_PENDING);
+	return SOCKET_ERROR;
+}
+
+/**
+ * @brief Starts an overlapped send operation on a connected socket.
+ *
+ * See the winsock documentation of WSASend for more information.
+ */
+int WSASend(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesSent, DWORD flags, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine)
+{
+	return WSASendTo(socket,buffers,bufferCount,bytesSent,flags,NULL,0,overlapped,completionRoutine);
+}
+
+/**
+ * @brief Requests that an event be signaled when the connection is closed by the peer.
+ *
+ * Only FD_CLOSE is supported, and the socket must already be associated with a completion port.
+ *
+ * @param socket Socket to monitor.
+ * @param event Event to signal.
+ * @param networkEvents Must be FD_CLOSE.
+ *
+ * @return 0 if successful, SOCKET_ERROR if not.
+ */
+int WSAEventSelect(SOCKET socket, HANDLE event, long networkEvents)
+{
+	if(networkEvents != FD_CLOSE)
+	{
+		WSASetLastError(WSAEINVAL);
+		return SOCKET_ERROR;
+	}
+
+	UringSocket * uringSocket = UringLockSocket(socket);
+	if(uringSocket == NULL)
+	{
+		WSASetLastError(WSAENOTSOCK);
+		return SOCKET_ERROR;
+	}
+
+	uringSocket->closeEvent = event;
+	pthread_mutex_unlock(&uringSocket->lock);
+	return 0;
+}
+
+/**
+ * @brief Aborts all operations of a socket that has been removed from uringSockets.
+ *
+ * Operations that are waiting complete with WSA_OPERATION_ABORTED, and requests in
+ * the ring are canceled.
+ *
+ * @param socket Socket to close, must not be locked.
+ * @param port If not NULL the socket is no longer allowed to queue completion status' to @a port,
+ * only signaling the events of its operations.
+ *
+ * @return true if the socket has no requests in the ring, so should be cleaned up by the caller.
+ * @return false if the socket will be cleaned up by WaitForEvents() once its requests have completed.
+ */
+static bool UringCloseSocket(UringSocket * socket, const CompletionPort * port)
+{
+	pthread_mutex_lock(&socket->lock);
+	socket->closed = true;
+	if(port != NULL && socket->port == port)
+	{
+		socket->port = NULL;
+	}
+
+	while(socket->pendingRecv.empty() == false)
+	{
+		UringComplete(socket,socket->pendingRecv.front().overlapped,0,WSA_OPERATION_ABORTED);
+		socket->pendingRecv.pop_front();
+	}
+
+	while(socket->queuedSend.empty() == false)
+	{
+		UringComplete(socket,socket->queuedSend.front()->overlapped,0,WSA_OPERATION_ABORTED);
+		delete socket->queuedSend.front();
+		socket->queuedSend.pop_front();
+	}
+
+	// Requests in the ring complete with -ECANCELED.
+	if(socket->inFlight > 0)
+	{
+		pthread_mutex_lock(&socket->ring->submitLock);
+			io_uring_sqe * sqe = UringGetSqe(socket->ring);
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->fd = socket->descriptor;
+			sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+			sqe->user_data = 0;
+			UringSubmit(socket->ring);
+		pthread_mutex_unlock(&socket->ring->submitLock);
+	}
+
+	bool destroy = (socket->inFlight == 0);
+	pthread_mutex_unlock(&socket->lock);
+	return destroy;
+}
+
+/**
+ * @brief Closes a socket, canceling all of its operations.
+ *
+ * A completion status with error WSA_OPERATION_ABORTED is queued for
+ * every operation that had not completed.
+ *
+ * @param socket Socket to close.
+ *
+ * @return 0 if successful, SOCKET_ERROR if not.
+ */
+int closesocket(SOCKET socket)
+{
+	UringSocket * uringSocket = NULL;
+
+	pthread_rwlock_wrlock(&uringSocketsLock);
+	if(socket >= 0 && static_cast<size_t>(socket) < uringSockets.size())
+	{
+		uringSocket = uringSockets[socket];
+		uringSockets[socket] = NULL;
+	}
+	pthread_rwlock_unlock(&uringSocketsLock);
+
+	bool destroy = false;
+	if(uringSocket != NULL)
+	{
+		destroy = UringCloseSocket(uringSocket,NULL);
+	}
+
+	int result = close(socket);
+	DWORD error = WSATranslateErrno(errno);
+
+	if(destroy == true)
+	{
+		UringDestroySocket(uringSocket);
+	}
+
+	if(result == -1)
+	{
+		WSASetLastError(error);
+		return SOCKET_ERROR;
+	}
+	return 0;
+}
+
+/**
+ * @brief	Constructor.
+ *
+ * @param numThreads Number of worker threads that will manage completion port. Threads must
+ * exit without dealing with further completion status' when CompletionKey::SHUTDOWN notification is
+ * received.
+ * @param function Function to be called by worker threads. Function is passed a pointer to
+ * the ThreadSingle object that is managing it. ThreadSingle::GetParameter() will return a
+ * a pointer to the CompletionPort object that it is associated with. ThreadSingle::GetManualThreadID()
+ * will return a unique thread ID that should be used by the thread when calling any method requiring a thread ID.
+ */
+CompletionPort::CompletionPort(size_t numThreads, LPTHREAD_START_ROUTINE function)
+{
+	_ErrorException((numThreads == 0),"starting the completion port, number of threads is 0",0,__LINE__,__FILE__);
+
+	InitializeStatusQueue();
+
+	ring = new (nothrow) UringRing();
+	Utility::DynamicAllocCheck(ring,__LINE__,__FILE__);
+
+	io_uring_params params;
+	memset(&params,0,sizeof(params));
+	ring->descriptor = static_cast<int>(syscall(__NR_io_uring_setup,URING_ENTRIES,&params));
+	_ErrorException((ring->descriptor == -1),"creating the completion port (io_uring_setup)",WSATranslateErrno(errno),__LINE__,__FILE__);
+
+	ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	ring->cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	if(params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if(ring->cqMapSize > ring->sqMapSize)
+		{
+			ring->sqMapSize = ring->cqMapSize;
+		}
+		ring->cqMapSize = ring->sqMapSize;
+	}
+
+	ring->sqMap = mmap(NULL,ring->sqMapSize,PROT_READ | PROT_WRITE,MAP_SHARED | MAP_POPULATE,ring->descriptor,IORING_OFF_SQ_RING);
+	_ErrorException((ring->sqMap == MAP_FAILED),"creating the completion port (mapping submission queue)",WSATranslateErrno(errno),__LINE__,__FILE__);
+
+	if(params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		ring->cqMap = ring->sqMap;
+	}
+	else
+	{
+		ring->cqMap = mmap(NULL,ring->cqMapSize,PROT_READ | PROT_WRITE,MAP_SHARED | MAP_POPULATE,ring->descriptor,IORING_OFF_CQ_RING);
+		_ErrorException((ring->cqMap == MAP_FAILED),"creating the completion port (mapping completion queue)",WSATranslateErrno(errno),__LINE__,__FILE__);
+	}
+
+	ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	ring->sqes = static_cast<io_uring_sqe*>(mmap(NULL,ring->sqesSize,PROT_READ | PROT_WRITE,MAP_SHARED | MAP_POPULATE,ring->descriptor,IORING_OFF_SQES));
+	_ErrorException((ring->sqes == MAP_FAILED),"creating the completion port (mapping submission queue entries)",WSATranslateErrno(errno),__LINE__,__FILE__);
+
+	char * sq = static_cast<char*>(ring->sqMap);
+	ring->sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+	ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	ring->sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+	char * cq = static_cast<char*>(ring->cqMap);
+	ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	ring->cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+	pthread_mutex_init(&ring->submitLock,NULL);
+	ring->sockets = 0;
+	for(unsigned n = 0;n<URING_NO_BUFFER;n++)
+	{
+		ring->freeBufferGroups.push_back(static_cast<unsigned short>(URING_NO_BUFFER - 1 - n));
+	}
+
+	StartThreads(numThreads,function);
+}
+
+/**
+ * @brief	Destructor.
+ */
+CompletionPort::~CompletionPort(void)
+{
+	const char * cCommand = "an internal function (~CompletionPort)";
+	try
+	{
+		this->TerminateFriendly(true);
+
+		// Sockets may outlive the completion port, as on Windows after WSACleanup their operations
+		// are aborted, only signaling their events, and closing them later only closes the descriptor.
+		std::vector<UringSocket*> orphans;
+		pthread_rwlock_wrlock(&uringSocketsLock);
+		for(size_t n = 0;n<uringSockets.size();n++)
+		{
+			if(uringSockets[n] != NULL && uringSockets[n]->ring == ring)
+			{
+				orphans.push_back(uringSockets[n]);
+				uringSockets[n] = NULL;
+			}
+		}
+		pthread_rwlock_unlock(&uringSocketsLock);
+
+		for(size_t n = 0;n<orphans.size();n++)
+		{
+			if(UringCloseSocket(orphans[n],this) == true)
+			{
+				UringDestroySocket(orphans[n]);
+			}
+		}
+
+		// The kernel must be done with every request before the ring's memory is released.
+		for(;;)
+		{
+			pthread_mutex_lock(&ring->submitLock);
+			bool socketsRemaining = (ring->sockets > 0);
+			pthread_mutex_unlock(&ring->submitLock);
+
+			if(socketsRemaining == false)
+			{
+				break;
+			}
+			WaitForEvents();
+		}
+
+		munmap(ring->sqes,ring->sqesSize);
+		if(ring->cqMap != ring->sqMap)
+		{
+			munmap(ring->cqMap,ring->cqMapSize);
+		}
+		munmap(ring->sqMap,ring->sqMapSize);
+		close(ring->descriptor);
+		pthread_mutex_destroy(&ring->submitLock);
+		delete ring;
+
+		DestroyStatusQueue();
+	}
+	MSG_CATCH
+}
+
+/**
+ * @brief Waits for completion queue entries and converts them into completion status'.
+ *
+ * Must only be called by one thread at a time, see CompletionPort::waiting.
+ */
+void CompletionPort::WaitForEvents()
+{
+	int result;
+	do
+	{
+		result = static_cast<int>(syscall(__NR_io_uring_enter,ring->descriptor,0,1,IORING_ENTER_GETEVENTS,NULL,0));
+	}
+	while(result == -1 && errno == EINTR);
+
+	unsigned head = *ring->cqHead;
+	unsigned tail = __atomic_load_n(ring->cqTail,__ATOMIC_ACQUIRE);
+	while(head != tail)
+	{
+		io_uring_cqe cqe = ring->cqes[head & ring->cqMask];
+		head++;
+
+		// Free the entry before dealing with it, dealing with it may submit new requests.
+		__atomic_store_n(ring->cqHead,head,__ATOMIC_RELEASE);
+
+		UringRequest * request = reinterpret_cast<UringRequest*>(static_cast<uintptr_t>(cqe.user_data));
+		if(request == NULL)
+		{
+			continue;
+		}
+
+		if(head == tail)
+		{
+			tail = __atomic_load_n(ring->cqTail,__ATOMIC_ACQUIRE);
+		}
+
+		UringSocket * socket = request->socket;
+		pthread_mutex_lock(&socket->lock);
+			if(request->type == URING_RECV)
+			{
+				bool moreReady = (head != tail && ring->cqes[head & ring->cqMask].user_data == cqe.user_data);
+				UringDealWithRecv(socket,cqe,moreReady);
+			}
+			else
+			{
+				UringDealWithSend(socket,static_cast<UringSend*>(request),cqe.res);
+			}
+			bool destroy = (socket->closed == true && socket->inFlight == 0);
+		pthread_mutex_unlock(&socket->lock);
+
+		if(destroy == true)
+		{
+			UringDestroySocket(socket);
+		}
+	}
+}
+
+/**
+ * @brief Wakes the thread that is waiting in WaitForEvents(), by submitting a request that completes immediately.
+ */
+void CompletionPort::Wake()
+{
+	pthread_mutex_lock(&ring->submitLock);
+		io_uring_sqe * sqe = UringGetSqe(ring);
+		sqe->opcode = IORING_OP_NOP;
+		sqe->user_data = 0;
+		UringSubmit(ring);
+	pthread_mutex_unlock(&ring->submitLock);
+}
+
+/**
+ * @brief Associates an object with the completion port, so that status indicators
+ * can be received by the completion port about that object.
+ *
+ * @param object Socket descriptor to associate with completion port.
+ * @param key Key associated with object, to uniquely identify it.
+ */
+void CompletionPort::Associate(HANDLE object, const CompletionKey & key)
+{
+	SOCKET descriptor = static_cast<SOCKET>(reinterpret_cast<INT_PTR>(object));
+	_ErrorException((descriptor < 0),"associating a socket with the completion port, invalid socket",0,__LINE__,__FILE__);
+
+	int type = 0;
+	socklen_t typeLength = sizeof(type);
+	int result = getsockopt(descriptor,SOL_SOCKET,SO_TYPE,&type,&typeLength);
+	_ErrorException((result == -1),"associating a socket with the completion port",WSATranslateErrno(errno),__LINE__,__FILE__);
+
+	UringSocket * socket = new (nothrow) UringSocket();
+	Utility::DynamicAllocCheck(socket,__LINE__,__FILE__);
+	socket->descriptor = descriptor;
+	socket->stream = (type == SOCK_STREAM);
+	socket->key = const_cast<CompletionKey*>(&key);
+	socket->port = this;
+	socket->ring = ring;
+	socket->closeEvent = NULL;
+	socket->closed = false;
+	socket->inFlight = 0;
+	socket->recvRequest.type = URING_RECV;
+	socket->recvRequest.socket = socket;
+	socket->recvArmed = false;
+	memset(&socket->recvTemplate,0,sizeof(socket->recvTemplate));
+	socket->recvTemplate.msg_namelen = sizeof(sockaddr_storage);
+	if(socket->stream == false)
+	{
+		socket->recvTemplate.msg_controllen = URING_CONTROL_SIZE;
+	}
+	socket->bufferRing = NULL;
+	socket->bufferMemory = NULL;
+	socket->bufferSize = 0;
+	socket->bufferGroup = 0;
+	socket->bufferTail = 0;
+	socket->sendInFlight = false;
+	pthread_mutex_init(&socket->lock,NULL);
+
+	pthread_mutex_lock(&ring->submitLock);
+	ring->sockets++;
+	pthread_mutex_unlock(&ring->submitLock);
+
+	UringSocket * previous = NULL;
+	pthread_rwlock_wrlock(&uringSocketsLock);
+		if(static_cast<size_t>(descriptor) >= uringSockets.size())
+		{
+			uringSockets.resize(descriptor + 1,NULL);
+		}
+		previous = uringSockets[descriptor];
+		uringSockets[descriptor] = socket;
+	pthread_rwlock_unlock(&uringSocketsLock);
+
+	// Descriptor was closed without using closesocket and has been reused.
+	if(previous != NULL)
+	{
+		pthread_mutex_lock(&previous->lock);
+		previous->closed = true;
+		bool destroy = (previous->inFlight == 0);
+		pthread_mutex_unlock(&previous->lock);
+
+		if(destroy == true)
+		{
+			UringDestroySocket(previous);
+		}
+	}
+}
+
+#endif
@@ -44,4 +44,159 @@ DWORD WINAPI ConcurrentObjectTestFunction(LPVOID lpParameter)
 	cout << "Thread " << thread->GetThreadID() << " terminated\n";
 	Utility::output.Leave();
 	return (count);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool ConcurrentObjectTestClass()
+{
+	cout << "Testing ConcurrentObject class...\n";
+	bool problem = false;
+
+	{
+		cout << "Running threads\n";
+
+		int integer = 5000;
+		ConcurrentObject<int*> co(&integer);
+
+		// Create group of threads
+		const size_t numThreads = 5;
+
+		ThreadSingleGroup threads;
+
+		for(size_t n = 0;n<numThreads;n++)
+		{
+			ThreadSingle * thread = new ThreadSingle(&ConcurrentObjectTestFunction,&co);
+			Utility::DynamicAllocCheck(thread,__LINE__,__FILE__);
+			thread->Resume();
+			threads.Add(thread);
+			
+		}
+
+		// Wait for threads to exit
+		threads.WaitForThreadsToExit();
+
+		// Total up return value
+		size_t total = 0;
+		for(size_t n = 0;n<numThreads;n++)
+		{
+			total += threads[n].GetExitCode();
+			cout << "Count for thread " << n << " is " << threads[n].GetExitCode() << '\n';
+		}
+
+		cout << "Total: " << total << '\n';
+	}
+
+	{
+		ConcurrentObject<size_t> co;
+		co.Set(0);
+
+		// Test Increase()
+		co.Increase(10);
+
+		if(co.Get() != 10)
+		{
+			cout << "Increase is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Increase is good\n";
+		}
+
+		// Test Decrease()
+		co.Decrease(5);
+
+		if(co.Get() != 5)
+		{
+			cout << "Decrease is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Decrease is good\n";
+		}
+
+		co.Set(0);
+
+		// Test BitOn()
+		co.BitOn(2);
+		if(co.BitGet(2) != true)
+		{
+			cout << "BitOn or BitGet is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "BitOn and BitGet are good\n";
+		}
+
+		// Test BitOff()
+		co.BitOff(2);
+		if(co.BitGet(2) != false)
+		{
+			cout << "BitOff or BitGet is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "BitOff and BitGet are good\n";
+		}
+
+		// Test BitToggle()
+		co.BitToggle(2);
+		if(co.BitGet(2) != true)
+		{
+			cout << "BitToggle or BitGet is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "BitToggle and BitGet are good\n";
+		}
+
+		// Test BitToggle()
+		co.BitToggle(2);
+		if(co.BitGet(2) != false)
+		{
+			cout << "BitToggle or BitGet is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "BitToggle and BitGet are good\n";
+		}
+
+		ConcurrentObject<size_t> copyOfCo(co);
+		if(co != copyOfCo)
+		{
+			cout << "Copy constructor or equality operator is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Copy constructor and equality operator are good\n";
+		}
+
+		ConcurrentObject<size_t> copyOfCo2;
+		copyOfCo2 = co;
+		if(co != copyOfCo2)
+		{
+			cout << "Assignment operator or equality operator is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Assignment operator and equality operator are good\n";
+		}
+	}
+
+	
+	cout << "\n\n";
+	return !problem;
+}
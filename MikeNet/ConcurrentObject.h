@@ -2,6 +2,7 @@
 #include "ConcurrencyControl.h"
 
 DWORD WINAPI ConcurrentObjectTestFunction(LPVOID lpParameter);
+bool ConcurrentObjectTestClass();
 
 /**
  * @brief	Uses CriticalSection to safely control access to an object.
@@ -115,7 +116,7 @@ public:
 	* 
 	* @param paraObject Pointer who's data will be copied into object.
 	*/
-	void ConcurrentObject::SetB(const T * paraObject)
+	void SetB(const T * paraObject)
 	{
 		Enter();
 			object = *paraObject;
@@ -127,7 +128,7 @@ public:
 	* 
 	* @param paraObject Object who's data will be copied.
 	*/
-	void ConcurrentObject::Set(T paraObject)
+	void Set(T paraObject)
 	{
 		Enter();
 			object = paraObject;
@@ -139,7 +140,7 @@ public:
 	 *
 	 * @param amount Amount to decrease protected object by.
 	 */
-	void ConcurrentObject::Decrease(int amount)
+	void Decrease(int amount)
 	{
 		Enter();
 			object-=amount;
@@ -151,7 +152,7 @@ public:
 	 *
 	 * @param amount Amount to increase protected object by.
 	 */
-	void ConcurrentObject::Increase(int amount)
+	void Increase(int amount)
 	{
 		Enter();
 			object+=amount;
@@ -163,7 +164,7 @@ public:
 	 *
 	 * @return copy of object.
 	 */
-	T ConcurrentObject::Get() const
+	T Get() const
 	{
 		T returnMe;
 
@@ -179,7 +180,7 @@ public:
 	 * 
 	 * @param [out] destination Destination to copy protected object into.
 	 */
-	void ConcurrentObject::GetB(T & destination)
+	void GetB(T & destination)
 	{
 		Enter();
 			destination = object;
@@ -195,7 +196,7 @@ public:
 	 *
 	 * @return mutable pointer to protected object.
 	 */
-	T * ConcurrentObject::GetPtr()
+	T * GetPtr()
 	{
 		return(&object);
 	}
@@ -210,7 +211,7 @@ public:
 	 *
 	 * @return constant pointer to protected object.
 	 */
-	const T * ConcurrentObject::GetPtrConst()
+	const T * GetPtrConst()
 	{
 		return(&object);
 	}
@@ -222,7 +223,7 @@ public:
 	 *
 	 * @param bitNumber Bit number to toggle on.
 	 */
-	void ConcurrentObject::BitOn(int bitNumber)
+	void BitOn(int bitNumber)
 	{
 		_ErrorException((bitNumber > sizeof(T)),"attempting to signal object's bit to on, bitNumber is too high",0,__LINE__,__FILE__);
 		Enter();
@@ -237,7 +238,7 @@ public:
 	 *
 	 * @param bitNumber Bit number to toggle off.
 	 */
-	void ConcurrentObject::BitOff(int bitNumber)
+	void BitOff(int bitNumber)
 	{
 		_ErrorException((bitNumber > sizeof(T)),"attempting to signal object's bit to off, bitNumber is too high",0,__LINE__,__FILE__);
 		Enter();
@@ -252,7 +253,7 @@ public:
 	 *
 	 * @param bitNumber Bit number to flip.
 	 */
-	void ConcurrentObject::BitToggle(int bitNumber)
+	void BitToggle(int bitNumber)
 	{
 		_ErrorException((bitNumber > sizeof(T)),"attempting to toggle object's bit, bitNumber is too high",0,__LINE__,__FILE__);
 		Enter();
@@ -268,7 +269,7 @@ public:
 	 * @param bitNumber Bit number to retrieve the value of.
 	 * @return true if specified bit is signaled.
 	 */
-	bool ConcurrentObject::BitGet(int bitNumber) const
+	bool BitGet(int bitNumber) const
 	{
 		_ErrorException((bitNumber > sizeof(T)),"attempting to retrieve object's bit, bitNumber is too high",0,__LINE__,__FILE__);
 		bool bReturn = false;
@@ -304,150 +305,7 @@ public:
 	 */
 	static bool TestClass()
 	{
-		cout << "Testing ConcurrentObject class...\n";
-		bool problem = false;
-
-		{
-			cout << "Running threads\n";
-
-			int integer = 5000;
-			ConcurrentObject<int*> co(&integer);
-
-			// Create group of threads
-			const size_t numThreads = 5;
-
-			ThreadSingleGroup threads;
-
-			for(size_t n = 0;n<numThreads;n++)
-			{
-				ThreadSingle * thread = new ThreadSingle(&ConcurrentObjectTestFunction,&co);
-				Utility::DynamicAllocCheck(thread,__LINE__,__FILE__);
-				thread->Resume();
-				threads.Add(thread);
-				
-			}
-
-			// Wait for threads to exit
-			threads.WaitForThreadsToExit();
-
-			// Total up return value
-			size_t total = 0;
-			for(size_t n = 0;n<numThreads;n++)
-			{
-				total += threads[n].GetExitCode();
-				cout << "Count for thread " << n << " is " << threads[n].GetExitCode() << '\n';
-			}
-
-			cout << "Total: " << total << '\n';
-		}
-
-		{
-			ConcurrentObject<size_t> co;
-			co.Set(0);
-
-			// Test Increase()
-			co.Increase(10);
-
-			if(co.Get() != 10)
-			{
-				cout << "Increase is bad\n";
-				problem = true;
-			}
-			else
-			{
-				cout << "Increase is good\n";
-			}
-
-			// Test Decrease()
-			co.Decrease(5);
-
-			if(co.Get() != 5)
-			{
-				cout << "Decrease is bad\n";
-				problem = true;
-			}
-			else
-			{
-				cout << "Decrease is good\n";
-			}
-
-			co.Set(0);
-
-			// Test BitOn()
-			co.BitOn(2);
-			if(co.BitGet(2) != true)
-			{
-				cout << "BitOn or BitGet is bad\n";
-				problem = true;
-			}
-			else
-			{
-				cout << "BitOn and BitGet are good\n";
-			}
-
-			// Test BitOff()
-			co.BitOff(2);
-			if(co.BitGet(2) != false)
-			{
-				cout << "BitOff or BitGet is bad\n";
-				problem = true;
-			}
-			else
-			{
-				cout << "BitOff and BitGet are good\n";
-			}
-
-			// Test BitToggle()
-			co.BitToggle(2);
-			if(co.BitGet(2) != true)
-			{
-				cout << "BitToggle or BitGet is bad\n";
-				problem = true;
-			}
-			else
-			{
-				cout << "BitToggle and BitGet are good\n";
-			}
-
-			// Test BitToggle()
-			co.BitToggle(2);
-			if(co.BitGet(2) != false)
-			{
-				cout << "BitToggle or BitGet is bad\n";
-				problem = true;
-			}
-			else
-			{
-				cout << "BitToggle and BitGet are good\n";
-			}
-
-			ConcurrentObject<size_t> copyOfCo(co);
-			if(co != copyOfCo)
-			{
-				cout << "Copy constructor or equality operator is bad\n";
-				problem = true;
-			}
-			else
-			{
-				cout << "Copy constructor and equality operator are good\n";
-			}
-
-			ConcurrentObject<size_t> copyOfCo2;
-			copyOfCo2 = co;
-			if(co != copyOfCo2)
-			{
-				cout << "Assignment operator or equality operator is bad\n";
-				problem = true;
-			}
-			else
-			{
-				cout << "Assignment operator and equality operator are good\n";
-			}
-		}
-
-		
-		cout << "\n\n";
-		return !problem;
+		return ConcurrentObjectTestClass();
 	}
 
 
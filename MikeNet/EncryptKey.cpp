@@ -135,6 +135,25 @@ EncryptKey::EncryptKey(int key1, int key2, int key3, int key4, bool differentTyp
 
 	KeyExpansion(keyStore);
 }
+
+/**
+ * @brief	Constructor for 128, 192 or 256 bit strength encryption, depending on the size of @a key.
+ *
+ * Keys constructed from the same bytes are identical to those constructed from integers,
+ * e.g. a 16 byte packet containing @a key1 and @a key2 produces the same key as EncryptKey(key1,key2).
+ *
+ * @param	key	Key required upon decryption, must be 16, 24 or 32 bytes in size.
+ */
+EncryptKey::EncryptKey(const Packet & key)
+{
+	Packet keyStore;
+	SetBitStrength(key.GetUsedSize() * 8,keyStore);
+
+	keyStore.AddStringC(key.GetDataPtr(),key.GetUsedSize(),false);
+
+	KeyExpansion(keyStore);
+}
+
 /**
  * @brief	Deep copy constructor / assignment operator helper method.
  *
@@ -144,9 +163,36 @@ void EncryptKey::Copy( const EncryptKey & copyMe )
 {
 	this->numIntegers = copyMe.numIntegers;
 	this->numRounds = copyMe.numRounds;
-	this->roundKey = copyMe.roundKey;
-	this->ucharRoundKey = reinterpret_cast<unsigned char*>(this->roundKey.GetDataPtr());
 	this->bitStrength = copyMe.bitStrength;
+
+	// Storage may be aligned differently in each object
+	const size_t roundKeySize = (numRounds + 1) * CipherAES::BLOCK_SIZE;
+	memcpy(this->GetStorage(),copyMe.GetRoundKeys(),roundKeySize);
+	memcpy(this->GetStorage() + CipherAES::MAXIMUM_ROUND_KEY_SIZE,copyMe.GetDecryptionRoundKeys(),roundKeySize);
+}
+
+/**
+ * @brief	Retrieves the aligned part of EncryptKey::roundKeyStorage.
+ *
+ * @return	pointer to encryption round keys, followed by decryption round keys
+ * CipherAES::MAXIMUM_ROUND_KEY_SIZE bytes later.
+ */
+unsigned char * EncryptKey::GetStorage()
+{
+	size_t address = reinterpret_cast<size_t>(roundKeyStorage);
+	return reinterpret_cast<unsigned char*>((address + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+}
+
+/**
+ * @brief	Retrieves the aligned part of EncryptKey::roundKeyStorage.
+ *
+ * @return	pointer to encryption round keys, followed by decryption round keys
+ * CipherAES::MAXIMUM_ROUND_KEY_SIZE bytes later.
+ */
+const unsigned char * EncryptKey::GetStorage() const
+{
+	size_t address = reinterpret_cast<size_t>(roundKeyStorage);
+	return reinterpret_cast<const unsigned char*>((address + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
 }
 
 
@@ -221,13 +267,14 @@ unsigned char * EncryptKey::RotateWordLeft(unsigned char * word)
 void EncryptKey::KeyExpansion(const Packet & key)
 {
 	unsigned char temp[4];
+	unsigned char * roundKey = GetStorage();
 	
 	// The first round key is the key itself.
 	for(size_t i=0;i<numIntegers;i++)
 	{
 		for(size_t n = 0;n<WORD_SIZE;n++)
 		{
-			roundKey.GetDataPtr()[i*4+n]=key.GetDataPtr()[i*4+n];
+			roundKey[i*4+n]=key.GetDataPtr()[i*4+n];
 		}
 	}
 
@@ -236,7 +283,7 @@ void EncryptKey::KeyExpansion(const Packet & key)
 	{
 		for(size_t j=0;j<WORD_SIZE;j++)
 		{
-			temp[j]=roundKey.GetDataPtr()[(i-1) * WORD_SIZE + j];
+			temp[j]=roundKey[(i-1) * WORD_SIZE + j];
 		}
 		if (i % numIntegers == 0)
 		{
@@ -260,9 +307,12 @@ void EncryptKey::KeyExpansion(const Packet & key)
 		// Combine temp with roundKey.
 		for(size_t n = 0;n<WORD_SIZE;n++)
 		{
-			roundKey.GetDataPtr()[i*WORD_SIZE+n] = roundKey.GetDataPtr()[(i-numIntegers)*WORD_SIZE+n] ^ temp[n];
+			roundKey[i*WORD_SIZE+n] = roundKey[(i-numIntegers)*WORD_SIZE+n] ^ temp[n];
 		}
 	}
+
+	// Decryption round keys are generated once here instead of every time data is decrypted.
+	CipherAES::ExpandDecryptionKey(numRounds,roundKey,roundKey + CipherAES::MAXIMUM_ROUND_KEY_SIZE);
 }
 
 
@@ -290,23 +340,15 @@ EncryptKey::~EncryptKey()
 // 
 void EncryptKey::SetBitStrength( size_t type, Packet & key )
 {
-	// Allocate new memory
+	// Round keys are stored in EncryptKey::roundKeyStorage, which is large enough for any bit strength
 	switch(type)
 	{
 		case 256:
-			roundKey.SetMemorySize(240);
-		break;
-
 		case 192:
-			roundKey.SetMemorySize(208);
-		break;
-
 		case 128:
-			roundKey.SetMemorySize(176);
 		break;
 
 		default:
-			roundKey.SetMemorySize(0);
 			_ErrorException(true,"setting the encrypt key type. Must be 256, 192 or 128 bit",1,__LINE__,__FILE__);
 		break;
 	}
@@ -318,9 +360,6 @@ void EncryptKey::SetBitStrength( size_t type, Packet & key )
 	numRounds = numIntegers+6;
 
 	this->bitStrength = type;
-
-	// Must be done after memory allocation takes place.
-	this->ucharRoundKey = reinterpret_cast<unsigned char*>(roundKey.GetDataPtr());
 }
 
 /**
@@ -334,13 +373,37 @@ unsigned char EncryptKey::GetNumRounds() const
 }
 
 /**
- * @brief	Returns pointer to round key.
+ * @brief	Retrieves the strength of encryption.
  *
- * @return	pointer to round key.
+ * @return	256, 192 or 128.
  */
-unsigned char * EncryptKey::GetRoundKeys() const
+size_t EncryptKey::GetBitStrength() const
 {
-	return ucharRoundKey;
+	return bitStrength;
+}
+
+/**
+ * @brief	Returns pointer to round keys used when encrypting.
+ *
+ * The first GetBitStrength() / 8 bytes are the key itself.
+ *
+ * @return	pointer to round keys, (GetNumRounds() + 1) * CipherAES::BLOCK_SIZE bytes in size
+ * and aligned to a CipherAES::BLOCK_SIZE byte boundary.
+ */
+const unsigned char * EncryptKey::GetRoundKeys() const
+{
+	return GetStorage();
+}
+
+/**
+ * @brief	Returns pointer to round keys used when decrypting, generated by CipherAES::ExpandDecryptionKey().
+ *
+ * @return	pointer to round keys, (GetNumRounds() + 1) * CipherAES::BLOCK_SIZE bytes in size
+ * and aligned to a CipherAES::BLOCK_SIZE byte boundary.
+ */
+const unsigned char * EncryptKey::GetDecryptionRoundKeys() const
+{
+	return GetStorage() + CipherAES::MAXIMUM_ROUND_KEY_SIZE;
 }
 
 /**
@@ -511,6 +574,38 @@ bool EncryptKey::TestClass()
 			problem = true;
 			cout << "Decryption 256 is bad\n";
 		}
+
+		// Precomputed decryption round keys, copies and keys constructed from bytes
+		Packet keyBytes;
+		keyBytes.Add(key1);
+		keyBytes.Add(key2);
+		keyBytes.Add(key3);
+		keyBytes.Add(key4);
+		EncryptKey fromBytes(keyBytes);
+		EncryptKey copied(fromBytes);
+
+		unsigned char decryptionRoundKey[CipherAES::MAXIMUM_ROUND_KEY_SIZE];
+		CipherAES::ExpandDecryptionKey(encryptKey256.GetNumRounds(),encryptKey256.GetRoundKeys(),decryptionRoundKey);
+		const size_t roundKeySize = (encryptKey256.GetNumRounds() + 1) * CipherAES::BLOCK_SIZE;
+
+		bool schedulesGood = memcmp(encryptKey256.GetDecryptionRoundKeys(),decryptionRoundKey,roundKeySize) == 0 &&
+							 fromBytes.GetBitStrength() == 256 &&
+							 memcmp(fromBytes.GetRoundKeys(),encryptKey256.GetRoundKeys(),roundKeySize) == 0 &&
+							 memcmp(copied.GetRoundKeys(),encryptKey256.GetRoundKeys(),roundKeySize) == 0 &&
+							 memcmp(copied.GetDecryptionRoundKeys(),decryptionRoundKey,roundKeySize) == 0;
+
+		bool alignmentGood = reinterpret_cast<size_t>(copied.GetRoundKeys()) % CipherAES::BLOCK_SIZE == 0 &&
+							 reinterpret_cast<size_t>(copied.GetDecryptionRoundKeys()) % CipherAES::BLOCK_SIZE == 0;
+
+		if(schedulesGood == true && alignmentGood == true)
+		{
+			cout << "Round key schedules are good\n";
+		}
+		else
+		{
+			problem = true;
+			cout << "Round key schedules are bad\n";
+		}
 	}
 	cout << "\n\n";
 	return !problem;
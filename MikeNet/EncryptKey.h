@@ -24,15 +24,19 @@ private:
 	unsigned char numRounds;
 
 	/**
-	 * @brief Round key, generated from EncryptKey::key which is used
-	 * when encrypting and decrypting.
+	 * @brief Alignment of round keys in bytes, so that they can be loaded a block at a time.
 	 */
-	Packet roundKey;
+	const static size_t ALIGNMENT = 16;
 
 	/**
-	 * @brief Pointer to data of EncryptKey::roundKey.
+	 * @brief Storage for round keys, generated from the key which are used
+	 * when encrypting and decrypting.
+	 *
+	 * The encryption round keys are followed by the decryption round keys, which are generated
+	 * once by CipherAES::ExpandDecryptionKey() so that decrypting does not need to transform them.
+	 * Both start at an EncryptKey::ALIGNMENT byte boundary within this storage, see GetStorage().
 	 */
-	unsigned char * ucharRoundKey;
+	unsigned char roundKeyStorage[2 * CipherAES::MAXIMUM_ROUND_KEY_SIZE + ALIGNMENT - 1];
 
 	/**
 	 * @brief Strength of encryption, either 256, 192 or 128.
@@ -42,6 +46,9 @@ private:
 	unsigned char * RotateWordLeft(unsigned char * RotateMe);
 	unsigned char * SubWord(unsigned char * SubMe);
 
+	unsigned char * GetStorage();
+	const unsigned char * GetStorage() const;
+
 	void SetBitStrength(size_t Type, Packet & key);
 	void KeyExpansion(const Packet & key);
 
@@ -55,10 +62,13 @@ public:
 	EncryptKey(int key1, int key2, int key3, int key4, int key5, int key6, bool differentType);
 	EncryptKey(__int64 key1, __int64 key2);
 	EncryptKey(int key1, int key2, int key3, int key4, bool differentType);
+	EncryptKey(const Packet & key);
 	~EncryptKey();
 
 	unsigned char GetNumRounds() const;
-	unsigned char * GetRoundKeys() const;
+	size_t GetBitStrength() const;
+	const unsigned char * GetRoundKeys() const;
+	const unsigned char * GetDecryptionRoundKeys() const;
 
 	static bool TestClass();
 };
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "FullInclude.h"
+
+EncryptKeyCache EncryptKeyCache::sharedCache;
+
+/**
+ * @brief Constructor.
+ */
+EncryptKeyCache::EncryptKeyCache() : CriticalSection()
+{
+
+}
+
+/**
+ * @brief Destructor, deallocates keys that have not been released.
+ */
+EncryptKeyCache::~EncryptKeyCache()
+{
+	for(size_t n = 0;n<entries.size();n++)
+	{
+		delete entries[n].key;
+	}
+}
+
+/**
+ * @brief Generates a hash of key bytes.
+ *
+ * @param key Key bytes.
+ *
+ * @return hash of @a key.
+ */
+size_t EncryptKeyCache::Hash(const Packet & key)
+{
+	// FNV-1a
+	unsigned int hash = 2166136261U;
+	const unsigned char * data = reinterpret_cast<const unsigned char*>(key.GetDataPtr());
+	for(size_t n = 0;n<key.GetUsedSize();n++)
+	{
+		hash = (hash ^ data[n]) * 16777619U;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Retrieves a key, creating it if no identical key is cached.
+ *
+ * @param key Key bytes, must be 16, 24 or 32 bytes in size (see EncryptKey::EncryptKey(const Packet &)).
+ *
+ * @return key which must be released using Release() when no longer needed, and must not be deallocated directly.
+ */
+EncryptKey * EncryptKeyCache::Acquire(const Packet & key)
+{
+	size_t hash = Hash(key);
+	size_t size = key.GetUsedSize();
+	EncryptKey * returnMe = NULL;
+
+	Enter();
+	try
+	{
+		for(size_t n = 0;n<entries.size();n++)
+		{
+			EncryptKey * cachedKey = entries[n].key;
+
+			// The first round keys are the key itself
+			if(entries[n].hash == hash && cachedKey->GetBitStrength() == size * 8 &&
+			   memcmp(cachedKey->GetRoundKeys(),key.GetDataPtr(),size) == 0)
+			{
+				entries[n].references++;
+				returnMe = cachedKey;
+				break;
+			}
+		}
+
+		if(returnMe == NULL)
+		{
+			returnMe = new (nothrow) EncryptKey(key);
+			Utility::DynamicAllocCheck(returnMe,__LINE__,__FILE__);
+
+			Entry entry;
+			entry.hash = hash;
+			entry.references = 1;
+			entry.key = returnMe;
+
+			try
+			{
+				entries.push_back(entry);
+			}
+			catch(...){delete returnMe; throw;}
+		}
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){Leave(); throw(error);}
+	catch(...){Leave(); throw(-1);}
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Releases a key retrieved using Acquire(), deallocating it if there are no other users.
+ *
+ * @param key Key to release.
+ *
+ * @throws ErrorReport If @a key was not retrieved from this cache.
+ */
+void EncryptKeyCache::Release(const EncryptKey * key)
+{
+	Enter();
+	try
+	{
+		bool found = false;
+		for(size_t n = 0;n<entries.size();n++)
+		{
+			if(entries[n].key == key)
+			{
+				found = true;
+				entries[n].references--;
+
+				if(entries[n].references == 0)
+				{
+					delete entries[n].key;
+					entries[n] = entries.back();
+					entries.pop_back();
+				}
+				break;
+			}
+		}
+
+		_ErrorException((found == false),"releasing an encryption key, the key was not created by this cache",0,__LINE__,__FILE__);
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){Leave(); throw(error);}
+	catch(...){Leave(); throw(-1);}
+	Leave();
+}
+
+/**
+ * @brief Retrieves the number of distinct keys that are cached.
+ *
+ * @return number of keys.
+ */
+size_t EncryptKeyCache::GetAmount() const
+{
+	Enter();
+	size_t returnMe = entries.size();
+	Leave();
+	return returnMe;
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool EncryptKeyCache::TestClass()
+{
+	cout << "Testing EncryptKeyCache class...\n";
+	bool problem = false;
+
+	EncryptKeyCache cache;
+
+	Packet keyA;
+	keyA.Add<__int64>(1234);
+	keyA.Add<__int64>(5678);
+
+	Packet keyB;
+	keyB.Add<__int64>(1234);
+	keyB.Add<__int64>(5679);
+
+	// Same bytes as keyA, added as 32 bit integers
+	Packet keyC;
+	keyC.Add<int>(1234);
+	keyC.Add<int>(0);
+	keyC.Add<int>(5678);
+	keyC.Add<int>(0);
+
+	EncryptKey * a1 = cache.Acquire(keyA);
+	EncryptKey * b = cache.Acquire(keyB);
+	EncryptKey * a2 = cache.Acquire(keyC);
+
+	EncryptKey expected(1234,5678);
+	bool keyGood = memcmp(a1->GetRoundKeys(),expected.GetRoundKeys(),(expected.GetNumRounds() + 1) * CipherAES::BLOCK_SIZE) == 0;
+
+	if(a1 == a2 && a1 != b && cache.GetAmount() == 2 && keyGood == true)
+	{
+		cout << "Acquire is good\n";
+	}
+	else
+	{
+		cout << "Acquire is bad\n";
+		problem = true;
+	}
+
+	cache.Release(a1);
+	size_t amountAfterFirst = cache.GetAmount();
+	cache.Release(a2);
+	cache.Release(b);
+
+	bool errorGood = false;
+	try
+	{
+		cache.Release(&expected);
+	}
+	catch(ErrorReport & error)
+	{
+		errorGood = true;
+	}
+
+	if(amountAfterFirst == 2 && cache.GetAmount() == 0 && errorGood == true)
+	{
+		cout << "Release is good\n";
+	}
+	else
+	{
+		cout << "Release is bad\n";
+		problem = true;
+	}
+
+	// Compare creating a key per client against sharing one through the cache
+	const size_t numClients = 10000;
+	Packet key256;
+	key256.Add<__int64>(1);
+	key256.Add<__int64>(2);
+	key256.Add<__int64>(3);
+	key256.Add<__int64>(4);
+
+	DWORD startTime = GetTickCount();
+	for(size_t n = 0;n<numClients;n++)
+	{
+		EncryptKey * key = new (nothrow) EncryptKey(key256);
+		Utility::DynamicAllocCheck(key,__LINE__,__FILE__);
+		delete key;
+	}
+	DWORD expansionTime = GetTickCount() - startTime;
+
+	vector<EncryptKey*> sharedKeys(numClients);
+	startTime = GetTickCount();
+	for(size_t n = 0;n<numClients;n++)
+	{
+		sharedKeys[n] = cache.Acquire(key256);
+	}
+	DWORD cacheTime = GetTickCount() - startTime;
+
+	for(size_t n = 0;n<numClients;n++)
+	{
+		cache.Release(sharedKeys[n]);
+	}
+
+	cout << "Creating " << numClients << " 256 bit keys: " << expansionTime << "ms with key expansion, " << cacheTime << "ms with cache\n";
+
+	cout << "\n\n";
+	return !problem;
+}
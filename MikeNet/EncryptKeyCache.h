@@ -0,0 +1,51 @@
+#pragma once
+#include "EncryptKey.h"
+
+/**
+ * @brief	Shares EncryptKey objects between users of identical keys.
+ *
+ * Key expansion is done once per distinct key, so creating many keys with the same
+ * value (e.g. one per client) costs a lookup instead of a key expansion. Keys are reference
+ * counted, each Acquire() must be matched by a Release() and the key is deallocated when
+ * the last user releases it.\n\n
+ *
+ * Keys are immutable once created so they can be shared safely.\n\n
+ *
+ * This class is thread safe.
+ */
+class EncryptKeyCache : public CriticalSection
+{
+	/** @brief Cached key. */
+	struct Entry
+	{
+		/** @brief Hash of key bytes, compared before the bytes themselves. */
+		size_t hash;
+
+		/** @brief Number of users of the key. */
+		size_t references;
+
+		/** @brief Key, owned by the cache. */
+		EncryptKey * key;
+	};
+
+	/** @brief Cached keys, in no particular order. */
+	vector<Entry> entries;
+
+	static size_t Hash(const Packet & key);
+
+	EncryptKeyCache(const EncryptKeyCache &);
+	EncryptKeyCache & operator= (const EncryptKeyCache &);
+public:
+	/** @brief Cache used by the flat API, see mn::CreateKey256(). */
+	static EncryptKeyCache sharedCache;
+
+	EncryptKeyCache();
+	~EncryptKeyCache();
+
+	EncryptKey * Acquire(const Packet & key);
+	void Release(const EncryptKey * key);
+
+	size_t GetAmount() const;
+
+	static bool TestClass();
+};
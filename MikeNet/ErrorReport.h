@@ -1,7 +1,8 @@
 #pragma once
-#include "ConcurrencyEvent.h"
-#include "ConcurrentObject.h"
-#include "StoreQueue.h"
+#include "CriticalSection.h"
+
+class ConcurrencyEvent;
+template<class T> class ConcurrentObject;
 
 /**
  * @brief	Stores an error report.
@@ -13,16 +13,22 @@
 #define ALREADY_INCLUDED_LIBS
 
 // Required header files used throughout MikeNet
-#include <winsock2.h>
-#include <Windows.h>
+#ifdef _WIN32
+	#include <winsock2.h>
+	#include <Windows.h>
+	#include <ws2tcpip.h>
+	#include <Wspiapi.h>
+	#include <Netfw.h>
+	#include <MMReg.h>
+#else
+	#include "PlatformLinux.h"
+#endif
 #include <time.h>
 #include <queue>
-#include <ws2tcpip.h>
-#include <Wspiapi.h>
+#include <utility>
+#include <functional>
 #include <exception>
 #include <stdlib.h>
-#include <Netfw.h>
-#include <MMReg.h>
 #include <cmath>
 #include <iostream>
 
@@ -34,8 +40,12 @@ using namespace std;
 // MikeNet modules
 #include "GlobalInclude.h"
 #include "NetworkFullInclude.h"
-#include "UPnPFullInclude.h"
-#include "SoundFullInclude.h"
+
+// UPnP and sound modules depend on COM and the Windows multimedia API
+#ifdef _WIN32
+	#include "UPnPFullInclude.h"
+	#include "SoundFullInclude.h"
+#endif
 
 // Wrapper for DBP compatibility
 #ifdef DBP
@@ -14,42 +14,51 @@
 #include "GlobalObjects.h"
 #include "GlobalDefinitions.h"
 #include "BitMacros.h"
+#include "CriticalSection.h"
+#include "ErrorFunctions.h"
+#include "ErrorReport.h"
+#include "Utility.h"
 #include "Store.h"
 #include "StoreVector.h"
-#include "Utility.h"
-#include "CriticalSection.h"
 #include "ConcurrencyControlSimple.h"
 #include "ConcurrencyControl.h"
+#include "ConcurrentObject.h"
+#include "ConcurrencyEvent.h"
+#include "StoreQueue.h"
 
+#include "MemoryRecycleSlab.h"
 #include "MemoryRecyclePacket.h"
 #include "MemoryRecyclePacketRestricted.h"
 #include "UsageTracker.h"
 
-#include "ErrorFunctions.h"
-#include "ConcurrentObject.h"
-#include "ConcurrencyEvent.h"
-#include "StoreQueue.h"
-#include "ErrorReport.h"
 #include "Counter.h"
 #include "Timer.h"
-#include "Store.h"
+#include "TimerWheel.h"
 
 #include "ThreadSingle.h"
 #include "ThreadSingleGroup.h"
 #include "CompletionKey.h"
 #include "CompletionPort.h"
+#include "ThreadMessageQueue.h"
 #include "ThreadSingleMessage.h"
 #include "ThreadSingleMessageKeepLast.h"
 #include "ThreadSingleMessageKeepLastUser.h"
 #include "ThreadMessageItem.h"
 #include "ThreadMessageItemShutdown.h"
 #include "EncryptionThread.h"
+#include "CipherAES.h"
 #include "ThreadMessageItemEncrypt.h"
 #include "EncryptKey.h"
+#include "EncryptKeyCache.h"
+#include "CipherGCM.h"
 #include "Packet.h"
+#include "PacketBuilder.h"
+#include "PacketReader.h"
 
 #include "MemoryRecyclePacket.h"
 
-#include "ComString.h"
-#include "ComUtility.h"
+#ifdef _WIN32
+	#include "ComString.h"
+	#include "ComUtility.h"
+#endif
 #include "PointerConverter.h"
\ No newline at end of file
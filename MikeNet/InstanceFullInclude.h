@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include "NetClientQueue.h"
 #include "NetInstance.h"
 
 #include "NetInstanceTCP.h"
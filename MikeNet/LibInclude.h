@@ -6,6 +6,7 @@
 	#pragma comment(lib, "winmm.lib")
 	#pragma comment(lib, "user32.lib")
 	#pragma comment(lib, "Oleaut32.lib")
+	#pragma comment(lib, "Advapi32.lib")
 
 	#ifndef _WIN64
 		#ifdef _DEBUG
@@ -1,29 +1,133 @@
 #include "FullInclude.h"
 #include "MemoryRecyclePacket.h"
 
+const DWORD MemoryRecyclePacket::threadCacheStorageIndex = TlsAlloc();
+volatile LONG MemoryRecyclePacket::threadCacheAssigned = 0;
+
 /**
- * @brief	Constructor. 
+ * @brief	Allocates the lock free lists and fills the recycle bin.
  *
- * @param	numberOfPackets	Number of packets that should be in the recycle bin. Initially there
- * will be this many packets in the recycle bin. Thereafter, although the number of packets stored in
- * the recycle bin may decrease, it will never exceed this number.
- * @param	packetSize		The size of packets stored in the recycle bin. No packet less than or greater
- * than this value will ever be stored in the recycle bin.
+ * Memory usage is not logged by this method.
+ *
+ * @param	numberOfPackets	Maximum number of packets that can be stored in the recycle bin.
+ * @param	packetSize		The size of packets stored in the recycle bin. If a slab is used this is rounded up to the slab's size class.
+ * @param	initialPackets	Number of packets of size @a packetSize to put in the recycle bin, must not be more than @a numberOfPackets.
+ * @param	slabBlocksPerClass	If more than 0, a MemoryRecycleSlab storing up to this many blocks of each size class
+ * is created and used by all packets retrieved from this object.
  */
-MemoryRecyclePacket::MemoryRecyclePacket(size_t numberOfPackets, size_t packetSize)
+void MemoryRecyclePacket::Initialize(size_t numberOfPackets, size_t packetSize, size_t initialPackets, size_t slabBlocksPerClass)
 {
 	this->numberOfPackets = numberOfPackets;
+	this->storedAmount = 0;
+	this->nodes = NULL;
+	this->slab = NULL;
+
+	if(slabBlocksPerClass > 0)
+	{
+		slab = new (nothrow) MemoryRecycleSlab(slabBlocksPerClass);
+		Utility::DynamicAllocCheck(slab,__LINE__,__FILE__);
+
+		// Packets using the slab have a memory size equal to a size class
+		packetSize = MemoryRecycleSlab::GetBlockSize(packetSize);
+	}
 	this->packetSize = packetSize;
 
-	recycleBin.ResizeAllocate(numberOfPackets);
+	for(size_t n = 0;n<THREAD_CACHE_AMOUNT;n++)
+	{
+		threadCache[n].inUse = 0;
+		threadCache[n].amount = 0;
+	}
+
+	recycleBin = static_cast<PSLIST_HEADER>(_aligned_malloc(sizeof(SLIST_HEADER),MEMORY_ALLOCATION_ALIGNMENT));
+	Utility::DynamicAllocCheck(recycleBin,__LINE__,__FILE__);
+	InitializeSListHead(recycleBin);
+
+	unusedNodes = static_cast<PSLIST_HEADER>(_aligned_malloc(sizeof(SLIST_HEADER),MEMORY_ALLOCATION_ALIGNMENT));
+	Utility::DynamicAllocCheck(unusedNodes,__LINE__,__FILE__);
+	InitializeSListHead(unusedNodes);
+
+	if(numberOfPackets > 0)
+	{
+		nodes = static_cast<RecycleNode*>(_aligned_malloc(sizeof(RecycleNode) * numberOfPackets,MEMORY_ALLOCATION_ALIGNMENT));
+		Utility::DynamicAllocCheck(nodes,__LINE__,__FILE__);
+
+		for(size_t n = 0;n<numberOfPackets;n++)
+		{
+			nodes[n].packet = NULL;
+			InterlockedPushEntrySList(unusedNodes,&nodes[n].entry);
+		}
+	}
+
+	for(size_t n = 0;n<initialPackets;n++)
+	{
+		Packet * packet = new (nothrow) Packet();
+		Utility::DynamicAllocCheck(packet,__LINE__,__FILE__);
+		packet->SetSlab(slab);
+		packet->SetMemorySize(packetSize);
+		Store(packet);
+	}
+}
+
+/**
+ * @brief	Deallocates all stored packets and the lock free lists.
+ *
+ * Memory usage is not logged by this method.
+ */
+void MemoryRecyclePacket::Cleanup()
+{
+	for(size_t n = 0;n<THREAD_CACHE_AMOUNT;n++)
+	{
+		for(size_t i = 0;i<threadCache[n].amount;i++)
+		{
+			delete threadCache[n].packets[i];
+		}
+		threadCache[n].amount = 0;
+	}
+
+	if(recycleBin != NULL)
+	{
+		RecycleNode * node;
+		while((node = reinterpret_cast<RecycleNode*>(InterlockedPopEntrySList(recycleBin))) != NULL)
+		{
+			delete node->packet;
+		}
+	}
+
+	_aligned_free(nodes);
+	_aligned_free(recycleBin);
+	_aligned_free(unusedNodes);
+
+	nodes = NULL;
+	recycleBin = NULL;
+	unusedNodes = NULL;
+	storedAmount = 0;
 
-	for(size_t n = 0;n<recycleBin.Size();n++)
+	// Packets still in use hold their own reference
+	if(slab != NULL)
 	{
-		recycleBin[n].SetMemorySize(packetSize);
-		this->IncreaseMemorySize(packetSize);
+		slab->Release();
+		slab = NULL;
 	}
 }
 
+/**
+ * @brief	Constructor.
+ *
+ * @param	numberOfPackets	Number of packets that should be in the recycle bin. Initially there
+ * will be this many packets in the recycle bin. Thereafter, although the number of packets stored in
+ * the recycle bin may decrease, it will never exceed this number.
+ * @param	packetSize		The size of packets stored in the recycle bin. No packet less than
+ * this value will ever be stored in the recycle bin.
+ * @param	slabBlocksPerClass	If more than 0, memory of packets retrieved from this object is allocated from a MemoryRecycleSlab
+ * which stores up to this many blocks of each size class, so that packets larger than @a packetSize are recycled too.
+ * @a packetSize is rounded up to the slab's size class. (Optional, default = 0).
+ */
+MemoryRecyclePacket::MemoryRecyclePacket(size_t numberOfPackets, size_t packetSize, size_t slabBlocksPerClass)
+{
+	Initialize(numberOfPackets,packetSize,numberOfPackets,slabBlocksPerClass);
+	this->IncreaseMemorySize(numberOfPackets * this->packetSize);
+}
+
 /**
  * @brief Default constructor.
  *
@@ -32,26 +136,26 @@ MemoryRecyclePacket::MemoryRecyclePacket(size_t numberOfPackets, size_t packetSi
  */
 MemoryRecyclePacket::MemoryRecyclePacket()
 {
-	this->numberOfPackets = 0;
-	this->packetSize = 0;
+	Initialize(0,0,0,0);
 }
 
 /**
  * @brief	Copies the contents of @a copyMe into this object (deep).
  *
+ * The recycle bin of this object is filled with as many packets as are stored by @a copyMe.
+ * If @a copyMe uses a slab, this object uses a new slab with the same limit.
+ *
  * @param	copyMe	The object to copy.
  */
 void MemoryRecyclePacket::Copy(const MemoryRecyclePacket & copyMe)
 {
-	this->recycleBin = copyMe.recycleBin;
-	this->numberOfPackets = copyMe.numberOfPackets;
-	this->packetSize = copyMe.packetSize;
+	Initialize(copyMe.numberOfPackets,copyMe.packetSize,copyMe.GetStoredAmount(),copyMe.GetSlabBlocksPerClass());
 }
 
 /**
- * @brief	Deep copy constructor. 
+ * @brief	Deep copy constructor.
  *
- * @param	copyMe	Object to copy. 
+ * @param	copyMe	Object to copy.
  */
 MemoryRecyclePacket::MemoryRecyclePacket( const MemoryRecyclePacket & copyMe ) :
 	MemoryUsageLog(copyMe)
@@ -60,25 +164,34 @@ MemoryRecyclePacket::MemoryRecyclePacket( const MemoryRecyclePacket & copyMe ) :
 }
 
 /**
- * @brief	Deep assignment operator. 
+ * @brief	Deep assignment operator.
  *
- * @param	copyMe	Object to copy. 
+ * @param	copyMe	Object to copy.
  *
- * @return	a deep copy of this object. 
+ * @return	a deep copy of this object.
  */
 MemoryRecyclePacket & MemoryRecyclePacket::operator=(const MemoryRecyclePacket & copyMe)
 {
-	MemoryUsageLog::operator=(copyMe);
-	Copy(copyMe);
+	if(this != &copyMe)
+	{
+		MemoryUsageLog::operator=(copyMe);
+		Cleanup();
+		Copy(copyMe);
+	}
 	return *this;
 }
 
 /**
- * @brief	Destructor. 
+ * @brief	Destructor.
  */
 MemoryRecyclePacket::~MemoryRecyclePacket(void)
 {
-
+	const char * cCommand = "an internal function (~MemoryRecyclePacket)";
+	try
+	{
+		Cleanup();
+	}
+	MSG_CATCH
 }
 
 /**
@@ -103,6 +216,173 @@ size_t MemoryRecyclePacket::GetMaxNumberOfPackets() const
 	return this->numberOfPackets;
 }
 
+/**
+ * @brief	Retrieves the number of packets currently stored by this object, ready to be recycled.
+ *
+ * @return	the number of packets stored.
+ */
+size_t MemoryRecyclePacket::GetStoredAmount() const
+{
+	return static_cast<size_t>(this->storedAmount);
+}
+
+/**
+ * @brief	Retrieves the maximum number of blocks of each size class stored by the slab of this object.
+ *
+ * @return	the maximum number of blocks, 0 if no slab is used.
+ */
+size_t MemoryRecyclePacket::GetSlabBlocksPerClass() const
+{
+	if(slab == NULL)
+	{
+		return 0;
+	}
+	return slab->GetMaximumBlocks();
+}
+
+/**
+ * @brief	Retrieves the slab that packets retrieved from this object allocate memory from.
+ *
+ * The slab's MemoryUsageLog reports the memory it stores and its hit rate.
+ *
+ * @return	the slab, NULL if no slab is used.
+ */
+const MemoryRecycleSlab * MemoryRecyclePacket::GetSlab() const
+{
+	return slab;
+}
+
+/**
+ * @brief	Retrieves the index of the calling thread's cache.
+ *
+ * Threads are assigned caches in turn the first time they use this method, so that up to
+ * THREAD_CACHE_AMOUNT threads each have their own cache regardless of their thread IDs.
+ *
+ * @return	index into MemoryRecyclePacket::threadCache.
+ */
+size_t MemoryRecyclePacket::GetThreadCacheIndex()
+{
+	size_t index = reinterpret_cast<size_t>(TlsGetValue(threadCacheStorageIndex));
+	if(index == 0)
+	{
+		index = (static_cast<ULONG>(InterlockedIncrement(&threadCacheAssigned)) % THREAD_CACHE_AMOUNT) + 1;
+		TlsSetValue(threadCacheStorageIndex,reinterpret_cast<LPVOID>(index));
+	}
+
+	return index - 1;
+}
+
+/**
+ * @brief	Retrieves the calling thread's cache and prevents other threads from using it.
+ *
+ * Each thread uses the cache assigned by GetThreadCacheIndex().
+ *
+ * @return	the cache, which must be released using LeaveThreadCache().
+ * @return	NULL if another thread is using the cache.
+ */
+MemoryRecyclePacket::ThreadCache * MemoryRecyclePacket::EnterThreadCache()
+{
+	ThreadCache * cache = &threadCache[GetThreadCacheIndex()];
+
+	if(InterlockedCompareExchange(&cache->inUse,1,0) == 0)
+	{
+		return cache;
+	}
+	return NULL;
+}
+
+/**
+ * @brief	Allows other threads to use a cache retrieved by EnterThreadCache().
+ *
+ * @param [in]	cache	Cache to release.
+ */
+void MemoryRecyclePacket::LeaveThreadCache(ThreadCache * cache)
+{
+	InterlockedExchange(&cache->inUse,0);
+}
+
+/**
+ * @brief	Removes a packet from the calling thread's cache or the recycle bin without waiting for other threads.
+ *
+ * @return	a stored packet.
+ * @return	NULL if no packet is stored.
+ */
+Packet * MemoryRecyclePacket::Take()
+{
+	Packet * packet = NULL;
+
+	ThreadCache * cache = EnterThreadCache();
+	if(cache != NULL)
+	{
+		if(cache->amount > 0)
+		{
+			cache->amount--;
+			packet = cache->packets[cache->amount];
+		}
+		LeaveThreadCache(cache);
+	}
+
+	if(packet == NULL)
+	{
+		RecycleNode * node = reinterpret_cast<RecycleNode*>(InterlockedPopEntrySList(recycleBin));
+		if(node != NULL)
+		{
+			packet = node->packet;
+			node->packet = NULL;
+			InterlockedPushEntrySList(unusedNodes,&node->entry);
+		}
+	}
+
+	// Only decreased once the node is unused, so that Store() always finds an unused node
+	if(packet != NULL)
+	{
+		InterlockedDecrement(&storedAmount);
+	}
+
+	return packet;
+}
+
+/**
+ * @brief	Stores a packet in the calling thread's cache or the recycle bin without waiting for other threads.
+ *
+ * @param [in]	packet	Packet to store, not changed if it cannot be stored.
+ *
+ * @return	true if the packet was stored, false if MemoryRecyclePacket::numberOfPackets packets are already stored.
+ */
+bool MemoryRecyclePacket::Store(Packet * packet)
+{
+	if(static_cast<size_t>(InterlockedIncrement(&storedAmount)) > numberOfPackets)
+	{
+		InterlockedDecrement(&storedAmount);
+		return false;
+	}
+
+	ThreadCache * cache = EnterThreadCache();
+	if(cache != NULL)
+	{
+		bool stored = false;
+		if(cache->amount < THREAD_CACHE_SIZE)
+		{
+			cache->packets[cache->amount] = packet;
+			cache->amount++;
+			stored = true;
+		}
+		LeaveThreadCache(cache);
+
+		if(stored == true)
+		{
+			return true;
+		}
+	}
+
+	RecycleNode * node = reinterpret_cast<RecycleNode*>(InterlockedPopEntrySList(unusedNodes));
+	_ErrorException((node == NULL),"recycling a packet, no unused node is available",0,__LINE__,__FILE__);
+
+	node->packet = packet;
+	InterlockedPushEntrySList(recycleBin,&node->entry);
+	return true;
+}
+
 /**
  * @brief	Retrieves a packet from the recycle bin if possible.
  *
@@ -110,11 +390,15 @@ size_t MemoryRecyclePacket::GetMaxNumberOfPackets() const
  * is less than or equal to GetPacketMemorySize. If possible
  * this packet will be retrieved from the recycle bin, but if the recycle bin is
  * empty then a fresh packet will be created using non recycled memory. Non recycled
- * memory is also used if the requested packet size is more than GetPacketMemorySize.
+ * memory is also used if the requested packet size is more than GetPacketMemorySize.\n\n
+ *
+ * Retrieving a packet from the recycle bin does not wait for other threads. Retrieving from the recycle bin
+ * is logged as a hit and allocating a fresh packet as a miss (see MemoryUsageLog::GetRecycleHitPercentage()).
+ * If a slab is used, the memory of fresh packets is allocated from the slab.
  *
  * @param	memorySizeOfPacket		The requested memory size of the packet.
  * @param   memoryRestrictor		Object which keeps track of this object's memory usage and restricts it. Object
- * may keep track of other objects too. Set to NULL if memory should not be restricted. (Optional, default = NULL). 
+ * may keep track of other objects too. Set to NULL if memory should not be restricted. (Optional, default = NULL).
  * @param	allocatedFreshMemory	If non NULL, is set to true if fresh memory was allocated to the returned packet,
  * and set to false if recycled memory was used. (Optional, default = NULL).
  *
@@ -125,63 +409,49 @@ size_t MemoryRecyclePacket::GetMaxNumberOfPackets() const
 Packet * MemoryRecyclePacket::GetPacket( size_t memorySizeOfPacket, const MemoryUsageRestricted * memoryRestrictor, bool * allocatedFreshMemory )
 {
 	Packet * packet = NULL;
+	size_t freshMemorySize = memorySizeOfPacket;
 
-	recycleBin.Enter();
-	try
+	if(memorySizeOfPacket <= this->GetPacketMemorySize())
 	{
-		if(memorySizeOfPacket <= this->GetPacketMemorySize() )
-		{
-			if(recycleBin.Size() > 0)
-			{
-				packet = recycleBin.Extract(0);
-
-				if(allocatedFreshMemory != NULL)
-				{
-					*allocatedFreshMemory = false;
-				}
-			}
-			else
-			{
-				if(memoryRestrictor != NULL)
-				{
-					memoryRestrictor->EnforceMemoryLimitIncrease(this->GetPacketMemorySize());
-				}
-
-				packet = new (nothrow) Packet();
-				Utility::DynamicAllocCheck(packet,__LINE__,__FILE__);
-
-				packet->SetMemorySize(this->GetPacketMemorySize());
+		packet = Take();
+		freshMemorySize = this->GetPacketMemorySize();
+	}
 
-				this->IncreaseMemorySize(this->GetPacketMemorySize());
+	if(packet != NULL)
+	{
+		this->LogRecycleHit();
 
-				if(allocatedFreshMemory != NULL)
-				{
-					*allocatedFreshMemory = true;
-				}
-			}
+		if(allocatedFreshMemory != NULL)
+		{
+			*allocatedFreshMemory = false;
 		}
-		else
+	}
+	else
+	{
+		if(slab != NULL)
 		{
-			if(memoryRestrictor != NULL)
-			{
-				memoryRestrictor->EnforceMemoryLimitIncrease(memorySizeOfPacket);
-			}
+			freshMemorySize = MemoryRecycleSlab::GetBlockSize(freshMemorySize);
+		}
 
-			packet = new (nothrow) Packet();
-			Utility::DynamicAllocCheck(packet,__LINE__,__FILE__);
+		if(memoryRestrictor != NULL)
+		{
+			memoryRestrictor->EnforceMemoryLimitIncrease(freshMemorySize);
+		}
 
-			packet->SetMemorySize(memorySizeOfPacket);
-			
-			this->IncreaseMemorySize(memorySizeOfPacket);
+		packet = new (nothrow) Packet();
+		Utility::DynamicAllocCheck(packet,__LINE__,__FILE__);
 
-			if(allocatedFreshMemory != NULL)
-			{
-				*allocatedFreshMemory = true;
-			}
+		packet->SetSlab(slab);
+		packet->SetMemorySize(freshMemorySize);
+
+		this->IncreaseMemorySize(packet->GetMemorySize());
+		this->LogRecycleMiss();
+
+		if(allocatedFreshMemory != NULL)
+		{
+			*allocatedFreshMemory = true;
 		}
 	}
-	catch(ErrorReport & report){recycleBin.Leave(); throw report;}
-	recycleBin.Leave();
 
 	return packet;
 }
@@ -191,9 +461,14 @@ Packet * MemoryRecyclePacket::GetPacket( size_t memorySizeOfPacket, const Memory
  *
  * The specified packet is consumed by this object, whether it is recycled
  * or not. For the packet to be recycled, the recycle bin must not have reached
- * its limit of GetNumberOfPackets packets, and the packet must be of size. 
- * GetPacketMemorySize. If the packet cannot be recycled it will be deallocated
- * with no recycling.
+ * its limit of GetNumberOfPackets packets, and the packet's memory size must be
+ * at least GetPacketMemorySize and at most MAXIMUM_GROWTH times GetPacketMemorySize.
+ * Packets whose memory has grown (see Packet::Reserve()) keep their capacity when recycled.
+ * If the packet cannot be recycled it will be deallocated with no recycling.\n\n
+ *
+ * The packet's current memory size must already be logged by this object, i.e. any
+ * growth since the packet was retrieved using GetPacket must have been logged using IncreaseMemorySize.
+ * Recycling a packet does not wait for other threads.
  *
  * @param [in]	packet	The packet to recycle. This is always consumed and should
  * not be referenced elsewhere after this call.
@@ -202,35 +477,264 @@ Packet * MemoryRecyclePacket::GetPacket( size_t memorySizeOfPacket, const Memory
  */
 bool MemoryRecyclePacket::RecyclePacket( Packet * packet )
 {
-	bool addedToRecyleBin;
+	if(packet == NULL)
+	{
+		return false;
+	}
+
+	if(packet->GetMemorySize() >= this->GetPacketMemorySize() &&
+	   packet->GetMemorySize() / MAXIMUM_GROWTH <= this->GetPacketMemorySize())
+	{
+		// Cleared before being stored, because another thread may retrieve it straight away
+		packet->Clear();
+
+		if(Store(packet) == true)
+		{
+			return true;
+		}
+	}
+
+	size_t sizeOfPacketToDeallocate = packet->GetMemorySize();
+	delete packet;
+	this->DecreaseMemorySize(sizeOfPacketToDeallocate);
+
+	return false;
+}
+
+/**
+ * @brief	Parameters of MemoryRecyclePacketBenchmarkThread.
+ */
+struct MemoryRecyclePacketBenchmarkParameters
+{
+	/** @brief Object to retrieve packets from, if NULL packets are allocated and deallocated using new and delete. */
+	MemoryRecyclePacket * recycle;
+
+	/** @brief Number of packets to retrieve and recycle. */
+	size_t iterations;
+
+	/** @brief Memory size of packets. */
+	size_t packetSize;
+};
+
+/**
+ * @brief	Benchmark thread which repeatedly retrieves and recycles packets.
+ *
+ * @param	lpParameter	Pointer to ThreadSingle object, which contains pointer to MemoryRecyclePacketBenchmarkParameters to use.
+ *
+ * @return	0.
+ */
+DWORD WINAPI MemoryRecyclePacketBenchmarkThread(LPVOID lpParameter)
+{
+	ThreadSingle * thread = (ThreadSingle*)lpParameter;
+	MemoryRecyclePacketBenchmarkParameters * parameters = static_cast<MemoryRecyclePacketBenchmarkParameters*>(thread->GetParameter());
+
+	const size_t batch = 4;
+	Packet * packets[batch];
+
+	for(size_t n = 0;n<parameters->iterations;n+=batch)
+	{
+		for(size_t i = 0;i<batch;i++)
+		{
+			if(parameters->recycle != NULL)
+			{
+				packets[i] = parameters->recycle->GetPacket(parameters->packetSize);
+			}
+			else
+			{
+				packets[i] = new Packet();
+				packets[i]->SetMemorySize(parameters->packetSize);
+			}
+			packets[i]->Add<int>(static_cast<int>(n));
+		}
+
+		for(size_t i = 0;i<batch;i++)
+		{
+			if(parameters->recycle != NULL)
+			{
+				parameters->recycle->RecyclePacket(packets[i]);
+			}
+			else
+			{
+				delete packets[i];
+			}
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief	Retrieves and recycles packets from several threads at the same time.
+ *
+ * @param	recycle		Object to retrieve packets from, if NULL packets are allocated and deallocated using new and delete.
+ * @param	numThreads	Number of threads.
+ * @param	iterations	Number of packets each thread retrieves and recycles.
+ *
+ * @return	the time taken in milliseconds.
+ */
+static DWORD MemoryRecyclePacketBenchmark(MemoryRecyclePacket * recycle, size_t numThreads, size_t iterations)
+{
+	MemoryRecyclePacketBenchmarkParameters parameters;
+	parameters.recycle = recycle;
+	parameters.iterations = iterations;
+	parameters.packetSize = 1024;
+
+	ThreadSingleGroup threads;
+	for(size_t n = 0;n<numThreads;n++)
+	{
+		ThreadSingle * thread = new (nothrow) ThreadSingle(&MemoryRecyclePacketBenchmarkThread,&parameters);
+		Utility::DynamicAllocCheck(thread,__LINE__,__FILE__);
+		threads.Add(thread);
+	}
+
+	DWORD startTime = GetTickCount();
+	for(size_t n = 0;n<numThreads;n++)
+	{
+		threads[n].Resume();
+	}
+	threads.WaitForThreadsToExit();
+	return GetTickCount() - startTime;
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool MemoryRecyclePacket::TestClass()
+{
+	cout << "Testing MemoryRecyclePacket class...\n";
+	bool problem = false;
 
-	recycleBin.Enter();
-	try
 	{
-		if(packet != NULL &&
-		   recycleBin.Size() < numberOfPackets &&
-		   packet->GetMemorySize() == this->GetPacketMemorySize())
+		MemoryRecyclePacket recycle(4,100);
+		if(recycle.GetStoredAmount() != 4 || recycle.GetMemorySize() != 400)
+		{
+			cout << "Constructor is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Constructor is good\n";
+		}
+
+		Packet * packets[5];
+		bool fresh[5];
+		for(size_t n = 0;n<5;n++)
 		{
-			packet->Clear();
-			recycleBin.Add(packet);
-			addedToRecyleBin = true;
+			packets[n] = recycle.GetPacket(50,NULL,&fresh[n]);
+		}
+
+		if(fresh[0] == true || fresh[3] == true || fresh[4] == false || recycle.GetStoredAmount() != 0 ||
+		   recycle.GetMemorySize() != 500 || packets[0]->GetMemorySize() != 100)
+		{
+			cout << "GetPacket is bad\n";
+			problem = true;
 		}
 		else
 		{
-			size_t sizeOfPacketToDeallocate = 0;
-			if(packet != NULL)
+			cout << "GetPacket is good\n";
+		}
+
+		// Only four packets can be stored, the fifth is deallocated
+		packets[0]->AddStringC("hello",0,false);
+		size_t recycled = 0;
+		for(size_t n = 0;n<5;n++)
+		{
+			if(recycle.RecyclePacket(packets[n]) == true)
 			{
-				sizeOfPacketToDeallocate = packet->GetMemorySize();
+				recycled++;
 			}
+		}
 
-			delete packet;
-			this->DecreaseMemorySize(sizeOfPacketToDeallocate);
+		Packet * reused = recycle.GetPacket(100);
+		if(recycled != 4 || recycle.GetStoredAmount() != 3 || recycle.GetMemorySize() != 400 || reused->GetUsedSize() != 0)
+		{
+			cout << "RecyclePacket is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "RecyclePacket is good\n";
+		}
+		recycle.RecyclePacket(reused);
+
+		// Packets much larger than the recycle size are not recycled
+		Packet * large = recycle.GetPacket(1000);
+		if(recycle.RecyclePacket(large) == true || recycle.GetMemorySize() != 400)
+		{
+			cout << "RecyclePacket (large) is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "RecyclePacket (large) is good\n";
+		}
 
-			addedToRecyleBin = false;
+		MemoryRecyclePacket copy(recycle);
+		if(copy.GetStoredAmount() != 4 || copy.GetMaxNumberOfPackets() != 4 || copy.GetPacketMemorySize() != 100 || copy.GetMemorySize() != 400)
+		{
+			cout << "Copy constructor is bad\n";
+			problem = true;
 		}
+		else
+		{
+			cout << "Copy constructor is good\n";
+		}
+	}
+
+	{
+		// Packets too large to be recycled reuse memory through the slab
+		MemoryRecyclePacket recycle(4,100,4);
+		Packet * large = recycle.GetPacket(1000);
+		recycle.RecyclePacket(large);
+		large = recycle.GetPacket(1000);
+		Packet * small = recycle.GetPacket(50);
+
+		if(recycle.GetPacketMemorySize() != 128 || large->GetMemorySize() != 1024 || recycle.GetMemorySize() != 512 + 1024 ||
+		   recycle.GetRecycleHitCount() != 1 || recycle.GetRecycleMissCount() != 2 || recycle.GetSlab()->GetRecycleHitCount() != 1)
+		{
+			cout << "Slab is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Slab is good\n";
+		}
+
+		recycle.RecyclePacket(large);
+		recycle.RecyclePacket(small);
+	}
+
+	{
+		// Packets are not lost and memory usage is correct after many threads have used the object
+		MemoryRecyclePacket recycle(64,1024);
+		MemoryRecyclePacketBenchmark(&recycle,8,100000);
+		if(recycle.GetStoredAmount() > 64 || recycle.GetMemorySize() != recycle.GetStoredAmount() * 1024)
+		{
+			cout << "Concurrent use is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Concurrent use is good\n";
+		}
+	}
+
+	cout << "Benchmarking..\n";
+	for(size_t numThreads = 1;numThreads<=8;numThreads*=2)
+	{
+		MemoryRecyclePacket recycle(64,1024);
+		DWORD recycleTime = MemoryRecyclePacketBenchmark(&recycle,numThreads,1000000);
+		DWORD heapTime = MemoryRecyclePacketBenchmark(NULL,numThreads,1000000);
+
+		cout << " " << numThreads << " threads, 1000000 packets each:\n";
+		cout << "  MemoryRecyclePacket: " << recycleTime << "ms\n";
+		cout << "  new and delete: " << heapTime << "ms\n";
 	}
-	catch(ErrorReport & report){recycleBin.Leave(); throw report;}
-	recycleBin.Leave();	
 
-	return addedToRecyleBin;
+	cout << "\n\n";
+	return !problem;
 }
@@ -1,6 +1,6 @@
 #pragma once
-#include "StoreVector.h"
 #include "Packet.h"
+#include "MemoryRecycleSlab.h"
 
 /**
  * @brief	A method of recycling the memory used by packets.
@@ -20,6 +20,10 @@
  * via UDP and TCP. The exception to this is UDP sending, which is not unique to clients (all clients 
  * share the same memory counter).\n\n
  *
+ * Packets that are ready to be recycled are stored in a lock free list, and in a small cache for
+ * each thread, so that threads retrieving and recycling packets at the same time do not wait for each other.
+ * Packets are always returned to the object that they were retrieved from. This class is thread safe.\n\n
+ *
  * To ensure efficient recycling and to restrict memory usage accurately, this class
  * should be a single point of memory allocation and deallocation for all packets used
  * for the purpose which the memory recycling and restrictions apply.
@@ -29,10 +33,77 @@
  */
 class MemoryRecyclePacket : public MemoryUsageLog
 {
+public:
+	/**
+	 * @brief Packets whose memory size is more than this multiple of GetPacketMemorySize are not recycled,
+	 * so that one unusually large packet does not hold on to memory indefinitely.
+	 */
+	static const size_t MAXIMUM_GROWTH = 4;
+
+	/** @brief Number of thread caches, threads are assigned a cache in turn when they first use any MemoryRecyclePacket object. */
+	static const size_t THREAD_CACHE_AMOUNT = 8;
+
+	/** @brief Maximum number of packets stored in each thread cache. */
+	static const size_t THREAD_CACHE_SIZE = 8;
+
+private:
+	/**
+	 * @brief Entry of MemoryRecyclePacket::recycleBin.
+	 */
+	struct RecycleNode
+	{
+		/** @brief Links node into a lock free list, must be the first member. */
+		SLIST_ENTRY entry;
+
+		/** @brief Packet stored by this node, NULL if node is in MemoryRecyclePacket::unusedNodes. */
+		Packet * packet;
+	};
+
+	/**
+	 * @brief Small store of packets which avoids MemoryRecyclePacket::recycleBin.
+	 *
+	 * Only one thread can use a cache at a time. A thread that finds its cache in use
+	 * does not wait, it uses MemoryRecyclePacket::recycleBin instead.
+	 */
+	struct ThreadCache
+	{
+		/** @brief 1 while a thread is using the cache, 0 otherwise. */
+		volatile LONG inUse;
+
+		/** @brief Number of packets in ThreadCache::packets. */
+		size_t amount;
+
+		/** @brief Stored packets. */
+		Packet * packets[THREAD_CACHE_SIZE];
+	};
+
+	/**
+	 * @brief Caches of packets that are ready to be 'recycled', used before MemoryRecyclePacket::recycleBin.
+	 */
+	ThreadCache threadCache[THREAD_CACHE_AMOUNT];
+
+	/**
+	 * @brief Lock free list of RecycleNode objects containing packets which are ready to be 'recycled'.
+	 */
+	PSLIST_HEADER recycleBin;
+
 	/**
-	 * @brief Contains all packets which are currently ready to be 'recycled'.
+	 * @brief Lock free list of RecycleNode objects that are not in MemoryRecyclePacket::recycleBin.
 	 */
-	StoreVector<Packet> recycleBin;
+	PSLIST_HEADER unusedNodes;
+
+	/**
+	 * @brief All RecycleNode objects, there is one for each packet that can be stored.
+	 */
+	RecycleNode * nodes;
+
+	/**
+	 * @brief Number of packets stored in thread caches and MemoryRecyclePacket::recycleBin.
+	 *
+	 * Never exceeds MemoryRecyclePacket::numberOfPackets, so a node is always available in
+	 * MemoryRecyclePacket::unusedNodes when a packet is stored.
+	 */
+	volatile LONG storedAmount;
 
 	/**
 	 * @brief Maximum number of packets that can be stored in recycle bin.
@@ -44,10 +115,31 @@ class MemoryRecyclePacket : public MemoryUsageLog
 	 */
 	size_t packetSize;
 
+	/**
+	 * @brief Slab which packets retrieved from this object allocate their memory from, NULL if there is none.
+	 *
+	 * This object and each packet retrieved from it hold a reference to the slab.
+	 */
+	MemoryRecycleSlab * slab;
+
+	void Initialize(size_t numberOfPackets, size_t packetSize, size_t initialPackets, size_t slabBlocksPerClass);
+	void Cleanup();
 	void Copy(const MemoryRecyclePacket & copyMe);
+
+	/** @brief Thread local storage index storing the calling thread's cache index plus 1, 0 if it has not been assigned one yet. */
+	static const DWORD threadCacheStorageIndex;
+
+	/** @brief Number of thread caches assigned, used to assign the next thread a cache. */
+	static volatile LONG threadCacheAssigned;
+
+	static size_t GetThreadCacheIndex();
+	ThreadCache * EnterThreadCache();
+	static void LeaveThreadCache(ThreadCache * cache);
+	Packet * Take();
+	bool Store(Packet * packet);
 public:
 	MemoryRecyclePacket();
-	MemoryRecyclePacket(size_t numberOfPackets, size_t packetSize);
+	MemoryRecyclePacket(size_t numberOfPackets, size_t packetSize, size_t slabBlocksPerClass = 0);
 	MemoryRecyclePacket(const MemoryRecyclePacket & copyMe);
 	MemoryRecyclePacket & operator=(const MemoryRecyclePacket & copyMe);
 	virtual ~MemoryRecyclePacket(void);
@@ -58,5 +150,9 @@ public:
 
 	size_t GetPacketMemorySize() const;
 	size_t GetMaxNumberOfPackets() const;
-};
+	size_t GetStoredAmount() const;
+	size_t GetSlabBlocksPerClass() const;
+	const MemoryRecycleSlab * GetSlab() const;
 
+	static bool TestClass();
+};
\ No newline at end of file
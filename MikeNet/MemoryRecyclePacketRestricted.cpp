@@ -17,9 +17,11 @@ MemoryRecyclePacketRestricted::MemoryRecyclePacketRestricted(void)
  * @param	memorySizeOfPackets		The size of packets stored in the recycle bin. No packet less than or greater
  * than this value will ever be stored in the recycle bin.
  * @param	memoryLimit	Maximum amount of memory which this object can allocate at any one time.
+ * @param	slabBlocksPerClass	If more than 0, packet memory is allocated from a MemoryRecycleSlab which stores up to
+ * this many blocks of each size class. See MemoryRecyclePacket::MemoryRecyclePacket() for more information.
  */
-MemoryRecyclePacketRestricted::MemoryRecyclePacketRestricted( size_t numberOfPackets, size_t memorySizeOfPackets, size_t memoryLimit ) :
-	MemoryRecyclePacket(numberOfPackets,memorySizeOfPackets),
+MemoryRecyclePacketRestricted::MemoryRecyclePacketRestricted( size_t numberOfPackets, size_t memorySizeOfPackets, size_t memoryLimit, size_t slabBlocksPerClass ) :
+	MemoryRecyclePacket(numberOfPackets,memorySizeOfPackets,slabBlocksPerClass),
 	MemoryUsageRestricted(memoryLimit)
 {
 
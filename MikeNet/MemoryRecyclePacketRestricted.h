@@ -1,5 +1,5 @@
 #pragma once
-#include "memoryrecyclepacket.h"
+#include "MemoryRecyclePacket.h"
 
 /**
  * @brief	A method of recycling and restricting the memory used by packets.
@@ -16,7 +16,7 @@ class MemoryRecyclePacketRestricted :
 {
 public:
 	MemoryRecyclePacketRestricted();
-	MemoryRecyclePacketRestricted(size_t numberOfPackets, size_t memorySizeOfPackets, size_t memoryLimit = 0);
+	MemoryRecyclePacketRestricted(size_t numberOfPackets, size_t memorySizeOfPackets, size_t memoryLimit = 0, size_t slabBlocksPerClass = 0);
 	MemoryRecyclePacketRestricted(const MemoryRecyclePacketRestricted & copyMe);
 	MemoryRecyclePacketRestricted & operator=(const MemoryRecyclePacketRestricted & copyMe);
 	
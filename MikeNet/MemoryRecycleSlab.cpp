@@ -0,0 +1,372 @@
+#include "FullInclude.h"
+#include "MemoryRecycleSlab.h"
+
+/**
+ * @brief	Constructor.
+ *
+ * The caller holds the first reference and must use Release() when it no longer needs the object.
+ *
+ * @param	maximumBlocks	Maximum number of blocks stored in each size class.
+ */
+MemoryRecycleSlab::MemoryRecycleSlab(size_t maximumBlocks)
+{
+	this->maximumBlocks = maximumBlocks;
+	this->references = 1;
+
+	for(size_t n = 0;n<CLASS_AMOUNT;n++)
+	{
+		SizeClass & sizeClass = classes[n];
+		sizeClass.amount = 0;
+		sizeClass.nodes = NULL;
+
+		sizeClass.blocks = static_cast<PSLIST_HEADER>(_aligned_malloc(sizeof(SLIST_HEADER),MEMORY_ALLOCATION_ALIGNMENT));
+		Utility::DynamicAllocCheck(sizeClass.blocks,__LINE__,__FILE__);
+		InitializeSListHead(sizeClass.blocks);
+
+		sizeClass.unusedNodes = static_cast<PSLIST_HEADER>(_aligned_malloc(sizeof(SLIST_HEADER),MEMORY_ALLOCATION_ALIGNMENT));
+		Utility::DynamicAllocCheck(sizeClass.unusedNodes,__LINE__,__FILE__);
+		InitializeSListHead(sizeClass.unusedNodes);
+
+		if(maximumBlocks > 0)
+		{
+			sizeClass.nodes = static_cast<BlockNode*>(_aligned_malloc(sizeof(BlockNode) * maximumBlocks,MEMORY_ALLOCATION_ALIGNMENT));
+			Utility::DynamicAllocCheck(sizeClass.nodes,__LINE__,__FILE__);
+
+			for(size_t i = 0;i<maximumBlocks;i++)
+			{
+				sizeClass.nodes[i].block = NULL;
+				InterlockedPushEntrySList(sizeClass.unusedNodes,&sizeClass.nodes[i].entry);
+			}
+		}
+	}
+}
+
+/**
+ * @brief	Destructor, only used by Release().
+ */
+MemoryRecycleSlab::~MemoryRecycleSlab()
+{
+	const char * cCommand = "an internal function (~MemoryRecycleSlab)";
+	try
+	{
+		for(size_t n = 0;n<CLASS_AMOUNT;n++)
+		{
+			BlockNode * node;
+			while((node = reinterpret_cast<BlockNode*>(InterlockedPopEntrySList(classes[n].blocks))) != NULL)
+			{
+				delete[] node->block;
+			}
+			_aligned_free(classes[n].nodes);
+			_aligned_free(classes[n].blocks);
+			_aligned_free(classes[n].unusedNodes);
+		}
+	}
+	MSG_CATCH
+}
+
+/**
+ * @brief	Adds a reference to this object, the object will not be deleted until
+ * Release() has been used for this reference.
+ */
+void MemoryRecycleSlab::AddReference()
+{
+	InterlockedIncrement(&references);
+}
+
+/**
+ * @brief	Releases a reference to this object, deleting it if this was the last reference.
+ *
+ * The object must not be used by the caller after this method returns.
+ */
+void MemoryRecycleSlab::Release()
+{
+	if(InterlockedDecrement(&references) == 0)
+	{
+		delete this;
+	}
+}
+
+/**
+ * @brief	Retrieves the number of references to this object.
+ *
+ * @return	the number of references.
+ */
+size_t MemoryRecycleSlab::GetReferenceCount() const
+{
+	return static_cast<size_t>(references);
+}
+
+/**
+ * @brief	Retrieves the maximum number of blocks stored in each size class.
+ *
+ * @return	the maximum number of blocks.
+ */
+size_t MemoryRecycleSlab::GetMaximumBlocks() const
+{
+	return maximumBlocks;
+}
+
+/**
+ * @brief	Determines which size class a block of the specified size belongs to.
+ *
+ * @param	size	Size of block in bytes.
+ *
+ * @return	index of the smallest size class that can hold @a size bytes.
+ * @return	MemoryRecycleSlab::CLASS_AMOUNT if @a size is larger than the largest size class.
+ */
+size_t MemoryRecycleSlab::GetClassIndex(size_t size)
+{
+	size_t classIndex = 0;
+	size_t classSize = GetClassSize(0);
+
+	while(classSize < size)
+	{
+		classIndex++;
+		if(classIndex == CLASS_AMOUNT)
+		{
+			break;
+		}
+		classSize <<= 1;
+	}
+
+	return classIndex;
+}
+
+/**
+ * @brief	Retrieves the size of blocks in a size class.
+ *
+ * @param	classIndex	Index of size class.
+ *
+ * @return	the size in bytes.
+ */
+size_t MemoryRecycleSlab::GetClassSize(size_t classIndex)
+{
+	return static_cast<size_t>(1) << (classIndex + MINIMUM_CLASS_BITS);
+}
+
+/**
+ * @brief	Retrieves the size of block that Allocate() returns when @a size bytes are requested.
+ *
+ * @param	size	Minimum size of block in bytes.
+ *
+ * @return	@a size rounded up to the size of its size class.
+ * @return	@a size if it is 0 or is larger than the largest size class.
+ */
+size_t MemoryRecycleSlab::GetBlockSize(size_t size)
+{
+	if(size == 0)
+	{
+		return 0;
+	}
+
+	size_t classIndex = GetClassIndex(size);
+	if(classIndex == CLASS_AMOUNT)
+	{
+		return size;
+	}
+	return GetClassSize(classIndex);
+}
+
+/**
+ * @brief	Allocates a block, using a recycled block where possible.
+ *
+ * Does not wait for other threads unless memory is allocated.
+ *
+ * @param [in,out]	size	Minimum size of block in bytes, must be more than 0. Set to the actual size of the block,
+ * which must be passed to Deallocate().
+ *
+ * @return	the block, which can be deallocated using Deallocate() or delete[].
+ */
+char * MemoryRecycleSlab::Allocate(size_t & size)
+{
+	size_t classIndex = GetClassIndex(size);
+
+	if(classIndex < CLASS_AMOUNT)
+	{
+		size = GetClassSize(classIndex);
+
+		SizeClass & sizeClass = classes[classIndex];
+		BlockNode * node = reinterpret_cast<BlockNode*>(InterlockedPopEntrySList(sizeClass.blocks));
+		if(node != NULL)
+		{
+			char * block = node->block;
+			node->block = NULL;
+			InterlockedPushEntrySList(sizeClass.unusedNodes,&node->entry);
+
+			// Only decreased once the node is unused, so that Deallocate() always finds an unused node
+			InterlockedDecrement(&sizeClass.amount);
+			DecreaseMemorySize(size);
+			LogRecycleHit();
+			return block;
+		}
+	}
+
+	LogRecycleMiss();
+
+	char * block = new (nothrow) char[size];
+	Utility::DynamicAllocCheck(block,__LINE__,__FILE__);
+	return block;
+}
+
+/**
+ * @brief	Stores a block so that it can be recycled, or deallocates it if this is not possible.
+ *
+ * Blocks are stored if @a size is exactly the size of a size class and that size class is not full.
+ * The block does not need to have been allocated by this object, but must have been allocated using new[].
+ *
+ * @param [in]	block	Block to deallocate, may be NULL.
+ * @param	size	Size of block in bytes.
+ */
+void MemoryRecycleSlab::Deallocate(char * block, size_t size)
+{
+	if(block == NULL)
+	{
+		return;
+	}
+
+	size_t classIndex = GetClassIndex(size);
+	if(classIndex < CLASS_AMOUNT && GetClassSize(classIndex) == size)
+	{
+		SizeClass & sizeClass = classes[classIndex];
+		if(static_cast<size_t>(InterlockedIncrement(&sizeClass.amount)) <= maximumBlocks)
+		{
+			BlockNode * node = reinterpret_cast<BlockNode*>(InterlockedPopEntrySList(sizeClass.unusedNodes));
+			node->block = block;
+
+			// Logged before the block can be taken, so that Allocate never decreases below 0
+			IncreaseMemorySize(size);
+			InterlockedPushEntrySList(sizeClass.blocks,&node->entry);
+			return;
+		}
+		InterlockedDecrement(&sizeClass.amount);
+	}
+
+	delete[] block;
+}
+
+/**
+ * @brief	Sets the memory size of packets of mixed sizes.
+ *
+ * @param	slab	Slab for packets to use, may be NULL.
+ * @param	numPackets	Number of packets.
+ *
+ * @return	time taken in milliseconds.
+ */
+static DWORD MemoryRecycleSlabBenchmark(MemoryRecycleSlab * slab, size_t numPackets)
+{
+	const size_t sizes[] = {100, 1500, 9000, 70000, 300, 24000, 600000};
+	const size_t numSizes = sizeof(sizes) / sizeof(sizes[0]);
+
+	DWORD startTime = GetTickCount();
+	for(size_t n = 0;n<numPackets;n++)
+	{
+		Packet packet;
+		if(slab != NULL)
+		{
+			packet.SetSlab(slab);
+		}
+		packet.SetMemorySize(sizes[n % numSizes]);
+		packet.Add<size_t>(n);
+	}
+	return GetTickCount() - startTime;
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool MemoryRecycleSlab::TestClass()
+{
+	cout << "Testing MemoryRecycleSlab class...\n";
+	bool problem = false;
+
+	if(GetClassIndex(1) != 0 || GetClassIndex(64) != 0 || GetClassIndex(65) != 1 ||
+	   GetClassIndex(1024*1024) != CLASS_AMOUNT - 1 || GetClassIndex(1024*1024 + 1) != CLASS_AMOUNT ||
+	   GetClassSize(0) != 64 || GetClassSize(CLASS_AMOUNT - 1) != 1024*1024 ||
+	   GetBlockSize(0) != 0 || GetBlockSize(1500) != 2048 || GetBlockSize(1024*1024 + 1) != 1024*1024 + 1)
+	{
+		cout << "GetClassIndex, GetClassSize or GetBlockSize is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "GetClassIndex, GetClassSize and GetBlockSize are good\n";
+	}
+
+	MemoryRecycleSlab * slab = new MemoryRecycleSlab(2);
+
+	size_t size = 100;
+	char * block = slab->Allocate(size);
+	slab->Deallocate(block,size);
+	size_t reusedSize = 120;
+	char * reused = slab->Allocate(reusedSize);
+	if(size != 128 || reusedSize != 128 || reused != block || slab->GetMemorySize() != 0 ||
+	   slab->GetRecycleHitCount() != 1 || slab->GetRecycleMissCount() != 1 || slab->GetRecycleHitPercentage() != 50.0)
+	{
+		cout << "Allocate or Deallocate is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Allocate and Deallocate are good\n";
+	}
+	slab->Deallocate(reused,reusedSize);
+
+	// Blocks that are not the size of a size class, and blocks beyond the maximum, are deallocated
+	slab->Deallocate(new char[100],100);
+	slab->Deallocate(new char[128],128);
+	slab->Deallocate(new char[128],128);
+	if(slab->GetMemorySize() != 256)
+	{
+		cout << "Deallocate (limit) is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Deallocate (limit) is good\n";
+	}
+
+	{
+		Packet packet;
+		packet.SetSlab(slab);
+		packet.SetMemorySize(1000);
+		packet.AddStringC("hello",0,false);
+		packet.ChangeMemorySize(2000);
+
+		if(packet.GetMemorySize() != 2048 || packet != "hello" || slab->GetReferenceCount() != 2 || slab->GetMemorySize() != 256 + 1024)
+		{
+			cout << "Packet integration is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Packet integration is good\n";
+		}
+	}
+
+	if(slab->GetReferenceCount() != 1 || slab->GetMemorySize() != 256 + 1024 + 2048)
+	{
+		cout << "Packet destructor is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Packet destructor is good\n";
+	}
+	slab->Release();
+
+	cout << "Benchmarking..\n";
+	slab = new MemoryRecycleSlab(16);
+	DWORD slabTime = MemoryRecycleSlabBenchmark(slab,1000000);
+	DWORD heapTime = MemoryRecycleSlabBenchmark(NULL,1000000);
+	cout << " 1000000 packets of mixed sizes:\n";
+	cout << "  MemoryRecycleSlab: " << slabTime << "ms, " << slab->GetRecycleHitPercentage() << "% hits\n";
+	cout << "  new and delete: " << heapTime << "ms\n";
+	slab->Release();
+
+	cout << "\n\n";
+	return !problem;
+}
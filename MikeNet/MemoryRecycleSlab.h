@@ -0,0 +1,99 @@
+#pragma once
+
+/**
+ * @brief	Recycles the memory blocks used by packet data, with a separate lock free list for each size class.
+ *
+ * Sizes from 64 bytes to 1 megabyte are rounded up to the next power of two, and each
+ * power of two is a size class. When a packet deallocates its data the block is stored in the list of
+ * its size class, and the next packet that needs a block of that class takes it instead of using the heap.
+ * This means that traffic of mixed sizes is recycled, unlike MemoryRecyclePacket which only recycles
+ * packets of one size. Sizes larger than 1 megabyte are always allocated from the heap.\n\n
+ *
+ * Every block is allocated using new[] so that a block which leaves the slab (e.g. using Packet::MoveIntoWSABUF()
+ * or Packet::Swap()) can still be deallocated using delete[], and any block of a class size can be stored.\n\n
+ *
+ * The logged memory size is the amount of memory stored ready to be recycled, and hits and misses are logged
+ * using MemoryUsageLog::LogRecycleHit() and MemoryUsageLog::LogRecycleMiss().\n\n
+ *
+ * The object is reference counted so that it is not deallocated while packets that use it exist (see Packet::SetSlab()).
+ * This class is thread safe.
+ */
+class MemoryRecycleSlab : public MemoryUsageLog
+{
+public:
+	/** @brief Smallest size class is 2 to the power of this, 64 bytes. */
+	static const size_t MINIMUM_CLASS_BITS = 6;
+
+	/** @brief Largest size class is 2 to the power of this, 1 megabyte. */
+	static const size_t MAXIMUM_CLASS_BITS = 20;
+
+	/** @brief Number of size classes. */
+	static const size_t CLASS_AMOUNT = MAXIMUM_CLASS_BITS - MINIMUM_CLASS_BITS + 1;
+
+private:
+	/**
+	 * @brief Entry of SizeClass::blocks.
+	 *
+	 * Blocks are not linked into the lists themselves, because a block can be deallocated
+	 * while another thread popping the list still reads its link.
+	 */
+	struct BlockNode
+	{
+		/** @brief Links node into a lock free list, must be the first member. */
+		SLIST_ENTRY entry;
+
+		/** @brief Block stored by this node, NULL if node is in SizeClass::unusedNodes. */
+		char * block;
+	};
+
+	/** @brief Blocks of one size class that are ready to be recycled. */
+	struct SizeClass
+	{
+		/** @brief Lock free list of BlockNode objects containing blocks which are ready to be recycled. */
+		PSLIST_HEADER blocks;
+
+		/** @brief Lock free list of BlockNode objects that are not in SizeClass::blocks. */
+		PSLIST_HEADER unusedNodes;
+
+		/** @brief All BlockNode objects of this size class, there is one for each block that can be stored. */
+		BlockNode * nodes;
+
+		/**
+		 * @brief Number of blocks in SizeClass::blocks.
+		 *
+		 * Never exceeds MemoryRecycleSlab::maximumBlocks, so a node is always available in
+		 * SizeClass::unusedNodes when a block is stored.
+		 */
+		volatile LONG amount;
+	};
+
+	/** @brief Size classes, index 0 is the smallest. */
+	SizeClass classes[CLASS_AMOUNT];
+
+	/** @brief Maximum number of blocks stored in each size class, extra blocks are deallocated. */
+	size_t maximumBlocks;
+
+	/** @brief Number of references to this object, it is deallocated when this reaches 0. */
+	volatile LONG references;
+
+	~MemoryRecycleSlab();
+
+	MemoryRecycleSlab(const MemoryRecycleSlab &);
+	MemoryRecycleSlab & operator= (const MemoryRecycleSlab &);
+public:
+	MemoryRecycleSlab(size_t maximumBlocks);
+
+	void AddReference();
+	void Release();
+	size_t GetReferenceCount() const;
+
+	char * Allocate(size_t & size);
+	void Deallocate(char * block, size_t size);
+
+	size_t GetMaximumBlocks() const;
+	static size_t GetClassIndex(size_t size);
+	static size_t GetClassSize(size_t classIndex);
+	static size_t GetBlockSize(size_t size);
+
+	static bool TestClass();
+};
@@ -7,6 +7,8 @@
 MemoryUsageLog::MemoryUsageLog(void)
 {
 	this->memoryUsage = 0;
+	this->recycleHits = 0;
+	this->recycleMisses = 0;
 }
 
 /**
@@ -17,6 +19,8 @@ MemoryUsageLog::MemoryUsageLog(void)
 MemoryUsageLog::MemoryUsageLog( const MemoryUsageLog & copyMe )
 {
 	this->memoryUsage = copyMe.memoryUsage;
+	this->recycleHits = copyMe.recycleHits;
+	this->recycleMisses = copyMe.recycleMisses;
 }
 
 /**
@@ -29,6 +33,8 @@ MemoryUsageLog::MemoryUsageLog( const MemoryUsageLog & copyMe )
 MemoryUsageLog & MemoryUsageLog::operator=( const MemoryUsageLog & copyMe )
 {
 	this->memoryUsage = copyMe.memoryUsage;
+	this->recycleHits = copyMe.recycleHits;
+	this->recycleMisses = copyMe.recycleMisses;
 	return *this;
 }
 
@@ -149,3 +155,60 @@ size_t MemoryUsageLog::GetNewMemorySizeAfterDecrease( size_t amount ) const
 
 	return returnMe;
 }
+
+/**
+ * @brief	Logs that a request for memory was satisfied with recycled memory.
+ *
+ * Does not use the critical section, so can be used by lock free code.
+ */
+void MemoryUsageLog::LogRecycleHit()
+{
+	InterlockedIncrement64(&recycleHits);
+}
+
+/**
+ * @brief	Logs that a request for memory was satisfied by allocating fresh memory.
+ *
+ * Does not use the critical section, so can be used by lock free code.
+ */
+void MemoryUsageLog::LogRecycleMiss()
+{
+	InterlockedIncrement64(&recycleMisses);
+}
+
+/**
+ * @brief	Retrieves the number of requests for memory satisfied with recycled memory.
+ *
+ * @return	the number of hits logged by LogRecycleHit().
+ */
+unsigned long long int MemoryUsageLog::GetRecycleHitCount() const
+{
+	return static_cast<unsigned long long int>(recycleHits);
+}
+
+/**
+ * @brief	Retrieves the number of requests for memory satisfied by allocating fresh memory.
+ *
+ * @return	the number of misses logged by LogRecycleMiss().
+ */
+unsigned long long int MemoryUsageLog::GetRecycleMissCount() const
+{
+	return static_cast<unsigned long long int>(recycleMisses);
+}
+
+/**
+ * @brief	Retrieves the percentage of requests for memory that were satisfied with recycled memory.
+ *
+ * @return	a value between 0 and 100, 0 if no requests have been logged.
+ */
+double MemoryUsageLog::GetRecycleHitPercentage() const
+{
+	unsigned long long int hits = GetRecycleHitCount();
+	unsigned long long int total = hits + GetRecycleMissCount();
+
+	if(total == 0)
+	{
+		return 0.0;
+	}
+	return (static_cast<double>(hits) / static_cast<double>(total)) * 100.0;
+}
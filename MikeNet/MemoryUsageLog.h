@@ -1,15 +1,24 @@
 #pragma once
-#include "memoryusage.h"
+#include "MemoryUsage.h"
 #include "CriticalSection.h"
 
 /**
  * @brief Keeps a running total of memory usage.
+ *
+ * Objects that recycle memory also log how often a request for memory was satisfied
+ * with recycled memory (a hit) and how often fresh memory was allocated (a miss).
  */
 class MemoryUsageLog :
 	public virtual MemoryUsage, public virtual CriticalSection
 {
 	size_t memoryUsage;
 
+	/** @brief Number of requests for memory satisfied with recycled memory, changed without using the critical section. */
+	volatile LONGLONG recycleHits;
+
+	/** @brief Number of requests for memory satisfied with fresh memory, changed without using the critical section. */
+	volatile LONGLONG recycleMisses;
+
 public:
 	MemoryUsageLog(void);
 	MemoryUsageLog(const MemoryUsageLog & copyMe);
@@ -25,5 +34,11 @@ public:
 	virtual void SetMemorySize(size_t size);
 
 	virtual size_t GetMemorySize() const;
+
+	void LogRecycleHit();
+	void LogRecycleMiss();
+	unsigned long long int GetRecycleHitCount() const;
+	unsigned long long int GetRecycleMissCount() const;
+	double GetRecycleHitPercentage() const;
 };
 
@@ -1,5 +1,5 @@
 #pragma once
-#include "memoryusage.h"
+#include "MemoryUsage.h"
 #include "CriticalSection.h"
 
 /**
@@ -91,7 +91,7 @@ bool NetAddress::operator==(const NetAddress & testMe) const
 	this->Enter();
 	testMe.Enter();
 
-	bool returnMe = ( this->addr.sin_addr.S_un.S_addr == testMe.addr.sin_addr.S_un.S_addr &&
+	bool returnMe = ( this->addr.sin_addr.s_addr == testMe.addr.sin_addr.s_addr &&
 					  this->addr.sin_family == testMe.addr.sin_family &&
 					  this->addr.sin_port == testMe.addr.sin_port );
 
@@ -150,7 +150,7 @@ void NetAddress::Clear()
 
 	SecureZeroMemory(&addr,sizeof(addr));
 	addr.sin_family = AF_INET;
-	addr.sin_addr.S_un.S_addr = INADDR_ANY;
+	addr.sin_addr.s_addr = INADDR_ANY;
 
 	this->Leave();
 }
@@ -286,13 +286,13 @@ void NetAddress::SetIP(const char * IP)
 		if(IP == NULL || strlen(IP) == 0)
 		{
 			// winsock will automatically assign an IP.
-			addr.sin_addr.S_un.S_addr = INADDR_ANY;
+			addr.sin_addr.s_addr = INADDR_ANY;
 		}
 		else
 		{
-			addr.sin_addr.S_un.S_addr = inet_addr(IP);
+			addr.sin_addr.s_addr = inet_addr(IP);
 			// Don't check for errors because error is also signaled when an address of 255.255.255.255 is passed.
-			//_ErrorException((addr.sin_addr.S_un.S_addr == INADDR_NONE),"converting an IP address",WSAGetLastError(),__LINE__,__FILE__);
+			//_ErrorException((addr.sin_addr.s_addr == INADDR_NONE),"converting an IP address",WSAGetLastError(),__LINE__,__FILE__);
 		}
 	}
 	catch (ErrorReport & error){Leave(); throw(error);}
@@ -320,7 +320,7 @@ void NetAddress::SetFamily(ADDRESS_FAMILY family)
 unsigned long int NetAddress::GetByteRepresentationIP() const
 {
 	Enter();
-		unsigned long returnMe = addr.sin_addr.S_un.S_addr;
+		unsigned long returnMe = addr.sin_addr.s_addr;
 	Leave();
 	return returnMe;
 }
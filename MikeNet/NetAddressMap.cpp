@@ -0,0 +1,413 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Constructor.
+ *
+ * @param capacity Maximum number of addresses that can be stored.
+ */
+NetAddressMap::NetAddressMap(size_t capacity) : CriticalSection()
+{
+	sequence = 0;
+	amount = 0;
+	Resize(capacity);
+}
+
+/**
+ * @brief Destructor.
+ */
+NetAddressMap::~NetAddressMap()
+{
+
+}
+
+/**
+ * @brief Determines the slot that an address should be stored in, if that slot is free.
+ *
+ * @param ip IP address in network byte order.
+ * @param port Port in host byte order.
+ *
+ * @return element of NetAddressMap::table.
+ */
+size_t NetAddressMap::GetSlot(unsigned long ip, unsigned short port) const
+{
+	size_t key = (static_cast<size_t>(ip) * 2654435761UL) ^ (static_cast<size_t>(port) * 40503UL);
+	key ^= key >> 15;
+
+	return key & mask;
+}
+
+/**
+ * @brief Searches for an address, must only be used while the critical section is held.
+ *
+ * @param ip IP address in network byte order.
+ * @param port Port in host byte order.
+ * @param [out] slot Filled with slot containing the address if it was found, otherwise the
+ * slot that it should be stored in.
+ *
+ * @return true if the address was found.
+ */
+bool NetAddressMap::FindSlot(unsigned long ip, unsigned short port, size_t & slot) const
+{
+	slot = GetSlot(ip,port);
+
+	while(table[slot].used == true)
+	{
+		if(table[slot].ip == ip && table[slot].port == port)
+		{
+			return true;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Indicates to Find() that a change is starting, the critical section must be held.
+ */
+void NetAddressMap::BeginChange()
+{
+	InterlockedIncrement(&sequence);
+}
+
+/**
+ * @brief Indicates to Find() that a change has finished, the critical section must be held.
+ */
+void NetAddressMap::EndChange()
+{
+	InterlockedIncrement(&sequence);
+}
+
+/**
+ * @brief Removes all addresses and changes the capacity.
+ *
+ * @warning Other threads must not use this object at the same time, because
+ * the memory used by Find() is reallocated.
+ *
+ * @param capacity Maximum number of addresses that can be stored.
+ */
+void NetAddressMap::Resize(size_t capacity)
+{
+	// Keep table at most half full so that probe sequences are short
+	size_t tableSize = 2;
+	while(tableSize < capacity * 2)
+	{
+		tableSize *= 2;
+	}
+
+	Entry empty;
+	empty.ip = 0;
+	empty.port = 0;
+	empty.used = false;
+	empty.value = 0;
+
+	Enter();
+	BeginChange();
+	table.assign(tableSize,empty);
+	mask = tableSize - 1;
+	this->capacity = capacity;
+	amount = 0;
+	EndChange();
+	Leave();
+}
+
+/**
+ * @brief Associates an address with a value.
+ *
+ * If the address is already stored then its value is replaced.
+ *
+ * @param address Address.
+ * @param value Value to associate with @a address.
+ *
+ * @throws ErrorReport If the map is full.
+ */
+void NetAddressMap::Add(const NetAddress & address, size_t value)
+{
+	unsigned long ip = address.GetByteRepresentationIP();
+	unsigned short port = address.GetPort();
+
+	Enter();
+	try
+	{
+		size_t slot;
+		bool found = FindSlot(ip,port,slot);
+
+		_ErrorException((found == false && amount >= capacity),"adding an address to an address map, the map is full",0,__LINE__,__FILE__);
+
+		BeginChange();
+		table[slot].ip = ip;
+		table[slot].port = port;
+		table[slot].value = value;
+		table[slot].used = true;
+		EndChange();
+
+		if(found == false)
+		{
+			amount++;
+		}
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){Leave(); throw(error);}
+	catch(...){Leave(); throw(-1);}
+	Leave();
+}
+
+/**
+ * @brief Removes an address if it is associated with the specified value.
+ *
+ * @param address Address to remove.
+ * @param value Address is only removed if it is associated with this value. This prevents
+ * an address that has since been associated with a different value from being removed.
+ *
+ * @return true if the address was removed.
+ */
+bool NetAddressMap::Remove(const NetAddress & address, size_t value)
+{
+	unsigned long ip = address.GetByteRepresentationIP();
+	unsigned short port = address.GetPort();
+	bool removed = false;
+
+	Enter();
+
+	size_t hole;
+	if(FindSlot(ip,port,hole) == true && table[hole].value == value)
+	{
+		BeginChange();
+
+		// Move later entries of the probe sequence back, so that no
+		// markers for removed entries are needed.
+		size_t next = (hole + 1) & mask;
+		while(table[next].used == true)
+		{
+			size_t home = GetSlot(table[next].ip,table[next].port);
+
+			// Entry can move if hole is between its home slot and its current slot
+			if(((next - home) & mask) >= ((next - hole) & mask))
+			{
+				table[hole] = table[next];
+				hole = next;
+			}
+
+			next = (next + 1) & mask;
+		}
+		table[hole].used = false;
+
+		EndChange();
+
+		amount--;
+		removed = true;
+	}
+
+	Leave();
+
+	return removed;
+}
+
+/**
+ * @brief Searches for an address, without entering the critical section.
+ *
+ * @param address Address to search for.
+ * @param [out] value Filled with the value associated with @a address, unchanged if @a address was not found.
+ *
+ * @return true if @a address was found.
+ */
+bool NetAddressMap::Find(const NetAddress & address, size_t & value) const
+{
+	unsigned long ip = address.GetByteRepresentationIP();
+	unsigned short port = address.GetPort();
+
+	while(true)
+	{
+		LONG before = sequence;
+		MemoryBarrier();
+
+		// Retry if a change is in progress
+		if((before & 1) != 0)
+		{
+			continue;
+		}
+
+		bool found = false;
+		size_t foundValue = 0;
+		size_t slot = GetSlot(ip,port);
+
+		// Limit on probes is only reached if a change happens while searching,
+		// in which case the result is discarded.
+		for(size_t n = 0;n<=mask;n++)
+		{
+			const Entry & entry = table[slot];
+			if(entry.used == false)
+			{
+				break;
+			}
+
+			if(entry.ip == ip && entry.port == port)
+			{
+				found = true;
+				foundValue = entry.value;
+				break;
+			}
+
+			slot = (slot + 1) & mask;
+		}
+
+		MemoryBarrier();
+		if(sequence == before)
+		{
+			if(found == true)
+			{
+				value = foundValue;
+			}
+
+			return found;
+		}
+	}
+}
+
+/**
+ * @brief Retrieves the number of addresses stored.
+ *
+ * @return number of addresses.
+ */
+size_t NetAddressMap::Size() const
+{
+	Enter();
+	size_t returnMe = amount;
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Retrieves the maximum number of addresses that can be stored.
+ *
+ * @return capacity.
+ */
+size_t NetAddressMap::GetCapacity() const
+{
+	Enter();
+	size_t returnMe = capacity;
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool NetAddressMap::TestClass()
+{
+	cout << "Testing NetAddressMap class...\n";
+	bool problem = false;
+
+	NetAddressMap map(4);
+	NetAddress address1("127.0.0.1",6000);
+	NetAddress address2("127.0.0.1",6001);
+	NetAddress address3("192.168.0.1",6000);
+	size_t value = 0;
+
+	map.Add(address1,1);
+	map.Add(address2,2);
+	if(map.Size() != 2 || map.Find(address1,value) == false || value != 1 ||
+	   map.Find(address2,value) == false || value != 2 || map.Find(address3,value) == true)
+	{
+		cout << "Add or Find is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Add and Find are good\n";
+	}
+
+	// Replace value
+	map.Add(address1,3);
+	if(map.Size() != 2 || map.Find(address1,value) == false || value != 3)
+	{
+		cout << "Add is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Add is good\n";
+	}
+
+	// Address is only removed if it has the specified value
+	if(map.Remove(address1,1) == true || map.Remove(address1,3) == false || map.Find(address1,value) == true || map.Size() != 1)
+	{
+		cout << "Remove is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Remove is good\n";
+	}
+
+	// Map is full
+	map.Add(address1,1);
+	map.Add(address3,3);
+	map.Add(NetAddress("10.0.0.1",1),4);
+	try
+	{
+		map.Add(NetAddress("10.0.0.2",1),5);
+		cout << "Capacity is bad\n";
+		problem = true;
+	}
+	catch(ErrorReport & error)
+	{
+		cout << "Capacity is good\n";
+	}
+
+	// Many clients joining and leaving, compared with a record of which clients are connected
+	{
+		const size_t clients = 1000;
+		NetAddressMap churn(clients);
+		vector<size_t> connected(clients,0);
+		bool churnProblem = false;
+
+		for(size_t n = 0;n<clients * 20;n++)
+		{
+			size_t clientID = (n * 7919) % clients;
+			NetAddress address("10.0.0.1",static_cast<unsigned short>(1000 + (clientID * 31) % clients));
+
+			if(connected[clientID] == 0)
+			{
+				churn.Add(address,clientID + 1);
+				connected[clientID] = clientID + 1;
+			}
+			else if(n % 3 == 0)
+			{
+				churn.Remove(address,clientID + 1);
+				connected[clientID] = 0;
+			}
+
+			// Check a client from elsewhere in the table
+			size_t checkID = (n * 104729) % clients;
+			NetAddress checkAddress("10.0.0.1",static_cast<unsigned short>(1000 + (checkID * 31) % clients));
+			size_t found = 0;
+			churn.Find(checkAddress,found);
+
+			if(found != connected[checkID])
+			{
+				churnProblem = true;
+			}
+		}
+
+		if(churnProblem == true)
+		{
+			cout << "Churn is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Churn is good\n";
+		}
+	}
+
+	cout << "\n\n";
+	return !problem;
+}
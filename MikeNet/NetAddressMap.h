@@ -0,0 +1,71 @@
+#pragma once
+#include "NetAddress.h"
+
+/**
+ * @brief Hash map from a NetAddress (IP and port) to a value, such as a client ID.
+ *
+ * The map uses open addressing with linear probing, in a table with a fixed capacity that is
+ * allocated by Resize(), so that lookups never touch memory that may be freed.\n\n
+ *
+ * Find() is lock free: it does not enter the critical section and does not write shared memory, so
+ * any number of threads can look up addresses at the same time without contending.
+ * Changes are made while holding the critical section and are rare (e.g. clients joining and leaving);
+ * a sequence number is made odd during a change and even afterwards, and Find() retries if the sequence
+ * number was odd or changed while it was searching.\n\n
+ *
+ * This class is thread safe, except for Resize() which must not be used while other threads may use the object.
+ */
+class NetAddressMap : public CriticalSection
+{
+	/** @brief Slot of the hash table. */
+	struct Entry
+	{
+		/** @brief IP address in network byte order. */
+		unsigned long ip;
+
+		/** @brief Port in host byte order. */
+		unsigned short port;
+
+		/** @brief True if this slot contains an address. */
+		bool used;
+
+		/** @brief Value associated with address. */
+		size_t value;
+	};
+
+	/** @brief Hash table, size is a power of 2 and more than the capacity. */
+	vector<Entry> table;
+
+	/** @brief Number of elements of NetAddressMap::table minus 1, used to wrap slot numbers. */
+	size_t mask;
+
+	/** @brief Maximum number of addresses that can be stored. */
+	size_t capacity;
+
+	/** @brief Number of addresses stored. */
+	size_t amount;
+
+	/** @brief Incremented before and after every change, odd while a change is in progress. */
+	volatile LONG sequence;
+
+	size_t GetSlot(unsigned long ip, unsigned short port) const;
+	bool FindSlot(unsigned long ip, unsigned short port, size_t & slot) const;
+	void BeginChange();
+	void EndChange();
+
+	NetAddressMap(const NetAddressMap &);
+	NetAddressMap & operator= (const NetAddressMap &);
+public:
+	NetAddressMap(size_t capacity = 0);
+	~NetAddressMap();
+
+	void Resize(size_t capacity);
+	void Add(const NetAddress & address, size_t value);
+	bool Remove(const NetAddress & address, size_t value);
+	bool Find(const NetAddress & address, size_t & value) const;
+
+	size_t Size() const;
+	size_t GetCapacity() const;
+
+	static bool TestClass();
+};
@@ -0,0 +1,232 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Constructor.
+ *
+ * @param maxClientID Largest client ID that can be stored (optional, default 0).
+ */
+NetClientQueue::NetClientQueue(size_t maxClientID) : CriticalSection()
+{
+	Resize(maxClientID);
+}
+
+/**
+ * @brief Destructor.
+ */
+NetClientQueue::~NetClientQueue()
+{
+
+}
+
+/**
+ * @brief Empties the queue and changes the largest client ID that can be stored.
+ *
+ * @param maxClientID Largest client ID that can be stored.
+ */
+void NetClientQueue::Resize(size_t maxClientID)
+{
+	Enter();
+	try
+	{
+		data.assign(maxClientID+1,0);
+		queued.assign(maxClientID+1,false);
+		front = 0;
+		amount = 0;
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){Leave(); throw(error);}
+	catch(...){Leave(); throw(-1);}
+	Leave();
+}
+
+/**
+ * @brief Adds a client ID to the back of the queue, if it is not already in the queue.
+ *
+ * @param clientID Client ID to add.
+ *
+ * @return true if @a clientID was added.
+ * @return false if @a clientID was already in the queue.
+ */
+bool NetClientQueue::Add(size_t clientID)
+{
+	bool returnMe = false;
+
+	Enter();
+	try
+	{
+		_ErrorException((clientID >= queued.size()),"adding a client ID to a queue, client ID is out of bounds",0,__LINE__,__FILE__);
+
+		if(queued[clientID] == false)
+		{
+			data[(front + amount) % data.size()] = clientID;
+			queued[clientID] = true;
+			amount++;
+			returnMe = true;
+		}
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){Leave(); throw(error);}
+	catch(...){Leave(); throw(-1);}
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Retrieves and removes the client ID at the front of the queue.
+ *
+ * @param [out] clientID Filled with client ID, unchanged if the queue is empty.
+ *
+ * @return true if a client ID was retrieved, false if the queue is empty.
+ */
+bool NetClientQueue::GetFront(size_t & clientID)
+{
+	bool returnMe = false;
+
+	Enter();
+	if(amount > 0)
+	{
+		clientID = data[front];
+		queued[clientID] = false;
+		front = (front + 1) % data.size();
+		amount--;
+		returnMe = true;
+	}
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Retrieves and removes the client ID at the back of the queue.
+ *
+ * @param [out] clientID Filled with client ID, unchanged if the queue is empty.
+ *
+ * @return true if a client ID was retrieved, false if the queue is empty.
+ */
+bool NetClientQueue::GetBack(size_t & clientID)
+{
+	bool returnMe = false;
+
+	Enter();
+	if(amount > 0)
+	{
+		amount--;
+		clientID = data[(front + amount) % data.size()];
+		queued[clientID] = false;
+		returnMe = true;
+	}
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Determines whether a client ID is in the queue.
+ *
+ * @param clientID Client ID.
+ *
+ * @return true if @a clientID is in the queue.
+ */
+bool NetClientQueue::Contains(size_t clientID) const
+{
+	Enter();
+	bool returnMe = (clientID < queued.size() && queued[clientID] == true);
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Retrieves the number of client IDs in the queue.
+ *
+ * @return number of client IDs.
+ */
+size_t NetClientQueue::Size() const
+{
+	Enter();
+	size_t returnMe = amount;
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool NetClientQueue::TestClass()
+{
+	cout << "Testing NetClientQueue class...\n";
+	bool problem = false;
+
+	NetClientQueue queue(5);
+	size_t clientID = 0;
+
+	// Duplicates are ignored
+	if(queue.Add(3) == false || queue.Add(1) == false || queue.Add(3) == true || queue.Add(5) == false ||
+	   queue.Size() != 3 || queue.Contains(1) == false || queue.Contains(2) == true)
+	{
+		cout << "Add is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Add is good\n";
+	}
+
+	if(queue.GetFront(clientID) == false || clientID != 3 || queue.Contains(3) == true ||
+	   queue.GetBack(clientID) == false || clientID != 5 || queue.Size() != 1)
+	{
+		cout << "GetFront or GetBack is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "GetFront and GetBack are good\n";
+	}
+
+	// Wrap around end of circular buffer
+	queue.Add(0);
+	queue.Add(2);
+	queue.Add(3);
+	queue.Add(4);
+	queue.Add(5);
+
+	size_t expected[] = {1,0,2,3,4,5};
+	bool wrapProblem = (queue.Size() != 6);
+	for(size_t n = 0;n<6;n++)
+	{
+		if(queue.GetFront(clientID) == false || clientID != expected[n])
+		{
+			wrapProblem = true;
+		}
+	}
+
+	if(wrapProblem == true || queue.GetFront(clientID) == true || queue.GetBack(clientID) == true)
+	{
+		cout << "Circular buffer is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Circular buffer is good\n";
+	}
+
+	try
+	{
+		queue.Add(6);
+		cout << "Bounds checking is bad\n";
+		problem = true;
+	}
+	catch(ErrorReport & error)
+	{
+		cout << "Bounds checking is good\n";
+	}
+
+	cout << "\n\n";
+	return !problem;
+}
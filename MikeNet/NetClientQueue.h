@@ -0,0 +1,44 @@
+#pragma once
+
+/**
+ * @brief Queue of client IDs, in which each client ID appears at most once.
+ *
+ * Memory for every client ID is allocated by Resize(), so adding and retrieving client IDs
+ * is O(1) and allocates no memory. Adding a client ID that is already in the queue does nothing,
+ * so a client ID can be added whenever something happens to the client without duplicates building up.\n\n
+ *
+ * Client IDs can be retrieved from the front, so that the queue is first in first out,
+ * or from the back, so that it can be used as a stack.\n\n
+ *
+ * This class is thread safe.
+ */
+class NetClientQueue : public CriticalSection
+{
+	/** @brief Circular buffer of client IDs, with one element for each possible client ID. */
+	vector<size_t> data;
+
+	/** @brief Element @a n is true if client ID @a n is in the queue. */
+	vector<bool> queued;
+
+	/** @brief Element of NetClientQueue::data at the front of the queue. */
+	size_t front;
+
+	/** @brief Number of client IDs in the queue. */
+	size_t amount;
+
+	NetClientQueue(const NetClientQueue &);
+	NetClientQueue & operator= (const NetClientQueue &);
+public:
+	NetClientQueue(size_t maxClientID = 0);
+	~NetClientQueue();
+
+	void Resize(size_t maxClientID);
+	bool Add(size_t clientID);
+	bool GetFront(size_t & clientID);
+	bool GetBack(size_t & clientID);
+	bool Contains(size_t clientID) const;
+
+	size_t Size() const;
+
+	static bool TestClass();
+};
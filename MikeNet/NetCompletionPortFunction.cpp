@@ -81,7 +81,7 @@ DWORD WINAPI NetManageCompletionPort(LPVOID lpParameter)
 
 								// Indicate that we have completely finished receiving and dealing with receive data
 								// Socket will wait until this has happened before cleaning up
-								socket->SetCompletionPortFinishRecvNotification();
+								socket->SetCompletionPortFinishRecvNotification(completionOverlapped);
 
 								// UDP receive operations sometimes fail and are not catastrophic,
 								// so we should always try to start another receive operation
@@ -93,7 +93,17 @@ DWORD WINAPI NetManageCompletionPort(LPVOID lpParameter)
 							}
 							else
 							{
-								instance->DealCompletion(socket,completionBytes,clientID);
+								try
+								{
+									instance->DealCompletion(socket,completionOverlapped,completionBytes,clientID);
+								}
+								// Receive operation must be finished even if an error occurred, so that the socket can close
+								catch(ErrorReport & error){ socket->SetCompletionPortFinishRecvNotification(completionOverlapped); throw error; }
+								catch(...){ socket->SetCompletionPortFinishRecvNotification(completionOverlapped); throw -1; }
+
+								// Indicate that we have completely finished receiving and dealing with receive data
+								// MUST do before starting new receive operation
+								socket->SetCompletionPortFinishRecvNotification(completionOverlapped);
 
 								// Start another receive operation	
 								instance->DoRecv(socket,clientID);
@@ -134,7 +144,7 @@ DWORD WINAPI NetManageCompletionPort(LPVOID lpParameter)
 
 							// Indicate that we have completely finished receiving and dealing with receive data
 							// Socket will wait until this has happened before cleaning up
-							completionKey->GetSocket()->SetCompletionPortFinishRecvNotification();
+							completionKey->GetSocket()->SetCompletionPortFinishRecvNotification(completionOverlapped);
 
 							// UDP receive operations sometimes fail and are not catastrophic,
 							// so we should always try to start another receive operation
@@ -149,11 +159,11 @@ DWORD WINAPI NetManageCompletionPort(LPVOID lpParameter)
 							try
 							{
 								// Deal with received data
-								completionKey->GetSocket()->DealWithData(completionKey->GetSocket()->recvBuffer,completionBytes,completionKey->GetSocket()->GetRecvFunction(),0,0);
+								completionKey->GetSocket()->DealWithCompletion(completionOverlapped,completionBytes,completionKey->GetSocket()->GetRecvFunction(),0,0);
 
 								// Indicate that we have completely finished receiving and dealing with receive data
 								// MUST do before starting new receive operation
-								completionKey->GetSocket()->SetCompletionPortFinishRecvNotification();
+								completionKey->GetSocket()->SetCompletionPortFinishRecvNotification(completionOverlapped);
 
 								// Start another receive operation	
 								bool error = completionKey->GetSocket()->Recv();
@@ -165,8 +175,8 @@ DWORD WINAPI NetManageCompletionPort(LPVOID lpParameter)
 								}
 							}
 							// Request that socket be closed in the event of an error
-							catch(ErrorReport & error){	completionKey->GetSocket()->CompletionPortRequestClose(); }
-							catch(...){ completionKey->GetSocket()->CompletionPortRequestClose(); }
+							catch(ErrorReport & error){	completionKey->GetSocket()->SetCompletionPortFinishRecvNotification(completionOverlapped); completionKey->GetSocket()->CompletionPortRequestClose(); }
+							catch(...){ completionKey->GetSocket()->SetCompletionPortFinishRecvNotification(completionOverlapped); completionKey->GetSocket()->CompletionPortRequestClose(); }
 						}
 					}
 					// isSendOperation = true
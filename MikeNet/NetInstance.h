@@ -63,10 +63,11 @@ public:
 	 * @brief When send and receive operations are completed on this instance, this method is called.
 	 * 
 	 * @param socket [in,out] Socket that operation was started by.
+	 * @param overlapped Overlapped object of the operation.
 	 * @param bytes Number of bytes of data transferred in operation.
 	 * @param clientID ID of client that owns socket.
 	 */
-	virtual void DealCompletion(NetSocket * socket, DWORD bytes, size_t clientID) = 0;
+	virtual void DealCompletion(NetSocket * socket, const WSAOVERLAPPED * overlapped, DWORD bytes, size_t clientID) = 0;
 
 	/**
 	 * @brief Deals with errors.
@@ -193,15 +193,16 @@ NetUtility::SendStatus NetInstanceBroadcast::SendToUDP(const NetAddress & addres
  * @brief When send and receive operations are completed on this instance, this method is called.
  * 
  * @param socket [in,out] Socket that operation was started by.
+ * @param overlapped Overlapped object of the operation.
  * @param bytes Number of bytes of data transferred in operation.
  * @param clientID Ignored (optional, default = 0).
  */
-void NetInstanceBroadcast::DealCompletion(NetSocket * socket, DWORD bytes, size_t clientID)
+void NetInstanceBroadcast::DealCompletion(NetSocket * socket, const WSAOVERLAPPED * overlapped, DWORD bytes, size_t clientID)
 {
 	try
 	{
 		// Deal with received data
-		socket->DealWithData(socket->recvBuffer,bytes,socket->GetRecvFunction(),0,this->GetInstanceID());
+		socket->DealWithCompletion(overlapped,bytes,socket->GetRecvFunction(),0,this->GetInstanceID());
 	}
 	// Disconnect client in the event of an error
 	catch(ErrorReport & error){	ErrorOccurred(0); }
@@ -42,7 +42,7 @@ public:
 	NetUtility::SendStatus SendUDP(const Packet & packet, bool block, size_t clientID=0);
 	NetUtility::SendStatus SendToUDP(const NetAddress & address, const Packet & packet, bool block);
 
-	void DealCompletion(NetSocket * socket, DWORD bytes, size_t clientID=0);
+	void DealCompletion(NetSocket * socket, const WSAOVERLAPPED * overlapped, DWORD bytes, size_t clientID=0);
 
 	virtual void CloseSockets();
 	
@@ -321,12 +321,18 @@ NetUtility::ConnectionStatus NetInstanceClient::ThreadHandshakeRoutine()
 				// Retrieve information about server.
 				NetMode::ProtocolMode mode;
 				size_t numOperations;
+				bool compactHeaders;
+				bool authenticatedEncryption;
 
 				this->maxClients = recvPacket.GetSizeT();
 				if(IsEnabledUDP() == true)
 				{
 					numOperations = recvPacket.GetSizeT();
-					mode = static_cast<NetMode::ProtocolMode>(recvPacket.Get<char>());
+
+					char modeUDP = recvPacket.Get<char>();
+					mode = static_cast<NetMode::ProtocolMode>(modeUDP & ~(NetModeUdp::COMPACT_HEADERS_FLAG | NetModeUdp::AUTHENTICATED_ENCRYPTION_FLAG));
+					compactHeaders = (modeUDP & NetModeUdp::COMPACT_HEADERS_FLAG) != 0;
+					authenticatedEncryption = (modeUDP & NetModeUdp::AUTHENTICATED_ENCRYPTION_FLAG) != 0;
 				}
 				clientID = recvPacket.GetSizeT();
 
@@ -335,6 +341,15 @@ NetUtility::ConnectionStatus NetInstanceClient::ThreadHandshakeRoutine()
 					// Create UDP mode and pass this to socket.
 					// Socket will now be fully operational.
 					NetModeUdp * modeUDP = NetModeUdp::GenerateModeUDP(mode,maxClients.Get(),numOperations,recvSizeUDP,decryptKey,memoryRecycle);
+					modeUDP->SetCompactHeaders(compactHeaders);
+
+					// Fails if the server seals packets but we have no key
+					try
+					{
+						modeUDP->SetAuthenticatedEncryption(authenticatedEncryption);
+					}
+					catch(ErrorReport & error){delete modeUDP; throw(error);}
+					catch(...){delete modeUDP; throw(-1);}
 					socketUDP->LoadMode(modeUDP);
 					
 					// Formulate packet to be sent via UDP so that the server can find our UDP address.
@@ -445,7 +460,7 @@ NetUtility::ConnectionStatus NetInstanceClient::PollConnect()
 	}
 
 	// Take action based upon exit code result.
-	switch(exitCode)
+	switch(static_cast<int>(exitCode))
 	{
 		case(STILL_ACTIVE):
 			returnMe = NetUtility::STILL_CONNECTING;
@@ -854,15 +869,16 @@ void NetInstanceClient::CompletionError(NetSocket * completionSocket, size_t cli
  * @brief When send and receive operations are completed on this instance, this method is called.
  * 
  * @param socket [in,out] Socket that operation was started by.
+ * @param overlapped Overlapped object of the operation.
  * @param bytes Number of bytes of data transferred in operation.
  * @param clientID Ignored (optional, default = 0).
  */
-void NetInstanceClient::DealCompletion(NetSocket * socket, DWORD bytes, size_t clientID)
+void NetInstanceClient::DealCompletion(NetSocket * socket, const WSAOVERLAPPED * overlapped, DWORD bytes, size_t clientID)
 {
 	try
 	{
 		// Deal with received data
-		socket->DealWithData(socket->recvBuffer,bytes,socket->GetRecvFunction(),NULL,this->GetInstanceID());
+		socket->DealWithCompletion(overlapped,bytes,socket->GetRecvFunction(),0,this->GetInstanceID());
 	}
 	// Disconnect client in the event of an error
 	catch(ErrorReport & error){	ErrorOccurred(NULL); }
@@ -105,7 +105,7 @@ public:
 	size_t GetClientID();
 
 
-	void DealCompletion(NetSocket * socket, DWORD bytes, size_t clientID=0);
+	void DealCompletion(NetSocket * socket, const WSAOVERLAPPED * overlapped, DWORD bytes, size_t clientID=0);
 
 	virtual void CloseSockets();
 
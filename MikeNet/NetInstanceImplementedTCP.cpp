@@ -299,6 +299,39 @@ NetUtility::SendStatus NetInstanceImplementedTCP::SendTCP(const Packet & packet,
 	return socketTCP->Send(packet,block,NULL,GetSendTimeout());
 }
 
+/**
+ * @brief Sends a packet asynchronously via TCP, sharing a copy of its data with other send operations.
+ *
+ * @param packet Packet to send.
+ * @param [in] payload Copy of @a packet's data, see NetSendPayload.
+ * @param clientID ID of client to use. Ignored in this implementation but derived class may use ID when overriding (optional, default = 0).
+ *
+ * @return NetUtility::SEND_COMPLETED if the send operation completed successfully instantly.
+ * @return NetUtility::SEND_IN_PROGRESS if the send operation was started, but has not yet completed.
+ * @return NetUtility::SEND_FAILED if the send operation failed.
+ * @return NetUtility::SEND_FAILED_KILL if the send operation failed and an entity was killed as a result (e.g. Client disconnected).
+ */
+NetUtility::SendStatus NetInstanceImplementedTCP::SendSharedTCP(const Packet & packet, NetSendPayload * payload, size_t clientID)
+{
+	return socketTCP->SendShared(packet,payload,GetSendTimeout());
+}
+
+/**
+ * @brief Sends a packet chain asynchronously via TCP, without copying its segments.
+ *
+ * @param chain Packet data to send, see PacketChain.
+ * @param clientID ID of client to use. Ignored in this implementation but derived class may use ID when overriding (optional, default = 0).
+ *
+ * @return NetUtility::SEND_COMPLETED if the send operation completed successfully instantly.
+ * @return NetUtility::SEND_IN_PROGRESS if the send operation was started, but has not yet completed.
+ * @return NetUtility::SEND_FAILED if the send operation failed.
+ * @return NetUtility::SEND_FAILED_KILL if the send operation failed and an entity was killed as a result (e.g. Client disconnected).
+ */
+NetUtility::SendStatus NetInstanceImplementedTCP::SendChainTCP(const PacketChain & chain, size_t clientID)
+{
+	return socketTCP->SendChain(chain,GetSendTimeout());
+}
+
 
 /**
  * @brief Retrieves the state that the TCP connection is in.
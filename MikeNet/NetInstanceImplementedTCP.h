@@ -1,5 +1,5 @@
 #pragma once
-#include "netinstancetcp.h"
+#include "NetInstanceTCP.h"
 
 /**
  * @brief	Implements NetInstanceTCP with a standard setup for using a TCP socket (NetSocketTCP).
@@ -41,7 +41,10 @@ public:
 	virtual void ShutdownTCP(size_t clientID=0);
 
 	virtual size_t GetPacketFromStoreTCP(Packet * destination=0, size_t clientID=0);
+	using NetInstanceTCP::SendTCP;
 	virtual NetUtility::SendStatus SendTCP(const Packet & packet, bool block=0, size_t clientID=0);
+	virtual NetUtility::SendStatus SendSharedTCP(const Packet & packet, NetSendPayload * payload, size_t clientID=0);
+	virtual NetUtility::SendStatus SendChainTCP(const PacketChain & chain, size_t clientID=0);
 
 	virtual NetUtility::ConnectionStatus GetConnectionStateTCP(size_t clientID=0) const;
 
@@ -12,13 +12,14 @@ void NetInstanceProfile::DefaultVariables()
 	localAddrTCP.Clear();
 	localAddrUDP.Clear();
 	enabledUDP = DEFAULT_ENABLED_UDP;
-	decryptKeyUDP = DEFAULT_DECRYPT_KEY_UDP;
+	decryptKeyUDP = reinterpret_cast<const EncryptKey*>(DEFAULT_DECRYPT_KEY_UDP);
 	tcpRecvFunc = DEFAULT_RECV_FUNC;
 	udpRecvFunc = DEFAULT_RECV_FUNC;
 	handshakeEnabled = DEFAULT_HANDSHAKE_ENABLED;
 	modeTCP = DEFAULT_MODE_TCP;
 	modeUDP = DEFAULT_MODE_UDP;
 	autoResizeTCP = DEFAULT_AUTO_RESIZE_TCP;
+	zeroCopyTCP = DEFAULT_ZERO_COPY_TCP;
 	sendTimeout = DEFAULT_SEND_TIMEOUT;
 	gracefulDisconnect = DEFAULT_GRACEFUL_DISCONNECT;
 	nagleEnabled = DEFAULT_NAGLE_ENABLED;
@@ -26,13 +27,19 @@ void NetInstanceProfile::DefaultVariables()
 	reusableUDP = DEFAULT_REUSABLE_UDP;
 	connectionToServerTimeout = DEFAULT_CONNECTION_TO_SERVER_TIMEOUT;
 	numOperations = DEFAULT_NUM_OPERATIONS;
+	recvDepthUDP = DEFAULT_RECV_DEPTH_UDP;
+	recvBatchUDP = DEFAULT_RECV_BATCH_UDP;
+	recvCoalescingUDP = DEFAULT_RECV_COALESCING_UDP;
+	compactHeadersUDP = DEFAULT_COMPACT_HEADERS_UDP;
+	authenticatedEncryptionUDP = DEFAULT_AUTHENTICATED_ENCRYPTION_UDP;
 	sendMemoryLimitTCP = DEFAULT_SEND_MEMORY_LIMIT;
 	sendMemoryLimitUDP = DEFAULT_SEND_MEMORY_LIMIT;
 	recvMemoryLimitTCP = DEFAULT_RECV_MEMORY_LIMIT;
 	recvMemoryLimitUDP = DEFAULT_RECV_MEMORY_LIMIT;
 	packetRecycleMemorySizeOfPacketsTCP = DEFAULT_PACKET_RECYCLE_MEMORY_SIZE_TCP;
 	packetRecycleNumberOfPacketsTCP = DEFAULT_PACKET_RECYCLE_MEMORY_SIZE_TCP;
-	packetRecycleUDP = new (nothrow) MemoryRecyclePacketRestricted(DEFAULT_PACKET_RECYCLE_NUM_OF_PACKETS_UDP,DEFAULT_PACKET_RECYCLE_MEMORY_SIZE_UDP);
+	packetRecycleSlabBlocksPerClassTCP = DEFAULT_PACKET_RECYCLE_SLAB_BLOCKS_PER_CLASS;
+	packetRecycleUDP = new (nothrow) MemoryRecyclePacketRestricted(DEFAULT_PACKET_RECYCLE_NUM_OF_PACKETS_UDP,DEFAULT_PACKET_RECYCLE_MEMORY_SIZE_UDP,0,DEFAULT_PACKET_RECYCLE_SLAB_BLOCKS_PER_CLASS);
 	Utility::DynamicAllocCheck(packetRecycleUDP,__LINE__,__FILE__);
 }
 
@@ -64,6 +71,7 @@ void NetInstanceProfile::Copy(const NetInstanceProfile & a)
 		modeTCP = a.modeTCP;
 		modeUDP = a.modeUDP;
 		autoResizeTCP = a.autoResizeTCP;
+		zeroCopyTCP = a.zeroCopyTCP;
 		sendTimeout = a.sendTimeout;
 		gracefulDisconnect = a.gracefulDisconnect;
 		nagleEnabled = a.nagleEnabled;
@@ -71,12 +79,18 @@ void NetInstanceProfile::Copy(const NetInstanceProfile & a)
 		reusableUDP = a.reusableUDP;
 		connectionToServerTimeout = a.connectionToServerTimeout;
 		numOperations = a.numOperations;
+		recvDepthUDP = a.recvDepthUDP;
+		recvBatchUDP = a.recvBatchUDP;
+		recvCoalescingUDP = a.recvCoalescingUDP;
+		compactHeadersUDP = a.compactHeadersUDP;
+		authenticatedEncryptionUDP = a.authenticatedEncryptionUDP;
 		
 		packetRecycleUDP = new (nothrow) MemoryRecyclePacketRestricted(*a.packetRecycleUDP);
 		Utility::DynamicAllocCheck(packetRecycleUDP,__LINE__,__FILE__);
 
 		packetRecycleMemorySizeOfPacketsTCP = a.packetRecycleMemorySizeOfPacketsTCP;
 		packetRecycleNumberOfPacketsTCP = a.packetRecycleNumberOfPacketsTCP;
+		packetRecycleSlabBlocksPerClassTCP = a.packetRecycleSlabBlocksPerClassTCP;
 	this->Leave();
 	a.Leave();
 }
@@ -105,6 +119,7 @@ bool NetInstanceProfile::operator==( const NetInstanceProfile & a ) const
 			modeTCP == a.modeTCP && 
 			modeUDP == a.modeUDP && 
 			autoResizeTCP == a.autoResizeTCP && 
+			zeroCopyTCP == a.zeroCopyTCP && 
 			sendTimeout == a.sendTimeout && 
 			gracefulDisconnect == a.gracefulDisconnect && 
 			nagleEnabled == a.nagleEnabled && 
@@ -112,9 +127,16 @@ bool NetInstanceProfile::operator==( const NetInstanceProfile & a ) const
 			reusableUDP == a.reusableUDP && 
 			connectionToServerTimeout == a.connectionToServerTimeout && 
 			numOperations == a.numOperations && 
+			recvDepthUDP == a.recvDepthUDP && 
+			recvBatchUDP == a.recvBatchUDP && 
+			recvCoalescingUDP == a.recvCoalescingUDP && 
+			compactHeadersUDP == a.compactHeadersUDP && 
+			authenticatedEncryptionUDP == a.authenticatedEncryptionUDP && 
 			packetRecycleMemorySizeOfPacketsTCP == a.packetRecycleMemorySizeOfPacketsTCP &&
 			packetRecycleNumberOfPacketsTCP == a.packetRecycleNumberOfPacketsTCP &&
+			packetRecycleSlabBlocksPerClassTCP == a.packetRecycleSlabBlocksPerClassTCP &&
 			packetRecycleUDP->GetMaxNumberOfPackets() == a.packetRecycleUDP->GetMaxNumberOfPackets() &&
+			packetRecycleUDP->GetSlabBlocksPerClass() == a.packetRecycleUDP->GetSlabBlocksPerClass() &&
 			packetRecycleUDP->GetMemorySize() == a.packetRecycleUDP->GetMemorySize());
 	a.Leave();
 	this->Leave();
@@ -471,6 +493,26 @@ void NetInstanceProfile::SetAutoResizeTCP(bool newAutoResizeTCP)
 	_safeWriteValue(autoResizeTCP, newAutoResizeTCP);
 }
 
+/**
+ * @brief Enables or disables zero copy receiving of TCP packets.
+ *
+ * @param option @copydoc zeroCopyTCP
+ */
+void NetInstanceProfile::SetZeroCopyTCP(bool option)
+{
+	_safeWriteValue(zeroCopyTCP, option);
+}
+
+/**
+ * @brief Determines whether zero copy receiving of TCP packets is enabled.
+ *
+ * @return @copydoc zeroCopyTCP
+ */
+bool NetInstanceProfile::IsZeroCopyTCP() const
+{
+	return _safeReadValue(zeroCopyTCP);
+}
+
 /**
  * @brief Retrieves the number of milliseconds that send operations
  * will be allowed to complete before they are canceled and the
@@ -600,6 +642,106 @@ size_t NetInstanceProfile::GetNumOperations() const
 	return _safeReadValue(numOperations);
 }
 
+/**
+ * @brief Specifies the number of UDP receive operations that can be in progress at the same time.
+ *
+ * @param newRecvDepthUDP @copydoc recvDepthUDP
+ */
+void NetInstanceProfile::SetRecvDepthUDP(size_t newRecvDepthUDP)
+{
+	_safeWriteValue(recvDepthUDP, newRecvDepthUDP);
+}
+
+/**
+ * @brief Retrieves the number of UDP receive operations that can be in progress at the same time.
+ *
+ * @return @copydoc recvDepthUDP
+ */
+size_t NetInstanceProfile::GetRecvDepthUDP() const
+{
+	return _safeReadValue(recvDepthUDP);
+}
+
+/**
+ * @brief Specifies the maximum number of UDP datagrams that each receive operation can receive with one system call.
+ *
+ * @param newRecvBatchUDP @copydoc recvBatchUDP
+ */
+void NetInstanceProfile::SetRecvBatchUDP(size_t newRecvBatchUDP)
+{
+	_safeWriteValue(recvBatchUDP, newRecvBatchUDP);
+}
+
+/**
+ * @brief Retrieves the maximum number of UDP datagrams that each receive operation can receive with one system call.
+ *
+ * @return @copydoc recvBatchUDP
+ */
+size_t NetInstanceProfile::GetRecvBatchUDP() const
+{
+	return _safeReadValue(recvBatchUDP);
+}
+
+/**
+ * @brief Enables or disables UDP receive coalescing.
+ *
+ * @param option @copydoc recvCoalescingUDP
+ */
+void NetInstanceProfile::SetRecvCoalescingUDP(bool option)
+{
+	_safeWriteValue(recvCoalescingUDP, option);
+}
+
+/**
+ * @brief Determines whether UDP receive coalescing is enabled.
+ *
+ * @return @copydoc recvCoalescingUDP
+ */
+bool NetInstanceProfile::IsRecvCoalescingUDP() const
+{
+	return _safeReadValue(recvCoalescingUDP);
+}
+
+/**
+ * @brief Enables or disables compact UDP headers.
+ *
+ * @param option @copydoc compactHeadersUDP
+ */
+void NetInstanceProfile::SetCompactHeadersUDP(bool option)
+{
+	_safeWriteValue(compactHeadersUDP, option);
+}
+
+/**
+ * @brief Determines whether compact UDP headers are enabled.
+ *
+ * @return @copydoc compactHeadersUDP
+ */
+bool NetInstanceProfile::IsCompactHeadersUDP() const
+{
+	return _safeReadValue(compactHeadersUDP);
+}
+
+/**
+ * @brief Enables or disables authenticated encryption of UDP packets.
+ *
+ * @param option @copydoc authenticatedEncryptionUDP
+ */
+void NetInstanceProfile::SetAuthenticatedEncryptionUDP(bool option)
+{
+	_safeWriteValue(authenticatedEncryptionUDP, option);
+}
+
+/**
+ * @brief Determines whether authenticated encryption of UDP packets is enabled.
+ *
+ * @return @copydoc authenticatedEncryptionUDP
+ */
+bool NetInstanceProfile::IsAuthenticatedEncryptionUDP() const
+{
+	return _safeReadValue(authenticatedEncryptionUDP);
+}
+
 /**
  * @brief Sets the number of milliseconds that a client is allowed to handshake with the server
  * before it is forcefully disconnected.
@@ -728,11 +870,17 @@ size_t NetInstanceProfile::GetRecvMemoryLimitUDP() const
  *
  * @param	numberOfPackets		Maximum number of packets which can be stored by memory recycle. 
  * @param	memorySizeOfPackets	Memory size of packets in memory recycle.
+ * @param	slabBlocksPerClass	If more than 0, packets larger than @a memorySizeOfPackets are also recycled,
+ * using a MemoryRecycleSlab which stores up to this many blocks of each size class. See MemoryRecycleSlab for more information.
+ * (Optional, default = DEFAULT_PACKET_RECYCLE_SLAB_BLOCKS_PER_CLASS).
  */
-void NetInstanceProfile::SetMemoryRecycleTCP(size_t numberOfPackets, size_t memorySizeOfPackets)
+void NetInstanceProfile::SetMemoryRecycleTCP(size_t numberOfPackets, size_t memorySizeOfPackets, size_t slabBlocksPerClass)
 {
+	Enter();
 	_safeWriteValue(packetRecycleNumberOfPacketsTCP,numberOfPackets);
 	_safeWriteValue(packetRecycleMemorySizeOfPacketsTCP,memorySizeOfPackets);
+	_safeWriteValue(packetRecycleSlabBlocksPerClassTCP,slabBlocksPerClass);
+	Leave();
 }
 
 /**
@@ -745,10 +893,13 @@ void NetInstanceProfile::SetMemoryRecycleTCP(size_t numberOfPackets, size_t memo
  *
  * @param	numberOfPackets		Maximum number of packets which can be stored by memory recycle. 
  * @param	memorySizeOfPackets	Memory size of packets in memory recycle.
+ * @param	slabBlocksPerClass	If more than 0, packets larger than @a memorySizeOfPackets are also recycled,
+ * using a MemoryRecycleSlab which stores up to this many blocks of each size class. See MemoryRecycleSlab for more information.
+ * (Optional, default = DEFAULT_PACKET_RECYCLE_SLAB_BLOCKS_PER_CLASS).
  */
-void NetInstanceProfile::SetMemoryRecycleUDP(size_t numberOfPackets, size_t memorySizeOfPackets)
+void NetInstanceProfile::SetMemoryRecycleUDP(size_t numberOfPackets, size_t memorySizeOfPackets, size_t slabBlocksPerClass)
 {
-	MemoryRecyclePacketRestricted * recycle = new (nothrow) MemoryRecyclePacketRestricted(numberOfPackets,memorySizeOfPackets);
+	MemoryRecyclePacketRestricted * recycle = new (nothrow) MemoryRecyclePacketRestricted(numberOfPackets,memorySizeOfPackets,0,slabBlocksPerClass);
 	Utility::DynamicAllocCheck(recycle,__LINE__,__FILE__);
 
 	Enter();
@@ -805,6 +956,30 @@ size_t NetInstanceProfile::GetMemoryRecycleMemorySizeOfPacketsUDP() const
 	return _safeReadValue(packetRecycleUDP)->GetPacketMemorySize();
 }
 
+/**
+ * @brief	Retrieves the maximum number of blocks of each size class that the slab of the TCP receiving memory recycle can store.
+ *
+ * See MemoryRecycleSlab for more information.
+ *
+ * @return	number of blocks, 0 if no slab is used.
+ */
+size_t NetInstanceProfile::GetMemoryRecycleSlabBlocksPerClassTCP() const
+{
+	return _safeReadValue(packetRecycleSlabBlocksPerClassTCP);
+}
+
+/**
+ * @brief	Retrieves the maximum number of blocks of each size class that the slab of the UDP receiving memory recycle can store.
+ *
+ * See MemoryRecycleSlab for more information.
+ *
+ * @return	number of blocks, 0 if no slab is used.
+ */
+size_t NetInstanceProfile::GetMemoryRecycleSlabBlocksPerClassUDP() const
+{
+	return _safeReadValue(packetRecycleUDP)->GetSlabBlocksPerClass();
+}
+
 /**
  * @brief	Retrieves the UDP packet recycle receive object.
  *
@@ -832,22 +1007,24 @@ NetModeUdp * NetInstanceProfile::GenerateObjectModeUDP(size_t numClients, size_t
 {
 	if(IsEnabledUDP() == true)
 	{
+		NetModeUdp * returnMe = NULL;
+
 		switch(GetModeUDP())
 		{
 		case NetMode::UDP_CATCH_ALL:
-			return static_cast<NetModeUdp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeUdpCatchAll(numClients,&GetMemoryRecyclePacketUDP()),__LINE__,__FILE__));
+			returnMe = static_cast<NetModeUdp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeUdpCatchAll(numClients,&GetMemoryRecyclePacketUDP()),__LINE__,__FILE__));
 			break;
 
 		case NetMode::UDP_CATCH_ALL_NO:
-			return static_cast<NetModeUdp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeUdpCatchAllNo(numClients,&GetMemoryRecyclePacketUDP()),__LINE__,__FILE__));
+			returnMe = static_cast<NetModeUdp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeUdpCatchAllNo(numClients,&GetMemoryRecyclePacketUDP()),__LINE__,__FILE__));
 			break;
 
 		case NetMode::UDP_PER_CLIENT:
-			return static_cast<NetModeUdp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeUdpPerClient(GetRecvSizeUDP(),numClients,numOperations,false,GetDecryptKeyUDP()),__LINE__,__FILE__));
+			returnMe = static_cast<NetModeUdp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeUdpPerClient(GetRecvSizeUDP(),numClients,numOperations,false,GetDecryptKeyUDP()),__LINE__,__FILE__));
 			break;
 
 		case NetMode::UDP_PER_CLIENT_PER_OPERATION:
-			return static_cast<NetModeUdp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeUdpPerClient(GetRecvSizeUDP(),numClients,numOperations,true,GetDecryptKeyUDP()),__LINE__,__FILE__));
+			returnMe = static_cast<NetModeUdp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeUdpPerClient(GetRecvSizeUDP(),numClients,numOperations,true,GetDecryptKeyUDP()),__LINE__,__FILE__));
 			break;
 
 		default:
@@ -855,6 +1032,17 @@ NetModeUdp * NetInstanceProfile::GenerateObjectModeUDP(size_t numClients, size_t
 			return NULL;
 			break;
 		}
+
+		returnMe->SetCompactHeaders(IsCompactHeadersUDP());
+
+		try
+		{
+			returnMe->SetAuthenticatedEncryption(IsAuthenticatedEncryptionUDP());
+		}
+		catch(ErrorReport & error){delete returnMe; throw(error);}
+		catch(...){delete returnMe; throw(-1);}
+
+		return returnMe;
 	}
 	else
 	{
@@ -869,21 +1057,23 @@ NetModeUdp * NetInstanceProfile::GenerateObjectModeUDP(size_t numClients, size_t
  */
 NetModeTcp * NetInstanceProfile::GenerateObjectModeTCP() const
 {
-	MemoryRecyclePacket * memoryRecycle = new (nothrow) MemoryRecyclePacket(packetRecycleNumberOfPacketsTCP,packetRecycleMemorySizeOfPacketsTCP);
+	MemoryRecyclePacket * memoryRecycle = new (nothrow) MemoryRecyclePacket(packetRecycleNumberOfPacketsTCP,packetRecycleMemorySizeOfPacketsTCP,packetRecycleSlabBlocksPerClassTCP);
 	Utility::DynamicAllocCheck(memoryRecycle,__LINE__,__FILE__);
 
+	NetModeTcp * returnMe = NULL;
+
 	switch(GetModeTCP())
 	{
 	case NetMode::TCP_PREFIX_SIZE:
-		return static_cast<NetModeTcp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeTcpPrefixSize(GetRecvSizeTCP(),GetAutoResizeTCP(),memoryRecycle),__LINE__,__FILE__));
+		returnMe = static_cast<NetModeTcp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeTcpPrefixSize(GetRecvSizeTCP(),GetAutoResizeTCP(),memoryRecycle),__LINE__,__FILE__));
 		break;
 
 	case NetMode::TCP_POSTFIX:
-		return static_cast<NetModeTcp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeTcpPostfix(GetRecvSizeTCP(),GetAutoResizeTCP(),GetPostFixTCP(),memoryRecycle),__LINE__,__FILE__));
+		returnMe = static_cast<NetModeTcp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeTcpPostfix(GetRecvSizeTCP(),GetAutoResizeTCP(),GetPostFixTCP(),memoryRecycle),__LINE__,__FILE__));
 		break;
 
 	case NetMode::TCP_RAW:
-		return static_cast<NetModeTcp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeTcpRaw(memoryRecycle),__LINE__,__FILE__));
+		returnMe = static_cast<NetModeTcp*>(Utility::DynamicAllocCheck(new (nothrow) NetModeTcpRaw(memoryRecycle),__LINE__,__FILE__));
 		break;
 
 	default:
@@ -893,7 +1083,8 @@ NetModeTcp * NetInstanceProfile::GenerateObjectModeTCP() const
 		break;
 	}
 
-	delete memoryRecycle;
+	returnMe->SetZeroCopy(IsZeroCopyTCP());
+	return returnMe;
 }
 
 /**
@@ -924,7 +1115,7 @@ NetSocketUDP * NetInstanceProfile::GenerateObjectSocketUDP( size_t bufferLength,
 
 	if(this->IsEnabledUDP() == true)
 	{
-		returnMe = new NetSocketUDP(bufferLength,localAddr,reusable,udpMode,recvFunc);
+		returnMe = new NetSocketUDP(bufferLength,localAddr,reusable,udpMode,recvFunc,GetRecvDepthUDP(),GetRecvBatchUDP(),IsRecvCoalescingUDP());
 		Utility::DynamicAllocCheck(returnMe,__LINE__,__FILE__);
 	}
 
@@ -74,7 +74,7 @@ private:
 
 public:
 	/** @brief Default value for NetInstanceProfile::decryptKeyUDP. */
-	static const INT_PTR DEFAULT_DECRYPT_KEY_UDP = NULL;
+	static const INT_PTR DEFAULT_DECRYPT_KEY_UDP = 0;
 private:
 
 	/**
@@ -154,6 +154,21 @@ private:
 	 */
 	bool autoResizeTCP;
 
+public:
+	/** @brief Default value for NetInstanceProfile::zeroCopyTCP. */
+	static const bool DEFAULT_ZERO_COPY_TCP = false;
+private:
+	/**
+	 * @brief If true complete TCP packets are passed to the TCP receive function as views of the received data,
+	 * and packets retrieved from the TCP packet queue take the memory of the queued packet rather than copying it.
+	 *
+	 * Views are only valid until the receive function returns and must not be added to.
+	 * See NetModeTcp::SetZeroCopy for more information.
+	 *
+	 * Default is NetInstanceProfile::DEFAULT_ZERO_COPY_TCP.
+	 */
+	bool zeroCopyTCP;
+
 public:
 	/** @brief Default value for NetInstanceProfile::sendTimeout. */
 	static const unsigned int DEFAULT_SEND_TIMEOUT = INFINITE;
@@ -220,6 +235,83 @@ private:
 	 */
 	size_t numOperations;
 
+public:
+	/** @brief Default value for NetInstanceProfile::recvDepthUDP. */
+	static const size_t DEFAULT_RECV_DEPTH_UDP = 1;
+private:
+	/**
+	 * @brief Number of UDP receive operations that can be in progress at the same time.
+	 *
+	 * More receive operations allow more completion port threads to deal with UDP data at the same time,
+	 * but packets may be dealt with in a different order to the one they were received in. NetMode::UDP_CATCH_ALL
+	 * delivers such packets out of order. The other UDP modes never deliver or store a packet older than one already
+	 * dealt with from the same client (and operation, in NetMode::UDP_PER_CLIENT_PER_OPERATION), because each packet
+	 * is checked and dealt with while holding a lock for that client. More packets may be discarded as out of order though,
+	 * and packets from the same client are dealt with one at a time.
+	 *
+	 * Default is NetInstanceProfile::DEFAULT_RECV_DEPTH_UDP.
+	 */
+	size_t recvDepthUDP;
+
+public:
+	/** @brief Default value for NetInstanceProfile::recvBatchUDP. */
+	static const size_t DEFAULT_RECV_BATCH_UDP = 1;
+private:
+	/**
+	 * @brief Maximum number of UDP datagrams that each receive operation can receive with one system call.
+	 *
+	 * Datagrams received together are passed to the UDP mode together, reducing the number of system calls
+	 * and completions under heavy load. Only supported on Linux, ignored on Windows.
+	 *
+	 * Default is NetInstanceProfile::DEFAULT_RECV_BATCH_UDP.
+	 */
+	size_t recvBatchUDP;
+
+public:
+	/** @brief Default value for NetInstanceProfile::recvCoalescingUDP. */
+	static const bool DEFAULT_RECV_COALESCING_UDP = false;
+private:
+	/**
+	 * @brief True if UDP receive coalescing (GRO) is enabled, allowing the kernel to pass several
+	 * datagrams from the same source as one message which is then split into datagrams.
+	 *
+	 * Only supported on Linux, ignored on Windows or if not supported by the kernel.
+	 *
+	 * Default is NetInstanceProfile::DEFAULT_RECV_COALESCING_UDP.
+	 */
+	bool recvCoalescingUDP;
+
+public:
+	/** @brief Default value for NetInstanceProfile::compactHeadersUDP. */
+	static const bool DEFAULT_COMPACT_HEADERS_UDP = false;
+private:
+	/**
+	 * @brief True if UDP modes should write their headers as variable length integers
+	 * instead of Utility::LargestSupportedBytesInt byte integers.
+	 *
+	 * Only the server's option is used, clients use whatever the server tells them to
+	 * during the handshaking process. See NetModeUdp::SetCompactHeaders for more information.
+	 *
+	 * Default is NetInstanceProfile::DEFAULT_COMPACT_HEADERS_UDP.
+	 */
+	bool compactHeadersUDP;
+
+public:
+	/** @brief Default value for NetInstanceProfile::authenticatedEncryptionUDP. */
+	static const bool DEFAULT_AUTHENTICATED_ENCRYPTION_UDP = false;
+private:
+	/**
+	 * @brief True if UDP packets should be encrypted and authenticated using the UDP decryption key,
+	 * see SetDecryptKeyUDP(). Packets which have been modified or forged are then discarded.
+	 *
+	 * Only supported by NetMode::UDP_PER_CLIENT and NetMode::UDP_PER_CLIENT_PER_OPERATION, and a UDP
+	 * decryption key must be set. Only the server's option is used, clients use whatever the server tells
+	 * them to during the handshaking process. See NetModeUdp::SetAuthenticatedEncryption for more information.
+	 *
+	 * Default is NetInstanceProfile::DEFAULT_AUTHENTICATED_ENCRYPTION_UDP.
+	 */
+	bool authenticatedEncryptionUDP;
+
 public:
 	/** @brief Default value for NetInstanceProfile::nagleEnabled. */
 	static const NetMode::ProtocolMode DEFAULT_MODE_UDP = NetMode::UDP_CATCH_ALL_NO;
@@ -308,6 +400,11 @@ private:
 	 */
 	const static size_t DEFAULT_PACKET_RECYCLE_MEMORY_SIZE_UDP = 0;
 
+	/**
+	 * @brief Default value for NetInstanceProfile::packetRecycleSlabBlocksPerClassTCP and the slab of NetInstanceProfile::packetRecycleUDP.
+	 */
+	const static size_t DEFAULT_PACKET_RECYCLE_SLAB_BLOCKS_PER_CLASS = 0;
+
 	/**
 	 * @brief Maximum number of packets which can be stored in the memory
 	 * recycle to be used while receiving TCP packets.
@@ -320,6 +417,12 @@ private:
 	 */
 	size_t packetRecycleMemorySizeOfPacketsTCP;
 
+	/**
+	 * @brief Maximum number of blocks of each size class which can be stored in the
+	 * slab of the memory recycle used while receiving TCP packets, 0 if no slab is used.
+	 */
+	size_t packetRecycleSlabBlocksPerClassTCP;
+
 	/**
 	 * @brief Memory recycle to be used to efficiently manage
 	 * memory while receiving UDP packets.
@@ -351,6 +454,7 @@ public:
 	void SetModeTCP(NetMode::ProtocolMode newModeTCP);
 	void SetModeUDP(NetMode::ProtocolMode newModeUDP);
 	void SetAutoResizeTCP(bool newAutoResizeTCP);
+	void SetZeroCopyTCP(bool option);
 	void SetSendTimeout(unsigned int newSendTimeout);
 	void SetGracefulDisconnectEnabled(bool newGracefulDisconnect);
 	void SetNagleEnabled(bool newNagleEnabled);
@@ -358,10 +462,15 @@ public:
 	void SetReusableUDP(bool option);
 	void SetConnectionToServerTimeout(size_t newConnectionToServerTimeout);
 	void SetNumOperations(size_t newNumOperations);
+	void SetRecvDepthUDP(size_t newRecvDepthUDP);
+	void SetRecvBatchUDP(size_t newRecvBatchUDP);
+	void SetRecvCoalescingUDP(bool option);
+	void SetCompactHeadersUDP(bool option);
+	void SetAuthenticatedEncryptionUDP(bool option);
 	void SetSendMemoryLimit(size_t memoryLimitTCP, size_t memoryLimitUDP);
 	void SetRecvMemoryLimit(size_t memoryLimitTCP, size_t memoryLimitUDP);
-	void SetMemoryRecycleTCP(size_t numberOfPackets, size_t memorySizeOfPackets);
-	void SetMemoryRecycleUDP(size_t numberOfPackets, size_t memorySizeOfPackets);
+	void SetMemoryRecycleTCP(size_t numberOfPackets, size_t memorySizeOfPackets, size_t slabBlocksPerClass = DEFAULT_PACKET_RECYCLE_SLAB_BLOCKS_PER_CLASS);
+	void SetMemoryRecycleUDP(size_t numberOfPackets, size_t memorySizeOfPackets, size_t slabBlocksPerClass = DEFAULT_PACKET_RECYCLE_SLAB_BLOCKS_PER_CLASS);
 
 	size_t GetWsaRecvSizeTCP() const;
 	size_t GetRecvSizeTCP() const;
@@ -375,6 +484,7 @@ public:
 	NetMode::ProtocolMode GetModeTCP() const;
 	NetMode::ProtocolMode GetModeUDP() const;
 	bool GetAutoResizeTCP() const;
+	bool IsZeroCopyTCP() const;
 	unsigned int GetSendTimeout() const;
 	bool IsGracefulDisconnectEnabled() const;
 	bool IsNagleEnabled() const;
@@ -382,6 +492,11 @@ public:
 	bool IsReusableUDP() const;
 	size_t GetConnectionToServerTimeout() const;
 	size_t GetNumOperations() const;
+	size_t GetRecvDepthUDP() const;
+	size_t GetRecvBatchUDP() const;
+	bool IsRecvCoalescingUDP() const;
+	bool IsCompactHeadersUDP() const;
+	bool IsAuthenticatedEncryptionUDP() const;
 	size_t GetSendMemoryLimitTCP() const;
 	size_t GetRecvMemoryLimitTCP() const;
 	size_t GetSendMemoryLimitUDP() const;
@@ -390,6 +505,8 @@ public:
 	size_t GetMemoryRecycleMemorySizeOfPacketsTCP() const;
 	size_t GetMemoryRecycleNumberOfPacketsUDP() const;
 	size_t GetMemoryRecycleMemorySizeOfPacketsUDP() const;
+	size_t GetMemoryRecycleSlabBlocksPerClassTCP() const;
+	size_t GetMemoryRecycleSlabBlocksPerClassUDP() const;
 
 	NetSocket::RecvFunc GetRecvFuncTCP() const;
 	NetSocket::RecvFunc GetRecvFuncUDP() const;
@@ -1,6 +1,4 @@
 #include "FullInclude.h"
-#include "ComparatorServerClientFindByAddressUDP.h"
-#include "StdComparator.h"
 
 
 /**
@@ -33,6 +31,19 @@ void NetInstanceServer::Initialize(size_t p_maxClients, bool p_handshakeEnabled,
 		_ErrorException((p_socketListening == NULL),"loading a listening socket, parameter is NULL",0,__LINE__,__FILE__);
 		this->socketListening = p_socketListening;
 
+		// Setup client ID queues, every client ID is unused and lowest client IDs are used first
+		unusedClients.Resize(maxClients);
+		clientStateChanged.Resize(maxClients);
+		clientClosingGracefully.Resize(maxClients);
+		for(size_t n = maxClients; n>=1; n--)
+		{
+			unusedClients.Add(n);
+		}
+
+		// SendAllUDP does not allocate memory once this is done
+		sendAllClientIDs.reserve(maxClients);
+		sendAllAddresses.reserve(maxClients);
+
 		// Setup client vector
 		client.Resize(maxClients+1); // +1 for 0 indexed
 		for(size_t n = 1; n<=maxClients; n++)
@@ -42,6 +53,7 @@ void NetInstanceServer::Initialize(size_t p_maxClients, bool p_handshakeEnabled,
 
 			client.Allocate(n,addMe);
 			client[n].GetSocketTCP()->SetInstance(this);
+			client[n].SetStateChangedQueue(&clientStateChanged);
 
 			client[n].SetSendMemoryLimitTCP(sendMemoryLimitTCP);
 			client[n].SetRecvMemoryLimitTCP(recvMemoryLimitTCP);
@@ -55,8 +67,7 @@ void NetInstanceServer::Initialize(size_t p_maxClients, bool p_handshakeEnabled,
 			}
 		}
 
-		clientSortedByAddressUDP.LinkShallow(client);
-		clientSortedByAddressUdpNeedsResort = true;
+		clientByAddressUDP.Resize(client.Size());
 
 		/**
 		 * Server info packet contains:
@@ -77,7 +88,17 @@ void NetInstanceServer::Initialize(size_t p_maxClients, bool p_handshakeEnabled,
 		if(IsEnabledUDP() == true)
 		{
 			serverInfo.AddSizeT(socketUDP->GetMode()->GetNumOperations());
-			serverInfo.Add<char>(socketUDP->GetMode()->GetProtocolMode());
+
+			char modeUDP = static_cast<char>(socketUDP->GetMode()->GetProtocolMode());
+			if(socketUDP->GetMode()->IsCompactHeaders() == true)
+			{
+				modeUDP |= NetModeUdp::COMPACT_HEADERS_FLAG;
+			}
+			if(socketUDP->GetMode()->IsAuthenticatedEncryption() == true)
+			{
+				modeUDP |= NetModeUdp::AUTHENTICATED_ENCRYPTION_FLAG;
+			}
+			serverInfo.Add<char>(modeUDP);
 		}
 
 		// Start receiving via UDP
@@ -109,9 +130,15 @@ void NetInstanceServer::Initialize(size_t p_maxClients, bool p_handshakeEnabled,
  */
 NetInstanceServer::NetInstanceServer(size_t p_maxClients, NetSocketListening * p_socketListening, NetSocketUDP * p_socketUDP, bool p_handshakeEnabled, unsigned int p_sendTimeout, size_t p_connectionTimeout, size_t p_instanceID) :
 		client(),
-		clientSortedByAddressUDP(),
-		comparatorSort(true),
-		comparatorFind(false),
+		clientByAddressUDP(),
+		unusedClients(),
+		clientStateChanged(),
+		clientClosingGracefully(),
+		connectingClients(),
+		connectingExpired(),
+		sendAllLock(),
+		sendAllClientIDs(),
+		sendAllAddresses(),
 		NetInstance(p_instanceID,NetInstance::SERVER,p_sendTimeout),
 		NetInstanceTCP(p_handshakeEnabled),
 		NetInstanceUDP(p_socketUDP),
@@ -131,9 +158,15 @@ NetInstanceServer::NetInstanceServer(size_t p_maxClients, NetSocketListening * p
  */
 NetInstanceServer::NetInstanceServer(size_t p_maxClients, const NetInstanceProfile & p_profile, size_t p_instanceID) :
 		client(),
-		clientSortedByAddressUDP(),
-		comparatorSort(true),
-		comparatorFind(false),
+		clientByAddressUDP(),
+		unusedClients(),
+		clientStateChanged(),
+		clientClosingGracefully(),
+		connectingClients(),
+		connectingExpired(),
+		sendAllLock(),
+		sendAllClientIDs(),
+		sendAllAddresses(),
 		NetInstance(p_instanceID,NetInstance::SERVER,p_profile.GetSendTimeout()),
 		NetInstanceTCP(p_profile.IsHandshakeEnabled()),
 		NetInstanceUDP
@@ -474,23 +507,26 @@ void NetInstanceServer::DisconnectClient(size_t clientID)
 		AddDisconnect(clientID);
 	}
 
-	clientSortedByAddressUDP.Enter();
+	clientByAddressUDP.Enter();
 	try
 	{
+		// UDP address is about to be cleared, so stop packets from it being routed to this client.
+		clientByAddressUDP.Remove(client[clientID].GetConnectedAddressUDP(),clientID);
+
 		// Reset client's data
 		client[clientID].Disconnect();
-
-		// UDP address will have changed, so resort vector.
-		RequestResortClientsByAddressUDP();
 	}
-	catch(ErrorReport & error){	clientSortedByAddressUDP.Leave(); throw(error); }
-	catch(...){ clientSortedByAddressUDP.Leave(); throw(-1); }
-	clientSortedByAddressUDP.Leave();
+	catch(ErrorReport & error){	clientByAddressUDP.Leave(); throw(error); }
+	catch(...){ clientByAddressUDP.Leave(); throw(-1); }
+	clientByAddressUDP.Leave();
 
 	if(IsEnabledUDP() == true)
 	{
 		socketUDP->Reset(clientID);
 	}
+
+	// Client ID can now be given to a new client
+	unusedClients.Add(clientID);
 }
 
 /**
@@ -521,8 +557,8 @@ NetUtility::ConnectionStatus NetInstanceServer::ClientConnected(size_t clientID)
  * during the handshaking process. It is best to call this continuously in 
  * a loop that runs this networking module. \n\n
  * 
- * Connection requests will be rejected if the maximum number of clients
- * has been reached.\n\n
+ * All pending connection requests are accepted on each call, and connection
+ * requests will be rejected if the maximum number of clients has been reached.\n\n
  *
  * This method is part of the @ref handshakePage "server/client handshaking process".
  *
@@ -531,82 +567,123 @@ NetUtility::ConnectionStatus NetInstanceServer::ClientConnected(size_t clientID)
  */
 size_t NetInstanceServer::ClientJoined()
 {
-	size_t returnMe = NULL;
+	size_t returnMe = 0;
 
 	/**
-	 * When a TCP connection is accepted, an unused client ID needs to be found.
-	 * It is more efficient only to have one loop checking the status of clients
-	 * and this loop occurs before WSAAccept. The loop will fill unusedClientID
-	 * with the first unused client ID that it finds, so that a new client can
-	 * be given the ID.
-	 *
-	 * If unusedClientID remains 0 then no free client ID was found.
+	 * Clients are only looked at when something has happened to them, rather than
+	 * checking the state of every client on every call. This keeps the cost of each
+	 * call low when maxClients is large.
 	 */
-	size_t unusedClientID = 0;
 
-	for(size_t clientID = 1; clientID <= maxClients; clientID++)
+	// Connection process timeouts
+	clock_t now = clock();
+	connectingExpired.clear();
+	connectingClients.Advance(now,connectingExpired);
+	for(size_t n = 0;n<connectingExpired.size();n++)
 	{
-		switch(client[clientID].GetConnectionState())
+		size_t clientID = connectingExpired[n];
+
+		// Client may have finished connecting, or the client ID may have been reused since the deadline was set.
+		if(client[clientID].GetConnectionState() == NetUtility::CONNECTING)
 		{
-			// Unused client ID
-			case(NetUtility::NOT_CONNECTED):
-				if(unusedClientID == 0)
-				{
-					unusedClientID = clientID;
-				}
-			break;
+			if(now - client[clientID].GetClockStarted() > (clock_t)timeout.Get())
+			{
+				DisconnectClient(clientID);
+			}
+			else
+			{
+				// Not timed out yet, timeout may have been increased
+				connectingClients.Add(clientID,client[clientID].GetClockStarted() + (clock_t)timeout.Get());
+			}
+		}
+	}
 
-			// When all TCP data has been used then we should cleanup.
-			case(NetUtility::CONNECTED):
-				if(IsGracefulDisconnectEnabled() == true)
-				{
-					if(client[clientID].GetConnectionStateTCP() == NetUtility::NOT_CONNECTED)
-					{
-						DisconnectClient(clientID);
-					}
-				}
+	// When all TCP data has been used then we should cleanup.
+	size_t closingAmount = clientClosingGracefully.Size();
+	for(size_t n = 0;n<closingAmount;n++)
+	{
+		size_t clientID = 0;
+		if(clientClosingGracefully.GetFront(clientID) == false)
+		{
 			break;
+		}
 
+		if(client[clientID].GetConnectionState() == NetUtility::CONNECTED)
+		{
+			if(client[clientID].GetConnectionStateTCP() == NetUtility::NOT_CONNECTED)
+			{
+				DisconnectClient(clientID);
+			}
+			else
+			{
+				// Check again next time
+				clientClosingGracefully.Add(clientID);
+			}
+		}
+	}
+
+	// Deal with clients whose connection state has changed, announcing at most one new client per call.
+	size_t clientID = 0;
+	while(returnMe == 0 && clientStateChanged.GetFront(clientID) == true)
+	{
+		switch(client[clientID].GetConnectionState())
+		{
 			// An error has occurred and the client should now be disconnected. It is important
 			// that the client is disconnected from the main process to prevent deadlock.
 			case(NetUtility::DISCONNECTING):
 				DisconnectClient(clientID);
 			break;
-				
+
 			// Client is fully connected but is awaiting confirmation since
 			// this method must announce that it is joined before it is officially connected.
 			case(NetUtility::CONNECTED_AC):
-				if(returnMe == NULL)
+			{
+				// Notify client that we received their UDP packet so they are fully connected.
+				// Send operation MUST block because we don't want to change connection status until
+				// this message has been sent.
+				try
 				{
-					// Notify client that we received their UDP packet so they are fully connected.
-					// Send operation MUST block because we don't want to change connection status until
-					// this message has been sent.
 					Packet notifyCompletion;
 					NetUtility::SendStatus status = client[clientID].SendTCP(notifyCompletion,true);
 					_ErrorException((status != NetUtility::SEND_COMPLETED),"notifying a client that it has finished connecting",WSAGetLastError(),__LINE__,__FILE__);
 
-					returnMe = clientID;
 					client[clientID].SetConnectionState(NetUtility::CONNECTED);
 				}
+				// Put the client back in the queue so that it is dealt with by a later call, instead of being lost
+				catch(ErrorReport & error){ clientStateChanged.Add(clientID); throw(error); }
+				catch(...){ clientStateChanged.Add(clientID); throw(-1); }
+
+				returnMe = clientID;
+			}
 			break;
 
-			// Connection process timeouts
-			case(NetUtility::CONNECTING):
-				if(clock() - client[clientID].GetClockStarted() > (clock_t)timeout.Get())
-				{
-					DisconnectClient(clientID);
-				}
+			// Client state has changed again since it was added to the queue.
+			default:
 			break;
 		}
 	}
 
-	// Deal with new TCP connection attempts
-	NetAddress newClientAddr;
-	SOCKET newClientSocket = socketListening->AcceptConnection(unusedClientID,&newClientAddr);
-
-	// If a request was accepted then continue setting up this client
-	if(newClientSocket != INVALID_SOCKET)
+	// Deal with new TCP connection attempts, accepting all that are pending while there are unused client IDs.
+	// When there are no unused client IDs, unusedClientID remains 0 and one connection attempt is rejected.
+	while(true)
 	{
+		size_t unusedClientID = 0;
+		bool foundUnused = unusedClients.GetBack(unusedClientID);
+
+		NetAddress newClientAddr;
+		SOCKET newClientSocket = socketListening->AcceptConnection(unusedClientID,&newClientAddr);
+
+		// No more connection attempts
+		if(newClientSocket == INVALID_SOCKET)
+		{
+			if(foundUnused == true)
+			{
+				unusedClients.Add(unusedClientID);
+			}
+			break;
+		}
+
+		// Continue setting up this client
 		client[unusedClientID].LoadTCP(newClientSocket,newClientAddr,IsEnabledUDP());
 		DoRecv(client[unusedClientID].GetSocketTCP(),unusedClientID); // Starts TCP receive operation
 
@@ -615,20 +692,29 @@ size_t NetInstanceServer::ClientJoined()
 			NetUtility::SendStatus status = client[unusedClientID].SendHandshakingPacket(GetServerInfo(),IsEnabledUDP());
 			if(status == NetUtility::SEND_FAILED || status == NetUtility::SEND_FAILED_KILL)
 			{
-				clientSortedByAddressUDP.Enter();
+				clientByAddressUDP.Enter();
 				try
 				{
-					client[unusedClientID].Disconnect();
-
 					// Just in case a UDP address was loaded before disconnection, although
 					// this probably never happens.
-					RequestResortClientsByAddressUDP();
+					clientByAddressUDP.Remove(client[unusedClientID].GetConnectedAddressUDP(),unusedClientID);
+
+					client[unusedClientID].Disconnect();
 				}
-				catch(ErrorReport & error){	clientSortedByAddressUDP.Leave(); throw(error); }
-				catch(...){ clientSortedByAddressUDP.Leave(); throw(-1); }
-				clientSortedByAddressUDP.Leave();
+				catch(ErrorReport & error){	clientByAddressUDP.Leave(); throw(error); }
+				catch(...){ clientByAddressUDP.Leave(); throw(-1); }
+				clientByAddressUDP.Leave();
+
+				unusedClients.Add(unusedClientID);
+				continue;
 			}
 		}
+
+		// Client must complete the connection process before the timeout.
+		if(client[unusedClientID].GetConnectionState() == NetUtility::CONNECTING)
+		{
+			connectingClients.Add(unusedClientID,client[unusedClientID].GetClockStarted() + (clock_t)timeout.Get());
+		}
 	}
 
 	return(returnMe);
@@ -935,6 +1021,72 @@ NetUtility::SendStatus NetInstanceServer::SendTCP(const Packet & packet, bool bl
 	return returnMe;
 }
 
+/**
+ * @brief Sends a packet asynchronously via TCP to the specified client, sharing a copy of its data with other send operations.
+ *
+ * @param packet Packet to send.
+ * @param [in] payload Copy of @a packet's data, see NetSendPayload.
+ * @param clientID ID of client to send to.
+ *
+ * @return NetUtility::SEND_COMPLETED if the send operation completed successfully instantly.
+ * @return NetUtility::SEND_IN_PROGRESS if the send operation was started, but has not yet completed.
+ * @return NetUtility::SEND_FAILED if the send operation failed.
+ * @return NetUtility::SEND_FAILED_KILL if the send operation failed and an entity was killed as a result (e.g. Client disconnected).
+ */
+NetUtility::SendStatus NetInstanceServer::SendSharedTCP(const Packet & packet, NetSendPayload * payload, size_t clientID)
+{
+	ValidateClientID(clientID,__LINE__,__FILE__);
+	NetUtility::SendStatus returnMe = client[clientID].SendSharedTCP(packet,payload);
+	if(returnMe == NetUtility::SEND_FAILED_KILL)
+	{
+		ErrorOccurred(clientID);
+	}
+	return returnMe;
+}
+
+/**
+ * @brief Sends a packet chain asynchronously via TCP to the specified client, without copying its segments.
+ *
+ * @param chain Packet data to send, see PacketChain.
+ * @param clientID ID of client to send to.
+ *
+ * @return NetUtility::SEND_COMPLETED if the send operation completed successfully instantly.
+ * @return NetUtility::SEND_IN_PROGRESS if the send operation was started, but has not yet completed.
+ * @return NetUtility::SEND_FAILED if the send operation failed.
+ * @return NetUtility::SEND_FAILED_KILL if the send operation failed and an entity was killed as a result (e.g. Client disconnected).
+ */
+NetUtility::SendStatus NetInstanceServer::SendChainTCP(const PacketChain & chain, size_t clientID)
+{
+	ValidateClientID(clientID,__LINE__,__FILE__);
+	NetUtility::SendStatus returnMe = client[clientID].SendChainTCP(chain);
+	if(returnMe == NetUtility::SEND_FAILED_KILL)
+	{
+		ErrorOccurred(clientID);
+	}
+	return returnMe;
+}
+
+/**
+ * @brief Sends a packet asynchronously via TCP to all connected clients, sharing one copy of its data.
+ *
+ * @param packet Packet to send.
+ * @param [in] payload Copy of @a packet's data, see NetSendPayload.
+ * @param excludeClient Client ID of client not to send to.
+ */
+void NetInstanceServer::SendAllSharedTCP(const Packet & packet, NetSendPayload * payload, size_t excludeClient)
+{
+	for(size_t cl = 1;cl<=maxClients;cl++)
+	{
+		if(excludeClient != cl)
+		{
+			if(ClientConnected(cl) == NetUtility::CONNECTED)
+			{
+				SendSharedTCP(packet,payload,cl);
+			}
+		}
+	}
+}
+
 /**
  * @brief Sends a packet via TCP to all connected clients.
  *
@@ -943,8 +1095,86 @@ NetUtility::SendStatus NetInstanceServer::SendTCP(const Packet & packet, bool bl
  * the packet has been received by all clients, instead it simply means the packet is in transit. \n
  * If false the method will return instantly even if the packet has not been sent.
  * @param excludeClient Client ID of client not to send to.
+ *
+ * If @a block is false the packet's data is copied once and shared by the send operations
+ * of all clients (see NetSendPayload), instead of being copied for each client.
  */
 void NetInstanceServer::SendAllTCP(const Packet & packet, bool block, size_t excludeClient)
+{
+	if(block == true)
+	{
+		for(size_t cl = 1;cl<=maxClients;cl++)
+		{
+			if(excludeClient != cl)
+			{
+				if(ClientConnected(cl) == NetUtility::CONNECTED)
+				{
+					SendTCP(packet,block,cl);
+				}
+			}
+		}
+		return;
+	}
+
+	// Send operations hold their own references, so the payload is deleted
+	// when we release ours and the last send operation completes.
+	NetSendPayload * payload = new (nothrow) NetSendPayload(packet);
+	Utility::DynamicAllocCheck(payload,__LINE__,__FILE__);
+
+	try
+	{
+		SendAllSharedTCP(packet,payload,excludeClient);
+	}
+	catch(ErrorReport & error){ payload->Release(); throw error; }
+	catch(...){ payload->Release(); throw -1; }
+	payload->Release();
+}
+
+/**
+ * @brief Sends a packet via TCP to all connected clients, taking the packet's memory instead of copying it.
+ *
+ * If @a block is false the packet's memory is given to a NetSendPayload shared by the send operations
+ * of all clients, so @a packet is left with no memory. In all cases @a packet is empty when this method returns.
+ * If an exception is thrown @a packet keeps its data.
+ *
+ * @param [in,out] packet Packet to send.
+ * @param block If true the method will not return until @a packet is completely sent to all clients, note that this does not indicate that
+ * the packet has been received by all clients, instead it simply means the packet is in transit. \n
+ * If false the method will return instantly even if the packet has not been sent.
+ * @param excludeClient Client ID of client not to send to.
+ */
+void NetInstanceServer::SendAllTCP(Packet && packet, bool block, size_t excludeClient)
+{
+	if(block == true || packet.GetUsedSize() == 0 || packet.IsDataPtrChanged() == true)
+	{
+		SendAllTCP(static_cast<const Packet &>(packet),block,excludeClient);
+		packet.Clear();
+		return;
+	}
+
+	// Packet's memory is only taken once the send operations have been started
+	NetSendPayload * payload = new (nothrow) NetSendPayload(&packet);
+	Utility::DynamicAllocCheck(payload,__LINE__,__FILE__);
+
+	try
+	{
+		SendAllSharedTCP(packet,payload,excludeClient);
+		payload->TakeMemory();
+	}
+	catch(ErrorReport & error){ payload->ReturnMemory(); payload->Release(); throw error; }
+	catch(...){ payload->ReturnMemory(); payload->Release(); throw -1; }
+	payload->Release();
+}
+
+/**
+ * @brief Sends a packet chain asynchronously via TCP to all connected clients.
+ *
+ * Segments are shared by the send operations of all clients, so no data is copied.
+ *
+ * @param chain Packet data to send, see PacketChain.
+ * @param excludeClient Client ID of client not to send to.
+ */
+void NetInstanceServer::SendAllChainTCP(const PacketChain & chain, size_t excludeClient)
 {
 	for(size_t cl = 1;cl<=maxClients;cl++)
 	{
@@ -952,7 +1182,7 @@ void NetInstanceServer::SendAllTCP(const Packet & packet, bool block, size_t exc
 		{
 			if(ClientConnected(cl) == NetUtility::CONNECTED)
 			{
-				SendTCP(packet,block,cl);
+				SendChainTCP(chain,cl);
 			}
 		}
 	}
@@ -1000,19 +1230,46 @@ NetUtility::SendStatus NetInstanceServer::SendUDP(const Packet & packet, bool bl
  * the packet has been received by all clients, instead it simply means the packet is in transit. \n
  * If false the method will return instantly even if the packet has not been sent.
  * @param excludeClient ClientID of client not to send to.
+ *
+ * Where supported (see NetSocketUDP::SendBatch) the packet is sent to all clients with a few batched
+ * system calls, which complete before this method returns. Any clients that the batch could not deal
+ * with are sent to individually using SendUDP().
  */
 void NetInstanceServer::SendAllUDP(const Packet & packet, bool block, size_t excludeClient)
 {
-	for(size_t cl = 1;cl<=maxClients;cl++)
+	sendAllLock.Enter();
+	try
 	{
-		if(excludeClient != cl)
+		sendAllClientIDs.clear();
+		sendAllAddresses.clear();
+
+		for(size_t cl = 1;cl<=maxClients;cl++)
 		{
-			if(ClientConnected(cl) == NetUtility::CONNECTED)
+			if(excludeClient != cl)
 			{
-				SendUDP(packet,block,cl);
+				if(ClientConnected(cl) == NetUtility::CONNECTED)
+				{
+					sendAllClientIDs.push_back(cl);
+					sendAllAddresses.push_back(&client[cl].GetConnectedAddressUDP());
+				}
+			}
+		}
+
+		if(sendAllClientIDs.empty() == false)
+		{
+			NetInstanceUDP::ValidateIsEnabledUDP(__LINE__,__FILE__);
+
+			size_t sent = socketUDP->SendBatch(packet,&sendAllClientIDs[0],&sendAllAddresses[0],sendAllClientIDs.size());
+			for(size_t n = sent;n<sendAllClientIDs.size();n++)
+			{
+				SendUDP(packet,block,sendAllClientIDs[n]);
 			}
 		}
 	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){ sendAllLock.Leave(); throw(error); }
+	catch(...){ sendAllLock.Leave(); throw(-1); }
+	sendAllLock.Leave();
 }
 
 /**
@@ -1082,15 +1339,6 @@ size_t NetInstanceServer::GetPacketFromStoreUDP(Packet * destination, size_t cli
 	return NetInstanceUDP::GetPacketFromStoreUDP(destination, clientID,operationID);
 }
 
-/**
- * @brief	Sorts the vector clientSortedByAddressUDP in order of UDP address so
- * that it can be efficiently searched through.
- */
-void NetInstanceServer::RequestResortClientsByAddressUDP()
-{
-	clientSortedByAddressUdpNeedsResort = true;
-}
-
 /** 
  * @brief Searches all connected clients and determines if the specified address
  * a remote UDP address belonging to one of them. If it is then the client
@@ -1105,49 +1353,11 @@ void NetInstanceServer::RequestResortClientsByAddressUDP()
  */
 size_t NetInstanceServer::FindClientByAddressUDP(const NetAddress & addr)
 {
-	clientSortedByAddressUDP.Enter();
+	// Lock free, so that completion threads receiving UDP packets do not contend with each other.
 	size_t returnMe = 0;
-	try
-	{
-		size_t idWithinVector = clientSortedByAddressUDP.Find(comparatorSort,comparatorFind,&addr,clientSortedByAddressUdpNeedsResort);
-
-		// Vector will have been sorted if necessary by Find.
-		clientSortedByAddressUdpNeedsResort = false;
-
-		if(idWithinVector >= clientSortedByAddressUDP.Size() ||
-		   !clientSortedByAddressUDP.IsAllocated(idWithinVector) ||
-		   clientSortedByAddressUDP[idWithinVector].GetConnectedAddressUDP() != addr)
-		{
-			returnMe = 0;
-		}
-		else
-		{
-			returnMe = clientSortedByAddressUDP[idWithinVector].GetClientID();
-		}
-	}
-	catch(ErrorReport & Error){	clientSortedByAddressUDP.Leave(); throw(Error); }
-	catch(...){ clientSortedByAddressUDP.Leave(); throw(-1); }
-		
-	clientSortedByAddressUDP.Leave();
+	clientByAddressUDP.Find(addr,returnMe);
 
 	return returnMe;
-
-	/* // OLD CODE <-- does work, but not as efficiently as above replacement.
-	size_t returnMe = 0;
-	for(size_t n = 1;n<client.Size();n++)
-	{
-		if(ClientConnected(n) != NetUtility::NOT_CONNECTED)
-		{
-			if(addr == client[n].GetConnectedAddressUDP())
-			{
-				returnMe = n;
-				break;
-			}
-		}
-	}
-	
-	return returnMe;
-	*/
 }
 
 
@@ -1255,19 +1465,108 @@ void NetInstanceServer::CompletionError(NetSocket * completionSocket, size_t cli
 		{
 			ErrorOccurred(clientID);
 		}
+		// ClientJoined will disconnect client once all TCP data has been used.
+		else
+		{
+			clientClosingGracefully.Add(clientID);
+		}
 	}
 }
 
+/**
+ * @brief Performs part of the @ref handshakePage "handshaking process" using a UDP datagram
+ * received from an address that is not stored under any connected client ID.
+ *
+ * If the datagram is invalid it is ignored silently.
+ *
+ * @param datagram Received datagram, its length is the length of the WSABUF.
+ * @param from Address that @a datagram was received from.
+ */
+void NetInstanceServer::HandshakeUDP(const WSABUF & datagram, const NetAddress & from)
+{
+	try
+	{
+		// Interface with packet using Packet class
+		// newPacket and socket's WSABUF are now linked.
+		Packet newPacket;
+		newPacket.SetDataPtr(datagram.buf,datagram.len,datagram.len);
+
+		/**
+		 * Discard prefix.
+		 *
+		 * We do this because after connection there may be connection UDP packets that are received.
+		 * The prefix is always 0 which allows us to differentiate between connection
+		 * packets and normal packets.
+		 */
+		newPacket.GetSizeT();
+
+		// Determine what client this UDP packet claims to be from
+		size_t clientID = newPacket.GetSizeT();
+
+		// If clientID is out of bounds then ignore packet
+		ValidateClientID(clientID,__LINE__,__FILE__);
+
+		// Authenticate client
+		// We need to add the address later, but must take control of lock
+		// in this order always, to avoid deadlock.
+		clientByAddressUDP.Enter();
+		try
+		{
+			// Take control in case multiple threads reach this point at the same time
+			client[clientID].Enter(); 
+
+			try
+			{
+				_ErrorException((client[clientID].GetConnectionState() != NetUtility::CONNECTING),"handshaking with a client, client ID specified is not connecting",0,__LINE__,__FILE__);
+
+				vector<int> connectCode;
+				connectCode.resize(NetUtility::authenticationStrength);
+				for(size_t n = 0;n<connectCode.size();n++)
+				{
+					connectCode[n] = newPacket.Get<int>();
+				}
+
+				_ErrorException((client[clientID].Authenticate(connectCode) == false),"handshaking with a client, client failed to authenticate",0,__LINE__,__FILE__);
+				
+				try
+				{
+					// Finish setting up client by finalizing its UDP configuration
+					// Note that LoadUDP changes the connection status of the client.
+					// Ensure this is the last thing done so that connection state changes last.
+					// ClientJoined will send confirmation to client.
+					client[clientID].LoadUDP(from);
+				}
+				catch(ErrorReport & Error){	ErrorOccurred(clientID); throw(Error); }
+				catch(...){ ErrorOccurred(clientID); throw(-1); }
+
+				// Not in above try/catch because not client specific.
+				clientByAddressUDP.Add(from,clientID);
+			}
+			// Release control of all objects before throwing final exception
+			catch(ErrorReport & Error){	client[clientID].Leave(); throw(Error); }
+			catch(...){ client[clientID].Leave(); throw(-1); }
+			client[clientID].Leave();
+
+		}
+		catch(ErrorReport & Error){	clientByAddressUDP.Leave(); throw(Error); }
+		catch(...){ clientByAddressUDP.Leave(); throw(-1); }
+		clientByAddressUDP.Leave();	
+	}
+	// If an exception occurs then ignore packet silently
+	catch(ErrorReport & error){}
+}
+
 /**
  * @brief When send and receive operations are completed on this instance, this method is called.
  * When data is received from an unlisted UDP address, i.e. An address that is not stored
  * under any connected client ID, this method performs part of the @ref handshakePage "handshaking process".
  * 
  * @param socket [in,out] Socket that operation was started by.
+ * @param overlapped Overlapped object of the operation.
  * @param bytes Number of bytes of data transferred in operation.
  * @param clientID ID of client that owns socket.
  */
-void NetInstanceServer::DealCompletion(NetSocket * socket, DWORD bytes, size_t clientID)
+void NetInstanceServer::DealCompletion(NetSocket * socket, const WSAOVERLAPPED * overlapped, DWORD bytes, size_t clientID)
 {
 	switch(socket->GetProtocol())
 	{
@@ -1275,91 +1574,53 @@ void NetInstanceServer::DealCompletion(NetSocket * socket, DWORD bytes, size_t c
 		{
 			NetSocketUDP * completionSocket = static_cast<NetSocketUDP*>(socket);
 
-			size_t clientID = FindClientByAddressUDP(completionSocket->GetRecvAddress());
-			bool clientAlreadyConnected = (clientID > 0);
-			if(clientAlreadyConnected)
+			size_t amount = completionSocket->Received(overlapped,bytes);
+			const WSABUF * datagrams = completionSocket->GetRecvDatagrams(overlapped);
+
+			// Datagrams are dealt with in runs from the same address, so that
+			// a batch from one client is passed to its UDP mode together.
+			size_t n = 0;
+			size_t runClientID = 0;
+			if(amount > 0)
 			{
-				try
-				{
-					completionSocket->DealWithData(completionSocket->recvBuffer,bytes,completionSocket->GetRecvFunction(),clientID,this->GetInstanceID());
-				}
-				// Disconnect client in the event of an error
-				catch(ErrorReport & error){	ErrorOccurred(clientID); }
-				catch(...){ ErrorOccurred(clientID);}
+				runClientID = FindClientByAddressUDP(completionSocket->GetRecvAddress(overlapped,0));
 			}
-			// !clientAlreadyConnected
-			else
+
+			while(n < amount)
 			{
-				try
+				size_t runEnd = n+1;
+				size_t nextClientID = 0;
+				for(;runEnd<amount;runEnd++)
 				{
-					// Interface with packet using Packet class
-					// newPacket and socket's WSABUF are now linked.
-					Packet newPacket;
-					newPacket.SetDataPtr(completionSocket->recvBuffer.buf,bytes,bytes);
-
-					/**
-					 * Discard prefix.
-					 *
-					 * We do this because after connection there may be connection UDP packets that are received.
-					 * The prefix is always 0 which allows us to differentiate between connection
-					 * packets and normal packets.
-					 */
-					newPacket.GetSizeT();
-
-					// Determine what client this UDP packet claims to be from
-					size_t clientID = newPacket.GetSizeT();
-
-					// If clientID is out of bounds then ignore packet
-					ValidateClientID(clientID,__LINE__,__FILE__);
-
-					// Authenticate client
-					// We need to resort later, but must take control of lock
-					// in this order always, to avoid deadlock.
-					clientSortedByAddressUDP.Enter();
-					try
+					nextClientID = FindClientByAddressUDP(completionSocket->GetRecvAddress(overlapped,runEnd));
+					if(nextClientID != runClientID)
 					{
-						// Take control in case multiple threads reach this point at the same time
-						client[clientID].Enter(); 
-
-						try
-						{
-							_ErrorException((client[clientID].GetConnectionState() != NetUtility::CONNECTING),"handshaking with a client, client ID specified is not connecting",0,__LINE__,__FILE__);
-
-							vector<int> connectCode;
-							connectCode.resize(NetUtility::authenticationStrength);
-							for(size_t n = 0;n<connectCode.size();n++)
-							{
-								connectCode[n] = newPacket.Get<int>();
-							}
-
-							_ErrorException((client[clientID].Authenticate(connectCode) == false),"handshaking with a client, client failed to authenticate",0,__LINE__,__FILE__);
-							
-							try
-							{
-								// Finish setting up client by finalizing its UDP configuration
-								// Note that LoadUDP changes the connection status of the client.
-								// Ensure this is the last thing done so that connection state changes last.
-								// ClientJoined will send confirmation to client.
-								client[clientID].LoadUDP(completionSocket->GetRecvAddress());
-							}
-							catch(ErrorReport & Error){	ErrorOccurred(clientID); throw(Error); }
-							catch(...){ ErrorOccurred(clientID); throw(-1); }
-
-							// Not in above try/catch because not client specific.
-							RequestResortClientsByAddressUDP();
-						}
-						// Release control of all objects before throwing final exception
-						catch(ErrorReport & Error){	client[clientID].Leave(); throw(Error); }
-						catch(...){ client[clientID].Leave(); throw(-1); }
-						client[clientID].Leave();
+						break;
+					}
+				}
 
+				bool clientAlreadyConnected = (runClientID > 0);
+				if(clientAlreadyConnected)
+				{
+					try
+					{
+						completionSocket->DealWithDataBatch(&datagrams[n],NULL,runEnd-n,completionSocket->GetRecvFunction(),runClientID,this->GetInstanceID());
+					}
+					// Disconnect client in the event of an error
+					catch(ErrorReport & error){	ErrorOccurred(runClientID); }
+					catch(...){ ErrorOccurred(runClientID);}
+				}
+				// !clientAlreadyConnected
+				else
+				{
+					for(size_t d = n;d<runEnd;d++)
+					{
+						HandshakeUDP(datagrams[d],completionSocket->GetRecvAddress(overlapped,d));
 					}
-					catch(ErrorReport & Error){	clientSortedByAddressUDP.Leave(); throw(Error); }
-					catch(...){ clientSortedByAddressUDP.Leave(); throw(-1); }
-					clientSortedByAddressUDP.Leave();	
 				}
-				// If an exception occurs then ignore packet silently
-				catch(ErrorReport & error){}
+
+				n = runEnd;
+				runClientID = nextClientID;
 			}
 		}
 		break;
@@ -1374,7 +1635,7 @@ void NetInstanceServer::DealCompletion(NetSocket * socket, DWORD bytes, size_t c
 				if(client[clientID].GetConnectionState() != NetUtility::NOT_CONNECTED)
 				{
 					// Deal with received data
-					completionSocket->DealWithData(completionSocket->recvBuffer,bytes,completionSocket->GetRecvFunction(),clientID,this->GetInstanceID());
+					completionSocket->DealWithData(completionSocket->GetRecvBuffer(overlapped),bytes,completionSocket->GetRecvFunction(),clientID,this->GetInstanceID());
 				}
 			}
 			// Disconnect client in the event of an error
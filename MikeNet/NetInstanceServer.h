@@ -1,6 +1,5 @@
 #pragma once
 #include "Counter.h"
-#include "ComparatorServerClientFindByAddressUDP.h"
 
 /**
  * @brief	Server instance, designed to communicate with clients.
@@ -43,37 +42,60 @@ private:
 	StoreVector<NetServerClient> client;
 
 	/**
-	 * @brief Client data sorted by UDP address.
+	 * @brief Client IDs indexed by UDP address.
 	 *
 	 * This is necessary for quick searching of UDP addresses,
 	 * done every time a UDP packet is received to determine which
-	 * client it belongs to.
+	 * client it belongs to. Searching does not enter the critical section.
 	 *
 	 * When using multiple critical sections this lock should be
 	 * entered first, before client or any client in that vector.
 	 * This is important to prevent deadlock.
 	 */
-	StoreVector<NetServerClient> clientSortedByAddressUDP;
+	NetAddressMap clientByAddressUDP;
+
+	/** @brief Client IDs that are not in use, used as a stack. */
+	NetClientQueue unusedClients;
 
 	/**
-	 * @brief True when clientSortedByAddressUDP has changed and needs
-	 * to be resorted.
-	 * 
-	 * Protected by clientSortedByAddressUDP's critical section.
+	 * @brief Clients whose connection state has changed to NetUtility::DISCONNECTING
+	 * or NetUtility::CONNECTED_AC, which ClientJoined must act upon.
 	 */
-	bool clientSortedByAddressUdpNeedsResort;
+	NetClientQueue clientStateChanged;
 
 	/**
-	 * @brief Comparator used to sort clientSortedByAddressUDP, ordering
-	 * it by UDP address.
+	 * @brief Fully connected clients whose TCP connection is being gracefully closed.
+	 *
+	 * ClientJoined disconnects these clients once all TCP data has been used.
 	 */
-	ComparatorServerClientFindByAddressUDP comparatorSort;
+	NetClientQueue clientClosingGracefully;
+
+	/** @brief Deadlines of clients that are connecting, so that ClientJoined can time them out. */
+	TimerWheel connectingClients;
 
 	/**
-	 * @brief Comparator used to search for a client with a specific.
-	 * UDP remote NetAddress within clientSOrtedByAddressUDP.
+	 * @brief Clients whose connection deadline has passed, filled by ClientJoined.
+	 *
+	 * Kept between calls so that its memory is reused instead of being allocated on each call.
 	 */
-	ComparatorServerClientFindByAddressUDP comparatorFind;
+	vector<size_t> connectingExpired;
+
+	/** @brief Controls access to NetInstanceServer::sendAllClientIDs and NetInstanceServer::sendAllAddresses. */
+	CriticalSection sendAllLock;
+
+	/**
+	 * @brief Clients that SendAllUDP() sends to, kept between calls so that its memory is reused.
+	 *
+	 * Protected by NetInstanceServer::sendAllLock.
+	 */
+	vector<size_t> sendAllClientIDs;
+
+	/**
+	 * @brief UDP addresses of NetInstanceServer::sendAllClientIDs, kept between calls so that its memory is reused.
+	 *
+	 * Protected by NetInstanceServer::sendAllLock.
+	 */
+	vector<const NetAddress*> sendAllAddresses;
 
 	/** @brief Maximum number of clients that can be connected to server at any one time. */
 	size_t maxClients;
@@ -97,6 +119,8 @@ private:
 	void ValidateClientID(size_t clientID, size_t line, const char * file) const;
 
 	size_t FindClientByAddressUDP(const NetAddress & addr);
+	void HandshakeUDP(const WSABUF & datagram, const NetAddress & from);
+	void SendAllSharedTCP(const Packet & packet, NetSendPayload * payload, size_t excludeClient);
 public:
 
 	NetInstanceServer(size_t maxClients, NetSocketListening * listeningSocket, NetSocketUDP * socketUDP, bool handshakeEnabled, unsigned int sendTimeout = INFINITE, size_t connectionTimeout = DEFAULT_CONNECTION_TIMEOUT, size_t instanceID = 0);
@@ -152,8 +176,13 @@ public:
 
 	size_t GetPacketFromStoreTCP(Packet * destination, size_t clientID);
 
+	using NetInstanceTCP::SendTCP;
 	NetUtility::SendStatus SendTCP(const Packet & packet, bool block, size_t clientID);
+	NetUtility::SendStatus SendSharedTCP(const Packet & packet, NetSendPayload * payload, size_t clientID);
+	NetUtility::SendStatus SendChainTCP(const PacketChain & chain, size_t clientID);
 	void SendAllTCP(const Packet & packet, bool block, size_t clientExclude);
+	void SendAllTCP(Packet && packet, bool block, size_t clientExclude);
+	void SendAllChainTCP(const PacketChain & chain, size_t clientExclude);
 
 	NetUtility::SendStatus SendUDP(const Packet & packet, bool block, size_t clientID);
 	void SendAllUDP(const Packet & packet, bool block, size_t clientExclude);
@@ -167,7 +196,7 @@ public:
 	bool GetNagleEnabledTCP() const;
 	const Packet & GetPostfixTCP() const;
 
-	void DealCompletion(NetSocket * socket, DWORD bytes, size_t clientID);
+	void DealCompletion(NetSocket * socket, const WSAOVERLAPPED * overlapped, DWORD bytes, size_t clientID);
 
 	NetUtility::ConnectionStatus GetConnectionStateTCP(size_t clientID) const;
 
@@ -186,8 +215,5 @@ public:
 	size_t GetSendMemorySizeTCP(size_t clientID) const;
 	size_t GetRecvMemorySizeTCP(size_t clientID) const;
 
-private:
-	void RequestResortClientsByAddressUDP();
-
 public:
 };
@@ -40,3 +40,51 @@ bool NetInstanceTCP::ValidateRecvSizeTCP(size_t size) const
 {
 	return(size >= GetRecvSizeMinTCP());
 }
+
+/**
+ * @brief Sends a packet via TCP to the specified client, taking the packet's memory instead of copying it where possible.
+ *
+ * Asynchronous send operations need their own copy of the data. Packets larger than NetSend::INLINE_BUFFER_LENGTH
+ * give their memory to the send operation instead (see NetSendPayload), so @a packet is left with no memory.
+ * Smaller packets are copied into the send operation without any memory being allocated, and keep their memory.\n\n
+ *
+ * In all cases @a packet is empty when this method returns. If an exception is thrown @a packet keeps its data.
+ *
+ * @param [in,out] packet Packet to send.
+ * @param block If true the method will not return until @a packet is completely sent, note that this does not indicate that
+ * the packet has been received by the recipient, instead it simply means the packet is in transit.\n
+ * If false the method will return instantly even if the packet has not been sent.
+ * @param clientID ID of client to send to, may be ignored.
+ *
+ * @return NetUtility::SEND_COMPLETED If the send operation completed successfully instantly.
+ * @return NetUtility::SEND_IN_PROGRESS If the send operation was started, but has not yet completed.
+ * @return NetUtility::SEND_FAILED If the send operation failed.
+ * @return NetUtility::SEND_FAILED_KILL If the send operation failed and an entity was killed as a result (e.g. Client disconnected).
+ */
+NetUtility::SendStatus NetInstanceTCP::SendTCP(Packet && packet, bool block, size_t clientID)
+{
+	NetUtility::SendStatus returnMe;
+
+	if(block == true || packet.GetUsedSize() <= NetSend::INLINE_BUFFER_LENGTH || packet.IsDataPtrChanged() == true)
+	{
+		returnMe = SendTCP(static_cast<const Packet &>(packet),block,clientID);
+		packet.Clear();
+	}
+	else
+	{
+		// Packet's memory is only taken once the send operation has been started
+		NetSendPayload * payload = new (nothrow) NetSendPayload(&packet);
+		Utility::DynamicAllocCheck(payload,__LINE__,__FILE__);
+
+		try
+		{
+			returnMe = SendSharedTCP(packet,payload,clientID);
+			payload->TakeMemory();
+		}
+		catch(ErrorReport & error){ payload->ReturnMemory(); payload->Release(); throw error; }
+		catch(...){ payload->ReturnMemory(); payload->Release(); throw -1; }
+		payload->Release();
+	}
+
+	return returnMe;
+}
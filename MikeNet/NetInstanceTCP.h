@@ -224,6 +224,35 @@ public:
 	 */
 	virtual NetUtility::SendStatus SendTCP(const Packet & packet, bool block, size_t clientID) = 0;
 
+	/**
+	 * @brief Sends a packet asynchronously via TCP to the specified client, sharing a copy of its data with other send operations.
+	 *
+	 * @param packet Packet to send.
+	 * @param [in] payload Copy of @a packet's data, see NetSendPayload.
+	 * @param clientID ID of client to send to, may be ignored.
+	 *
+	 * @return NetUtility::SEND_COMPLETED If the send operation completed successfully instantly.
+	 * @return NetUtility::SEND_IN_PROGRESS If the send operation was started, but has not yet completed.
+	 * @return NetUtility::SEND_FAILED If the send operation failed.
+	 * @return NetUtility::SEND_FAILED_KILL If the send operation failed and an entity was killed as a result (e.g. Client disconnected).
+	 */
+	virtual NetUtility::SendStatus SendSharedTCP(const Packet & packet, NetSendPayload * payload, size_t clientID) = 0;
+
+	/**
+	 * @brief Sends a packet chain asynchronously via TCP to the specified client, without copying its segments.
+	 *
+	 * @param chain Packet data to send, see PacketChain.
+	 * @param clientID ID of client to send to, may be ignored.
+	 *
+	 * @return NetUtility::SEND_COMPLETED If the send operation completed successfully instantly.
+	 * @return NetUtility::SEND_IN_PROGRESS If the send operation was started, but has not yet completed.
+	 * @return NetUtility::SEND_FAILED If the send operation failed.
+	 * @return NetUtility::SEND_FAILED_KILL If the send operation failed and an entity was killed as a result (e.g. Client disconnected).
+	 */
+	virtual NetUtility::SendStatus SendChainTCP(const PacketChain & chain, size_t clientID) = 0;
+
+	NetUtility::SendStatus SendTCP(Packet && packet, bool block, size_t clientID);
+
 	/**
 	 * @brief Retrieves the state that the TCP connection is in.
 	 *
@@ -152,6 +152,21 @@ size_t NetInstanceUDP::GetRecvBufferLengthUDP() const
 	ValidateIsEnabledUDP(__LINE__,__FILE__);
 	return socketUDP->GetRecvBufferLength();
 }
+
+/**
+ * @brief Retrieves the average number of UDP packets received by each receive system call.
+ *
+ * Values greater than 1 indicate that batched receiving is in effect, see NetInstanceProfile::SetRecvBatchUDP.
+ *
+ * @return the average number of packets per receive call, 0 if nothing has been received.
+ *
+ * @throws ErrorReport If UDP is disabled.
+ */
+double NetInstanceUDP::GetRecvPacketsPerCallUDP() const
+{
+	ValidateIsEnabledUDP(__LINE__,__FILE__);
+	return socketUDP->GetRecvPacketsPerCall();
+}
 /**
  * @brief Calls GetRecvBufferLengthUDP(), included for consistency between TCP and UDP.
  *
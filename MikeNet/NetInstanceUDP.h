@@ -41,6 +41,7 @@ public:
 
 	size_t GetRecvBufferLengthUDP() const;
 	size_t GetMaxPacketSizeUDP() const;
+	double GetRecvPacketsPerCallUDP() const;
 	NetMode::ProtocolMode GetProtocolModeUDP() const;
 	virtual size_t GetPacketAmountUDP(size_t clientID=0, size_t operationID=0) const;
 
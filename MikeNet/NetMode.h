@@ -136,10 +136,11 @@ public:
 	 *
 	 * @param packet Packet to send.
 	 * @param block True if sending should be synchronous, false if sending should be asynchronous.
+	 * @param [in] pool Send object is taken from this pool where possible, and returned to it when no longer in use.
 	 *
 	 * @return a send object formatted for the specific protocol and mode.
 	 */
-	virtual NetSend * GetSendObject(const Packet * packet, bool block)=0;
+	virtual NetSend * GetSendObject(const Packet * packet, bool block, NetSendPool & pool)=0;
 
 	/**
 	 * @brief Retrieves the protocol mode in use.
@@ -11,8 +11,13 @@
  *
  * By default memory usage is unrestricted (referring to the use of SizeRestrictable class).
  */
-NetModeTcp::NetModeTcp(size_t partialPacketSize, bool autoResize) : autoResize(autoResize)
+NetModeTcp::NetModeTcp(size_t partialPacketSize, bool autoResize) : autoResize(autoResize), zeroCopy(false)
 {
+	recvRegionPending = false;
+	viewInUse = false;
+	memorySizeChangeDeferred = false;
+	deferredMemorySize = 0;
+
 	partialPacket.SetMemorySize(partialPacketSize);
 
 	// Memory recycle stores no packets, so essentially just uses new and delete.
@@ -35,8 +40,13 @@ NetModeTcp::NetModeTcp(size_t partialPacketSize, bool autoResize) : autoResize(a
  *
  * By default memory usage is unrestricted (referring to the use of SizeRestrictable class).
  */
-NetModeTcp::NetModeTcp(size_t partialPacketSize, bool autoResize, MemoryRecyclePacket * memoryRecycle) : autoResize(autoResize)
+NetModeTcp::NetModeTcp(size_t partialPacketSize, bool autoResize, MemoryRecyclePacket * memoryRecycle) : autoResize(autoResize), zeroCopy(false)
 {
+	recvRegionPending = false;
+	viewInUse = false;
+	memorySizeChangeDeferred = false;
+	deferredMemorySize = 0;
+
 	// Must load memory recycle before enforcing limits.
 	LoadMemoryRecycle(memoryRecycle);
 
@@ -52,10 +62,17 @@ NetModeTcp::NetModeTcp(size_t partialPacketSize, bool autoResize, MemoryRecycleP
 void NetModeTcp::Copy(const NetModeTcp & copyMe)
 {
 	this->autoResize = copyMe.autoResize;
+	this->zeroCopy = copyMe.zeroCopy;
 	this->partialPacket.SetMemorySize(copyMe.partialPacket.GetMemorySize()); // Memory size is not copied automatically
 	this->partialPacket = copyMe.partialPacket;
 	this->packetStore = copyMe.packetStore;
 
+	// No receive operation is using this object's partial packet yet
+	this->recvRegionPending = false;
+	this->viewInUse = false;
+	this->memorySizeChangeDeferred = false;
+	this->deferredMemorySize = 0;
+
 	MemoryRecyclePacket * recycle = new (nothrow) MemoryRecyclePacket(*copyMe.packetMemoryRecycle);
 	Utility::DynamicAllocCheck(recycle,__LINE__,__FILE__);
 	LoadMemoryRecycle(recycle);
@@ -155,12 +172,203 @@ size_t NetModeTcp::GetPacketAmount( size_t clientID, size_t operationID ) const
  * @note Attempting to decrease the size may not be effective. If data exists in the buffer
  * this will not be discarded. The buffer will decrease as much as possible without discarding data.
  *
+ * @note If a receive operation is writing into the region returned by GetRecvRegion(),
+ * or a receive function is using a view of the partial packet, then the change is applied
+ * when the partial packet is no longer in use.
+ *
  * @param newSize New size.
  */
 void NetModeTcp::ChangePartialPacketMemorySize(size_t newSize)
 {
 	this->EnforceMemoryLimit(GetPacketStoreMemorySize(),newSize);
-	partialPacket.ChangeMemorySize(newSize);
+
+	partialPacket.Enter();
+	try
+	{
+		if(IsPartialPacketInUse() == true)
+		{
+			memorySizeChangeDeferred = true;
+			deferredMemorySize = newSize;
+		}
+		else
+		{
+			partialPacket.ChangeMemorySize(newSize);
+		}
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){partialPacket.Leave(); throw(error);}
+	catch(...){partialPacket.Leave(); throw(-1);}
+	partialPacket.Leave();
+}
+
+/**
+ * @brief Determines whether memory of the partial packet is in use by a receive operation or
+ * receive function, so that it must not be reallocated.
+ *
+ * NetModeTcp::partialPacket's critical section must be held.
+ *
+ * @return true if the partial packet is in use.
+ */
+bool NetModeTcp::IsPartialPacketInUse() const
+{
+	return recvRegionPending == true || viewInUse == true;
+}
+
+/**
+ * @brief Applies a memory size change that was deferred by ChangePartialPacketMemorySize(),
+ * if the partial packet is no longer in use.
+ *
+ * NetModeTcp::partialPacket's critical section must be held.
+ */
+void NetModeTcp::ApplyDeferredMemorySize()
+{
+	if(memorySizeChangeDeferred == true && IsPartialPacketInUse() == false)
+	{
+		memorySizeChangeDeferred = false;
+		partialPacket.ChangeMemorySize(deferredMemorySize);
+	}
+}
+
+/**
+ * @brief Retrieves the free space at the end of the partial packet, so that
+ * a receive operation can write directly into it.
+ *
+ * Unread data is moved to the start of the partial packet if there are less than
+ * @a length bytes free after it. Received data must be passed to DealWithData()
+ * using the returned buffer, so that it is used without being copied. \n\n
+ *
+ * NetModeTcp::partialPacket will not be reallocated until DealWithData() is called.
+ *
+ * @param length Preferred minimum number of bytes that can be received.
+ *
+ * @return buffer to receive into, its length may be less than @a length.
+ *
+ * @throws ErrorReport If the partial packet is full and auto resize is disabled.
+ */
+WSABUF NetModeTcp::GetRecvRegion(size_t length)
+{
+	WSABUF returnMe;
+
+	partialPacket.Enter();
+	try
+	{
+		// Previous receive operation must have completed
+		recvRegionPending = false;
+		ApplyDeferredMemorySize();
+		DiscardReadData();
+
+		size_t usedSize = partialPacket.GetUsedSize();
+		size_t freeSize = partialPacket.GetMemorySize() - usedSize;
+
+		// Move unread data to the start only when the free space after it runs low
+		if(freeSize < length && partialPacket.GetCursor() > 0)
+		{
+			partialPacket.Erase(0, partialPacket.GetCursor());
+			usedSize = partialPacket.GetUsedSize();
+			freeSize = partialPacket.GetMemorySize() - usedSize;
+		}
+
+		// Partial packet is completely full of unread data
+		if(freeSize == 0)
+		{
+			if(!IsAutoResizeEnabled())
+			{
+				_ErrorException(true,"receiving new TCP data. The size of a newly received packet is larger than the TCP receive buffer",0,__LINE__,__FILE__);
+			}
+			else
+			{
+				// Increase memory size to accommodate incoming packet
+				ChangePartialPacketMemorySize(usedSize + length);
+				freeSize = partialPacket.GetMemorySize() - usedSize;
+			}
+		}
+
+		returnMe.buf = partialPacket.GetDataPtr() + usedSize;
+		returnMe.len = static_cast<DWORD>(freeSize);
+		recvRegionPending = true;
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){partialPacket.Leave(); throw(error);}
+	catch(...){partialPacket.Leave(); throw(-1);}
+	partialPacket.Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Determines whether data should be received directly into the partial packet using GetRecvRegion().
+ *
+ * @return true by default, modes that do not use the partial packet should return false
+ * so that data is received into the socket's receive buffer instead.
+ */
+bool NetModeTcp::IsRecvInPlace() const
+{
+	return true;
+}
+
+/**
+ * @brief Adds newly received data to the end of the partial packet.
+ *
+ * If @a buffer is the region returned by GetRecvRegion() then the data is already in place
+ * and only the used size changes. Otherwise the data is copied, increasing the memory size if
+ * necessary. NetModeTcp::partialPacket's critical section must be held.
+ *
+ * @param buffer Newly received data.
+ * @param completionBytes Number of bytes of new data stored in @a buffer.
+ */
+void NetModeTcp::AddRecvData(const WSABUF & buffer, size_t completionBytes)
+{
+	size_t usedSize = partialPacket.GetUsedSize();
+
+	if(recvRegionPending == true && buffer.buf == partialPacket.GetDataPtr() + usedSize)
+	{
+		_ErrorException((completionBytes > buffer.len),"receiving new TCP data, more data was received than the receive region can hold",0,__LINE__,__FILE__);
+
+		recvRegionPending = false;
+		partialPacket.SetUsedSize(usedSize + completionBytes);
+		ApplyDeferredMemorySize();
+	}
+	else
+	{
+		// Ensure that the unread data after data is received is not too large
+		size_t newSize = partialPacket.GetPacketRemainder() + completionBytes;
+		if(newSize > GetPartialPacketMemorySize())
+		{
+			if(!IsAutoResizeEnabled())
+			{
+				_ErrorException(true,"receiving new TCP data. The size of a newly received packet is larger than the TCP receive buffer",0,__LINE__,__FILE__);
+			}
+			else
+			{
+				// Increase memory size to accommodate incoming packet
+				ChangePartialPacketMemorySize(newSize);
+			}
+		}
+
+		// Make room after unread data
+		if(usedSize + completionBytes > GetPartialPacketMemorySize())
+		{
+			partialPacket.Erase(0, partialPacket.GetCursor());
+		}
+
+		partialPacket.addEqualWSABUF(buffer,completionBytes);
+	}
+}
+
+/**
+ * @brief Discards data that has been read, if no unread data remains.
+ *
+ * Resetting the partial packet does not move any data. Data that has been read
+ * but is followed by unread data is discarded later by GetRecvRegion() or AddRecvData(),
+ * only when space is needed. NetModeTcp::partialPacket's critical section must be held.
+ */
+void NetModeTcp::DiscardReadData()
+{
+	if(partialPacket.GetCursor() == partialPacket.GetUsedSize())
+	{
+		// Cursor is moved back to the start too
+		partialPacket.SetUsedSize(0);
+	}
 }
 
 /**
@@ -190,6 +398,32 @@ bool NetModeTcp::IsAutoResizeEnabled() const
 	return autoResize.Get();
 }
 
+/**
+ * @brief Enables or disables the 'zero copy' option.
+ *
+ * @param paraZeroCopy Value to set zeroCopy to. \n
+ * When true, complete packets are passed to receive functions as views of the received data,
+ * which are only valid until the receive function returns and must not be added to.
+ * Packets retrieved using GetPacketFromStore() take the memory of the stored packet,
+ * rather than it being copied.\n
+ * When false, complete packets are copied.
+ */
+void NetModeTcp::SetZeroCopy(bool paraZeroCopy)
+{
+	zeroCopy.Set(paraZeroCopy);
+}
+
+/**
+ * @brief Determines whether the 'zero copy' option is enabled.
+ *
+ * @return true if complete packets are passed to receive functions as views
+ * and moved out of the complete packet store, see SetZeroCopy().
+ */
+bool NetModeTcp::IsZeroCopyEnabled() const
+{
+	return zeroCopy.Get();
+}
+
 /**
  * @brief Deals with a complete packet.
  *
@@ -222,6 +456,94 @@ void NetModeTcp::PacketDone(Packet * completePacket, NetSocket::RecvFunc tcpRecv
 	}
 }
 
+/**
+ * @brief Deals with a complete packet that is stored in received data.
+ *
+ * If a receive function is specified and the 'zero copy' option is enabled, the receive function
+ * is passed a packet that points directly to @a packetData, which is only valid until it returns.
+ * Otherwise the packet is copied and passed to PacketDone(Packet*,NetSocket::RecvFunc). \n\n
+ *
+ * NetModeTcp::partialPacket's critical section must be held once by the caller. It is released while
+ * the receive function executes, so that other threads using this object do not wait for the user,
+ * and is held again when this method returns or throws.
+ *
+ * @param packetData Received data containing the packet.
+ * @param used Size of the packet.
+ * @param offset Position of the packet within @a packetData.
+ * @param [in] tcpRecvFunc Method will be executed and data not added to the queue if this is non NULL.
+ * @param clientID ID of client that data was received from, set to 0 if not applicable.
+ * @param instanceID Instance that data was received on.
+ */
+void NetModeTcp::PacketDone(const WSABUF & packetData, size_t used, size_t offset, NetSocket::RecvFunc tcpRecvFunc, size_t clientID, size_t instanceID)
+{
+	if(tcpRecvFunc != NULL && IsZeroCopyEnabled() == true)
+	{
+		// Access received data directly using Packet object
+		Packet view;
+		view.SetDataPtr(packetData.buf + offset,used,used);
+		view.SetClientFrom(clientID);
+		view.SetInstance(instanceID);
+
+		// Received data must not be reallocated until the user function returns,
+		// but the user function is not executed while holding the partial packet's lock
+		viewInUse = true;
+		partialPacket.Leave();
+		try
+		{
+			(*tcpRecvFunc)(view);
+		}
+		// Take back control of the partial packet before throwing final exception, the caller releases it
+		catch(ErrorReport & error){partialPacket.Enter(); viewInUse = false; throw(error);}
+		catch(...){partialPacket.Enter(); viewInUse = false; throw(-1);}
+		partialPacket.Enter();
+		viewInUse = false;
+
+		ApplyDeferredMemorySize();
+	}
+	else
+	{
+		Packet * completePacket = this->packetMemoryRecycle->GetPacket(used,this);
+		completePacket->LoadFull(packetData,used,offset,clientID,0,instanceID,0);
+
+		PacketDone(completePacket, tcpRecvFunc);
+	}
+}
+
+/**
+ * @brief Generates an asynchronous NetSend object that sends data shared with other send operations.
+ *
+ * Used when the same packet is sent to many recipients, so that its data is copied once.
+ * By default the shared data is ignored and GetSendObject() is used, which copies the packet.
+ *
+ * @param packet Packet to send, its data must be the same as @a payload's.
+ * @param [in] payload Copy of @a packet's data.
+ * @param [in] pool Send object is taken from this pool where possible.
+ *
+ * @return a send object.
+ */
+NetSend * NetModeTcp::GetSharedSendObject(const Packet * packet, NetSendPayload * payload, NetSendPool & pool)
+{
+	return GetSendObject(packet,false,pool);
+}
+
+/**
+ * @brief Generates an asynchronous NetSend object that sends the segments of a chain.
+ *
+ * By default the chain is copied into one packet and GetSendObject() is used.
+ *
+ * @param chain Packet data to send.
+ * @param [in] pool Send object is taken from this pool where possible.
+ *
+ * @return a send object.
+ */
+NetSend * NetModeTcp::GetChainSendObject(const PacketChain & chain, NetSendPool & pool)
+{
+	Packet flat;
+	chain.CopyInto(flat);
+
+	return GetSendObject(&flat,false,pool);
+}
+
 /**
  * @brief Retrieves the size of the largest packet that can be received without a change in memory size.
  *
@@ -234,19 +556,19 @@ size_t NetModeTcp::GetMaxPacketSize() const
 }
 
 /**
- * @brief Determines the amount of data currently stored in
+ * @brief Determines the amount of unread data currently stored in
  * the partial packet.
  *
  * When used outside of the DealWithData method, this
  * retrieves the size of the packet currently being received.
  *
- * @return the amount of data currently stored in the partial packet.
+ * @return the amount of unread data currently stored in the partial packet.
  * Normally this is the current size of the partial packet being received.
  * i.e. The number of bytes of the packet that have been received.
  */
 size_t NetModeTcp::GetPartialPacketUsedSize() const
 {
-	return partialPacket.GetUsedSize();
+	return partialPacket.GetPacketRemainder();
 }
 
 /**
@@ -275,8 +597,20 @@ size_t NetModeTcp::GetPacketFromStore( Packet * destination, size_t clientID, si
 			// Extract packet from front of queue (removing it but not deallocating it).
 			Packet * extractedPacket = packetStore.ExtractFront();
 
-			// Copy packet to destination.
-			*destination = *extractedPacket;
+			if(IsZeroCopyEnabled() == true && destination->IsDataPtrChanged() == false)
+			{
+				// Destination takes the packet's memory, and its old memory is recycled instead.
+				// The memory recycle no longer owns the memory that was handed over.
+				size_t handedOver = extractedPacket->GetMemorySize();
+				destination->Swap(*extractedPacket);
+				this->packetMemoryRecycle->DecreaseMemorySize(handedOver);
+				this->packetMemoryRecycle->IncreaseMemorySize(extractedPacket->GetMemorySize());
+			}
+			else
+			{
+				// Copy packet to destination.
+				*destination = *extractedPacket;
+			}
 			
 			// Cleanup memory or recycle memory.
 			this->packetMemoryRecycle->RecyclePacket(extractedPacket);
@@ -363,7 +697,7 @@ public:
 	/**
 	 * @brief Constructor.
 	 *
-	 * Adds an integer to partial packet for testing purposes.
+	 * Adds an unread integer to partial packet for testing purposes.
 	 *
 	 * @param partialPacketSize Maximum amount of partial data (data that does not make up a full packet) that can be stored (in bytes).
 	 * Packets larger than this size cannot be received without memory reallocation.
@@ -373,6 +707,7 @@ public:
 	TestClassNetModeTcp(size_t partialPacketSize, bool autoResize) : NetModeTcp(partialPacketSize, autoResize)
 	{
 		partialPacket.Add<int>(5000);
+		partialPacket.SetCursor(0);
 	}
 
 	/** 
@@ -400,10 +735,11 @@ public:
 	 *
 	 * @param packet Packet to send.
 	 * @param block True if sending should be synchronous, false if sending should be asynchronous.
+	 * @param [in] pool Ignored.
 	 *
 	 * @return NULL.
 	 */
-	NetSend * GetSendObject(const Packet * packet, bool block)
+	NetSend * GetSendObject(const Packet * packet, bool block, NetSendPool & pool)
 	{
 		return NULL;
 	}
@@ -497,6 +833,26 @@ bool NetModeTcp::TestClass()
 	{
 		cout << "ClearPacketStore is good\n";
 	}
+
+	// Packet memory is handed over rather than copied
+	obj.SetZeroCopy(true);
+	packet = obj.packetMemoryRecycle->GetPacket(100);
+	packet->AddStringC("zero copy",0,false);
+	const char * storedData = packet->GetDataPtr();
+	obj.PacketDone(packet,NULL);
+
+	Packet destination;
+	obj.GetPacketFromStore(&destination);
+	if(destination != "zero copy" || destination.GetDataPtr() != storedData || obj.GetPacketAmount() != 0)
+	{
+		cout << "GetPacketFromStore (zero copy) is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "GetPacketFromStore (zero copy) is good\n";
+	}
+	obj.SetZeroCopy(false);
 	
 	packet = obj.packetMemoryRecycle->GetPacket(100);
 	packet->AddStringC("hello universe",0,false);
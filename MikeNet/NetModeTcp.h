@@ -12,6 +12,12 @@
  * a queue or passed to a user supplied function. Classes derived from this
  * object decide how exactly this process is implemented. \n\n
  *
+ * The partial buffer is used as a ring: data is read from the cursor and received
+ * at the used size, so dealing with complete packets does not move the remaining data.
+ * Receive operations can write directly into the partial buffer using GetRecvRegion().
+ * Unread data is only moved to the start of the buffer when there is not enough free space
+ * after it, and the buffer is reset for free when all data has been read. \n\n
+ *
  * This class is thread safe.
  */
 class NetModeTcp : public NetMode, public MemoryUsageRestricted
@@ -40,9 +46,48 @@ protected:
 	 * Protected by critical section so that it can be changed during runtime.
 	 */
 	ConcurrentObject<bool> autoResize;
+
+	/**
+	 * @brief True while a receive operation may be writing into the region returned by GetRecvRegion().
+	 *
+	 * NetModeTcp::partialPacket must not be reallocated while this is true.
+	 * Protected by NetModeTcp::partialPacket's critical section.
+	 */
+	bool recvRegionPending;
+
+	/**
+	 * @brief True while a receive function is using a view of NetModeTcp::partialPacket, see PacketDone().
+	 *
+	 * NetModeTcp::partialPacket must not be reallocated while this is true.
+	 * Protected by NetModeTcp::partialPacket's critical section.
+	 */
+	bool viewInUse;
+
+	/** @brief True if ChangePartialPacketMemorySize() was called while NetModeTcp::partialPacket was in use. */
+	bool memorySizeChangeDeferred;
+
+	/** @brief Memory size to apply when the pending receive operation completes, see NetModeTcp::memorySizeChangeDeferred. */
+	size_t deferredMemorySize;
+
+	/**
+	 * @brief If true, complete packets are passed to receive functions as views of received data
+	 * and packets are moved rather than copied out of the complete packet store.
+	 *
+	 * Protected by critical section so that it can be changed during runtime.
+	 */
+	ConcurrentObject<bool> zeroCopy;
+
+	void AddRecvData(const WSABUF & buffer, size_t completionBytes);
+	void DiscardReadData();
+	void PacketDone(const WSABUF & packetData, size_t used, size_t offset, NetSocket::RecvFunc tcpRecvFunc, size_t clientID, size_t instanceID);
+private:
+	bool IsPartialPacketInUse() const;
+	void ApplyDeferredMemorySize();
 public:
 	void SetAutoResize(bool autoResize);
 	bool IsAutoResizeEnabled() const;
+	void SetZeroCopy(bool zeroCopy);
+	bool IsZeroCopyEnabled() const;
 
 	NetModeTcp(size_t partialPacketSize, bool autoResize);
 	virtual ~NetModeTcp();
@@ -77,14 +122,20 @@ public:
 	size_t GetMaxPacketSize() const;
 	size_t GetPartialPacketMemorySize() const;
 	void ChangePartialPacketMemorySize(size_t newSize);
+
+	WSABUF GetRecvRegion(size_t length);
+	virtual bool IsRecvInPlace() const;
 	
 	size_t GetPacketStoreMemorySize() const;
 	
 	void ClearPacketStore();
-	void ClearData();
+	virtual void ClearData();
 
 	size_t GetPacketFromStore(Packet * destination, size_t clientID=0, size_t operationID=0);
 	void PacketDone(Packet * completePacket, NetSocket::RecvFunc tcpRecvFunc);
+
+	virtual NetSend * GetSharedSendObject(const Packet * packet, NetSendPayload * payload, NetSendPool & pool);
+	virtual NetSend * GetChainSendObject(const PacketChain & chain, NetSendPool & pool);
 	
 	size_t GetMemorySize() const;
 
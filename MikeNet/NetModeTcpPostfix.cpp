@@ -13,6 +13,7 @@ class NetSocketTCP;
 NetModeTcpPostfix::NetModeTcpPostfix(size_t partialPacketSize, bool autoResize, const Packet & packetPostfix) : NetModeTcp(partialPacketSize, autoResize)
 {
 	postfix = packetPostfix;
+	searchedBytes = 0;
 }
 
 /**
@@ -29,6 +30,7 @@ NetModeTcpPostfix::NetModeTcpPostfix(size_t partialPacketSize, bool autoResize,
 NetModeTcpPostfix::NetModeTcpPostfix(size_t partialPacketSize, bool autoResize, const Packet & packetPostfix, MemoryRecyclePacket * memoryRecycle) : NetModeTcp(partialPacketSize, autoResize, memoryRecycle)
 {
 	postfix = packetPostfix;
+	searchedBytes = 0;
 }
 
 /**
@@ -39,6 +41,7 @@ NetModeTcpPostfix::NetModeTcpPostfix(size_t partialPacketSize, bool autoResize,
 NetModeTcpPostfix::NetModeTcpPostfix(const NetModeTcpPostfix & copyMe) : NetModeTcp(copyMe)
 {
 	postfix = copyMe.postfix;
+	searchedBytes = copyMe.searchedBytes;
 }
 
 /**
@@ -52,6 +55,7 @@ NetModeTcpPostfix & NetModeTcpPostfix::operator= (const NetModeTcpPostfix & copy
 {
 	NetModeTcp::operator=(copyMe);
 	this->postfix = copyMe.postfix;
+	this->searchedBytes = copyMe.searchedBytes;
 	return *this;
 }
 
@@ -82,37 +86,53 @@ void NetModeTcpPostfix::DealWithData(const WSABUF & buffer, size_t completionByt
 	partialPacket.Enter();
 	try
 	{
-		// Size after data received
-		size_t newSize = GetPartialPacketUsedSize() + completionBytes;
-
-		// Ensure that size is not too large
-		if(newSize > GetPartialPacketMemorySize())
-		{
-			if(!IsAutoResizeEnabled())
-			{
-				_ErrorException(true,"receiving new TCP data. The size of a newly received packet is larger than the TCP receive buffer",0,__LINE__,__FILE__);
-			}
-			else
-			{
-				// Increase memory size to accommodate incoming packet
-				ChangePartialPacketMemorySize(newSize);
-			}
-		}
-
 		// Add new bytes to the incomplete packet store
-		// Added onto the end, denoted by used size
-		partialPacket.addEqualWSABUF(buffer,completionBytes);
+		// Added onto the end, denoted by used size, without copying if they were received directly into it
+		AddRecvData(buffer,completionBytes);
 
 		// If there are any complete packets in the incomplete packet store then move them into the user buffer
 ReCheck:
 
 		// Search for postfix because this indicates the end of a packet
-		// Returned will be pointer to the START of postfix within sData
+		// Bytes that have already been searched are skipped
+		size_t cursor = partialPacket.GetCursor();
+		size_t unread = partialPacket.GetUsedSize() - cursor;
+		if(searchedBytes > unread)
+		{
+			searchedBytes = 0;
+		}
+
 		size_t endPos = 0;
+		size_t position = 0;
 		bool found = false;
-		if(partialPacket.GetCursor() != GetPartialPacketUsedSize())
+		if(unread > searchedBytes)
+		{
+			found = Utility::FindBytes(partialPacket.GetDataPtr() + cursor + searchedBytes, unread - searchedBytes, postfix.GetDataPtr(), postfix.GetUsedSize(), position);
+		}
+
+		if(found == true)
 		{
-			found = partialPacket.Find(partialPacket.GetCursor(),0,postfix,&endPos);
+			// Position of the START of postfix within partial packet
+			endPos = cursor + searchedBytes + position;
+			searchedBytes = 0;
+		}
+		else
+		{
+			// The start of the postfix may be in the last few bytes, with the rest still to be received
+			size_t overlap = 0;
+			if(postfix.GetUsedSize() > 0)
+			{
+				overlap = postfix.GetUsedSize() - 1;
+			}
+
+			if(unread > overlap)
+			{
+				searchedBytes = unread - overlap;
+			}
+			else
+			{
+				searchedBytes = 0;
+			}
 		}
 		
 		if(found == true)
@@ -136,20 +156,16 @@ ReCheck:
 			// operations can succeed, and overwrite the bad data.
 			partialPacket.IncCursor(packetSize + postfix.GetUsedSize());
 
-			Packet * completePacket = this->packetMemoryRecycle->GetPacket(used,this);
-			completePacket->LoadFull(packetData,used,offset,clientID,0,instanceID,0);
-
 			// Add packet to packet store or pass it to user function
-			PacketDone(completePacket, tcpRecvFunc);
+			PacketDone(packetData, used, offset, tcpRecvFunc, clientID, instanceID);
 
 			// Recheck to see if any other completed packets exist in the TCP buffer
 			goto ReCheck;
 		}
 
-		// Erase packets that we've dealt (without changing memory size)
-		// Do this after all packets have been dealt with because it is more efficient
-		// to erase multiple packets at the same time, rather than each one individually
-		partialPacket.Erase(0, partialPacket.GetCursor());
+		// Packets that we've dealt with are left in place, the cursor has moved past them.
+		// Data is only moved when space is needed, see GetRecvRegion.
+		DiscardReadData();
 	}
 	// Release control of all objects before throwing final exception
 	catch(ErrorReport & Error){ partialPacket.Leave(); throw(Error); }
@@ -163,15 +179,40 @@ ReCheck:
  *
  * @param packet Packet to send.
  * @param block True if sending should be synchronous, false if sending should be asynchronous.
+ * @param [in] pool Send object is taken from this pool where possible.
  *
  * @return a send object.
  */
-NetSend * NetModeTcpPostfix::GetSendObject(const Packet * packet, bool block)
+NetSend * NetModeTcpPostfix::GetSendObject(const Packet * packet, bool block, NetSendPool & pool)
 {
-	NetSend * sendObject = new (nothrow) NetSendPostfix(packet,block,&postfix);
-	Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
+	return pool.GetPostfix(packet,block,&postfix);
+}
 
-	return sendObject;
+/**
+ * @brief Generates an asynchronous NetSend object that sends data shared with other send operations.
+ *
+ * @param packet Packet to send.
+ * @param [in] payload Copy of @a packet's data.
+ * @param [in] pool Send object is taken from this pool where possible.
+ *
+ * @return a send object.
+ */
+NetSend * NetModeTcpPostfix::GetSharedSendObject(const Packet * packet, NetSendPayload * payload, NetSendPool & pool)
+{
+	return pool.GetShared(payload,NULL,&postfix);
+}
+
+/**
+ * @brief Generates an asynchronous NetSend object that sends the segments of a chain without copying them.
+ *
+ * @param chain Packet data to send.
+ * @param [in] pool Send object is taken from this pool where possible.
+ *
+ * @return a send object.
+ */
+NetSend * NetModeTcpPostfix::GetChainSendObject(const PacketChain & chain, NetSendPool & pool)
+{
+	return pool.GetShared(chain,NULL,&postfix);
 }
 
 /**
@@ -199,6 +240,25 @@ double NetModeTcpPostfix::GetPartialPacketPercentage() const
 	return 0.0;
 }
 
+/**
+ * @brief Erases all stored TCP data.
+ *
+ * The object will now be in the same state as if it were newly constructed.
+ */
+void NetModeTcpPostfix::ClearData()
+{
+	partialPacket.Enter();
+	try
+	{
+		NetModeTcp::ClearData();
+		searchedBytes = 0;
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & Error){ partialPacket.Leave(); throw(Error); }
+	catch(...){	partialPacket.Leave(); throw(-1); }
+	partialPacket.Leave();
+}
+
 /**
  * @brief Retrieves the postfix in use, which indicates the end of a packet.
  *
@@ -209,6 +269,128 @@ const Packet & NetModeTcpPostfix::GetPostfix() const
 	return postfix;
 }
 
+/** @brief Number of packets passed to NetModeTcpPostfixBenchmarkRecv(). */
+static size_t benchmarkPacketsReceived = 0;
+
+/** @brief Total size of packets passed to NetModeTcpPostfixBenchmarkRecv(). */
+static size_t benchmarkBytesReceived = 0;
+
+/**
+ * @brief Receive function used by NetModeTcpPostfixBenchmark(), counts packets.
+ *
+ * @param packet Complete packet.
+ */
+static void NetModeTcpPostfixBenchmarkRecv(Packet & packet)
+{
+	benchmarkPacketsReceived++;
+	benchmarkBytesReceived += packet.GetUsedSize();
+}
+
+/**
+ * @brief Compares searching for the postfix using Packet::Find from the cursor after every receive,
+ * with the resumable search used by NetModeTcpPostfix::DealWithData.
+ *
+ * @param packets Number of packets to stream.
+ * @param packetSize Size of each packet, not including postfix.
+ * @param recvSize Maximum number of bytes received by each receive operation.
+ *
+ * @return true if every packet was received intact using both methods.
+ */
+static bool NetModeTcpPostfixBenchmark(size_t packets, size_t packetSize, size_t recvSize)
+{
+	Packet postfix("\r\n");
+
+	// Stream of postfix framed packets, as it would arrive from the network
+	Packet stream;
+	stream.SetMemorySize(packets * (packetSize + postfix.GetUsedSize()));
+	for(size_t n = 0;n<packets;n++)
+	{
+		for(size_t i = 0;i<packetSize;i++)
+		{
+			stream.Add(static_cast<char>('a' + (i % 26)));
+		}
+		stream.Add('\r');
+		stream.Add('\n');
+	}
+	const size_t streamSize = stream.GetUsedSize();
+
+	// Search from the cursor with Packet::Find after every receive
+	Packet partialPacket;
+	partialPacket.SetMemorySize(recvSize * 2);
+	size_t findPackets = 0;
+	size_t findBytes = 0;
+
+	DWORD startTime = GetTickCount();
+	for(size_t position = 0;position<streamSize;)
+	{
+		size_t bytes = streamSize - position;
+		if(bytes > recvSize)
+		{
+			bytes = recvSize;
+		}
+
+		WSABUF buffer;
+		buffer.buf = stream.GetDataPtr() + position;
+		buffer.len = static_cast<DWORD>(bytes);
+		partialPacket.addEqualWSABUF(buffer,bytes);
+		position += bytes;
+
+		size_t endPos = 0;
+		while(partialPacket.GetCursor() != partialPacket.GetUsedSize() &&
+			  partialPacket.Find(partialPacket.GetCursor(),0,postfix,&endPos) == true)
+		{
+			size_t size = endPos - partialPacket.GetCursor();
+
+			WSABUF copyData;
+			copyData.buf = partialPacket.GetDataPtr() + partialPacket.GetCursor();
+			copyData.len = static_cast<DWORD>(size);
+			partialPacket.IncCursor(size + postfix.GetUsedSize());
+
+			Packet completePacket;
+			completePacket.LoadFull(copyData,size,0,0,0,0,0);
+			findPackets++;
+			findBytes += completePacket.GetUsedSize();
+		}
+
+		partialPacket.Erase(0,partialPacket.GetCursor());
+	}
+	DWORD findTime = GetTickCount() - startTime;
+
+	// Resumable search
+	NetModeTcpPostfix mode(recvSize * 2,true,postfix);
+	benchmarkPacketsReceived = 0;
+	benchmarkBytesReceived = 0;
+
+	startTime = GetTickCount();
+	for(size_t position = 0;position<streamSize;)
+	{
+		WSABUF region = mode.GetRecvRegion(recvSize);
+
+		size_t bytes = streamSize - position;
+		if(bytes > recvSize)
+		{
+			bytes = recvSize;
+		}
+		if(bytes > region.len)
+		{
+			bytes = region.len;
+		}
+		memcpy(region.buf,stream.GetDataPtr() + position,bytes); // Done by the kernel in practice
+		position += bytes;
+
+		mode.DealWithData(region,bytes,&NetModeTcpPostfixBenchmarkRecv,0,0);
+	}
+	DWORD searchTime = GetTickCount() - startTime;
+
+	cout << packets << " packets of " << packetSize << " bytes, " << recvSize << " byte receives:\n";
+	cout << " Packet::Find: " << findTime << "ms\n";
+	cout << " Resumable search: " << searchTime << "ms\n";
+
+	return findPackets == packets && findBytes == packets * packetSize &&
+		   benchmarkPacketsReceived == packets && benchmarkBytesReceived == packets * packetSize &&
+		   mode.GetPartialPacketUsedSize() == 0;
+}
+
 /**
  * @brief Tests class.
  *
@@ -444,6 +626,67 @@ bool NetModeTcpPostfix::TestClass()
 		cout << "DealWithData memory restriction failure " << obj.GetMemorySize() << "\n";
 	}
 
+	// Large packet received in pieces, with postfix split between two pieces
+	{
+		NetModeTcpPostfix large(16,true,postfix);
+
+		Packet largeData;
+		for(size_t n = 0;n<1000;n++)
+		{
+			largeData.Add(static_cast<char>('a' + (n % 26)));
+		}
+		largeData.Add('\r');
+
+		WSABUF piece;
+		size_t position = 0;
+		while(position < largeData.GetUsedSize())
+		{
+			piece.buf = largeData.GetDataPtr() + position;
+			piece.len = 100;
+			if(position + piece.len > largeData.GetUsedSize())
+			{
+				piece.len = static_cast<DWORD>(largeData.GetUsedSize() - position);
+			}
+			large.DealWithData(piece,piece.len,NULL,0,0);
+			position += piece.len;
+		}
+
+		bool partialGood = (large.GetPacketAmount() == 0 && large.GetPartialPacketUsedSize() == 1001);
+
+		char endData[] = "\nabc\r\n";
+		piece.buf = endData;
+		piece.len = 6;
+		large.DealWithData(piece,piece.len,NULL,0,0);
+
+		Packet first;
+		Packet second;
+		large.GetPacketFromStore(&first);
+		large.GetPacketFromStore(&second);
+		WSABUF expected;
+		expected.buf = largeData.GetDataPtr();
+		expected.len = 1000;
+
+		if(partialGood == false || first.compareWSABUF(expected,expected.len) == false || second != "abc" || large.GetPartialPacketUsedSize() != 0)
+		{
+			cout << "DealWithData is bad (split postfix)\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "DealWithData is good (split postfix)\n";
+		}
+	}
+
+	if(NetModeTcpPostfixBenchmark(200000,16,1024) == false || NetModeTcpPostfixBenchmark(4,256*1024,4096) == false)
+	{
+		cout << "Benchmark is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Benchmark is good\n";
+	}
+
 	cout << "\n\n";
 	return !problem;
 }
@@ -19,6 +19,15 @@ class NetModeTcpPostfix: public NetModeTcp
 	 * @brief Stores postfix used to indicate the end of a packet.
 	 */
 	Packet postfix;
+
+	/**
+	 * @brief Number of bytes after the partial packet's cursor that have already been searched
+	 * without finding the start of the postfix.
+	 *
+	 * When a large packet arrives over many receive operations, the search continues from here
+	 * instead of scanning the whole partial packet again each time.
+	 */
+	size_t searchedBytes;
 public:
 	NetModeTcpPostfix(size_t partialPacketSize, bool autoResize, const Packet & packetPostfix);
 	NetModeTcpPostfix(const NetModeTcpPostfix & copyMe);
@@ -28,12 +37,16 @@ public:
 
 	void DealWithData(const WSABUF & buffer, size_t completionBytes, NetSocket::RecvFunc tcpRecvFunc, size_t clientID, size_t instanceID);
 
-	NetSend * GetSendObject(const Packet * packet, bool block);
+	NetSend * GetSendObject(const Packet * packet, bool block, NetSendPool & pool);
+	NetSend * GetSharedSendObject(const Packet * packet, NetSendPayload * payload, NetSendPool & pool);
+	NetSend * GetChainSendObject(const PacketChain & chain, NetSendPool & pool);
 
 	ProtocolMode GetProtocolMode() const;
 
 	double GetPartialPacketPercentage() const;
 
+	void ClearData();
+
 	const Packet & GetPostfix() const;
 	
 	static bool TestClass();
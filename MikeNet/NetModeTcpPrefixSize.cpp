@@ -81,23 +81,8 @@ void NetModeTcpPrefixSize::DealWithData(const WSABUF & buffer, size_t completion
 
 	try
 	{
-		// Ensure that of partial packet buffer after data received is not too large
-		size_t newSize = GetPartialPacketUsedSize() + completionBytes;
-		if(newSize > GetPartialPacketMemorySize())
-		{
-			if(!IsAutoResizeEnabled())
-			{
-				_ErrorException(true,"receiving new TCP data. The size of a newly received packet is larger than the TCP receive buffer",0,__LINE__,__FILE__);
-			}
-			else
-			{
-				// Increase memory size to accommodate incoming packet
-				this->ChangePartialPacketMemorySize(newSize);
-			}
-		}
-
-		// Add new bytes to the partial packet buffer
-		partialPacket.addEqualWSABUF(buffer,completionBytes);
+		// Add new bytes to the partial packet buffer, without copying if they were received directly into it
+		AddRecvData(buffer,completionBytes);
 
 		// If there are any complete packets in the incomplete packet store then they will be passed to PacketDone
 ReCheck:
@@ -140,12 +125,8 @@ ReCheck:
 				// operations can succeed, and overwrite the bad data.
 				partialPacket.IncCursor(packetSizeWithPrefix);
 
-				// Copy data from partialPacket into a separate packet to be passed to user
-				Packet * completePacket = this->packetMemoryRecycle->GetPacket(packetSize,this);
-				completePacket->LoadFull(copyData, packetSize, 0, clientID, 0, instanceID, 0);
-
-				// Pass to PacketDone
-				PacketDone(completePacket, tcpRecvFunc);
+				// Pass to user function or copy data from partialPacket into a separate packet for the packet store
+				PacketDone(copyData, packetSize, 0, tcpRecvFunc, clientID, instanceID);
 
 				// Recheck to see if any other completed packets exist in partialPacket
 				// (it is possible to receive more than one complete packet at the same time)
@@ -153,10 +134,9 @@ ReCheck:
 			}
 		}
 
-		// Erase packets that we've dealt with, this simply involves decreasing used size
-		// Do this after all packets have been dealt with because it is more efficient
-		// to erase multiple packets at the same time, rather than each one individually
-		partialPacket.Erase(0, partialPacket.GetCursor());
+		// Packets that we've dealt with are left in place, the cursor has moved past them.
+		// Data is only moved when space is needed, see GetRecvRegion.
+		DiscardReadData();
 	}
 	// Release control of all objects before throwing final exception
 	catch(ErrorReport & error){ partialPacket.Leave(); throw(error); }
@@ -170,18 +150,49 @@ ReCheck:
  *
  * @param packet Packet to send.
  * @param block True if sending should be synchronous, false if sending should be asynchronous.
+ * @param [in] pool Send object is taken from this pool where possible.
+ *
+ * @return a send object.
+ */
+NetSend * NetModeTcpPrefixSize::GetSendObject(const Packet * packet, bool block, NetSendPool & pool)
+{
+	NetSendPrefix * sendObject = pool.GetPrefix(packet,block);
+	sendObject->GetPrefix().AddSizeT(packet->GetUsedSize());
+
+	return sendObject;
+}
+
+/**
+ * @brief Generates an asynchronous NetSend object that sends data shared with other send operations.
+ *
+ * @param packet Packet to send.
+ * @param [in] payload Copy of @a packet's data.
+ * @param [in] pool Send object is taken from this pool where possible.
  *
  * @return a send object.
  */
-NetSend * NetModeTcpPrefixSize::GetSendObject(const Packet * packet, bool block)
+NetSend * NetModeTcpPrefixSize::GetSharedSendObject(const Packet * packet, NetSendPayload * payload, NetSendPool & pool)
 {
 	Packet aux;
-	aux.AddSizeT(packet->GetUsedSize());
+	aux.AddSizeT(payload->GetBuffer().len);
 
-	NetSend * sendObject = new (nothrow) NetSendPrefix(packet,block,aux);
-	Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
+	return pool.GetShared(payload,&aux,NULL);
+}
 
-	return sendObject;
+/**
+ * @brief Generates an asynchronous NetSend object that sends the segments of a chain without copying them.
+ *
+ * @param chain Packet data to send.
+ * @param [in] pool Send object is taken from this pool where possible.
+ *
+ * @return a send object.
+ */
+NetSend * NetModeTcpPrefixSize::GetChainSendObject(const PacketChain & chain, NetSendPool & pool)
+{
+	Packet aux;
+	aux.AddSizeT(chain.GetUsedSize());
+
+	return pool.GetShared(chain,&aux,NULL);
 }
 
 /**
@@ -208,7 +219,7 @@ double NetModeTcpPrefixSize::GetPartialPacketPercentage() const
 
 	if(GetPartialPacketUsedSize() >= Packet::prefixSizeBytes)
 	{
-		double packetFinalSize = static_cast<double>(partialPacket.GetPrefixSizeT());
+		double packetFinalSize = static_cast<double>(partialPacket.GetPrefixSizeT(partialPacket.GetCursor()));
 		double packetCurrentSize = static_cast<double>(GetPartialPacketUsedSize() - Packet::prefixSizeBytes);
 
 		percentage = (packetCurrentSize / packetFinalSize) * 100.0;
@@ -225,6 +236,199 @@ double NetModeTcpPrefixSize::GetPartialPacketPercentage() const
 }
 
 
+/** @brief Data pointer of the last packet passed to NetModeTcpPrefixSizeTestView(). */
+static const char * testViewData = NULL;
+
+/** @brief True if the last packet passed to NetModeTcpPrefixSizeTestView() was as expected. */
+static bool testViewGood = false;
+
+/** @brief If not NULL, NetModeTcpPrefixSizeTestView() resizes this object's partial packet from another thread. */
+static NetModeTcpPrefixSize * testViewMode = NULL;
+
+/** @brief Thread started by NetModeTcpPrefixSizeTestView(), NULL if none. */
+static ThreadSingle * testViewThread = NULL;
+
+/** @brief True if NetModeTcpPrefixSizeTestView() was not blocked by the partial packet's lock. */
+static bool testViewUnlocked = false;
+
+/**
+ * @brief Changes the partial packet memory size of the NetModeTcpPrefixSize passed as the thread's parameter.
+ *
+ * @param lpParameter Pointer to ThreadSingle object.
+ *
+ * @return 0.
+ */
+static DWORD WINAPI NetModeTcpPrefixSizeTestResizeThread(LPVOID lpParameter)
+{
+	ThreadSingle * thread = static_cast<ThreadSingle*>(lpParameter);
+	NetModeTcpPrefixSize * mode = static_cast<NetModeTcpPrefixSize*>(thread->GetParameter());
+
+	mode->ChangePartialPacketMemorySize(128);
+	return 0;
+}
+
+/**
+ * @brief Receive function used by NetModeTcpPrefixSize::TestClass() to test zero copy receiving.
+ *
+ * If testViewMode is set, checks that another thread can use the object
+ * while this function executes.
+ *
+ * @param packet Complete packet.
+ */
+static void NetModeTcpPrefixSizeTestView(Packet & packet)
+{
+	testViewData = packet.GetDataPtr();
+	testViewGood = (packet == "view" && packet.GetClientFrom() == 1 && packet.GetInstance() == 2);
+
+	if(testViewMode != NULL)
+	{
+		testViewThread = new (nothrow) ThreadSingle(&NetModeTcpPrefixSizeTestResizeThread,testViewMode);
+		Utility::DynamicAllocCheck(testViewThread,__LINE__,__FILE__);
+		testViewThread->Resume();
+
+		// Thread cannot finish until this function returns if the partial packet is still locked
+		for(size_t n = 0;n<1000 && testViewThread->IsRunning() == true;n++)
+		{
+			Sleep(1);
+		}
+		testViewUnlocked = (testViewThread->IsRunning() == false);
+	}
+}
+
+/** @brief Number of packets passed to NetModeTcpPrefixSizeBenchmarkRecv(). */
+static size_t benchmarkPacketsReceived = 0;
+
+/** @brief Sum of the first byte of each packet passed to NetModeTcpPrefixSizeBenchmarkRecv(). */
+static size_t benchmarkChecksum = 0;
+
+/**
+ * @brief Receive function used by NetModeTcpPrefixSizeBenchmark(), counts packets.
+ *
+ * @param packet Complete packet.
+ */
+static void NetModeTcpPrefixSizeBenchmarkRecv(Packet & packet)
+{
+	benchmarkPacketsReceived++;
+	benchmarkChecksum += static_cast<unsigned char>(packet.GetDataPtr()[0]);
+}
+
+/**
+ * @brief Compares copying received data into the partial packet and moving unread data
+ * to the start after every receive, with receiving directly into the partial packet.
+ *
+ * Many small prefix framed packets are streamed through in receive sized pieces
+ * that do not line up with packet boundaries.
+ *
+ * @param packets Number of packets to stream.
+ * @param packetSize Size of each packet, not including prefix.
+ * @param recvSize Maximum number of bytes received by each receive operation.
+ *
+ * @return true if every packet was received intact using both methods.
+ */
+static bool NetModeTcpPrefixSizeBenchmark(size_t packets, size_t packetSize, size_t recvSize)
+{
+	// Stream of prefix framed packets, as it would arrive from the network
+	Packet stream;
+	stream.SetMemorySize(packets * (packetSize + Packet::prefixSizeBytes));
+	size_t expectedChecksum = 0;
+	for(size_t n = 0;n<packets;n++)
+	{
+		char first = static_cast<char>(n);
+		expectedChecksum += static_cast<unsigned char>(first);
+
+		stream.AddSizeT(packetSize);
+		stream.Add(first);
+		for(size_t i = 1;i<packetSize;i++)
+		{
+			stream.Add('a');
+		}
+	}
+	const size_t streamSize = stream.GetUsedSize();
+
+	// Copy from a receive buffer and erase dealt with data after every receive
+	char * recvBuffer = new (nothrow) char[recvSize];
+	Utility::DynamicAllocCheck(recvBuffer,__LINE__,__FILE__);
+
+	Packet partialPacket;
+	partialPacket.SetMemorySize(recvSize * 2);
+	size_t copyPackets = 0;
+	size_t copyChecksum = 0;
+	size_t bytesMoved = 0;
+
+	DWORD startTime = GetTickCount();
+	for(size_t position = 0;position<streamSize;)
+	{
+		size_t bytes = streamSize - position;
+		if(bytes > recvSize)
+		{
+			bytes = recvSize;
+		}
+		memcpy(recvBuffer,stream.GetDataPtr() + position,bytes);
+		position += bytes;
+
+		WSABUF buffer;
+		buffer.buf = recvBuffer;
+		buffer.len = static_cast<DWORD>(bytes);
+		partialPacket.addEqualWSABUF(buffer,bytes);
+
+		while(partialPacket.GetPacketRemainder() >= Packet::prefixSizeBytes &&
+			  partialPacket.GetPrefixSizeT(partialPacket.GetCursor()) + Packet::prefixSizeBytes <= partialPacket.GetPacketRemainder())
+		{
+			size_t size = partialPacket.GetPrefixSizeT(partialPacket.GetCursor());
+
+			WSABUF copyData;
+			copyData.buf = partialPacket.GetDataPtr() + partialPacket.GetCursor() + Packet::prefixSizeBytes;
+			copyData.len = static_cast<DWORD>(size);
+			partialPacket.IncCursor(size + Packet::prefixSizeBytes);
+
+			Packet completePacket;
+			completePacket.LoadFull(copyData,size,0,0,0,0,0);
+			copyPackets++;
+			copyChecksum += static_cast<unsigned char>(completePacket.GetDataPtr()[0]);
+		}
+
+		bytesMoved += partialPacket.GetPacketRemainder();
+		partialPacket.Erase(0,partialPacket.GetCursor());
+	}
+	DWORD copyTime = GetTickCount() - startTime;
+	delete[] recvBuffer;
+
+	// Receive directly into the partial packet
+	NetModeTcpPrefixSize mode(recvSize * 2,true);
+	benchmarkPacketsReceived = 0;
+	benchmarkChecksum = 0;
+
+	startTime = GetTickCount();
+	for(size_t position = 0;position<streamSize;)
+	{
+		WSABUF region = mode.GetRecvRegion(recvSize);
+
+		size_t bytes = streamSize - position;
+		if(bytes > recvSize)
+		{
+			bytes = recvSize;
+		}
+		if(bytes > region.len)
+		{
+			bytes = region.len;
+		}
+		memcpy(region.buf,stream.GetDataPtr() + position,bytes); // Done by the kernel in practice
+		position += bytes;
+
+		mode.DealWithData(region,bytes,&NetModeTcpPrefixSizeBenchmarkRecv,0,0);
+	}
+	DWORD ringTime = GetTickCount() - startTime;
+
+	cout << packets << " packets of " << packetSize << " bytes, " << recvSize << " byte receives:\n";
+	cout << " Copy and erase: " << copyTime << "ms, " << bytesMoved << " bytes moved by erase\n";
+	cout << " Receive in place: " << ringTime << "ms\n";
+
+	return copyPackets == packets && copyChecksum == expectedChecksum &&
+		   benchmarkPacketsReceived == packets && benchmarkChecksum == expectedChecksum &&
+		   mode.GetPartialPacketUsedSize() == 0;
+}
+
+
 /**
  * @brief Tests class.
  *
@@ -358,6 +562,100 @@ bool NetModeTcpPrefixSize::TestClass()
 		cout << "DealWithData is good (packet 3)\n";
 	}
 
+	// Data received directly into the partial packet
+	{
+		NetModeTcpPrefixSize direct(64,false);
+
+		Packet first;
+		first.AddStringC("first",0,true);
+		first.AddStringC("second",0,true);
+
+		// All of first packet and part of the second
+		size_t amount = first.GetUsedSize() - 3;
+		WSABUF region = direct.GetRecvRegion(amount);
+		memcpy(region.buf,first.GetDataPtr(),amount);
+		direct.DealWithData(region,amount,NULL,1,2);
+
+		// Rest of the second packet is received after the first, without data being moved
+		WSABUF secondRegion = direct.GetRecvRegion(3);
+		memcpy(secondRegion.buf,first.GetDataPtr() + amount,3);
+		direct.DealWithData(secondRegion,3,NULL,1,2);
+
+		bool directProblem = (secondRegion.buf != region.buf + amount || direct.GetPacketAmount() != 2 || direct.GetPartialPacketUsedSize() != 0);
+
+		direct.GetPacketFromStore(&destination);
+		directProblem |= (destination != "first");
+		direct.GetPacketFromStore(&destination);
+		directProblem |= (destination != "second");
+
+		// All data read, so partial packet is reused from the start
+		directProblem |= (direct.GetRecvRegion(3).buf != region.buf);
+
+		if(directProblem == true)
+		{
+			cout << "GetRecvRegion is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "GetRecvRegion is good\n";
+		}
+	}
+
+	// Receive function is passed a view of the partial packet
+	{
+		NetModeTcpPrefixSize direct(64,false);
+		direct.SetZeroCopy(true);
+
+		Packet message;
+		message.AddStringC("view",0,true);
+
+		WSABUF region = direct.GetRecvRegion(message.GetUsedSize());
+		memcpy(region.buf,message.GetDataPtr(),message.GetUsedSize());
+		direct.DealWithData(region,message.GetUsedSize(),&NetModeTcpPrefixSizeTestView,1,2);
+
+		if(testViewGood == false || testViewData != region.buf + Packet::prefixSizeBytes || direct.GetPacketAmount() != 0)
+		{
+			cout << "DealWithData (zero copy) is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "DealWithData (zero copy) is good\n";
+		}
+
+		// Partial packet is not locked while the receive function executes, resizing is deferred until it returns
+		testViewMode = &direct;
+		region = direct.GetRecvRegion(message.GetUsedSize());
+		memcpy(region.buf,message.GetDataPtr(),message.GetUsedSize());
+		direct.DealWithData(region,message.GetUsedSize(),&NetModeTcpPrefixSizeTestView,1,2);
+		testViewMode = NULL;
+
+		testViewThread->WaitForThreadToExit();
+		delete testViewThread;
+		testViewThread = NULL;
+
+		if(testViewGood == false || testViewUnlocked == false || direct.GetPartialPacketMemorySize() != 128)
+		{
+			cout << "DealWithData (zero copy, unlocked) is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "DealWithData (zero copy, unlocked) is good\n";
+		}
+	}
+
+	if(NetModeTcpPrefixSizeBenchmark(200000,16,1024) == false || NetModeTcpPrefixSizeBenchmark(20000,600,4096) == false)
+	{
+		cout << "Benchmark is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Benchmark is good\n";
+	}
+
 	cout << "\n\n";
 	return !problem;
 }
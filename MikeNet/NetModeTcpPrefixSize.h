@@ -22,7 +22,9 @@ public:
 
 	NetModeTcpPrefixSize(size_t partialPacketSize, bool autoResize);
 
-	NetSend * GetSendObject(const Packet * packet, bool block);
+	NetSend * GetSendObject(const Packet * packet, bool block, NetSendPool & pool);
+	NetSend * GetSharedSendObject(const Packet * packet, NetSendPayload * payload, NetSendPool & pool);
+	NetSend * GetChainSendObject(const PacketChain & chain, NetSendPool & pool);
 
 	NetModeTcpPrefixSize(const NetModeTcpPrefixSize &);
 	NetModeTcpPrefixSize(size_t partialPacketSize, bool autoResize, MemoryRecyclePacket * memoryRecycle);
@@ -76,11 +76,28 @@ NetModeTcp * NetModeTcpRaw::Clone() const
  */
 void NetModeTcpRaw::DealWithData(const WSABUF & buffer, size_t completionBytes, NetSocket::RecvFunc tcpRecvFunc, size_t clientID, size_t instanceID)
 {
-	Packet * completePacket = this->packetMemoryRecycle->GetPacket(completionBytes,this);
-	completePacket->LoadFull(buffer,completionBytes,0,clientID,0,instanceID,0);
+	partialPacket.Enter();
+
+	try
+	{
+		// Add packet to packet store or pass it to user function
+		PacketDone(buffer, completionBytes, 0, tcpRecvFunc, clientID, instanceID);
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){ partialPacket.Leave(); throw(error); }
+	catch(...){	partialPacket.Leave(); throw(-1); }
+
+	partialPacket.Leave();
+}
 
-	// Add packet to packet store or pass it to user function
-	PacketDone(completePacket, tcpRecvFunc);
+/**
+ * @brief Determines whether data should be received directly into the partial packet.
+ *
+ * @return false, the partial packet is not used so data is received into the socket's receive buffer.
+ */
+bool NetModeTcpRaw::IsRecvInPlace() const
+{
+	return false;
 }
 
 /**
@@ -88,15 +105,40 @@ void NetModeTcpRaw::DealWithData(const WSABUF & buffer, size_t completionBytes,
  *
  * @param packet Packet to send.
  * @param block True if sending should be synchronous, false if sending should be asynchronous.
+ * @param [in] pool Send object is taken from this pool where possible.
  *
  * @return a send object.
  */
-NetSend * NetModeTcpRaw::GetSendObject(const Packet * packet, bool block)
+NetSend * NetModeTcpRaw::GetSendObject(const Packet * packet, bool block, NetSendPool & pool)
 {
-	NetSend * sendObject = new (nothrow) NetSendRaw(packet,block);
-	Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
+	return pool.GetRaw(packet,block);
+}
 
-	return sendObject;
+/**
+ * @brief Generates an asynchronous NetSend object that sends data shared with other send operations.
+ *
+ * @param packet Packet to send.
+ * @param [in] payload Copy of @a packet's data.
+ * @param [in] pool Send object is taken from this pool where possible.
+ *
+ * @return a send object.
+ */
+NetSend * NetModeTcpRaw::GetSharedSendObject(const Packet * packet, NetSendPayload * payload, NetSendPool & pool)
+{
+	return pool.GetShared(payload,NULL,NULL);
+}
+
+/**
+ * @brief Generates an asynchronous NetSend object that sends the segments of a chain without copying them.
+ *
+ * @param chain Packet data to send.
+ * @param [in] pool Send object is taken from this pool where possible.
+ *
+ * @return a send object.
+ */
+NetSend * NetModeTcpRaw::GetChainSendObject(const PacketChain & chain, NetSendPool & pool)
+{
+	return pool.GetShared(chain,NULL,NULL);
 }
 
 /**
@@ -11,8 +11,11 @@ public:
 	NetModeTcp * Clone() const;
 
 	void DealWithData(const WSABUF & buffer, size_t completionBytes, NetSocket::RecvFunc tcpRecvFunc, size_t clientID, size_t instanceID);
+	bool IsRecvInPlace() const;
 
-	NetSend * GetSendObject(const Packet * packet, bool block);
+	NetSend * GetSendObject(const Packet * packet, bool block, NetSendPool & pool);
+	NetSend * GetSharedSendObject(const Packet * packet, NetSendPayload * payload, NetSendPool & pool);
+	NetSend * GetChainSendObject(const PacketChain & chain, NetSendPool & pool);
 
 	ProtocolMode GetProtocolMode() const;
 };
\ No newline at end of file
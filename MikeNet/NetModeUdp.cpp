@@ -1,5 +1,13 @@
 #include "FullInclude.h"
 
+/**
+ * @brief Constructor.
+ */
+NetModeUdp::NetModeUdp() : compactHeaders(false)
+{
+
+}
+
 /**
  * @brief Generates NetModeUdp object based on @a protocolMode.
  *
@@ -55,6 +63,144 @@ NetModeUdp * NetModeUdp::GenerateModeUDP(NetMode::ProtocolMode protocolMode, siz
 	return returnMe;
 }
 
+/**
+ * @brief Enables or disables compact headers.
+ *
+ * When enabled, integers that this object adds to the start of sent packets (the clock value in
+ * NetMode::UDP_PER_CLIENT and the counter in NetMode::UDP_CATCH_ALL_NO) are variable length integers,
+ * which usually take up 1 to 4 bytes instead of Utility::LargestSupportedBytesInt bytes, and the same
+ * integers in received packets are expected to be variable length integers too.\n\n
+ *
+ * Only integers that this object adds are affected. Integers that the application adds itself, such as
+ * client and operation IDs in NetMode::UDP_PER_CLIENT and NetMode::UDP_PER_CLIENT_PER_OPERATION,
+ * always use Packet::AddSizeT(), so applications do not need to know which option is in use.\n\n
+ *
+ * Both ends must use the same option. NetInstanceServer tells clients which option it is using
+ * during the handshaking process. Connection packets always use the normal format.
+ *
+ * @param paraCompactHeaders True if compact headers should be used, false if not.
+ */
+void NetModeUdp::SetCompactHeaders(bool paraCompactHeaders)
+{
+	compactHeaders.Set(paraCompactHeaders);
+}
+
+/**
+ * @brief Determines whether compact headers are enabled, see SetCompactHeaders().
+ *
+ * @return true if compact headers are enabled, false if not.
+ */
+bool NetModeUdp::IsCompactHeaders() const
+{
+	return compactHeaders.Get();
+}
+
+/**
+ * @brief Enables or disables authenticated encryption of packets, see CipherGCM.
+ *
+ * By default this is not supported, and an exception is thrown if @a option is true.
+ * NetModeUdpPerClient supports it when it has a decryption key.\n\n
+ *
+ * Both ends must use the same option. NetInstanceServer tells clients which option it is using
+ * during the handshaking process. This must not be changed while the object is in use.
+ *
+ * @param option True if packets should be sealed when sent and opened when received, false if not.
+ *
+ * @throws ErrorReport If @a option is true and authenticated encryption is not supported.
+ */
+void NetModeUdp::SetAuthenticatedEncryption(bool option)
+{
+	_ErrorException((option == true),"enabling authenticated encryption, the UDP mode does not support it",0,__LINE__,__FILE__);
+}
+
+/**
+ * @brief Determines whether authenticated encryption is enabled, see SetAuthenticatedEncryption().
+ *
+ * @return true if authenticated encryption is enabled, false if not.
+ */
+bool NetModeUdp::IsAuthenticatedEncryption() const
+{
+	return false;
+}
+
+/**
+ * @brief Adds an integer to a header in the format selected by SetCompactHeaders().
+ *
+ * @param [out] destination Integer is added to this packet.
+ * @param add Integer to add.
+ */
+void NetModeUdp::AddHeaderSizeT(Packet & destination, size_t add) const
+{
+	if(IsCompactHeaders() == true)
+	{
+		destination.AddVarSizeT(add);
+	}
+	else
+	{
+		destination.AddSizeT(add);
+	}
+}
+
+/**
+ * @brief Retrieves an integer from a header in the format selected by SetCompactHeaders().
+ *
+ * @param source Packet to retrieve integer from.
+ *
+ * @return retrieved integer.
+ */
+size_t NetModeUdp::GetHeaderSizeT(const Packet & source) const
+{
+	if(IsCompactHeaders() == true)
+	{
+		return source.GetVarSizeT();
+	}
+	else
+	{
+		return source.GetSizeT();
+	}
+}
+
+/**
+ * @brief Adds the prefix that GetSendObject() would place before a packet sent to the specified client.
+ *
+ * This allows a packet to be sent to many clients with one batched operation, where only
+ * the prefix differs between clients. By default there is no prefix.
+ *
+ * @param [out] destination Prefix is added to the end of this packet.
+ * @param clientID ID of client that the packet will be sent to, or 0 if not applicable.
+ */
+void NetModeUdp::AddSendPrefix(Packet & destination, size_t clientID)
+{
+
+}
+
+/**
+ * @brief Deals with several newly received datagrams.
+ *
+ * By default each datagram is passed to DealWithData() in order. Derived classes may
+ * override this to reduce the cost of dealing with each datagram, e.g. by locking once per batch.
+ *
+ * @param buffers Array of datagrams, the length of each datagram is the length of its WSABUF.
+ * @param clientIDs Array of @a amount client IDs, one for each datagram. If NULL @a clientID applies to all datagrams.
+ * @param amount Number of elements in @a buffers.
+ * @param [in] udpRecvFunc Method will be executed and data not added to the queue if this is non NULL.
+ * @param clientID ID of client that data was received from, set to 0 if not applicable. Ignored if @a clientIDs is not NULL.
+ * @param instanceID Instance that data was received on.
+ */
+void NetModeUdp::DealWithDataBatch(const WSABUF * buffers, const size_t * clientIDs, size_t amount, NetSocket::RecvFunc udpRecvFunc, size_t clientID, size_t instanceID)
+{
+	for(size_t n = 0;n<amount;n++)
+	{
+		size_t datagramClientID = clientID;
+		if(clientIDs != NULL)
+		{
+			datagramClientID = clientIDs[n];
+		}
+
+		DealWithData(buffers[n],buffers[n].len,udpRecvFunc,datagramClientID,instanceID);
+	}
+}
+
 /**
  * @brief	Helps to test NetModeUdp objects.
  *
@@ -212,6 +358,127 @@ bool NetModeUdp::_HelperTestClass(NetModeUdp & obj, Packet & packet, const char
 	return !problem;
 }
 
+/**
+ * @brief Adds a header integer in the format used by NetModeUdp::AddHeaderSizeT().
+ *
+ * @param [out] destination Integer is added to this packet.
+ * @param add Integer to add.
+ * @param compact True if compact headers are in use.
+ */
+static void NetModeUdpHeaderAdd(Packet & destination, size_t add, bool compact)
+{
+	if(compact == true)
+	{
+		destination.AddVarSizeT(add);
+	}
+	else
+	{
+		destination.AddSizeT(add);
+	}
+}
+
+/**
+ * @brief Compares the bandwidth used by normal and compact headers, see NetModeUdp::SetCompactHeaders().
+ *
+ * Simulates @a seconds seconds of a server sending @a packetsPerSecond packets per second to each of
+ * @a numClients clients, starting @a uptime seconds after the server started. The header values (clock values
+ * and counters) are those that the server would send at that time. Every packet is received by a NetModeUdp object
+ * using the same option, to check that the headers are read correctly.
+ *
+ * @param protocolMode NetMode::UDP_PER_CLIENT_PER_OPERATION or NetMode::UDP_CATCH_ALL_NO.
+ * @param numClients Number of clients that packets are sent to.
+ * @param numOperations Number of operations that packets are spread across, ignored in NetMode::UDP_CATCH_ALL_NO.
+ * @param payloadSize Size of data in each packet, excluding headers.
+ * @param uptime Number of seconds that the server has been running for.
+ * @param seconds Number of seconds of traffic to simulate.
+ * @param packetsPerSecond Number of packets sent to each client per second.
+ *
+ * @return true if every packet was received, false if not.
+ */
+static bool NetModeUdpHeaderBandwidth(NetMode::ProtocolMode protocolMode, size_t numClients, size_t numOperations, size_t payloadSize, size_t uptime, size_t seconds, size_t packetsPerSecond)
+{
+	// IPv4 and UDP headers, sent with every datagram regardless of the UDP mode
+	const size_t ipOverhead = 28;
+
+	Packet payload;
+	payload.SetMemorySize(payloadSize);
+	for(size_t n = 0;n<payloadSize;n++)
+	{
+		payload.Add<char>('a');
+	}
+
+	bool problem = false;
+	size_t headerBytes[2] = {0, 0};
+	size_t numPackets = seconds * packetsPerSecond * numClients;
+
+	for(size_t compact = 0;compact<2;compact++)
+	{
+		NetModeUdp * mode = NetModeUdp::GenerateModeUDP(protocolMode,numClients,numOperations,1024,NULL,NULL);
+		mode->SetCompactHeaders(compact == 1);
+
+		Packet packet;
+		Packet destination;
+		WSABUF buffer;
+		size_t received = 0;
+
+		for(size_t tick = 0;tick<seconds * packetsPerSecond;tick++)
+		{
+			size_t sendNumber = uptime * packetsPerSecond + tick + 1;
+			size_t clockValue = (uptime * CLOCKS_PER_SEC) + (tick * CLOCKS_PER_SEC / packetsPerSecond) + 1;
+			size_t operationID = tick % numOperations;
+
+			for(size_t clientID = 1;clientID<=numClients;clientID++)
+			{
+				packet.Clear();
+
+				// Headers, in the same order as NetModeUdp::GetSendObject() and the user would add them
+				if(protocolMode == NetMode::UDP_CATCH_ALL_NO)
+				{
+					operationID = 0;
+					NetModeUdpHeaderAdd(packet,sendNumber,compact == 1);
+				}
+				else
+				{
+					NetModeUdpHeaderAdd(packet,clockValue,compact == 1);
+
+					// Added by the user, so never compact
+					packet.AddSizeT(clientID);
+					packet.AddSizeT(operationID);
+				}
+
+				headerBytes[compact] += packet.GetUsedSize();
+				packet += payload;
+
+				// In NetMode::UDP_CATCH_ALL_NO the client is known from the address, in client state NetMode::UDP_PER_CLIENT_PER_OPERATION
+				// reads it from the packet
+				packet.PtrIntoWSABUF(buffer);
+				mode->DealWithData(buffer,packet.GetUsedSize(),NULL,protocolMode == NetMode::UDP_CATCH_ALL_NO ? clientID : 0,0);
+
+				if(mode->GetPacketFromStore(&destination,clientID,operationID) == 1 && destination.GetPacketRemainder() == payloadSize)
+				{
+					received++;
+				}
+			}
+		}
+
+		if(received != numPackets)
+		{
+			problem = true;
+		}
+
+		delete mode;
+	}
+
+	size_t totalBytes[2] = {headerBytes[0] + (payloadSize + ipOverhead) * numPackets, headerBytes[1] + (payloadSize + ipOverhead) * numPackets};
+
+	cout << " " << numClients << " clients, " << payloadSize << " byte payload, " << packetsPerSecond << " packets per second, after " << uptime << " seconds:\n";
+	cout << "  Normal headers: " << static_cast<double>(headerBytes[0]) / numPackets << " bytes per packet, " << totalBytes[0] / seconds << " bytes per second including IP and UDP headers\n";
+	cout << "  Compact headers: " << static_cast<double>(headerBytes[1]) / numPackets << " bytes per packet, " << totalBytes[1] / seconds << " bytes per second including IP and UDP headers\n";
+	cout << "  Compact headers use " << (100.0 * totalBytes[1]) / totalBytes[0] << "% of the bandwidth\n";
+
+	return !problem;
+}
+
 /**
  * @brief Tests class.
  *
@@ -240,6 +507,41 @@ bool NetModeUdp::TestClass()
 	
 	delete mode;
 
+	{
+		NetModeUdpPerClient obj(1024,10,1,false,NULL);
+		obj.SetCompactHeaders(true);
+
+		NetModeUdp * clone = obj.Clone();
+		if(clone->IsCompactHeaders() == false)
+		{
+			cout << "SetCompactHeaders is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "SetCompactHeaders is good\n";
+		}
+		delete clone;
+	}
+
+	cout << "Comparing bandwidth used by headers in NetMode::UDP_PER_CLIENT_PER_OPERATION..\n";
+	bool bandwidthGood = NetModeUdpHeaderBandwidth(NetMode::UDP_PER_CLIENT_PER_OPERATION,16,4,48,60,20,30);
+	bandwidthGood &= NetModeUdpHeaderBandwidth(NetMode::UDP_PER_CLIENT_PER_OPERATION,16,4,48,86400,20,30);
+
+	cout << "Comparing bandwidth used by headers in NetMode::UDP_CATCH_ALL_NO..\n";
+	bandwidthGood &= NetModeUdpHeaderBandwidth(NetMode::UDP_CATCH_ALL_NO,16,1,48,60,20,30);
+	bandwidthGood &= NetModeUdpHeaderBandwidth(NetMode::UDP_CATCH_ALL_NO,16,1,48,86400,20,30);
+
+	if(bandwidthGood == false)
+	{
+		cout << "Bandwidth comparison is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Bandwidth comparison is good\n";
+	}
+
 	cout << "\n\n";
 	return !problem;
 }
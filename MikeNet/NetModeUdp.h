@@ -9,7 +9,39 @@
  */
 class NetModeUdp : public NetMode
 {
+	/**
+	 * @brief If true, integers in the headers that this object adds, and the same integers in received packets,
+	 * are variable length integers, see Packet::AddVarSizeT() and SetCompactHeaders().
+	 *
+	 * Protected by critical section so that it can be changed during runtime.
+	 */
+	ConcurrentObject<bool> compactHeaders;
+
+protected:
+	void AddHeaderSizeT(Packet & destination, size_t add) const;
+	size_t GetHeaderSizeT(const Packet & source) const;
+
 public:
+	/**
+	 * @brief Set in the UDP mode that NetInstanceServer sends to clients while handshaking
+	 * if compact headers are enabled, see SetCompactHeaders().
+	 */
+	static const char COMPACT_HEADERS_FLAG = 0x40;
+
+	/**
+	 * @brief Set in the UDP mode that NetInstanceServer sends to clients while handshaking
+	 * if authenticated encryption is enabled, see SetAuthenticatedEncryption().
+	 */
+	static const char AUTHENTICATED_ENCRYPTION_FLAG = 0x20;
+
+	NetModeUdp();
+
+	void SetCompactHeaders(bool compactHeaders);
+	bool IsCompactHeaders() const;
+
+	virtual void SetAuthenticatedEncryption(bool option);
+	virtual bool IsAuthenticatedEncryption() const;
+
 	static NetModeUdp * GenerateModeUDP(NetMode::ProtocolMode protocolMode, size_t numClients, size_t numOperations, size_t recvSize, const EncryptKey * decryptKey, const MemoryRecyclePacketRestricted * memoryRecycle);
 
 	static bool _HelperTestClass(NetModeUdp & obj, Packet & packet, const char * str, size_t dealWithDataClientID, size_t expectedClientID, size_t operationID);
@@ -65,6 +97,10 @@ public:
 	 */
 	virtual bool IsRecvMemorySizeSupported() const = 0;
 
+	virtual void AddSendPrefix(Packet & destination, size_t clientID);
+
+	virtual void DealWithDataBatch(const WSABUF * buffers, const size_t * clientIDs, size_t amount, NetSocket::RecvFunc udpRecvFunc, size_t clientID, size_t instanceID);
+
 	/**
 	 * @brief Retrieves the number of operations that this object can manage.
 	 *
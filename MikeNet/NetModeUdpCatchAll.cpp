@@ -157,6 +157,65 @@ void NetModeUdpCatchAll::DealWithData(const WSABUF & buffer, size_t completionBy
 	PacketDone(newPacket, udpRecvFunc);
 }
 
+/**
+ * @brief Deals with several newly received datagrams.
+ *
+ * When packets are queued, the packet store of a client is locked once for each run of datagrams
+ * from that client rather than once per datagram. Datagrams are still dealt with by DealWithData(),
+ * so derived classes do not need to override this method.
+ *
+ * @param buffers Array of datagrams, the length of each datagram is the length of its WSABUF.
+ * @param clientIDs Array of @a amount client IDs, one for each datagram. If NULL @a clientID applies to all datagrams.
+ * @param amount Number of elements in @a buffers.
+ * @param [in] udpRecvFunc Method will be executed and data not added to the queue if this is non NULL.
+ * @param clientID ID of client that data was received from, set to 0 if not applicable. Ignored if @a clientIDs is not NULL.
+ * @param instanceID Instance that data was received on.
+ */
+void NetModeUdpCatchAll::DealWithDataBatch(const WSABUF * buffers, const size_t * clientIDs, size_t amount, NetSocket::RecvFunc udpRecvFunc, size_t clientID, size_t instanceID)
+{
+	// Packets passed to a user function do not touch the packet store
+	if(udpRecvFunc != NULL)
+	{
+		NetModeUdp::DealWithDataBatch(buffers,clientIDs,amount,udpRecvFunc,clientID,instanceID);
+		return;
+	}
+
+	size_t n = 0;
+	while(n < amount)
+	{
+		size_t runClientID = clientID;
+		if(clientIDs != NULL)
+		{
+			runClientID = clientIDs[n];
+		}
+		ValidateClientID(runClientID);
+
+		// Find end of run of datagrams from the same client
+		size_t runEnd = n+1;
+		while(runEnd < amount && clientIDs != NULL && clientIDs[runEnd] == runClientID)
+		{
+			runEnd++;
+		}
+		if(clientIDs == NULL)
+		{
+			runEnd = amount;
+		}
+
+		// Lock is recursive so PacketDone can still lock it
+		packetStore[runClientID].Enter();
+		try
+		{
+			for(;n<runEnd;n++)
+			{
+				DealWithData(buffers[n],buffers[n].len,udpRecvFunc,runClientID,instanceID);
+			}
+		}
+		catch(ErrorReport & report){packetStore[runClientID].Leave(); throw report;}
+		catch(...){packetStore[runClientID].Leave(); throw -1;}
+		packetStore[runClientID].Leave();
+	}
+}
+
 /**
  * @brief Determines the number of packets in the specified packet store. 
  *
@@ -196,7 +255,21 @@ size_t NetModeUdpCatchAll::GetPacketFromStore(Packet * destination, size_t clien
 		if(returnMe > 0)
 		{
 			Packet * extractedPacket = packetStore[clientID].ExtractFront();
-			*destination = *extractedPacket;
+
+			// Destination takes the packet's memory, and its old memory is recycled instead.
+			// Only done if this does not increase the memory owned by the memory recycle, so that its limit is not exceeded.
+			size_t handedOver = extractedPacket->GetMemorySize();
+			if(destination->IsDataPtrChanged() == false && destination->GetMemorySize() <= handedOver)
+			{
+				destination->Swap(*extractedPacket);
+				packetStoreMemoryRecycle[clientID].DecreaseMemorySize(handedOver);
+				packetStoreMemoryRecycle[clientID].IncreaseMemorySize(extractedPacket->GetMemorySize());
+			}
+			else
+			{
+				*destination = *extractedPacket;
+			}
+
 			packetStoreMemoryRecycle[clientID].RecyclePacket(extractedPacket);
 		}
 	}
@@ -213,15 +286,13 @@ size_t NetModeUdpCatchAll::GetPacketFromStore(Packet * destination, size_t clien
  *
  * @param packet Packet to send.
  * @param block True if sending should be synchronous, false if sending should be asynchronous.
+ * @param [in] pool Send object is taken from this pool where possible.
  *
  * @return a send object.
  */
-NetSend * NetModeUdpCatchAll::GetSendObject(const Packet * packet, bool block)
+NetSend * NetModeUdpCatchAll::GetSendObject(const Packet * packet, bool block, NetSendPool & pool)
 {
-	NetSend * sendObject = new (nothrow) NetSendRaw(packet,block);
-	Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
-	
-	return sendObject;
+	return pool.GetRaw(packet,block);
 }
 
 /**
@@ -426,6 +497,37 @@ bool NetModeUdpCatchAll::TestClass()
 		cout << "DealWithData is good (packet 2)\n";
 	}
 
+	// Batch of datagrams from two clients
+	Packet batchPacket1("first");
+	Packet batchPacket2("second");
+	WSABUF batchBuffers[3];
+	batchPacket1.PtrIntoWSABUF(batchBuffers[0]);
+	batchPacket2.PtrIntoWSABUF(batchBuffers[1]);
+	batchPacket1.PtrIntoWSABUF(batchBuffers[2]);
+	size_t batchClientIDs[3] = {2,2,3};
+	obj.DealWithDataBatch(batchBuffers,batchClientIDs,3,NULL,0,1);
+
+	bool batchGood = (obj.GetPacketAmount(2) == 2 && obj.GetPacketAmount(3) == 1);
+	if(batchGood == true)
+	{
+		obj.GetPacketFromStore(&destination,2);
+		batchGood = (destination == "first");
+		obj.GetPacketFromStore(&destination,2);
+		batchGood = batchGood && (destination == "second");
+		obj.GetPacketFromStore(&destination,3);
+		batchGood = batchGood && (destination == "first");
+	}
+
+	if(batchGood == false)
+	{
+		cout << "DealWithDataBatch is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "DealWithDataBatch is good\n";
+	}
+
 	obj.SetRecvMemoryLimit(1,1);
 	Packet ott("hello"); // over the top ;)
 	WSABUF bufOtt;
@@ -42,12 +42,13 @@ public:
 
 	void PacketDone(Packet * completePacket, NetSocket::RecvFunc udpRecvFunc);
 	virtual void DealWithData(const WSABUF & buffer, size_t completionBytes, NetSocket::RecvFunc udpRecvFunc, size_t clientID, size_t instanceID);
+	virtual void DealWithDataBatch(const WSABUF * buffers, const size_t * clientIDs, size_t amount, NetSocket::RecvFunc udpRecvFunc, size_t clientID, size_t instanceID);
 	
 	size_t GetPacketAmount(size_t clientID, size_t operationID=0) const;
 
 	size_t GetPacketFromStore(Packet * destination, size_t clientID, size_t operationID=0);
 
-	virtual NetSend * GetSendObject(const Packet * packet, bool block);
+	virtual NetSend * GetSendObject(const Packet * packet, bool block, NetSendPool & pool);
 
 	virtual ProtocolMode GetProtocolMode() const;
 	size_t GetNumOperations() const;
@@ -93,6 +93,7 @@ void NetModeUdpCatchAllNo::Reset()
  * @param buffer Newly received data.
  * @param completionBytes Number of bytes of new data stored in @a buffer.
  * @param [in] udpRecvFunc Method will be executed and data not added to the queue if this is non NULL.
+ * It is never executed for two packets from the same client at the same time, so that packets are dealt with in order.
  * @param instanceID Instance that data was received on.
  * @param clientID ID of client that data was received from, set to 0 if not applicable.
  */
@@ -109,47 +110,56 @@ void NetModeUdpCatchAllNo::DealWithData(const WSABUF & buffer, size_t completion
 	 * or equal to the counter of the last received packet.
 	 */
 counterJustResetSoTryAgain:
-	size_t newPacketCounter = packetBuffer.GetSizeT();
+	size_t newPacketCounter = GetHeaderSizeT(packetBuffer);
 	
 	// Ignore connection packets
 	if(newPacketCounter != 0)
 	{
-		if(newPacketCounter >= recvCounter[clientID].Get())
+		/**
+		 * With more than one receive operation in progress, packets from the same
+		 * client can be dealt with at the same time. The counter is compared, updated
+		 * and the packet dealt with in one step while holding the counter's lock,
+		 * otherwise an older packet could pass the comparison at the same time as a
+		 * newer packet and be dealt with after it.
+		 */
+		bool retryPacket = false;
+		recvCounter[clientID].Enter();
+		try
 		{
-			size_t usedSize = completionBytes-packetBuffer.GetCursor();
+			if(newPacketCounter >= recvCounter[clientID].Get())
+			{
+				size_t usedSize = completionBytes-packetBuffer.GetCursor();
 
-			// Copy data into Packet object, excluding the prefix
-			Packet * newPacket = packetStoreMemoryRecycle[clientID].GetPacket(usedSize);
-			newPacket->LoadFull(buffer,usedSize,packetBuffer.GetCursor(),clientID,0,instanceID,static_cast<clock_t>(newPacketCounter));
+				// Copy data into Packet object, excluding the prefix
+				Packet * newPacket = packetStoreMemoryRecycle[clientID].GetPacket(usedSize);
+				newPacket->LoadFull(buffer,usedSize,packetBuffer.GetCursor(),clientID,0,instanceID,static_cast<clock_t>(newPacketCounter));
 
-			// Set recvCounter
-			recvCounter[clientID].Set(newPacketCounter);
+				// Set recvCounter
+				recvCounter[clientID].Set(newPacketCounter);
 
-			// Add packet to queue
-			PacketDone(newPacket,udpRecvFunc);
-		}
-		else
-		{
+				// Add packet to queue
+				PacketDone(newPacket,udpRecvFunc);
+			}
 			/**
 			 * If the current counter value is vastly different to the last
 			 * counter value, then it is likely that the maximum for
 			 * the counter value was reached, and so it looped back round
 			 * to 0.
 			 */
-			bool retryPacket = false;
-			recvCounter[clientID].Enter();
-			if(recvCounter[clientID].Get() - newPacketCounter >  recvCounter[clientID].Get() / 2)
+			else if(recvCounter[clientID].Get() - newPacketCounter >  recvCounter[clientID].Get() / 2)
 			{
 				recvCounter[clientID].Set(INITIAL_COUNTER_VALUE);
 				retryPacket = true;
 			}
-			recvCounter[clientID].Leave();
+		}
+		catch(ErrorReport & error){recvCounter[clientID].Leave(); throw error;}
+		catch(...){recvCounter[clientID].Leave(); throw -1;}
+		recvCounter[clientID].Leave();
 
-			if(retryPacket == true)
-			{
-				packetBuffer.SetCursor(0);
-				goto counterJustResetSoTryAgain;
-			}
+		if(retryPacket == true)
+		{
+			packetBuffer.SetCursor(0);
+			goto counterJustResetSoTryAgain;
 		}
 	}
 }
@@ -159,22 +169,37 @@ counterJustResetSoTryAgain:
  *
  * @param packet Packet to send.
  * @param block True if sending should be synchronous, false if sending should be asynchronous.
+ * @param [in] pool Send object is taken from this pool where possible.
  *
  * @return a send object.
  */
-NetSend * NetModeUdpCatchAllNo::GetSendObject(const Packet * packet, bool block)
+NetSend * NetModeUdpCatchAllNo::GetSendObject(const Packet * packet, bool block, NetSendPool & pool)
 {
-	Packet aux;
-	aux.AddSizeT(sendCounter[packet->GetClientFrom()].Get());
+	NetSendPrefix * sendObject = pool.GetPrefix(packet,block);
 
-	NetSend * sendObject = new (nothrow) NetSendPrefix(packet,block,aux);
-	Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
-
-	sendCounter[packet->GetClientFrom()].Increase(1);
+	try
+	{
+		AddSendPrefix(sendObject->GetPrefix(),packet->GetClientFrom());
+	}
+	// Return send object to pool before throwing final exception
+	catch(ErrorReport & error){NetSendPool::Recycle(sendObject); throw error;}
+	catch(...){NetSendPool::Recycle(sendObject); throw -1;}
 	
 	return sendObject;
 }
 
+/**
+ * @brief Adds the send counter of the specified client, and increases the counter.
+ *
+ * @param [out] destination Prefix is added to the end of this packet.
+ * @param clientID ID of client that the packet will be sent to, or 0 if not applicable.
+ */
+void NetModeUdpCatchAllNo::AddSendPrefix(Packet & destination, size_t clientID)
+{
+	AddHeaderSizeT(destination,sendCounter[clientID].Get());
+	sendCounter[clientID].Increase(1);
+}
+
 /**
  * @brief Retrieves the protocol mode in use.
  *
@@ -185,6 +210,67 @@ NetMode::ProtocolMode NetModeUdpCatchAllNo::GetProtocolMode() const
 	return NetMode::UDP_CATCH_ALL_NO;
 }
 
+/** @brief Number of packets dealt with by each thread started by NetModeUdpCatchAllNo::TestClass. */
+static const size_t NET_MODE_UDP_CATCH_ALL_NO_TEST_AMOUNT = 20000;
+
+/**
+ * @brief Counter of the next packet sent by NetModeUdpCatchAllNoTestThread.
+ *
+ * Starts high so that packets delayed by thread scheduling are not mistaken for the counter looping back round to 0.
+ */
+static ConcurrentObject<size_t> NetModeUdpCatchAllNoTestCounter(static_cast<size_t>(-1) / 4);
+
+/** @brief Counter of the last packet passed to NetModeUdpCatchAllNoTestRecvFunc. */
+static size_t NetModeUdpCatchAllNoTestLast = 0;
+
+/** @brief False if NetModeUdpCatchAllNoTestRecvFunc was passed a packet older than the one before it. */
+static bool NetModeUdpCatchAllNoTestOrderGood = true;
+
+/**
+ * @brief Receive function used by NetModeUdpCatchAllNo::TestClass, checks that packets are never older than the previous packet.
+ *
+ * @param packet Packet that was received, its age is its counter.
+ */
+static void NetModeUdpCatchAllNoTestRecvFunc(Packet & packet)
+{
+	size_t counter = static_cast<size_t>(packet.GetAge());
+	if(counter < NetModeUdpCatchAllNoTestLast)
+	{
+		NetModeUdpCatchAllNoTestOrderGood = false;
+	}
+	NetModeUdpCatchAllNoTestLast = counter;
+}
+
+/**
+ * @brief Deals with packets from client 0 at the same time as other threads,
+ * as completion port threads do when a socket has several receive operations in progress.
+ *
+ * @param lpParameter Pointer to ThreadSingle object, whose parameter is the NetModeUdpCatchAllNo object.
+ *
+ * @return 0.
+ */
+static DWORD WINAPI NetModeUdpCatchAllNoTestThread(LPVOID lpParameter)
+{
+	ThreadSingle * thread = static_cast<ThreadSingle*>(lpParameter);
+	NetModeUdpCatchAllNo * mode = static_cast<NetModeUdpCatchAllNo*>(thread->GetParameter());
+
+	Packet packet;
+	WSABUF buffer;
+	for(size_t n = 0;n<NET_MODE_UDP_CATCH_ALL_NO_TEST_AMOUNT;n++)
+	{
+		NetModeUdpCatchAllNoTestCounter.Enter();
+			packet.Clear();
+			packet.AddSizeT(NetModeUdpCatchAllNoTestCounter.Get());
+			NetModeUdpCatchAllNoTestCounter.Increase(1);
+		NetModeUdpCatchAllNoTestCounter.Leave();
+
+		packet.AddSizeT(n);
+		packet.PtrIntoWSABUF(buffer);
+		mode->DealWithData(buffer,packet.GetUsedSize(),&NetModeUdpCatchAllNoTestRecvFunc,0,0);
+	}
+
+	return 0;
+}
 
 /**
  * @brief Tests class.
@@ -212,6 +298,60 @@ bool NetModeUdpCatchAllNo::TestClass()
 		problem = true;	
 	}
 
+	// Compact headers
+	NetModeUdpCatchAllNo compactObj(10);
+	compactObj.SetCompactHeaders(true);
+
+	WSABUF buffer;
+	Packet compactPacket;
+	for(size_t n = 0;n<2;n++)
+	{
+		compactPacket.Clear();
+		compactObj.AddSendPrefix(compactPacket,4);
+		compactPacket.AddStringC(str,0,false);
+		compactPacket.PtrIntoWSABUF(buffer);
+		compactObj.DealWithData(buffer,compactPacket.GetUsedSize(),NULL,4,0);
+	}
+
+	if(compactObj.GetPacketAmount(4,0) != 2 || compactObj.GetPacketFromStore(&destination,4,0) != 2 ||
+	   destination.GetAge() != static_cast<clock_t>(INITIAL_COUNTER_VALUE) || destination != str ||
+	   compactPacket.GetUsedSize() != strlen(str) + 1)
+	{
+		cout << "DealWithData (compact headers) is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "DealWithData (compact headers) is good\n";
+	}
+
+	// Packets dealt with at the same time must still never be passed on out of order
+	{
+		const size_t numThreads = 4;
+		NetModeUdpCatchAllNo concurrentObj(1);
+
+		ThreadSingleGroup threads;
+		for(size_t n = 0;n<numThreads;n++)
+		{
+			ThreadSingle * thread = new (nothrow) ThreadSingle(&NetModeUdpCatchAllNoTestThread,&concurrentObj,n);
+			Utility::DynamicAllocCheck(thread,__LINE__,__FILE__);
+			threads.Add(thread);
+		}
+
+		threads.Resume();
+		threads.WaitForThreadsToExit();
+
+		if(NetModeUdpCatchAllNoTestOrderGood == false)
+		{
+			cout << "DealWithData (concurrent) is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "DealWithData (concurrent) is good\n";
+		}
+	}
+
 	cout << "\n\n";
 	return !problem;
 }
@@ -55,7 +55,8 @@ public:
 
 	void DealWithData(const WSABUF & buffer, size_t completionBytes, NetSocket::RecvFunc udpRecvFunc, size_t clientID, size_t instanceID);
 	
-	NetSend * GetSendObject(const Packet * packet, bool block);
+	void AddSendPrefix(Packet & destination, size_t clientID);
+	NetSend * GetSendObject(const Packet * packet, bool block, NetSendPool & pool);
 
 	ProtocolMode GetProtocolMode() const;
 
@@ -13,6 +13,8 @@
 NetModeUdpPerClient::NetModeUdpPerClient(size_t recvSize, size_t numClients, size_t numOperations, bool perOperation, const EncryptKey * decryptKey) : NetModeUdp()
 {
 	this->perOperation = perOperation;
+	this->sealer = NULL;
+	this->sealCounter = 0;
 
 	if(decryptKey == NULL)
 	{
@@ -63,6 +65,17 @@ void NetModeUdpPerClient::Copy(const NetModeUdpPerClient & copyMe)
 		this->decryptKey = new (nothrow) EncryptKey(*copyMe.decryptKey);
 		Utility::DynamicAllocCheck(this->decryptKey,__LINE__,__FILE__);
 	}
+
+	// The copy gets its own salt so that the two objects never generate the same nonce
+	delete this->sealer;
+	this->sealer = NULL;
+	this->sealCounter = 0;
+	if(copyMe.sealer != NULL)
+	{
+		this->sealer = new (nothrow) CipherGCM(*copyMe.sealer);
+		Utility::DynamicAllocCheck(this->sealer,__LINE__,__FILE__);
+		CipherGCM::GenerateRandom(sealSalt,SALT_SIZE);
+	}
 }
 
 /**
@@ -72,6 +85,7 @@ void NetModeUdpPerClient::Copy(const NetModeUdpPerClient & copyMe)
  */
 NetModeUdpPerClient::NetModeUdpPerClient(const NetModeUdpPerClient & copyMe) : NetModeUdp(copyMe)
 {
+	sealer = NULL;
 	Copy(copyMe);
 }
 
@@ -156,6 +170,7 @@ void NetModeUdpPerClient::Reset()
 NetModeUdpPerClient::~NetModeUdpPerClient()
 {
 	delete decryptKey;
+	delete sealer;
 }
 
 /**
@@ -185,7 +200,8 @@ void NetModeUdpPerClient::PacketDone(Packet * completePacket, NetSocket::RecvFun
 
 	if(udpRecvFunc == NULL)
 	{
-		packetStore[clientID][operationID] = *completePacket;
+		// Memory changes owner if completePacket owns it, otherwise data is copied
+		packetStore[clientID][operationID] = std::move(*completePacket);
 	}
 	else
 	{
@@ -202,11 +218,18 @@ void NetModeUdpPerClient::PacketDone(Packet * completePacket, NetSocket::RecvFun
  * data and that will be used to determine what client ID this packet refers to.\n\n
  *
  * Afterwards, if 'per operation' is enabled then a further integer of size_t type
- * will be extracted and its data will indicate the operation ID that the packet refers to.
+ * will be extracted and its data will indicate the operation ID that the packet refers to.\n\n
+ *
+ * These integers are added by the application and are always of size_t type (see Packet::AddSizeT()),
+ * even if compact headers are enabled (see NetModeUdp::SetCompactHeaders()).\n\n
+ *
+ * If authenticated encryption is enabled the packet is opened in place (see OpenSealed()) before
+ * anything after the clock value is read, and packets which fail authentication are discarded.
  *
  * @param buffer Newly received data.
  * @param completionBytes Number of bytes of new data stored in @a buffer.
  * @param [in] udpRecvFunc Method will be executed and data not added to the queue if this is non NULL.
+ * It is never executed for two packets with the same client and operation at the same time.
  * @param instanceID Instance that data was received on.
  * @param clientID ID of client that data was received from, set to 0 if not applicable.
  * If 0 then the client ID will be extracted from the packet directly.
@@ -221,17 +244,28 @@ void NetModeUdpPerClient::DealWithData(const WSABUF & buffer, size_t completionB
 
 	// Get clock value to determine age of packet
 	// Note: clock value is never encrypted
-	clock_t clock = static_cast<clock_t>(packetBuffer->GetSizeT());
+	size_t counter = GetHeaderSizeT(*packetBuffer);
+	clock_t clock = static_cast<clock_t>(counter);
 
 	// Ignore connection packets
-	// Connection packets have a prefix of 0
+	// Connection packets have a prefix of 0, the first byte of which is also 0 as a variable length integer
 	if(clock == 0)
 	{
+		delete packetBuffer;
 		return;
 	}
 
+	// Authenticate and decrypt, forged or corrupted packets are discarded
+	if(sealer != NULL)
+	{
+		if(OpenSealed(buffer,completionBytes,*packetBuffer,counter) == false)
+		{
+			delete packetBuffer;
+			return;
+		}
+	}
 	// If mnDecryptUDP was used, decrypt using preset key
-	if(decryptKey != NULL)
+	else if(decryptKey != NULL)
 	{
 		Packet::DecryptWSABUF(buffer, completionBytes - packetBuffer->GetCursor(), packetBuffer->GetCursor(), decryptKey);
 	}
@@ -254,31 +288,49 @@ void NetModeUdpPerClient::DealWithData(const WSABUF & buffer, size_t completionB
 		ValidateOperationID(operationID);
 	}
 
-	// Ignore old packets
-	if(clock <= packetStore[clientID][operationID].GetAge())
-	{
-		/* If the current clock value is vastly different to the last
-		 * clock value, then it is likely that the maximum for
-		 * the clock value was reached, and so it looped back round
-		 * to 0 */
-		if(packetStore[clientID][operationID].GetAge() - clock > packetStore[clientID][operationID].GetAge() / 2)
-		{
-			packetStore[clientID][operationID].SetAge(0);
-		}
-		else
-		{
-			delete packetBuffer;
-			return;
-		}
-	}
-
 	// Save packet
 	packetBuffer->SetInstance(instanceID);
 	packetBuffer->SetAge(clock);
 	packetBuffer->SetClientFrom(clientID);
 	packetBuffer->SetOperation(operationID);
 
-	PacketDone(packetBuffer,udpRecvFunc); // packetBuffer is cleaned up by this method
+	/**
+	 * With more than one receive operation in progress, packets for the same
+	 * store can be dealt with at the same time. The age is compared and the packet
+	 * dealt with in one step while holding the store's lock, otherwise an older
+	 * packet could pass the comparison at the same time as a newer packet and
+	 * overwrite it.
+	 */
+	Packet & store = packetStore[clientID][operationID];
+	store.Enter();
+	try
+	{
+		// Ignore old packets
+		if(clock <= store.GetAge())
+		{
+			/* If the current clock value is vastly different to the last
+			 * clock value, then it is likely that the maximum for
+			 * the clock value was reached, and so it looped back round
+			 * to 0 */
+			if(store.GetAge() - clock > store.GetAge() / 2)
+			{
+				store.SetAge(0);
+			}
+			else
+			{
+				delete packetBuffer;
+				packetBuffer = NULL;
+			}
+		}
+
+		if(packetBuffer != NULL)
+		{
+			PacketDone(packetBuffer,udpRecvFunc); // packetBuffer is cleaned up by this method
+		}
+	}
+	catch(ErrorReport & error){store.Leave(); throw error;}
+	catch(...){store.Leave(); throw -1;}
+	store.Leave();
 }
 
 /**
@@ -332,11 +384,22 @@ size_t NetModeUdpPerClient::GetPacketFromStore(Packet * destination, size_t clie
 
 	if(packetStore[clientID][operationID].GetUsedSize() > 0)
 	{
-		*destination = packetStore[clientID][operationID];
+		Packet & stored = packetStore[clientID][operationID];
+
+		if(destination->IsDataPtrChanged() == false)
+		{
+			// Destination takes the packet's memory, and its old memory is used for the next packet
+			destination->Swap(stored);
+			stored.SetAge(destination->GetAge());
+		}
+		else
+		{
+			*destination = stored;
+		}
 
 		// Do not used clear, because GetAge() must still return age
 		// of last received packet!
-		packetStore[clientID][operationID].SetUsedSize(0);
+		stored.SetUsedSize(0);
 
 		return 1;
 	}
@@ -392,20 +455,191 @@ void NetModeUdpPerClient::SetRecvCounter(size_t clientID, size_t operationID, cl
  *
  * @param packet Packet to send.
  * @param block True if sending should be synchronous, false if sending should be asynchronous.
+ * @param [in] pool Send object is taken from this pool where possible.
  *
  * @return a send object.
  */
-NetSend * NetModeUdpPerClient::GetSendObject(const Packet * packet, bool block)
+NetSend * NetModeUdpPerClient::GetSendObject(const Packet * packet, bool block, NetSendPool & pool)
 {
-	Packet aux;
-	aux.AddSizeT((size_t)clock());
+	NetSendPrefix * sendObject = pool.GetPrefix(packet,block);
 
-	NetSend * sendObject = new (nothrow) NetSendPrefix(packet,block,aux);
-	Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
+	if(sealer != NULL)
+	{
+		unsigned char nonce[CipherGCM::NONCE_SIZE];
+		AddSealedPrefix(sendObject->GetPrefix(),nonce);
+		sendObject->Seal(*sealer,nonce);
+	}
+	else
+	{
+		AddSendPrefix(sendObject->GetPrefix(),packet->GetClientFrom());
+	}
 	
 	return sendObject;
 }
 
+/**
+ * @brief Adds the clock value used to determine the age of a packet.
+ *
+ * If authenticated encryption is enabled the prefix of a sealed packet is added, but
+ * the packet itself must be sealed with the nonce, so GetSendObject() should be used instead.
+ *
+ * @param [out] destination Prefix is added to the end of this packet.
+ * @param clientID Ignored.
+ */
+void NetModeUdpPerClient::AddSendPrefix(Packet & destination, size_t clientID)
+{
+	if(sealer != NULL)
+	{
+		unsigned char nonce[CipherGCM::NONCE_SIZE];
+		AddSealedPrefix(destination,nonce);
+	}
+	else
+	{
+		AddHeaderSizeT(destination,(size_t)clock());
+	}
+}
+
+/**
+ * @brief Adds the prefix of a sealed packet and generates its nonce.
+ *
+ * The prefix is a clock value followed by NetModeUdpPerClient::sealSalt. The clock value is
+ * higher than that of the last sealed packet, even if clock() has not changed, so that no two
+ * packets sealed by this object have the same nonce. When the lower 32 bits of the clock value
+ * wrap, the salt is regenerated.
+ *
+ * @param [out] destination Prefix is added to the end of this packet.
+ * @param [out] nonce CipherGCM::NONCE_SIZE bytes are written here: the salt followed by the lower
+ * 32 bits of the clock value, big endian.
+ */
+void NetModeUdpPerClient::AddSealedPrefix(Packet & destination, unsigned char * nonce)
+{
+	sealLock.Enter();
+
+	size_t counter = static_cast<size_t>(clock());
+	if(counter <= sealCounter)
+	{
+		counter = sealCounter + 1;
+	}
+
+	if(counter == 0 || (static_cast<unsigned long long int>(counter) >> 32) != (static_cast<unsigned long long int>(sealCounter) >> 32))
+	{
+		try
+		{
+			CipherGCM::GenerateRandom(sealSalt,SALT_SIZE);
+		}
+		// Release control of all objects before throwing final exception
+		catch(ErrorReport & error){sealLock.Leave(); throw(error);}
+		catch(...){sealLock.Leave(); throw(-1);}
+	}
+
+	// A clock value of 0 indicates a connection packet, which may be read as a 32 bit clock_t
+	if(static_cast<unsigned int>(counter) == 0)
+	{
+		counter++;
+	}
+
+	sealCounter = counter;
+	memcpy(nonce,sealSalt,SALT_SIZE);
+
+	sealLock.Leave();
+
+	nonce[SALT_SIZE] = static_cast<unsigned char>(counter >> 24);
+	nonce[SALT_SIZE + 1] = static_cast<unsigned char>(counter >> 16);
+	nonce[SALT_SIZE + 2] = static_cast<unsigned char>(counter >> 8);
+	nonce[SALT_SIZE + 3] = static_cast<unsigned char>(counter);
+
+	AddHeaderSizeT(destination,counter);
+	destination.AddStringC(reinterpret_cast<const char*>(nonce),SALT_SIZE,false);
+}
+
+/**
+ * @brief Authenticates and decrypts a sealed packet in place.
+ *
+ * A sealed packet consists of the clock value, the salt, the encrypted data and
+ * the CipherGCM::TAG_SIZE byte authentication tag. The clock value and salt
+ * are authenticated but not encrypted.
+ *
+ * @param buffer Newly received data.
+ * @param completionBytes Number of bytes of new data stored in @a buffer.
+ * @param [in,out] packetBuffer Packet using @a buffer's memory, with its cursor after the clock value. On success
+ * its cursor is moved past the salt and the tag is removed from its used size.
+ * @param counter Clock value read from the packet.
+ *
+ * @return true if the packet is authentic and was decrypted, false if it should be discarded.
+ */
+bool NetModeUdpPerClient::OpenSealed(const WSABUF & buffer, size_t completionBytes, Packet & packetBuffer, size_t counter) const
+{
+	size_t prefixSize = packetBuffer.GetCursor() + SALT_SIZE;
+	if(completionBytes < prefixSize + CipherGCM::TAG_SIZE)
+	{
+		return false;
+	}
+
+	unsigned char * data = reinterpret_cast<unsigned char*>(buffer.buf);
+	size_t dataSize = completionBytes - prefixSize - CipherGCM::TAG_SIZE;
+
+	unsigned char nonce[CipherGCM::NONCE_SIZE];
+	memcpy(nonce,data + packetBuffer.GetCursor(),SALT_SIZE);
+	nonce[SALT_SIZE] = static_cast<unsigned char>(counter >> 24);
+	nonce[SALT_SIZE + 1] = static_cast<unsigned char>(counter >> 16);
+	nonce[SALT_SIZE + 2] = static_cast<unsigned char>(counter >> 8);
+	nonce[SALT_SIZE + 3] = static_cast<unsigned char>(counter);
+
+	if(sealer->Open(data + prefixSize,dataSize,data,prefixSize,nonce,data + prefixSize + dataSize) == false)
+	{
+		return false;
+	}
+
+	packetBuffer.SetUsedSize(completionBytes - CipherGCM::TAG_SIZE);
+	packetBuffer.SetCursor(prefixSize);
+	return true;
+}
+
+/**
+ * @brief Enables or disables authenticated encryption of packets.
+ *
+ * When enabled, sent packets are encrypted and authenticated using CipherGCM with the decryption key
+ * passed to the constructor, instead of being encrypted by the user. Received packets are opened in place
+ * and discarded if they were modified or forged, instead of being decrypted using Packet::Decrypt().\n\n
+ *
+ * Both ends must use the same option and key. This must not be changed while the object is in use.
+ *
+ * @param option True if authenticated encryption should be used, false if not.
+ *
+ * @throws ErrorReport If @a option is true and no decryption key was passed to the constructor.
+ */
+void NetModeUdpPerClient::SetAuthenticatedEncryption(bool option)
+{
+	if(option == true)
+	{
+		_ErrorException((decryptKey == NULL),"enabling authenticated encryption, a decryption key is required",0,__LINE__,__FILE__);
+
+		if(sealer == NULL)
+		{
+			CipherGCM::GenerateRandom(sealSalt,SALT_SIZE);
+			sealCounter = 0;
+
+			sealer = new (nothrow) CipherGCM(*decryptKey);
+			Utility::DynamicAllocCheck(sealer,__LINE__,__FILE__);
+		}
+	}
+	else
+	{
+		delete sealer;
+		sealer = NULL;
+	}
+}
+
+/**
+ * @brief Determines whether authenticated encryption is enabled, see SetAuthenticatedEncryption().
+ *
+ * @return true if authenticated encryption is enabled, false if not.
+ */
+bool NetModeUdpPerClient::IsAuthenticatedEncryption() const
+{
+	return sealer != NULL;
+}
+
 /**
  * @brief Retrieves the protocol mode in use.
  *
@@ -662,6 +896,114 @@ bool NetModeUdpPerClient::TestClass()
 		}
 	}
 
+	{
+		NetModeUdpPerClient obj(1024,10,7,true,NULL);
+		obj.SetCompactHeaders(true);
+
+		Packet destination;
+		WSABUF buffer;
+
+		// Connection packets use the normal format and must be ignored
+		Packet connection;
+		connection.AddSizeT(0);
+		connection.AddSizeT(3);
+		connection.PtrIntoWSABUF(buffer);
+		obj.DealWithData(buffer,connection.GetUsedSize(),NULL,0,1);
+
+		Packet packet;
+		obj.AddSendPrefix(packet,0);
+		size_t prefixSize = packet.GetUsedSize();
+
+		packet.Clear();
+		packet.AddVarSizeT(500); // Clock
+		packet.AddSizeT(10); // Client ID, added by the application so not compact
+		packet.AddSizeT(6); // Operation ID
+		packet.AddStringC(str,0,false);
+		packet.PtrIntoWSABUF(buffer);
+		obj.DealWithData(buffer,packet.GetUsedSize(),NULL,0,1);
+
+		if(prefixSize > Packet::varSizeTMaxBytes || obj.GetPacketAmount(3,0) != 0 ||
+		   obj.GetPacketFromStore(&destination,10,6) != 1 || destination.GetAge() != 500 ||
+		   destination.GetClientFrom() != 10 || destination.GetOperation() != 6 || destination.GetCursor() != 2 + 2 * Utility::LargestSupportedBytesInt)
+		{
+			cout << "DealWithData (compact headers) is bad\n";
+			problem = true;
+		}
+		else
+		{
+			destination.Erase(0,destination.GetCursor());
+			if(destination != str)
+			{
+				cout << "DealWithData (compact headers) is bad due to contents\n";
+				problem = true;
+			}
+			else
+			{
+				cout << "DealWithData (compact headers) is good\n";
+			}
+		}
+	}
+
+	{
+		EncryptKey key(1234,5678);
+		NetModeUdpPerClient sender(1024,10,1,false,&key);
+		NetModeUdpPerClient receiver(1024,10,1,false,&key);
+		sender.SetAuthenticatedEncryption(true);
+		receiver.SetAuthenticatedEncryption(true);
+
+		Packet packet;
+		packet.AddSizeT(4); // Client ID
+		packet.AddStringC(str,0,false);
+
+		// Datagram is formed from the buffers of the send object, as it would be by the socket
+		NetSendPool pool;
+		NetSend * sendObject = sender.GetSendObject(&packet,false,pool);
+		Packet datagram;
+		for(size_t n = 0;n<sendObject->GetBufferAmount();n++)
+		{
+			datagram.AddStringC(sendObject->GetBuffer()[n].buf,sendObject->GetBuffer()[n].len,false);
+		}
+		NetSendPool::Recycle(sendObject);
+
+		// Modified packets must be discarded
+		Packet modified(datagram);
+		modified.GetDataPtr()[modified.GetUsedSize() - CipherGCM::TAG_SIZE - 1] ^= 1;
+		WSABUF buffer;
+		modified.PtrIntoWSABUF(buffer);
+		receiver.DealWithData(buffer,modified.GetUsedSize(),NULL,0,1);
+		bool rejectGood = (receiver.GetPacketAmount(4,0) == 0);
+
+		datagram.PtrIntoWSABUF(buffer);
+		receiver.DealWithData(buffer,datagram.GetUsedSize(),NULL,0,1);
+
+		Packet destination;
+		bool openGood = (receiver.GetPacketFromStore(&destination,4,0) == 1 && destination.GetClientFrom() == 4);
+		if(openGood == true)
+		{
+			destination.Erase(0,destination.GetCursor());
+			openGood = (destination == str);
+		}
+
+		// Copies must generate different nonces
+		NetModeUdpPerClient * clone = sender.Clone();
+		Packet prefix;
+		Packet clonePrefix;
+		sender.AddSendPrefix(prefix,0);
+		clone->AddSendPrefix(clonePrefix,0);
+		bool cloneGood = (clone->IsAuthenticatedEncryption() == true && prefix != clonePrefix);
+		delete clone;
+
+		if(rejectGood == false || openGood == false || cloneGood == false)
+		{
+			cout << "SetAuthenticatedEncryption is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "SetAuthenticatedEncryption is good\n";
+		}
+	}
+
 
 	cout << "\n\n";
 	return !problem;
@@ -23,6 +23,9 @@
  *
  * For details on how to implement this system in a custom instance see DealWithData().\n\n
  *
+ * If authenticated encryption is enabled (see SetAuthenticatedEncryption()) the clock value is strictly
+ * increasing and is followed by a random salt; together they form the nonce of each sealed packet.\n\n
+ *
  * On the client and server side there is a packet store for each client which stores the newest
  * packet received from that client (in the case of server state) or referring to that client (in the case of client state).
  * Each store contains only one packet, reducing the overhead of a queue.\n\n
@@ -44,6 +47,21 @@ class NetModeUdpPerClient: public NetModeUdp
 
 	/** @brief Pointer to decryption key used to decrypt incoming packets before reading them. */
 	const EncryptKey * decryptKey;
+
+	/** @brief Number of random bytes placed after the clock value of sealed packets. */
+	static const size_t SALT_SIZE = 8;
+
+	/** @brief Seals sent packets and opens received packets, NULL if authenticated encryption is disabled. */
+	CipherGCM * sealer;
+
+	/** @brief Controls access to NetModeUdpPerClient::sealCounter and NetModeUdpPerClient::sealSalt. */
+	CriticalSection sealLock;
+
+	/** @brief Clock value of the last sealed packet, the clock value of each sealed packet is higher than the last. */
+	size_t sealCounter;
+
+	/** @brief Random salt placed after the clock value of sealed packets, regenerated when the clock value wraps. */
+	unsigned char sealSalt[SALT_SIZE];
 public:
 	NetModeUdpPerClient(size_t recvSize, size_t numClients, size_t numOperations, bool perOperation, const EncryptKey * decryptKey);
 	~NetModeUdpPerClient();
@@ -52,6 +70,9 @@ private:
 
 	void ValidateClientID(size_t clientID) const;
 	void ValidateOperationID(size_t operationID) const;
+
+	void AddSealedPrefix(Packet & destination, unsigned char * nonce);
+	bool OpenSealed(const WSABUF & buffer, size_t completionBytes, Packet & packetBuffer, size_t counter) const;
 public:
 	NetModeUdpPerClient(const NetModeUdpPerClient &);
 	NetModeUdpPerClient & operator= (const NetModeUdpPerClient &);
@@ -70,7 +91,11 @@ public:
 	clock_t GetRecvCounter(size_t clientID, size_t operationID);
 	void SetRecvCounter(size_t clientID, size_t operationID, clock_t newCounter);
 
-	NetSend * GetSendObject(const Packet * packet, bool block);
+	void SetAuthenticatedEncryption(bool option);
+	bool IsAuthenticatedEncryption() const;
+
+	void AddSendPrefix(Packet & destination, size_t clientID);
+	NetSend * GetSendObject(const Packet * packet, bool block, NetSendPool & pool);
 
 	ProtocolMode GetProtocolMode() const;
 	size_t GetNumOperations() const;
@@ -0,0 +1,530 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Allocates NetRecvUDP::buffer and, if batched, sets up NetRecvUDP::messages.
+ *
+ * @param bufferLength Length of receive buffer in bytes;
+ * this is the maximum amount of data that can be received in one datagram.
+ * @param batchSize Maximum number of messages received by one receive operation, ignored on Windows.
+ * @param coalescing True if UDP receive coalescing is enabled on the socket, ignored on Windows.
+ */
+void NetRecvUDP::Allocate(size_t bufferLength, size_t batchSize, bool coalescing)
+{
+	if(bufferLength > ULONG_MAX)
+	{
+		bufferLength = ULONG_MAX;
+	}
+
+#ifdef _WIN32
+	batchSize = 1;
+	coalescing = false;
+#else
+	if(batchSize > WSA_MAX_RECV_BATCH)
+	{
+		batchSize = WSA_MAX_RECV_BATCH;
+	}
+#endif
+	if(batchSize == 0)
+	{
+		batchSize = 1;
+	}
+
+	this->datagramLength = bufferLength;
+	this->batchSize = batchSize;
+	this->coalescing = coalescing;
+
+	// Coalesced messages contain several datagrams, so are larger than one datagram.
+	size_t messageLength = bufferLength;
+	if(coalescing == true && messageLength < COALESCED_BUFFER_LENGTH)
+	{
+		messageLength = COALESCED_BUFFER_LENGTH;
+	}
+
+	buffer.len = static_cast<ULONG>(messageLength);
+	if(messageLength > 0)
+	{
+		buffer.buf = new (nothrow) char[messageLength * batchSize];
+		Utility::DynamicAllocCheck(buffer.buf,__LINE__,__FILE__);
+	}
+	else
+	{
+		buffer.buf = NULL;
+	}
+
+#ifndef _WIN32
+	messages.clear();
+	messageAddresses.clear();
+	messagesReceived = 0;
+	if(batchSize > 1 || coalescing == true)
+	{
+		messages.resize(batchSize);
+		messageAddresses.resize(batchSize);
+		for(size_t n = 0;n<batchSize;n++)
+		{
+			memset(&messages[n],0,sizeof(WSABATCHMSG));
+			messages[n].buffer.buf = buffer.buf + (n * messageLength);
+			messages[n].buffer.len = static_cast<ULONG>(messageLength);
+			messages[n].from = reinterpret_cast<SOCKADDR*>(messageAddresses[n].GetAddrPtr());
+		}
+	}
+#endif
+
+	datagrams.reserve(batchSize);
+	datagramAddresses.reserve(batchSize);
+}
+
+/**
+ * @brief Constructor.
+ *
+ * @param bufferLength Length of receive buffer in bytes;
+ * this is the maximum amount of data that can be received in one datagram.
+ * @param batchSize Maximum number of messages received by one receive operation (optional, default 1).
+ * Ignored on Windows.
+ * @param coalescing True if UDP receive coalescing is enabled on the socket (optional, default false).
+ * Ignored on Windows.
+ */
+NetRecvUDP::NetRecvUDP(size_t bufferLength, size_t batchSize, bool coalescing) : overlappedEvent(true), idle(true), recvAddr()
+{
+	SecureZeroMemory(&overlapped,sizeof(WSAOVERLAPPED));
+	overlapped.hEvent = overlappedEvent.GetEventHandle();
+	flags = 0;
+	recvAddrLength = 0;
+
+	Allocate(bufferLength,batchSize,coalescing);
+}
+
+/**
+ * @brief Deep copy constructor.
+ *
+ * Operation does not copy the contents of @a copyMe, but initializes its buffer
+ * to be the same size as @a copyMe's.
+ *
+ * @param copyMe Object to copy.
+ */
+NetRecvUDP::NetRecvUDP(const NetRecvUDP & copyMe) : overlappedEvent(true), idle(true), recvAddr()
+{
+	SecureZeroMemory(&overlapped,sizeof(WSAOVERLAPPED));
+	overlapped.hEvent = overlappedEvent.GetEventHandle();
+	flags = 0;
+	recvAddrLength = 0;
+
+	Allocate(copyMe.datagramLength,copyMe.batchSize,copyMe.coalescing);
+}
+
+/**
+ * @brief Deep assignment operator.
+ *
+ * Operation does not copy the contents of @a copyMe, but initializes its buffer
+ * to be the same size as @a copyMe's.
+ *
+ * @param copyMe Object to copy.
+ *
+ * @return reference to this object.
+ */
+NetRecvUDP & NetRecvUDP::operator=(const NetRecvUDP & copyMe)
+{
+	if(this->datagramLength != copyMe.datagramLength || this->batchSize != copyMe.batchSize || this->coalescing != copyMe.coalescing)
+	{
+		delete[] buffer.buf;
+		Allocate(copyMe.datagramLength,copyMe.batchSize,copyMe.coalescing);
+	}
+	return *this;
+}
+
+/**
+ * @brief Destructor.
+ */
+NetRecvUDP::~NetRecvUDP()
+{
+	const char * cCommand = "an internal function (~NetRecvUDP)";
+	try
+	{
+		delete[] buffer.buf;
+	}
+	MSG_CATCH
+}
+
+/**
+ * @brief Determines whether the operation is idle and so can be started.
+ *
+ * @return true if no receive operation is in progress and all received data has been dealt with.
+ */
+bool NetRecvUDP::IsIdle() const
+{
+	return idle.Get();
+}
+
+/**
+ * @brief Prepares for a new receive operation, the operation is no longer idle.
+ *
+ * This must be done before every receive operation.
+ */
+void NetRecvUDP::Begin()
+{
+	idle.Set(false);
+
+	overlapped.Internal = 0;
+	overlapped.InternalHigh = 0;
+	overlapped.Offset = 0;
+	overlapped.OffsetHigh = 0;
+	overlapped.Pointer = 0;
+	flags = 0;
+	recvAddr.Clear();
+	recvAddrLength = *NetUtility::GetSizeSOCKADDR();
+
+#ifndef _WIN32
+	messagesReceived = 0;
+	for(size_t n = 0;n<messages.size();n++)
+	{
+		messageAddresses[n].Clear();
+		messages[n].fromLength = *NetUtility::GetSizeSOCKADDR();
+		messages[n].bytes = 0;
+		messages[n].segmentSize = 0;
+		messages[n].error = 0;
+	}
+#endif
+}
+
+/**
+ * @brief Returns the operation to idle after it failed to start.
+ *
+ * When an overlapped receive operation fails before pending the overlapped
+ * event object is not automatically signaled, so this is done manually.
+ */
+void NetRecvUDP::Failed()
+{
+	overlappedEvent.Set(true);
+	idle.Set(true);
+}
+
+/**
+ * @brief Returns the operation to idle after it completed and its data was dealt with.
+ *
+ * @warning Should only be used by completion port.
+ */
+void NetRecvUDP::Finished()
+{
+	idle.Set(true);
+}
+
+/**
+ * @brief Waits until the operation is idle.
+ */
+void NetRecvUDP::WaitUntilIdle() const
+{
+	overlappedEvent.WaitUntilSignaled();
+	idle.WaitUntilSignaled();
+}
+
+/**
+ * @brief Determines the size of the receive buffer.
+ *
+ * @return the maximum amount of data that can be received by the operation.
+ */
+size_t NetRecvUDP::GetBufferLength() const
+{
+	return datagramLength;
+}
+
+/**
+ * @brief Determines the maximum number of messages received by one receive operation.
+ *
+ * @return the batch size, always 1 on Windows.
+ */
+size_t NetRecvUDP::GetBatchSize() const
+{
+	return batchSize;
+}
+
+/**
+ * @brief Determines whether the operation should be started with WSARecvFromBatch.
+ *
+ * @return true if the operation is batched, always false on Windows.
+ */
+bool NetRecvUDP::IsBatched() const
+{
+#ifdef _WIN32
+	return false;
+#else
+	return messages.empty() == false;
+#endif
+}
+
+/**
+ * @brief Determines whether the operation expects UDP receive coalescing.
+ *
+ * @return true if coalescing is enabled, always false on Windows.
+ */
+bool NetRecvUDP::IsCoalescing() const
+{
+	return coalescing;
+}
+
+/**
+ * @brief Adds a datagram to NetRecvUDP::datagrams, discarding it if it is too large.
+ *
+ * @param data Datagram data.
+ * @param length Length of @a data in bytes.
+ * @param from Address that datagram was received from.
+ */
+void NetRecvUDP::AddDatagram(char * data, size_t length, const NetAddress * from)
+{
+	if(length == 0 || length > datagramLength)
+	{
+		return;
+	}
+
+	WSABUF datagram;
+	datagram.buf = data;
+	datagram.len = static_cast<ULONG>(length);
+	datagrams.push_back(datagram);
+	datagramAddresses.push_back(from);
+}
+
+/**
+ * @brief Splits the data received by a completed operation into datagrams.
+ *
+ * Must be called once after the operation completes and before any other datagram methods are used.
+ * Truncated datagrams and datagrams larger than GetBufferLength() are discarded.
+ *
+ * @param completionBytes Number of bytes reported by the completion port.
+ *
+ * @return the number of datagrams received.
+ */
+size_t NetRecvUDP::Received(DWORD completionBytes)
+{
+	datagrams.clear();
+	datagramAddresses.clear();
+
+#ifndef _WIN32
+	if(IsBatched() == true)
+	{
+		for(size_t n = 0;n<messagesReceived && n<messages.size();n++)
+		{
+			const WSABATCHMSG & message = messages[n];
+			if(message.error != 0)
+			{
+				continue;
+			}
+
+			// Coalesced messages consist of datagrams of segmentSize bytes, the last may be smaller.
+			size_t segmentSize = message.segmentSize;
+			if(segmentSize == 0)
+			{
+				segmentSize = message.bytes;
+			}
+
+			for(size_t offset = 0;offset<message.bytes;offset+=segmentSize)
+			{
+				size_t length = message.bytes - offset;
+				if(length > segmentSize)
+				{
+					length = segmentSize;
+				}
+				AddDatagram(message.buffer.buf + offset,length,&messageAddresses[n]);
+			}
+		}
+		return datagrams.size();
+	}
+#endif
+
+	AddDatagram(buffer.buf,completionBytes,&recvAddr);
+	return datagrams.size();
+}
+
+/**
+ * @brief Determines the number of datagrams found by Received().
+ *
+ * @return the number of datagrams.
+ */
+size_t NetRecvUDP::GetDatagramAmount() const
+{
+	return datagrams.size();
+}
+
+/**
+ * @brief Retrieves the datagrams found by Received().
+ *
+ * @return array of GetDatagramAmount() datagrams, the length of each is stored in WSABUF::len.
+ */
+const WSABUF * NetRecvUDP::GetDatagrams() const
+{
+	if(datagrams.empty() == true)
+	{
+		return NULL;
+	}
+	return &datagrams[0];
+}
+
+/**
+ * @brief Retrieves the address that a datagram found by Received() came from.
+ *
+ * @param datagram Index of datagram.
+ *
+ * @return the remote address that the datagram was sent from.
+ * @throws ErrorReport If @a datagram is out of bounds.
+ */
+const NetAddress & NetRecvUDP::GetDatagramAddress(size_t datagram) const
+{
+	_ErrorException((datagram >= datagramAddresses.size()),"retrieving the address of a received UDP datagram, datagram is out of bounds",0,__LINE__,__FILE__);
+	return *datagramAddresses[datagram];
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool NetRecvUDP::TestClass()
+{
+	cout << "Testing NetRecvUDP class...\n";
+	bool problem = false;
+
+	NetRecvUDP operation(1024);
+	if(operation.GetBufferLength() != 1024 || operation.IsIdle() == false)
+	{
+		cout << "Constructor is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Constructor is good\n";
+	}
+
+	operation.Begin();
+	if(operation.IsIdle() == true || operation.recvAddrLength != *NetUtility::GetSizeSOCKADDR())
+	{
+		cout << "Begin is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Begin is good\n";
+	}
+
+	operation.Finished();
+	operation.WaitUntilIdle();
+	if(operation.IsIdle() == false)
+	{
+		cout << "Finished is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Finished is good\n";
+	}
+
+	memcpy(operation.buffer.buf,"hello",5);
+	if(operation.Received(5) != 1 || operation.GetDatagrams()[0].len != 5 || &operation.GetDatagramAddress(0) != &operation.recvAddr)
+	{
+		cout << "Received is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Received is good\n";
+	}
+
+	if(operation.Received(0) != 0 || operation.Received(2048) != 0)
+	{
+		cout << "Received (discard) is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Received (discard) is good\n";
+	}
+
+#ifndef _WIN32
+	NetRecvUDP batch(100,4,true);
+	batch.Begin();
+	batch.messagesReceived = 2;
+	batch.messages[0].bytes = 250;
+	batch.messages[0].segmentSize = 100;
+	batch.messages[1].bytes = 50;
+	batch.messages[2].bytes = 50;
+	if(batch.IsBatched() == false || batch.Received(300) != 4 ||
+	   batch.GetDatagrams()[2].len != 50 || batch.GetDatagrams()[3].buf != batch.messages[1].buffer.buf ||
+	   &batch.GetDatagramAddress(3) != &batch.messageAddresses[1])
+	{
+		cout << "Received (batch) is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Received (batch) is good\n";
+	}
+
+	// Datagrams already waiting on the socket when the operation starts
+	// must be taken by a single receive call.
+	NetUtility::SetupCompletionPort(2);
+	NetUtility::StartWinsock();
+	{
+		const size_t preloadAmount = 16;
+		const char * localHost = NetUtility::ConvertDomainNameToIP("localhost").GetIP();
+		NetSocketUDP sender(1024,NetAddress(localHost,0),false,new NetModeUdpCatchAll(1));
+		NetSocketUDP receiver(1024,NetAddress(localHost,0),false,new NetModeUdpCatchAll(1),NULL,1,preloadAmount);
+		sender.Connect(receiver.GetLocalAddress());
+		receiver.Connect(sender.GetLocalAddress());
+
+		Packet sendPacket("hello preload");
+		for(size_t n = 0;n<preloadAmount;n++)
+		{
+			sender.Send(sendPacket,false,NULL,INFINITE);
+		}
+
+		// Loopback sends are queued on the receiving socket by the time they complete
+		DWORD startTime = GetTickCount();
+		while(sender.GetSendMemorySize() > 0 && GetTickCount() - startTime < 5000)
+		{
+			Sleep(10);
+		}
+
+		receiver.Recv();
+
+		size_t received = 0;
+		Packet receivedPacket;
+		startTime = GetTickCount();
+		while(received < preloadAmount && GetTickCount() - startTime < 5000)
+		{
+			if(receiver.GetPacketFromStore(&receivedPacket,0,0) > 0)
+			{
+				received++;
+			}
+			else
+			{
+				Sleep(10);
+			}
+		}
+
+		if(received != preloadAmount || receiver.GetRecvCallCount() != 1 || receiver.GetRecvPacketsPerCall() != static_cast<double>(preloadAmount))
+		{
+			cout << "Received (preloaded socket) is bad: " << received << " of " << preloadAmount << " received, " << receiver.GetRecvPacketsPerCall() << " packets per receive call\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Received (preloaded socket) is good: " << receiver.GetRecvPacketsPerCall() << " packets per receive call\n";
+		}
+	}
+	NetUtility::FinishWinsock();
+	NetUtility::DestroyCompletionPort();
+#endif
+
+	NetRecvUDP copy(operation);
+	if(copy.GetBufferLength() != operation.GetBufferLength() || copy.buffer.buf == operation.buffer.buf ||
+	   copy.overlapped.hEvent == operation.overlapped.hEvent)
+	{
+		cout << "Copy constructor is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Copy constructor is good\n";
+	}
+
+	cout << "\n\n";
+	return !problem;
+}
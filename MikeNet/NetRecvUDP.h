@@ -0,0 +1,140 @@
+#pragma once
+
+/**
+ * @brief Receive operation used by NetSocketUDP.
+ *
+ * Each receive operation has its own buffer, address and overlapped object, so that
+ * a UDP socket can have several receive operations in progress at once and the
+ * completion port can deal with the data of one while others are still receiving.\n\n
+ *
+ * On Linux an operation can receive a batch of datagrams with one system call (see WSARecvFromBatch),
+ * optionally with UDP receive coalescing. Once the operation has completed, Received() splits what
+ * was received into individual datagrams. Batches are not supported on Windows, where
+ * the batch size is always 1.\n\n
+ *
+ * An operation is idle when no winsock receive operation is in progress and
+ * any data it received has been dealt with. Only idle operations can be started.\n\n
+ *
+ * This class is not thread safe.
+ */
+class NetRecvUDP
+{
+public:
+	/** @brief Length of each message buffer when UDP receive coalescing is enabled, large enough for any coalesced message. */
+	static const size_t COALESCED_BUFFER_LENGTH = 65535;
+
+private:
+	/**
+	 * @brief Event object associated with NetRecvUDP::overlapped.
+	 *
+	 * See NetSocket::recvOverlappedEvent for details on the stages that the event goes through.
+	 */
+	ConcurrencyEvent overlappedEvent;
+
+	/**
+	 * @brief Signaled while the operation is idle.
+	 *
+	 * This is important during the socket closure process so that resources being used are not cleaned up.
+	 */
+	ConcurrencyEvent idle;
+
+	/** @brief Maximum size of a datagram, larger datagrams are discarded. */
+	size_t datagramLength;
+
+	/** @brief Maximum number of messages received by one receive operation. */
+	size_t batchSize;
+
+	/** @brief True if UDP receive coalescing is enabled on the socket. */
+	bool coalescing;
+
+	/** @brief Datagrams received by the last completed operation, filled by Received(). */
+	vector<WSABUF> datagrams;
+
+	/** @brief Address that each element of NetRecvUDP::datagrams was received from. */
+	vector<const NetAddress*> datagramAddresses;
+
+	void Allocate(size_t bufferLength, size_t batchSize, bool coalescing);
+	void AddDatagram(char * data, size_t length, const NetAddress * from);
+public:
+	/**
+	 * @brief Winsock overlapped operation used to identify when the receive operation has completed.
+	 *
+	 * Public access rights so that winsock has access to it.
+	 */
+	WSAOVERLAPPED overlapped;
+
+	/**
+	 * @brief Winsock buffer that is filled with newly received data.
+	 *
+	 * If the operation is batched this is the memory of all messages, and its length is that of one message.
+	 * Public access rights so that winsock has access to it.
+	 */
+	WSABUF buffer;
+
+	/**
+	 * @brief Filled when receive operation completes, is ignored but required by winsock.
+	 *
+	 * Public access rights so that winsock has access to it.
+	 */
+	DWORD flags;
+
+	/**
+	 * @brief Filled with address that the received packet came from.
+	 *
+	 * Public access rights so that winsock has access to it.
+	 */
+	NetAddress recvAddr;
+
+	/**
+	 * @brief Length of NetRecvUDP::recvAddr, filled by winsock.
+	 *
+	 * Public access rights so that winsock has access to it.
+	 */
+	int recvAddrLength;
+
+#ifndef _WIN32
+	/**
+	 * @brief Messages of a batched receive operation, empty if the operation is not batched.
+	 *
+	 * Public access rights so that WSARecvFromBatch has access to it.
+	 */
+	vector<WSABATCHMSG> messages;
+
+	/**
+	 * @brief Filled with address that each element of NetRecvUDP::messages came from.
+	 *
+	 * Public access rights so that WSARecvFromBatch has access to it.
+	 */
+	vector<NetAddress> messageAddresses;
+
+	/**
+	 * @brief Filled with number of messages received by a batched receive operation.
+	 *
+	 * Public access rights so that WSARecvFromBatch has access to it.
+	 */
+	DWORD messagesReceived;
+#endif
+
+	NetRecvUDP(size_t bufferLength, size_t batchSize = 1, bool coalescing = false);
+	NetRecvUDP(const NetRecvUDP & copyMe);
+	NetRecvUDP & operator=(const NetRecvUDP & copyMe);
+	~NetRecvUDP();
+
+	bool IsIdle() const;
+	void Begin();
+	void Failed();
+	void Finished();
+	void WaitUntilIdle() const;
+
+	size_t GetBufferLength() const;
+	size_t GetBatchSize() const;
+	bool IsBatched() const;
+	bool IsCoalescing() const;
+
+	size_t Received(DWORD completionBytes);
+	size_t GetDatagramAmount() const;
+	const WSABUF * GetDatagrams() const;
+	const NetAddress & GetDatagramAddress(size_t datagram) const;
+
+	static bool TestClass();
+};
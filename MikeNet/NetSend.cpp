@@ -6,13 +6,113 @@
  * @param	block	True if the send operation should be synchronous, false if it should be asynchronous. 
  */
 NetSend::NetSend(bool block) : overlappedEvent(true)
+{
+	pool = NULL;
+	list = NULL;
+	listPrevious = NULL;
+	listNext = NULL;
+	bucketNext = NULL;
+	Reinitialize(block);
+}
+
+/**
+ * @brief Prepares the object for a new send operation.
+ *
+ * Used by the constructor and by subclasses when they are reused by a NetSendPool,
+ * the event object is reused rather than being created again.
+ *
+ * @param	block	True if the send operation should be synchronous, false if it should be asynchronous.
+ */
+void NetSend::Reinitialize(bool block)
 {
 	SecureZeroMemory(&overlapped,sizeof(WSAOVERLAPPED));
 	overlapped.hEvent = overlappedEvent.GetEventHandle();
+	overlappedEvent.Set(true);
+	bytes = 0;
 
 	this->block = block;
 }
 
+/**
+ * @brief Copies a packet into a buffer owned by this object.
+ *
+ * If the packet fits into NetSend::inlineBuffer then that is used, otherwise
+ * memory is allocated. The buffer must be released using ReleaseBuffer().
+ *
+ * @param packet Packet to copy.
+ * @param [out] destination Filled with the copy of @a packet, existing contents is ignored.
+ */
+void NetSend::CopyIntoBuffer(const Packet & packet, WSABUF & destination)
+{
+	packet.Enter();
+	try
+	{
+		if(packet.GetUsedSize() <= INLINE_BUFFER_LENGTH)
+		{
+			WSABUF data;
+			packet.PtrIntoWSABUF(data);
+
+			memcpy(inlineBuffer,data.buf,data.len);
+			destination.buf = inlineBuffer;
+			destination.len = data.len;
+		}
+		else
+		{
+			packet.CopyIntoWSABUF(destination);
+		}
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){packet.Leave(); throw(error);}
+	catch(...){packet.Leave(); throw(-1);}
+	packet.Leave();
+}
+
+/**
+ * @brief Releases a buffer filled by CopyIntoBuffer().
+ *
+ * @param [in,out] buffer Buffer to release, it is emptied.
+ */
+void NetSend::ReleaseBuffer(WSABUF & buffer)
+{
+	if(buffer.buf != inlineBuffer)
+	{
+		delete[] buffer.buf;
+	}
+
+	buffer.buf = NULL;
+	buffer.len = 0;
+}
+
+/**
+ * @brief Retrieves the pool that this object is returned to when it is no longer in use.
+ *
+ * @return pool, or NULL if this object should be deleted when it is no longer in use.
+ */
+NetSendPool * NetSend::GetPool() const
+{
+	return pool;
+}
+
+/**
+ * @brief Sets the pool that this object is returned to when it is no longer in use.
+ *
+ * @param pool Pool, may be NULL.
+ */
+void NetSend::SetPool(NetSendPool * pool)
+{
+	this->pool = pool;
+}
+
+/**
+ * @brief Retrieves the type of this send object, so that a NetSendPool knows where to store it.
+ *
+ * @return NetSend::TYPE_AMOUNT, subclasses that can be stored by a NetSendPool override this.
+ */
+NetSend::PoolType NetSend::GetPoolType() const
+{
+	return TYPE_AMOUNT;
+}
+
 /**
  * @brief Destructor.
  */
@@ -99,6 +199,35 @@ private:
 	{
 		return 0;
 	}
+
+	/** 
+	 * @brief Implements virtual method, does nothing.
+	 */
+	void Cleanup()
+	{
+
+	}
+public:
+	/**
+	 * @brief Gives access to protected method.
+	 *
+	 * @param packet Packet to copy.
+	 * @param [out] destination Filled with the copy of @a packet.
+	 */
+	void TestCopyIntoBuffer(const Packet & packet, WSABUF & destination)
+	{
+		CopyIntoBuffer(packet,destination);
+	}
+
+	/**
+	 * @brief Gives access to protected method.
+	 *
+	 * @param [in,out] buffer Buffer to release.
+	 */
+	void TestReleaseBuffer(WSABUF & buffer)
+	{
+		ReleaseBuffer(buffer);
+	}
 };
 
 
@@ -159,6 +288,45 @@ bool NetSend::TestClass()
 			cout << "_WaitForCompletion is good\n";
 		}
 	}
+
+	{
+		TestNetSend obj(false);
+
+		Packet smallPacket("hello world");
+		Packet largePacket;
+		largePacket.SetMemorySize(NetSend::INLINE_BUFFER_LENGTH * 2);
+		for(size_t n = 0;n<NetSend::INLINE_BUFFER_LENGTH * 2;n++)
+		{
+			largePacket.Add('a');
+		}
+
+		WSABUF smallBuffer;
+		WSABUF largeBuffer;
+		obj.TestCopyIntoBuffer(smallPacket,smallBuffer);
+		obj.TestCopyIntoBuffer(largePacket,largeBuffer);
+
+		if(smallPacket.compareWSABUF(smallBuffer,smallBuffer.len) == false || largePacket.compareWSABUF(largeBuffer,largeBuffer.len) == false)
+		{
+			cout << "CopyIntoBuffer is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "CopyIntoBuffer is good\n";
+		}
+
+		obj.TestReleaseBuffer(smallBuffer);
+		obj.TestReleaseBuffer(largeBuffer);
+		if(smallBuffer.buf != NULL || largeBuffer.buf != NULL || smallBuffer.len != 0)
+		{
+			cout << "ReleaseBuffer is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "ReleaseBuffer is good\n";
+		}
+	}
 	
 	cout << "\n\n";
 	return !problem;
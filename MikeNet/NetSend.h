@@ -1,5 +1,8 @@
 #pragma once
 #include "ConcurrencyEvent.h"
+class NetSendPool;
+class NetSendList;
+class Packet;
 
 /**
  * @brief Base class for sendable objects which can be used in conjunction with winsock WSASend.
@@ -9,13 +12,65 @@
  *
  * This class inherits CriticalSection because: After this object is added to the send
  * cleanup list, we must have control of this object until it has finished using its own data,
- * because otherwise it may be cleaned up before it is done using them.
+ * because otherwise it may be cleaned up before it is done using them.\n\n
+ *
+ * Send objects can be reused via a NetSendPool, in which case the event object and critical section
+ * are created once and small packets are copied into NetSend::inlineBuffer instead of memory allocated from the heap.
  */
 class NetSend : public CriticalSection
 {
+public:
+	/** @brief Packets of this size or smaller are copied into NetSend::inlineBuffer by CopyIntoBuffer(). */
+	static const size_t INLINE_BUFFER_LENGTH = 256;
+
+	/** @brief Types of send object that a NetSendPool can store, used to index NetSendPool::idle. */
+	enum PoolType
+	{
+		/** @brief NetSendRaw. */
+		RAW,
+
+		/** @brief NetSendPrefix. */
+		PREFIX,
+
+		/** @brief NetSendPostfix. */
+		POSTFIX,
+
+		/** @brief NetSendShared. */
+		SHARED,
+
+		/** @brief Number of types, also used for types that cannot be stored. */
+		TYPE_AMOUNT
+	};
+
+private:
 	/** @brief True if send operation should be synchronous, false if send operation should be asynchronous. */
 	bool block;
 
+	/** @brief Pool that this object is returned to when it is no longer in use, may be NULL. */
+	NetSendPool * pool;
+
+	/** @brief Stores a copy of small packets so that no memory needs to be allocated. */
+	char inlineBuffer[INLINE_BUFFER_LENGTH];
+
+	/** @brief List that this object is stored in while the send operation is in progress, NULL if none. */
+	NetSendList * list;
+
+	/** @brief Previous send operation in NetSend::list. */
+	NetSend * listPrevious;
+
+	/** @brief Next send operation in NetSend::list. */
+	NetSend * listNext;
+
+	/** @brief Next send operation in the same NetSend::list hash bucket. */
+	NetSend * bucketNext;
+
+	friend class NetSendList;
+
+protected:
+	void Reinitialize(bool block);
+	void CopyIntoBuffer(const Packet & packet, WSABUF & destination);
+	void ReleaseBuffer(WSABUF & buffer);
+
 public:
 	/** @brief Event object that is signaled when the send operation completes, and non signaled in its duration. */
 	ConcurrencyEvent overlappedEvent;
@@ -33,6 +88,16 @@ public:
 	size_t GetTotalBufferLength();
 	bool IsBlocking() const;
 
+	NetSendPool * GetPool() const;
+	void SetPool(NetSendPool * pool);
+	virtual PoolType GetPoolType() const;
+
+	/**
+	 * @brief Releases resources that are only needed while the send operation is in progress,
+	 * so that this object can be stored in a NetSendPool until it is reused.
+	 */
+	virtual void Cleanup() = 0;
+
 	/** 
 	 * @brief Retrieves an array of WSABUF structures containing
 	 * data to send.
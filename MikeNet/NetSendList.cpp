@@ -0,0 +1,290 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Constructor.
+ */
+NetSendList::NetSendList() : CriticalSection()
+{
+	first = NULL;
+	last = NULL;
+	amount = 0;
+	buckets.resize(INITIAL_BUCKET_AMOUNT,NULL);
+}
+
+/**
+ * @brief Destructor, send objects still in the list are not deleted.
+ */
+NetSendList::~NetSendList()
+{
+
+}
+
+/**
+ * @brief Determines which hash bucket a send operation belongs in.
+ *
+ * @param operation Overlapped object of send operation.
+ *
+ * @return element of NetSendList::buckets.
+ */
+size_t NetSendList::GetBucket(const WSAOVERLAPPED * operation) const
+{
+	// Low bits are the same for all objects because of alignment
+	size_t key = reinterpret_cast<size_t>(operation);
+	key = (key >> 4) ^ (key >> 12) ^ (key >> 20);
+
+	return key & (buckets.size() - 1);
+}
+
+/**
+ * @brief Changes the number of hash buckets, moving each send operation to its new bucket.
+ *
+ * @param bucketAmount New number of buckets, must be a power of 2.
+ */
+void NetSendList::Rehash(size_t bucketAmount)
+{
+	buckets.assign(bucketAmount,NULL);
+
+	for(NetSend * send = first;send != NULL;send = send->listNext)
+	{
+		size_t bucket = GetBucket(&send->overlapped);
+		send->bucketNext = buckets[bucket];
+		buckets[bucket] = send;
+	}
+}
+
+/**
+ * @brief Adds a send operation to the end of the list.
+ *
+ * @param [in] send Send operation to add, must not be in a list already.
+ */
+void NetSendList::Add(NetSend * send)
+{
+	_ErrorException((send == NULL),"adding a send operation to a list, send operation must not be NULL",0,__LINE__,__FILE__);
+
+	Enter();
+	try
+	{
+		_ErrorException((send->list != NULL),"adding a send operation to a list, send operation is already in a list",0,__LINE__,__FILE__);
+
+		// Keep buckets short
+		if(amount >= buckets.size())
+		{
+			Rehash(buckets.size() * 2);
+		}
+
+		send->list = this;
+		send->listPrevious = last;
+		send->listNext = NULL;
+
+		if(last == NULL)
+		{
+			first = send;
+		}
+		else
+		{
+			last->listNext = send;
+		}
+		last = send;
+
+		size_t bucket = GetBucket(&send->overlapped);
+		send->bucketNext = buckets[bucket];
+		buckets[bucket] = send;
+
+		amount++;
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){Leave(); throw(error);}
+	catch(...){Leave(); throw(-1);}
+	Leave();
+}
+
+/**
+ * @brief Removes a send operation from the list.
+ *
+ * @param [in] send Send operation to remove, must be in this list.
+ */
+void NetSendList::Remove(NetSend * send)
+{
+	_ErrorException((send == NULL),"removing a send operation from a list, send operation must not be NULL",0,__LINE__,__FILE__);
+
+	Enter();
+	try
+	{
+		_ErrorException((send->list != this),"removing a send operation from a list, send operation is not in this list",0,__LINE__,__FILE__);
+
+		// Unlink from list
+		if(send->listPrevious == NULL)
+		{
+			first = send->listNext;
+		}
+		else
+		{
+			send->listPrevious->listNext = send->listNext;
+		}
+
+		if(send->listNext == NULL)
+		{
+			last = send->listPrevious;
+		}
+		else
+		{
+			send->listNext->listPrevious = send->listPrevious;
+		}
+
+		// Unlink from bucket
+		NetSend ** link = &buckets[GetBucket(&send->overlapped)];
+		while(*link != send)
+		{
+			link = &(*link)->bucketNext;
+		}
+		*link = send->bucketNext;
+
+		send->list = NULL;
+		send->listPrevious = NULL;
+		send->listNext = NULL;
+		send->bucketNext = NULL;
+
+		amount--;
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){Leave(); throw(error);}
+	catch(...){Leave(); throw(-1);}
+	Leave();
+}
+
+/**
+ * @brief Searches for the send operation that is using the specified overlapped object.
+ *
+ * @param operation Overlapped object, does not need to belong to a send operation.
+ *
+ * @return send operation in this list that is using @a operation, or NULL if there is none.
+ */
+NetSend * NetSendList::Find(const WSAOVERLAPPED * operation) const
+{
+	Enter();
+
+	NetSend * send = buckets[GetBucket(operation)];
+	while(send != NULL && &send->overlapped != operation)
+	{
+		send = send->bucketNext;
+	}
+
+	Leave();
+
+	return send;
+}
+
+/**
+ * @brief Determines whether a send operation is in this list.
+ *
+ * @param send Send operation.
+ *
+ * @return true if @a send is in this list.
+ */
+bool NetSendList::Contains(const NetSend * send) const
+{
+	Enter();
+	bool returnMe = (send->list == this);
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Retrieves the oldest send operation in the list.
+ *
+ * @return oldest send operation, or NULL if the list is empty.
+ */
+NetSend * NetSendList::GetFirst() const
+{
+	Enter();
+	NetSend * returnMe = first;
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Retrieves the number of send operations in the list.
+ *
+ * @return number of send operations.
+ */
+size_t NetSendList::Size() const
+{
+	Enter();
+	size_t returnMe = amount;
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool NetSendList::TestClass()
+{
+	cout << "Testing NetSendList class...\n";
+	bool problem = false;
+
+	Packet packet("hello world");
+	NetSendList list;
+
+	NetSendRaw send1(&packet,true);
+	NetSendRaw send2(&packet,true);
+	NetSendRaw send3(&packet,true);
+
+	list.Add(&send1);
+	list.Add(&send2);
+	list.Add(&send3);
+
+	if(list.Size() != 3 || list.GetFirst() != &send1 || list.Contains(&send2) == false)
+	{
+		cout << "Add is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Add is good\n";
+	}
+
+	WSAOVERLAPPED overlapped;
+	if(list.Find(&send2.overlapped) != &send2 || list.Find(&send3.overlapped) != &send3 || list.Find(&overlapped) != NULL)
+	{
+		cout << "Find is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Find is good\n";
+	}
+
+	list.Remove(&send1);
+	list.Remove(&send3);
+	if(list.Size() != 1 || list.GetFirst() != &send2 || list.Contains(&send1) == true || list.Find(&send3.overlapped) != NULL)
+	{
+		cout << "Remove is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Remove is good\n";
+	}
+
+	list.Remove(&send2);
+	if(list.Size() != 0 || list.GetFirst() != NULL)
+	{
+		cout << "Remove is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Remove is good\n";
+	}
+
+	cout << "\n\n";
+	return !problem;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "NetSend.h"
+
+/**
+ * @brief List of send operations that are in progress.
+ *
+ * The list is intrusive: links are stored in the NetSend objects themselves, so adding and
+ * removing a send operation is O(1) and allocates no memory. Send operations are also
+ * chained into hash buckets by the address of their overlapped object, so that the send operation
+ * that completed can be found from the overlapped pointer given by the completion port in O(1) time.\n\n
+ *
+ * The list does not own the send objects and does not delete them.\n\n
+ *
+ * This class is thread safe.
+ */
+class NetSendList : public CriticalSection
+{
+	/** @brief Oldest send operation in the list, NULL if the list is empty. */
+	NetSend * first;
+
+	/** @brief Newest send operation in the list, NULL if the list is empty. */
+	NetSend * last;
+
+	/** @brief Number of send operations in the list. */
+	size_t amount;
+
+	/** @brief Hash buckets, each is a chain of send operations linked by NetSend::bucketNext. Size is a power of 2. */
+	vector<NetSend*> buckets;
+
+	/** @brief Initial number of hash buckets. */
+	static const size_t INITIAL_BUCKET_AMOUNT = 16;
+
+	size_t GetBucket(const WSAOVERLAPPED * operation) const;
+	void Rehash(size_t bucketAmount);
+
+	NetSendList(const NetSendList &);
+	NetSendList & operator= (const NetSendList &);
+public:
+	NetSendList();
+	~NetSendList();
+
+	void Add(NetSend * send);
+	void Remove(NetSend * send);
+	NetSend * Find(const WSAOVERLAPPED * operation) const;
+	bool Contains(const NetSend * send) const;
+
+	NetSend * GetFirst() const;
+	size_t Size() const;
+
+	static bool TestClass();
+};
@@ -0,0 +1,289 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Constructor, copies the packet's data.
+ *
+ * The caller holds the first reference and must use Release() when it no longer needs the object.
+ *
+ * @param packet Packet whose used data should be copied.
+ */
+NetSendPayload::NetSendPayload(const Packet & packet) : CriticalSection()
+{
+	packet.CopyIntoWSABUF(buffer);
+	references = 1;
+	owner = NULL;
+}
+
+/**
+ * @brief Constructor, takes the packet's memory instead of copying it where possible.
+ *
+ * The caller holds the first reference and must use Release() when it no longer needs the object.
+ *
+ * @param [in,out] packet Packet whose used data should be taken, see Packet::MoveIntoWSABUF().
+ */
+NetSendPayload::NetSendPayload(Packet && packet) : CriticalSection()
+{
+	packet.MoveIntoWSABUF(buffer);
+	references = 1;
+	owner = NULL;
+}
+
+/**
+ * @brief Constructor, borrows the packet's memory without copying or taking it.
+ *
+ * The caller holds the first reference and must use Release() when it no longer needs the object.
+ * @a owner must not be modified until TakeMemory() or ReturnMemory() has been used.
+ *
+ * @param [in] owner Packet whose used data should be sent, it must own its memory
+ * (see Packet::IsDataPtrChanged()) and must not be empty.
+ */
+NetSendPayload::NetSendPayload(Packet * owner) : CriticalSection()
+{
+	_ErrorException((owner->IsDataPtrChanged() == true || owner->GetUsedSize() == 0),"borrowing the memory of a packet for a shared send payload, the packet does not own any memory",0,__LINE__,__FILE__);
+
+	buffer.buf = owner->GetDataPtr();
+	buffer.len = static_cast<ULONG>(owner->GetUsedSize());
+	references = 1;
+	this->owner = owner;
+}
+
+/**
+ * @brief Destructor, only used by Release().
+ */
+NetSendPayload::~NetSendPayload()
+{
+	if(owner == NULL)
+	{
+		delete[] buffer.buf;
+	}
+}
+
+/**
+ * @brief Takes the memory borrowed from the packet passed to the constructor, once send operations using it have been started.
+ *
+ * The packet is left with no memory. Does nothing if the memory was not borrowed.
+ */
+void NetSendPayload::TakeMemory()
+{
+	Enter();
+	try
+	{
+		if(owner != NULL)
+		{
+			WSABUF taken;
+			owner->MoveIntoWSABUF(taken);
+			owner = NULL;
+
+			_ErrorException((taken.buf != buffer.buf),"taking the memory of a packet for a shared send payload, the packet's memory has changed",0,__LINE__,__FILE__);
+		}
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){Leave(); throw(error);}
+	catch(...){Leave(); throw(-1);}
+	Leave();
+}
+
+/**
+ * @brief Stops using the memory borrowed from the packet passed to the constructor, because starting send operations failed.
+ *
+ * The packet keeps its data. If send operations that were started still hold references then they keep
+ * the borrowed memory, and the packet is given a copy of its data instead. Does nothing if the memory was not borrowed.
+ */
+void NetSendPayload::ReturnMemory()
+{
+	Enter();
+	try
+	{
+		if(owner != NULL)
+		{
+			if(references > 1)
+			{
+				Packet * packet = owner;
+				Packet copy(*packet);
+				TakeMemory();
+				*packet = std::move(copy);
+			}
+			else
+			{
+				buffer.buf = NULL;
+				buffer.len = 0;
+				owner = NULL;
+			}
+		}
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){Leave(); throw(error);}
+	catch(...){Leave(); throw(-1);}
+	Leave();
+}
+
+/**
+ * @brief Adds a reference to this object, the object will not be deleted until
+ * Release() has been used for this reference.
+ */
+void NetSendPayload::AddReference()
+{
+	Enter();
+	references++;
+	Leave();
+}
+
+/**
+ * @brief Releases a reference to this object, deleting it if this was the last reference.
+ *
+ * The object must not be used by the caller after this method returns.
+ */
+void NetSendPayload::Release()
+{
+	Enter();
+	_ErrorException((references == 0),"releasing a shared send payload, no references remain",0,__LINE__,__FILE__);
+	references--;
+	bool deleteMe = (references == 0);
+	Leave();
+
+	if(deleteMe == true)
+	{
+		delete this;
+	}
+}
+
+/**
+ * @brief Retrieves the number of references to this object.
+ *
+ * @return the number of references.
+ */
+size_t NetSendPayload::GetReferenceCount() const
+{
+	Enter();
+	size_t returnMe = references;
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Retrieves the copied data.
+ *
+ * The data must not be modified.
+ *
+ * @return buffer containing the data, WSABUF::len is the number of bytes of data.
+ */
+const WSABUF & NetSendPayload::GetBuffer() const
+{
+	return buffer;
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool NetSendPayload::TestClass()
+{
+	cout << "Testing NetSendPayload class...\n";
+	bool problem = false;
+
+	Packet packet("hello world");
+	NetSendPayload * obj = new NetSendPayload(packet);
+
+	if(packet.compareWSABUF(obj->GetBuffer(),obj->GetBuffer().len) == false || obj->GetBuffer().buf == packet.GetDataPtr())
+	{
+		cout << "Constructor is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Constructor is good\n";
+	}
+
+	obj->AddReference();
+	obj->AddReference();
+	if(obj->GetReferenceCount() != 3)
+	{
+		cout << "AddReference is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "AddReference is good\n";
+	}
+
+	obj->Release();
+	obj->Release();
+	if(obj->GetReferenceCount() != 1)
+	{
+		cout << "Release is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Release is good\n";
+	}
+	obj->Release();
+
+	// Memory changes owner instead of being copied
+	Packet moveMe("hello world");
+	const char * moveData = moveMe.GetDataPtr();
+	obj = new NetSendPayload(std::move(moveMe));
+	if(obj->GetBuffer().buf != moveData || obj->GetBuffer().len != 11 || moveMe.GetMemorySize() != 0 || moveMe.GetUsedSize() != 0)
+	{
+		cout << "Move constructor is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Move constructor is good\n";
+	}
+	obj->Release();
+
+	// Memory is borrowed, then taken once sending has started
+	Packet borrowMe("hello world");
+	const char * borrowData = borrowMe.GetDataPtr();
+	obj = new NetSendPayload(&borrowMe);
+	bool borrowProblem = (obj->GetBuffer().buf != borrowData || obj->GetBuffer().len != 11 || borrowMe != "hello world");
+	obj->TakeMemory();
+	borrowProblem |= (obj->GetBuffer().buf != borrowData || borrowMe.GetMemorySize() != 0 || borrowMe.GetUsedSize() != 0);
+	obj->Release();
+
+	if(borrowProblem == true)
+	{
+		cout << "TakeMemory is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "TakeMemory is good\n";
+	}
+
+	// Sending failed before any send operation used the memory, so the packet is unchanged
+	Packet returnMe("hello world");
+	const char * returnData = returnMe.GetDataPtr();
+	obj = new NetSendPayload(&returnMe);
+	obj->ReturnMemory();
+	bool returnProblem = (returnMe.GetDataPtr() != returnData || returnMe != "hello world");
+	obj->Release();
+
+	// Sending failed after a send operation started using the memory, so the packet is given a copy
+	obj = new NetSendPayload(&returnMe);
+	obj->AddReference();
+	obj->ReturnMemory();
+	returnProblem |= (obj->GetBuffer().buf != returnData || returnMe.GetDataPtr() == returnData || returnMe != "hello world");
+	obj->Release();
+	returnProblem |= (obj->GetBuffer().buf != returnData || strncmp(obj->GetBuffer().buf,"hello world",11) != 0);
+	obj->Release();
+
+	if(returnProblem == true)
+	{
+		cout << "ReturnMemory is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "ReturnMemory is good\n";
+	}
+
+	cout << "\n\n";
+	return !problem;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Packet.h"
+
+/**
+ * @brief Immutable copy of packet data that can be shared by several send operations.
+ *
+ * The data is copied once when the object is constructed, or taken from a packet
+ * that is no longer needed without being copied. The memory of a packet can also be
+ * borrowed while send operations are started, and only taken once they have been started
+ * using TakeMemory(), so that the packet keeps its data if starting them fails. Each send operation using the
+ * payload holds a reference to it, and the object deletes itself when the last reference is
+ * released, so the data remains valid until every send operation has completed.\n\n
+ *
+ * Objects must be allocated using new and are never deleted directly, use Release() instead.\n\n
+ *
+ * This class is thread safe.
+ */
+class NetSendPayload : public CriticalSection
+{
+	/** @brief Copy of packet data. */
+	WSABUF buffer;
+
+	/** @brief Number of references to this object, when this reaches 0 the object is deleted. */
+	size_t references;
+
+	/** @brief Packet that owns the memory of NetSendPayload::buffer, NULL if this object owns it. */
+	Packet * owner;
+
+	~NetSendPayload();
+	NetSendPayload(const NetSendPayload &);
+	NetSendPayload & operator= (const NetSendPayload &);
+public:
+	NetSendPayload(const Packet & packet);
+	NetSendPayload(Packet && packet);
+	NetSendPayload(Packet * owner);
+
+	void TakeMemory();
+	void ReturnMemory();
+
+	void AddReference();
+	void Release();
+	size_t GetReferenceCount() const;
+
+	const WSABUF & GetBuffer() const;
+
+	static bool TestClass();
+};
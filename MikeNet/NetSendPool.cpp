@@ -0,0 +1,541 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Constructor.
+ *
+ * @param maximumIdle Maximum number of idle send objects of each type that are kept, extra objects are deleted.
+ */
+NetSendPool::NetSendPool(size_t maximumIdle) : CriticalSection()
+{
+	this->maximumIdle = maximumIdle;
+	allocationCount = 0;
+}
+
+/**
+ * @brief Destructor, deletes idle send objects.
+ *
+ * Send objects that are in use must not be returned to the pool after it has been destroyed,
+ * so sockets clear their send operations first.
+ */
+NetSendPool::~NetSendPool()
+{
+	const char * cCommand = "an internal function (~NetSendPool)";
+	try
+	{
+		Clear();
+	}
+	MSG_CATCH
+}
+
+/**
+ * @brief Removes an idle send object from the pool.
+ *
+ * @param type Type of send object to remove.
+ *
+ * @return send object of type @a type, or NULL if there are none.
+ */
+NetSend * NetSendPool::Take(NetSend::PoolType type)
+{
+	NetSend * returnMe = NULL;
+
+	Enter();
+	if(idle[type].empty() == false)
+	{
+		returnMe = idle[type].back();
+		idle[type].pop_back();
+	}
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Records that a send object was allocated for this pool.
+ *
+ * @param [in] send Newly allocated send object, it is returned to this pool when it is no longer in use.
+ */
+void NetSendPool::Allocated(NetSend * send)
+{
+	send->SetPool(this);
+
+	Enter();
+	allocationCount++;
+	Leave();
+}
+
+/**
+ * @brief Retrieves a NetSendRaw object, reusing an idle object if possible.
+ *
+ * @param packet Packet to send.
+ * @param block If true packet will be sent synchronously, if false packet will be sent asynchronously.
+ *
+ * @return send object.
+ */
+NetSend * NetSendPool::GetRaw(const Packet * packet, bool block)
+{
+	NetSendRaw * sendObject = static_cast<NetSendRaw*>(Take(NetSend::RAW));
+
+	if(sendObject == NULL)
+	{
+		sendObject = new (nothrow) NetSendRaw(packet,block);
+		Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
+		Allocated(sendObject);
+	}
+	else
+	{
+		sendObject->Reinitialize(packet,block);
+	}
+
+	return sendObject;
+}
+
+/**
+ * @brief Retrieves a NetSendPrefix object with an empty prefix, reusing an idle object if possible.
+ *
+ * The prefix should be added to NetSendPrefix::GetPrefix() before sending.
+ *
+ * @param packet Packet to send.
+ * @param block If true packet will be sent synchronously, if false packet will be sent asynchronously.
+ *
+ * @return send object.
+ */
+NetSendPrefix * NetSendPool::GetPrefix(const Packet * packet, bool block)
+{
+	NetSendPrefix * sendObject = static_cast<NetSendPrefix*>(Take(NetSend::PREFIX));
+
+	if(sendObject == NULL)
+	{
+		sendObject = new (nothrow) NetSendPrefix(packet,block,Packet());
+		Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
+		Allocated(sendObject);
+	}
+	else
+	{
+		sendObject->Reinitialize(packet,block);
+	}
+
+	return sendObject;
+}
+
+/**
+ * @brief Retrieves a NetSendPostfix object, reusing an idle object if possible.
+ *
+ * @param packet Packet to send.
+ * @param block If true packet will be sent synchronously, if false packet will be sent asynchronously.
+ * @param postfix Postfix to attach to the end of the packet.
+ *
+ * @return send object.
+ */
+NetSend * NetSendPool::GetPostfix(const Packet * packet, bool block, const Packet * postfix)
+{
+	NetSendPostfix * sendObject = static_cast<NetSendPostfix*>(Take(NetSend::POSTFIX));
+
+	if(sendObject == NULL)
+	{
+		sendObject = new (nothrow) NetSendPostfix(packet,block,postfix);
+		Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
+		Allocated(sendObject);
+	}
+	else
+	{
+		sendObject->Reinitialize(packet,block,postfix);
+	}
+
+	return sendObject;
+}
+
+/**
+ * @brief Retrieves a NetSendShared object, reusing an idle object if possible.
+ *
+ * @param [in] payload Packet data to send.
+ * @param prefix Prefix to place at start of packet, may be NULL.
+ * @param postfix Postfix to place at end of packet, may be NULL.
+ *
+ * @return send object.
+ */
+NetSend * NetSendPool::GetShared(NetSendPayload * payload, const Packet * prefix, const Packet * postfix)
+{
+	NetSendShared * sendObject = static_cast<NetSendShared*>(Take(NetSend::SHARED));
+
+	if(sendObject == NULL)
+	{
+		sendObject = new (nothrow) NetSendShared(payload,prefix,postfix);
+		Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
+		Allocated(sendObject);
+	}
+	else
+	{
+		sendObject->Reinitialize(payload,prefix,postfix);
+	}
+
+	return sendObject;
+}
+
+/**
+ * @brief Retrieves a NetSendShared object that sends the segments of a chain, reusing an idle object if possible.
+ *
+ * @param chain Packet data to send.
+ * @param prefix Prefix to place at start of packet, may be NULL.
+ * @param postfix Postfix to place at end of packet, may be NULL.
+ *
+ * @return send object.
+ */
+NetSend * NetSendPool::GetShared(const PacketChain & chain, const Packet * prefix, const Packet * postfix)
+{
+	NetSendShared * sendObject = static_cast<NetSendShared*>(Take(NetSend::SHARED));
+
+	if(sendObject == NULL)
+	{
+		sendObject = new (nothrow) NetSendShared(chain,prefix,postfix);
+		Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
+		Allocated(sendObject);
+	}
+	else
+	{
+		sendObject->Reinitialize(chain,prefix,postfix);
+	}
+
+	return sendObject;
+}
+
+/**
+ * @brief Returns a send object that is no longer in use to the pool.
+ *
+ * The object is cleaned up and stored until it is reused, or deleted if
+ * the pool is full or cannot store objects of its type.
+ *
+ * @param [in] send Send object to add, the caller must not use it after this method returns.
+ */
+void NetSendPool::Add(NetSend * send)
+{
+	_ErrorException((send == NULL),"adding a send object to a pool, send object must not be NULL",0,__LINE__,__FILE__);
+
+	NetSend::PoolType type = send->GetPoolType();
+	bool stored = false;
+
+	if(type != NetSend::TYPE_AMOUNT)
+	{
+		send->Cleanup();
+
+		Enter();
+		if(idle[type].size() < maximumIdle)
+		{
+			idle[type].push_back(send);
+			stored = true;
+		}
+		Leave();
+	}
+
+	if(stored == false)
+	{
+		delete send;
+	}
+}
+
+/**
+ * @brief Returns a send object that is no longer in use to the pool that it came from.
+ *
+ * @param [in] send Send object, deleted if it did not come from a pool. The caller must not use it after this method returns.
+ */
+void NetSendPool::Recycle(NetSend * send)
+{
+	_ErrorException((send == NULL),"recycling a send object, send object must not be NULL",0,__LINE__,__FILE__);
+
+	if(send->GetPool() != NULL)
+	{
+		send->GetPool()->Add(send);
+	}
+	else
+	{
+		delete send;
+	}
+}
+
+/**
+ * @brief Deletes all idle send objects.
+ */
+void NetSendPool::Clear()
+{
+	Enter();
+	for(size_t type = 0;type<NetSend::TYPE_AMOUNT;type++)
+	{
+		for(size_t n = 0;n<idle[type].size();n++)
+		{
+			delete idle[type][n];
+		}
+		idle[type].clear();
+	}
+	Leave();
+}
+
+/**
+ * @brief Retrieves the number of idle send objects stored in the pool.
+ *
+ * @return number of idle send objects of all types.
+ */
+size_t NetSendPool::GetIdleAmount() const
+{
+	size_t returnMe = 0;
+
+	Enter();
+	for(size_t type = 0;type<NetSend::TYPE_AMOUNT;type++)
+	{
+		returnMe += idle[type].size();
+	}
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Retrieves the maximum number of idle send objects of each type that are kept.
+ *
+ * @return maximum number of idle send objects of each type.
+ */
+size_t NetSendPool::GetMaximumIdle() const
+{
+	return maximumIdle;
+}
+
+/**
+ * @brief Retrieves the number of send objects that have been allocated by this pool.
+ *
+ * @return number of allocations.
+ */
+size_t NetSendPool::GetAllocationCount() const
+{
+	Enter();
+	size_t returnMe = allocationCount;
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Determines whether a buffer is stored inside a send object.
+ *
+ * @param send Send object.
+ * @param buffer Buffer to check.
+ *
+ * @return true if @a buffer points to memory within @a send, which means that no memory was allocated for it.
+ */
+static bool NetSendPoolIsInline(const NetSend * send, const WSABUF & buffer)
+{
+	const char * start = reinterpret_cast<const char*>(send);
+	return buffer.buf >= start && buffer.buf < start + sizeof(NetSend);
+}
+
+/**
+ * @brief Compares allocating a send object for each send operation with reusing send objects.
+ *
+ * @param sends Number of send operations to simulate.
+ * @param packetSize Size of packet sent by each operation.
+ *
+ * @return true if pooled send operations allocated no memory after the first.
+ */
+static bool NetSendPoolBenchmark(size_t sends, size_t packetSize)
+{
+	Packet packet;
+	packet.SetMemorySize(packetSize);
+	for(size_t n = 0;n<packetSize;n++)
+	{
+		packet.Add('a');
+	}
+
+	// Allocate a send object, event object and buffer for each send
+	DWORD startTime = GetTickCount();
+	for(size_t n = 0;n<sends;n++)
+	{
+		Packet prefix;
+		prefix.AddSizeT(n);
+
+		NetSend * sendObject = new (nothrow) NetSendPrefix(&packet,false,prefix);
+		Utility::DynamicAllocCheck(sendObject,__LINE__,__FILE__);
+		NetSendPool::Recycle(sendObject);
+	}
+	DWORD allocateTime = GetTickCount() - startTime;
+
+	// Reuse send objects
+	NetSendPool pool;
+	size_t heapBuffers = 0;
+
+	startTime = GetTickCount();
+	for(size_t n = 0;n<sends;n++)
+	{
+		NetSendPrefix * sendObject = pool.GetPrefix(&packet,false);
+		sendObject->GetPrefix().AddSizeT(n);
+
+		if(NetSendPoolIsInline(sendObject,sendObject->GetBuffer()[1]) == false)
+		{
+			heapBuffers++;
+		}
+
+		NetSendPool::Recycle(sendObject);
+	}
+	DWORD pooledTime = GetTickCount() - startTime;
+
+	double objectsPerSend = static_cast<double>(pool.GetAllocationCount()) / sends;
+	double buffersPerSend = static_cast<double>(heapBuffers) / sends;
+
+	cout << packetSize << " byte packets, " << sends << " sends:\n";
+	cout << " Allocated per send: " << allocateTime << "ms, 1 send object, 1 event object and 1 prefix per send\n";
+	cout << " Pooled: " << pooledTime << "ms, " << objectsPerSend << " send objects and " << buffersPerSend << " heap buffers per send\n";
+
+	return pool.GetAllocationCount() == 1 && (packetSize > NetSend::INLINE_BUFFER_LENGTH || heapBuffers == 0);
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool NetSendPool::TestClass()
+{
+	cout << "Testing NetSendPool class...\n";
+	bool problem = false;
+
+	Packet packet("hello world");
+	Packet postfix("!");
+
+	{
+		NetSendPool pool(2);
+
+		NetSend * raw = pool.GetRaw(&packet,false);
+		if(raw->GetPool() != &pool || pool.GetAllocationCount() != 1 || packet.compareWSABUF(raw->GetBuffer()[0],raw->GetBuffer()[0].len) == false)
+		{
+			cout << "GetRaw is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "GetRaw is good\n";
+		}
+
+		if(NetSendPoolIsInline(raw,raw->GetBuffer()[0]) == false)
+		{
+			cout << "Inline buffer is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Inline buffer is good\n";
+		}
+
+		NetSendPool::Recycle(raw);
+		if(pool.GetIdleAmount() != 1)
+		{
+			cout << "Recycle is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Recycle is good\n";
+		}
+
+		// Idle object is reused
+		NetSend * reused = pool.GetRaw(&packet,true);
+		if(reused != raw || pool.GetAllocationCount() != 1 || pool.GetIdleAmount() != 0 || reused->IsBlocking() == false ||
+		   reused->GetBuffer()[0].buf != packet.GetDataPtr())
+		{
+			cout << "Reuse is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Reuse is good\n";
+		}
+		NetSendPool::Recycle(reused);
+
+		// Objects of a different type are not reused
+		NetSendPrefix * prefix = pool.GetPrefix(&packet,false);
+		prefix->GetPrefix().AddSizeT(5);
+		NetSend * postfixObject = pool.GetPostfix(&packet,false,&postfix);
+		if(pool.GetAllocationCount() != 3 || pool.GetIdleAmount() != 1 ||
+		   prefix->GetBuffer()[0].len != sizeof(size_t) || postfix.compareWSABUF(postfixObject->GetBuffer()[1],postfixObject->GetBuffer()[1].len) == false)
+		{
+			cout << "GetPrefix or GetPostfix is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "GetPrefix and GetPostfix are good\n";
+		}
+
+		// Pool keeps at most 2 of each type
+		NetSend * extra1 = pool.GetPostfix(&packet,false,&postfix);
+		NetSend * extra2 = pool.GetPostfix(&packet,false,&postfix);
+		NetSendPool::Recycle(prefix);
+		NetSendPool::Recycle(postfixObject);
+		NetSendPool::Recycle(extra1);
+		NetSendPool::Recycle(extra2);
+		if(pool.GetIdleAmount() != 4)
+		{
+			cout << "Maximum idle is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Maximum idle is good\n";
+		}
+
+		// Reused prefix starts empty
+		prefix = pool.GetPrefix(&packet,false);
+		if(prefix->GetBuffer()[0].len != 0)
+		{
+			cout << "Prefix reuse is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Prefix reuse is good\n";
+		}
+		NetSendPool::Recycle(prefix);
+
+		pool.Clear();
+		if(pool.GetIdleAmount() != 0)
+		{
+			cout << "Clear is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Clear is good\n";
+		}
+	}
+
+	// Shared send objects release their payload when recycled
+	{
+		NetSendPool pool;
+		NetSendPayload * payload = new NetSendPayload(packet);
+		NetSend * shared = pool.GetShared(payload,NULL,&postfix);
+		NetSendPool::Recycle(shared);
+
+		if(payload->GetReferenceCount() != 1 || pool.GetIdleAmount() != 1)
+		{
+			cout << "GetShared is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "GetShared is good\n";
+		}
+		payload->Release();
+	}
+
+	// Benchmark
+	cout << "Benchmarking allocations per send..\n";
+	if(NetSendPoolBenchmark(100000,64) == false || NetSendPoolBenchmark(100000,4096) == false)
+	{
+		cout << "Benchmark is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Benchmark is good\n";
+	}
+
+	cout << "\n\n";
+	return !problem;
+}
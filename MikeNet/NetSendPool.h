@@ -0,0 +1,60 @@
+#pragma once
+#include "NetSend.h"
+#include "NetSendRaw.h"
+#include "NetSendPrefix.h"
+#include "NetSendPostfix.h"
+#include "NetSendShared.h"
+
+/**
+ * @brief Free list of send objects that are not in use, so that they can be reused by later send operations.
+ *
+ * Each socket has its own pool. Send objects are taken from the pool by the protocol mode
+ * when a send operation begins, and are returned to the pool by the socket when the send operation
+ * has completed, instead of being deleted. Once the pool has warmed up a send operation
+ * creates no event objects or critical sections, and if the packet is small no memory is allocated.\n\n
+ *
+ * Each type of send object is stored separately, at most NetSendPool::maximumIdle of each type are kept.\n\n
+ *
+ * This class is thread safe.
+ */
+class NetSendPool : public CriticalSection
+{
+public:
+	/** @brief Default maximum number of idle send objects of each type. */
+	static const size_t DEFAULT_MAXIMUM_IDLE = 64;
+
+private:
+	/** @brief Send objects that are not in use, of each type. */
+	vector<NetSend*> idle[NetSend::TYPE_AMOUNT];
+
+	/** @brief Maximum number of idle send objects of each type, extra objects are deleted. */
+	size_t maximumIdle;
+
+	/** @brief Number of send objects that have been allocated by this pool. */
+	size_t allocationCount;
+
+	NetSend * Take(NetSend::PoolType type);
+	void Allocated(NetSend * send);
+
+	NetSendPool(const NetSendPool &);
+	NetSendPool & operator= (const NetSendPool &);
+public:
+	NetSendPool(size_t maximumIdle = DEFAULT_MAXIMUM_IDLE);
+	~NetSendPool();
+
+	NetSend * GetRaw(const Packet * packet, bool block);
+	NetSendPrefix * GetPrefix(const Packet * packet, bool block);
+	NetSend * GetPostfix(const Packet * packet, bool block, const Packet * postfix);
+	NetSend * GetShared(NetSendPayload * payload, const Packet * prefix, const Packet * postfix);
+	NetSend * GetShared(const PacketChain & chain, const Packet * prefix, const Packet * postfix);
+
+	void Add(NetSend * send);
+	static void Recycle(NetSend * send);
+	void Clear();
+
+	size_t GetIdleAmount() const;
+	size_t GetMaximumIdle() const;
+	size_t GetAllocationCount() const;
+
+	static bool TestClass();
+};
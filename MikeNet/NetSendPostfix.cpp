@@ -8,10 +8,28 @@
  * @param postfix Postfix to attach to the end of the packet. Pointer must remain valid for lifetime of object.
  */
 NetSendPostfix::NetSendPostfix(const Packet * packet, bool block, const Packet * postfix) : NetSend(block)
+{
+	buffers[0].buf = NULL;
+	buffers[0].len = 0;
+
+	Reinitialize(packet,block,postfix);
+}
+
+/**
+ * @brief Prepares the object for a new send operation.
+ *
+ * Cleanup() must have been called if the object was used previously.
+ *
+ * @param packet Packet to send. Pointer must remain valid until the send operation completes.
+ * @param block If true packet will be sent synchronously, if false packet will be sent asynchronously.
+ * @param postfix Postfix to attach to the end of the packet. Pointer must remain valid until the send operation completes.
+ */
+void NetSendPostfix::Reinitialize(const Packet * packet, bool block, const Packet * postfix)
 {
 	_ErrorException((packet == NULL),"constructing a NetSendPostfix object, packet parameter must not be null",0,__LINE__,__FILE__);
 	_ErrorException((postfix == NULL),"constructing a NetSendPostfix object, postfix parameter must not be null",0,__LINE__,__FILE__);
 	
+	NetSend::Reinitialize(block);
 	this->postfix = postfix;
 	this->packet = packet;
 
@@ -20,7 +38,7 @@ NetSendPostfix::NetSendPostfix(const Packet * packet, bool block, const Packet *
 	 * the send operation does not need its own buffer
 	 * because the send operation will be completed before
 	 * further usage of the packet buffer takes place.
-	 * The destructor MUST NOT deallocate the buffer memory
+	 * Cleanup() MUST NOT deallocate the buffer memory
 	 * since this will be done automatically by the destructors
 	 * of the objects that the buffer points to (we are not doing
 	 * any copying).
@@ -32,15 +50,20 @@ NetSendPostfix::NetSendPostfix(const Packet * packet, bool block, const Packet *
 	}
 	/**
 	 * If the send operation does not block until completion
-	 * then it needs its own buffer, which is allocated from 
-	 * the heap and MUST be deallocated by the destructor.
+	 * then it needs its own buffer, which is stored inline or
+	 * allocated from the heap and MUST be released by Cleanup().
 	 * This is necessary because the packet buffer may be used
 	 * by another thread during sending.
+	 *
+	 * The postfix is copied into NetSendPostfix::postfixCopy whose
+	 * memory is kept when the object is reused.
 	 */
 	else
 	{
-		packet->CopyIntoWSABUF(buffers[0]);
-		postfix->CopyIntoWSABUF(buffers[1]);
+		CopyIntoBuffer(*packet,buffers[0]);
+
+		postfixCopy = *postfix;
+		postfixCopy.PtrIntoWSABUF(buffers[1]);
 	}
 }
 
@@ -48,13 +71,25 @@ NetSendPostfix::NetSendPostfix(const Packet * packet, bool block, const Packet *
  * @brief Destructor.
  */
 NetSendPostfix::~NetSendPostfix()
+{
+	Cleanup();
+}
+
+/**
+ * @brief Releases the copy of the packet, if any.
+ */
+void NetSendPostfix::Cleanup()
 {
 	// Memory is only allocated by this object if non blocking
 	if(IsBlocking() == false)
 	{
-		delete[] buffers[0].buf;
-		delete[] buffers[1].buf;
+		ReleaseBuffer(buffers[0]);
 	}
+
+	buffers[0].buf = NULL;
+	buffers[0].len = 0;
+	packet = NULL;
+	postfix = NULL;
 }
 
 /** 
@@ -80,6 +115,16 @@ size_t NetSendPostfix::GetBufferAmount() const
 	return NUM_BUFFERS;
 }
 
+/**
+ * @brief Implements virtual method.
+ *
+ * @return NetSend::POSTFIX.
+ */
+NetSend::PoolType NetSendPostfix::GetPoolType() const
+{
+	return POSTFIX;
+}
+
 /**
  * @brief Tests class.
  *
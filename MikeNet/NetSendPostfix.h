@@ -16,6 +16,9 @@ class NetSendPostfix : public NetSend
 	/** @brief Pointer to packet containing data to send. */
 	const Packet * packet;
 
+	/** @brief Copy of postfix used by asynchronous send operations. */
+	Packet postfixCopy;
+
 	/** @brief Number of elements in NetSendPostfix::buffers. */
 	static const size_t NUM_BUFFERS = 2;
 
@@ -30,8 +33,12 @@ public:
 	NetSendPostfix(const Packet * packet, bool block, const Packet * postfix);
 	~NetSendPostfix();
 
+	void Reinitialize(const Packet * packet, bool block, const Packet * postfix);
+	void Cleanup();
+
 	WSABUF * GetBuffer();
 	size_t GetBufferAmount() const;
+	PoolType GetPoolType() const;
 
 	static bool TestClass();
 };
\ No newline at end of file
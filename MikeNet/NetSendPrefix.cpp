@@ -9,25 +9,41 @@
  * valid for lifetime of object.
  */
 NetSendPrefix::NetSendPrefix(const Packet * packet, bool block, const Packet & prefix) : NetSend(block)
+{
+	buffers[1].buf = NULL;
+	buffers[1].len = 0;
+	buffers[2].buf = NULL;
+	buffers[2].len = 0;
+
+	Reinitialize(packet,block);
+	this->prefix = prefix; // Store bytes of prefix
+}
+
+/**
+ * @brief Prepares the object for a new send operation, with an empty prefix.
+ *
+ * The prefix should then be added to GetPrefix().
+ * Cleanup() must have been called if the object was used previously.
+ *
+ * @param packet Packet to send. Pointer must remain valid until the send operation completes.
+ * @param block If true packet will be sent synchronously, if false packet will be sent asynchronously.
+ */
+void NetSendPrefix::Reinitialize(const Packet * packet, bool block)
 {
 	_ErrorException((packet == NULL),"constructing a NetSendPostfix object, packet parameter must not be null",0,__LINE__,__FILE__);
 	
-	this->prefix = prefix; // Store bytes of prefix
+	NetSend::Reinitialize(block);
+	this->prefix.Clear(); // Memory is kept for the next prefix
 	this->packet = packet;
-
-	/**
-	 * this->prefix will remain valid until this object is destroyed.
-	 * This object won't be destroyed until send operation is completed.
-	 */
-	buffers[0].buf = this->prefix.GetDataPtr();
-	buffers[0].len = static_cast<DWORD>(this->prefix.GetUsedSize());
+	this->sealed = false;
+	this->ownsBuffer = !block;
 
 	/**
 	 * If the send operation blocks until completion then
 	 * the send operation does not need its own buffer
 	 * because the send operation will be completed before
 	 * further usage of the packet buffer takes place.
-	 * The destructor MUST NOT deallocate the buffer memory
+	 * Cleanup() MUST NOT deallocate the buffer memory
 	 * since this will be done automatically by the destructors
 	 * of the objects that the buffer points to (we are not doing
 	 * any copying).
@@ -38,14 +54,14 @@ NetSendPrefix::NetSendPrefix(const Packet * packet, bool block, const Packet & p
 	}
 	/**
 	 * If the send operation does not block until completion
-	 * then it needs its own buffer, which is allocated from 
-	 * the heap and MUST be deallocated by the destructor.
+	 * then it needs its own buffer, which is stored inline or
+	 * allocated from the heap and MUST be released by Cleanup().
 	 * This is necessary because the packet buffer may be used
 	 * by another thread during sending.
 	 */
 	else
 	{
-		packet->CopyIntoWSABUF(buffers[1]);
+		CopyIntoBuffer(*packet,buffers[1]);
 	}
 }
 
@@ -54,11 +70,61 @@ NetSendPrefix::NetSendPrefix(const Packet * packet, bool block, const Packet & p
  */
 NetSendPrefix::~NetSendPrefix()
 {
-	// Memory is only allocated by this object if non blocking
-	if(IsBlocking() == false)
+	Cleanup();
+}
+
+/**
+ * @brief Releases the copy of the packet, if any.
+ */
+void NetSendPrefix::Cleanup()
+{
+	// Memory is only allocated by this object if non blocking or sealed
+	if(ownsBuffer == true)
 	{
-		delete[] buffers[1].buf;
+		ReleaseBuffer(buffers[1]);
+		ownsBuffer = false;
 	}
+
+	buffers[1].buf = NULL;
+	buffers[1].len = 0;
+	packet = NULL;
+}
+
+/**
+ * @brief Retrieves the prefix, which can be modified until the send operation begins.
+ *
+ * @return prefix placed at start of packet.
+ */
+Packet & NetSendPrefix::GetPrefix()
+{
+	return prefix;
+}
+
+/**
+ * @brief Encrypts the data to be sent and authenticates it together with the prefix, see CipherGCM::Seal().
+ *
+ * The prefix must be complete before this method is used, since it cannot be changed afterwards
+ * without invalidating the authentication tag. The data is sealed in place in this object's own copy
+ * of the packet; if sending is blocking the packet is copied first so that it is not modified.
+ *
+ * @param cipher Cipher to seal with.
+ * @param nonce CipherGCM::NONCE_SIZE byte nonce, which must never be used with @a cipher's key again.
+ */
+void NetSendPrefix::Seal(const CipherGCM & cipher, const unsigned char * nonce)
+{
+	_ErrorException((sealed == true),"sealing a packet that is about to be sent, the packet has already been sealed",0,__LINE__,__FILE__);
+
+	if(ownsBuffer == false)
+	{
+		CopyIntoBuffer(*packet,buffers[1]);
+		ownsBuffer = true;
+	}
+
+	cipher.Seal(reinterpret_cast<unsigned char*>(buffers[1].buf),buffers[1].len,reinterpret_cast<const unsigned char*>(prefix.GetDataPtr()),prefix.GetUsedSize(),nonce,tag);
+
+	buffers[2].buf = reinterpret_cast<char*>(tag);
+	buffers[2].len = CipherGCM::TAG_SIZE;
+	sealed = true;
 }
 
 /** 
@@ -71,6 +137,12 @@ NetSendPrefix::~NetSendPrefix()
  */
 WSABUF * NetSendPrefix::GetBuffer()
 {
+	/**
+	 * this->prefix will remain valid until this object is reused.
+	 * This object won't be reused until send operation is completed.
+	 */
+	prefix.PtrIntoWSABUF(buffers[0]);
+
 	return (WSABUF*)buffers;
 }
 
@@ -81,7 +153,24 @@ WSABUF * NetSendPrefix::GetBuffer()
  */
 size_t NetSendPrefix::GetBufferAmount() const
 {
-	return NUM_BUFFERS;
+	if(sealed == true)
+	{
+		return NUM_BUFFERS;
+	}
+	else
+	{
+		return NUM_BUFFERS - 1;
+	}
+}
+
+/**
+ * @brief Implements virtual method.
+ *
+ * @return NetSend::PREFIX.
+ */
+NetSend::PoolType NetSendPrefix::GetPoolType() const
+{
+	return PREFIX;
 }
 
 /**
@@ -130,6 +219,34 @@ bool NetSendPrefix::TestClass()
 		cout << "Constructor is good\n";
 	}
 
+	{
+		CipherGCM cipher(EncryptKey(1234,5678));
+		unsigned char nonce[CipherGCM::NONCE_SIZE] = {0};
+
+		// Blocking send objects must copy the packet before sealing it
+		NetSendPrefix sealObj(&packet,true,prefix);
+		sealObj.Seal(cipher,nonce);
+
+		WSABUF * sealBuffers = sealObj.GetBuffer();
+		Packet opened;
+		opened.AddStringC(sealBuffers[1].buf,sealBuffers[1].len,false);
+
+		bool openGood = cipher.Open(reinterpret_cast<unsigned char*>(opened.GetDataPtr()),opened.GetUsedSize(),
+									reinterpret_cast<const unsigned char*>(sealBuffers[0].buf),sealBuffers[0].len,
+									nonce,reinterpret_cast<const unsigned char*>(sealBuffers[2].buf));
+
+		if(sealObj.GetBufferAmount() != 3 || sealBuffers[2].len != CipherGCM::TAG_SIZE || openGood == false ||
+		   opened != packet || packet != "hello world")
+		{
+			cout << "Seal is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Seal is good\n";
+		}
+	}
+
 	cout << "\n\n";
 	return !problem;
 }
\ No newline at end of file
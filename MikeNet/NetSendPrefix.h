@@ -1,12 +1,14 @@
 #pragma once
 #include "NetSend.h"
 #include "Packet.h"
+#include "CipherGCM.h"
 
 /**
  * @brief Send class where packets sent have a prefix.
  * @remarks	Michael Pryor, 6/28/2010.
  *
  * This class makes use of scatter/gather I/O to maximize efficiency.
+ * If Seal() is used, the authentication tag is sent as a third buffer after the data.
  */
 class NetSendPrefix : public NetSend
 {
@@ -17,22 +19,38 @@ class NetSendPrefix : public NetSend
 	const Packet * packet;
 
 	/** @brief Number of elements in NetSendPrefix::buffers. */
-	static const size_t NUM_BUFFERS = 2;
+	static const size_t NUM_BUFFERS = 3;
 
 	/**
 	 * @brief Array of buffers to be sent.
 	 *
 	 * - e0 is packet prefix
 	 * - e1 is packet data.
+	 * - e2 is authentication tag, only sent if Seal() was used.
 	 */
 	WSABUF buffers[NUM_BUFFERS];
 
+	/** @brief True if NetSendPrefix::buffers[1] is a copy of the packet that must be released by Cleanup(). */
+	bool ownsBuffer;
+
+	/** @brief True if Seal() has been used since the object was last initialized. */
+	bool sealed;
+
+	/** @brief Authentication tag generated by Seal(). */
+	unsigned char tag[CipherGCM::TAG_SIZE];
+
 public:
 	NetSendPrefix(const Packet * packet, bool block, const Packet & prefix);
 	~NetSendPrefix();
 
+	void Reinitialize(const Packet * packet, bool block);
+	void Cleanup();
+	Packet & GetPrefix();
+	void Seal(const CipherGCM & cipher, const unsigned char * nonce);
+
 	WSABUF * GetBuffer();
 	size_t GetBufferAmount() const;
+	PoolType GetPoolType() const;
 	
 	static bool TestClass();
 };
\ No newline at end of file
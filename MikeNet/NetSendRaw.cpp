@@ -7,9 +7,26 @@
  * @param block If true packet will be sent synchronously, if false packet will be sent asynchronously.
  */
 NetSendRaw::NetSendRaw(const Packet * packet, bool block) : NetSend(block)
+{
+	buffers[0].buf = NULL;
+	buffers[0].len = 0;
+
+	Reinitialize(packet,block);
+}
+
+/**
+ * @brief Prepares the object for a new send operation.
+ *
+ * Cleanup() must have been called if the object was used previously.
+ *
+ * @param packet Packet to send.
+ * @param block If true packet will be sent synchronously, if false packet will be sent asynchronously.
+ */
+void NetSendRaw::Reinitialize(const Packet * packet, bool block)
 {
 	_ErrorException((packet == NULL),"constructing a NetSendPostfix object, packet parameter must not be null",0,__LINE__,__FILE__);
 	
+	NetSend::Reinitialize(block);
 	this->packet = packet;
 
 	/**
@@ -17,7 +34,7 @@ NetSendRaw::NetSendRaw(const Packet * packet, bool block) : NetSend(block)
 	 * the send operation does not need its own buffer
 	 * because the send operation will be completed before
 	 * further usage of the packet buffer takes place.
-	 * The destructor MUST NOT deallocate the buffer memory
+	 * Cleanup() MUST NOT deallocate the buffer memory
 	 * since this will be done automatically by the destructors
 	 * of the objects that the buffer points to (we are not doing
 	 * any copying).
@@ -28,14 +45,14 @@ NetSendRaw::NetSendRaw(const Packet * packet, bool block) : NetSend(block)
 	}
 	/**
 	 * If the send operation does not block until completion
-	 * then it needs its own buffer, which is allocated from 
-	 * the heap and MUST be deallocated by the destructor.
+	 * then it needs its own buffer, which is stored inline or
+	 * allocated from the heap and MUST be released by Cleanup().
 	 * This is necessary because the packet buffer may be used
 	 * by another thread during sending.
 	 */
 	else
 	{
-		packet->CopyIntoWSABUF(buffers[0]);
+		CopyIntoBuffer(*packet,buffers[0]);
 	}
 }
 
@@ -43,12 +60,24 @@ NetSendRaw::NetSendRaw(const Packet * packet, bool block) : NetSend(block)
  * @brief Destructor.
  */
 NetSendRaw::~NetSendRaw()
+{
+	Cleanup();
+}
+
+/**
+ * @brief Releases the copy of the packet, if any.
+ */
+void NetSendRaw::Cleanup()
 {
 	// Memory is only allocated by this object if non blocking
 	if(IsBlocking() == false)
 	{
-		delete[] buffers[0].buf;
+		ReleaseBuffer(buffers[0]);
 	}
+
+	buffers[0].buf = NULL;
+	buffers[0].len = 0;
+	packet = NULL;
 }
 
 /** 
@@ -74,6 +103,16 @@ size_t NetSendRaw::GetBufferAmount() const
 	return NUM_BUFFERS;
 }
 
+/**
+ * @brief Implements virtual method.
+ *
+ * @return NetSend::RAW.
+ */
+NetSend::PoolType NetSendRaw::GetPoolType() const
+{
+	return RAW;
+}
+
 /**
  * @brief Tests class.
  *
@@ -26,8 +26,12 @@ public:
 	NetSendRaw(const Packet * packet, bool block);
 	~NetSendRaw();
 
+	void Reinitialize(const Packet * packet, bool block);
+	void Cleanup();
+
 	WSABUF * GetBuffer();
 	size_t GetBufferAmount() const;
+	PoolType GetPoolType() const;
 
 	static bool TestClass();
 };
\ No newline at end of file
@@ -0,0 +1,325 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Constructor.
+ *
+ * @param [in] payload Packet data to send, a reference is added which is released by the destructor.
+ * @param prefix Prefix to place at start of packet, may be NULL. Data is copied, so pointer does not need to remain
+ * valid for lifetime of object.
+ * @param postfix Postfix to place at end of packet, may be NULL. Data is copied, so pointer does not need to remain
+ * valid for lifetime of object.
+ */
+NetSendShared::NetSendShared(NetSendPayload * payload, const Packet * prefix, const Packet * postfix) : NetSend(false)
+{
+	Reinitialize(payload,prefix,postfix);
+}
+
+/**
+ * @brief Constructor, sending the segments of a chain.
+ *
+ * @param chain Packet data to send, a reference to each segment is added which is released by the destructor.
+ * The chain itself does not need to remain valid for lifetime of object.
+ * @param prefix Prefix to place at start of packet, may be NULL. Data is copied, so pointer does not need to remain
+ * valid for lifetime of object.
+ * @param postfix Postfix to place at end of packet, may be NULL. Data is copied, so pointer does not need to remain
+ * valid for lifetime of object.
+ */
+NetSendShared::NetSendShared(const PacketChain & chain, const Packet * prefix, const Packet * postfix) : NetSend(false)
+{
+	Reinitialize(chain,prefix,postfix);
+}
+
+/**
+ * @brief Prepares the object for a new send operation and adds the prefix.
+ *
+ * @param prefix Prefix to place at start of packet, may be NULL. Data is copied.
+ */
+void NetSendShared::Begin(const Packet * prefix)
+{
+	NetSend::Reinitialize(false);
+	buffers.clear();
+
+	/**
+	 * this->prefix and this->postfix will remain valid until this object is reused.
+	 * This object won't be reused until send operation is completed.
+	 */
+	if(prefix != NULL && prefix->GetUsedSize() > 0)
+	{
+		WSABUF buffer;
+		this->prefix = *prefix;
+		this->prefix.PtrIntoWSABUF(buffer);
+		buffers.push_back(buffer);
+	}
+}
+
+/**
+ * @brief Adds shared packet data after the data that has already been added.
+ *
+ * @param [in] payload Packet data to send, a reference is added which is released by Cleanup().
+ */
+void NetSendShared::AddPayload(NetSendPayload * payload)
+{
+	// The payload cannot be deleted until we release our reference
+	payloads.push_back(payload);
+	payload->AddReference();
+	buffers.push_back(payload->GetBuffer());
+}
+
+/**
+ * @brief Adds the postfix after all other data.
+ *
+ * @param postfix Postfix to place at end of packet, may be NULL. Data is copied.
+ */
+void NetSendShared::End(const Packet * postfix)
+{
+	if(postfix != NULL && postfix->GetUsedSize() > 0)
+	{
+		WSABUF buffer;
+		this->postfix = *postfix;
+		this->postfix.PtrIntoWSABUF(buffer);
+		buffers.push_back(buffer);
+	}
+}
+
+/**
+ * @brief Prepares the object for a new send operation.
+ *
+ * Cleanup() must have been called if the object was used previously.
+ *
+ * @param [in] payload Packet data to send, a reference is added which is released by Cleanup().
+ * @param prefix Prefix to place at start of packet, may be NULL. Data is copied.
+ * @param postfix Postfix to place at end of packet, may be NULL. Data is copied.
+ */
+void NetSendShared::Reinitialize(NetSendPayload * payload, const Packet * prefix, const Packet * postfix)
+{
+	_ErrorException((payload == NULL),"constructing a NetSendShared object, payload parameter must not be null",0,__LINE__,__FILE__);
+
+	Begin(prefix);
+	AddPayload(payload);
+	End(postfix);
+}
+
+/**
+ * @brief Prepares the object for a new send operation, sending the segments of a chain.
+ *
+ * Cleanup() must have been called if the object was used previously.
+ *
+ * @param chain Packet data to send, a reference to each segment is added which is released by Cleanup().
+ * @param prefix Prefix to place at start of packet, may be NULL. Data is copied.
+ * @param postfix Postfix to place at end of packet, may be NULL. Data is copied.
+ */
+void NetSendShared::Reinitialize(const PacketChain & chain, const Packet * prefix, const Packet * postfix)
+{
+	Begin(prefix);
+	for(size_t n = 0;n<chain.GetSegmentAmount();n++)
+	{
+		AddPayload(chain.GetSegment(n));
+	}
+	End(postfix);
+}
+
+/**
+ * @brief Destructor, releases references to payloads.
+ */
+NetSendShared::~NetSendShared()
+{
+	Cleanup();
+}
+
+/**
+ * @brief Releases references to payloads.
+ */
+void NetSendShared::Cleanup()
+{
+	for(size_t n = 0;n<payloads.size();n++)
+	{
+		payloads[n]->Release();
+	}
+
+	payloads.clear();
+	buffers.clear();
+}
+
+/** 
+ * @brief Retrieves an array of WSABUF structures containing
+ * data to send (NetSendShared::buffers).
+ *
+ * @return an array of WSABUF containing data to be sent. The
+ * sent packet or data stream will consist of a combination
+ * of all elements of the array, starting from element 0.
+ * @return NULL if there is no data to send.
+ */
+WSABUF * NetSendShared::GetBuffer()
+{
+	if(buffers.empty() == true)
+	{
+		return NULL;
+	}
+
+	return &buffers[0];
+}
+
+/** 
+ * @brief Retrieves the number of elements in the array returned by GetBuffer().
+ *
+ * @return number of elements.
+ */
+size_t NetSendShared::GetBufferAmount() const
+{
+	return buffers.size();
+}
+
+/**
+ * @brief Implements virtual method.
+ *
+ * @return NetSend::SHARED.
+ */
+NetSend::PoolType NetSendShared::GetPoolType() const
+{
+	return SHARED;
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool NetSendShared::TestClass()
+{
+	cout << "Testing NetSendShared class...\n";
+	bool problem = false;
+
+	Packet packet("hello world");
+	Packet prefix("goodbye and ");
+	Packet postfix("!");
+	NetSendPayload * payload = new NetSendPayload(packet);
+
+	{
+		NetSendShared obj1(payload,&prefix,&postfix);
+		NetSendShared obj2(payload,NULL,NULL);
+
+		if(obj1.GetBufferAmount() != 3 || obj2.GetBufferAmount() != 1)
+		{
+			cout << "GetBufferAmount or constructor is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "GetBufferAmount and constructor are good\n";
+		}
+
+		if(prefix.compareWSABUF(obj1.GetBuffer()[0],obj1.GetBuffer()[0].len) == false ||
+		   packet.compareWSABUF(obj1.GetBuffer()[1],obj1.GetBuffer()[1].len) == false ||
+		   postfix.compareWSABUF(obj1.GetBuffer()[2],obj1.GetBuffer()[2].len) == false)
+		{
+			cout << "Constructor is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Constructor is good\n";
+		}
+
+		// Both objects share the same copy of the data
+		if(obj1.GetBuffer()[1].buf != obj2.GetBuffer()[0].buf || payload->GetReferenceCount() != 3)
+		{
+			cout << "Payload sharing is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Payload sharing is good\n";
+		}
+	}
+
+	if(payload->GetReferenceCount() != 1)
+	{
+		cout << "Destructor is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Destructor is good\n";
+	}
+	payload->Release();
+
+	// Segments of a chain are sent without being copied
+	{
+		PacketChain chain;
+		chain.Add(Packet("hello "));
+		chain.Add(Packet("world"));
+
+		NetSendShared obj(chain,&prefix,&postfix);
+		if(obj.GetBufferAmount() != 4 || obj.GetTotalBufferLength() != 24 ||
+		   obj.GetBuffer()[1].buf != chain.GetSegment(0)->GetBuffer().buf ||
+		   obj.GetBuffer()[2].buf != chain.GetSegment(1)->GetBuffer().buf ||
+		   chain.GetSegment(0)->GetReferenceCount() != 2)
+		{
+			cout << "Constructor (chain) is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Constructor (chain) is good\n";
+		}
+
+		obj.Cleanup();
+		if(chain.GetSegment(0)->GetReferenceCount() != 1 || obj.GetBufferAmount() != 0)
+		{
+			cout << "Cleanup (chain) is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Cleanup (chain) is good\n";
+		}
+	}
+
+	// Benchmark preparing a 4KB broadcast to 1000 clients
+	cout << "Benchmarking preparation of a 4KB packet for 1000 clients..\n";
+	const size_t numClients = 1000;
+	const size_t numBroadcasts = 50;
+	Packet broadcast;
+	broadcast.SetMemorySize(4096);
+	broadcast.SetUsedSize(4096);
+	Packet sizePrefix;
+	sizePrefix.AddSizeT(broadcast.GetUsedSize());
+	vector<NetSend*> sendObjects(numClients);
+
+	DWORD startTime = GetTickCount();
+	for(size_t b = 0;b<numBroadcasts;b++)
+	{
+		for(size_t n = 0;n<numClients;n++)
+		{
+			sendObjects[n] = new NetSendPrefix(&broadcast,false,sizePrefix);
+		}
+		for(size_t n = 0;n<numClients;n++)
+		{
+			delete sendObjects[n];
+		}
+	}
+	DWORD copyTime = GetTickCount() - startTime;
+
+	startTime = GetTickCount();
+	for(size_t b = 0;b<numBroadcasts;b++)
+	{
+		NetSendPayload * broadcastPayload = new NetSendPayload(broadcast);
+		for(size_t n = 0;n<numClients;n++)
+		{
+			sendObjects[n] = new NetSendShared(broadcastPayload,&sizePrefix,NULL);
+		}
+		broadcastPayload->Release();
+		for(size_t n = 0;n<numClients;n++)
+		{
+			delete sendObjects[n];
+		}
+	}
+	DWORD sharedTime = GetTickCount() - startTime;
+
+	cout << " " << numBroadcasts << " broadcasts, copy per client: " << copyTime << "ms, shared payload: " << sharedTime << "ms\n";
+
+	cout << "\n\n";
+	return !problem;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "NetSend.h"
+#include "NetSendPayload.h"
+#include "PacketChain.h"
+#include "Packet.h"
+
+/**
+ * @brief Asynchronous send class where the packet data is shared with other send operations.
+ *
+ * The packet data is held by one or more NetSendPayload objects, so sending the same packet to many
+ * recipients copies the data once. Only the prefix and postfix, which are small and may differ
+ * between recipients, are copied by each object.\n\n
+ *
+ * A PacketChain can be sent in the same way, each of its segments becoming one element of the buffer array.\n\n
+ *
+ * This class makes use of scatter/gather I/O to maximize efficiency.
+ */
+class NetSendShared : public NetSend
+{
+	/** @brief Stores prefix, may be empty. */
+	Packet prefix;
+
+	/** @brief Stores postfix, may be empty. */
+	Packet postfix;
+
+	/** @brief Shared packet data, this object holds a reference to each element. */
+	vector<NetSendPayload*> payloads;
+
+	/**
+	 * @brief Array of buffers to be sent.
+	 *
+	 * Consists of the prefix (if not empty), the data of each element of NetSendShared::payloads and the postfix (if not empty).
+	 * Memory is kept when the object is reused.
+	 */
+	vector<WSABUF> buffers;
+
+	void Begin(const Packet * prefix);
+	void AddPayload(NetSendPayload * payload);
+	void End(const Packet * postfix);
+public:
+	NetSendShared(NetSendPayload * payload, const Packet * prefix, const Packet * postfix);
+	NetSendShared(const PacketChain & chain, const Packet * prefix, const Packet * postfix);
+	~NetSendShared();
+
+	void Reinitialize(NetSendPayload * payload, const Packet * prefix, const Packet * postfix);
+	void Reinitialize(const PacketChain & chain, const Packet * prefix, const Packet * postfix);
+	void Cleanup();
+
+	WSABUF * GetBuffer();
+	size_t GetBufferAmount() const;
+	PoolType GetPoolType() const;
+
+	static bool TestClass();
+};
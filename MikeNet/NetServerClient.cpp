@@ -15,6 +15,7 @@ NetServerClient::NetServerClient(size_t clientID, NetSocketTCP * socketTCP, unsi
 {
 	_ErrorException((socketTCP == NULL),"constructing a NetServerClient object, socketTCP parameter must not be NULL",0,__LINE__,__FILE__);
 	
+	stateChanged = NULL;
 	SetConnectionState(NetUtility::NOT_CONNECTED);
 
 	this->socketTCP->SetClientID(clientID);
@@ -116,6 +117,23 @@ void NetServerClient::SetConnectionState(NetUtility::ConnectionStatus state)
 	}
 
 	connectionState.Set(state);
+
+	// Server must disconnect the client, or announce that it has joined
+	if(stateChanged != NULL && (state == NetUtility::DISCONNECTING || state == NetUtility::CONNECTED_AC))
+	{
+		stateChanged->Add(GetClientID());
+	}
+}
+
+/**
+ * @brief Sets the queue that the client ID is added to when the server needs to act upon
+ * a change in connection state.
+ *
+ * @param [in] queue Queue to use, may be NULL. The queue is not owned by this object.
+ */
+void NetServerClient::SetStateChangedQueue(NetClientQueue * queue)
+{
+	stateChanged = queue;
 }
 
 /**
@@ -404,10 +422,11 @@ void NetServerClient::CompletionError(NetSocket * completionSocket, size_t clien
  * @brief Method should never be called, required by base class.
  * 
  * @param socket Ignored.
+ * @param overlapped Ignored.
  * @param bytes Ignored.
  * @param clientID Ignored.
  */
-void NetServerClient::DealCompletion(NetSocket * socket, DWORD bytes, size_t clientID)
+void NetServerClient::DealCompletion(NetSocket * socket, const WSAOVERLAPPED * overlapped, DWORD bytes, size_t clientID)
 {
 	_ErrorException(true,"attempting to call NetServerClient::DealCompletion, all data is dealt with by the NetInstanceServer object encapsulating this object",0,__LINE__,__FILE__);
 }
@@ -37,6 +37,12 @@ class NetServerClient: public NetInstanceImplementedTCP
 	 * if it was fully connected.
 	 */
 	bool wasFullyConnected;
+
+	/**
+	 * @brief Client ID is added to this queue when the connection state changes to a state
+	 * that the server needs to act upon, may be NULL.
+	 */
+	NetClientQueue * stateChanged;
 public:
 
 	NetServerClient(size_t clientID, NetSocketTCP * socketTCP, unsigned int sendTimeout = INFINITE);
@@ -46,6 +52,7 @@ public:
 	size_t GetClientID() const;
 	NetUtility::ConnectionStatus GetConnectionState() const;
 	void SetConnectionState(NetUtility::ConnectionStatus state);
+	void SetStateChangedQueue(NetClientQueue * queue);
 	clock_t GetClockStarted() const;
 	void SetClockStarted();
 	void SetConnectCode(size_t element, int code);
@@ -68,7 +75,7 @@ public:
 	void CompletionError(NetSocket * completionSocket, size_t clientID=0);
 
 	void ErrorOccurred(size_t clientID=0);
-	void DealCompletion(NetSocket * socket, DWORD bytes, size_t clientID);
+	void DealCompletion(NetSocket * socket, const WSAOVERLAPPED * overlapped, DWORD bytes, size_t clientID);
 	
 	void Enter();
 	void Leave();
@@ -288,13 +288,12 @@ bool NetSocket::RemoveSend(const OVERLAPPED * operation)
 
 	sendCleanup.Enter();
 		// Find send operation to remove
-		size_t position = 0;
-		bool found = FindSend(operation,position);
+		NetSend * send = FindSend(operation);
 
-		if(found == true)
+		if(send != NULL)
 		{
-			RemoveSend(position);
-			removed = found;
+			RemoveSend(send);
+			removed = true;
 		}
 	sendCleanup.Leave();
 
@@ -306,46 +305,28 @@ bool NetSocket::RemoveSend(const OVERLAPPED * operation)
  * the send cleanup list.
  *
  * @param operation Pointer to overlapped object.
- * @param [out] position The location of the found send operation will be stored here.
  *
- * @return true if the send operation that is using the specified overlapped object was
- * found in the send cleanup list.
+ * @return the send operation that is using the specified overlapped object, or NULL if it
+ * was not found in the send cleanup list.
  */
-bool NetSocket::FindSend(const OVERLAPPED * operation, size_t & position) const
+NetSend * NetSocket::FindSend(const OVERLAPPED * operation) const
 {
-	bool bFound = false;
-
-	sendCleanup.Enter();
-	{
-		for(size_t n = 0;n<sendCleanup.Size();n++)
-		{
-			if(&sendCleanup[n].overlapped == operation)
-			{
-				position = n;
-				bFound = true;
-
-				break;
-			}
-		}
-	}
-	sendCleanup.Leave();
-
-	return(bFound);
+	return sendCleanup.Find(operation);
 }
 
 /**
- * @brief Cleans up the send operation at the specified element.
+ * @brief Cleans up the specified send operation.
  *
- * @param element Element to cleanup.
+ * @param [in] send Send operation to cleanup, must be in the send cleanup list.
  */
-void NetSocket::RemoveSend(size_t element)
+void NetSocket::RemoveSend(NetSend * send)
 {
 	sendCleanup.Enter();
 	{
-		if(element >= sendCleanup.Size())
+		if(send == NULL || sendCleanup.Contains(send) == false)
 		{
 			sendCleanup.Leave();
-			_ErrorException(true,"cleaning up a send operation by element, element is out of bounds",0,__LINE__,__FILE__);
+			_ErrorException(true,"cleaning up a send operation, send operation is not in the send cleanup list",0,__LINE__,__FILE__);
 		}
 
 		/**
@@ -357,27 +338,28 @@ void NetSocket::RemoveSend(size_t element)
 		 * and so we must wait before we clean it up. We must release the
 		 * critical section BEFORE cleaning it up.
 		 */
-		sendCleanup[element].Enter();
-		sendCleanup[element].Leave();
+		send->Enter();
+		send->Leave();
 
 		// Send operations are only copied to a separate
 		// buffer if asynchronous, otherwise the memory of
 		// the packet itself is used.
-		if(!sendCleanup.GetElement(element).IsBlocking())
+		if(!send->IsBlocking())
 		{
-			sendCleanupSize.DecreaseMemorySize(sendCleanup[element].GetTotalBufferLength());
+			sendCleanupSize.DecreaseMemorySize(send->GetTotalBufferLength());
 		}
 
-		// Cleanup element
-		sendCleanup.Erase(element);
+		// Cleanup send operation, returning it to the pool so that it can be reused
+		sendCleanup.Remove(send);
+		NetSendPool::Recycle(send);
 	}
 	sendCleanup.Leave();
 }
 
 /**
- * @brief Adds a send operation to the cleanup vector.
+ * @brief Adds a send operation to the cleanup list.
  *
- * @param send Send operation to add to cleanup vector.
+ * @param send Send operation to add to cleanup list.
  *
  * @throws ErrorReport If too much memory is used to store send operations in progress.
  */
@@ -396,25 +378,25 @@ void NetSocket::AddSend(NetSend * send)
 }
 
 /**
- * @brief Empties the send cleanup vector, cleaning up all send operations.
+ * @brief Empties the send cleanup list, cleaning up all send operations.
  */
 void NetSocket::ClearSend()
 {
 	sendCleanup.Enter();
 
 	// Cleanup and remove all elements
-	while(sendCleanup.Size() > 0)
+	while(sendCleanup.GetFirst() != NULL)
 	{
-		RemoveSend((size_t)0);
+		RemoveSend(sendCleanup.GetFirst());
 	}
 
 	sendCleanup.Leave();
 }
 
 /**
- * @brief Determines whether the send cleanup vector is empty.
+ * @brief Determines whether the send cleanup list is empty.
  *
- * @return true if the send cleanup vector is empty.
+ * @return true if the send cleanup list is empty.
  */
 bool NetSocket::IsSendEmpty() const
 {
@@ -422,6 +404,16 @@ bool NetSocket::IsSendEmpty() const
 	return returnMe;
 }
 
+/**
+ * @brief Retrieves the pool of send objects that are reused by this socket's send operations.
+ *
+ * @return send object pool.
+ */
+const NetSendPool & NetSocket::GetSendPool() const
+{
+	return sendPool;
+}
+
 /**
  * Associates the socket with a completion port.
  * The completion port takes over the following jobs:
@@ -482,7 +474,7 @@ NetUtility::SendStatus NetSocket::Send(NetSend * sendObject, const NetAddress *
 	{
 		// Cleanup send object because it will never be used.
 		sendObject->Leave();
-		delete sendObject;
+		NetSendPool::Recycle(sendObject);
 		throw report;
 	}
 
@@ -532,7 +524,10 @@ NetUtility::SendStatus NetSocket::Send(NetSend * sendObject, const NetAddress *
 	/* We are done using this object so it is now okay for object to be cleaned up */
 	sendObject->Leave();
 
-	if(returnMe == NetUtility::SEND_FAILED || returnMe == NetUtility::SEND_FAILED_KILL)
+	// A blocking operation that did not complete in time is still in progress and
+	// its completion will clean it up, removing it here would allow the send object to be reused
+	// while winsock is still using it.
+	if(returnMe == NetUtility::SEND_FAILED)
 	{
 		// Operation will never be completed successfully so deallocate manually
 		RemoveSend(&sendObject->overlapped);
@@ -553,6 +548,34 @@ bool NetSocket::IsOurOverlapped(const WSAOVERLAPPED * overlapped) const
 	return &this->recvOverlapped == overlapped;
 }
 
+/**
+ * @brief Retrieves the buffer that the receive operation using the specified overlapped object received data into.
+ *
+ * @param overlapped Overlapped object of a receive operation, IsOurOverlapped() must be true for it.
+ *
+ * @return NetSocket::recvBuffer.
+ */
+const WSABUF & NetSocket::GetRecvBuffer(const WSAOVERLAPPED * overlapped) const
+{
+	return recvBuffer;
+}
+
+/**
+ * @brief Deals with the data received by a completed receive operation.
+ *
+ * By default the data is passed to DealWithData().
+ *
+ * @param overlapped Overlapped object of the receive operation, IsOurOverlapped() must be true for it.
+ * @param completionBytes Number of bytes received.
+ * @param [in] recvFunc Method will be executed and data not added to the queue if this is non NULL.
+ * @param clientID ID of client that data was received from, set to 0 if not applicable.
+ * @param instanceID Instance that data was received on.
+ */
+void NetSocket::DealWithCompletion(const WSAOVERLAPPED * overlapped, DWORD completionBytes, NetSocket::RecvFunc recvFunc, size_t clientID, size_t instanceID)
+{
+	DealWithData(GetRecvBuffer(overlapped),completionBytes,recvFunc,clientID,instanceID);
+}
+
 /**
  * @brief Determines whether the completion port has signaled this socket for closure.
  *
@@ -584,9 +607,11 @@ void NetSocket::CompletionPortRequestClose()
 /**
  * @brief Signal that the receive operation that was last initiated has completed.
  *
+ * @param overlapped Overlapped object of the receive operation.
+ *
  * @warning Should only be used by completion port.
  */
-void NetSocket::SetCompletionPortFinishRecvNotification()
+void NetSocket::SetCompletionPortFinishRecvNotification(const WSAOVERLAPPED * overlapped)
 {
 	notDealingWithData.Set(true);
 }
@@ -731,6 +756,75 @@ public:
 	}
 };
 
+/**
+ * @brief Stress tests send cleanup with many outstanding send operations.
+ *
+ * Send operations are completed in a different order to which they were started, as they
+ * would be by a slow client, and the time is compared with a linear search of the overlapped pointers.
+ *
+ * @param [in] socket Socket to use, its send cleanup list must be empty.
+ * @param sends Number of outstanding send operations.
+ *
+ * @return true if every send operation was found and cleaned up.
+ */
+static bool NetSocketSendCleanupStress(NetSocket & socket, size_t sends)
+{
+	Packet packet("hello world");
+	vector<const OVERLAPPED*> overlapped;
+
+	for(size_t n = 0;n<sends;n++)
+	{
+		NetSend * sendObject = new NetSendRaw(&packet,false);
+		socket.AddSend(sendObject);
+		overlapped.push_back(&sendObject->overlapped);
+	}
+
+	// Odd operations complete first, then even operations newest first
+	vector<const OVERLAPPED*> completionOrder;
+	for(size_t n = 1;n<sends;n+=2)
+	{
+		completionOrder.push_back(overlapped[n]);
+	}
+	for(size_t n = sends;n>0;n--)
+	{
+		if((n-1) % 2 == 0)
+		{
+			completionOrder.push_back(overlapped[n-1]);
+		}
+	}
+
+	// Linear search and erase, as a comparison
+	DWORD startTime = GetTickCount();
+	vector<const OVERLAPPED*> linear(overlapped);
+	for(size_t n = 0;n<completionOrder.size();n++)
+	{
+		for(size_t i = 0;i<linear.size();i++)
+		{
+			if(linear[i] == completionOrder[n])
+			{
+				linear.erase(linear.begin()+i);
+				break;
+			}
+		}
+	}
+	DWORD linearTime = GetTickCount() - startTime;
+
+	startTime = GetTickCount();
+	size_t removed = 0;
+	for(size_t n = 0;n<completionOrder.size();n++)
+	{
+		if(socket.RemoveSend(completionOrder[n]) == true)
+		{
+			removed++;
+		}
+	}
+	DWORD removeTime = GetTickCount() - startTime;
+
+	cout << " " << sends << " outstanding send operations cleaned up in " << removeTime << "ms (linear search: " << linearTime << "ms)\n";
+
+	return removed == sends && socket.IsSendEmpty() == true && socket.GetSendMemorySize() == 0;
+}
+
 /**
  * @brief Tests class.
  *
@@ -766,7 +860,7 @@ bool NetSocket::TestClass()
 	NetSendRaw * sendObj2 = new NetSendRaw(&packet,true);
 	NetSendRaw * sendObj3 = new NetSendRaw(&packet,true);
 
-	cout << "Adding send objects to send cleanup vector..\n";
+	cout << "Adding send objects to send cleanup list..\n";
 	socket.AddSend(sendObj);
 	socket.AddSend(sendObj2);
 	socket.AddSend(sendObj3);
@@ -776,10 +870,9 @@ bool NetSocket::TestClass()
 	OVERLAPPED * sendObjOverlapped3 = &sendObj3->overlapped;
 
 	cout << "Finding send overlapped by overlapped pointer..\n";
-	size_t position = 0;
-	bool found = socket.FindSend(sendObjOverlapped2,position);
+	bool found = (socket.FindSend(sendObjOverlapped2) == sendObj2);
 	
-	if(found == false || position != 1)
+	if(found == false || socket.FindSend(&overlapped) != NULL)
 	{
 		cout << " FindSend is bad\n";
 		problem = true;
@@ -813,7 +906,7 @@ bool NetSocket::TestClass()
 		cout << " IsSendEmpty is good\n";
 	}
 
-	cout << "Erasing send cleanup vector..\n";
+	cout << "Erasing send cleanup list..\n";
 	socket.ClearSend();
 	isEmpty = socket.IsSendEmpty();
 	if(isEmpty == false)
@@ -826,6 +919,16 @@ bool NetSocket::TestClass()
 		cout << " IsSendEmpty is good\n";
 	}
 
+	cout << "Stress testing send cleanup..\n";
+	if(NetSocketSendCleanupStress(socket,10000) == false)
+	{
+		cout << " RemoveSend stress test is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << " RemoveSend stress test is good\n";
+	}
 	
 	cout << "Associating socket with completion port..\n";
 	NetUtility::StartWinsock();
@@ -89,16 +89,15 @@ protected:
 
 private:
 	/**
-	 * @brief This vector is filled with send operations that are in progress.
+	 * @brief This list is filled with send operations that are in progress.
 	 *
-	 * Upon completion, a completion thread compares the overlapped pointer using.
+	 * Upon completion, a completion thread looks up the overlapped pointer using
 	 * RemoveSend() to determine which send operation should be cleaned up.
-	 * When cleaned up the send operation is removed from this vector.
+	 * When cleaned up the send operation is removed from this list.
 	 *
-	 * @note Vector should not be used if socket is not associated with completion port.
-	 * @note Made mutable because vector CPP class is not const correct.
+	 * @note List should not be used if socket is not associated with completion port.
 	 */
-	mutable StoreVector<NetSend> sendCleanup;
+	mutable NetSendList sendCleanup;
 
 	/**
 	 * Keeps track of and restricts how much memory sendCleanup is using.
@@ -107,6 +106,16 @@ private:
 	 */
 	MemoryUsageLogRestricted sendCleanupSize;
 
+protected:
+	/**
+	 * @brief Send objects that are no longer in use, which are reused by later send operations.
+	 *
+	 * Send operations in NetSocket::sendCleanup are returned to this pool when they are removed.
+	 */
+	NetSendPool sendPool;
+
+private:
+
 	void AllocateBuffer(size_t bufferLength);
 	void Initialize(size_t bufferLength);
 public:
@@ -126,11 +135,12 @@ public:
 	void SetClientID( size_t clientID );
 
 	bool RemoveSend(const OVERLAPPED * operation);
-	void RemoveSend(size_t element);
+	void RemoveSend(NetSend * send);
 	void AddSend(NetSend * send);
 	void ClearSend();
-	bool FindSend(const OVERLAPPED * operation, size_t & position) const;
+	NetSend * FindSend(const OVERLAPPED * operation) const;
 	bool IsSendEmpty() const;
+	const NetSendPool & GetSendPool() const;
 
 	virtual void Close();
 
@@ -167,9 +177,10 @@ public:
 	 */
 	virtual NetUtility::SendStatus Send(const Packet & packet, bool block, const NetAddress * sendToAddr, unsigned int timeout)=0;
 
-	size_t GetRecvBufferLength() const;
+	virtual size_t GetRecvBufferLength() const;
 
-	bool IsOurOverlapped(const WSAOVERLAPPED * overlapped) const;
+	virtual bool IsOurOverlapped(const WSAOVERLAPPED * overlapped) const;
+	virtual const WSABUF & GetRecvBuffer(const WSAOVERLAPPED * overlapped) const;
 
 	/**
 	 * @brief Retrieves the protocol type that the socket represents as an enum.
@@ -193,12 +204,13 @@ public:
 	 * @param clientID ID of client that data was received from, set to 0 if not applicable.
 	 */
 	virtual void DealWithData(const WSABUF & buffer, size_t completionBytes, NetSocket::RecvFunc recvFunc, size_t clientID, size_t instanceID)=0;
+	virtual void DealWithCompletion(const WSAOVERLAPPED * overlapped, DWORD completionBytes, NetSocket::RecvFunc recvFunc, size_t clientID, size_t instanceID);
 
 	virtual void CompletedSendOperation(const WSAOVERLAPPED * overlapped, bool success, bool shuttingDown);
 
 	bool GetCompletionPortCloseRequest() const;
 	void CompletionPortRequestClose();
-	void SetCompletionPortFinishRecvNotification();
+	virtual void SetCompletionPortFinishRecvNotification(const WSAOVERLAPPED * overlapped);
 
 	static bool TestClass();
 };
\ No newline at end of file
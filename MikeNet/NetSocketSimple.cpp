@@ -206,8 +206,8 @@ void NetSocketSimple::SetReusable()
 	_ErrorException((IsSetup() == false),"making a socket reusable, the socket has not been setup",0,__LINE__,__FILE__);
 	_ErrorException((IsBound() == true),"making a socket reusable, the socket has been bound",0,__LINE__,__FILE__);
 
-	bool bOption = 1;
-	int iResult = setsockopt(winsockSocket, SOL_SOCKET, SO_REUSEADDR, (char*)&bOption,sizeof(bool));
+	BOOL bOption = TRUE;
+	int iResult = setsockopt(winsockSocket, SOL_SOCKET, SO_REUSEADDR, (char*)&bOption,sizeof(BOOL));
 	_ErrorException((iResult==SOCKET_ERROR),"making a socket reusable",WSAGetLastError(),__LINE__,__FILE__);
 
 	reusable = true;
@@ -362,8 +362,8 @@ void NetSocketSimple::SetBroadcasting()
 	_ErrorException((IsSetup() == false),"setting a socket to broadcast mode, the socket has not been setup",0,__LINE__,__FILE__);
 	_ErrorException((IsBound() == true),"setting a socket to broadcasting mode, the socket has been bound",0,__LINE__,__FILE__);
 
-	bool bOption = true;
-	int iResult = setsockopt(winsockSocket, SOL_SOCKET, SO_BROADCAST,(char*)&bOption,sizeof(bool));
+	BOOL bOption = TRUE;
+	int iResult = setsockopt(winsockSocket, SOL_SOCKET, SO_BROADCAST,(char*)&bOption,sizeof(BOOL));
 	_ErrorException((iResult==SOCKET_ERROR),"setting a socket to broadcasting mode",WSAGetLastError(),__LINE__,__FILE__);
 
 	broadcasting = true;
@@ -395,8 +395,8 @@ void NetSocketSimple::DisableNagle()
 	_ErrorException((IsSetup() == false),"disabling the nagle algorithm on a socket, the socket has not been setup",0,__LINE__,__FILE__);
 	_ErrorException((IsBound() == true),"disabling the nagle algorithm on a socket, the socket has been bound",0,__LINE__,__FILE__);
 
-	bool bOption = true;
-	int iResult = setsockopt(winsockSocket, SOL_SOCKET, TCP_NODELAY,(char*)&bOption,sizeof(bool));
+	BOOL bOption = TRUE;
+	int iResult = setsockopt(winsockSocket, IPPROTO_TCP, TCP_NODELAY,(char*)&bOption,sizeof(BOOL));
 	_ErrorException((iResult==SOCKET_ERROR),"disabling the nagle algorithm on a TCP socket",WSAGetLastError(),__LINE__,__FILE__);
 
 	nagleEnabled = false;
@@ -27,6 +27,9 @@ void NetSocketTCP::Initialize(bool gracefulDisconnectEnabled, NetModeTcp * modeT
 	
 	this->modeTCP = modeTCP;
 
+	recvRegion.buf = NULL;
+	recvRegion.len = 0;
+
 	sendPossible = true;
 
 	if(gracefulDisconnectEnabled == true)
@@ -146,6 +149,10 @@ void NetSocketTCP::Copy(const NetSocketTCP & copyMe)
 {
 	this->sendPossible = copyMe.sendPossible;
 
+	// Receive region belongs to copyMe's partial packet
+	recvRegion.buf = NULL;
+	recvRegion.len = 0;
+
 	if(copyMe.IsGracefulDisconnectEnabled() == true)
 	{
 		if(gracefulShutdown != NULL)
@@ -237,7 +244,9 @@ void NetSocketTCP::LoadSOCKET(SOCKET paraSocket, const NetAddress & addr)
  * This method calls the winsock method @c WSARecv.\n\n
  *
  * If @c WSARecv is successful the result of the operation (which will probably not complete instantly) will be passed to the completion port.
- * Upon completion NetSocket::recvBuffer will be filled with received data.\n\n
+ * Data is received directly into the free space of NetSocketTCP::modeTCP's partial packet, see NetModeTcp::GetRecvRegion(),
+ * unless the mode does not use a partial packet in which case NetSocket::recvBuffer is used.
+ * At least NetSocket::recvBuffer's length is made available where possible.\n\n
  * 
  * If @c WSARecv is unsuccessful the operation will not complete so the completion port will receive no notification. This
  * means that we must manually set the overlapped event in the case of initial failure.
@@ -253,10 +262,18 @@ bool NetSocketTCP::Recv()
 
 	// Prepare for new receive operation
 	ClearRecv();
+	if(modeTCP->IsRecvInPlace() == true)
+	{
+		recvRegion = modeTCP->GetRecvRegion(recvBuffer.len);
+	}
+	else
+	{
+		recvRegion = recvBuffer;
+	}
 
 	// Start new receive operation
 	notDealingWithData.Set(false);
-	iResult = WSARecv(winsockSocket, &recvBuffer, 1, NULL, &flags, &recvOverlapped, NULL);
+	iResult = WSARecv(winsockSocket, &recvRegion, 1, NULL, &flags, &recvOverlapped, NULL);
 
 	// WSA_IO_PENDING indicates that receive operation was started, but did not complete instantly
 	// The receive operation may still be successful however and complete at a later time.
@@ -270,6 +287,18 @@ bool NetSocketTCP::Recv()
 	return error;
 }
 
+/**
+ * @brief Retrieves the buffer that the receive operation using the specified overlapped object received data into.
+ *
+ * @param overlapped Overlapped object of a receive operation, IsOurOverlapped() must be true for it.
+ *
+ * @return NetSocketTCP::recvRegion.
+ */
+const WSABUF & NetSocketTCP::GetRecvBuffer(const WSAOVERLAPPED * overlapped) const
+{
+	return recvRegion;
+}
+
 /**
  * @brief Checks the status of the TCP handshake routine started by NetSocketSimple::Connect().
  * 
@@ -288,7 +317,7 @@ bool NetSocketTCP::PollConnect() const
 	FD_ZERO(&fdSetWrite);
 	FD_SET(winsockSocket,&fdSetWrite);
 
-	returnMe = select(NULL,NULL,&fdSetWrite,NULL,&tvTimeout);
+	returnMe = select(static_cast<int>(winsockSocket)+1,NULL,&fdSetWrite,NULL,&tvTimeout); // First parameter is ignored by winsock
 	_ErrorException((returnMe==SOCKET_ERROR),"checking the status of the connection process",WSAGetLastError(),__LINE__,__FILE__);
 
 	return(returnMe == 0);
@@ -370,7 +399,40 @@ bool NetSocketTCP::IsRecvPossible() const
  */
 NetUtility::SendStatus NetSocketTCP::Send(const Packet & packet, bool block, const NetAddress * sendToAddr,unsigned int timeout)
 {
-	return NetSocket::Send(modeTCP->GetSendObject(&packet,block),NULL,timeout);
+	return NetSocket::Send(modeTCP->GetSendObject(&packet,block,sendPool),NULL,timeout);
+}
+
+/** 
+ * @brief Sends a packet asynchronously using this socket, sharing a copy of its data with other send operations.
+ *
+ * @param packet Packet to send.
+ * @param [in] payload Copy of @a packet's data, see NetSendPayload.
+ * @param timeout Length of time in milliseconds to wait before canceling send operation.
+ *
+ * @return NetUtility::SEND_COMPLETED if the send operation completed successfully instantly.
+ * @return NetUtility::SEND_IN_PROGRESS if the send operation was started, but has not yet completed.
+ * @return NetUtility::SEND_FAILED if the send operation failed.
+ * @return NetUtility::SEND_FAILED_KILL if the send operation failed and an entity was killed as a result (e.g. Client disconnected).
+ */
+NetUtility::SendStatus NetSocketTCP::SendShared(const Packet & packet, NetSendPayload * payload, unsigned int timeout)
+{
+	return NetSocket::Send(modeTCP->GetSharedSendObject(&packet,payload,sendPool),NULL,timeout);
+}
+
+/** 
+ * @brief Sends a packet chain asynchronously using this socket, each segment is sent without being copied.
+ *
+ * @param chain Packet data to send, see PacketChain.
+ * @param timeout Length of time in milliseconds to wait before canceling send operation.
+ *
+ * @return NetUtility::SEND_COMPLETED if the send operation completed successfully instantly.
+ * @return NetUtility::SEND_IN_PROGRESS if the send operation was started, but has not yet completed.
+ * @return NetUtility::SEND_FAILED if the send operation failed.
+ * @return NetUtility::SEND_FAILED_KILL if the send operation failed and an entity was killed as a result (e.g. Client disconnected).
+ */
+NetUtility::SendStatus NetSocketTCP::SendChain(const PacketChain & chain, unsigned int timeout)
+{
+	return NetSocket::Send(modeTCP->GetChainSendObject(chain,sendPool),NULL,timeout);
 }
 
 /**
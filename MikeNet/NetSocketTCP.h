@@ -40,6 +40,13 @@ class NetSocketTCP: public NetSocket
 	 */
 	NetModeTcp * modeTCP;
 
+	/**
+	 * @brief Part of NetSocketTCP::modeTCP's partial packet that the current receive operation writes into.
+	 *
+	 * Received data is framed where it is, rather than being copied out of NetSocket::recvBuffer.
+	 */
+	WSABUF recvRegion;
+
 	void AssociateGracefulDisconnect();
 	void Initialize(bool gracefulDisconnectEnabled, NetModeTcp * modeTCP);
 
@@ -58,6 +65,8 @@ public:
 	bool PollConnect() const;
 
 	NetUtility::SendStatus Send(const Packet & packet, bool block, const NetAddress * sendToAddr, unsigned int timeout);
+	NetUtility::SendStatus SendShared(const Packet & packet, NetSendPayload * payload, unsigned int timeout);
+	NetUtility::SendStatus SendChain(const PacketChain & chain, unsigned int timeout);
 
 	void Shutdown();
 	void StopSend();
@@ -65,6 +74,7 @@ public:
 	bool IsRecvPossible() const;
 
 	bool Recv();
+	const WSABUF & GetRecvBuffer(const WSAOVERLAPPED * overlapped) const;
 
 	virtual void Close();
 
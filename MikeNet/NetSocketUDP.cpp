@@ -16,14 +16,24 @@
  *										Care must be taken to ensure that this function is thread safe.
  *										If NULL then packets will not be passed to a function, and instead
  *										will be put into a queue.
+ * @param	recvDepth					Number of receive operations that can be in progress at the same time (optional, default 1).
+ *										Each operation has its own receive buffer of @a bufferLength bytes.
+ * @param	recvBatch					Maximum number of datagrams received by each receive operation with one
+ *										system call (optional, default 1). Only supported on Linux, ignored on Windows.
+ * @param	recvCoalescing				If true UDP receive coalescing (GRO) is enabled, so that the kernel can pass several
+ *										datagrams from the same source as one message (optional, default false).
+ *										Only supported on Linux, ignored on Windows or if not supported by the kernel.
  */
-NetSocketUDP::NetSocketUDP(size_t bufferLength, const NetAddress & localAddr, bool reusable, NetModeUdp * udpMode, NetSocket::RecvFunc recvFunc) : NetSocket(bufferLength, recvFunc), recvAddr()
+NetSocketUDP::NetSocketUDP(size_t bufferLength, const NetAddress & localAddr, bool reusable, NetModeUdp * udpMode, NetSocket::RecvFunc recvFunc, size_t recvDepth, size_t recvBatch, bool recvCoalescing) : NetSocket(0, recvFunc), recvOperations(), recvLock(), recvCallCount(static_cast<size_t>(0)), recvPacketCount(static_cast<size_t>(0))
 {
 	try
 	{
 		modeUDP = udpMode;
 
+		AllocateRecvOperations(bufferLength,recvDepth,recvBatch,recvCoalescing);
+
 		Setup(NetSocketSimple::UDP);
+		EnableRecvCoalescing(recvCoalescing);
 
 		if(reusable)
 		{
@@ -37,6 +47,7 @@ NetSocketUDP::NetSocketUDP(size_t bufferLength, const NetAddress & localAddr, bo
 	catch(ErrorReport & error)
 	{
 		Close();
+		DeallocateRecvOperations();
 		delete udpMode;
 		throw error;
 	}
@@ -54,15 +65,25 @@ NetSocketUDP::NetSocketUDP(size_t bufferLength, const NetAddress & localAddr, bo
  *										Care must be taken to ensure that this function is thread safe.
  *										If NULL then packets will not be passed to a function, and instead
  *										will be put into a queue.
+ * @param	recvDepth					Number of receive operations that can be in progress at the same time (optional, default 1).
+ *										Each operation has its own receive buffer of @a bufferLength bytes.
+ * @param	recvBatch					Maximum number of datagrams received by each receive operation with one
+ *										system call (optional, default 1). Only supported on Linux, ignored on Windows.
+ * @param	recvCoalescing				If true UDP receive coalescing (GRO) is enabled, so that the kernel can pass several
+ *										datagrams from the same source as one message (optional, default false).
+ *										Only supported on Linux, ignored on Windows or if not supported by the kernel.
  */
-NetSocketUDP::NetSocketUDP(size_t bufferLength, const NetAddress & localAddr, NetSocket::RecvFunc recvFunc) : NetSocket(bufferLength, recvFunc), recvAddr()
+NetSocketUDP::NetSocketUDP(size_t bufferLength, const NetAddress & localAddr, NetSocket::RecvFunc recvFunc, size_t recvDepth, size_t recvBatch, bool recvCoalescing) : NetSocket(0, recvFunc), recvOperations(), recvLock(), recvCallCount(static_cast<size_t>(0)), recvPacketCount(static_cast<size_t>(0))
 {
 	NetModeUdpCatchAll * mode = new (nothrow) NetModeUdpCatchAll(1);
 	Utility::DynamicAllocCheck(mode,__LINE__,__FILE__);
 
 	modeUDP.Set(mode);
 
+	AllocateRecvOperations(bufferLength,recvDepth,recvBatch,recvCoalescing);
+
 	Setup(NetSocketSimple::UDP);
+	EnableRecvCoalescing(recvCoalescing);
 	SetReusable();
 
 	SetBroadcasting();
@@ -72,16 +93,95 @@ NetSocketUDP::NetSocketUDP(size_t bufferLength, const NetAddress & localAddr, Ne
 	Bind(localAddr);
 }
 
+/**
+ * @brief Enables UDP receive coalescing on the socket.
+ *
+ * Failure is ignored because older kernels do not support coalescing,
+ * in which case datagrams are received individually.
+ *
+ * @param recvCoalescing If false nothing is done.
+ */
+void NetSocketUDP::EnableRecvCoalescing(bool recvCoalescing)
+{
+#ifndef _WIN32
+	if(recvCoalescing == true)
+	{
+		WSASetRecvCoalescing(winsockSocket,TRUE);
+	}
+#endif
+}
+
+/**
+ * @brief Allocates NetSocketUDP::recvOperations.
+ *
+ * @param bufferLength Length of each receive buffer in bytes.
+ * @param recvDepth Number of receive operations, a value of 0 is treated as 1.
+ * @param recvBatch Maximum number of datagrams received by each receive operation.
+ * @param recvCoalescing True if UDP receive coalescing is enabled.
+ */
+void NetSocketUDP::AllocateRecvOperations(size_t bufferLength, size_t recvDepth, size_t recvBatch, bool recvCoalescing)
+{
+	if(recvDepth == 0)
+	{
+		recvDepth = 1;
+	}
+
+	recvOperations.reserve(recvDepth);
+	for(size_t n = 0;n<recvDepth;n++)
+	{
+		NetRecvUDP * operation = new (nothrow) NetRecvUDP(bufferLength,recvBatch,recvCoalescing);
+		Utility::DynamicAllocCheck(operation,__LINE__,__FILE__);
+		recvOperations.push_back(operation);
+	}
+}
+
+/**
+ * @brief Deallocates NetSocketUDP::recvOperations.
+ *
+ * @warning No receive operations may be in progress.
+ */
+void NetSocketUDP::DeallocateRecvOperations()
+{
+	for(size_t n = 0;n<recvOperations.size();n++)
+	{
+		delete recvOperations[n];
+	}
+	recvOperations.clear();
+}
+
 /**
  * @brief Copy constructor / assignment operator helper method.
  *
+ * Receive operations are not copied, but the same number of operations
+ * with the same buffer length are allocated.
+ *
  * @note Does not copy modeUDP, do this elsewhere.
  *
  * @param	copyMe	Object to copy.
  */
 void NetSocketUDP::Copy(const NetSocketUDP & copyMe)
 {
-	this->recvAddr = copyMe.recvAddr;
+	DeallocateRecvOperations();
+	AllocateRecvOperations(copyMe.GetRecvBufferLength(),copyMe.GetRecvDepth(),copyMe.GetRecvBatch(),copyMe.IsRecvCoalescing());
+}
+
+/**
+ * @brief Finds the receive operation that uses the specified overlapped object.
+ *
+ * @param overlapped Overlapped object to search for.
+ *
+ * @return the receive operation, or NULL if no receive operation of this socket uses @a overlapped.
+ */
+NetRecvUDP * NetSocketUDP::FindRecvOperation(const WSAOVERLAPPED * overlapped) const
+{
+	for(size_t n = 0;n<recvOperations.size();n++)
+	{
+		if(&recvOperations[n]->overlapped == overlapped)
+		{
+			return recvOperations[n];
+		}
+	}
+	return NULL;
 }
 
 /**
@@ -89,7 +189,7 @@ void NetSocketUDP::Copy(const NetSocketUDP & copyMe)
  *
  * @param	copyMe	Object to copy.
  */
-NetSocketUDP::NetSocketUDP(const NetSocketUDP & copyMe) : NetSocket(copyMe), recvAddr(), modeUDP(copyMe.modeUDP)
+NetSocketUDP::NetSocketUDP(const NetSocketUDP & copyMe) : NetSocket(copyMe), recvOperations(), recvLock(), recvCallCount(static_cast<size_t>(0)), recvPacketCount(static_cast<size_t>(0)), modeUDP(copyMe.modeUDP)
 {
 	Copy(copyMe);
 }
@@ -119,6 +219,7 @@ NetSocketUDP::~NetSocketUDP()
 	try
 	{
 		Close();
+		DeallocateRecvOperations();
 
 		modeUDP.Enter();
 		delete modeUDP.Get();
@@ -128,24 +229,14 @@ NetSocketUDP::~NetSocketUDP()
 }
 
 /**
- * @brief Clears NetSocket::recvOverlapped and NetSocketUDP::recvAddr ready for next receive.
- *
- * This must be done after every receive operation.
- */
-void NetSocketUDP::ClearRecv()
-{
-	NetSocket::ClearRecv();
-	recvAddr.Clear();
-}
-
-/**
- * @brief Starts a receive operation via TCP.
+ * @brief Starts receive operations via UDP.
  *
- * This method calls the winsock method @c WSARecvFrom.\n\n
+ * This method calls the winsock method @c WSARecvFrom once for each idle receive operation,
+ * so that up to GetRecvDepth() receive operations are in progress at the same time.\n\n
  *
  * If @c WSARecvFrom is successful the result of the operation (which will probably not complete instantly) will be passed to the completion port.
- * Upon completion NetSocket::recvBuffer will be filled with received data and NetSocket::recvAddr will be filled with the address that the packet
- * came from, which can be different to the address we are connected to.\n\n
+ * Upon completion the operation's buffer will be filled with received data and its address will be filled with the address that the packet
+ * came from, which can be different to the address we are connected to. Use GetRecvBuffer() and GetRecvAddress() to access these.\n\n
  * 
  * If @c WSARecvFrom is unsuccessful the operation will not complete so the completion port will receive no notification. This
  * means that we must manually set the overlapped event in the case of initial failure.
@@ -159,27 +250,148 @@ bool NetSocketUDP::Recv()
 {
 	ValidateModeLoaded(__LINE__,__FILE__);
 
-	// Prepare for new receive operation
-	ClearRecv();
+	bool error = false;
 
-	// Start new receive operation
-	// Note: no point in using multithreaded controls on recvAddr
-	// No way of telling when winsock is done with it
-	// This does not matter though due to the way we are using recvAddr
-	notDealingWithData.Set(false);
-	int iResult = WSARecvFrom(winsockSocket, &recvBuffer, 1, NULL, &flags, (SOCKADDR*)recvAddr.GetAddrPtr(), NetUtility::GetSizeSOCKADDR(), &recvOverlapped, NULL);
-
-	// WSA_IO_PENDING indicates that receive operation was started, but did not complete instantly
-	// The receive operation may still be successful however and complete at a later time.
-	bool error = (iResult == SOCKET_ERROR && WSAGetLastError() != WSA_IO_PENDING);
-	if(error == true)
+	recvLock.Enter();
+	try
 	{
-		SetRecvOverlappedEvent();
-		notDealingWithData.Set(true);
+		for(size_t n = 0;n<recvOperations.size();n++)
+		{
+			NetRecvUDP * operation = recvOperations[n];
+			if(operation->IsIdle() == false)
+			{
+				continue;
+			}
+
+			// Prepare for new receive operation
+			operation->Begin();
+
+			// Start new receive operation
+			int iResult;
+#ifndef _WIN32
+			if(operation->IsBatched() == true)
+			{
+				iResult = WSARecvFromBatch(winsockSocket, &operation->messages[0], static_cast<DWORD>(operation->messages.size()), &operation->messagesReceived, &operation->overlapped);
+			}
+			else
+#endif
+			{
+				iResult = WSARecvFrom(winsockSocket, &operation->buffer, 1, NULL, &operation->flags, (SOCKADDR*)operation->recvAddr.GetAddrPtr(), &operation->recvAddrLength, &operation->overlapped, NULL);
+			}
+
+			// WSA_IO_PENDING indicates that receive operation was started, but did not complete instantly
+			// The receive operation may still be successful however and complete at a later time.
+			error = (iResult == SOCKET_ERROR && WSAGetLastError() != WSA_IO_PENDING);
+			if(error == true)
+			{
+				operation->Failed();
+				break;
+			}
+		}
 	}
+	catch(ErrorReport & errorReport){ recvLock.Leave(); throw errorReport; }
+	catch(...){ recvLock.Leave(); throw -1; }
+	recvLock.Leave();
+
 	return error;
 }
 
+/**
+ * @brief Retrieves the number of receive operations that can be in progress at the same time.
+ *
+ * @return the number of receive operations.
+ */
+size_t NetSocketUDP::GetRecvDepth() const
+{
+	return recvOperations.size();
+}
+
+/**
+ * @brief Retrieves the maximum number of datagrams received by each receive operation with one system call.
+ *
+ * @return the batch size, always 1 on Windows.
+ */
+size_t NetSocketUDP::GetRecvBatch() const
+{
+	if(recvOperations.empty() == true)
+	{
+		return 1;
+	}
+	return recvOperations[0]->GetBatchSize();
+}
+
+/**
+ * @brief Determines whether UDP receive coalescing was requested for this socket.
+ *
+ * @return true if coalescing was requested.
+ */
+bool NetSocketUDP::IsRecvCoalescing() const
+{
+	if(recvOperations.empty() == true)
+	{
+		return false;
+	}
+	return recvOperations[0]->IsCoalescing();
+}
+
+/**
+ * @brief Retrieves the length of each receive operation's buffer.
+ *
+ * @return the maximum amount of data that can be received in one receive operation.
+ */
+size_t NetSocketUDP::GetRecvBufferLength() const
+{
+	if(recvOperations.empty() == true)
+	{
+		return 0;
+	}
+	return recvOperations[0]->GetBufferLength();
+}
+
+/**
+ * @brief Determines whether the specified overlapped object belongs to one of this socket's receive operations.
+ *
+ * @param overlapped Overlapped object to compare.
+ *
+ * @return true if @a overlapped is used by one of this socket's receive operations.
+ */
+bool NetSocketUDP::IsOurOverlapped(const WSAOVERLAPPED * overlapped) const
+{
+	return FindRecvOperation(overlapped) != NULL;
+}
+
+/**
+ * @brief Retrieves the buffer that the receive operation using the specified overlapped object received data into.
+ *
+ * @param overlapped Overlapped object of a receive operation, IsOurOverlapped() must be true for it.
+ *
+ * @return the receive operation's buffer.
+ * @throws ErrorReport If @a overlapped does not belong to this socket.
+ */
+const WSABUF & NetSocketUDP::GetRecvBuffer(const WSAOVERLAPPED * overlapped) const
+{
+	NetRecvUDP * operation = FindRecvOperation(overlapped);
+	_ErrorException((operation == NULL),"retrieving a UDP receive buffer, overlapped object does not belong to this socket",0,__LINE__,__FILE__);
+	return operation->buffer;
+}
+
+/**
+ * @brief Signal that the receive operation using the specified overlapped object has completed
+ * and its data has been dealt with, so that it can be started again.
+ *
+ * @param overlapped Overlapped object of the receive operation.
+ *
+ * @warning Should only be used by completion port.
+ */
+void NetSocketUDP::SetCompletionPortFinishRecvNotification(const WSAOVERLAPPED * overlapped)
+{
+	NetRecvUDP * operation = FindRecvOperation(overlapped);
+	if(operation != NULL)
+	{
+		operation->Finished();
+	}
+}
+
 /** 
  * @brief Sends a packet using this socket.
  *
@@ -198,7 +410,7 @@ bool NetSocketUDP::Recv()
 NetUtility::SendStatus NetSocketUDP::Send(const Packet & packet, bool block, const NetAddress * sendToAddr, unsigned int timeout)
 {
 	ValidateModeLoaded(__LINE__,__FILE__);
-	return NetSocket::Send(modeUDP.Get()->GetSendObject(&packet,block),sendToAddr,timeout);
+	return NetSocket::Send(modeUDP.Get()->GetSendObject(&packet,block,sendPool),sendToAddr,timeout);
 }
 
 /** 
@@ -224,13 +436,103 @@ NetUtility::SendStatus NetSocketUDP::RawSend(const Packet & packet, bool block,
 	return NetSocket::Send(sendObject,sendToAddr,timeout);
 }
 
+/**
+ * @brief Sends a packet to several addresses with as few system calls as possible.
+ *
+ * The packet's data is shared by all destinations, only the UDP mode's prefix (see NetModeUdp::AddSendPrefix)
+ * is generated for each one. Datagrams are handed to the kernel synchronously using WSASendToBatch,
+ * so no send objects are created.\n\n
+ *
+ * Batched sending is only supported on Linux. If the socket's send buffer fills up, on Windows, or if the UDP mode
+ * seals packets (see NetModeUdp::SetAuthenticatedEncryption()), the method stops early and the caller should send
+ * to the remaining destinations using Send().
+ *
+ * @param packet Packet to send.
+ * @param clientIDs Array of @a amount client IDs, used by the UDP mode to generate each prefix.
+ * @param sendToAddrs Array of @a amount addresses to send to.
+ * @param amount Number of destinations.
+ *
+ * @return the number of destinations, starting from element 0, that were dealt with.
+ * Destinations that failed are included because UDP sending is unreliable.
+ */
+size_t NetSocketUDP::SendBatch(const Packet & packet, const size_t * clientIDs, const NetAddress * const * sendToAddrs, size_t amount)
+{
+#ifdef _WIN32
+	return 0;
+#else
+	ValidateModeLoaded(__LINE__,__FILE__);
+	_ErrorException((clientIDs == NULL || sendToAddrs == NULL),"sending a UDP packet to several addresses, clientIDs and sendToAddrs must not be NULL",0,__LINE__,__FILE__);
+
+	// Each destination needs its own sealed copy of the data
+	if(amount == 0 || modeUDP.Get()->IsAuthenticatedEncryption() == true)
+	{
+		return 0;
+	}
+
+	// Prefixes of all destinations are stored one after another
+	Packet prefixes;
+	vector<size_t> prefixEnd(amount);
+	for(size_t n = 0;n<amount;n++)
+	{
+		modeUDP.Get()->AddSendPrefix(prefixes,clientIDs[n]);
+		prefixEnd[n] = prefixes.GetUsedSize();
+	}
+
+	// Data of packet is not copied because sending is synchronous
+	vector<WSABUF> buffers(amount * 2);
+	vector<WSABATCHSENDMSG> messages(amount);
+	size_t prefixStart = 0;
+	for(size_t n = 0;n<amount;n++)
+	{
+		WSABUF * messageBuffers = &buffers[n * 2];
+		DWORD bufferCount = 0;
+
+		if(prefixEnd[n] > prefixStart)
+		{
+			messageBuffers[bufferCount].buf = prefixes.GetDataPtr() + prefixStart;
+			messageBuffers[bufferCount].len = static_cast<ULONG>(prefixEnd[n] - prefixStart);
+			bufferCount++;
+		}
+		packet.PtrIntoWSABUF(messageBuffers[bufferCount]);
+		bufferCount++;
+		prefixStart = prefixEnd[n];
+
+		messages[n].buffers = messageBuffers;
+		messages[n].bufferCount = bufferCount;
+		messages[n].to = reinterpret_cast<const SOCKADDR*>(sendToAddrs[n]->GetAddrPtr());
+		messages[n].toLength = sizeof(SOCKADDR);
+	}
+
+	DWORD messagesSent = 0;
+	WSASendToBatch(winsockSocket,&messages[0],static_cast<DWORD>(amount),&messagesSent);
+	return messagesSent;
+#endif
+}
+
 /**
  * @brief Closes socket and resets NetSocketTCP::modeUDP to unused state. 
  */
 void NetSocketUDP::Close()
 {
+	bool wasSetup = IsSetup();
+
 	NetSocket::Close();
 
+	// Wait for receive operations to be canceled and their data to be dealt with.
+	// If the completion port is not setup it cannot signal that it is done dealing with data,
+	// so we only wait for the operations to be canceled.
+	if(wasSetup == true)
+	{
+		for(size_t n = 0;n<recvOperations.size();n++)
+		{
+			if(NetUtility::IsCompletionPortSetup() == false)
+			{
+				recvOperations[n]->Finished();
+			}
+			recvOperations[n]->WaitUntilIdle();
+		}
+	}
+
 	if(IsModeLoaded() == true)
 	{
 		modeUDP.Get()->Reset();
@@ -325,13 +627,96 @@ NetSocket::Protocol NetSocketUDP::GetProtocol() const
 }
 
 /**
- * @brief Determines where the packet that was last received from came from.
+ * @brief Splits the data received by the specified receive operation into datagrams.
  *
- * @return the remote address that the last received packet was sent from.
+ * Must be used once when the receive operation completes, before GetRecvDatagrams() and GetRecvAddress().
+ * Also updates the statistics returned by GetRecvPacketsPerCall().
+ *
+ * @param overlapped Overlapped object of the receive operation, IsOurOverlapped() must be true for it.
+ * @param completionBytes Number of bytes reported by the completion port.
+ *
+ * @return the number of datagrams received.
+ * @throws ErrorReport If @a overlapped does not belong to this socket.
  */
-const NetAddress & NetSocketUDP::GetRecvAddress() const
+size_t NetSocketUDP::Received(const WSAOVERLAPPED * overlapped, DWORD completionBytes)
 {
-	return recvAddr;
+	NetRecvUDP * operation = FindRecvOperation(overlapped);
+	_ErrorException((operation == NULL),"splitting received UDP data, overlapped object does not belong to this socket",0,__LINE__,__FILE__);
+
+	size_t amount = operation->Received(completionBytes);
+
+	recvCallCount.Increase(1);
+	recvPacketCount.Increase(static_cast<int>(amount));
+
+	return amount;
+}
+
+/**
+ * @brief Retrieves the datagrams received by the specified receive operation.
+ *
+ * @param overlapped Overlapped object of the receive operation, IsOurOverlapped() must be true for it.
+ *
+ * @return array of datagrams, the number of elements is the value returned by Received().
+ * @throws ErrorReport If @a overlapped does not belong to this socket.
+ */
+const WSABUF * NetSocketUDP::GetRecvDatagrams(const WSAOVERLAPPED * overlapped) const
+{
+	NetRecvUDP * operation = FindRecvOperation(overlapped);
+	_ErrorException((operation == NULL),"retrieving UDP datagrams, overlapped object does not belong to this socket",0,__LINE__,__FILE__);
+	return operation->GetDatagrams();
+}
+
+/**
+ * @brief Determines where a datagram received by the specified receive operation came from.
+ *
+ * @param overlapped Overlapped object of the receive operation, IsOurOverlapped() must be true for it.
+ * @param datagram Index of datagram, must be less than the value returned by Received().
+ *
+ * @return the remote address that the datagram was sent from.
+ * @throws ErrorReport If @a overlapped does not belong to this socket.
+ */
+const NetAddress & NetSocketUDP::GetRecvAddress(const WSAOVERLAPPED * overlapped, size_t datagram) const
+{
+	NetRecvUDP * operation = FindRecvOperation(overlapped);
+	_ErrorException((operation == NULL),"retrieving a UDP receive address, overlapped object does not belong to this socket",0,__LINE__,__FILE__);
+	return operation->GetDatagramAddress(datagram);
+}
+
+/**
+ * @brief Retrieves the number of receive operations that have completed.
+ *
+ * @return the number of completed receive operations, each is one system call.
+ */
+size_t NetSocketUDP::GetRecvCallCount() const
+{
+	return recvCallCount.Get();
+}
+
+/**
+ * @brief Retrieves the number of datagrams received by all completed receive operations.
+ *
+ * @return the number of datagrams received.
+ */
+size_t NetSocketUDP::GetRecvPacketCount() const
+{
+	return recvPacketCount.Get();
+}
+
+/**
+ * @brief Retrieves the average number of datagrams received by each receive operation.
+ *
+ * Values greater than 1 show that batching or coalescing is reducing the number of system calls.
+ *
+ * @return the average number of datagrams received per receive operation, 0 if none have completed.
+ */
+double NetSocketUDP::GetRecvPacketsPerCall() const
+{
+	size_t calls = GetRecvCallCount();
+	if(calls == 0)
+	{
+		return 0.0;
+	}
+	return static_cast<double>(GetRecvPacketCount()) / static_cast<double>(calls);
 }
 
 
@@ -348,15 +733,45 @@ void NetSocketUDP::DealWithData(const WSABUF & buffer, size_t completionBytes, N
 {
 	ValidateModeLoaded(__LINE__,__FILE__);
 
-	try
+	// The completion port signals that the receive operation is finished
+	// via SetCompletionPortFinishRecvNotification.
+	modeUDP.Get()->DealWithData(buffer,completionBytes,recvFunc,clientID,instanceID);
+}
+
+/**
+ * @brief Deals with several newly received datagrams using the socket's UDP mode.
+ *
+ * @param buffers Array of datagrams, the length of each datagram is the length of its WSABUF.
+ * @param clientIDs Array of @a amount client IDs, one for each datagram. If NULL @a clientID applies to all datagrams.
+ * @param amount Number of elements in @a buffers.
+ * @param [in] recvFunc Method will be executed and data not added to the queue if this is non NULL.
+ * @param clientID ID of client that data was received from, set to 0 if not applicable.
+ * @param instanceID Instance that data was received on.
+ */
+void NetSocketUDP::DealWithDataBatch(const WSABUF * buffers, const size_t * clientIDs, size_t amount, NetSocket::RecvFunc recvFunc, size_t clientID, size_t instanceID)
+{
+	ValidateModeLoaded(__LINE__,__FILE__);
+	modeUDP.Get()->DealWithDataBatch(buffers,clientIDs,amount,recvFunc,clientID,instanceID);
+}
+
+/**
+ * @brief Deals with the data received by a completed receive operation.
+ *
+ * The data is split into datagrams which are passed to the UDP mode together.
+ *
+ * @param overlapped Overlapped object of the receive operation.
+ * @param completionBytes Number of bytes reported by the completion port.
+ * @param [in] recvFunc Method will be executed and data not added to the queue if this is non NULL.
+ * @param clientID ID of client that data was received from, set to 0 if not applicable.
+ * @param instanceID Instance that data was received on.
+ */
+void NetSocketUDP::DealWithCompletion(const WSAOVERLAPPED * overlapped, DWORD completionBytes, NetSocket::RecvFunc recvFunc, size_t clientID, size_t instanceID)
+{
+	size_t amount = Received(overlapped,completionBytes);
+	if(amount > 0)
 	{
-		modeUDP.Get()->DealWithData(buffer,completionBytes,recvFunc,clientID,instanceID);
+		DealWithDataBatch(GetRecvDatagrams(overlapped),NULL,amount,recvFunc,clientID,instanceID);
 	}
-	// Indicate that we are no longer dealing with data in the event of an error
-	catch(ErrorReport & error){	notDealingWithData.Set(true); throw error;}
-	catch(...){ notDealingWithData.Set(true); throw -1; }
-
-	notDealingWithData.Set(true);
 }
 
 /**
@@ -403,6 +818,187 @@ size_t NetSocketUDP::GetRecvMemorySize(size_t clientID) const
 }
 
 
+/** @brief Time in milliseconds after which a benchmark packet that has not been received is counted as lost. */
+static const DWORD NetSocketUDPBenchmarkLossTimeout = 100;
+
+/** @brief Number of packets received by NetSocketUDPBenchmarkRecvFunc. */
+static ConcurrentObject<size_t> NetSocketUDPBenchmarkReceived(static_cast<size_t>(0));
+
+/**
+ * @brief Receive function used by NetSocketUDPBenchmark, counts received packets.
+ *
+ * @param packet Received packet.
+ */
+static void NetSocketUDPBenchmarkRecvFunc(Packet & packet)
+{
+	NetSocketUDPBenchmarkReceived.Increase(1);
+}
+
+/**
+ * @brief Measures loopback throughput and latency with the specified number of completion port threads
+ * and receive operations.
+ *
+ * Throughput is measured by keeping a window of packets in flight, and latency
+ * by sending one packet at a time and waiting for it to be received. Packets that are
+ * not received within NetSocketUDPBenchmarkLossTimeout milliseconds are counted as lost,
+ * so that a dropped datagram does not stall the benchmark.
+ *
+ * @param numThreads Number of completion port worker threads.
+ * @param recvDepth Number of receive operations that the receiving socket can have in progress at the same time.
+ * @param recvBatch Maximum number of datagrams received by each receive operation (optional, default 1).
+ */
+static void NetSocketUDPBenchmark(size_t numThreads, size_t recvDepth, size_t recvBatch = 1)
+{
+	const size_t numPackets = 100000;
+	const size_t window = 64;
+	const size_t numPings = 2000;
+
+	NetUtility::SetupCompletionPort(numThreads);
+	NetUtility::StartWinsock();
+	{
+		const char * localHost = NetUtility::ConvertDomainNameToIP("localhost").GetIP();
+		NetSocketUDP sender(1024,NetAddress(localHost,0),false,new NetModeUdpCatchAll(1));
+		NetSocketUDP receiver(1024,NetAddress(localHost,0),false,new NetModeUdpCatchAll(1),&NetSocketUDPBenchmarkRecvFunc,recvDepth,recvBatch);
+		sender.Connect(receiver.GetLocalAddress());
+		receiver.Connect(sender.GetLocalAddress());
+		receiver.Recv();
+
+		Packet packet;
+		packet.SetMemorySize(64);
+		packet.SetUsedSize(64);
+
+		// Throughput
+		NetSocketUDPBenchmarkReceived.Set(0);
+		size_t lost = 0;
+		DWORD startTime = GetTickCount();
+		for(size_t n = 0;n<numPackets;n++)
+		{
+			DWORD waitTime = GetTickCount();
+			while(n - NetSocketUDPBenchmarkReceived.Get() - lost > window)
+			{
+				if(GetTickCount() - waitTime > NetSocketUDPBenchmarkLossTimeout)
+				{
+					lost = n - NetSocketUDPBenchmarkReceived.Get();
+				}
+			}
+			sender.Send(packet,false,NULL,INFINITE);
+		}
+		DWORD waitTime = GetTickCount();
+		while(NetSocketUDPBenchmarkReceived.Get() < numPackets && GetTickCount() - waitTime < NetSocketUDPBenchmarkLossTimeout);
+		DWORD throughputTime = GetTickCount() - startTime;
+		size_t received = NetSocketUDPBenchmarkReceived.Get();
+
+		// Latency
+		NetSocketUDPBenchmarkReceived.Set(0);
+		size_t pingsLost = 0;
+		startTime = GetTickCount();
+		for(size_t n = 0;n<numPings;n++)
+		{
+			sender.Send(packet,false,NULL,INFINITE);
+
+			waitTime = GetTickCount();
+			while(NetSocketUDPBenchmarkReceived.Get() + pingsLost <= n)
+			{
+				if(GetTickCount() - waitTime > NetSocketUDPBenchmarkLossTimeout)
+				{
+					pingsLost++;
+				}
+			}
+		}
+		DWORD latencyTime = GetTickCount() - startTime - (pingsLost * NetSocketUDPBenchmarkLossTimeout);
+
+		cout << " Threads: " << numThreads << ", receive depth: " << recvDepth << ", receive batch: " << receiver.GetRecvBatch();
+		cout << ", received " << received << " of " << numPackets << " in " << throughputTime << "ms";
+		cout << ", packets per receive call: " << receiver.GetRecvPacketsPerCall();
+		if(throughputTime > 0)
+		{
+			cout << " (" << (received * 1000) / throughputTime << " packets per second)";
+		}
+		cout << ", average latency: " << (latencyTime * 1000) / numPings << " microseconds\n";
+	}
+	NetUtility::FinishWinsock();
+	NetUtility::DestroyCompletionPort();
+}
+
+/**
+ * @brief Measures the time taken to send a packet to many destinations using one Send() per destination,
+ * and using SendBatch().
+ *
+ * @param numDestinations Number of destinations that each packet is sent to.
+ */
+static void NetSocketUDPSendBatchBenchmark(size_t numDestinations)
+{
+	const size_t numTicks = 200;
+	const size_t numReceivers = 8;
+
+	NetUtility::SetupCompletionPort(2);
+	NetUtility::StartWinsock();
+	{
+		const char * localHost = NetUtility::ConvertDomainNameToIP("localhost").GetIP();
+		NetSocketUDP sender(1024,NetAddress(localHost,0),false,new NetModeUdpCatchAllNo(1));
+
+		// Receivers never receive, the kernel discards packets once their receive buffers are full
+		NetSocketUDP * receivers[numReceivers];
+		for(size_t n = 0;n<numReceivers;n++)
+		{
+			receivers[n] = new NetSocketUDP(1024,NetAddress(localHost,0),false,new NetModeUdpCatchAll(1));
+		}
+
+		vector<size_t> clientIDs(numDestinations,0);
+		vector<const NetAddress*> addresses(numDestinations);
+		for(size_t n = 0;n<numDestinations;n++)
+		{
+			addresses[n] = &receivers[n % numReceivers]->GetLocalAddress();
+		}
+
+		Packet packet;
+		packet.SetMemorySize(64);
+		packet.SetUsedSize(64);
+
+		// One send operation per destination
+		DWORD startTime = GetTickCount();
+		for(size_t tick = 0;tick<numTicks;tick++)
+		{
+			for(size_t n = 0;n<numDestinations;n++)
+			{
+				sender.Send(packet,false,addresses[n],INFINITE);
+			}
+		}
+		DWORD loopTime = GetTickCount() - startTime;
+
+		// Wait for send operations to complete
+		while(sender.GetSendMemorySize() > 0 && GetTickCount() - startTime < 10000)
+		{
+			Sleep(1);
+		}
+
+		// Batched
+		size_t batched = 0;
+		startTime = GetTickCount();
+		for(size_t tick = 0;tick<numTicks;tick++)
+		{
+			size_t sent = sender.SendBatch(packet,&clientIDs[0],&addresses[0],numDestinations);
+			for(size_t n = sent;n<numDestinations;n++)
+			{
+				sender.Send(packet,false,addresses[n],INFINITE);
+			}
+			batched += sent;
+		}
+		DWORD batchTime = GetTickCount() - startTime;
+
+		cout << " Destinations: " << numDestinations << ", ticks: " << numTicks;
+		cout << ", per destination loop: " << loopTime << "ms";
+		cout << ", batched: " << batchTime << "ms (" << batched << " of " << numDestinations * numTicks << " sent by batch)\n";
+
+		for(size_t n = 0;n<numReceivers;n++)
+		{
+			delete receivers[n];
+		}
+	}
+	NetUtility::FinishWinsock();
+	NetUtility::DestroyCompletionPort();
+}
+
 /**
  * @brief Tests class.
  *
@@ -482,6 +1078,12 @@ bool NetSocketUDP::TestClass()
 		}
 
 		// After packet is sent, memory size should decrease.
+		// The send may complete after the packet is received.
+		DWORD sendWaitTime = GetTickCount();
+		while(client1.GetSendMemorySize() != 0 && GetTickCount() - sendWaitTime < 1000)
+		{
+			Sleep(10);
+		}
 		if(client1.GetSendMemorySize() != 0)
 		{
 			cout << " GetSendMemorySize is bad\n";
@@ -523,10 +1125,73 @@ bool NetSocketUDP::TestClass()
 		{
 			cout << " Packet received is good!\n";
 		}
+
+		// Sending data 1 to 2 several times with one batch
+		cout << "Sending batch from client1 to client2..\n";
+		sendPacket = "hello batch";
+		const size_t batchAmount = 3;
+		size_t batchClientIDs[batchAmount] = {0,0,0};
+		const NetAddress * batchAddrs[batchAmount] = {&client2.GetLocalAddress(),&client2.GetLocalAddress(),&client2.GetLocalAddress()};
+		size_t batchSent = client1.SendBatch(sendPacket,batchClientIDs,batchAddrs,batchAmount);
+		for(size_t n = batchSent;n<batchAmount;n++)
+		{
+			client1.Send(sendPacket,false,NULL,INFINITE);
+		}
+		cout << " " << batchSent << " of " << batchAmount << " sent by batch\n";
+
+		cout << "Waiting for data to be received by client2..\n";
+		bool batchGood = true;
+		DWORD batchStartTime = GetTickCount();
+		for(size_t n = 0;n<batchAmount;n++)
+		{
+			while(client2.GetPacketFromStore(&receivedPacket,0,0) == 0 && GetTickCount() - batchStartTime < 5000)
+			{
+				Sleep(10);
+			}
+			batchGood = batchGood && (receivedPacket == "hello batch");
+			receivedPacket.Clear();
+		}
+
+		if(batchGood == false)
+		{
+			cout << " SendBatch is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << " SendBatch is good\n";
+		}
 	}
 	NetUtility::FinishWinsock();
 	NetUtility::DestroyCompletionPort();
 
+	cout << "Benchmarking loopback throughput and latency..\n";
+	size_t threadCounts[] = {1,2,4,8};
+	for(size_t n = 0;n<sizeof(threadCounts)/sizeof(threadCounts[0]);n++)
+	{
+		NetSocketUDPBenchmark(threadCounts[n],1);
+	}
+
+	cout << "Benchmarking loopback throughput and latency with multiple outstanding receive operations..\n";
+	size_t recvDepths[] = {1,2,4,8,16};
+	for(size_t n = 0;n<sizeof(recvDepths)/sizeof(recvDepths[0]);n++)
+	{
+		NetSocketUDPBenchmark(4,recvDepths[n]);
+	}
+
+	cout << "Benchmarking loopback throughput and latency with batched receive operations..\n";
+	size_t recvBatches[] = {1,8,64};
+	for(size_t n = 0;n<sizeof(recvBatches)/sizeof(recvBatches[0]);n++)
+	{
+		NetSocketUDPBenchmark(4,1,recvBatches[n]);
+	}
+
+	cout << "Benchmarking sending to many destinations..\n";
+	size_t numDestinations[] = {10,100,500};
+	for(size_t n = 0;n<sizeof(numDestinations)/sizeof(numDestinations[0]);n++)
+	{
+		NetSocketUDPSendBatchBenchmark(numDestinations[n]);
+	}
 
 	cout << "\n\n";
 	return !problem;
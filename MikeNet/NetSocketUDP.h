@@ -12,9 +12,23 @@
 class NetSocketUDP: public NetSocket
 {
 	/**
-	 * @brief Filled with address that the last received packet has come from.
+	 * @brief Receive operations, each can be in progress at the same time.
+	 *
+	 * The number of operations is fixed when the socket is constructed.
+	 * NetSocket::recvBuffer and NetSocket::recvOverlapped are not used.
 	 */
-	NetAddress recvAddr;
+	vector<NetRecvUDP*> recvOperations;
+
+	/**
+	 * @brief Prevents multiple threads from starting the same receive operation.
+	 */
+	CriticalSection recvLock;
+
+	/** @brief Number of receive operations that have completed successfully, see GetRecvPacketsPerCall(). */
+	ConcurrentObject<size_t> recvCallCount;
+
+	/** @brief Number of datagrams received by all completed receive operations, see GetRecvPacketsPerCall(). */
+	ConcurrentObject<size_t> recvPacketCount;
 
 	/**
 	 * @brief Describes how received data should be dealt with and how sent data should be modified.
@@ -25,22 +39,33 @@ class NetSocketUDP: public NetSocket
 	ConcurrentObject<NetModeUdp*> modeUDP;
 
 public:
-	NetSocketUDP(size_t bufferLength, const NetAddress & localAddr, bool reusable, NetModeUdp * udpMode, NetSocket::RecvFunc recvFunc = NULL);
-	NetSocketUDP(size_t bufferLength, const NetAddress & localAddr, NetSocket::RecvFunc recvFunc = NULL);
+	NetSocketUDP(size_t bufferLength, const NetAddress & localAddr, bool reusable, NetModeUdp * udpMode, NetSocket::RecvFunc recvFunc = NULL, size_t recvDepth = 1, size_t recvBatch = 1, bool recvCoalescing = false);
+	NetSocketUDP(size_t bufferLength, const NetAddress & localAddr, NetSocket::RecvFunc recvFunc = NULL, size_t recvDepth = 1, size_t recvBatch = 1, bool recvCoalescing = false);
 	~NetSocketUDP();
 
 private:
 	void ValidateModeLoaded(size_t line, const char * file) const;
+	void EnableRecvCoalescing(bool recvCoalescing);
+	void AllocateRecvOperations(size_t bufferLength, size_t recvDepth, size_t recvBatch, bool recvCoalescing);
+	void DeallocateRecvOperations();
 	void Copy(const NetSocketUDP & copyMe);
+	NetRecvUDP * FindRecvOperation(const WSAOVERLAPPED * overlapped) const;
 public:
 	NetSocketUDP(const NetSocketUDP &);
 	NetSocketUDP & operator= (const NetSocketUDP &);
 
-	void ClearRecv();
 	bool Recv();
+	size_t GetRecvDepth() const;
+	size_t GetRecvBatch() const;
+	bool IsRecvCoalescing() const;
+	size_t GetRecvBufferLength() const;
+	bool IsOurOverlapped(const WSAOVERLAPPED * overlapped) const;
+	const WSABUF & GetRecvBuffer(const WSAOVERLAPPED * overlapped) const;
+	void SetCompletionPortFinishRecvNotification(const WSAOVERLAPPED * overlapped);
 
 	NetUtility::SendStatus Send(const Packet & packet, bool block, const NetAddress * sendToAddr, unsigned int timeout);
 	NetUtility::SendStatus RawSend(const Packet & packet, bool block, const NetAddress * sendToAddr, unsigned int timeout);
+	size_t SendBatch(const Packet & packet, const size_t * clientIDs, const NetAddress * const * sendToAddrs, size_t amount);
 
 	virtual void Close();
 	void Reset(size_t clientID);
@@ -54,9 +79,17 @@ public:
 
 	NetSocket::Protocol GetProtocol() const;
 
-	const NetAddress & GetRecvAddress() const;
+	size_t Received(const WSAOVERLAPPED * overlapped, DWORD completionBytes);
+	const WSABUF * GetRecvDatagrams(const WSAOVERLAPPED * overlapped) const;
+	const NetAddress & GetRecvAddress(const WSAOVERLAPPED * overlapped, size_t datagram) const;
+
+	size_t GetRecvCallCount() const;
+	size_t GetRecvPacketCount() const;
+	double GetRecvPacketsPerCall() const;
 
 	void DealWithData(const WSABUF & buffer, size_t completionBytes, NetSocket::RecvFunc recvFunc, size_t clientID, size_t instanceID);
+	void DealWithDataBatch(const WSABUF * buffers, const size_t * clientIDs, size_t amount, NetSocket::RecvFunc recvFunc, size_t clientID, size_t instanceID);
+	void DealWithCompletion(const WSAOVERLAPPED * overlapped, DWORD completionBytes, NetSocket::RecvFunc recvFunc, size_t clientID, size_t instanceID);
 
 	void SetRecvMemoryLimit(size_t newLimit, size_t clientID);
 	size_t GetRecvMemoryLimit(size_t clientID) const;
@@ -250,7 +250,7 @@ void NetUtility::LoadLocalInfo()
 	{
 		sockaddr_in loadMe;
 		loadMe.sin_family = AF_INET;
-		loadMe.sin_addr = *reinterpret_cast<IN_ADDR*>(phe->h_addr_list[n]);
+		loadMe.sin_addr = *reinterpret_cast<in_addr*>(phe->h_addr_list[n]);
 		loadMe.sin_port = 0;
 		localInterface[n].Load(loadMe);
 	}
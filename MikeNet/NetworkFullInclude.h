@@ -9,6 +9,7 @@ class NetInstanceBroadcast;
 #include "LibInclude.h"
 
 #include "NetAddress.h"
+#include "NetAddressMap.h"
 #include "NetUtility.h"
 #include "NetCompletionPortFunction.h"
 
@@ -1,4 +1,7 @@
 #include "FullInclude.h"
+#include <algorithm>
+
+volatile size_t Packet::encryptionInlineThreshold = 0;
 
 /**
  * @brief Changes Packet::data to point to an alternative point in memory that is not managed by the object.
@@ -23,7 +26,10 @@ void Packet::SetDataPtr(char * newPtr, size_t paraMemSize, size_t paraUsedSize)
 		_ErrorException((paraUsedSize > paraMemSize),"changing a packet's data pointer, used size cannot be more than memory size",0,__LINE__,__FILE__);
 
 		// Cleanup old memory
-		delete[] data;
+		if(dataPtrChanged == false)
+		{
+			DeallocateData();
+		}
 
 		// Set data and related variables
 		dataPtrChanged = true; // data will not be cleaned up
@@ -63,6 +69,202 @@ void Packet::UnsetDataPtr()
 	Leave();
 }
 
+/**
+ * @brief Determines whether SetDataPtr() has been used, so that this object does not own its memory.
+ *
+ * @return Packet::dataPtrChanged.
+ */
+bool Packet::IsDataPtrChanged() const
+{
+	Enter();
+	bool returnMe = dataPtrChanged;
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Enters the critical sections of two packets in a fixed order.
+ *
+ * Packets are entered in order of address, so that two threads locking the same pair
+ * of packets in opposite directions (e.g. a.Swap(b) and b.Swap(a)) cannot deadlock.
+ * Use LeavePair() to release them.
+ *
+ * @param first Packet to enter, may be the same object as @a second.
+ * @param second Packet to enter.
+ */
+void Packet::EnterPair(const Packet & first, const Packet & second)
+{
+	if(&first == &second)
+	{
+		first.Enter();
+	}
+	else if(std::less<const Packet*>()(&first,&second))
+	{
+		first.Enter();
+		second.Enter();
+	}
+	else
+	{
+		second.Enter();
+		first.Enter();
+	}
+}
+
+/**
+ * @brief Leaves the critical sections of two packets entered using EnterPair(), in reverse order.
+ *
+ * @param first Packet to leave, may be the same object as @a second.
+ * @param second Packet to leave.
+ */
+void Packet::LeavePair(const Packet & first, const Packet & second)
+{
+	if(&first == &second)
+	{
+		first.Leave();
+	}
+	else if(std::less<const Packet*>()(&first,&second))
+	{
+		second.Leave();
+		first.Leave();
+	}
+	else
+	{
+		first.Leave();
+		second.Leave();
+	}
+}
+
+/**
+ * @brief Exchanges the contents of this packet with another, without copying data.
+ *
+ * Memory, used size, cursor and packet information are all exchanged.
+ *
+ * @exception ErrorReport If either packet uses SetDataPtr(), because memory
+ * that is not owned must not change owner.
+ *
+ * @param [in,out] other Packet to exchange contents with.
+ */
+void Packet::Swap(Packet & other)
+{
+	if(&other == this)
+	{
+		return;
+	}
+
+	EnterPair(*this,other);
+
+	try
+	{
+		_ErrorException((dataPtrChanged == true || other.dataPtrChanged == true),"swapping the contents of two packets, neither packet may use SetDataPtr",0,__LINE__,__FILE__);
+
+		std::swap(data,other.data);
+		std::swap(memSize,other.memSize);
+		std::swap(usedSize,other.usedSize);
+		std::swap(cursorPos,other.cursorPos);
+		std::swap(clientFrom,other.clientFrom);
+		std::swap(operation,other.operation);
+		std::swap(instance,other.instance);
+		std::swap(age,other.age);
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & Error){LeavePair(*this,other); throw(Error);}
+	catch(...){LeavePair(*this,other); throw(-1);}
+
+	LeavePair(*this,other);
+}
+
+/**
+ * @brief Takes the contents of another packet without copying data.
+ *
+ * This packet's memory is deallocated and replaced with @a source's memory.
+ * Used size, cursor and packet information are also taken. @a source is left
+ * empty with no memory.\n\n
+ *
+ * If @a source uses SetDataPtr() its data is copied instead, because memory
+ * that is not owned must not change owner, and @a source is not changed.
+ *
+ * @param [in,out] source Packet to take contents from.
+ */
+void Packet::TakeBuffer(Packet & source)
+{
+	if(&source == this)
+	{
+		return;
+	}
+
+	EnterPair(*this,source);
+
+	try
+	{
+		if(source.dataPtrChanged == true)
+		{
+			// Memory pointed to by a view of other memory is never deallocated
+			if(dataPtrChanged == true)
+			{
+				dataPtrChanged = false;
+				data = NULL;
+				memSize = 0;
+			}
+
+			Copy(source);
+		}
+		else
+		{
+			if(dataPtrChanged == false)
+			{
+				DeallocateData();
+			}
+
+			dataPtrChanged = false;
+			data = source.data;
+			memSize = source.memSize;
+			usedSize = source.usedSize;
+			cursorPos = source.cursorPos;
+			clientFrom = source.clientFrom;
+			operation = source.operation;
+			instance = source.instance;
+			age = source.age;
+
+			source.DefaultVariables(true);
+		}
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & Error){LeavePair(*this,source); throw(Error);}
+	catch(...){LeavePair(*this,source); throw(-1);}
+
+	LeavePair(*this,source);
+}
+
+/**
+ * @brief Move constructor, takes @a moveMe's memory instead of copying it.
+ *
+ * See TakeBuffer().
+ *
+ * @param [in,out] moveMe Object to move, left empty with no memory.
+ */
+Packet::Packet(Packet && moveMe)
+{
+	slab = NULL;
+	DefaultVariables(true);
+	TakeBuffer(moveMe);
+}
+
+/**
+ * @brief Move assignment operator, takes @a moveMe's memory instead of copying it.
+ *
+ * See TakeBuffer().
+ *
+ * @param [in,out] moveMe Object to move, left empty with no memory.
+ *
+ * @return reference to this object.
+ */
+Packet & Packet::operator= (Packet && moveMe)
+{
+	TakeBuffer(moveMe);
+	return(*this);
+}
+
 /**
  * @brief Decrypts WSABUF.
  *
@@ -113,6 +315,7 @@ void Packet::DefaultVariables(bool paraFull)
  */
 Packet::Packet()
 {
+	slab = NULL;
 	DefaultVariables(true);
 }
 
@@ -128,10 +331,11 @@ Packet::~Packet()
 
 		if(dataPtrChanged == false)
 		{
-			delete[] data;
+			DeallocateData();
 		}
 
 		DefaultVariables(true);
+		SetSlab(NULL);
 	}
 	MSG_CATCH
 }
@@ -148,8 +352,7 @@ Packet::~Packet()
  */
 void Packet::Copy(const Packet & copyMe)
 {
-	copyMe.Enter();
-	this->Enter();
+	EnterPair(*this,copyMe);
 	
 	try
 	{
@@ -173,11 +376,10 @@ void Packet::Copy(const Packet & copyMe)
 		usedSize = copyMe.usedSize;
 	}
 	// Release control of all objects before throwing final exception
-	catch(ErrorReport & Error){this->Leave(); copyMe.Leave(); throw(Error);}
-	catch(...){this->Leave(); copyMe.Leave(); throw(-1);}
+	catch(ErrorReport & Error){LeavePair(*this,copyMe); throw(Error);}
+	catch(...){LeavePair(*this,copyMe); throw(-1);}
 
-	this->Leave();
-	copyMe.Leave();
+	LeavePair(*this,copyMe);
 }
 
 /**
@@ -187,6 +389,7 @@ void Packet::Copy(const Packet & copyMe)
  */
 Packet::Packet(const Packet & copyMe)
 {
+	slab = NULL;
 	// Set to default, so that Copy works properly
 	DefaultVariables(true);
 
@@ -260,6 +463,7 @@ void Packet::Copy(const char * copyMe)
  */
 Packet::Packet(const char * copyMe)
 {
+	slab = NULL;
 	// Set to default, so that Copy works properly
 	DefaultVariables(true);
 
@@ -283,6 +487,7 @@ Packet & Packet::operator=(const char * copyMe)
 	return *this;
 }
 
+#ifdef _WIN32
 /**
  * @brief Copy constructor / assignment operator helper function.
  *
@@ -307,6 +512,7 @@ void Packet::Copy(const ComString & copyMe)
  */
 Packet::Packet(const ComString & copyMe)
 {
+	slab = NULL;
 	DefaultVariables(true);
 	Copy(copyMe);
 }
@@ -323,6 +529,7 @@ Packet & Packet::operator= (const ComString & copyMe)
 	Copy(copyMe);
 	return *this;
 }
+#endif
 
 /**
  * @brief WSABUF assignment operator.
@@ -378,8 +585,7 @@ bool Packet::operator==(const Packet & param) const
 {
 	bool returnMe = false;
 
-	param.Enter();
-	this->Enter();
+	EnterPair(*this,param);
 
 	try
 	{
@@ -410,11 +616,10 @@ bool Packet::operator==(const Packet & param) const
 		}
 	}
 	// Release control of all objects before throwing final exception
-	catch(ErrorReport & Error){this->Leave(); param.Leave(); throw(Error);}
-	catch(...){this->Leave(); param.Leave(); throw(-1);}
+	catch(ErrorReport & Error){LeavePair(*this,param); throw(Error);}
+	catch(...){LeavePair(*this,param); throw(-1);}
 
-	this->Leave();
-	param.Leave();
+	LeavePair(*this,param);
 
 	return returnMe;
 }
@@ -560,8 +765,7 @@ bool Packet::compareWSABUF (const WSABUF & copyMe, size_t used)
  */
 void Packet::_AddPacket(Packet & destination, const Packet & source)
 {
-	destination.Enter();
-	source.Enter();
+	EnterPair(destination,source);
 
 	try
 	{
@@ -570,11 +774,10 @@ void Packet::_AddPacket(Packet & destination, const Packet & source)
 		memcpy(destination.data + originalCursor, source.data, source.GetUsedSize());
 	}
 	// Release control of all objects before throwing final exception
-	catch(ErrorReport & Error){source.Leave(); destination.Leave();	throw(Error);}
-	catch(...){source.Leave(); destination.Leave(); throw(-1);}
+	catch(ErrorReport & Error){LeavePair(destination,source); throw(Error);}
+	catch(...){LeavePair(destination,source); throw(-1);}
 
-	source.Leave();
-	destination.Leave();
+	LeavePair(destination,source);
 
 }
 
@@ -633,10 +836,7 @@ void Packet::_AddWSABUF(Packet & destination, const WSABUF & source, size_t used
 	{
 		// Allocate more memory if necessary
 		size_t newSize = destination.usedSize + used;
-		if(newSize > destination.memSize)
-		{
-			destination.ChangeMemorySize(newSize);
-		}
+		destination._GrowMemory(newSize);
 
 		// Copy Source
 		memcpy(destination.data + destination.usedSize, source.buf, used);
@@ -706,17 +906,40 @@ void Packet::Clear()
  * @param	key			The key to use.
  * @param block If true the method will not return until the encryption operation has finished, if false
  * it will return straight away and Packet::IsLastEncryptionOperationFinished and Packet::WaitUntilLastEncryptionOperationFinished
- * can be used to determine when it is completed.
+ * can be used to determine when it is completed. Packets smaller than GetEncryptionInlineThreshold()
+ * are always ciphered before returning.
  */
 void Packet::DoEncryptionOperation(bool encryption, const EncryptKey & key, bool block)
 {
+	// Small packets are ciphered on this thread, because posting a message
+	// to each thread costs more than ciphering the packet
+	if(usedSize < GetEncryptionInlineThreshold())
+	{
+		// Data may still be in use by a previous non blocking operation
+		WaitUntilLastEncryptionOperationFinished();
+
+		ThreadMessageItemEncrypt::Cipher(encryption,reinterpret_cast<unsigned char*>(data),usedSize / ThreadMessageItemEncrypt::ENCRYPTION_CHUNK_SIZE,key);
+		return;
+	}
+
 	// Setup threads (if necessary) and post message to each thread.
 	// Each thread will encrypt a part of the packet.
 	SetupThreadsLocal(ThreadSingleMessageKeepLastUser::CLASS_INDEX_PACKET,ThreadSingle::GetNumLogicalCores(),&EncryptionThread,NULL);
 	for(size_t n = 0;n<GetNumThreads();n++)
 	{
-		ThreadMessageItem * encryptionMessage = new (nothrow) ThreadMessageItemEncrypt(encryption,this,key,n,GetNumThreads());
-		Utility::DynamicAllocCheck(encryptionMessage,__LINE__,__FILE__);
+		// Messages are reused once threads have finished with them, so only the first operation allocates them
+		ThreadMessageItemEncrypt * encryptionMessage = static_cast<ThreadMessageItemEncrypt*>(GetLastMessageItem(n));
+		if(encryptionMessage == NULL)
+		{
+			encryptionMessage = new (nothrow) ThreadMessageItemEncrypt(encryption,this,key,n,GetNumThreads());
+			Utility::DynamicAllocCheck(encryptionMessage,__LINE__,__FILE__);
+		}
+		else
+		{
+			encryptionMessage->WaitUntilNotInUseByThread();
+			encryptionMessage->Reinitialize(encryption,this,key,n,GetNumThreads());
+		}
+
 		PostMessageItem(n,encryptionMessage);
 	}
 
@@ -738,7 +961,8 @@ void Packet::DoEncryptionOperation(bool encryption, const EncryptKey & key, bool
  * @param key Key to use when decrypting, must be the same as the key used for encrypting for decryption to work.
  * @param block If true the method will not return until the encryption operation has finished, if false
  * it will return straight away and Packet::IsLastEncryptionOperationFinished and Packet::WaitUntilLastEncryptionOperationFinished
- * can be used to determine when it is completed.
+ * can be used to determine when it is completed. Packets smaller than GetEncryptionInlineThreshold()
+ * are always ciphered before returning.
  */
 void Packet::Decrypt( const EncryptKey & key, bool block )
 {
@@ -771,7 +995,8 @@ void Packet::Decrypt( const EncryptKey & key, bool block )
  * @param key Key to use when encrypting, must be the same as the key used for decrypting for decryption to work.
  * @param block If true the method will not return until the encryption operation has finished, if false
  * it will return straight away and Packet::IsLastEncryptionOperationFinished and Packet::WaitUntilLastEncryptionOperationFinished
- * can be used to determine when it is completed.
+ * can be used to determine when it is completed. Packets smaller than GetEncryptionInlineThreshold()
+ * are always ciphered before returning.
  */
 void Packet::Encrypt( const EncryptKey & key, bool block )
 {
@@ -817,6 +1042,102 @@ void Packet::Encrypt( const EncryptKey & key, bool block )
 	Leave();
 }
 
+/**
+ * @brief Retrieves the amount of memory that is allocated when at least @a size bytes are needed.
+ *
+ * @param size Minimum number of bytes.
+ *
+ * @return @a size rounded up to the size class of Packet::slab, or @a size if there is no slab.
+ */
+size_t Packet::GetAllocationSize(size_t size) const
+{
+	if(slab == NULL)
+	{
+		return size;
+	}
+	return MemoryRecycleSlab::GetBlockSize(size);
+}
+
+/**
+ * @brief Allocates memory for Packet::data, from Packet::slab if there is one.
+ *
+ * @param size Number of bytes to allocate, must be a value returned by GetAllocationSize().
+ *
+ * @return the allocated memory, which must be deallocated using DeallocateData().
+ */
+char * Packet::AllocateData(size_t size)
+{
+	if(slab != NULL)
+	{
+		return slab->Allocate(size);
+	}
+
+	char * returnMe = new (nothrow) char[size];
+	Utility::DynamicAllocCheck(returnMe,__LINE__,__FILE__);
+	return returnMe;
+}
+
+/**
+ * @brief Deallocates Packet::data, returning it to Packet::slab if there is one.
+ *
+ * Packet::data is set to NULL, Packet::memSize is not changed. Must not be used if the data pointer has been changed using SetDataPtr().
+ */
+void Packet::DeallocateData()
+{
+	if(slab != NULL)
+	{
+		slab->Deallocate(data,memSize);
+	}
+	else
+	{
+		delete[] data;
+	}
+	data = NULL;
+}
+
+/**
+ * @brief Changes the slab that memory is allocated from.
+ *
+ * Memory that is already allocated is not changed, when deallocated it is given to the new slab.
+ * Memory allocated by a slab can be deallocated using delete[], so memory can still change owner
+ * e.g. using Swap() or MoveIntoWSABUF(). The slab is not changed by Swap(), TakeBuffer() or copying.\n\n
+ *
+ * Packets using a slab have a memory size that is rounded up to the slab's size class.
+ *
+ * @param [in] newSlab Slab to use, a reference is added which is released when the slab is changed or this object is destroyed.
+ * If NULL, memory is allocated using new[].
+ */
+void Packet::SetSlab(MemoryRecycleSlab * newSlab)
+{
+	Enter();
+
+	if(newSlab != NULL)
+	{
+		newSlab->AddReference();
+	}
+	if(slab != NULL)
+	{
+		slab->Release();
+	}
+	slab = newSlab;
+
+	Leave();
+}
+
+/**
+ * @brief Retrieves the slab that memory is allocated from.
+ *
+ * @return Packet::slab, NULL if memory is allocated using new[].
+ */
+MemoryRecycleSlab * Packet::GetSlab() const
+{
+	Enter();
+	MemoryRecycleSlab * returnMe = slab;
+	Leave();
+
+	return returnMe;
+}
+
 /**
  * @brief Changes the memory size of the packet, erasing all packet data in the process.
  *
@@ -836,20 +1157,17 @@ void Packet::SetMemorySize(size_t newSize)
 	{
 		if(dataPtrChanged == false)
 		{
+			newSize = GetAllocationSize(newSize);
+
 			if(newSize != GetMemorySize())
 			{
 				// Cleanup
-				delete[] data;
+				DeallocateData();
 
 				// Allocate memory
 				if(newSize > 0)
 				{
-					data = new (nothrow) char[newSize];
-					Utility::DynamicAllocCheck(data,__LINE__,__FILE__);
-				}
-				else
-				{
-					data = NULL;
+					data = AllocateData(newSize);
 				}
 			}
 		}
@@ -887,25 +1205,35 @@ void Packet::ChangeMemorySize(size_t newSize)
 		// Reallocate
 		if(dataPtrChanged == false)
 		{
+			// Data in use must not be lost
+			if(newSize < usedSize)
+			{
+				newSize = usedSize;
+			}
+			newSize = GetAllocationSize(newSize);
+
 			if(newSize != memSize)
 			{
 				if(newSize > 0)
 				{
-					// Store current data
-					Packet Temp(*this);
+					// Copy data in use straight into new memory
+					char * newData = AllocateData(newSize);
 
-					// Change memory size, current data is lost
-					SetMemorySize(newSize);
+					if(usedSize > 0)
+					{
+						memcpy(newData,data,usedSize);
+					}
 
-					// Restore data
-					*this = Temp;
+					DeallocateData();
+					data = newData;
 				}
 				else
 				{
 					// Deallocate completely if NewSize is 0
-					delete[] data;
-					data = NULL;
+					DeallocateData();
 				}
+
+				memSize = newSize;
 			}
 		}
 		else
@@ -920,6 +1248,61 @@ void Packet::ChangeMemorySize(size_t newSize)
 	Leave();
 }
 
+/**
+ * @brief Ensures that Packet::memSize is at least @a size without erasing packet data.
+ *
+ * Unlike the memory that is allocated automatically as data is added, exactly @a size bytes are allocated.
+ * This should be used before adding many fields if the final size of the packet is known.
+ * Memory size is never decreased by this method.
+ *
+ * @param size Minimum memory size.
+ */
+void Packet::Reserve(size_t size)
+{
+	Enter();
+
+	try
+	{
+		if(size > memSize)
+		{
+			ChangeMemorySize(size);
+		}
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & Error){Leave();	throw(Error);}
+	catch(...){Leave();	throw(-1);}
+
+	Leave();
+}
+
+/**
+ * @brief Increases Packet::memSize geometrically if it is less than @a requiredSize.
+ *
+ * Memory size is at least doubled, so that adding data one field at a time results in
+ * a small number of reallocations rather than one for every field.
+ * If the data pointer has been changed using SetDataPtr() memory size is set to exactly @a requiredSize.
+ *
+ * @param requiredSize Minimum memory size.
+ */
+void Packet::_GrowMemory(size_t requiredSize)
+{
+	if(requiredSize <= memSize)
+	{
+		return;
+	}
+
+	size_t newSize = requiredSize;
+	size_t doubleSize = memSize * 2;
+
+	// doubleSize is less than memSize if integer overflow occurred
+	if(dataPtrChanged == false && doubleSize > newSize && doubleSize > memSize)
+	{
+		newSize = doubleSize;
+	}
+
+	ChangeMemorySize(newSize);
+}
+
 /**
  * @brief Erases part of the packet, decreasing Packet::usedSize and Packet::cursorPos.
  * 
@@ -991,6 +1374,7 @@ void Packet::Insert(size_t amount)
 			size_t newSize = oldSize + amount;
 
 			// Adjust memory size and used size
+			_GrowMemory(newSize);
 			SetUsedSize(newSize);
 
 			// Destination begins after insert area
@@ -1300,6 +1684,37 @@ void Packet::AddClockT(clock_t add)
 	Leave();
 }
 
+/**
+ * @brief Adds a variable of type size_t to the packet as a variable length integer.
+ *
+ * Data is added to the packet's data buffer starting at Packet::cursorPos.
+ * Packet::cursorPos is moved along by the number of bytes used.\n\n
+ *
+ * Unlike AddSizeT() small values use fewer bytes: values below 128 use 1 byte, values below 16384 use 2 bytes
+ * and so on, up to Packet::varSizeTMaxBytes. The encoding is the same on all bit versions of the module.
+ * The value must be retrieved using GetVarSizeT().
+ *
+ * @param add Data to add.
+ */
+void Packet::AddVarSizeT(size_t add)
+{
+	char encoded[varSizeTMaxBytes];
+	size_t length = EncodeVarSizeT(add, encoded);
+
+	Enter();
+	try
+	{
+		size_t originalCursor = GetCursor();
+		_UpdateMemoryAndCursor(length);
+		memcpy(data + originalCursor, encoded, length);
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & Error){Leave();	throw(Error);}
+	catch(...){Leave();	throw(-1);}
+
+	Leave();
+}
+
 /**
  * @brief Adjusts Packet::usedSize and Packet::memSize if Packet::cursorPos increases beyond it with the addition of @a addSize.
  *
@@ -1314,6 +1729,7 @@ void Packet::_UpdateMemoryAndCursor(size_t amount)
 
 		if(newSize > GetUsedSize())
 		{
+			_GrowMemory(newSize);
 			SetUsedSize(newSize);
 		}
 		IncCursor(amount);
@@ -1422,26 +1838,116 @@ size_t Packet::GetSizeT() const
 }
 
 /**
- * @brief Retrieves a variable of type size_t from the specified position without moving the cursor.
- *
- * Note that the cursor will move Utility::LargestSupportedBytesInt length
- * even if sizeof(size_t) is smaller. This is to ensure that the different bit versions
- * of the module are compatible with each other.
+ * @brief Retrieves a variable of type size_t that was added using AddVarSizeT().
  *
- * @param position Position to retrieve data from.
+ * Data is retrieved from the packet's data buffer starting at Packet::cursorPos.
+ * Packet::cursorPos is moved along by the number of bytes used.
  *
- * @return retrieved data.
+ * @exception ErrorReport If the end of the packet is reached before the end of the integer, or
+ * if the integer is longer than Packet::varSizeTMaxBytes.
+ * @return data from the packet.
  */
-size_t Packet::GetPrefixSizeT( size_t position ) const
+size_t Packet::GetVarSizeT() const
 {
 	size_t returnMe = 0;
-	const char * cCommand = "Packet::GetPrefixSizeT";
 
 	Enter();
 	try
 	{
-		size_t originalCursor = GetCursor();
-
+		size_t length = DecodeVarSizeT(data + GetCursor(), GetPacketRemainder(), &returnMe);
+		SetCursor(GetCursor() + length);
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & Error){Leave();	throw(Error);}
+	catch(...){Leave();	throw(-1);}
+
+	Leave();
+
+	return(returnMe);
+}
+
+/**
+ * @brief Writes @a value as a variable length integer.
+ *
+ * 7 bits of @a value are stored in each byte, least significant first. The most significant bit
+ * of each byte is set if more bytes follow.
+ *
+ * @param value Value to write.
+ * @param [out] destination Encoded value is written here, must be at least Packet::varSizeTMaxBytes in size.
+ *
+ * @return number of bytes written to @a destination.
+ */
+size_t Packet::EncodeVarSizeT(size_t value, char * destination)
+{
+	size_t length = 0;
+
+	while(value >= 0x80)
+	{
+		destination[length] = static_cast<char>((value & 0x7F) | 0x80);
+		value >>= 7;
+		length++;
+	}
+	destination[length] = static_cast<char>(value);
+
+	return length + 1;
+}
+
+/**
+ * @brief Reads a variable length integer written by EncodeVarSizeT().
+ *
+ * Integers written by a 64 bit version of the module that are too large for size_t
+ * are truncated, as with GetSizeT().
+ *
+ * @param source Encoded value.
+ * @param length Number of bytes of @a source that can be read.
+ * @param [out] result Decoded value is written here.
+ *
+ * @exception ErrorReport If @a length bytes are read before the end of the integer, or
+ * if the integer is longer than Packet::varSizeTMaxBytes.
+ * @return number of bytes read from @a source.
+ */
+size_t Packet::DecodeVarSizeT(const char * source, size_t length, size_t * result)
+{
+	unsigned long long int value = 0;
+
+	for(size_t n = 0;n<length && n<varSizeTMaxBytes;n++)
+	{
+		unsigned char byte = static_cast<unsigned char>(source[n]);
+		value |= static_cast<unsigned long long int>(byte & 0x7F) << (n * 7);
+
+		if((byte & 0x80) == 0)
+		{
+			*result = static_cast<size_t>(value);
+			return n + 1;
+		}
+	}
+
+	_ErrorException((length < varSizeTMaxBytes),"getting a variable length integer. The end of the packet was reached before all data could be extracted from the packet",0,__LINE__,__FILE__);
+	_ErrorException(true,"getting a variable length integer, the integer is too long",0,__LINE__,__FILE__);
+	return 0;
+}
+
+/**
+ * @brief Retrieves a variable of type size_t from the specified position without moving the cursor.
+ *
+ * Note that the cursor will move Utility::LargestSupportedBytesInt length
+ * even if sizeof(size_t) is smaller. This is to ensure that the different bit versions
+ * of the module are compatible with each other.
+ *
+ * @param position Position to retrieve data from.
+ *
+ * @return retrieved data.
+ */
+size_t Packet::GetPrefixSizeT( size_t position ) const
+{
+	size_t returnMe = 0;
+	const char * cCommand = "Packet::GetPrefixSizeT";
+
+	Enter();
+	try
+	{
+		size_t originalCursor = GetCursor();
+
 		SetCursor(position);
 		returnMe = GetSizeT();
 
@@ -1751,6 +2257,38 @@ void Packet::CopyIntoWSABUF(WSABUF & buffer) const
 	Leave();
 }
 
+/**
+ * @brief Gives the packet's memory to a WSABUF, leaving the packet empty with no memory.
+ *
+ * The buffer must be deallocated using delete[], as with CopyIntoWSABUF(). If this packet uses
+ * SetDataPtr() or is empty then its data is copied instead, and the packet is not changed.
+ *
+ * @param [out]	buffer	The buffer to move into.
+ * @warning Contents of @a buffer is ignored so any memory deallocation of the buffer should
+ * take place before calling this method.
+ */
+void Packet::MoveIntoWSABUF(WSABUF & buffer)
+{
+	Enter();
+	try
+	{
+		if(dataPtrChanged == true || usedSize == 0)
+		{
+			CopyIntoWSABUF(buffer);
+		}
+		else
+		{
+			buffer.buf = data;
+			buffer.len = static_cast<ULONG>(usedSize);
+			DefaultVariables(true);
+		}
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & Error){Leave();	throw(Error);}
+	catch(...){Leave();	throw(-1);}
+	Leave();
+}
+
 /**
  * @brief Constructor to be used to create a new packet after data has been received via winsock.
  *
@@ -1764,6 +2302,7 @@ void Packet::CopyIntoWSABUF(WSABUF & buffer) const
  */
 Packet::Packet(const WSABUF & paraData, size_t paraUsed, size_t paraOffset, size_t paraClientFrom, size_t paraOperation, size_t paraInstance, clock_t paraClock)
 {
+	slab = NULL;
 	DefaultVariables(true);
 	LoadFull(paraData,paraUsed,paraOffset,paraClientFrom,paraOperation,paraInstance,paraClock);
 }
@@ -1816,8 +2355,7 @@ bool Packet::Find( size_t startPos, size_t endPos, const Packet & findMe, size_t
 {
 	bool found = false;
 
-	Enter();
-	findMe.Enter();
+	EnterPair(*this,findMe);
 	try
 	{
 		if(endPos == 0)
@@ -1858,15 +2396,170 @@ bool Packet::Find( size_t startPos, size_t endPos, const Packet & findMe, size_t
 		}
 	}
 	// Release control of all objects before throwing exception
-	catch (ErrorReport & error){findMe.Leave(); Leave(); throw(error);}
-	catch (...){findMe.Leave(); Leave(); throw(-1);}
-	findMe.Leave();
-	Leave();
+	catch (ErrorReport & error){LeavePair(*this,findMe); throw(error);}
+	catch (...){LeavePair(*this,findMe); throw(-1);}
+	LeavePair(*this,findMe);
 
 	return found;
 }
 
 
+/**
+ * @brief Compares the cost of building packets from many small fields with
+ * exact memory growth, geometric memory growth and Packet::Reserve().
+ *
+ * @param numPackets Number of packets to build.
+ * @param numFields Number of integers added to each packet.
+ */
+static void PacketGrowthBenchmark(size_t numPackets, size_t numFields)
+{
+	// Memory is increased by exactly the size of each field, as it was before geometric growth
+	DWORD startTime = GetTickCount();
+	for(size_t n = 0;n<numPackets;n++)
+	{
+		Packet packet;
+		for(size_t i = 0;i<numFields;i++)
+		{
+			packet.ChangeMemorySize(packet.GetUsedSize() + sizeof(int));
+			packet.Add<int>(static_cast<int>(i));
+		}
+	}
+	DWORD exactTime = GetTickCount() - startTime;
+
+	startTime = GetTickCount();
+	for(size_t n = 0;n<numPackets;n++)
+	{
+		Packet packet;
+		for(size_t i = 0;i<numFields;i++)
+		{
+			packet.Add<int>(static_cast<int>(i));
+		}
+	}
+	DWORD geometricTime = GetTickCount() - startTime;
+
+	startTime = GetTickCount();
+	for(size_t n = 0;n<numPackets;n++)
+	{
+		Packet packet;
+		packet.Reserve(numFields * sizeof(int));
+		for(size_t i = 0;i<numFields;i++)
+		{
+			packet.Add<int>(static_cast<int>(i));
+		}
+	}
+	DWORD reserveTime = GetTickCount() - startTime;
+
+	cout << " " << numPackets << " packets of " << numFields << " fields:\n";
+	cout << "  Exact growth: " << exactTime << "ms\n";
+	cout << "  Geometric growth: " << geometricTime << "ms\n";
+	cout << "  Reserve: " << reserveTime << "ms\n";
+}
+
+/**
+ * @brief	Compares encrypting and decrypting packets on the calling thread with using encryption threads,
+ * for a range of packet sizes, to find the size at which encryption threads become faster.
+ */
+static void PacketEncryptionThresholdBenchmark()
+{
+	const size_t bytesPerSize = 4 * 1024 * 1024;
+	EncryptKey key(1234,5678);
+	size_t crossover = 0;
+
+	cout << "Encryption inline threshold sweep:\n";
+	for(size_t size = 256;size <= 1024 * 1024;size *= 2)
+	{
+		Packet packet;
+		packet.SetMemorySize(size);
+		packet.SetUsedSize(size);
+		memset(packet.GetDataPtr(),0x5a,size);
+
+		size_t iterations = bytesPerSize / size;
+		DWORD times[2];
+		for(size_t threaded = 0;threaded<2;threaded++)
+		{
+			// Packets are never empty, so a threshold of 1 always uses the encryption threads
+			if(threaded == 1)
+			{
+				Packet::SetEncryptionInlineThreshold(1);
+			}
+			else
+			{
+				Packet::SetEncryptionInlineThreshold(size + 1);
+			}
+
+			DWORD startTime = GetTickCount();
+			for(size_t n = 0;n<iterations;n++)
+			{
+				packet.Encrypt(key);
+				packet.Decrypt(key);
+			}
+			times[threaded] = GetTickCount() - startTime;
+		}
+
+		cout << " " << size << " bytes: " << times[0] << "ms inline, " << times[1] << "ms using threads\n";
+		if(crossover == 0 && times[1] < times[0])
+		{
+			crossover = size;
+		}
+	}
+
+	Packet::SetEncryptionInlineThreshold(0);
+	cout << " Threads are first faster at " << crossover << " bytes (0 if never), automatic threshold is " << Packet::GetEncryptionInlineThreshold() << " bytes\n";
+}
+
+/** @brief Number of times each thread started by Packet::TestClass() swaps PacketTestSwapPair. */
+static const size_t PACKET_TEST_SWAP_AMOUNT = 1000000;
+
+/** @brief Packets swapped in opposite directions by two threads. */
+static Packet PacketTestSwapPair[2];
+
+/** @brief False if PacketTestSwapThread() found the packets of PacketTestSwapPair to be the same. */
+static bool PacketTestSwapCompareGood = true;
+
+/**
+ * @brief Swaps and compares the packets of PacketTestSwapPair, in the direction given by the thread's manual ID.
+ *
+ * @param lpParameter Pointer to ThreadSingle object.
+ *
+ * @return 0.
+ */
+static DWORD WINAPI PacketTestSwapThread(LPVOID lpParameter)
+{
+	ThreadSingle * thread = static_cast<ThreadSingle*>(lpParameter);
+	size_t from = thread->GetManualThreadID();
+
+	for(size_t n = 0;n<PACKET_TEST_SWAP_AMOUNT;n++)
+	{
+		PacketTestSwapPair[from].Swap(PacketTestSwapPair[1 - from]);
+		if(PacketTestSwapPair[from] == PacketTestSwapPair[1 - from])
+		{
+			PacketTestSwapCompareGood = false;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Moves the packets of PacketTestSwapPair into each other, in the direction given by the thread's manual ID.
+ *
+ * @param lpParameter Pointer to ThreadSingle object.
+ *
+ * @return 0.
+ */
+static DWORD WINAPI PacketTestMoveThread(LPVOID lpParameter)
+{
+	ThreadSingle * thread = static_cast<ThreadSingle*>(lpParameter);
+	size_t from = thread->GetManualThreadID();
+
+	for(size_t n = 0;n<PACKET_TEST_SWAP_AMOUNT;n++)
+	{
+		PacketTestSwapPair[from] = std::move(PacketTestSwapPair[1 - from]);
+	}
+
+	return 0;
+}
+
 /**
  * @brief Tests class.
  *
@@ -2034,10 +2727,10 @@ bool Packet::TestClass()
 			cout << "Add and Get are good\n";
 		}
 
-		// Adding into unallocated data
+		// Adding into unallocated data, memory size doubles
 		packet.Add<int>(500);
 		packet.Add<int>(600);
-		if(packet.GetMemorySize() != sizeof(int)*3)
+		if(packet.GetMemorySize() != sizeof(int)*4)
 		{
 			cout << "GetMemorySize or Add is bad\n";
 			problem = true;
@@ -2233,6 +2926,45 @@ bool Packet::TestClass()
 		}
 	}
 
+	{
+		Packet packet;
+
+		// Variable length integers, each value uses one more byte than the last
+		packet.AddVarSizeT(0);
+		packet.AddVarSizeT(127);
+		packet.AddVarSizeT(128);
+		packet.AddVarSizeT(16384);
+		packet.AddVarSizeT(0xFFFFFFFF);
+		packet.SetCursor(0);
+
+		if(packet.GetUsedSize() != 1 + 1 + 2 + 3 + 5 || packet.GetVarSizeT() != 0 || packet.GetVarSizeT() != 127 ||
+		   packet.GetVarSizeT() != 128 || packet.GetVarSizeT() != 16384 || packet.GetVarSizeT() != 0xFFFFFFFF ||
+		   packet.GetPacketRemainder() != 0)
+		{
+			cout << "AddVarSizeT and GetVarSizeT is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "AddVarSizeT and GetVarSizeT is good\n";
+		}
+
+		// Integer that is cut off
+		packet.Clear();
+		packet.Add<unsigned char>(0x80);
+		packet.SetCursor(0);
+		try
+		{
+			packet.GetVarSizeT();
+			cout << "GetVarSizeT bounds checking is bad\n";
+			problem = true;
+		}
+		catch(ErrorReport & error)
+		{
+			cout << "GetVarSizeT bounds checking is good\n";
+		}
+	}
+
 	{
 		Packet packet;
 
@@ -2522,6 +3254,203 @@ bool Packet::TestClass()
 
 		delete[] result;
 	}
+
+	{
+		Packet first("hello");
+		first.SetClientFrom(3);
+		Packet second;
+		second.SetMemorySize(100);
+
+		const char * firstData = first.GetDataPtr();
+		second.Swap(first);
+
+		if(second != "hello" || second.GetDataPtr() != firstData || second.GetClientFrom() != 3 ||
+		   first.GetUsedSize() != 0 || first.GetMemorySize() != 100 || first.GetClientFrom() != 0)
+		{
+			cout << "Swap is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Swap is good\n";
+		}
+
+		char external[5];
+		Packet view;
+		view.SetDataPtr(external,sizeof(external),0);
+		try
+		{
+			view.Swap(first);
+			cout << "Swap is bad\n";
+			problem = true;
+		}
+		catch(ErrorReport & error)
+		{
+			cout << "Swap is good\n";
+		}
+		view.UnsetDataPtr();
+	}
+
+	{
+		// Two threads locking the same pair of packets in opposite directions must not deadlock
+		PacketTestSwapPair[0] = "hello";
+		PacketTestSwapPair[1] = "world";
+
+		ThreadSingleGroup threads;
+		for(size_t n = 0;n<2;n++)
+		{
+			ThreadSingle * thread = new (nothrow) ThreadSingle(&PacketTestSwapThread,NULL,n);
+			Utility::DynamicAllocCheck(thread,__LINE__,__FILE__);
+			threads.Add(thread);
+		}
+		threads.Resume();
+		threads.WaitForThreadsToExit();
+
+		bool swapGood = (PacketTestSwapPair[0] == "hello" && PacketTestSwapPair[1] == "world") || (PacketTestSwapPair[0] == "world" && PacketTestSwapPair[1] == "hello");
+		if(swapGood == false || PacketTestSwapCompareGood == false)
+		{
+			cout << "Swap is bad (concurrent)\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Swap is good (concurrent)\n";
+		}
+
+		// Move assignment locks both packets too, data may be lost but the threads must finish
+		ThreadSingleGroup moveThreads;
+		for(size_t n = 0;n<2;n++)
+		{
+			ThreadSingle * thread = new (nothrow) ThreadSingle(&PacketTestMoveThread,NULL,n);
+			Utility::DynamicAllocCheck(thread,__LINE__,__FILE__);
+			moveThreads.Add(thread);
+		}
+		moveThreads.Resume();
+		moveThreads.WaitForThreadsToExit();
+		cout << "Move assignment operator is good (concurrent)\n";
+
+		PacketTestSwapPair[0].Clear();
+		PacketTestSwapPair[1].Clear();
+	}
+
+	{
+		Packet first("hello");
+		first.SetClientFrom(3);
+		const char * firstData = first.GetDataPtr();
+
+		Packet second(std::move(first));
+		Packet third;
+		third.SetMemorySize(100);
+		third = std::move(second);
+
+		if(third != "hello" || third.GetDataPtr() != firstData || third.GetClientFrom() != 3 ||
+		   first.GetMemorySize() != 0 || second.GetMemorySize() != 0 || second.GetUsedSize() != 0)
+		{
+			cout << "Move constructor or move assignment operator is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Move constructor and move assignment operator are good\n";
+		}
+
+		// Memory that is not owned is copied
+		char external[5] = {'v','i','e','w','s'};
+		Packet view;
+		view.SetDataPtr(external,sizeof(external),4);
+		third.TakeBuffer(view);
+		if(third != "view" || third.GetDataPtr() == external || view.GetUsedSize() != 4 || third.IsDataPtrChanged() == true)
+		{
+			cout << "TakeBuffer is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "TakeBuffer is good\n";
+		}
+		view.UnsetDataPtr();
+
+		const char * thirdData = third.GetDataPtr();
+		WSABUF buffer;
+		third.MoveIntoWSABUF(buffer);
+		if(buffer.buf != thirdData || buffer.len != 4 || third.GetMemorySize() != 0)
+		{
+			cout << "MoveIntoWSABUF is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "MoveIntoWSABUF is good\n";
+		}
+		delete[] buffer.buf;
+	}
+
+	{
+		// Memory grows geometrically as fields are added
+		Packet packet;
+		size_t reallocations = 0;
+		size_t lastMemorySize = 0;
+		for(size_t n = 0;n<1000;n++)
+		{
+			packet.Add<int>(static_cast<int>(n));
+			if(packet.GetMemorySize() != lastMemorySize)
+			{
+				reallocations++;
+				lastMemorySize = packet.GetMemorySize();
+			}
+		}
+
+		packet.SetCursor(sizeof(int)*999);
+		if(packet.GetUsedSize() != sizeof(int)*1000 || packet.GetMemorySize() < packet.GetUsedSize() ||
+		   packet.GetMemorySize() >= packet.GetUsedSize()*2 || reallocations > 12 || packet.Get<int>() != 999)
+		{
+			cout << "Geometric growth is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Geometric growth is good\n";
+		}
+
+		// Reserve allocates exactly, never shrinks and keeps data
+		Packet reserved("hello");
+		reserved.Reserve(100);
+		size_t memoryAfterReserve = reserved.GetMemorySize();
+		reserved.Reserve(10);
+		if(memoryAfterReserve != 100 || reserved.GetMemorySize() != 100 || reserved != "hello")
+		{
+			cout << "Reserve is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Reserve is good\n";
+		}
+
+		// Grown packets are recycled with their capacity
+		MemoryRecyclePacket recycle(1,16);
+		Packet * recycled = recycle.GetPacket(16);
+		recycled->AddStringC("more than sixteen bytes",0,false);
+		size_t grownSize = recycled->GetMemorySize();
+		recycle.IncreaseMemorySize(grownSize - 16);
+		bool wasRecycled = recycle.RecyclePacket(recycled);
+		recycled = recycle.GetPacket(16);
+		if(wasRecycled == false || recycled->GetMemorySize() != grownSize || recycled->GetUsedSize() != 0 || recycle.GetMemorySize() != grownSize)
+		{
+			cout << "Recycling grown packet is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Recycling grown packet is good\n";
+		}
+		recycle.RecyclePacket(recycled);
+	}
+
+	cout << "Benchmarking..\n";
+	PacketGrowthBenchmark(10000,1000);
+	PacketEncryptionThresholdBenchmark();
+
 	cout << "\n\n";
 	return !problem;
 }
@@ -2678,4 +3607,41 @@ void Packet::WaitUntilLastEncryptionOperationFinished()
 bool Packet::IsLastEncryptionOperationFinished()
 {
 	return IsLastThreadOperationFinished();
+}
+
+/**
+ * @brief	Changes the size below which packets are encrypted and decrypted on the calling thread.
+ *
+ * Packets of this size or larger are split between encryption threads. Operations on small
+ * packets always finish before Encrypt() and Decrypt() return, even if they are not blocking.
+ *
+ * @param	threshold	Size in bytes, or 0 to select the threshold automatically
+ * (see DEFAULT_ENCRYPTION_INLINE_THRESHOLD_TABLE and DEFAULT_ENCRYPTION_INLINE_THRESHOLD_HARDWARE).
+ */
+void Packet::SetEncryptionInlineThreshold(size_t threshold)
+{
+	encryptionInlineThreshold = threshold;
+}
+
+/**
+ * @brief	Retrieves the size below which packets are encrypted and decrypted on the calling thread.
+ *
+ * @return	size in bytes.
+ */
+size_t Packet::GetEncryptionInlineThreshold()
+{
+	size_t threshold = encryptionInlineThreshold;
+	if(threshold != 0)
+	{
+		return threshold;
+	}
+
+	if(CipherAES::GetImplementation() == CipherAES::IMPLEMENTATION_HARDWARE)
+	{
+		return DEFAULT_ENCRYPTION_INLINE_THRESHOLD_HARDWARE;
+	}
+	else
+	{
+		return DEFAULT_ENCRYPTION_INLINE_THRESHOLD_TABLE;
+	}
 }
\ No newline at end of file
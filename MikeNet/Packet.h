@@ -1,7 +1,8 @@
 #pragma once
 class Packet;
-#include "ComString.h"
+class ComString;
 class EncryptKey;
+class MemoryRecycleSlab;
 #include "CriticalSection.h"
 #include "ThreadSingleMessageKeepLastUser.h"
 #include "StoreQueue.h"
@@ -25,7 +26,9 @@ class EncryptKey;
  * There are two sizes associated with each packet. Firstly there is the memory size.
  * This is the amount of memory (in bytes) that is allocated to the packet. If more
  * memory is needed it is automatically allocated but for maximum efficiency you should
- * try to allocate all memory at the start using ChangeMemorySize() or SetMemorySize(). \n\n
+ * try to allocate all memory at the start using Reserve(), ChangeMemorySize() or SetMemorySize().
+ * Memory that is allocated automatically grows geometrically, so a packet built from many
+ * small additions is only reallocated a few times. \n\n
  *
  * Secondly there is used size. This is the amount of memory allocated to the packet
  * that is actually in use. The used size can never be more than the
@@ -109,21 +112,67 @@ class Packet: public CriticalSection, public ThreadSingleMessageKeepLastUser, pu
 	 */
 	size_t usedSize;
 
+	/**
+	 * @brief Slab that Packet::data is allocated from and returned to, NULL if new[] and delete[] are used.
+	 *
+	 * This object holds a reference to the slab.
+	 */
+	MemoryRecycleSlab * slab;
+
+	/**
+	 * @brief Packets with fewer bytes than this are encrypted and decrypted on the calling thread
+	 * instead of by encryption threads. 0 if the threshold is selected automatically.
+	 */
+	static volatile size_t encryptionInlineThreshold;
+
 
 public:
+	/**
+	 * @brief Automatic encryption inline threshold when CipherAES uses its table implementation.
+	 *
+	 * Posting a message to each encryption thread and waiting for them costs roughly as
+	 * much as ciphering this many bytes on one thread.
+	 */
+	static const size_t DEFAULT_ENCRYPTION_INLINE_THRESHOLD_TABLE = 16 * 1024;
+
+	/**
+	 * @brief Automatic encryption inline threshold when CipherAES uses AES-NI instructions.
+	 *
+	 * AES-NI is around 20 times faster than the table implementation, so much larger packets
+	 * are ciphered before encryption threads become worthwhile.
+	 */
+	static const size_t DEFAULT_ENCRYPTION_INLINE_THRESHOLD_HARDWARE = 256 * 1024;
+
 	/**
 	 * @brief Number of bytes including any padding that prefix added using AddSizeT() or AddClockT() use.
 	 *
 	 * This is not always the same as sizeof(size_t) or sizeof(clock_t).
 	 */
 	static const unsigned int prefixSizeBytes = Utility::LargestSupportedBytesInt;
+
+	/**
+	 * @brief Maximum number of bytes that a variable length integer added using AddVarSizeT() uses.
+	 *
+	 * Each byte holds 7 bits of the integer, so the largest values take more than Packet::prefixSizeBytes.
+	 */
+	static const unsigned int varSizeTMaxBytes = (Utility::LargestSupportedBitsInt + 6) / 7;
 private:
 	void _UpdateMemoryAndCursor(size_t addSize);
+	void _GrowMemory(size_t requiredSize);
+
+	size_t GetAllocationSize(size_t size) const;
+	char * AllocateData(size_t size);
+	void DeallocateData();
 
 
 	void Copy(const Packet & copyMe);
 	void Copy(const char * copyMe);
+#ifdef _WIN32
 	void Copy(const ComString & comString);
+#endif
+
+	static void EnterPair(const Packet & first, const Packet & second);
+	static void LeavePair(const Packet & first, const Packet & second);
 
 	static void _AddPacket(Packet & destination, const Packet & source);
 	static void _AddWSABUF(Packet & destination, const WSABUF & source, size_t used);
@@ -132,6 +181,8 @@ private:
 
 public:
 	static void DecryptWSABUF(WSABUF decryptMe, size_t used, size_t offset, const EncryptKey * key);
+	static size_t EncodeVarSizeT(size_t value, char * destination);
+	static size_t DecodeVarSizeT(const char * source, size_t length, size_t * result);
 
 	Packet operator+ (const Packet &);
 	void operator+= (const Packet &);
@@ -156,11 +207,17 @@ public:
 
 	Packet(const Packet &);
 	Packet(const char *);
+#ifdef _WIN32
 	Packet(const ComString &);
+#endif
 
 	Packet & operator= (const Packet &);
+	Packet(Packet && moveMe);
+	Packet & operator= (Packet && moveMe);
 	Packet & operator= (const char *);
+#ifdef _WIN32
 	Packet & operator= (const ComString &);
+#endif
 
 	void Erase(size_t startPos, size_t amount);
 	void Insert(size_t amount);
@@ -170,6 +227,7 @@ public:
 	void AddStringC(const char*, size_t length, bool prefix);
 	void AddSizeT(size_t);
 	void AddClockT(clock_t);
+	void AddVarSizeT(size_t);
 
 	size_t GetPacketRemainder() const;
 	char * GetStringC(size_t length, bool nullTerminated) const;
@@ -177,10 +235,14 @@ public:
 	size_t GetStringSize() const;
 	size_t GetSizeT() const;
 	clock_t GetClockT() const;
+	size_t GetVarSizeT() const;
 
 	size_t GetMemorySize() const;
 	void SetMemorySize(size_t size);
 	void ChangeMemorySize(size_t size);
+	void Reserve(size_t size);
+	void SetSlab(MemoryRecycleSlab * slab);
+	MemoryRecycleSlab * GetSlab() const;
 	void SetUsedSize(size_t size);
 	size_t GetUsedSize() const;
 	size_t GetCursor() const;
@@ -203,9 +265,14 @@ public:
 	char * GetDataPtrCopy() const;
 	void PtrIntoWSABUF(WSABUF & buffer) const;
 	void CopyIntoWSABUF(WSABUF & buffer) const;
+	void MoveIntoWSABUF(WSABUF & buffer);
 
 	void SetDataPtr(char * newPtr, size_t paraMemSize, size_t paraUsedSize);
 	void UnsetDataPtr();
+	bool IsDataPtrChanged() const;
+
+	void Swap(Packet & other);
+	void TakeBuffer(Packet & source);
 private:
 	void DoEncryptionOperation(bool encryption, const EncryptKey & key, bool block);
 public:
@@ -215,6 +282,9 @@ public:
 	void WaitUntilLastEncryptionOperationFinished();
 	bool IsLastEncryptionOperationFinished();
 
+	static void SetEncryptionInlineThreshold(size_t threshold);
+	static size_t GetEncryptionInlineThreshold();
+
 	void AddHex(const char * hex);
 	char * GetHex(size_t startPos, size_t numBytes) const;
 
@@ -324,10 +394,7 @@ public:
 			size_t endPos = GetCursor() + sizeof(add);
 
 			// Increase memory size as necessary
-			if(endPos > GetMemorySize())
-			{
-				ChangeMemorySize(endPos);
-			}
+			_GrowMemory(endPos);
 
 			// Increase used size as necessary
 			if(endPos > GetUsedSize())
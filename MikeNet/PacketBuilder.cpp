@@ -0,0 +1,505 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Constructor.
+ */
+PacketBuilder::PacketBuilder()
+{
+	data = inlineData;
+	memSize = INLINE_SIZE;
+	usedSize = 0;
+	cursorPos = 0;
+}
+
+/**
+ * @brief Constructor.
+ *
+ * @param size Number of bytes that can be added without allocating more memory.
+ */
+PacketBuilder::PacketBuilder(size_t size)
+{
+	data = inlineData;
+	memSize = INLINE_SIZE;
+	usedSize = 0;
+	cursorPos = 0;
+
+	Reserve(size);
+}
+
+/**
+ * @brief Destructor.
+ */
+PacketBuilder::~PacketBuilder()
+{
+
+}
+
+/**
+ * @brief Allocates more memory, keeping data that has already been added.
+ *
+ * @param required Amount of memory needed.
+ */
+void PacketBuilder::Grow(size_t required)
+{
+	// Double so that many small additions do not reallocate many times
+	size_t newSize = memSize * 2;
+	if(newSize < required)
+	{
+		newSize = required;
+	}
+
+	Packet grown;
+	grown.SetMemorySize(newSize);
+	if(usedSize > 0)
+	{
+		memcpy(grown.GetDataPtr(), data, usedSize);
+	}
+
+	storage.Swap(grown);
+	data = storage.GetDataPtr();
+	memSize = newSize;
+}
+
+/**
+ * @brief Ensures that at least @a size bytes can be stored without allocating more memory.
+ *
+ * @param size Amount of memory needed.
+ */
+void PacketBuilder::Reserve(size_t size)
+{
+	if(size > memSize)
+	{
+		Grow(size);
+	}
+}
+
+/**
+ * @brief Adds a variable of type size_t.
+ *
+ * As with Packet::AddSizeT(), Utility::LargestSupportedBytesInt bytes are always added
+ * so that the different bit versions of the module are compatible with each other.
+ *
+ * @param add Data to add.
+ */
+void PacketBuilder::AddSizeT(size_t add)
+{
+	Add(add);
+
+	// Pad insertion so that 32 bit insertion is the same size as 64 bit insertion
+	for(size_t n = sizeof(add);n<Utility::LargestSupportedBytesInt;n++)
+	{
+		Add('\0');
+	}
+}
+
+/**
+ * @brief Adds a variable of type clock_t.
+ *
+ * As with Packet::AddClockT(), Utility::LargestSupportedBytesInt bytes are always added
+ * so that the different bit versions of the module are compatible with each other.
+ *
+ * @param add Data to add.
+ */
+void PacketBuilder::AddClockT(clock_t add)
+{
+	Add(add);
+
+	// Pad insertion so that 32 bit insertion is the same size as 64 bit insertion
+	for(size_t n = sizeof(add);n<Utility::LargestSupportedBytesInt;n++)
+	{
+		Add('\0');
+	}
+}
+
+/**
+ * @brief Adds a variable of type size_t as a variable length integer.
+ *
+ * The format is the same as Packet::AddVarSizeT().
+ *
+ * @param add Data to add.
+ */
+void PacketBuilder::AddVarSizeT(size_t add)
+{
+	char encoded[Packet::varSizeTMaxBytes];
+	AddStringC(encoded,Packet::EncodeVarSizeT(add,encoded),false);
+}
+
+/**
+ * @brief Adds a C string.
+ *
+ * @param add C string to add.
+ * @param length Length of C string, if 0 then the string must be NULL terminated and the length will be calculated automatically.
+ * @param prefix If true the string will be added with a prefix that is used by Packet::GetStringC() and
+ * PacketReader::GetStringC() to determine its length.
+ */
+void PacketBuilder::AddStringC(const char * add, size_t length, bool prefix)
+{
+	if(length == 0)
+	{
+		length = strlen(add);
+	}
+
+	if(prefix == true)
+	{
+		AddSizeT(length);
+	}
+
+	size_t endPos = cursorPos + length;
+	if(endPos > memSize)
+	{
+		Grow(endPos);
+	}
+
+	if(length > 0)
+	{
+		memcpy(data + cursorPos, add, length);
+	}
+	cursorPos = endPos;
+
+	if(cursorPos > usedSize)
+	{
+		usedSize = cursorPos;
+	}
+}
+
+/**
+ * @brief Empties the packet, memory is kept so that it can be used again.
+ */
+void PacketBuilder::Clear()
+{
+	usedSize = 0;
+	cursorPos = 0;
+}
+
+/**
+ * @brief Retrieves the amount of data that has been added.
+ *
+ * @return amount of memory in use.
+ */
+size_t PacketBuilder::GetUsedSize() const
+{
+	return usedSize;
+}
+
+/**
+ * @brief Retrieves the amount of data that can be stored without allocating more memory.
+ *
+ * @return amount of memory available.
+ */
+size_t PacketBuilder::GetMemorySize() const
+{
+	return memSize;
+}
+
+/**
+ * @brief Retrieves the position that the next field will be added at.
+ *
+ * @return cursor position.
+ */
+size_t PacketBuilder::GetCursor() const
+{
+	return cursorPos;
+}
+
+/**
+ * @brief Changes the position that the next field will be added at.
+ *
+ * This can be used to go back and fill in a field whose value was not known when it was added.
+ *
+ * @exception ErrorReport If @a position is more than the used size.
+ *
+ * @param position New cursor position.
+ */
+void PacketBuilder::SetCursor(size_t position)
+{
+	_ErrorException((position > usedSize),"setting the cursor of a packet builder, position is out of bounds",0,__LINE__,__FILE__);
+	cursorPos = position;
+}
+
+/**
+ * @brief Retrieves a mutable pointer to the data that has been added.
+ *
+ * @warning The pointer is invalidated when more memory is allocated or MoveInto() is used.
+ * @return pointer to data.
+ */
+char * PacketBuilder::GetDataPtr()
+{
+	return data;
+}
+
+/**
+ * @brief Retrieves a constant pointer to the data that has been added.
+ *
+ * @warning The pointer is invalidated when more memory is allocated or MoveInto() is used.
+ * @return pointer to data.
+ */
+const char * PacketBuilder::GetDataPtr() const
+{
+	return data;
+}
+
+/**
+ * @brief Determines whether data is stored in memory that is part of the object.
+ *
+ * @return true if no memory has been allocated for the data.
+ */
+bool PacketBuilder::IsInline() const
+{
+	return data == inlineData;
+}
+
+/**
+ * @brief Passes the data that has been added to a packet, emptying this object.
+ *
+ * If memory has been allocated then it changes owner, so data is not copied. If the data is
+ * small enough to be stored in PacketBuilder::inlineData then it is copied.\n\n
+ *
+ * @a destination's previous memory is kept by this object and used by later packets.
+ * @a destination's client, operation, instance and age are set to 0 and its cursor is set to 0.
+ *
+ * @exception ErrorReport If @a destination uses Packet::SetDataPtr().
+ *
+ * @param [out] destination Packet to load data into.
+ */
+void PacketBuilder::MoveInto(Packet & destination)
+{
+	if(IsInline() == true)
+	{
+		WSABUF buffer;
+		buffer.buf = data;
+		buffer.len = static_cast<DWORD>(usedSize);
+		destination.LoadFull(buffer,usedSize,0,0,0,0,0);
+	}
+	else
+	{
+		storage.Clear();
+		storage.SetUsedSize(usedSize);
+		destination.Swap(storage);
+
+		// Reuse memory that destination was using if it is larger than inline memory
+		storage.Clear();
+		if(storage.GetMemorySize() > INLINE_SIZE)
+		{
+			data = storage.GetDataPtr();
+			memSize = storage.GetMemorySize();
+		}
+		else
+		{
+			data = inlineData;
+			memSize = INLINE_SIZE;
+		}
+	}
+
+	Clear();
+}
+
+/**
+ * @brief Compares the cost of adding and retrieving fields using Packet, which locks
+ * on every field, with PacketBuilder and PacketReader.
+ *
+ * @param packets Number of packets to build and read.
+ * @param fields Number of each type of field in each packet.
+ *
+ * @return true if both methods produced the same data.
+ */
+static bool PacketBuilderBenchmark(size_t packets, size_t fields)
+{
+	const size_t fieldTypes = 4;
+	size_t checksumLocked = 0;
+	size_t checksumBuilder = 0;
+	size_t lockedSize = 0;
+	size_t builderSize = 0;
+
+	// Locked packet
+	Packet packet;
+	DWORD startTime = GetTickCount();
+	for(size_t n = 0;n<packets;n++)
+	{
+		packet.Clear();
+		for(size_t i = 0;i<fields;i++)
+		{
+			packet.Add<int>(static_cast<int>(i));
+			packet.Add<float>(1.5f);
+			packet.Add<char>('a');
+			packet.AddSizeT(i);
+		}
+
+		packet.SetCursor(0);
+		for(size_t i = 0;i<fields;i++)
+		{
+			checksumLocked += packet.Get<int>();
+			checksumLocked += static_cast<size_t>(packet.Get<float>());
+			checksumLocked += packet.Get<char>();
+			checksumLocked += packet.GetSizeT();
+		}
+	}
+	DWORD lockedTime = GetTickCount() - startTime;
+	lockedSize = packet.GetUsedSize();
+
+	// Builder and reader
+	PacketBuilder builder;
+	startTime = GetTickCount();
+	for(size_t n = 0;n<packets;n++)
+	{
+		builder.Clear();
+		for(size_t i = 0;i<fields;i++)
+		{
+			builder.Add<int>(static_cast<int>(i));
+			builder.Add<float>(1.5f);
+			builder.Add<char>('a');
+			builder.AddSizeT(i);
+		}
+
+		PacketReader reader(builder.GetDataPtr(),builder.GetUsedSize());
+		for(size_t i = 0;i<fields;i++)
+		{
+			checksumBuilder += reader.Get<int>();
+			checksumBuilder += static_cast<size_t>(reader.Get<float>());
+			checksumBuilder += reader.Get<char>();
+			checksumBuilder += reader.GetSizeT();
+		}
+	}
+	DWORD builderTime = GetTickCount() - startTime;
+	builderSize = builder.GetUsedSize();
+
+	size_t totalFields = packets * fields * fieldTypes;
+	cout << packets << " packets of " << fields * fieldTypes << " fields, each field added and retrieved:\n";
+	cout << " Packet: " << lockedTime << "ms (" << (lockedTime * 1000000.0) / totalFields << "ns per field)\n";
+	cout << " PacketBuilder and PacketReader: " << builderTime << "ms (" << (builderTime * 1000000.0) / totalFields << "ns per field)\n";
+
+	return checksumLocked == checksumBuilder && lockedSize == builderSize &&
+		   memcmp(packet.GetDataPtr(),builder.GetDataPtr(),lockedSize) == 0;
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool PacketBuilder::TestClass()
+{
+	cout << "Testing PacketBuilder class...\n";
+	bool problem = false;
+
+	// Same format as Packet
+	{
+		Packet packet;
+		packet.Add<int>(50);
+		packet.AddSizeT(1234);
+		packet.AddClockT(5678);
+		packet.AddStringC("hello",0,true);
+		packet.AddStringC("world",0,false);
+		packet.AddVarSizeT(300);
+		packet.Add<double>(2.5);
+
+		PacketBuilder builder;
+		builder.Add<int>(50);
+		builder.AddSizeT(1234);
+		builder.AddClockT(5678);
+		builder.AddStringC("hello",0,true);
+		builder.AddStringC("world",0,false);
+		builder.AddVarSizeT(300);
+		builder.Add<double>(2.5);
+
+		if(builder.GetUsedSize() != packet.GetUsedSize() || builder.GetCursor() != packet.GetCursor() ||
+		   memcmp(builder.GetDataPtr(),packet.GetDataPtr(),packet.GetUsedSize()) != 0 || builder.IsInline() == false)
+		{
+			cout << "Add is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Add is good\n";
+		}
+
+		// Fill in a field after the rest of the packet
+		builder.SetCursor(0);
+		builder.Add<int>(60);
+		builder.SetCursor(builder.GetUsedSize());
+		if(builder.GetUsedSize() != packet.GetUsedSize() || *reinterpret_cast<int*>(builder.GetDataPtr()) != 60)
+		{
+			cout << "SetCursor is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "SetCursor is good\n";
+		}
+
+		Packet destination;
+		builder.MoveInto(destination);
+		if(destination.GetUsedSize() != packet.GetUsedSize() || destination.Get<int>() != 60 ||
+		   builder.GetUsedSize() != 0 || builder.IsInline() == false)
+		{
+			cout << "MoveInto (inline) is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "MoveInto (inline) is good\n";
+		}
+	}
+
+	// Growing beyond inline memory
+	{
+		PacketBuilder builder;
+		for(size_t n = 0;n<1000;n++)
+		{
+			builder.Add<int>(static_cast<int>(n));
+		}
+
+		bool grown = (builder.IsInline() == false && builder.GetMemorySize() >= 4000 && builder.GetUsedSize() == 4000);
+
+		const char * ptr = builder.GetDataPtr();
+		Packet destination;
+		destination.SetMemorySize(1000);
+		destination.SetClientFrom(5);
+		builder.MoveInto(destination);
+
+		bool intact = (destination.GetUsedSize() == 4000 && destination.GetClientFrom() == 0);
+		for(size_t n = 0;n<1000 && intact == true;n++)
+		{
+			intact = (destination.Get<int>() == static_cast<int>(n));
+		}
+
+		// Memory changed owner instead of being copied, and destination's old memory is reused
+		if(grown == false || intact == false || destination.GetDataPtr() != ptr ||
+		   builder.GetUsedSize() != 0 || builder.IsInline() == true || builder.GetMemorySize() != 1000)
+		{
+			cout << "MoveInto (allocated) is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "MoveInto (allocated) is good\n";
+		}
+	}
+
+	{
+		PacketBuilder builder(1024);
+		if(builder.IsInline() == true || builder.GetMemorySize() != 1024)
+		{
+			cout << "Reserve is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Reserve is good\n";
+		}
+	}
+
+	if(PacketBuilderBenchmark(100000,10) == false || PacketBuilderBenchmark(1000,1000) == false)
+	{
+		cout << "Benchmark is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Benchmark is good\n";
+	}
+
+	cout << "\n\n";
+	return !problem;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "Packet.h"
+
+/**
+ * @brief	Builds packet data without any locking, for use by a single thread.
+ *
+ * Data is written in exactly the same format as Packet::Add(), Packet::AddSizeT(), Packet::AddClockT(),
+ * Packet::AddVarSizeT() and Packet::AddStringC(), so the receiving end cannot tell the difference. Unlike Packet, this class does not
+ * inherit from CriticalSection, so adding a field costs no more than copying it.\n\n
+ *
+ * Small packets are built in memory that is part of the object, so no memory is allocated until
+ * more than PacketBuilder::INLINE_SIZE bytes are added. After that memory is at least doubled
+ * each time more is needed.\n\n
+ *
+ * When the packet is complete MoveInto() passes it to a Packet, which can then be given to the send methods.
+ * Memory that has been allocated changes owner instead of being copied.\n\n
+ *
+ * This class is not thread safe.
+ */
+class PacketBuilder
+{
+public:
+	/** @brief Number of bytes that can be added before memory is allocated. */
+	static const size_t INLINE_SIZE = 256;
+
+private:
+	/** @brief Memory used while the packet is small. */
+	char inlineData[INLINE_SIZE];
+
+	/**
+	 * @brief Owns memory used once PacketBuilder::inlineData is too small.
+	 *
+	 * This packet's locking is only used when memory changes, never when data is added.
+	 */
+	Packet storage;
+
+	/** @brief Either PacketBuilder::inlineData or memory owned by PacketBuilder::storage. */
+	char * data;
+
+	/** @brief Amount of memory that PacketBuilder::data points to. */
+	size_t memSize;
+
+	/** @brief Amount of PacketBuilder::data that is in use. */
+	size_t usedSize;
+
+	/** @brief Position within PacketBuilder::data that the next field is added at. */
+	size_t cursorPos;
+
+	void Grow(size_t required);
+
+	PacketBuilder(const PacketBuilder &);
+	PacketBuilder & operator= (const PacketBuilder &);
+public:
+	PacketBuilder();
+	PacketBuilder(size_t size);
+	~PacketBuilder();
+
+	void Reserve(size_t size);
+
+	void AddSizeT(size_t add);
+	void AddClockT(clock_t add);
+	void AddVarSizeT(size_t add);
+	void AddStringC(const char * add, size_t length, bool prefix);
+
+	void Clear();
+	size_t GetUsedSize() const;
+	size_t GetMemorySize() const;
+	size_t GetCursor() const;
+	void SetCursor(size_t position);
+	char * GetDataPtr();
+	const char * GetDataPtr() const;
+	bool IsInline() const;
+
+	void MoveInto(Packet & destination);
+
+	static bool TestClass();
+
+	/**
+	 * @brief Adds data of any type.
+	 *
+	 * Data is added at PacketBuilder::cursorPos, which is moved along by the size of the data.\n\n
+	 *
+	 * C strings should not be added using this method, use AddStringC() instead.
+	 *
+	 * @param add Data to add.
+	 */
+	template<typename T>
+	void Add(T add)
+	{
+		size_t endPos = cursorPos + sizeof(add);
+
+		if(endPos > memSize)
+		{
+			Grow(endPos);
+		}
+
+		memcpy(data + cursorPos, &add, sizeof(add));
+		cursorPos = endPos;
+
+		if(cursorPos > usedSize)
+		{
+			usedSize = cursorPos;
+		}
+	}
+};
@@ -0,0 +1,348 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Constructor, the chain is empty.
+ */
+PacketChain::PacketChain()
+{
+	usedSize = 0;
+}
+
+/**
+ * @brief Copy constructor, references to @a copyMe's segments are added instead of their data being copied.
+ *
+ * @param copyMe Object to copy.
+ */
+PacketChain::PacketChain(const PacketChain & copyMe)
+{
+	usedSize = 0;
+	Add(copyMe);
+}
+
+/**
+ * @brief Assignment operator, references to @a copyMe's segments are added instead of their data being copied.
+ *
+ * @param copyMe Object to copy.
+ *
+ * @return reference to this object.
+ */
+PacketChain & PacketChain::operator= (const PacketChain & copyMe)
+{
+	if(this != &copyMe)
+	{
+		Clear();
+		Add(copyMe);
+	}
+	return *this;
+}
+
+/**
+ * @brief Destructor, releases references to segments.
+ */
+PacketChain::~PacketChain()
+{
+	const char * cCommand = "an internal function (~PacketChain)";
+	try
+	{
+		Clear();
+	}
+	MSG_CATCH
+}
+
+/**
+ * @brief Adds a segment to the end of the chain, without copying its data.
+ *
+ * @param [in] segment Segment to add, a reference is added which is released by Clear() or the destructor.
+ * The caller keeps its own reference.
+ */
+void PacketChain::Add(NetSendPayload * segment)
+{
+	_ErrorException((segment == NULL),"adding a segment to a packet chain, segment must not be NULL",0,__LINE__,__FILE__);
+
+	if(segment->GetBuffer().len == 0)
+	{
+		return;
+	}
+
+	segments.push_back(segment);
+	segment->AddReference();
+	usedSize += segment->GetBuffer().len;
+}
+
+/**
+ * @brief Adds a copy of a packet's used data to the end of the chain.
+ *
+ * @param packet Packet to add.
+ */
+void PacketChain::Add(const Packet & packet)
+{
+	if(packet.GetUsedSize() == 0)
+	{
+		return;
+	}
+
+	NetSendPayload * segment = new (nothrow) NetSendPayload(packet);
+	Utility::DynamicAllocCheck(segment,__LINE__,__FILE__);
+
+	try
+	{
+		Add(segment);
+	}
+	catch(ErrorReport & error){ segment->Release(); throw error; }
+	catch(...){ segment->Release(); throw -1; }
+	segment->Release();
+}
+
+/**
+ * @brief Adds a packet's used data to the end of the chain, taking the packet's memory instead of copying it where possible.
+ *
+ * @param [in,out] packet Packet to add, see Packet::MoveIntoWSABUF().
+ */
+void PacketChain::Add(Packet && packet)
+{
+	if(packet.GetUsedSize() == 0)
+	{
+		return;
+	}
+
+	NetSendPayload * segment = new (nothrow) NetSendPayload(std::move(packet));
+	Utility::DynamicAllocCheck(segment,__LINE__,__FILE__);
+
+	try
+	{
+		Add(segment);
+	}
+	catch(ErrorReport & error){ segment->Release(); throw error; }
+	catch(...){ segment->Release(); throw -1; }
+	segment->Release();
+}
+
+/**
+ * @brief Adds the segments of another chain to the end of this chain, without copying their data.
+ *
+ * @param chain Chain to add.
+ */
+void PacketChain::Add(const PacketChain & chain)
+{
+	// Size is determined first in case chain is this object
+	size_t amount = chain.GetSegmentAmount();
+	segments.reserve(segments.size() + amount);
+
+	for(size_t n = 0;n<amount;n++)
+	{
+		Add(chain.GetSegment(n));
+	}
+}
+
+/**
+ * @brief Empties the chain, releasing references to all segments.
+ */
+void PacketChain::Clear()
+{
+	for(size_t n = 0;n<segments.size();n++)
+	{
+		segments[n]->Release();
+	}
+
+	segments.clear();
+	usedSize = 0;
+}
+
+/**
+ * @brief Retrieves the total number of bytes in all segments.
+ *
+ * @return PacketChain::usedSize.
+ */
+size_t PacketChain::GetUsedSize() const
+{
+	return usedSize;
+}
+
+/**
+ * @brief Retrieves the number of segments in the chain.
+ *
+ * @return number of segments.
+ */
+size_t PacketChain::GetSegmentAmount() const
+{
+	return segments.size();
+}
+
+/**
+ * @brief Retrieves a segment.
+ *
+ * @param index Index of segment, where 0 is the start of the chain.
+ *
+ * @exception ErrorReport If @a index is out of bounds.
+ * @return segment, the caller must use NetSendPayload::AddReference() if it is to be used after the chain is changed.
+ */
+NetSendPayload * PacketChain::GetSegment(size_t index) const
+{
+	_ErrorException((index >= segments.size()),"retrieving a segment from a packet chain, index is out of bounds",index,__LINE__,__FILE__);
+	return segments[index];
+}
+
+/**
+ * @brief Copies the data of all segments into one packet.
+ *
+ * This is only necessary where a contiguous copy is needed, sending a chain does not use it.
+ *
+ * @param [out] destination Packet to copy into, its existing contents are replaced and its cursor is set to 0.
+ */
+void PacketChain::CopyInto(Packet & destination) const
+{
+	destination.Clear();
+	destination.SetMemorySize(usedSize);
+
+	for(size_t n = 0;n<segments.size();n++)
+	{
+		const WSABUF & buffer = segments[n]->GetBuffer();
+		destination.AddStringC(buffer.buf,buffer.len,false);
+	}
+
+	destination.SetCursor(0);
+}
+
+/**
+ * @brief Compares the cost of composing messages using Packet::operator+=() and PacketChain.
+ *
+ * Each message consists of a small header, a large static blob which is the same in every message,
+ * and a small dynamic tail.
+ *
+ * @param numMessages Number of messages to compose.
+ * @param blobSize Size of static blob in bytes.
+ */
+static void PacketChainBenchmark(size_t numMessages, size_t blobSize)
+{
+	Packet header;
+	header.AddSizeT(1);
+	header.AddSizeT(2);
+
+	Packet blob;
+	blob.SetMemorySize(blobSize);
+	blob.SetUsedSize(blobSize);
+
+	Packet tail("dynamic tail of the message");
+
+	// The static blob is copied into every message
+	DWORD startTime = GetTickCount();
+	for(size_t n = 0;n<numMessages;n++)
+	{
+		Packet message;
+		message += header;
+		message += blob;
+		message += tail;
+	}
+	DWORD packetTime = GetTickCount() - startTime;
+
+	// The static blob is stored once and shared by every message
+	NetSendPayload * blobSegment = new NetSendPayload(blob);
+
+	startTime = GetTickCount();
+	for(size_t n = 0;n<numMessages;n++)
+	{
+		PacketChain message;
+		message.Add(header);
+		message.Add(blobSegment);
+		message.Add(tail);
+	}
+	DWORD chainTime = GetTickCount() - startTime;
+
+	blobSegment->Release();
+
+	cout << " " << numMessages << " messages with a " << blobSize << " byte static blob:\n";
+	cout << "  Packet: " << packetTime << "ms\n";
+	cout << "  PacketChain: " << chainTime << "ms\n";
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool PacketChain::TestClass()
+{
+	cout << "Testing PacketChain class...\n";
+	bool problem = false;
+
+	Packet blob("static blob, ");
+	NetSendPayload * blobSegment = new NetSendPayload(blob);
+
+	PacketChain chain;
+	chain.Add(Packet("header, "));
+	chain.Add(blobSegment);
+	chain.Add(Packet());
+
+	Packet tail("tail");
+	const char * tailData = tail.GetDataPtr();
+	chain.Add(std::move(tail));
+
+	if(chain.GetSegmentAmount() != 3 || chain.GetUsedSize() != 25 || chain.GetSegment(1) != blobSegment ||
+	   blobSegment->GetReferenceCount() != 2 || chain.GetSegment(2)->GetBuffer().buf != tailData)
+	{
+		cout << "Add is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Add is good\n";
+	}
+
+	Packet flat;
+	chain.CopyInto(flat);
+	if(flat != "header, static blob, tail")
+	{
+		cout << "CopyInto is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "CopyInto is good\n";
+	}
+
+	{
+		PacketChain copy(chain);
+		copy.Add(chain);
+		if(copy.GetSegmentAmount() != 6 || copy.GetUsedSize() != 50 || blobSegment->GetReferenceCount() != 4)
+		{
+			cout << "Copy constructor is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "Copy constructor is good\n";
+		}
+	}
+
+	chain.Clear();
+	if(chain.GetSegmentAmount() != 0 || chain.GetUsedSize() != 0 || blobSegment->GetReferenceCount() != 1)
+	{
+		cout << "Clear is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Clear is good\n";
+	}
+	blobSegment->Release();
+
+	try
+	{
+		chain.GetSegment(0);
+		cout << "Bounds checking is bad\n";
+		problem = true;
+	}
+	catch(ErrorReport & error)
+	{
+		cout << "Bounds checking is good\n";
+	}
+
+	cout << "Benchmarking..\n";
+	PacketChainBenchmark(10000,64 * 1024);
+	PacketChainBenchmark(100000,1024);
+
+	cout << "\n\n";
+	return !problem;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "NetSendPayload.h"
+
+/**
+ * @brief	Packet made up of several segments, each of which is a NetSendPayload.
+ *
+ * Adding a segment never copies the data of segments that are already in the chain, so large messages can be
+ * composed from parts without the whole message being reallocated as it grows, unlike Packet::operator+=().\n\n
+ *
+ * Segments are reference counted, so data that is sent often (e.g. a cached static blob) can be stored in one
+ * NetSendPayload and added to many chains without being copied. When a chain is sent each segment becomes
+ * one element of the WSABUF array passed to WSASend (see NetSendShared), so the segments are never
+ * copied into one buffer.\n\n
+ *
+ * Copying a chain adds references to its segments instead of copying their data.\n\n
+ *
+ * This class is not thread safe, but segments can be shared by chains used by different threads.
+ */
+class PacketChain
+{
+	/** @brief Segments, this object holds a reference to each. */
+	vector<NetSendPayload*> segments;
+
+	/** @brief Total number of bytes in all segments. */
+	size_t usedSize;
+
+public:
+	PacketChain();
+	PacketChain(const PacketChain & copyMe);
+	PacketChain & operator= (const PacketChain & copyMe);
+	~PacketChain();
+
+	void Add(NetSendPayload * segment);
+	void Add(const Packet & packet);
+	void Add(Packet && packet);
+	void Add(const PacketChain & chain);
+
+	void Clear();
+
+	size_t GetUsedSize() const;
+	size_t GetSegmentAmount() const;
+	NetSendPayload * GetSegment(size_t index) const;
+
+	void CopyInto(Packet & destination) const;
+
+	static bool TestClass();
+};
@@ -0,0 +1,343 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Constructor.
+ *
+ * @param data Data to read, which must not be changed or deallocated while this object is in use.
+ * @param usedSize Number of bytes of @a data that can be read.
+ */
+PacketReader::PacketReader(const char * data, size_t usedSize)
+{
+	_ErrorException((data == NULL && usedSize > 0),"constructing a packet reader, data must not be NULL",0,__LINE__,__FILE__);
+
+	this->data = data;
+	this->usedSize = usedSize;
+	this->cursorPos = 0;
+}
+
+/**
+ * @brief Constructor.
+ *
+ * Reading starts at @a packet's cursor.
+ *
+ * @param packet Packet to read, which must not be changed or deallocated while this object is in use.
+ */
+PacketReader::PacketReader(const Packet & packet)
+{
+	packet.Enter();
+	this->data = packet.GetDataPtr();
+	this->usedSize = packet.GetUsedSize();
+	this->cursorPos = packet.GetCursor();
+	packet.Leave();
+}
+
+/**
+ * @brief Destructor.
+ */
+PacketReader::~PacketReader()
+{
+
+}
+
+/**
+ * @brief Retrieves a variable of type size_t.
+ *
+ * As with Packet::GetSizeT(), Utility::LargestSupportedBytesInt bytes are always read
+ * so that the different bit versions of the module are compatible with each other.
+ *
+ * @exception ErrorReport If retrieving data would mean exceeding the used size.
+ * @return retrieved data.
+ */
+size_t PacketReader::GetSizeT()
+{
+	_ErrorException((Utility::LargestSupportedBytesInt > GetPacketRemainder()),"getting a size_t from a packet reader. The end of the packet was reached before all data could be extracted from the packet",0,__LINE__,__FILE__);
+
+	size_t returnMe = Get<size_t>();
+
+	// Pad retrieval so that 32 bit retrieval is the same size as 64 bit retrieval
+	cursorPos += Utility::LargestSupportedBytesInt - sizeof(returnMe);
+
+	return returnMe;
+}
+
+/**
+ * @brief Retrieves a variable of type clock_t.
+ *
+ * As with Packet::GetClockT(), Utility::LargestSupportedBytesInt bytes are always read
+ * so that the different bit versions of the module are compatible with each other.
+ *
+ * @exception ErrorReport If retrieving data would mean exceeding the used size.
+ * @return retrieved data.
+ */
+clock_t PacketReader::GetClockT()
+{
+	_ErrorException((Utility::LargestSupportedBytesInt > GetPacketRemainder()),"getting a clock_t from a packet reader. The end of the packet was reached before all data could be extracted from the packet",0,__LINE__,__FILE__);
+
+	clock_t returnMe = Get<clock_t>();
+
+	// Pad retrieval so that 32 bit retrieval is the same size as 64 bit retrieval
+	cursorPos += Utility::LargestSupportedBytesInt - sizeof(returnMe);
+
+	return returnMe;
+}
+
+/**
+ * @brief Retrieves a variable of type size_t that was added as a variable length integer.
+ *
+ * The format is the same as Packet::GetVarSizeT().
+ *
+ * @exception ErrorReport If the end of the data is reached before the end of the integer.
+ * @return retrieved data.
+ */
+size_t PacketReader::GetVarSizeT()
+{
+	size_t returnMe = 0;
+	cursorPos += Packet::DecodeVarSizeT(data + cursorPos, GetPacketRemainder(), &returnMe);
+	return returnMe;
+}
+
+/**
+ * @brief Retrieves the size of a string by reading its prefix.
+ *
+ * The prefix is read at PacketReader::cursorPos, which is NOT changed;
+ * this means that you can use this command and straight away use GetStringC().
+ *
+ * @exception ErrorReport If retrieving data would mean exceeding the used size.
+ * @return the size of the string.
+ */
+size_t PacketReader::GetStringSize() const
+{
+	PacketReader prefix(*this);
+	return prefix.GetSizeT();
+}
+
+/**
+ * @brief Gets a C string, allocating memory to it and returning it.
+ *
+ * @param length Length of string to retrieve, if 0 then the string must have a prefix which indicates its length.
+ * @param nullTerminated If true return string has a null terminator appended.
+ *
+ * @exception ErrorReport If retrieving data would mean exceeding the used size.
+ * @return C string which the caller must deallocate using delete[].
+ */
+char * PacketReader::GetStringC(size_t length, bool nullTerminated)
+{
+	size_t originalCursor = cursorPos;
+
+	size_t strSize = length;
+	if(length == 0)
+	{
+		strSize = GetSizeT();
+	}
+
+	if(strSize > GetPacketRemainder())
+	{
+		cursorPos = originalCursor;
+		_ErrorException(true,"getting a C string from a packet reader, the string size is too large",strSize,__LINE__,__FILE__);
+	}
+
+	char * returnMe = NULL;
+	if(nullTerminated == true)
+	{
+		returnMe = new (nothrow) char[strSize+1];
+		Utility::DynamicAllocCheck(returnMe,__LINE__,__FILE__);
+
+		returnMe[strSize] = '\0'; // Null terminator
+	}
+	else
+	{
+		returnMe = new (nothrow) char[strSize];
+		Utility::DynamicAllocCheck(returnMe,__LINE__,__FILE__);
+	}
+
+	memcpy(returnMe,data+cursorPos,strSize);
+	cursorPos += strSize;
+
+	return returnMe;
+}
+
+/**
+ * @brief Gets a C string, copying it into the specified memory location.
+ *
+ * @warning @a destination must have enough memory to store the retrieved string, use GetStringSize() to determine
+ * how much memory is required.
+ *
+ * @param destination Pointer to memory where C string should be copied into.
+ * @param length Length of string to retrieve, if 0 then the string must have a prefix which indicates its length.
+ * @param nullTerminated If true a null terminator is appended.
+ *
+ * @exception ErrorReport If retrieving data would mean exceeding the used size.
+ */
+void PacketReader::GetStringC(char * destination, size_t length, bool nullTerminated)
+{
+	size_t originalCursor = cursorPos;
+
+	size_t strSize = length;
+	if(length == 0)
+	{
+		strSize = GetSizeT();
+	}
+
+	if(strSize > GetPacketRemainder())
+	{
+		cursorPos = originalCursor;
+		_ErrorException(true,"getting a C string from a packet reader, the string size is too large",strSize,__LINE__,__FILE__);
+	}
+
+	memcpy(destination,data+cursorPos,strSize);
+	if(nullTerminated == true)
+	{
+		destination[strSize] = '\0';
+	}
+
+	cursorPos += strSize;
+}
+
+/**
+ * @brief Retrieves the number of bytes that can be read.
+ *
+ * @return PacketReader::usedSize.
+ */
+size_t PacketReader::GetUsedSize() const
+{
+	return usedSize;
+}
+
+/**
+ * @brief Retrieves the position that the next field will be read from.
+ *
+ * @return PacketReader::cursorPos.
+ */
+size_t PacketReader::GetCursor() const
+{
+	return cursorPos;
+}
+
+/**
+ * @brief Changes the position that the next field will be read from.
+ *
+ * @exception ErrorReport If @a position is more than the used size.
+ *
+ * @param position New cursor position.
+ */
+void PacketReader::SetCursor(size_t position)
+{
+	_ErrorException((position > usedSize),"setting the cursor of a packet reader, position is out of bounds",0,__LINE__,__FILE__);
+	cursorPos = position;
+}
+
+/**
+ * @brief Retrieves the number of bytes after the cursor that have not been read.
+ *
+ * @return used size - cursor.
+ */
+size_t PacketReader::GetPacketRemainder() const
+{
+	return usedSize - cursorPos;
+}
+
+/**
+ * @brief Retrieves a pointer to the data being read.
+ *
+ * @return pointer to data.
+ */
+const char * PacketReader::GetDataPtr() const
+{
+	return data;
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool PacketReader::TestClass()
+{
+	cout << "Testing PacketReader class...\n";
+	bool problem = false;
+
+	Packet packet;
+	packet.Add<int>(50);
+	packet.AddSizeT(1234);
+	packet.AddClockT(5678);
+	packet.AddStringC("hello",0,true);
+	packet.AddStringC("world",0,false);
+	packet.AddVarSizeT(300);
+	packet.Add<double>(2.5);
+	packet.SetCursor(0);
+
+	PacketReader reader(packet);
+
+	if(reader.Get<int>() != 50 || reader.GetSizeT() != 1234 || reader.GetClockT() != 5678)
+	{
+		cout << "Get is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Get is good\n";
+	}
+
+	char * hello = NULL;
+	char world[6];
+	if(reader.GetStringSize() != 5 || reader.GetCursor() != sizeof(int) + Packet::prefixSizeBytes * 2)
+	{
+		cout << "GetStringSize is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "GetStringSize is good\n";
+	}
+
+	hello = reader.GetStringC(0,true);
+	reader.GetStringC(world,5,true);
+	if(strcmp(hello,"hello") != 0 || strcmp(world,"world") != 0 || reader.GetVarSizeT() != 300 || reader.Get<double>() != 2.5 ||
+	   reader.GetPacketRemainder() != 0)
+	{
+		cout << "GetStringC is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "GetStringC is good\n";
+	}
+	delete[] hello;
+
+	// Reads data added by PacketBuilder
+	PacketBuilder builder;
+	builder.AddSizeT(99);
+	builder.AddStringC("abc",0,true);
+
+	PacketReader builderReader(builder.GetDataPtr(),builder.GetUsedSize());
+	char abc[4];
+	builderReader.SetCursor(Packet::prefixSizeBytes);
+	builderReader.GetStringC(abc,0,true);
+	builderReader.SetCursor(0);
+	if(strcmp(abc,"abc") != 0 || builderReader.GetSizeT() != 99)
+	{
+		cout << "SetCursor is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "SetCursor is good\n";
+	}
+
+	// Bounds checking
+	try
+	{
+		reader.Get<char>();
+		cout << "Bounds checking is bad\n";
+		problem = true;
+	}
+	catch(ErrorReport & error)
+	{
+		cout << "Bounds checking is good\n";
+	}
+
+	cout << "\n\n";
+	return !problem;
+}
@@ -0,0 +1,69 @@
+#pragma once
+class Packet;
+
+/**
+ * @brief	Reads packet data without any locking, for use by a single thread.
+ *
+ * Data is read in exactly the same format as Packet::Get(), Packet::GetSizeT(), Packet::GetClockT(),
+ * Packet::GetVarSizeT() and Packet::GetStringC(), but PacketReader does not inherit from CriticalSection so reading
+ * a field costs no more than copying it.\n\n
+ *
+ * The reader does not own the data that it reads; the data must not be changed or deallocated while
+ * the reader is in use.\n\n
+ *
+ * This class is not thread safe.
+ */
+class PacketReader
+{
+	/** @brief Data being read. */
+	const char * data;
+
+	/** @brief Number of bytes of PacketReader::data that can be read. */
+	size_t usedSize;
+
+	/** @brief Position within PacketReader::data that the next field is read from. */
+	size_t cursorPos;
+
+public:
+	PacketReader(const char * data, size_t usedSize);
+	PacketReader(const Packet & packet);
+	~PacketReader();
+
+	size_t GetSizeT();
+	clock_t GetClockT();
+	size_t GetVarSizeT();
+	size_t GetStringSize() const;
+	char * GetStringC(size_t length, bool nullTerminated);
+	void GetStringC(char * destination, size_t length, bool nullTerminated);
+
+	size_t GetUsedSize() const;
+	size_t GetCursor() const;
+	void SetCursor(size_t position);
+	size_t GetPacketRemainder() const;
+	const char * GetDataPtr() const;
+
+	static bool TestClass();
+
+	/**
+	 * @brief Retrieves data of any type.
+	 *
+	 * Data is retrieved from PacketReader::cursorPos, which is moved along by the size of the data.\n\n
+	 *
+	 * C strings should not be retrieved using this method, use GetStringC() instead.
+	 *
+	 * @exception ErrorReport If retrieving data would mean exceeding the used size.
+	 * @return retrieved data.
+	 */
+	template<typename T>
+	T Get()
+	{
+		T returnMe = 0;
+
+		_ErrorException((sizeof(returnMe) > usedSize - cursorPos),"getting data from a packet reader. The end of the packet was reached before all data could be extracted from the packet",0,__LINE__,__FILE__);
+
+		memcpy(&returnMe, data + cursorPos, sizeof(returnMe));
+		cursorPos += sizeof(returnMe);
+
+		return returnMe;
+	}
+};
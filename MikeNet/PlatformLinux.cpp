@@ -0,0 +1,1073 @@
+#include "FullInclude.h"
+#ifndef _WIN32
+#include <pthread.h>
+#include <signal.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/** @brief Last winsock error of the calling thread, valid while errno is WSA_ERRNO_SENTINEL. */
+static __thread DWORD lastError = 0;
+
+/**
+ * @brief errno value indicating that the last error was set using WSASetLastError().
+ *
+ * Standard socket functions (e.g. bind, connect) report errors through errno
+ * and the emulated functions report them through WSASetLastError(). Any
+ * failure of a standard function overwrites errno, so the most recent
+ * error is always reported by WSAGetLastError().
+ */
+static const int WSA_ERRNO_SENTINEL = 0x4D4E;
+
+/**
+ * @brief Retrieves the last error that occurred in the calling thread.
+ *
+ * @return winsock error code.
+ */
+DWORD WSAGetLastError()
+{
+	if(errno == WSA_ERRNO_SENTINEL)
+	{
+		return lastError;
+	}
+	return WSATranslateErrno(errno);
+}
+
+/**
+ * @brief Sets the last error of the calling thread.
+ *
+ * @param error Winsock error code.
+ */
+void WSASetLastError(DWORD error)
+{
+	lastError = error;
+	errno = WSA_ERRNO_SENTINEL;
+}
+
+/**
+ * @brief Retrieves the last error that occurred in the calling thread.
+ *
+ * @return winsock error code.
+ */
+DWORD GetLastError()
+{
+	return WSAGetLastError();
+}
+
+/**
+ * @brief Converts an errno value into the equivalent winsock error code.
+ *
+ * @param error errno value.
+ *
+ * @return winsock error code, or @a error if there is no equivalent.
+ */
+DWORD WSATranslateErrno(int error)
+{
+	switch(error)
+	{
+	case(0):				return 0;
+	case(EAGAIN):			return WSAEWOULDBLOCK;
+	case(EINPROGRESS):		return WSAEWOULDBLOCK;
+	case(EINTR):			return WSAEINTR;
+	case(EFAULT):			return WSAEFAULT;
+	case(EINVAL):			return WSAEINVAL;
+	case(EBADF):			return WSAENOTSOCK;
+	case(ENOTSOCK):			return WSAENOTSOCK;
+	case(EMSGSIZE):			return WSAEMSGSIZE;
+	case(EADDRINUSE):		return WSAEADDRINUSE;
+	case(ENETDOWN):			return WSAENETDOWN;
+	case(ENETUNREACH):		return WSAENETUNREACH;
+	case(ECONNABORTED):		return WSAECONNABORTED;
+	case(ECONNRESET):		return WSAECONNRESET;
+	case(EPIPE):			return WSAECONNRESET;
+	case(ENOBUFS):			return WSAENOBUFS;
+	case(ENOMEM):			return WSAENOBUFS;
+	case(ENOTCONN):			return WSAENOTCONN;
+	case(ESHUTDOWN):		return WSAESHUTDOWN;
+	case(ETIMEDOUT):		return WSAETIMEDOUT;
+	case(ECONNREFUSED):		return WSAECONNREFUSED;
+	case(EHOSTUNREACH):		return WSAEHOSTUNREACH;
+	case(ECANCELED):		return WSA_OPERATION_ABORTED;
+	default:				return static_cast<DWORD>(error);
+	}
+}
+
+struct PlatformThread;
+
+/**
+ * @brief Event object, equivalent to a Win32 event.
+ */
+struct PlatformEvent
+{
+	/** @brief Protects @a signaled. */
+	pthread_mutex_t lock;
+
+	/** @brief Broadcast when the event becomes signaled. */
+	pthread_cond_t signal;
+
+	/** @brief True if the event is signaled. */
+	bool signaled;
+
+	/** @brief If false the event is reset when a single waiting thread is released. */
+	bool manualReset;
+
+	/** @brief Non NULL if this event is the handle of a thread, in which case it is signaled when the thread exits. */
+	PlatformThread * thread;
+};
+
+/**
+ * @brief Initializes an event object.
+ *
+ * @param [out] event Event to initialize.
+ * @param manualReset If false the event is automatically reset when a waiting thread is released.
+ * @param initialState Initial state of the event.
+ */
+static void InitializeEvent(PlatformEvent * event, BOOL manualReset, BOOL initialState)
+{
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr,CLOCK_MONOTONIC);
+
+	pthread_mutex_init(&event->lock,NULL);
+	pthread_cond_init(&event->signal,&attr);
+	pthread_condattr_destroy(&attr);
+
+	event->signaled = (initialState != FALSE);
+	event->manualReset = (manualReset != FALSE);
+	event->thread = NULL;
+}
+
+/**
+ * @brief Cleans up an event object initialized by InitializeEvent().
+ *
+ * @param event Event to clean up.
+ */
+static void DestroyEvent(PlatformEvent * event)
+{
+	pthread_cond_destroy(&event->signal);
+	pthread_mutex_destroy(&event->lock);
+}
+
+/**
+ * @brief Creates an event object.
+ *
+ * @param attributes Ignored.
+ * @param manualReset If false the event is automatically reset when a waiting thread is released.
+ * @param initialState Initial state of the event.
+ * @param name Ignored, named events are not supported.
+ *
+ * @return handle to event, or NULL if an error occurred.
+ */
+HANDLE CreateEvent(LPVOID /*attributes*/, BOOL manualReset, BOOL initialState, const char * /*name*/)
+{
+	PlatformEvent * event = new (nothrow) PlatformEvent();
+	if(event == NULL)
+	{
+		WSASetLastError(WSAENOBUFS);
+		return NULL;
+	}
+
+	InitializeEvent(event,manualReset,initialState);
+	return event;
+}
+
+/**
+ * @brief Signals an event, releasing waiting threads.
+ *
+ * @param handle Event to signal.
+ *
+ * @return TRUE on success.
+ */
+BOOL SetEvent(HANDLE handle)
+{
+	PlatformEvent * event = static_cast<PlatformEvent*>(handle);
+	if(event == NULL)
+	{
+		return FALSE;
+	}
+
+	pthread_mutex_lock(&event->lock);
+	event->signaled = true;
+	if(event->manualReset == true)
+	{
+		pthread_cond_broadcast(&event->signal);
+	}
+	else
+	{
+		pthread_cond_signal(&event->signal);
+	}
+	pthread_mutex_unlock(&event->lock);
+	return TRUE;
+}
+
+/**
+ * @brief Resets an event to non signaled.
+ *
+ * @param handle Event to reset.
+ *
+ * @return TRUE on success.
+ */
+BOOL ResetEvent(HANDLE handle)
+{
+	PlatformEvent * event = static_cast<PlatformEvent*>(handle);
+	if(event == NULL)
+	{
+		return FALSE;
+	}
+
+	pthread_mutex_lock(&event->lock);
+	event->signaled = false;
+	pthread_mutex_unlock(&event->lock);
+	return TRUE;
+}
+
+/**
+ * @brief Releases the lock of an event, used if a thread is cancelled while waiting on the event.
+ *
+ * @param lock Lock to release.
+ */
+static void UnlockEventMutex(void * lock)
+{
+	pthread_mutex_unlock(static_cast<pthread_mutex_t*>(lock));
+}
+
+/**
+ * @brief Waits for an event to become signaled.
+ *
+ * @param handle Event to wait on.
+ * @param milliseconds Maximum length of time to wait, may be INFINITE.
+ *
+ * @return WAIT_OBJECT_0 if the event was signaled, WAIT_TIMEOUT if it was not.
+ */
+DWORD WaitForSingleObject(HANDLE handle, DWORD milliseconds)
+{
+	PlatformEvent * event = static_cast<PlatformEvent*>(handle);
+	if(event == NULL)
+	{
+		return WAIT_FAILED;
+	}
+
+	timespec deadline;
+	if(milliseconds != INFINITE)
+	{
+		clock_gettime(CLOCK_MONOTONIC,&deadline);
+		deadline.tv_sec += milliseconds / 1000;
+		deadline.tv_nsec += (milliseconds % 1000) * 1000000;
+		if(deadline.tv_nsec >= 1000000000)
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000;
+		}
+	}
+
+	DWORD result = WAIT_OBJECT_0;
+	pthread_mutex_lock(&event->lock);
+
+	// Waiting is a cancellation point, see TerminateThread()
+	pthread_cleanup_push(&UnlockEventMutex,&event->lock);
+	while(event->signaled == false)
+	{
+		if(milliseconds == INFINITE)
+		{
+			pthread_cond_wait(&event->signal,&event->lock);
+		}
+		// Polling must not sleep, an expired deadline still waits for the timer slack.
+		else if(milliseconds == 0)
+		{
+			result = WAIT_TIMEOUT;
+			break;
+		}
+		else if(pthread_cond_timedwait(&event->signal,&event->lock,&deadline) == ETIMEDOUT)
+		{
+			result = WAIT_TIMEOUT;
+			break;
+		}
+	}
+
+	if(result == WAIT_OBJECT_0 && event->manualReset == false)
+	{
+		event->signaled = false;
+	}
+	pthread_cleanup_pop(1);
+
+	return result;
+}
+
+static void ReleaseThread(PlatformThread * thread);
+
+/**
+ * @brief Cleans up an event or thread handle.
+ *
+ * Closing the handle of a thread does not affect the thread, as on Windows.
+ *
+ * @param handle Handle to clean up.
+ *
+ * @return TRUE on success.
+ */
+BOOL CloseHandle(HANDLE handle)
+{
+	PlatformEvent * event = static_cast<PlatformEvent*>(handle);
+	if(event == NULL)
+	{
+		return FALSE;
+	}
+
+	if(event->thread != NULL)
+	{
+		ReleaseThread(event->thread);
+		return TRUE;
+	}
+
+	DestroyEvent(event);
+	delete event;
+	return TRUE;
+}
+
+/**
+ * @brief Waits on a futex word.
+ *
+ * @param address Futex word.
+ * @param value The calling thread only sleeps if @a address contains this value.
+ */
+static void FutexWait(volatile int * address, int value)
+{
+	syscall(SYS_futex,address,FUTEX_WAIT_PRIVATE,value,NULL,NULL,0);
+}
+
+/**
+ * @brief Wakes threads waiting on a futex word.
+ *
+ * @param address Futex word.
+ * @param amount Maximum number of threads to wake.
+ */
+static void FutexWake(volatile int * address, int amount)
+{
+	syscall(SYS_futex,address,FUTEX_WAKE_PRIVATE,amount,NULL,NULL,0);
+}
+
+/**
+ * @brief Initializes a critical section.
+ *
+ * @param [out] criticalSection Critical section to initialize.
+ * @param spinCount Number of iterations to spin while the critical section is owned by another
+ * thread, before sleeping.
+ *
+ * @return TRUE.
+ */
+BOOL InitializeCriticalSectionAndSpinCount(CRITICAL_SECTION * criticalSection, DWORD spinCount)
+{
+	criticalSection->state = 0;
+	criticalSection->owner = 0;
+	criticalSection->recursion = 0;
+	criticalSection->spinCount = static_cast<unsigned int>(spinCount);
+	return TRUE;
+}
+
+/**
+ * @brief Takes control of a critical section, waiting until no other thread owns it.
+ *
+ * @param criticalSection Critical section to enter.
+ */
+void EnterCriticalSection(CRITICAL_SECTION * criticalSection)
+{
+	DWORD self = GetCurrentThreadId();
+	if(criticalSection->owner == self)
+	{
+		criticalSection->recursion++;
+		return;
+	}
+
+	int state = __sync_val_compare_and_swap(&criticalSection->state,0,1);
+	for(unsigned int n = 0;state != 0 && n < criticalSection->spinCount;n++)
+	{
+		YieldProcessor();
+		if(criticalSection->state == 0)
+		{
+			state = __sync_val_compare_and_swap(&criticalSection->state,0,1);
+		}
+	}
+
+	// Mark the critical section as contended, so that Leave wakes a sleeping thread
+	if(state != 0)
+	{
+		if(state != 2)
+		{
+			state = __sync_lock_test_and_set(&criticalSection->state,2);
+		}
+
+		while(state != 0)
+		{
+			FutexWait(&criticalSection->state,2);
+			state = __sync_lock_test_and_set(&criticalSection->state,2);
+		}
+	}
+
+	criticalSection->owner = self;
+	criticalSection->recursion = 1;
+}
+
+/**
+ * @brief Releases control of a critical section.
+ *
+ * @param criticalSection Critical section to leave, must be owned by the calling thread.
+ */
+void LeaveCriticalSection(CRITICAL_SECTION * criticalSection)
+{
+	criticalSection->recursion--;
+	if(criticalSection->recursion > 0)
+	{
+		return;
+	}
+
+	criticalSection->owner = 0;
+	if(__sync_fetch_and_sub(&criticalSection->state,1) != 1)
+	{
+		__sync_lock_release(&criticalSection->state);
+		FutexWake(&criticalSection->state,1);
+	}
+}
+
+/**
+ * @brief Cleans up a critical section, nothing needs to be deallocated.
+ *
+ * @param criticalSection Critical section to clean up.
+ */
+void DeleteCriticalSection(CRITICAL_SECTION * /*criticalSection*/)
+{
+}
+
+/**
+ * @brief Thread, equivalent to a Win32 thread.
+ *
+ * Threads are created detached, they are joined by waiting on PlatformThread::exited.
+ * Suspending a running thread sends it PlatformThreadSuspendSignal(), whose handler sleeps
+ * until the thread is resumed.
+ */
+struct PlatformThread
+{
+	/** @brief Handle of thread, must be the first member so that a handle is also a PlatformEvent. */
+	PlatformEvent exited;
+
+	/** @brief POSIX thread. */
+	pthread_t thread;
+
+	/** @brief Entry point of thread. */
+	LPTHREAD_START_ROUTINE function;
+
+	/** @brief Parameter passed to PlatformThread::function. */
+	LPVOID parameter;
+
+	/** @brief Exit code of thread, STILL_ACTIVE while the thread is running. */
+	volatile DWORD exitCode;
+
+	/** @brief Kernel thread ID. */
+	volatile DWORD threadID;
+
+	/** @brief Futex word, set to 1 once PlatformThread::threadID is filled. */
+	volatile int ready;
+
+	/** @brief Futex word, the thread sleeps while this is more than 0. */
+	volatile int suspendCount;
+
+	/** @brief Set to 1 once the thread may need a signal to be suspended. */
+	volatile int started;
+
+	/** @brief Futex word, set to 1 by the thread once it has been suspended by a signal. */
+	volatile int suspendAcknowledged;
+
+	/** @brief Number of users of this object (the handle and the thread itself). */
+	volatile LONG references;
+};
+
+/** @brief Thread object of calling thread, NULL if the thread was not created using CreateThread. */
+static __thread PlatformThread * currentThread = NULL;
+
+/** @brief Ensures that the suspend signal handler is installed once. */
+static pthread_once_t suspendHandlerInstalled = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Retrieves the signal used to suspend threads.
+ *
+ * @return signal number.
+ */
+static int PlatformThreadSuspendSignal()
+{
+	return SIGRTMIN + 2;
+}
+
+/**
+ * @brief Deallocates a thread object when its last user releases it.
+ *
+ * @param thread Thread to release.
+ */
+static void ReleaseThread(PlatformThread * thread)
+{
+	if(InterlockedDecrement(&thread->references) == 0)
+	{
+		DestroyEvent(&thread->exited);
+		delete thread;
+	}
+}
+
+/**
+ * @brief Sleeps while a thread is suspended.
+ *
+ * @param thread Calling thread.
+ */
+static void WaitWhileSuspended(PlatformThread * thread)
+{
+	int count;
+	while((count = thread->suspendCount) > 0)
+	{
+		FutexWait(&thread->suspendCount,count);
+	}
+}
+
+/**
+ * @brief Handles the suspend signal, sleeping until the thread is resumed.
+ *
+ * Only futex system calls are made, which are async signal safe.
+ *
+ * @param signalNumber Ignored.
+ */
+static void PlatformThreadSuspendHandler(int /*signalNumber*/)
+{
+	int savedErrno = errno;
+	PlatformThread * thread = currentThread;
+	if(thread != NULL)
+	{
+		thread->suspendAcknowledged = 1;
+		FutexWake(&thread->suspendAcknowledged,INT_MAX);
+		WaitWhileSuspended(thread);
+	}
+	errno = savedErrno;
+}
+
+/**
+ * @brief Installs PlatformThreadSuspendHandler().
+ */
+static void InstallSuspendHandler()
+{
+	struct sigaction action;
+	memset(&action,0,sizeof(action));
+	action.sa_handler = &PlatformThreadSuspendHandler;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	sigaction(PlatformThreadSuspendSignal(),&action,NULL);
+}
+
+/**
+ * @brief Signals that a thread has exited, run when the thread returns or is cancelled.
+ *
+ * @param parameter Thread that exited.
+ */
+static void PlatformThreadExit(void * parameter)
+{
+	PlatformThread * thread = static_cast<PlatformThread*>(parameter);
+	SetEvent(&thread->exited);
+	ReleaseThread(thread);
+}
+
+/**
+ * @brief Entry point of threads created by CreateThread().
+ *
+ * @param parameter PlatformThread object of thread.
+ *
+ * @return NULL.
+ */
+static void * PlatformThreadStart(void * parameter)
+{
+	PlatformThread * thread = static_cast<PlatformThread*>(parameter);
+	currentThread = thread;
+
+	thread->threadID = GetCurrentThreadId();
+	__sync_lock_test_and_set(&thread->ready,1);
+	FutexWake(&thread->ready,INT_MAX);
+
+	// Must be visible before suspendCount is read, so that SuspendThread either sees that
+	// a signal is needed or leaves suspendCount for this thread to see.
+	__sync_lock_test_and_set(&thread->started,1);
+	__sync_synchronize();
+	WaitWhileSuspended(thread);
+
+	pthread_cleanup_push(&PlatformThreadExit,thread);
+	DWORD exitCode = thread->function(thread->parameter);
+	__sync_val_compare_and_swap(&thread->exitCode,static_cast<DWORD>(STILL_ACTIVE),exitCode);
+	pthread_cleanup_pop(1);
+
+	return NULL;
+}
+
+/**
+ * @brief Creates a thread.
+ *
+ * @param attributes Ignored.
+ * @param stackSize Size of stack in bytes, 0 to use the default.
+ * @param function Entry point of thread.
+ * @param parameter Parameter passed to @a function.
+ * @param creationFlags CREATE_SUSPENDED if the thread should not run until ResumeThread() is used, otherwise 0.
+ * @param [out] threadID Filled with ID of thread, may be NULL.
+ *
+ * @return handle to thread, or NULL if an error occurred.
+ */
+HANDLE CreateThread(LPVOID /*attributes*/, size_t stackSize, LPTHREAD_START_ROUTINE function, LPVOID parameter, DWORD creationFlags, DWORD * threadID)
+{
+	pthread_once(&suspendHandlerInstalled,&InstallSuspendHandler);
+
+	PlatformThread * thread = new (nothrow) PlatformThread();
+	if(thread == NULL)
+	{
+		WSASetLastError(WSAENOBUFS);
+		return NULL;
+	}
+
+	InitializeEvent(&thread->exited,TRUE,FALSE);
+	thread->exited.thread = thread;
+	thread->function = function;
+	thread->parameter = parameter;
+	thread->exitCode = STILL_ACTIVE;
+	thread->threadID = 0;
+	thread->ready = 0;
+	thread->suspendCount = ((creationFlags & CREATE_SUSPENDED) != 0) ? 1 : 0;
+	thread->started = 0;
+	thread->suspendAcknowledged = 0;
+	thread->references = 2;
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr,PTHREAD_CREATE_DETACHED);
+	if(stackSize > 0)
+	{
+		pthread_attr_setstacksize(&attr,(stackSize < static_cast<size_t>(PTHREAD_STACK_MIN)) ? static_cast<size_t>(PTHREAD_STACK_MIN) : stackSize);
+	}
+
+	int result = pthread_create(&thread->thread,&attr,&PlatformThreadStart,thread);
+	pthread_attr_destroy(&attr);
+	if(result != 0)
+	{
+		DestroyEvent(&thread->exited);
+		delete thread;
+		WSASetLastError(WSATranslateErrno(result));
+		return NULL;
+	}
+
+	// Thread ID is only known once the thread is running
+	while(thread->ready == 0)
+	{
+		FutexWait(&thread->ready,0);
+	}
+
+	if(threadID != NULL)
+	{
+		*threadID = thread->threadID;
+	}
+	return &thread->exited;
+}
+
+/**
+ * @brief Decrements the suspend count of a thread, the thread runs when it reaches 0.
+ *
+ * @param handle Thread to resume.
+ *
+ * @return previous suspend count.
+ */
+DWORD ResumeThread(HANDLE handle)
+{
+	PlatformThread * thread = static_cast<PlatformEvent*>(handle)->thread;
+
+	int count;
+	do
+	{
+		count = thread->suspendCount;
+		if(count == 0)
+		{
+			return 0;
+		}
+	}
+	while(__sync_val_compare_and_swap(&thread->suspendCount,count,count - 1) != count);
+
+	if(count == 1)
+	{
+		FutexWake(&thread->suspendCount,INT_MAX);
+	}
+	return static_cast<DWORD>(count);
+}
+
+/**
+ * @brief Increments the suspend count of a thread, suspending it.
+ *
+ * Unlike on Windows the thread is suspended before this function returns. A thread that is blocked
+ * in a system call is suspended when the signal interrupts it, and the call is restarted when the
+ * thread is resumed.
+ *
+ * @param handle Thread to suspend.
+ *
+ * @return previous suspend count.
+ */
+DWORD SuspendThread(HANDLE handle)
+{
+	PlatformThread * thread = static_cast<PlatformEvent*>(handle)->thread;
+
+	if(thread == currentThread)
+	{
+		DWORD previous = static_cast<DWORD>(__sync_fetch_and_add(&thread->suspendCount,1));
+		WaitWhileSuspended(thread);
+		return previous;
+	}
+
+	// Holding the lock prevents the thread from exiting, after which it could not be signaled
+	pthread_mutex_lock(&thread->exited.lock);
+
+	int previous = __sync_fetch_and_add(&thread->suspendCount,1);
+	if(previous == 0 && thread->started == 1 && thread->exited.signaled == false)
+	{
+		thread->suspendAcknowledged = 0;
+		pthread_kill(thread->thread,PlatformThreadSuspendSignal());
+
+		while(thread->suspendAcknowledged == 0)
+		{
+			FutexWait(&thread->suspendAcknowledged,0);
+		}
+	}
+
+	pthread_mutex_unlock(&thread->exited.lock);
+	return static_cast<DWORD>(previous);
+}
+
+/**
+ * @brief Forces a thread to exit.
+ *
+ * The thread is cancelled, so it exits at its next cancellation point (e.g. Sleep() or a blocking
+ * system call) and its stack is unwound. As on Windows this should be avoided where possible.
+ *
+ * @param handle Thread to terminate.
+ * @param exitCode Exit code that the thread should have.
+ *
+ * @return TRUE on success.
+ */
+BOOL TerminateThread(HANDLE handle, DWORD exitCode)
+{
+	PlatformThread * thread = static_cast<PlatformEvent*>(handle)->thread;
+
+	pthread_mutex_lock(&thread->exited.lock);
+	if(thread->exited.signaled == false)
+	{
+		__sync_val_compare_and_swap(&thread->exitCode,static_cast<DWORD>(STILL_ACTIVE),exitCode);
+		pthread_cancel(thread->thread);
+	}
+	pthread_mutex_unlock(&thread->exited.lock);
+
+	// A suspended thread must run to reach a cancellation point
+	while(ResumeThread(handle) > 1);
+	return TRUE;
+}
+
+/**
+ * @brief Retrieves the exit code of a thread.
+ *
+ * @param handle Thread.
+ * @param [out] exitCode Filled with exit code, or STILL_ACTIVE if the thread is running.
+ *
+ * @return TRUE on success.
+ */
+BOOL GetExitCodeThread(HANDLE handle, DWORD * exitCode)
+{
+	*exitCode = static_cast<PlatformEvent*>(handle)->thread->exitCode;
+	return TRUE;
+}
+
+/**
+ * @brief Retrieves the kernel thread ID of the calling thread.
+ *
+ * @return thread ID.
+ */
+DWORD GetCurrentThreadId()
+{
+	static __thread DWORD threadID = 0;
+	if(threadID == 0)
+	{
+		threadID = static_cast<DWORD>(syscall(SYS_gettid));
+	}
+	return threadID;
+}
+
+/**
+ * @brief Allocates a thread local storage index.
+ *
+ * @return index, or TLS_OUT_OF_INDEXES if an error occurred.
+ */
+DWORD TlsAlloc()
+{
+	pthread_key_t key;
+	int result = pthread_key_create(&key,NULL);
+	if(result != 0)
+	{
+		WSASetLastError(WSATranslateErrno(result));
+		return TLS_OUT_OF_INDEXES;
+	}
+	return static_cast<DWORD>(key);
+}
+
+/**
+ * @brief Deallocates a thread local storage index.
+ *
+ * @param index Index allocated by TlsAlloc().
+ *
+ * @return TRUE on success.
+ */
+BOOL TlsFree(DWORD index)
+{
+	return pthread_key_delete(static_cast<pthread_key_t>(index)) == 0;
+}
+
+/**
+ * @brief Retrieves the value stored by the calling thread at a thread local storage index.
+ *
+ * As on Windows the last error is cleared, so that a stored value of NULL can be distinguished from an error.
+ *
+ * @param index Index allocated by TlsAlloc().
+ *
+ * @return stored value, NULL if no value is stored.
+ */
+LPVOID TlsGetValue(DWORD index)
+{
+	WSASetLastError(ERROR_SUCCESS);
+	return pthread_getspecific(static_cast<pthread_key_t>(index));
+}
+
+/**
+ * @brief Stores a value for the calling thread at a thread local storage index.
+ *
+ * @param index Index allocated by TlsAlloc().
+ * @param value Value to store.
+ *
+ * @return TRUE on success.
+ */
+BOOL TlsSetValue(DWORD index, LPVOID value)
+{
+	int result = pthread_setspecific(static_cast<pthread_key_t>(index),value);
+	if(result != 0)
+	{
+		WSASetLastError(WSATranslateErrno(result));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * @brief Retrieves information about the system.
+ *
+ * @param [out] systemInfo Filled with information.
+ */
+void GetNativeSystemInfo(SYSTEM_INFO * systemInfo)
+{
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	systemInfo->dwNumberOfProcessors = (processors > 0) ? static_cast<DWORD>(processors) : 1;
+}
+
+/**
+ * @brief Suspends the calling thread.
+ *
+ * @param milliseconds Length of time to sleep for.
+ */
+void Sleep(DWORD milliseconds)
+{
+	timespec length;
+	length.tv_sec = milliseconds / 1000;
+	length.tv_nsec = (milliseconds % 1000) * 1000000;
+	while(nanosleep(&length,&length) == -1 && errno == EINTR);
+}
+
+/**
+ * @brief Retrieves the number of milliseconds elapsed since an arbitrary fixed point.
+ *
+ * Unlike clock() on Linux this measures wall time, not processor time.
+ *
+ * @return number of milliseconds.
+ */
+DWORD GetTickCount()
+{
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC,&now);
+	return static_cast<DWORD>(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+/**
+ * @brief Creates a socket.
+ *
+ * Sockets are always non blocking because overlapped operations
+ * are emulated using readiness notifications.
+ *
+ * @param family Address family.
+ * @param type Socket type.
+ * @param protocol Protocol.
+ * @param protocolInfo Ignored.
+ * @param group Ignored.
+ * @param flags Ignored, all sockets support overlapped operations.
+ *
+ * @return new socket, or INVALID_SOCKET if an error occurred.
+ */
+SOCKET WSASocket(int family, int type, int protocol, LPVOID /*protocolInfo*/, unsigned int /*group*/, DWORD /*flags*/)
+{
+	SOCKET returnMe = socket(family,type | SOCK_NONBLOCK | SOCK_CLOEXEC,protocol);
+	if(returnMe == INVALID_SOCKET)
+	{
+		WSASetLastError(WSATranslateErrno(errno));
+	}
+	return returnMe;
+}
+
+/**
+ * @brief Accepts a pending connection.
+ *
+ * Connections cannot be rejected before they are accepted on Linux, so the
+ * connection is accepted and then immediately closed if @a condition returns
+ * CF_REJECT. The connecting peer sees a reset instead of a refusal.
+ *
+ * @param socket Listening socket.
+ * @param [out] address Address of connecting peer.
+ * @param [in,out] addressLength Length of @a address.
+ * @param condition Function that decides whether to accept the connection, may be NULL.
+ * @param callbackData Passed to @a condition.
+ *
+ * @return new socket, or INVALID_SOCKET if no connection was accepted.
+ * WSAGetLastError() returns WSAECONNREFUSED if @a condition rejected the connection.
+ */
+SOCKET WSAAccept(SOCKET socket, SOCKADDR * address, int * addressLength, LPCONDITIONPROC condition, DWORD_PTR callbackData)
+{
+	socklen_t length = static_cast<socklen_t>(*addressLength);
+	SOCKET returnMe = accept4(socket,address,&length,SOCK_NONBLOCK | SOCK_CLOEXEC);
+	if(returnMe == INVALID_SOCKET)
+	{
+		WSASetLastError(WSATranslateErrno(errno));
+		return INVALID_SOCKET;
+	}
+	*addressLength = static_cast<int>(length);
+
+	if(condition != NULL && condition(NULL,NULL,NULL,NULL,NULL,NULL,NULL,callbackData) == CF_REJECT)
+	{
+		linger hardClose;
+		hardClose.l_onoff = 1;
+		hardClose.l_linger = 0;
+		setsockopt(returnMe,SOL_SOCKET,SO_LINGER,&hardClose,sizeof(hardClose));
+		close(returnMe);
+
+		WSASetLastError(WSAECONNREFUSED);
+		return INVALID_SOCKET;
+	}
+
+	return returnMe;
+}
+
+/**
+ * @brief Enables or disables UDP receive coalescing (UDP GRO).
+ *
+ * When enabled the kernel may merge consecutive datagrams from the same source into one
+ * message, which WSARecvFromBatch reports using WSABATCHMSG::segmentSize. Messages can then be
+ * up to 65535 bytes long regardless of datagram size, so buffers should be that large.
+ *
+ * @param socket Datagram socket.
+ * @param enable TRUE to enable coalescing, FALSE to disable it.
+ *
+ * @return 0 if successful, SOCKET_ERROR if not (e.g. not supported by the kernel).
+ */
+int WSASetRecvCoalescing(SOCKET socket, BOOL enable)
+{
+	int option = enable ? 1 : 0;
+	if(setsockopt(socket,SOL_UDP,UDP_GRO,&option,sizeof(option)) == -1)
+	{
+		WSASetLastError(WSATranslateErrno(errno));
+		return SOCKET_ERROR;
+	}
+	return 0;
+}
+
+/**
+ * @brief Sends several datagrams, each to its own destination, using as few sendmmsg calls as possible.
+ *
+ * The operation is not overlapped: datagrams are handed to the kernel before the function returns
+ * and no completion status is queued. If the socket's send buffer is full the function stops early,
+ * and the remaining datagrams should be sent using WSASendTo.\n\n
+ *
+ * A failure that affects only one datagram (e.g. unreachable destination) is stored in
+ * WSABATCHSENDMSG::error and the remaining datagrams are still sent.
+ *
+ * @param socket Datagram socket.
+ * @param messages Datagrams to send.
+ * @param messageCount Number of elements in @a messages.
+ * @param [out] messagesSent Filled with number of elements of @a messages that were dealt with,
+ * those that failed are included.
+ *
+ * @return 0 if successful, SOCKET_ERROR if not.
+ */
+int WSASendToBatch(SOCKET socket, WSABATCHSENDMSG * messages, DWORD messageCount, DWORD * messagesSent)
+{
+	if(messages == NULL || messagesSent == NULL)
+	{
+		WSASetLastError(WSAEFAULT);
+		return SOCKET_ERROR;
+	}
+
+	mmsghdr headers[WSA_MAX_SEND_BATCH];
+	DWORD sent = 0;
+	while(sent < messageCount)
+	{
+		DWORD amount = messageCount - sent;
+		if(amount > WSA_MAX_SEND_BATCH)
+		{
+			amount = WSA_MAX_SEND_BATCH;
+		}
+
+		memset(headers,0,sizeof(mmsghdr) * amount);
+		for(DWORD n = 0;n<amount;n++)
+		{
+			WSABATCHSENDMSG & message = messages[sent+n];
+			message.bytes = 0;
+			message.error = 0;
+
+			headers[n].msg_hdr.msg_iov = reinterpret_cast<iovec*>(message.buffers);
+			headers[n].msg_hdr.msg_iovlen = message.bufferCount;
+			headers[n].msg_hdr.msg_name = const_cast<SOCKADDR*>(message.to);
+			headers[n].msg_hdr.msg_namelen = static_cast<socklen_t>(message.toLength);
+		}
+
+		int result = sendmmsg(socket,headers,amount,MSG_DONTWAIT | MSG_NOSIGNAL);
+		if(result == -1)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			// Send buffer is full, leave remaining datagrams to caller
+			if(errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				break;
+			}
+
+			// The first datagram failed, skip it and continue with the rest
+			if(errno != EBADF && errno != ENOTSOCK && errno != EFAULT)
+			{
+				messages[sent].error = WSATranslateErrno(errno);
+				sent++;
+				continue;
+			}
+
+			*messagesSent = sent;
+			WSASetLastError(WSATranslateErrno(errno));
+			return SOCKET_ERROR;
+		}
+
+		for(int n = 0;n<result;n++)
+		{
+			messages[sent+n].bytes = headers[n].msg_len;
+		}
+		sent += result;
+	}
+
+	*messagesSent = sent;
+	return 0;
+}
+
+#endif
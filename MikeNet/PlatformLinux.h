@@ -0,0 +1,456 @@
+#pragma once
+#ifndef _WIN32
+/**
+ * @file PlatformLinux.h
+ * @brief Definitions of the subset of the Win32 and winsock API used by the networking
+ * module, so that it can be compiled on Linux.
+ *
+ * Overlapped socket operations (WSARecv, WSARecvFrom, WSASend and WSASendTo) are
+ * emulated by the epoll completion engine in CompletionPortEpoll.cpp, or by the io_uring
+ * completion engine in CompletionPortUring.cpp if MIKENET_IO_URING is defined. The engine queues
+ * completion status' to the CompletionPort that the socket is associated with in
+ * the same way that an I/O completion port would. This means that NetManageCompletionPort
+ * and the instance classes are unchanged on Linux.
+ *
+ * WSARecvFromBatch and WSASetRecvCoalescing have no winsock equivalent. They receive
+ * several datagrams with one recvmmsg call, optionally coalesced by UDP GRO.
+ * WSASendToBatch sends a datagram to each of several destinations with sendmmsg.
+ */
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Basic Win32 types
+typedef unsigned short WORD;
+typedef unsigned long DWORD;
+#define __int64 long long
+typedef long long LONGLONG;
+typedef unsigned long long ULONGLONG;
+typedef int BOOL;
+typedef unsigned long ULONG;
+typedef long LONG;
+typedef unsigned long u_long;
+typedef unsigned short ADDRESS_FAMILY;
+typedef uintptr_t ULONG_PTR;
+typedef uintptr_t DWORD_PTR;
+typedef intptr_t INT_PTR;
+typedef void * HANDLE;
+typedef void * LPVOID;
+typedef int SOCKET;
+typedef struct sockaddr SOCKADDR;
+typedef DWORD (*LPTHREAD_START_ROUTINE)(LPVOID lpParameter);
+
+#define WINAPI
+#define CALLBACK
+#define IN
+#define OUT
+#define FAR
+#define TRUE 1
+#define FALSE 0
+#define INFINITE 0xFFFFFFFF
+#define INVALID_HANDLE_VALUE ((HANDLE)(INT_PTR)-1)
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR (-1)
+#define WAIT_OBJECT_0 0
+#define WAIT_TIMEOUT 258
+#define WAIT_FAILED 0xFFFFFFFF
+#define STILL_ACTIVE 259
+#define ERROR_SUCCESS 0
+#define ERROR_NETNAME_DELETED 64
+#define ERROR_PORT_UNREACHABLE 1234
+#define CREATE_SUSPENDED 0x00000004
+#define TLS_OUT_OF_INDEXES ((DWORD)0xFFFFFFFF)
+#define SD_SEND SHUT_WR
+#define WSA_FLAG_OVERLAPPED 0x01
+#define FD_CLOSE 0x20
+#define CF_ACCEPT 0x0000
+#define CF_REJECT 0x0001
+#define ZeroMemory(destination,length) memset((destination),0,(length))
+#define SecureZeroMemory(destination,length) memset((destination),0,(length))
+#define ioctlsocket ioctl
+
+// Winsock error codes, values are identical to those on Windows
+#define WSA_OPERATION_ABORTED 995
+#define WSA_IO_PENDING 997
+#define WSAEINTR 10004
+#define WSAEFAULT 10014
+#define WSAEINVAL 10022
+#define WSAEWOULDBLOCK 10035
+#define WSAENOTSOCK 10038
+#define WSAEMSGSIZE 10040
+#define WSAEADDRINUSE 10048
+#define WSAENETDOWN 10050
+#define WSAENETUNREACH 10051
+#define WSAECONNABORTED 10053
+#define WSAECONNRESET 10054
+#define WSAENOBUFS 10055
+#define WSAENOTCONN 10057
+#define WSAESHUTDOWN 10058
+#define WSAETIMEDOUT 10060
+#define WSAECONNREFUSED 10061
+#define WSAEHOSTUNREACH 10065
+
+/**
+ * @brief Buffer passed to overlapped socket operations.
+ *
+ * Layout is compatible with struct iovec so that an array of WSABUF
+ * can be passed directly to sendmsg and recvmsg.
+ */
+struct WSABUF
+{
+	/** @brief Pointer to buffer. */
+	char * buf;
+
+	/** @brief Length of buffer in bytes. */
+	ULONG len;
+};
+typedef WSABUF * LPWSABUF;
+
+/**
+ * @brief Identifies an overlapped operation.
+ *
+ * The completion engine signals @a hEvent when the operation completes,
+ * and resets it when the operation begins, as winsock does.
+ */
+struct WSAOVERLAPPED
+{
+	ULONG_PTR Internal;
+	ULONG_PTR InternalHigh;
+	DWORD Offset;
+	DWORD OffsetHigh;
+	LPVOID Pointer;
+	HANDLE hEvent;
+};
+typedef WSAOVERLAPPED OVERLAPPED;
+typedef WSAOVERLAPPED * LPWSAOVERLAPPED;
+typedef WSAOVERLAPPED * LPOVERLAPPED;
+typedef unsigned int GROUP;
+typedef void * LPQOS;
+typedef int (*LPCONDITIONPROC)(LPWSABUF callerID, LPWSABUF callerData, LPQOS sqos, LPQOS gqos, LPWSABUF calleeID, LPWSABUF calleeData, GROUP * g, DWORD_PTR callbackData);
+typedef void (*LPWSAOVERLAPPED_COMPLETION_ROUTINE)(DWORD error, DWORD bytes, LPWSAOVERLAPPED overlapped, DWORD flags);
+
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+/** @brief Maximum number of messages that may be passed to WSARecvFromBatch. */
+#define WSA_MAX_RECV_BATCH 64
+
+/** @brief Number of messages passed to each sendmmsg call by WSASendToBatch. */
+#define WSA_MAX_SEND_BATCH 64
+
+/**
+ * @brief One message of a batched receive operation, see WSARecvFromBatch.
+ */
+struct WSABATCHMSG
+{
+	/** @brief Buffer that the message is received into. */
+	WSABUF buffer;
+
+	/** @brief Filled with address that the message was received from, may be NULL. */
+	SOCKADDR * from;
+
+	/** @brief Length of WSABATCHMSG::from, updated when the message is received. */
+	int fromLength;
+
+	/** @brief Filled with number of bytes received. */
+	DWORD bytes;
+
+	/**
+	 * @brief Filled with size of each datagram if UDP receive coalescing merged several
+	 * datagrams from the same source into WSABATCHMSG::buffer, 0 if the message is one datagram.
+	 *
+	 * The last datagram may be smaller.
+	 */
+	DWORD segmentSize;
+
+	/** @brief Filled with WSAEMSGSIZE if the message was larger than WSABATCHMSG::buffer, 0 if not. */
+	DWORD error;
+};
+
+/**
+ * @brief One datagram of a batched send operation, see WSASendToBatch.
+ */
+struct WSABATCHSENDMSG
+{
+	/** @brief Array of buffers, the datagram consists of a combination of all elements. */
+	LPWSABUF buffers;
+
+	/** @brief Number of elements in WSABATCHSENDMSG::buffers. */
+	DWORD bufferCount;
+
+	/** @brief Address to send to, if NULL the datagram is sent to the address that the socket is connected to. */
+	const SOCKADDR * to;
+
+	/** @brief Length of WSABATCHSENDMSG::to. */
+	int toLength;
+
+	/** @brief Filled with number of bytes sent. */
+	DWORD bytes;
+
+	/** @brief Filled with winsock error code if this datagram could not be sent, 0 if not. */
+	DWORD error;
+};
+
+// Error handling
+DWORD WSAGetLastError();
+void WSASetLastError(DWORD error);
+DWORD GetLastError();
+DWORD WSATranslateErrno(int error);
+
+// Events, used by ConcurrencyEvent and signaled by the completion engine
+HANDLE CreateEvent(LPVOID attributes, BOOL manualReset, BOOL initialState, const char * name);
+BOOL SetEvent(HANDLE event);
+BOOL ResetEvent(HANDLE event);
+DWORD WaitForSingleObject(HANDLE event, DWORD milliseconds);
+BOOL CloseHandle(HANDLE event);
+
+/**
+ * @brief Critical section, equivalent to a Win32 critical section.
+ *
+ * Uncontended Enter and Leave are a single atomic operation each, a thread
+ * only sleeps (on a futex) after spinning for CRITICAL_SECTION::spinCount iterations.
+ * Critical sections are recursive, as they are on Windows.
+ */
+struct CRITICAL_SECTION
+{
+	/** @brief Futex word, 0 if unlocked, 1 if locked, 2 if locked and other threads may be sleeping. */
+	volatile int state;
+
+	/** @brief Kernel thread ID of the thread that owns the critical section, 0 if not owned. */
+	volatile DWORD owner;
+
+	/** @brief Number of times the owner has entered the critical section. */
+	unsigned int recursion;
+
+	/** @brief Number of iterations to spin before sleeping. */
+	unsigned int spinCount;
+};
+
+// Critical sections, used by CriticalSection
+BOOL InitializeCriticalSectionAndSpinCount(CRITICAL_SECTION * criticalSection, DWORD spinCount);
+void EnterCriticalSection(CRITICAL_SECTION * criticalSection);
+void LeaveCriticalSection(CRITICAL_SECTION * criticalSection);
+void DeleteCriticalSection(CRITICAL_SECTION * criticalSection);
+
+// Threads, used by ThreadSingle. Handles can be waited on using WaitForSingleObject, which returns when the thread exits.
+HANDLE CreateThread(LPVOID attributes, size_t stackSize, LPTHREAD_START_ROUTINE function, LPVOID parameter, DWORD creationFlags, DWORD * threadID);
+DWORD ResumeThread(HANDLE thread);
+DWORD SuspendThread(HANDLE thread);
+BOOL TerminateThread(HANDLE thread, DWORD exitCode);
+BOOL GetExitCodeThread(HANDLE thread, DWORD * exitCode);
+DWORD GetCurrentThreadId();
+
+// Thread local storage
+DWORD TlsAlloc();
+BOOL TlsFree(DWORD index);
+LPVOID TlsGetValue(DWORD index);
+BOOL TlsSetValue(DWORD index, LPVOID value);
+
+/**
+ * @brief Information about the system, only the number of processors is filled.
+ */
+struct SYSTEM_INFO
+{
+	/** @brief Number of logical processors. */
+	DWORD dwNumberOfProcessors;
+};
+void GetNativeSystemInfo(SYSTEM_INFO * systemInfo);
+
+// Atomic operations
+inline LONG InterlockedIncrement(volatile LONG * value) { return __sync_add_and_fetch(value,1); }
+inline LONG InterlockedDecrement(volatile LONG * value) { return __sync_sub_and_fetch(value,1); }
+inline LONG InterlockedExchange(volatile LONG * target, LONG value) { __sync_synchronize(); return __sync_lock_test_and_set(target,value); }
+inline LONG InterlockedCompareExchange(volatile LONG * destination, LONG exchange, LONG comparand) { return __sync_val_compare_and_swap(destination,comparand,exchange); }
+inline LONGLONG InterlockedIncrement64(volatile LONGLONG * value) { return __sync_add_and_fetch(value,1); }
+inline void MemoryBarrier() { __sync_synchronize(); }
+inline void YieldProcessor()
+{
+#if defined(__i386__) || defined(__x86_64__)
+	__builtin_ia32_pause();
+#endif
+}
+
+// Lock free lists, used by MemoryRecyclePacket and MemoryRecycleSlab
+#define MEMORY_ALLOCATION_ALIGNMENT 16
+
+/**
+ * @brief Entry of a lock free list, equivalent to a Win32 SLIST_ENTRY.
+ */
+struct SLIST_ENTRY
+{
+	/** @brief Next entry in the list, NULL if this is the last entry. */
+	SLIST_ENTRY * Next;
+};
+typedef SLIST_ENTRY * PSLIST_ENTRY;
+
+/**
+ * @brief Head of a lock free list (a Treiber stack), equivalent to a Win32 SLIST_HEADER.
+ *
+ * The first entry is swapped together with a tag that changes on every push and pop, using a
+ * 16 byte compare and swap (cmpxchg16b, so -mcx16 is required on x86-64). A pop therefore fails
+ * if the list changed after it read the first entry, even if the same entry is first again (ABA).
+ *
+ * A pop reads the first entry's SLIST_ENTRY::Next, which another thread may have popped in the
+ * meantime. Windows tolerates that entry having been deallocated, this emulation does not, so
+ * entries must remain allocated while the list exists.
+ */
+union SLIST_HEADER
+{
+	struct
+	{
+		/** @brief First entry of the list, NULL if the list is empty. */
+		PSLIST_ENTRY first;
+
+		/** @brief Increased by every push and pop. */
+		unsigned long long tag;
+	} fields;
+
+	/** @brief SLIST_HEADER::fields as a single value, for compare and swap. */
+	unsigned __int128 value;
+} __attribute__((aligned(16)));
+typedef SLIST_HEADER * PSLIST_HEADER;
+
+inline void InitializeSListHead(PSLIST_HEADER head)
+{
+	head->fields.first = NULL;
+	head->fields.tag = 0;
+}
+
+inline PSLIST_ENTRY InterlockedPushEntrySList(PSLIST_HEADER head, PSLIST_ENTRY entry)
+{
+	// May be read in two halves, the compare and swap fails if they do not match
+	SLIST_HEADER expected;
+	expected.value = head->value;
+
+	for(;;)
+	{
+		SLIST_HEADER desired;
+		entry->Next = expected.fields.first;
+		desired.fields.first = entry;
+		desired.fields.tag = expected.fields.tag + 1;
+
+		unsigned __int128 previous = __sync_val_compare_and_swap(&head->value,expected.value,desired.value);
+		if(previous == expected.value)
+		{
+			return expected.fields.first;
+		}
+		expected.value = previous;
+	}
+}
+
+inline PSLIST_ENTRY InterlockedPopEntrySList(PSLIST_HEADER head)
+{
+	SLIST_HEADER expected;
+	expected.value = head->value;
+
+	for(;;)
+	{
+		if(expected.fields.first == NULL)
+		{
+			return NULL;
+		}
+
+		SLIST_HEADER desired;
+		desired.fields.first = expected.fields.first->Next;
+		desired.fields.tag = expected.fields.tag + 1;
+
+		unsigned __int128 previous = __sync_val_compare_and_swap(&head->value,expected.value,desired.value);
+		if(previous == expected.value)
+		{
+			return expected.fields.first;
+		}
+		expected.value = previous;
+	}
+}
+
+// Aligned memory, alignment must be a power of 2
+inline void * _aligned_malloc(size_t size, size_t alignment)
+{
+	// aligned_alloc requires size to be a multiple of alignment
+	return aligned_alloc(alignment,(size + alignment - 1) & ~(alignment - 1));
+}
+inline void _aligned_free(void * memory) { free(memory); }
+
+// Timing
+void Sleep(DWORD milliseconds);
+DWORD GetTickCount();
+
+/**
+ * @brief Replacement for clock(), which measures processor time on Linux.
+ *
+ * clock() is used throughout as milliseconds of wall time, which it is on Windows.
+ *
+ * @return number of milliseconds elapsed since an arbitrary fixed point.
+ */
+inline clock_t PlatformClock() { return static_cast<clock_t>(GetTickCount()); }
+#define clock() PlatformClock()
+
+// Strings and message boxes, used by Utility
+#define USHORT_MAX USHRT_MAX
+#define MB_OK 0x00000000
+#define MB_YESNO 0x00000004
+#define MB_ICONERROR 0x00000010
+#define IDOK 1
+#define IDYES 6
+#define IDNO 7
+inline int strcpy_s(char * destination, size_t size, const char * source) { snprintf(destination,size,"%s",source); return 0; }
+inline int _itoa_s(int value, char * destination, size_t size, int /*radix*/) { snprintf(destination,size,"%d",value); return 0; }
+inline int _i64toa_s(long long value, char * destination, size_t size, int /*radix*/) { snprintf(destination,size,"%lld",value); return 0; }
+
+/**
+ * @brief Replacement for MessageBox, there is no desktop to display a message box on.
+ *
+ * The message is written to stderr and the user is assumed to have answered no.
+ *
+ * @return IDNO if @a type is MB_YESNO, IDOK otherwise.
+ */
+inline int MessageBox(void * /*window*/, const char * text, const char * caption, unsigned int type)
+{
+	fprintf(stderr,"%s: %s\n",caption,text);
+	return (type & MB_YESNO) ? IDNO : IDOK;
+}
+
+// Winsock initialization, nothing needs to be loaded on Linux
+#define MAKEWORD(low,high) ((unsigned short)(((unsigned char)(low)) | (((unsigned short)((unsigned char)(high))) << 8)))
+struct WSADATA
+{
+	unsigned short wVersion;
+	unsigned short wHighVersion;
+};
+inline int WSAStartup(unsigned short versionRequested, WSADATA * data) { data->wVersion = versionRequested; data->wHighVersion = versionRequested; return 0; }
+inline int WSACleanup() { return 0; }
+
+// Sockets
+SOCKET WSASocket(int family, int type, int protocol, LPVOID protocolInfo, unsigned int group, DWORD flags);
+SOCKET WSAAccept(SOCKET socket, SOCKADDR * address, int * addressLength, LPCONDITIONPROC condition, DWORD_PTR callbackData);
+int closesocket(SOCKET socket);
+inline int getsockname(SOCKET socket, SOCKADDR * address, int * addressLength) { return getsockname(socket,address,reinterpret_cast<socklen_t*>(addressLength)); }
+int WSAEventSelect(SOCKET socket, HANDLE event, long networkEvents);
+
+// Overlapped socket operations, implemented by the completion engine
+int WSARecv(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesReceived, DWORD * flags, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine);
+int WSARecvFrom(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesReceived, DWORD * flags, SOCKADDR * from, int * fromLength, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine);
+int WSASend(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesSent, DWORD flags, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine);
+int WSASendTo(SOCKET socket, LPWSABUF buffers, DWORD bufferCount, DWORD * bytesSent, DWORD flags, const SOCKADDR * to, int toLength, LPWSAOVERLAPPED overlapped, LPWSAOVERLAPPED_COMPLETION_ROUTINE completionRoutine);
+
+// Batched datagram receive and send, Linux only
+int WSARecvFromBatch(SOCKET socket, WSABATCHMSG * messages, DWORD messageCount, DWORD * messagesReceived, LPWSAOVERLAPPED overlapped);
+int WSASetRecvCoalescing(SOCKET socket, BOOL enable);
+int WSASendToBatch(SOCKET socket, WSABATCHSENDMSG * messages, DWORD messageCount, DWORD * messagesSent);
+
+#endif
@@ -4,3 +4,8 @@
 #include "NetSendRaw.h"
 #include "NetSendPostfix.h"
 #include "NetSendPrefix.h"
+#include "NetSendPayload.h"
+#include "PacketChain.h"
+#include "NetSendShared.h"
+#include "NetSendPool.h"
+#include "NetSendList.h"
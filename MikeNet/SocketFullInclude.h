@@ -5,5 +5,6 @@
 #include "NetSocket.h"
 
 #include "NetSocketTCP.h"
+#include "NetRecvUDP.h"
 #include "NetSocketUDP.h"
 #include "NetSocketListening.h"
\ No newline at end of file
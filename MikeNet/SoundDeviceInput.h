@@ -1,5 +1,5 @@
 #pragma once
-#include "sounddevice.h"
+#include "SoundDevice.h"
 
 /**
  * @brief	Stores information about an input device.
@@ -20,20 +20,20 @@ public:
 	 */
 	void Clear()
 	{
-		Enter();
+		this->Enter();
 			while(data.size() > 0)
 			{
 				delete data.front();
 				data.pop();
 			}
-		Leave();
+		this->Leave();
 	}
 
 
 	/**
 	 * @brief Constructor.
 	 */
-	StoreQueue() : Store()
+	StoreQueue() : Store<T>()
 	{
 
 	}
@@ -43,7 +43,7 @@ public:
 	 *
 	 * @param	copyMe	Object to copy.
 	 */
-	StoreQueue(const StoreQueue & copyMe) : Store(copyMe)
+	StoreQueue(const StoreQueue & copyMe) : Store<T>(copyMe)
 	{
 		copyMe.Enter();
 			queue<T*> aux = copyMe.data;
@@ -120,7 +120,7 @@ public:
 	{
 		size_t returnMe;
 
-		Enter();
+		this->Enter();
 			returnMe = data.size();
 
 			if(data.size() > 0)
@@ -129,7 +129,7 @@ public:
 				delete data.front();
 				data.pop();
 			}
-		Leave();
+		this->Leave();
 
 		return(returnMe);
 	}
@@ -143,9 +143,9 @@ public:
 	void Add(T * object)
 	{
 		_ErrorException((object == NULL),"adding an object to an object store queue, NULL pointer received",0,__LINE__,__FILE__);
-		Enter();
+		this->Enter();
 			data.push(object);
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -157,9 +157,9 @@ public:
 	{
 		size_t returnMe = 0;
 
-		Enter();
+		this->Enter();
 			returnMe = data.size();
-		Leave();
+		this->Leave();
 
 		return(returnMe);
 	}
@@ -173,16 +173,16 @@ public:
 	{
 		T * returnMe;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((data.size() == 0),"retrieving an element from the front of a queue, queue is empty",0,__LINE__,__FILE__);
 			returnMe = data.front();
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 
 		return(returnMe);
 	}
@@ -192,7 +192,7 @@ public:
 	 */
 	void RemoveFront()
 	{
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((data.size() == 0),"retrieving an element from the front of a queue, queue is empty",0,__LINE__,__FILE__);
@@ -200,9 +200,9 @@ public:
 			data.pop();
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 	}
 
 	/**
@@ -212,7 +212,7 @@ public:
 	{
 		T * returnMe = NULL;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((data.size() == 0),"extracting an element from the front of a queue, queue is empty",0,__LINE__,__FILE__);
@@ -220,9 +220,9 @@ public:
 			data.pop();
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 
 		return returnMe;
 	}
@@ -234,9 +234,9 @@ public:
 	 */
 	bool IsEmpty() const
 	{
-		Enter();
+		this->Enter();
 		bool returnMe = data.empty();
-		Leave();
+		this->Leave();
 		return returnMe;
 	}
 
@@ -249,16 +249,16 @@ public:
 	{
 		T * returnMe;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((data.size() == 0),"retrieving an element from the back of a queue, queue is empty",0,__LINE__,__FILE__);
 			returnMe = data.back();
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 
 		return(returnMe);
 	}
@@ -1,6 +1,7 @@
 #pragma once
 #include "Store.h"
 #include <math.h>
+#include <algorithm>
 #include "StdComparator.h"
 using namespace std;
 
@@ -31,7 +32,7 @@ class StoreVector: public Store<T>
 
 public:
 	/** @brief Constructor. */
-	StoreVector() : Store()
+	StoreVector() : Store<T>()
 	{
 		DefaultVariables();
 	}
@@ -41,7 +42,7 @@ public:
 	 *
 	 * @param doNotDeallocate if true items added to this vector will not be deallocated.
 	 */
-	StoreVector(bool doNotDeallocate) : Store()
+	StoreVector(bool doNotDeallocate) : Store<T>()
 	{
 		DefaultVariables();
 		this->doNotDeallocate = true;
@@ -52,7 +53,7 @@ public:
 	 *
 	 * @param	copyMe	Object to copy.
 	 */
-	StoreVector(const StoreVector & copyMe) : Store(copyMe)
+	StoreVector(const StoreVector & copyMe) : Store<T>(copyMe)
 	{
 		copyMe.Enter();
 		this->Enter();
@@ -165,12 +166,12 @@ public:
 	 */
 	void LinkShallow(const StoreVector & loadMe)
 	{
-		Enter();
+		this->Enter();
 		loadMe.Enter();
 			data = loadMe.data;
 			doNotDeallocate = true;
 		loadMe.Leave();
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -226,7 +227,7 @@ private:
 		}
 
 		StdComparator<T,T2> stdComparatorFind(comparatorFind);
-		vector<T*>::iterator iterator = std::lower_bound(range.begin(),range.end(),elementToFind,stdComparatorFind);
+		typename vector<T*>::iterator iterator = std::lower_bound(range.begin(),range.end(),elementToFind,stdComparatorFind);
 		return static_cast<size_t>(iterator - range.begin());
 	}
 
@@ -269,15 +270,15 @@ public:
 	 */
 	void Sort(const Comparator & comparator)
 	{
-		Enter();
+		this->Enter();
 		try
 		{
 			VectorSort(data,comparator);
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 	}
 
 	/**
@@ -299,15 +300,15 @@ public:
 	{
 		size_t returnMe;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			returnMe = VectorFind(data, comparatorSort, comparatorFind, findMe, sortVector);
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 
 		return returnMe;
 	}
@@ -328,15 +329,15 @@ public:
 	{
 		size_t returnMe;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			returnMe = VectorFind(data, comparator, comparator, findMe, sortVector);
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 
 		return returnMe;
 	}
@@ -360,15 +361,15 @@ public:
 	{
 		size_t returnMe;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			returnMe = VectorExists(data, comparatorSort, comparatorFind, findMe, sortVector);
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 
 		return returnMe;
 	}
@@ -387,16 +388,16 @@ public:
 	{
 		bool returnMe;
 
-		Enter();
+		this->Enter();
 
 		try
 		{
 			returnMe = VectorExists(data,comparator,comparator,findMe,sortVector);
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 
 		return returnMe;
 	}
@@ -414,15 +415,15 @@ public:
 	{
 		vector<T*> copy;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			copy = data;
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 
 		return VectorExists(copy,comparator,comparator,findMe,true);
 	}
@@ -440,16 +441,16 @@ public:
 	T ** GetPtr(size_t element)
 	{
 		T ** returnMe = NULL;
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((element >= this->Size()),"retrieving a vector element's pointer, element specified is out of bounds",0,__LINE__,__FILE__);
 			returnMe = &data[element];
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 		return returnMe;
 	}
 
@@ -468,7 +469,7 @@ public:
 	{
 		T * returnMe = NULL;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((element >= this->Size()),"accessing element of vector, element specified is out of bounds",0,__LINE__,__FILE__);
@@ -476,10 +477,10 @@ public:
 			returnMe = data[element];
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();
+		this->Leave();
 		return(*returnMe);
 	}
 
@@ -498,7 +499,7 @@ public:
 	{
 		T * returnMe = NULL;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((element >= this->Size()),"accessing element of vector, element specified is out of bounds",0,__LINE__,__FILE__);
@@ -506,10 +507,10 @@ public:
 			returnMe = data[element];
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();
+		this->Leave();
 		return(*returnMe);
 	}
 	
@@ -538,7 +539,7 @@ public:
 	 */
 	void Erase(size_t element)
 	{
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((element >= this->Size()),"erasing element of vector, element specified is out of bounds",0,__LINE__,__FILE__);
@@ -551,10 +552,10 @@ public:
 			data.erase(data.begin()+element);
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -567,7 +568,7 @@ public:
 	T * Extract(size_t element)
 	{
 		T * returnMe = NULL;
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((element >= this->Size()),"extracting element from vector, element specified is out of bounds",0,__LINE__,__FILE__);
@@ -576,10 +577,10 @@ public:
 			data.erase(data.begin()+element);
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();
+		this->Leave();
 		return returnMe;
 	}
 
@@ -591,18 +592,17 @@ public:
 	 */
 	void Insert(size_t element, size_t amount)
 	{
-		Enter();
+		this->Enter();
 
 		try
 		{
-			this->data.insert(data.begin()+element,amount,NULL);
-			vectorNeedsResorting = true;
+			this->data.insert(this->data.begin()+element,amount,NULL);
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -613,7 +613,7 @@ public:
 	 */
 	void InsertAllocate(size_t element, size_t amount)
 	{
-		Enter();
+		this->Enter();
 
 		try
 		{
@@ -625,10 +625,10 @@ public:
 			}
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();	
+		this->Leave();	
 	}
 
 	/**
@@ -640,7 +640,7 @@ public:
 	 */
 	void Allocate(size_t element)
 	{
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((element >= this->Size()),"allocating element of vector with default constructor, element specified is out of bounds",0,__LINE__,__FILE__);
@@ -650,10 +650,10 @@ public:
 			Utility::DynamicAllocCheck(data[element],__LINE__,__FILE__);
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -664,7 +664,7 @@ public:
 	 */
 	void Allocate(size_t element, const T & newElement)
 	{
-		Enter();
+		this->Enter();
 		
 		try
 		{
@@ -676,10 +676,10 @@ public:
 			Utility::DynamicAllocCheck(data[element],__LINE__,__FILE__);
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -690,7 +690,7 @@ public:
 	 */
 	void Allocate(size_t element, T * newElement)
 	{
-		Enter();
+		this->Enter();
 		
 		try
 		{
@@ -701,10 +701,10 @@ public:
 			data[element] = newElement;
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -716,7 +716,7 @@ public:
 	 */
 	void Deallocate(size_t element)
 	{
-		Enter();
+		this->Enter();
 
 		try
 		{
@@ -731,10 +731,10 @@ public:
 			data[element] = NULL;
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -742,14 +742,14 @@ public:
 	 */
 	void Clear()
 	{
-		Enter();
+		this->Enter();
 
 		while(data.size() > 0)
 		{
 			Erase(0);
 		}
 
-		Leave();		
+		this->Leave();		
 	}
 
 
@@ -764,7 +764,7 @@ public:
 	{
 		size_t returnMe;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			returnMe = data.size();
@@ -776,9 +776,9 @@ public:
 			}
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 
 		return(returnMe);
 	}
@@ -804,9 +804,9 @@ public:
 	void Add(T * object)
 	{
 		_ErrorException((object == NULL),"adding a NULL object to a vector",0,__LINE__,__FILE__);
-		Enter();
+		this->Enter();
 			data.push_back(object);
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -818,9 +818,9 @@ public:
 	{
 		size_t returnMe = 0;
 
-		Enter();
+		this->Enter();
 			returnMe = data.size();
-		Leave();
+		this->Leave();
 
 		return(returnMe);
 	}
@@ -834,16 +834,16 @@ public:
 	{
 		T * returnMe;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((data.size() == 0),"retrieving an element from the front of a vector, vector is empty",0,__LINE__,__FILE__);
 			returnMe = data.front();
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 
 		return(returnMe);
 	}
@@ -857,16 +857,16 @@ public:
 	{
 		T * returnMe;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((data.size() == 0),"retrieving an element from the back of a vector, vector is empty",0,__LINE__,__FILE__);
 			returnMe = data.back();
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 
 		return(returnMe);
 	}
@@ -880,7 +880,7 @@ public:
 	 */
 	void ResizeAllocate(size_t newSize)
 	{
-		Enter();
+		this->Enter();
 		try
 		{
 			size_t originalSize = data.size();
@@ -891,10 +891,10 @@ public:
 			}
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -907,7 +907,7 @@ public:
 	 */
 	void ResizeAllocate(size_t newSize, const T & copyMe)
 	{
-		Enter();
+		this->Enter();
 		try
 		{
 			size_t originalSize = data.size();
@@ -918,10 +918,10 @@ public:
 			}
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
 
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -934,16 +934,16 @@ public:
 	{
 		bool returnMe;
 
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((element >= data.size()),"determining whether an element is allocated, element specified is out of bounds",0,__LINE__,__FILE__);
 			returnMe = (data[element] != NULL);
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 		return returnMe;
 	}
 
@@ -954,7 +954,7 @@ public:
 	 */
 	void Resize(size_t newSize)
 	{
-		Enter();
+		this->Enter();
 			size_t originalSize = data.size();
 
 			// Resize array and set new elements to NULL
@@ -963,7 +963,7 @@ public:
 			{
 				data[n] = NULL;
 			}
-		Leave();
+		this->Leave();
 	}
 
 	/**
@@ -974,7 +974,7 @@ public:
 	 */
 	void Swap(size_t element1, size_t element2)
 	{
-		Enter();
+		this->Enter();
 		try
 		{
 			_ErrorException((element1 >= Size()),"swapping two elements of a vector, element1 is out of bounds",0,__LINE__,__FILE__);
@@ -986,9 +986,9 @@ public:
 			data[element1] = aux;
 		}
 		// Release control of all objects before throwing final exception
-		catch(ErrorReport & error){Leave(); throw(error);}
-		catch(...){Leave(); throw(-1);}
-		Leave();
+		catch(ErrorReport & error){this->Leave(); throw(error);}
+		catch(...){this->Leave(); throw(-1);}
+		this->Leave();
 	}
 
 	/**
@@ -29,15 +29,26 @@ void main()
  	problem(StoreQueue<int>::TestClass());
  	problem(Counter::TestClass());
  	problem(Packet::TestClass());
+ 	problem(MemoryRecyclePacket::TestClass());
+ 	problem(MemoryRecycleSlab::TestClass());
+ 	problem(PacketBuilder::TestClass());
+ 	problem(PacketReader::TestClass());
  	problem(Timer::TestClass());
+ 	problem(TimerWheel::TestClass());
  	problem(Utility::TestClass());
  	problem(NetSocketSimple::TestClass());
  	problem(NetUtility::TestClass());
  	problem(NetAddress::TestClass());
+ 	problem(NetAddressMap::TestClass());
  	problem(NetSend::TestClass());
  	problem(NetSendRaw::TestClass());
  	problem(NetSendPrefix::TestClass());
  	problem(NetSendPostfix::TestClass());
+ 	problem(NetSendPayload::TestClass());
+ 	problem(PacketChain::TestClass());
+ 	problem(NetSendShared::TestClass());
+ 	problem(NetSendPool::TestClass());
+ 	problem(NetSendList::TestClass());
  	problem(NetMode::TestClass());
  	problem(NetModeTcp::TestClass());
  	problem(NetModeTcpPostfix::TestClass());
@@ -49,15 +60,21 @@ void main()
  	problem(NetSocket::TestClass());
  	problem(NetSocketListening::TestClass());
  	problem(NetSocketTCP::TestClass());
+ 	problem(NetRecvUDP::TestClass());
  	problem(NetSocketUDP::TestClass());
  	problem(NetInstanceClient::TestClass());
+ 	problem(NetClientQueue::TestClass());
  	problem(NetInstanceServer::TestClass());
  	problem(NetInstanceBroadcast::TestClass());
  	problem(ErrorReport::TestClass());
+ 	problem(ThreadMessageQueue::TestClass());
  	problem(ThreadSingleMessage::TestClass());
  	problem(ThreadSingleMessageKeepLast::TestClass());
  	problem(UpnpNatCommunication::TestClass());
+ 	problem(CipherAES::TestClass());
+ 	problem(CipherGCM::TestClass());
  	problem(EncryptKey::TestClass());
+ 	problem(EncryptKeyCache::TestClass());
  	problem(SoundDeviceInput::TestClass());
  	problem(SoundDeviceOutput::TestClass());
  	problem(SoundInstanceOutput::TestClass());*/
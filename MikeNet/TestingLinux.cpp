@@ -0,0 +1,143 @@
+#include "FullInclude.h"
+#include <string.h>
+
+/** @brief Associates the name of a class with its test. */
+struct TestSuite
+{
+	/** @brief Name of class, passed on the command line to select the test. */
+	const char * name;
+
+	/** @brief Tests class, returning true if no problems were found. */
+	bool (*test)();
+};
+
+/** @brief Tests that can be run on Linux, UPnP and sound modules are Windows only. */
+static const TestSuite testSuites[] =
+{
+	{"CriticalSection", &CriticalSection::TestClass},
+	{"ConcurrencyControl", &ConcurrencyControl::TestClass},
+	{"ConcurrencyControlSimple", &ConcurrencyControlSimple::TestClass},
+	{"ConcurrentObject", &ConcurrentObject<int>::TestClass},
+	{"ConcurrencyEvent", &ConcurrencyEvent::TestClass},
+	{"ThreadSingle", &ThreadSingle::TestClass},
+	{"ThreadSingleGroup", &ThreadSingleGroup::TestClass},
+	{"StoreVector", &StoreVector<int>::TestClass},
+	{"StoreQueue", &StoreQueue<int>::TestClass},
+	{"Counter", &Counter::TestClass},
+	{"Timer", &Timer::TestClass},
+	{"TimerWheel", &TimerWheel::TestClass},
+	{"ThreadMessageQueue", &ThreadMessageQueue::TestClass},
+	{"ThreadSingleMessage", &ThreadSingleMessage::TestClass},
+	{"ThreadSingleMessageKeepLast", &ThreadSingleMessageKeepLast::TestClass},
+	{"MemoryRecyclePacket", &MemoryRecyclePacket::TestClass},
+	{"MemoryRecycleSlab", &MemoryRecycleSlab::TestClass},
+	{"Packet", &Packet::TestClass},
+	{"PacketBuilder", &PacketBuilder::TestClass},
+	{"PacketReader", &PacketReader::TestClass},
+	{"Utility", &Utility::TestClass},
+	{"ErrorReport", &ErrorReport::TestClass},
+	{"CipherAES", &CipherAES::TestClass},
+	{"CipherGCM", &CipherGCM::TestClass},
+	{"EncryptKey", &EncryptKey::TestClass},
+	{"EncryptKeyCache", &EncryptKeyCache::TestClass},
+	{"NetSocketSimple", &NetSocketSimple::TestClass},
+	{"NetUtility", &NetUtility::TestClass},
+	{"NetAddress", &NetAddress::TestClass},
+	{"NetAddressMap", &NetAddressMap::TestClass},
+	{"NetSend", &NetSend::TestClass},
+	{"NetSendRaw", &NetSendRaw::TestClass},
+	{"NetSendPrefix", &NetSendPrefix::TestClass},
+	{"NetSendPostfix", &NetSendPostfix::TestClass},
+	{"NetSendPayload", &NetSendPayload::TestClass},
+	{"PacketChain", &PacketChain::TestClass},
+	{"NetSendShared", &NetSendShared::TestClass},
+	{"NetSendPool", &NetSendPool::TestClass},
+	{"NetSendList", &NetSendList::TestClass},
+	{"NetMode", &NetMode::TestClass},
+	{"NetModeTcp", &NetModeTcp::TestClass},
+	{"NetModeTcpPostfix", &NetModeTcpPostfix::TestClass},
+	{"NetModeTcpPrefixSize", &NetModeTcpPrefixSize::TestClass},
+	{"NetModeUdp", &NetModeUdp::TestClass},
+	{"NetModeUdpCatchAll", &NetModeUdpCatchAll::TestClass},
+	{"NetModeUdpCatchAllNo", &NetModeUdpCatchAllNo::TestClass},
+	{"NetModeUdpPerClient", &NetModeUdpPerClient::TestClass},
+	{"NetSocket", &NetSocket::TestClass},
+	{"NetSocketListening", &NetSocketListening::TestClass},
+	{"NetSocketTCP", &NetSocketTCP::TestClass},
+	{"NetRecvUDP", &NetRecvUDP::TestClass},
+	{"NetSocketUDP", &NetSocketUDP::TestClass},
+	{"NetInstanceClient", &NetInstanceClient::TestClass},
+	{"NetClientQueue", &NetClientQueue::TestClass},
+	{"NetInstanceServer", &NetInstanceServer::TestClass},
+	{"NetInstanceBroadcast", &NetInstanceBroadcast::TestClass},
+	{"CompletionPort", &CompletionPort::TestClass},
+	{"CompletionKey", &CompletionKey::TestClass}
+};
+
+/**
+ * @brief Tests API on Linux, used by ctest.
+ *
+ * Unlike Testing.cpp this does not wait for input, so that it can be automated.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Names of classes to test, all classes are tested if none are specified.
+ *
+ * @return 0 if no problems were found, 1 if a problem was found or a class name was not recognised.
+ */
+int main(int argc, char ** argv)
+{
+	const size_t numSuites = sizeof(testSuites) / sizeof(testSuites[0]);
+	bool problem = false;
+
+	for(size_t n = 0;n<numSuites;n++)
+	{
+		bool selected = (argc < 2);
+		for(int i = 1;i<argc;i++)
+		{
+			if(strcmp(argv[i],testSuites[n].name) == 0)
+			{
+				selected = true;
+			}
+		}
+
+		if(selected == true)
+		{
+			try
+			{
+				if(testSuites[n].test() == false)
+				{
+					cout << "A problem was found while testing " << testSuites[n].name << "\n";
+					problem = true;
+				}
+			}
+			catch(ErrorReport & error)
+			{
+				char * message = error.GetFullMessage();
+				cout << "Error while testing " << testSuites[n].name << ": " << message << "\n";
+				delete[] message;
+				problem = true;
+			}
+		}
+	}
+
+	for(int i = 1;i<argc;i++)
+	{
+		bool found = false;
+		for(size_t n = 0;n<numSuites;n++)
+		{
+			if(strcmp(argv[i],testSuites[n].name) == 0)
+			{
+				found = true;
+			}
+		}
+
+		if(found == false)
+		{
+			cout << "No test for " << argv[i] << "\n";
+			problem = true;
+		}
+	}
+
+	cout << "Finished...\n";
+	return problem ? 1 : 0;
+}
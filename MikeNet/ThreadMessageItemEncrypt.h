@@ -1,11 +1,14 @@
 #pragma once
-#include "threadmessageitem.h"
+#include "ThreadMessageItem.h"
 #include "EncryptKey.h"
+#include "CipherAES.h"
 class Packet;
 
 /**
  * @brief	Message which encrypts or decrypts part of a packet, sent to a ThreadSingleMessage thread.
  * @remarks	Michael Pryor, 9/20/2010. 
+ *
+ * Messages can be reused for further operations using Reinitialize(), once the thread has finished with them.
  */
 class ThreadMessageItemEncrypt :
 	public ThreadMessageItem
@@ -28,7 +31,7 @@ class ThreadMessageItemEncrypt :
 	/**
 	 * @brief Key used to encrypt or decrypt data.
 	 */
-	const EncryptKey & key;
+	const EncryptKey * key;
 
 	/**
 	 * @brief ID of thread that this message will be sent to.
@@ -40,30 +43,18 @@ class ThreadMessageItemEncrypt :
 	 */
 	size_t numThreads;
 
-	/** @brief Stores intermediate encryption result. */
-	unsigned char state[4][4];
-
-	void InverseCipher(unsigned char * dataToEncrypt,unsigned char * result, unsigned char numRounds, unsigned char * roundKey);
-	void Cipher(unsigned char * dataToEncrypt, unsigned char * result, unsigned char numRounds, unsigned char * roundKey);
-
-	void XorRoundKey(size_t round, unsigned char * roundKey);
-	void InverseMixColumns();
-	void MixColumns();
-	void ShiftRowsRight();
-	void ShiftRowsLeft();
-	void InverseSubBytes();
-	void SubBytes();
-	unsigned char _gMul(unsigned char a, unsigned char b);
-
 public:
 	/**
-	 * @brief Amount of data that is encrypted in one ThreadMessageItemEncrypt::Cipher or decrypted in one ThreadMessageItemEncrypt::InverseCipher operation.
+	 * @brief Amount of data that is encrypted or decrypted as one block, see CipherAES.
 	 */
-	static const size_t ENCRYPTION_CHUNK_SIZE = 16;
+	static const size_t ENCRYPTION_CHUNK_SIZE = CipherAES::BLOCK_SIZE;
 	
 	ThreadMessageItemEncrypt(bool encrypt, Packet * packet, const EncryptKey & encryptKey, size_t threadID, size_t numThreads);
 	virtual ~ThreadMessageItemEncrypt();
 
+	void Reinitialize(bool encrypt, Packet * packet, const EncryptKey & encryptKey, size_t threadID, size_t numThreads);
+
+	static void Cipher(bool encrypt, unsigned char * data, size_t numChunks, const EncryptKey & key);
 	void * TakeAction();
 };
 
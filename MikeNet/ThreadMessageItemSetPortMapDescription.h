@@ -1,5 +1,5 @@
 #pragma once
-#include "threadmessageitem.h"
+#include "ThreadMessageItem.h"
 
 /**
  * @brief	Message for use with ThreadSingleMessage.
@@ -1,5 +1,5 @@
 #pragma once
-#include "threadmessageitem.h"
+#include "ThreadMessageItem.h"
 
 /**
  * @brief	Message used to tell thread to terminate.
@@ -1,5 +1,5 @@
 #pragma once
-#include "threadmessageitem.h"
+#include "ThreadMessageItem.h"
 class SoundInstance;
 
 
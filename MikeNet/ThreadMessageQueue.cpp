@@ -0,0 +1,473 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Advances a position, wrapping around instead of overflowing.
+ *
+ * @param position Position to advance.
+ * @param amount Amount to advance by.
+ *
+ * @return advanced position.
+ */
+static LONG ThreadMessageQueueAdvance(LONG position, ULONG amount)
+{
+	return static_cast<LONG>(static_cast<ULONG>(position) + amount);
+}
+
+/**
+ * @brief Allocates slots and sets variables to their initial state.
+ *
+ * @param capacity Maximum number of messages that can be queued, rounded up to a power of 2.
+ */
+void ThreadMessageQueue::Initialize(size_t capacity)
+{
+	size_t size = 2;
+	while(size < capacity)
+	{
+		size *= 2;
+	}
+
+	slots = new (nothrow) Slot[size];
+	Utility::DynamicAllocCheck(slots,__LINE__,__FILE__);
+
+	for(size_t n = 0;n<size;n++)
+	{
+		slots[n].sequence = static_cast<LONG>(n);
+		slots[n].item = NULL;
+	}
+
+	mask = static_cast<LONG>(size - 1);
+	pushPosition = 0;
+	popPosition = 0;
+	sleeping = 0;
+	spinCount = (ThreadSingle::GetNumLogicalCores() > 1) ? SPIN_COUNT : 0;
+}
+
+/**
+ * @brief Constructor.
+ *
+ * @param capacity Maximum number of messages that can be queued, rounded up to a power of 2.
+ */
+ThreadMessageQueue::ThreadMessageQueue(size_t capacity) : notEmpty(false,false)
+{
+	Initialize(capacity);
+}
+
+/**
+ * @brief Deep copy constructor.
+ *
+ * Only copies the capacity of the queue, rather than the messages in it.
+ *
+ * @param copyMe Object to copy.
+ */
+ThreadMessageQueue::ThreadMessageQueue(const ThreadMessageQueue & copyMe) : notEmpty(false,false)
+{
+	Initialize(copyMe.GetCapacity());
+}
+
+/**
+ * @brief Deep assignment operator.
+ *
+ * Does nothing, messages belong to the thread that owns the queue and are not copied.
+ *
+ * @param copyMe Object to copy.
+ *
+ * @return reference to this object.
+ */
+ThreadMessageQueue & ThreadMessageQueue::operator= (const ThreadMessageQueue & copyMe)
+{
+	return *this;
+}
+
+/**
+ * @brief Destructor.
+ */
+ThreadMessageQueue::~ThreadMessageQueue()
+{
+	delete[] slots;
+}
+
+/**
+ * @brief Posts a message without waiting.
+ *
+ * @param item Message to post, may be NULL.
+ *
+ * @return true if the message was posted, false if the queue is full.
+ */
+bool ThreadMessageQueue::TryPush(ThreadMessageItem * item)
+{
+	LONG position = pushPosition;
+	Slot * slot;
+
+	for(;;)
+	{
+		slot = &slots[position & mask];
+		LONG difference = ThreadMessageQueueAdvance(slot->sequence,-static_cast<ULONG>(position));
+
+		if(difference == 0)
+		{
+			// Slot is free, claim it
+			LONG previous = InterlockedCompareExchange(&pushPosition,ThreadMessageQueueAdvance(position,1),position);
+			if(previous == position)
+			{
+				break;
+			}
+			position = previous;
+		}
+		else if(difference < 0)
+		{
+			// Slot has not been received from since the last lap
+			return false;
+		}
+		else
+		{
+			// Another thread claimed the slot
+			position = pushPosition;
+		}
+	}
+
+	slot->item = item;
+
+	// Full barrier, so that the receiving thread sees the message or this thread sees that it is sleeping
+	InterlockedExchange(&slot->sequence,ThreadMessageQueueAdvance(position,1));
+
+	if(sleeping != 0)
+	{
+		notEmpty.Set(true);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Posts a message, waiting for a slot to become free if the queue is full.
+ *
+ * @param item Message to post, may be NULL.
+ */
+void ThreadMessageQueue::Push(ThreadMessageItem * item)
+{
+	size_t attempts = 0;
+	while(TryPush(item) == false)
+	{
+		attempts++;
+		if(attempts < spinCount)
+		{
+			YieldProcessor();
+		}
+		else
+		{
+			Sleep((attempts < spinCount + SPIN_COUNT) ? 0 : 1);
+		}
+	}
+}
+
+/**
+ * @brief Receives a message without waiting, must only be used by the receiving thread.
+ *
+ * @param [out] item Filled with the message if one was received.
+ *
+ * @return true if a message was received, false if the queue is empty.
+ */
+bool ThreadMessageQueue::TryPop(ThreadMessageItem *& item)
+{
+	Slot & slot = slots[popPosition & mask];
+	LONG nextPosition = ThreadMessageQueueAdvance(popPosition,1);
+
+	if(slot.sequence != nextPosition)
+	{
+		return false;
+	}
+
+	item = slot.item;
+
+	// Free slot for the next lap
+	slot.sequence = ThreadMessageQueueAdvance(popPosition,static_cast<ULONG>(mask) + 1);
+	popPosition = nextPosition;
+	return true;
+}
+
+/**
+ * @brief Receives a message, waiting until one is posted if the queue is empty.
+ *
+ * Must only be used by the receiving thread.
+ *
+ * @return message.
+ */
+ThreadMessageItem * ThreadMessageQueue::Pop()
+{
+	ThreadMessageItem * item;
+
+	for(;;)
+	{
+		for(size_t n = 0;n<spinCount;n++)
+		{
+			if(TryPop(item) == true)
+			{
+				return item;
+			}
+			YieldProcessor();
+		}
+
+		// Full barrier, so that a posting thread sees that we are sleeping or we see its message
+		InterlockedExchange(&sleeping,1);
+		if(TryPop(item) == true)
+		{
+			sleeping = 0;
+			return item;
+		}
+
+		notEmpty.WaitUntilSignaled();
+		sleeping = 0;
+	}
+}
+
+/**
+ * @brief Determines whether the queue is empty, must only be used by the receiving thread.
+ *
+ * @return true if there are no messages to receive.
+ */
+bool ThreadMessageQueue::IsEmpty() const
+{
+	return slots[popPosition & mask].sequence != ThreadMessageQueueAdvance(popPosition,1);
+}
+
+/**
+ * @brief Retrieves the maximum number of messages that can be queued.
+ *
+ * @return capacity.
+ */
+size_t ThreadMessageQueue::GetCapacity() const
+{
+	return static_cast<size_t>(mask) + 1;
+}
+
+/**
+ * @brief Number of messages posted by each thread in ThreadMessageQueue::TestClass.
+ */
+static const size_t THREAD_MESSAGE_QUEUE_TEST_AMOUNT = 200000;
+
+/**
+ * @brief Posts numbered messages to a queue, used by ThreadMessageQueue::TestClass.
+ *
+ * Messages are not real ThreadMessageItem objects and are never dereferenced.
+ *
+ * @param lpParameter Pointer to ThreadSingle object, whose parameter is the queue.
+ *
+ * @return 0.
+ */
+static DWORD WINAPI ThreadMessageQueueTestProducer(LPVOID lpParameter)
+{
+	ThreadSingle * thread = static_cast<ThreadSingle*>(lpParameter);
+	ThreadMessageQueue * queue = static_cast<ThreadMessageQueue*>(thread->GetParameter());
+
+	size_t producer = thread->GetManualThreadID();
+	for(size_t n = 1;n<=THREAD_MESSAGE_QUEUE_TEST_AMOUNT;n++)
+	{
+		queue->Push(reinterpret_cast<ThreadMessageItem*>((producer << 24) | n));
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Receives messages from one queue and posts them to another, until NULL is received.
+ *
+ * @param lpParameter Pointer to ThreadSingle object, whose parameter is an array of two queues.
+ *
+ * @return 0.
+ */
+static DWORD WINAPI ThreadMessageQueueEcho(LPVOID lpParameter)
+{
+	ThreadSingle * thread = static_cast<ThreadSingle*>(lpParameter);
+	ThreadMessageQueue ** queues = static_cast<ThreadMessageQueue**>(thread->GetParameter());
+
+	for(;;)
+	{
+		ThreadMessageItem * item = queues[0]->Pop();
+		if(item == NULL)
+		{
+			break;
+		}
+		queues[1]->Push(item);
+	}
+
+	return 0;
+}
+
+#ifdef _WIN32
+/**
+ * @brief Receives thread messages and posts them back to the thread that is the parameter, until a message of 0 is received.
+ *
+ * @param lpParameter Pointer to ThreadSingle object, whose parameter is the ID of the thread to reply to.
+ *
+ * @return 0.
+ */
+static DWORD WINAPI ThreadMessageQueueEchoWindows(LPVOID lpParameter)
+{
+	ThreadSingle * thread = static_cast<ThreadSingle*>(lpParameter);
+	DWORD replyThreadID = static_cast<DWORD>(reinterpret_cast<size_t>(thread->GetParameter()));
+
+	MSG message;
+	PeekMessage(&message,(HWND)-1,0,0,PM_NOREMOVE);
+	PostThreadMessage(replyThreadID,WM_APP,0,0);
+
+	while(GetMessage(&message,(HWND)-1,0,0) > 0 && message.lParam != 0)
+	{
+		PostThreadMessage(replyThreadID,WM_APP,0,message.lParam);
+	}
+
+	return 0;
+}
+#endif
+
+/**
+ * @brief Measures the time taken for a message to be sent to another thread and back.
+ *
+ * Compares ThreadMessageQueue, which ThreadSingleMessage uses, against the window message
+ * queue used by PostThreadMessage on Windows. Other platforms have no equivalent of
+ * PostThreadMessage, so only ThreadMessageQueue is measured.
+ */
+static void ThreadMessageQueueLatencyBenchmark()
+{
+	const size_t roundTrips = 200000;
+
+	{
+		ThreadMessageQueue request;
+		ThreadMessageQueue reply;
+		ThreadMessageQueue * queues[] = {&request, &reply};
+
+		ThreadSingle thread(&ThreadMessageQueueEcho,queues);
+		thread.Resume();
+
+		DWORD startTime = GetTickCount();
+		for(size_t n = 1;n<=roundTrips;n++)
+		{
+			request.Push(reinterpret_cast<ThreadMessageItem*>(n));
+			reply.Pop();
+		}
+		DWORD timeTaken = GetTickCount() - startTime;
+
+		request.Push(NULL);
+		thread.WaitForThreadToExit();
+
+		cout << "ThreadMessageQueue: " << roundTrips << " round trips in " << timeTaken << "ms, " << (timeTaken * 1000.0) / roundTrips << " microseconds per round trip\n";
+	}
+
+#ifdef _WIN32
+	{
+		MSG message;
+		PeekMessage(&message,(HWND)-1,0,0,PM_NOREMOVE);
+
+		ThreadSingle thread(&ThreadMessageQueueEchoWindows,reinterpret_cast<void*>(static_cast<size_t>(GetCurrentThreadId())));
+		thread.Resume();
+
+		// Wait for thread's queue to be created
+		GetMessage(&message,(HWND)-1,0,0);
+
+		DWORD startTime = GetTickCount();
+		for(size_t n = 1;n<=roundTrips;n++)
+		{
+			PostThreadMessage(thread.GetThreadID(),WM_APP,0,static_cast<LPARAM>(n));
+			GetMessage(&message,(HWND)-1,0,0);
+		}
+		DWORD timeTaken = GetTickCount() - startTime;
+
+		PostThreadMessage(thread.GetThreadID(),WM_APP,0,0);
+		thread.WaitForThreadToExit();
+
+		cout << "PostThreadMessage: " << roundTrips << " round trips in " << timeTaken << "ms, " << (timeTaken * 1000.0) / roundTrips << " microseconds per round trip\n";
+	}
+#endif
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool ThreadMessageQueue::TestClass()
+{
+	cout << "Testing ThreadMessageQueue class...\n";
+	bool problem = false;
+
+	{
+		ThreadMessageQueue queue(1000);
+
+		size_t amount = 0;
+		while(queue.TryPush(reinterpret_cast<ThreadMessageItem*>(amount + 1)) == true)
+		{
+			amount++;
+		}
+
+		bool orderGood = true;
+		for(size_t n = 0;n<amount;n++)
+		{
+			ThreadMessageItem * item = NULL;
+			if(queue.TryPop(item) == false || item != reinterpret_cast<ThreadMessageItem*>(n + 1))
+			{
+				orderGood = false;
+			}
+		}
+
+		if(queue.GetCapacity() == 1024 && amount == 1024 && orderGood == true && queue.IsEmpty() == true)
+		{
+			cout << "Capacity and order are good\n";
+		}
+		else
+		{
+			cout << "Capacity or order is bad\n";
+			problem = true;
+		}
+	}
+
+	{
+		// Small queue so that producers often find it full
+		const size_t numProducers = 4;
+		ThreadMessageQueue queue(64);
+
+		ThreadSingleGroup threads;
+		for(size_t n = 0;n<numProducers;n++)
+		{
+			ThreadSingle * thread = new (nothrow) ThreadSingle(&ThreadMessageQueueTestProducer,&queue,n);
+			Utility::DynamicAllocCheck(thread,__LINE__,__FILE__);
+			threads.Add(thread);
+		}
+
+		threads.Resume();
+
+		// Messages from each producer must arrive in the order that they were posted
+		size_t lastReceived[numProducers] = {0};
+		bool orderGood = true;
+		for(size_t n = 0;n<numProducers * THREAD_MESSAGE_QUEUE_TEST_AMOUNT;n++)
+		{
+			size_t value = reinterpret_cast<size_t>(queue.Pop());
+			size_t producer = value >> 24;
+			size_t number = value & 0xFFFFFF;
+
+			if(producer >= numProducers || number != lastReceived[producer] + 1)
+			{
+				orderGood = false;
+				break;
+			}
+			lastReceived[producer] = number;
+		}
+
+		threads.WaitForThreadsToExit();
+
+		if(orderGood == true && queue.IsEmpty() == true)
+		{
+			cout << "Multiple producers are good\n";
+		}
+		else
+		{
+			cout << "Multiple producers are bad\n";
+			problem = true;
+		}
+	}
+
+	ThreadMessageQueueLatencyBenchmark();
+
+	cout << "\n\n";
+	return !problem;
+}
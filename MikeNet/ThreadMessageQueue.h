@@ -0,0 +1,77 @@
+#pragma once
+#include "ConcurrencyEvent.h"
+
+class ThreadMessageItem;
+
+/**
+ * @brief	Bounded queue of ThreadMessageItem pointers, which any number of threads can post to and one thread receives from.
+ *
+ * Posting and receiving do not take locks and do not enter the kernel unless the receiving thread
+ * is asleep. The receiving thread spins briefly when the queue is empty before sleeping on an event,
+ * and posting threads only signal the event if the receiving thread has indicated that it is asleep.\n\n
+ *
+ * Each slot has a sequence number which tells posting threads whether the slot is free and
+ * the receiving thread whether it has been filled, so that a slot is never read before it is
+ * completely written. When the queue is full posting threads wait for the receiving thread to free a slot.\n\n
+ *
+ * Push() is thread safe, Pop(), TryPop() and IsEmpty() must only be used by the receiving thread.
+ */
+class ThreadMessageQueue
+{
+	/** @brief Element of ThreadMessageQueue::slots. */
+	struct Slot
+	{
+		/**
+		 * @brief Equal to the position that the slot will next be written at if it is free,
+		 * and one more than that position once it has been written.
+		 */
+		volatile LONG sequence;
+
+		/** @brief Message stored in slot, volatile so that it is not reordered around ThreadMessageQueue::Slot::sequence. */
+		ThreadMessageItem * volatile item;
+	};
+
+	/** @brief Ring buffer of slots, size is a power of 2. */
+	Slot * slots;
+
+	/** @brief Number of elements in ThreadMessageQueue::slots minus 1, used to wrap positions. */
+	LONG mask;
+
+	/** @brief Position that the next message will be posted at, shared by posting threads. */
+	volatile LONG pushPosition;
+
+	/** @brief Position that the next message will be received from, only used by the receiving thread. */
+	LONG popPosition;
+
+	/** @brief 1 while the receiving thread is asleep or about to sleep, 0 otherwise. */
+	volatile LONG sleeping;
+
+	/** @brief Number of times to spin before sleeping, 0 on single core machines where spinning only delays the other thread. */
+	size_t spinCount;
+
+	/** @brief Signaled by posting threads to wake the receiving thread. */
+	ConcurrencyEvent notEmpty;
+
+	void Initialize(size_t capacity);
+public:
+	/** @brief Default maximum number of messages that can be queued. */
+	static const size_t DEFAULT_CAPACITY = 1024;
+
+	/** @brief Number of times that the receiving thread checks an empty queue before sleeping, on multi core machines. */
+	static const size_t SPIN_COUNT = 256;
+
+	ThreadMessageQueue(size_t capacity = DEFAULT_CAPACITY);
+	ThreadMessageQueue(const ThreadMessageQueue & copyMe);
+	ThreadMessageQueue & operator= (const ThreadMessageQueue & copyMe);
+	~ThreadMessageQueue();
+
+	bool TryPush(ThreadMessageItem * item);
+	void Push(ThreadMessageItem * item);
+	bool TryPop(ThreadMessageItem *& item);
+	ThreadMessageItem * Pop();
+	bool IsEmpty() const;
+
+	size_t GetCapacity() const;
+
+	static bool TestClass();
+};
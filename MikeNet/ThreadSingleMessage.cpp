@@ -3,8 +3,6 @@
 #include "ThreadMessageItem.h"
 #include "ThreadMessageItemShutdown.h"
 
-const HWND ThreadSingleMessage::THIS_QUEUE_ONLY((HWND)-1);
-
 /**
  * @brief Constructor, creates a suspended thread.
  *
@@ -31,7 +29,7 @@ ThreadSingleMessage::~ThreadSingleMessage()
 }
 
 /**
- * @brief	Does not return until thread is ready for messages to be sent.
+ * @brief	Does not return until thread has started retrieving messages.
  */
 void ThreadSingleMessage::WaitForThreadToBeReady()
 {
@@ -46,13 +44,12 @@ void ThreadSingleMessage::WaitForThreadToBeReady()
  */
 void ThreadSingleMessage::PostMessageItem( ThreadMessageItem * message )
 {
-	WaitForThreadToBeReady();
+	this->Resume();
 
 	message->SetMessageInUseByThread(true);
 	message->SetMessageInUseBySender(true);
 
-	BOOL result = PostThreadMessage(GetThreadID(),NULL,NULL,reinterpret_cast<LPARAM>(message));
-	_ErrorException((result == FALSE),"posting a thread message item",WSAGetLastError(),__LINE__,__FILE__);
+	queue.Push(message);
 }
 
 /**
@@ -96,34 +93,20 @@ void ThreadSingleMessage::TerminateFriendly(bool block)
 
 
 /**
- * @brief	Retrieves a message from the message queue.
+ * @brief	Retrieves a message from the message queue, waiting until one is posted if the queue is empty.
  *
- * Messages are posted using PostMessageItem.
+ * Messages are posted using PostMessageItem. Must only be used by the thread.
  *
  * @return	the message item that was retrieved.
  */
 ThreadMessageItem * ThreadSingleMessage::GetMessageItem()
 {
-getAnotherMessage:
-	MSG message;
-
-	// Finish setting up message queue.
 	if(threadReady.Get() == false)
 	{
-		PeekMessage(&message, THIS_QUEUE_ONLY, 0, 0, PM_NOREMOVE);
 		threadReady.Set(true);
 	}
 
-	BOOL result = GetMessage(&message, THIS_QUEUE_ONLY, 0, 0);
-	_ErrorException((result == -1),"retrieving a message item from the queue",WSAGetLastError(),__LINE__,__FILE__);
-
-	// Sometimes NULL messages are received, we ignore these
-	if(message.lParam == NULL)
-	{
-		goto getAnotherMessage;
-	}
-
-	return reinterpret_cast<ThreadMessageItem*>(message.lParam);
+	return queue.Pop();
 }
 
 /**
@@ -133,9 +116,7 @@ getAnotherMessage:
  */
 bool ThreadSingleMessage::IsQueueEmpty() const
 {
-	MSG message;
-	BOOL result = PeekMessage(&message, THIS_QUEUE_ONLY, 0, 0, PM_NOREMOVE);
-	return result == FALSE;
+	return queue.IsEmpty();
 }
 
 /**
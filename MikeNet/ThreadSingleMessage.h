@@ -1,6 +1,7 @@
 #pragma once
-#include "threadsingle.h"
+#include "ThreadSingle.h"
 #include "ThreadMessageItem.h"
+#include "ThreadMessageQueue.h"
 
 /**
  * @brief	Extends ThreadSingle with additional functionality for threads to receive and be sent ThreadMessageItem messages.
@@ -10,19 +11,15 @@ class ThreadSingleMessage :
 	public ThreadSingle
 {
 	/**
-	 * @brief Signaled when the thread is ready to receive messages.
+	 * @brief Signaled when the thread first uses GetMessageItem.
 	 *
-	 * Until the thread has used GetMessageItem, PostMessageItem will fail. This is because.
-	 * GetMessageItem initializes the message queue.
+	 * Messages can be posted before this, they are queued until the thread retrieves them.
 	 */
 	ConcurrencyEvent threadReady;
-public:
-	/**
-	 * @brief Value to pass to windows functions to ensure that messages dealt with
-	 * are only ones that are intended specifically for this thread.
-	 */
-	static const HWND THIS_QUEUE_ONLY;
 
+	/** @brief Messages posted to the thread, which only the thread receives from. */
+	ThreadMessageQueue queue;
+public:
 	ThreadSingleMessage(LPTHREAD_START_ROUTINE function, void * parameter, size_t manualThreadID=0);
 	virtual ~ThreadSingleMessage(void);
 
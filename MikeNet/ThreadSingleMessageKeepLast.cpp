@@ -63,6 +63,9 @@ const ThreadMessageItem * ThreadSingleMessageKeepLast::ExtractLastMessage()
 /**
  * @brief	Posts a message to the thread to be received using ThreadSingleMessage::GetMessageItem().
  *
+ * The last message may be posted again, once the thread has finished with it, instead of
+ * allocating a new message. In this case it is not cleaned up.
+ *
  * @param	message	The message to post.
  * @param [in]	customLastMessage	Non NULL if this local last message should be used, NULL if the global last message should be used.
  */
@@ -70,9 +73,16 @@ void ThreadSingleMessageKeepLast::PostMessageItem( ThreadMessageItem * message,
 {
 	ThreadMessageItem ** lastMessageToActOn = GetLastMessageToActOn(customLastMessage);
 
-	CleanupLastMessage(lastMessageToActOn);
+	if(*lastMessageToActOn != message)
+	{
+		CleanupLastMessage(lastMessageToActOn);
+		*lastMessageToActOn = message;
+	}
+	else
+	{
+		message->WaitUntilNotInUseByThread();
+	}
 
-	*lastMessageToActOn = message;
 	ThreadSingleMessage::PostMessageItem(message);
 }
 
@@ -1,5 +1,5 @@
 #pragma once
-#include "threadsinglemessage.h"
+#include "ThreadSingleMessage.h"
 
 /**
  * @brief	Message based thread where only the last message is stored and others are cleaned up.
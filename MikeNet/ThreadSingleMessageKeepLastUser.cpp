@@ -242,6 +242,26 @@ void ThreadSingleMessageKeepLastUser::PostMessageItem(size_t threadID, ThreadMes
 	threads[classIndex][threadID].PostMessageItem(message,lastMessage.GetPtr(threadID));
 }
 
+/**
+ * @brief	Retrieves the last message that this object posted to a thread, so that it can be posted again.
+ *
+ * @param	threadID ID of thread that the message was posted to.
+ *
+ * @return	the message, which may still be in use by the thread.
+ * @return	NULL if no message has been posted to the thread.
+ */
+ThreadMessageItem * ThreadSingleMessageKeepLastUser::GetLastMessageItem(size_t threadID)
+{
+	if(threadID < lastMessage.Size() && lastMessage.IsAllocated(threadID) == true)
+	{
+		return &lastMessage[threadID];
+	}
+	else
+	{
+		return NULL;
+	}
+}
+
 /**
  * @brief	Retrieves the number of threads that are operational. 
  *
@@ -79,6 +79,7 @@ protected:
 	void CleanupThreadsLocal();
 
 	void PostMessageItem(size_t threadID, ThreadMessageItem * message);
+	ThreadMessageItem * GetLastMessageItem(size_t threadID);
 	size_t GetNumThreads();
 	void WaitUntilLastThreadOperationFinished();
 	bool IsLastThreadOperationFinished();
@@ -0,0 +1,252 @@
+#include "FullInclude.h"
+
+/**
+ * @brief Constructor.
+ *
+ * @param slotAmount Number of slots, must be more than 0 (optional, default DEFAULT_SLOT_AMOUNT).
+ * @param granularity Number of clock ticks covered by each slot, items may expire up to this
+ * many ticks late (optional, default DEFAULT_GRANULARITY).
+ * @param start Current clock() value (optional, default clock()).
+ */
+TimerWheel::TimerWheel(size_t slotAmount, clock_t granularity, clock_t start) : CriticalSection()
+{
+	_ErrorException((slotAmount == 0),"constructing a timer wheel, there must be at least one slot",0,__LINE__,__FILE__);
+	_ErrorException((granularity <= 0),"constructing a timer wheel, granularity must be more than 0",0,__LINE__,__FILE__);
+
+	this->granularity = granularity;
+	slots.resize(slotAmount);
+	Clear(start);
+}
+
+/**
+ * @brief Destructor.
+ */
+TimerWheel::~TimerWheel()
+{
+
+}
+
+/**
+ * @brief Determines which slot covers the specified time.
+ *
+ * @param time clock() value.
+ *
+ * @return element of TimerWheel::slots.
+ */
+size_t TimerWheel::GetSlot(clock_t time) const
+{
+	return static_cast<size_t>(time / granularity) % slots.size();
+}
+
+/**
+ * @brief Moves items in a slot that have passed their deadline into @a expired.
+ *
+ * @param slot Element of TimerWheel::slots.
+ * @param now Current clock() value.
+ * @param [out] expired IDs of items that have passed their deadline are added to this.
+ */
+void TimerWheel::DealWithSlot(size_t slot, clock_t now, vector<size_t> & expired)
+{
+	vector<Entry> & entries = slots[slot];
+
+	size_t n = 0;
+	while(n < entries.size())
+	{
+		if(entries[n].deadline <= now)
+		{
+			expired.push_back(entries[n].id);
+
+			// Order of entries does not matter
+			entries[n] = entries.back();
+			entries.pop_back();
+			amount--;
+		}
+		else
+		{
+			n++;
+		}
+	}
+}
+
+/**
+ * @brief Adds an item to the wheel.
+ *
+ * @param id ID of item, the same ID may be added more than once.
+ * @param deadline clock() value after which the item expires.
+ */
+void TimerWheel::Add(size_t id, clock_t deadline)
+{
+	Entry entry;
+	entry.id = id;
+	entry.deadline = deadline;
+
+	Enter();
+	try
+	{
+		// Items that have already expired are dealt with by the next Advance
+		clock_t time = deadline;
+		if(time < nextTick)
+		{
+			time = nextTick;
+		}
+
+		slots[GetSlot(time)].push_back(entry);
+		amount++;
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){Leave(); throw(error);}
+	catch(...){Leave(); throw(-1);}
+	Leave();
+}
+
+/**
+ * @brief Removes items that have passed their deadline.
+ *
+ * @param now Current clock() value.
+ * @param [out] expired IDs of items that have passed their deadline are added to this.
+ */
+void TimerWheel::Advance(clock_t now, vector<size_t> & expired)
+{
+	Enter();
+	try
+	{
+		// Deal with each time period that has completely passed
+		size_t steps = 0;
+		while(nextTick + granularity <= now && steps < slots.size())
+		{
+			DealWithSlot(GetSlot(nextTick),now,expired);
+			nextTick += granularity;
+			steps++;
+		}
+
+		// Every slot has been dealt with, so no items remain
+		// in the time periods that have not been dealt with.
+		if(nextTick + granularity <= now)
+		{
+			nextTick = (now / granularity) * granularity;
+		}
+	}
+	// Release control of all objects before throwing final exception
+	catch(ErrorReport & error){Leave(); throw(error);}
+	catch(...){Leave(); throw(-1);}
+	Leave();
+}
+
+/**
+ * @brief Removes all items.
+ *
+ * @param start Current clock() value (optional, default clock()).
+ */
+void TimerWheel::Clear(clock_t start)
+{
+	Enter();
+	for(size_t n = 0;n<slots.size();n++)
+	{
+		slots[n].clear();
+	}
+	nextTick = (start / granularity) * granularity;
+	amount = 0;
+	Leave();
+}
+
+/**
+ * @brief Retrieves the number of items in the wheel.
+ *
+ * @return number of items.
+ */
+size_t TimerWheel::Size() const
+{
+	Enter();
+	size_t returnMe = amount;
+	Leave();
+
+	return returnMe;
+}
+
+/**
+ * @brief Tests class.
+ *
+ * @return true if no problems while testing were found, false if not.
+ * Note that not all tests automatically check for problems so some tests
+ * require manual verification.
+ */
+bool TimerWheel::TestClass()
+{
+	cout << "Testing TimerWheel class...\n";
+	bool problem = false;
+
+	TimerWheel wheel(8,10,1000);
+	vector<size_t> expired;
+
+	wheel.Add(1,1015);
+	wheel.Add(2,1035);
+	wheel.Add(3,1500); // More than one rotation away
+	wheel.Add(4,900); // Already expired
+
+	wheel.Advance(1010,expired);
+	if(expired.size() != 1 || expired[0] != 4 || wheel.Size() != 3)
+	{
+		cout << "Add or Advance is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Add and Advance are good\n";
+	}
+
+	// Items expire at most one slot late
+	expired.clear();
+	wheel.Advance(1019,expired);
+	wheel.Advance(1020,expired);
+	if(expired.size() != 1 || expired[0] != 1)
+	{
+		cout << "Advance is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Advance is good\n";
+	}
+
+	// Item 3 is passed over during the first rotation
+	expired.clear();
+	wheel.Advance(1100,expired);
+	if(expired.size() != 1 || expired[0] != 2 || wheel.Size() != 1)
+	{
+		cout << "Advance is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Advance is good\n";
+	}
+
+	// Time jumps by more than one rotation
+	expired.clear();
+	wheel.Add(5,2000);
+	wheel.Advance(1600,expired);
+	if(expired.size() != 1 || expired[0] != 3 || wheel.Size() != 1)
+	{
+		cout << "Advance is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Advance is good\n";
+	}
+
+	expired.clear();
+	wheel.Advance(2010,expired);
+	if(expired.size() != 1 || expired[0] != 5 || wheel.Size() != 0)
+	{
+		cout << "Advance is bad\n";
+		problem = true;
+	}
+	else
+	{
+		cout << "Advance is good\n";
+	}
+
+	cout << "\n\n";
+	return !problem;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <time.h>
+
+/**
+ * @brief	Hashed timer wheel, used to find out which of many items have passed their deadline.
+ *
+ * Each item is an ID with a clock() deadline, and is stored in the slot that covers its deadline.
+ * Advance() only looks at slots whose time period has passed, so the cost of finding expired
+ * items is proportional to the number of items that expire, rather than the number of items being timed.
+ * Items whose deadline is more than one rotation away stay in their slot until the rotation that they expire in.\n\n
+ *
+ * Items cannot be removed individually; instead, the owner should check that an expired
+ * item is still relevant.\n\n
+ *
+ * This class is thread safe.
+ */
+class TimerWheel: public CriticalSection
+{
+	/** @brief Item being timed. */
+	struct Entry
+	{
+		/** @brief ID of item. */
+		size_t id;
+
+		/** @brief clock() value after which item expires. */
+		clock_t deadline;
+	};
+
+	/** @brief Slots, each covers TimerWheel::granularity clock ticks. */
+	vector< vector<Entry> > slots;
+
+	/** @brief Number of clock ticks covered by each slot. */
+	clock_t granularity;
+
+	/** @brief Start of the earliest time period that Advance() has not dealt with yet. */
+	clock_t nextTick;
+
+	/** @brief Number of items in the wheel. */
+	size_t amount;
+
+	size_t GetSlot(clock_t time) const;
+	void DealWithSlot(size_t slot, clock_t now, vector<size_t> & expired);
+
+public:
+	/** @brief Default number of slots. */
+	static const size_t DEFAULT_SLOT_AMOUNT = 128;
+
+	/** @brief Default number of clock ticks covered by each slot. */
+	static const clock_t DEFAULT_GRANULARITY = 100;
+
+	TimerWheel(size_t slotAmount = DEFAULT_SLOT_AMOUNT, clock_t granularity = DEFAULT_GRANULARITY, clock_t start = clock());
+	~TimerWheel();
+
+	void Add(size_t id, clock_t deadline);
+	void Advance(clock_t now, vector<size_t> & expired);
+	void Clear(clock_t start = clock());
+
+	size_t Size() const;
+
+	static bool TestClass();
+};
@@ -1,7 +1,19 @@
 // Simple functions used throughout MikeNet
 #include "FullInclude.h"
 #include <sstream>
-#include <intsafe.h>
+#ifdef _WIN32
+	#include <intsafe.h>
+#endif
+
+// Vector instructions used by FindBytes, chosen at compile time
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define UTILITY_FIND_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define UTILITY_FIND_SSE2
+#endif
 
 const char * Utility::VERSION = "Release v2.0.2";
 const char * Utility::CREDITS = "Michael Pryor";
@@ -196,6 +208,49 @@ bool Utility::TestClass()
 		cout << "Log2(32) is good " << log2_32 << '\n';
 	}
 
+	// FindBytes, with matches at every position so that vector and scalar code are both used
+	{
+		char haystack[100];
+		memset(haystack,'a',sizeof(haystack));
+		const char * needle = "\r\n";
+		bool findProblem = false;
+
+		for(size_t n = 0;n<=sizeof(haystack)-2;n++)
+		{
+			haystack[n] = '\r';
+			haystack[n+1] = '\n';
+
+			size_t position = 0;
+			if(FindBytes(haystack,sizeof(haystack),needle,2,position) == false || position != n)
+			{
+				findProblem = true;
+			}
+
+			// Partial match at end must not be found
+			if(FindBytes(haystack,n+1,needle,2,position) == true)
+			{
+				findProblem = true;
+			}
+
+			haystack[n] = 'a';
+			haystack[n+1] = 'a';
+		}
+
+		// First and last bytes match but middle does not
+		const char * similar = "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxaXbxxxxaYb";
+		size_t position = 0;
+		if(findProblem == true || FindBytes(similar,strlen(similar),"aYb",3,position) == false || position != 47 ||
+		   FindBytes(similar,strlen(similar),"aZb",3,position) == true || FindBytes(similar,strlen(similar),"",0,position) == true)
+		{
+			cout << "FindBytes is bad\n";
+			problem = true;
+		}
+		else
+		{
+			cout << "FindBytes is good\n";
+		}
+	}
+
 	cout << "\n\n";
 	return !problem;
 }
@@ -395,3 +450,114 @@ size_t Utility::Log2( size_t logMe )
 
 	return log;	
 }
+
+/**
+ * @brief Determines the position of the lowest bit that is set.
+ *
+ * @param mask Bits, must not be 0.
+ *
+ * @return position of lowest set bit, where 0 is the least significant bit.
+ */
+static unsigned int UtilityLowestSetBit(unsigned int mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index,mask);
+	return index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+/**
+ * @brief Searches a block of memory for a sequence of bytes.
+ *
+ * Where available AVX2 or SSE2 instructions are used to compare many positions at once:
+ * the first and last bytes of @a findMe are compared at each position, and only positions
+ * where both match are compared in full. Remaining positions are compared one at a time.
+ *
+ * @param data Memory to search.
+ * @param length Number of bytes of @a data to search.
+ * @param findMe Bytes to find.
+ * @param findLength Number of bytes in @a findMe.
+ * @param [out] result Set to position of the first occurrence of @a findMe within @a data,
+ * unchanged if not found.
+ *
+ * @return true if @a findMe was found, false if not or if @a findLength is 0.
+ */
+bool Utility::FindBytes(const char * data, size_t length, const char * findMe, size_t findLength, size_t & result)
+{
+	if(findLength == 0 || findLength > length)
+	{
+		return false;
+	}
+
+	// Last position that findMe could start at
+	const size_t last = length - findLength;
+	const char first = findMe[0];
+	const char final = findMe[findLength-1];
+
+	size_t n = 0;
+
+#ifdef UTILITY_FIND_AVX2
+	{
+		const __m256i firstBytes = _mm256_set1_epi8(first);
+		const __m256i finalBytes = _mm256_set1_epi8(final);
+
+		for(;n + 32 <= last + 1;n += 32)
+		{
+			__m256i start = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + n));
+			__m256i end = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + n + findLength - 1));
+			unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(start,firstBytes),_mm256_cmpeq_epi8(end,finalBytes))));
+
+			while(mask != 0)
+			{
+				size_t position = n + UtilityLowestSetBit(mask);
+				if(memcmp(data + position, findMe, findLength) == 0)
+				{
+					result = position;
+					return true;
+				}
+				mask &= mask - 1;
+			}
+		}
+	}
+#endif
+
+#ifdef UTILITY_FIND_SSE2
+	{
+		const __m128i firstBytes = _mm_set1_epi8(first);
+		const __m128i finalBytes = _mm_set1_epi8(final);
+
+		for(;n + 16 <= last + 1;n += 16)
+		{
+			__m128i start = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + n));
+			__m128i end = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + n + findLength - 1));
+			unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(start,firstBytes),_mm_cmpeq_epi8(end,finalBytes))));
+
+			while(mask != 0)
+			{
+				size_t position = n + UtilityLowestSetBit(mask);
+				if(memcmp(data + position, findMe, findLength) == 0)
+				{
+					result = position;
+					return true;
+				}
+				mask &= mask - 1;
+			}
+		}
+	}
+#endif
+
+	// Positions not covered by vector instructions
+	for(;n <= last;n++)
+	{
+		if(data[n] == first && data[n + findLength - 1] == final && memcmp(data + n, findMe, findLength) == 0)
+		{
+			result = n;
+			return true;
+		}
+	}
+
+	return false;
+}
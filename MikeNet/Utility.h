@@ -1,6 +1,8 @@
 #pragma once
 #include "CriticalSection.h"
-#include "StoreVector.h"
+
+template<class T> class StoreVector;
+
 /**
  * @brief	%Utility namespace providing methods for basic and commonly used jobs.
  * @remarks	Michael Pryor, 6/28/2010. 
@@ -44,6 +46,8 @@ namespace Utility
 
 	size_t Log2(size_t logMe);
 
+	bool FindBytes(const char * data, size_t length, const char * findMe, size_t findLength, size_t & result);
+
 	/**
 	 * @brief Generates a copy of the specified object.
 	 *
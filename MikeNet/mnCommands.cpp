@@ -2526,6 +2526,9 @@ DBP_CPP_DLL int mn::SendToUDP(size_t instanceID, INT_PTR packet, const char * ad
  * @param clientID ID of client to receive from.
  * @param [in] packet %Packet to send.
  * @param keep If false @a packet's contents will be erased, if true no modifications to @a packet will be made.
+ * If false, large packets that are sent asynchronously give their memory to the send operation instead of being copied,
+ * so unlike Packet::Clear() the packet's memory size drops to 0 and memory is allocated again when the packet is next used.
+ * If an error occurs the packet keeps its data.
  * @param block If false the command will return immediately without waiting for the send operation to complete.
  *
  * @return NetUtility::SEND_COMPLETED if the send operation completed successfully instantly.
@@ -2542,10 +2545,14 @@ NetUtility::SendStatus mn::SendTCP(size_t instanceID, Packet & packet, size_t cl
 	try
 	{
 		NetInstanceGroup & group = NetUtility::GetInstanceGroup();
-		returnMe = group[instanceID].GetInstanceTCP()->SendTCP(packet,block,clientID);
 		if(keep == false)
 		{
-			packet.Clear();
+			// Packet's memory can be taken by the send operation instead of being copied
+			returnMe = group[instanceID].GetInstanceTCP()->SendTCP(std::move(packet),block,clientID);
+		}
+		else
+		{
+			returnMe = group[instanceID].GetInstanceTCP()->SendTCP(packet,block,clientID);
 		}
 	}
 	STD_CATCH
@@ -2579,6 +2586,9 @@ DBP_CPP_DLL int mn::SendTCP(size_t instanceID, INT_PTR packet, size_t clientID,
  * @param instanceID Unique identifier for instance.
  * @param [in] packet %Packet to send.
  * @param keep If false @a packet's contents will be erased, if true no modifications to @a packet will be made.
+ * If false, large packets that are sent asynchronously give their memory to the send operation instead of being copied,
+ * so unlike Packet::Clear() the packet's memory size drops to 0 and memory is allocated again when the packet is next used.
+ * If an error occurs the packet keeps its data.
  * @param block If false the command will return immediately without waiting for the send operation to complete.
  * @param clientExcludeID ID of client to exclude, the packet will be sent to all clients except one with this ID.
  *
@@ -2593,10 +2603,14 @@ int mn::SendAllTCP(size_t instanceID, Packet & packet, bool keep, bool block, si
 	try
 	{
 		NetInstanceGroup & group = NetUtility::GetInstanceGroup();
-		group[instanceID].GetInstanceServer()->SendAllTCP(packet,block,clientExcludeID);
 		if(keep == false)
 		{
-			packet.Clear();
+			// Packet's memory can be taken by the send operations instead of being copied
+			group[instanceID].GetInstanceServer()->SendAllTCP(std::move(packet),block,clientExcludeID);
+		}
+		else
+		{
+			group[instanceID].GetInstanceServer()->SendAllTCP(packet,block,clientExcludeID);
 		}
 	}
 	STD_CATCH_RM
@@ -5513,6 +5527,8 @@ DBP_CPP_DLL int mn::GetErrorMode(int errorMode)
  * The same key must be used to encrypt as is used to decrypt if the
  * decrypted data is to make sense.
  *
+ * Identical keys are shared rather than expanded again, see EncryptKeyCache.
+ *
  * @param	key1	The first key. 
  * @param	key2	The second key. 
  * @param	key3	The third key. 
@@ -5527,8 +5543,12 @@ DBP_CPP_DLL INT_PTR mn::CreateKey256(__int64 key1, __int64 key2, __int64 key3, _
 
 	try
 	{
-		EncryptKey * keyData = new (nothrow) EncryptKey(key1,key2,key3,key4);
-		Utility::DynamicAllocCheck(keyData,__LINE__,__FILE__);
+		Packet keyBytes;
+		keyBytes.Add(key1);
+		keyBytes.Add(key2);
+		keyBytes.Add(key3);
+		keyBytes.Add(key4);
+		EncryptKey * keyData = EncryptKeyCache::sharedCache.Acquire(keyBytes);
 		returnMe = reinterpret_cast<INT_PTR>(keyData);
 	}
 	STD_CATCH_RM
@@ -5543,6 +5563,8 @@ DBP_CPP_DLL INT_PTR mn::CreateKey256(__int64 key1, __int64 key2, __int64 key3, _
  * The same key must be used to encrypt as is used to decrypt if the
  * decrypted data is to make sense.
  *
+ * Identical keys are shared rather than expanded again, see EncryptKeyCache.
+ *
  * @param	key1	The first key. 
  * @param	key2	The second key. 
  * @param	key3	The third key. 
@@ -5556,8 +5578,11 @@ DBP_CPP_DLL INT_PTR mn::CreateKey192(__int64 key1, __int64 key2, __int64 key3)
 
 	try
 	{
-		EncryptKey * keyData = new (nothrow) EncryptKey(key1,key2,key3);
-		Utility::DynamicAllocCheck(keyData,__LINE__,__FILE__);
+		Packet keyBytes;
+		keyBytes.Add(key1);
+		keyBytes.Add(key2);
+		keyBytes.Add(key3);
+		EncryptKey * keyData = EncryptKeyCache::sharedCache.Acquire(keyBytes);
 		returnMe = reinterpret_cast<INT_PTR>(keyData);
 	}
 	STD_CATCH_RM
@@ -5572,6 +5597,8 @@ DBP_CPP_DLL INT_PTR mn::CreateKey192(__int64 key1, __int64 key2, __int64 key3)
  * The same key must be used to encrypt as is used to decrypt if the
  * decrypted data is to make sense.
  *
+ * Identical keys are shared rather than expanded again, see EncryptKeyCache.
+ *
  * @param	key1	The first key. 
  * @param	key2	The second key. 
  *
@@ -5584,8 +5611,10 @@ DBP_CPP_DLL INT_PTR mn::CreateKey128(__int64 key1, __int64 key2)
 
 	try
 	{
-		EncryptKey * keyData = new (nothrow) EncryptKey(key1,key2);
-		Utility::DynamicAllocCheck(keyData,__LINE__,__FILE__);
+		Packet keyBytes;
+		keyBytes.Add(key1);
+		keyBytes.Add(key2);
+		EncryptKey * keyData = EncryptKeyCache::sharedCache.Acquire(keyBytes);
 		returnMe = reinterpret_cast<INT_PTR>(keyData);
 	}
 	STD_CATCH_RM
@@ -5600,6 +5629,8 @@ DBP_CPP_DLL INT_PTR mn::CreateKey128(__int64 key1, __int64 key2)
  * The same key must be used to encrypt as is used to decrypt if the
  * decrypted data is to make sense.
  *
+ * Identical keys are shared rather than expanded again, see EncryptKeyCache.
+ *
  * @param	key1	The first key. 
  * @param	key2	The second key. 
  * @param   key3    The third key.
@@ -5614,8 +5645,12 @@ CPP_DLL INT_PTR mn::CreateKeyFine128(int key1, int key2, int key3, int key4)
 
 	try
 	{
-		EncryptKey * keyData = new (nothrow) EncryptKey(key1,key2,key3,key4,true);
-		Utility::DynamicAllocCheck(keyData,__LINE__,__FILE__);
+		Packet keyBytes;
+		keyBytes.Add(key1);
+		keyBytes.Add(key2);
+		keyBytes.Add(key3);
+		keyBytes.Add(key4);
+		EncryptKey * keyData = EncryptKeyCache::sharedCache.Acquire(keyBytes);
 		returnMe = reinterpret_cast<INT_PTR>(keyData);
 	}
 	STD_CATCH_RM
@@ -5630,6 +5665,8 @@ CPP_DLL INT_PTR mn::CreateKeyFine128(int key1, int key2, int key3, int key4)
  * The same key must be used to encrypt as is used to decrypt if the
  * decrypted data is to make sense.
  *
+ * Identical keys are shared rather than expanded again, see EncryptKeyCache.
+ *
  * @param	key1	The first key. 
  * @param	key2	The second key. 
  * @param	key3	The third key. 
@@ -5646,8 +5683,14 @@ CPP_DLL INT_PTR mn::CreateKeyFine192(int key1, int key2, int key3, int key4, int
 
 	try
 	{
-		EncryptKey * keyData = new (nothrow) EncryptKey(key1,key2,key3,key4,key5,key6,true);
-		Utility::DynamicAllocCheck(keyData,__LINE__,__FILE__);
+		Packet keyBytes;
+		keyBytes.Add(key1);
+		keyBytes.Add(key2);
+		keyBytes.Add(key3);
+		keyBytes.Add(key4);
+		keyBytes.Add(key5);
+		keyBytes.Add(key6);
+		EncryptKey * keyData = EncryptKeyCache::sharedCache.Acquire(keyBytes);
 		returnMe = reinterpret_cast<INT_PTR>(keyData);
 	}
 	STD_CATCH_RM
@@ -5662,6 +5705,8 @@ CPP_DLL INT_PTR mn::CreateKeyFine192(int key1, int key2, int key3, int key4, int
  * The same key must be used to encrypt as is used to decrypt if the
  * decrypted data is to make sense.
  *
+ * Identical keys are shared rather than expanded again, see EncryptKeyCache.
+ *
  * @param	key1	The first key. 
  * @param	key2	The second key. 
  * @param	key3	The third key. 
@@ -5680,8 +5725,16 @@ CPP_DLL INT_PTR mn::CreateKeyFine256(int key1, int key2, int key3, int key4, int
 
 	try
 	{
-		EncryptKey * keyData = new (nothrow) EncryptKey(key1,key2,key3,key4,key5,key6,key7,key8,true);
-		Utility::DynamicAllocCheck(keyData,__LINE__,__FILE__);
+		Packet keyBytes;
+		keyBytes.Add(key1);
+		keyBytes.Add(key2);
+		keyBytes.Add(key3);
+		keyBytes.Add(key4);
+		keyBytes.Add(key5);
+		keyBytes.Add(key6);
+		keyBytes.Add(key7);
+		keyBytes.Add(key8);
+		EncryptKey * keyData = EncryptKeyCache::sharedCache.Acquire(keyBytes);
 		returnMe = reinterpret_cast<INT_PTR>(keyData);
 	}
 	STD_CATCH_RM
@@ -5693,6 +5746,9 @@ CPP_DLL INT_PTR mn::CreateKeyFine256(int key1, int key2, int key3, int key4, int
 /**
  * @brief	Deletes the specified encryption key.
  *
+ * The key is only deallocated once every mn::CreateKey256() (or similar) call
+ * that returned it has been matched by a call to this command.
+ *
  * @param	Key	The key to delete.
  *
  * @return	0 if no error occurred.
@@ -5706,7 +5762,7 @@ DBP_CPP_DLL int mn::DeleteKey(INT_PTR Key)
 	try
 	{
 		EncryptKey * ptr = (EncryptKey*)Key;
-		delete ptr;
+		EncryptKeyCache::sharedCache.Release(ptr);
 	}
 	STD_CATCH_RM
 
@@ -7132,6 +7188,7 @@ bool mn::TestClass()
 
 		mn::StartServer(0,maxPlayers,hostNIP);
 
+#ifdef _WIN32
 		mnSound::StartSound(1,1);
 
 		INT_PTR sip = mnSound::CreateSoundProfile();
@@ -7139,6 +7196,7 @@ bool mn::TestClass()
 		mnSound::SetSoundProfile(sip,7000,8,1);
 
 		mnSound::StartInput(0,-1,2,100,sip);
+#endif
 
 		clock_t lastClock = 0;
 
@@ -7189,7 +7247,9 @@ bool mn::TestClass()
 			}
 		}
 
+#ifdef _WIN32
 		mnSound::FinishSound();
+#endif
 		mn::Finish(-1);
 
 		mn::DeletePacket(recvPacket);